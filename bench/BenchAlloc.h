@@ -0,0 +1,48 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+namespace radbench
+{
+
+/// @brief malloc backed allocator, so rad containers are measured against the
+/// same heap as the std containers they are compared with.
+class Mallocator
+{
+public:
+
+    static void* AllocBytes(size_t size)
+    {
+        return malloc(size);
+    }
+
+    static void FreeBytes(void* ptr, size_t size) noexcept
+    {
+        RAD_UNUSED(size);
+        free(ptr);
+    }
+
+    static void HandleSizeOverflow()
+    {
+    }
+};
+
+} // namespace radbench
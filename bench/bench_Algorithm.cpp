@@ -0,0 +1,183 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "benchmark/benchmark.h"
+
+#include "radiant/Algorithm.h"
+#include "radiant/ParallelAlgorithm.h"
+#include "radiant/RadixSort.h"
+#include "radiant/ThreadPool.h"
+
+#include "bench/BenchAlloc.h"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct FlowRecord
+{
+    uint64_t key;
+    uint32_t bytes;
+    uint32_t packets;
+};
+
+bool KeyLess(const FlowRecord& a, const FlowRecord& b) noexcept
+{
+    return a.key < b.key;
+}
+
+std::vector<FlowRecord> MakeRecords(size_t count)
+{
+    std::mt19937_64 rng(count);
+    std::vector<FlowRecord> records(count);
+    for (auto& record : records)
+    {
+        record.key = rng();
+        record.bytes = static_cast<uint32_t>(rng());
+        record.packets = static_cast<uint32_t>(rng());
+    }
+
+    return records;
+}
+
+void BM_RadSort(benchmark::State& state)
+{
+    const auto input = MakeRecords(static_cast<size_t>(state.range(0)));
+    std::vector<FlowRecord> records;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        records = input;
+        state.ResumeTiming();
+        rad::Sort(records.data(), records.data() + records.size(), KeyLess);
+        benchmark::DoNotOptimize(records.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_StdSort(benchmark::State& state)
+{
+    const auto input = MakeRecords(static_cast<size_t>(state.range(0)));
+    std::vector<FlowRecord> records;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        records = input;
+        state.ResumeTiming();
+        std::sort(records.begin(), records.end(), KeyLess);
+        benchmark::DoNotOptimize(records.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_RadStableSort(benchmark::State& state)
+{
+    const auto input = MakeRecords(static_cast<size_t>(state.range(0)));
+    std::vector<FlowRecord> records;
+    radbench::Mallocator alloc;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        records = input;
+        state.ResumeTiming();
+        rad::StableSort(alloc,
+                        records.data(),
+                        records.data() + records.size(),
+                        KeyLess);
+        benchmark::DoNotOptimize(records.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_StdStableSort(benchmark::State& state)
+{
+    const auto input = MakeRecords(static_cast<size_t>(state.range(0)));
+    std::vector<FlowRecord> records;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        records = input;
+        state.ResumeTiming();
+        std::stable_sort(records.begin(), records.end(), KeyLess);
+        benchmark::DoNotOptimize(records.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_RadRadixSort(benchmark::State& state)
+{
+    const auto input = MakeRecords(static_cast<size_t>(state.range(0)));
+    std::vector<FlowRecord> records;
+    std::vector<FlowRecord> scratch(input.size());
+    const rad::Span<FlowRecord> scratchSpan(
+        scratch.data(),
+        static_cast<rad::SpanSizeType>(scratch.size()));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        records = input;
+        state.ResumeTiming();
+        rad::RadixSort(rad::Span<FlowRecord>(records.data(),
+                                             static_cast<rad::SpanSizeType>(
+                                                 records.size())),
+                       scratchSpan,
+                       [](const FlowRecord& record) noexcept
+                       { return record.key; });
+        benchmark::DoNotOptimize(records.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_RadParallelSort(benchmark::State& state)
+{
+    const auto input = MakeRecords(static_cast<size_t>(state.range(0)));
+    rad::ThreadPool<radbench::Mallocator> pool;
+    const unsigned threads = std::thread::hardware_concurrency();
+    RAD_UNUSED(pool.Start(threads > 1 ? threads - 1 : 1));
+    radbench::Mallocator alloc;
+    std::vector<FlowRecord> records;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        records = input;
+        state.ResumeTiming();
+        rad::ParallelSort(pool,
+                          alloc,
+                          rad::Span<FlowRecord>(
+                              records.data(),
+                              static_cast<rad::SpanSizeType>(records.size())),
+                          KeyLess);
+        benchmark::DoNotOptimize(records.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_RadSort)->Range(64, 1 << 20);
+BENCHMARK(BM_StdSort)->Range(64, 1 << 20);
+BENCHMARK(BM_RadStableSort)->Range(64, 1 << 20);
+BENCHMARK(BM_StdStableSort)->Range(64, 1 << 20);
+BENCHMARK(BM_RadRadixSort)->Range(64, 1 << 20);
+BENCHMARK(BM_RadParallelSort)->Range(64, 1 << 20)->UseRealTime();
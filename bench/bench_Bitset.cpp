@@ -0,0 +1,139 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark/benchmark.h"
+
+#include "radiant/Bitset.h"
+
+#include "bench/BenchAlloc.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+// slot occupancy of a large pool, with one slot in 64 in use
+constexpr size_t SlotCount = 1 << 20;
+constexpr uint32_t OccupiedOneIn = 64;
+
+std::vector<bool> MakeOccupancy()
+{
+    std::mt19937 rng(7);
+    std::vector<bool> slots(SlotCount);
+    for (size_t i = 0; i < SlotCount; ++i)
+    {
+        slots[i] = rng() % OccupiedOneIn == 0;
+    }
+
+    return slots;
+}
+
+void BM_ByteArrayScan(benchmark::State& state)
+{
+    const auto occupancy = MakeOccupancy();
+    std::vector<uint8_t> slots(occupancy.begin(), occupancy.end());
+    for (auto _ : state)
+    {
+        size_t sum = 0;
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+            if (slots[i] != 0)
+            {
+                sum += i;
+            }
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * SlotCount);
+}
+
+void BM_RadBitsetScan(benchmark::State& state)
+{
+    const auto occupancy = MakeOccupancy();
+    rad::DynamicBitset<radbench::Mallocator> slots;
+    if (!slots.Resize(SlotCount).IsOk())
+    {
+        state.SkipWithError("out of memory");
+        return;
+    }
+
+    for (size_t i = 0; i < SlotCount; ++i)
+    {
+        slots.Set(i, occupancy[i]);
+    }
+
+    for (auto _ : state)
+    {
+        size_t sum = 0;
+        for (size_t i = slots.FindFirst(); i < slots.Size();
+             i = slots.FindNext(i))
+        {
+            sum += i;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * SlotCount);
+}
+
+void BM_ByteArrayCount(benchmark::State& state)
+{
+    const auto occupancy = MakeOccupancy();
+    std::vector<uint8_t> slots(occupancy.begin(), occupancy.end());
+    for (auto _ : state)
+    {
+        size_t count = 0;
+        for (uint8_t slot : slots)
+        {
+            count += slot;
+        }
+
+        benchmark::DoNotOptimize(count);
+    }
+
+    state.SetItemsProcessed(state.iterations() * SlotCount);
+}
+
+void BM_RadBitsetCount(benchmark::State& state)
+{
+    const auto occupancy = MakeOccupancy();
+    rad::DynamicBitset<radbench::Mallocator> slots;
+    if (!slots.Resize(SlotCount).IsOk())
+    {
+        state.SkipWithError("out of memory");
+        return;
+    }
+
+    for (size_t i = 0; i < SlotCount; ++i)
+    {
+        slots.Set(i, occupancy[i]);
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(slots.Count());
+    }
+
+    state.SetItemsProcessed(state.iterations() * SlotCount);
+}
+
+} // namespace
+
+BENCHMARK(BM_ByteArrayScan);
+BENCHMARK(BM_RadBitsetScan);
+BENCHMARK(BM_ByteArrayCount);
+BENCHMARK(BM_RadBitsetCount);
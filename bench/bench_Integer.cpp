@@ -0,0 +1,124 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark/benchmark.h"
+
+#include "radiant/Integer.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+// a batch of metered counters and the increments to fold into them
+constexpr uint32_t CounterCount = 1 << 16;
+
+std::vector<uint32_t> MakeDeltas()
+{
+    std::mt19937 rng(7);
+    std::vector<uint32_t> deltas(CounterCount);
+    for (uint32_t& delta : deltas)
+    {
+        delta = rng() % 1024;
+    }
+
+    return deltas;
+}
+
+void BM_UncheckedAccumulate(benchmark::State& state)
+{
+    const auto deltas = MakeDeltas();
+    std::vector<uint32_t> counters(CounterCount);
+    for (auto _ : state)
+    {
+        for (uint32_t i = 0; i < CounterCount; ++i)
+        {
+            counters[i] += deltas[i];
+        }
+
+        benchmark::DoNotOptimize(counters.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * CounterCount);
+}
+
+void BM_ScalarCheckedAccumulate(benchmark::State& state)
+{
+    const auto deltas = MakeDeltas();
+    std::vector<rad::u32> counters(CounterCount);
+    for (auto _ : state)
+    {
+        for (uint32_t i = 0; i < CounterCount; ++i)
+        {
+            auto res = counters[i].Add(deltas[i]);
+            if (res.IsErr())
+            {
+                state.SkipWithError("overflow");
+                return;
+            }
+
+            counters[i] = res.Ok();
+        }
+
+        benchmark::DoNotOptimize(counters.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * CounterCount);
+}
+
+void BM_SpanCheckedAccumulate(benchmark::State& state)
+{
+    const auto deltas = MakeDeltas();
+    std::vector<uint32_t> counters(CounterCount);
+    rad::Span<uint32_t> total(counters.data(), CounterCount);
+    rad::Span<const uint32_t> delta(deltas.data(), CounterCount);
+    for (auto _ : state)
+    {
+        if (rad::AddChecked<uint32_t>(total, delta, total) != CounterCount)
+        {
+            state.SkipWithError("overflow");
+            return;
+        }
+
+        benchmark::DoNotOptimize(counters.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * CounterCount);
+}
+
+void BM_SpanSaturatingAccumulate(benchmark::State& state)
+{
+    const auto deltas = MakeDeltas();
+    std::vector<uint32_t> counters(CounterCount);
+    rad::Span<uint32_t> total(counters.data(), CounterCount);
+    rad::Span<const uint32_t> delta(deltas.data(), CounterCount);
+    for (auto _ : state)
+    {
+        rad::SaturatingAdd<uint32_t>(total, delta, total);
+        benchmark::DoNotOptimize(counters.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * CounterCount);
+}
+
+} // namespace
+
+BENCHMARK(BM_UncheckedAccumulate);
+BENCHMARK(BM_ScalarCheckedAccumulate);
+BENCHMARK(BM_SpanCheckedAccumulate);
+BENCHMARK(BM_SpanSaturatingAccumulate);
@@ -0,0 +1,213 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "benchmark/benchmark.h"
+
+#include "radiant/List.h"
+#include "radiant/NodePool.h"
+
+#include "bench/BenchAlloc.h"
+
+#include <list>
+
+namespace
+{
+using RadList = rad::List<int, radbench::Mallocator>;
+using PoolType = rad::ListNodePool<int, radbench::Mallocator>;
+using PoolAllocType = rad::ListNodePoolAllocator<int, radbench::Mallocator>;
+
+void BM_RadListPushBack(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        RadList list;
+        for (int i = 0; i < count; ++i)
+        {
+            RAD_UNUSED(list.PushBack(i));
+        }
+
+        benchmark::DoNotOptimize(list.begin());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_RadListPooledPushBack(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    PoolType pool;
+    for (auto _ : state)
+    {
+        PoolAllocType alloc(pool);
+        rad::List<int, PoolAllocType> list(alloc);
+        for (int i = 0; i < count; ++i)
+        {
+            RAD_UNUSED(list.PushBack(i));
+        }
+
+        benchmark::DoNotOptimize(list.begin());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_StdListPushBack(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        std::list<int> list;
+        for (int i = 0; i < count; ++i)
+        {
+            list.push_back(i);
+        }
+
+        benchmark::DoNotOptimize(list.begin());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_RadListInsertMiddle(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        RadList list;
+        RAD_UNUSED(list.PushBack(0));
+        auto middle = list.begin();
+        for (int i = 0; i < count; ++i)
+        {
+            // keep inserting before the same node so the work stays O(1)
+            RAD_UNUSED(list.Insert(middle, i));
+        }
+
+        benchmark::DoNotOptimize(list.begin());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_StdListInsertMiddle(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        std::list<int> list;
+        list.push_back(0);
+        auto middle = list.begin();
+        for (int i = 0; i < count; ++i)
+        {
+            list.insert(middle, i);
+        }
+
+        benchmark::DoNotOptimize(list.begin());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_RadListSplice(benchmark::State& state)
+{
+    RadList a;
+    RadList b;
+    for (int i = 0; i < state.range(0); ++i)
+    {
+        RAD_UNUSED(a.PushBack(i));
+        RAD_UNUSED(b.PushBack(i));
+    }
+
+    for (auto _ : state)
+    {
+        a.SpliceAll(a.end(), b);
+        b.SpliceAll(b.end(), a);
+        benchmark::DoNotOptimize(b.begin());
+    }
+}
+
+void BM_StdListSplice(benchmark::State& state)
+{
+    std::list<int> a;
+    std::list<int> b;
+    for (int i = 0; i < state.range(0); ++i)
+    {
+        a.push_back(i);
+        b.push_back(i);
+    }
+
+    for (auto _ : state)
+    {
+        a.splice(a.end(), b);
+        b.splice(b.end(), a);
+        benchmark::DoNotOptimize(b.begin());
+    }
+}
+
+void BM_RadListIterate(benchmark::State& state)
+{
+    RadList list;
+    for (int i = 0; i < state.range(0); ++i)
+    {
+        RAD_UNUSED(list.PushBack(i));
+    }
+
+    for (auto _ : state)
+    {
+        int64_t sum = 0;
+        for (int value : list)
+        {
+            sum += value;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_StdListIterate(benchmark::State& state)
+{
+    std::list<int> list;
+    for (int i = 0; i < state.range(0); ++i)
+    {
+        list.push_back(i);
+    }
+
+    for (auto _ : state)
+    {
+        int64_t sum = 0;
+        for (int value : list)
+        {
+            sum += value;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_RadListPushBack)->Range(8, 1 << 14);
+BENCHMARK(BM_RadListPooledPushBack)->Range(8, 1 << 14);
+BENCHMARK(BM_StdListPushBack)->Range(8, 1 << 14);
+BENCHMARK(BM_RadListInsertMiddle)->Range(8, 1 << 14);
+BENCHMARK(BM_StdListInsertMiddle)->Range(8, 1 << 14);
+BENCHMARK(BM_RadListSplice)->Range(8, 1 << 14);
+BENCHMARK(BM_StdListSplice)->Range(8, 1 << 14);
+BENCHMARK(BM_RadListIterate)->Range(8, 1 << 14);
+BENCHMARK(BM_StdListIterate)->Range(8, 1 << 14);
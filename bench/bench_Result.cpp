@@ -0,0 +1,170 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "benchmark/benchmark.h"
+
+#include "radiant/Res.h"
+
+#include <optional>
+#include <stdexcept>
+
+#if defined(RAD_MSC_VERSION)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+namespace
+{
+// Each layer checks the result of the one below and passes errors up, which
+// is the shape of most Res-returning call chains.
+
+BENCH_NOINLINE rad::Res<int> RadLeaf(int value)
+{
+    if (value < 0)
+    {
+        return rad::Error::OutOfRange;
+    }
+
+    return value + 1;
+}
+
+BENCH_NOINLINE rad::Res<int> RadMiddle(int value)
+{
+    auto res = RadLeaf(value);
+    if (res.IsErr())
+    {
+        return res.Err();
+    }
+
+    return res.Ok() * 2;
+}
+
+BENCH_NOINLINE rad::Res<int> RadTop(int value)
+{
+    auto res = RadMiddle(value);
+    if (res.IsErr())
+    {
+        return res.Err();
+    }
+
+    return res.Ok() - 3;
+}
+
+BENCH_NOINLINE std::optional<int> OptLeaf(int value)
+{
+    if (value < 0)
+    {
+        return std::nullopt;
+    }
+
+    return value + 1;
+}
+
+BENCH_NOINLINE std::optional<int> OptMiddle(int value)
+{
+    auto res = OptLeaf(value);
+    if (!res)
+    {
+        return std::nullopt;
+    }
+
+    return *res * 2;
+}
+
+BENCH_NOINLINE std::optional<int> OptTop(int value)
+{
+    auto res = OptMiddle(value);
+    if (!res)
+    {
+        return std::nullopt;
+    }
+
+    return *res - 3;
+}
+
+BENCH_NOINLINE int ExcLeaf(int value)
+{
+    if (value < 0)
+    {
+        throw std::invalid_argument("negative");
+    }
+
+    return value + 1;
+}
+
+BENCH_NOINLINE int ExcMiddle(int value)
+{
+    return ExcLeaf(value) * 2;
+}
+
+BENCH_NOINLINE int ExcTop(int value)
+{
+    return ExcMiddle(value) - 3;
+}
+
+// range(0) == 0 measures the success path, 1 the failure path
+int Input(const benchmark::State& state)
+{
+    return state.range(0) == 0 ? 5 : -5;
+}
+
+void BM_RadResultPropagate(benchmark::State& state)
+{
+    int value = Input(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value);
+        auto res = RadTop(value);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+void BM_StdOptionalPropagate(benchmark::State& state)
+{
+    int value = Input(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value);
+        auto res = OptTop(value);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+void BM_ExceptionPropagate(benchmark::State& state)
+{
+    int value = Input(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value);
+        int res = 0;
+        try
+        {
+            res = ExcTop(value);
+        }
+        catch (const std::invalid_argument&)
+        {
+            res = -1;
+        }
+
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_RadResultPropagate)->Arg(0)->Arg(1);
+BENCHMARK(BM_StdOptionalPropagate)->Arg(0)->Arg(1);
+BENCHMARK(BM_ExceptionPropagate)->Arg(0)->Arg(1);
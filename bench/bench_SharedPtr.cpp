@@ -0,0 +1,181 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "benchmark/benchmark.h"
+
+#include "radiant/SharedPtr.h"
+
+#include "bench/BenchAlloc.h"
+
+#include <atomic>
+#include <memory>
+
+namespace
+{
+struct Payload
+{
+    int value[4];
+};
+
+void BM_RadAllocateShared(benchmark::State& state)
+{
+    radbench::Mallocator alloc;
+    for (auto _ : state)
+    {
+        auto ptr = rad::AllocateShared<Payload>(alloc);
+        benchmark::DoNotOptimize(ptr.Get());
+    }
+}
+
+void BM_StdAllocateShared(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        auto ptr = std::make_shared<Payload>();
+        benchmark::DoNotOptimize(ptr.get());
+    }
+}
+
+void BM_RadSharedPtrCopy(benchmark::State& state)
+{
+    radbench::Mallocator alloc;
+    auto ptr = rad::AllocateShared<Payload>(alloc);
+    for (auto _ : state)
+    {
+        rad::SharedPtr<Payload> copy(ptr);
+        benchmark::DoNotOptimize(copy.Get());
+    }
+}
+
+void BM_StdSharedPtrCopy(benchmark::State& state)
+{
+    auto ptr = std::make_shared<Payload>();
+    for (auto _ : state)
+    {
+        std::shared_ptr<Payload> copy(ptr);
+        benchmark::DoNotOptimize(copy.get());
+    }
+}
+
+// shared between the threads of a multi-threaded run; thread 0 sets them up
+rad::AtomicSharedPtr<Payload> g_radAtomic;
+std::shared_ptr<Payload> g_stdAtomic;
+
+void BM_RadAtomicSharedPtrLoad(benchmark::State& state)
+{
+    if (state.thread_index() == 0)
+    {
+        g_radAtomic.Store(
+            rad::AllocateShared<Payload>(radbench::Mallocator()));
+    }
+
+    for (auto _ : state)
+    {
+        auto ptr = g_radAtomic.Load();
+        benchmark::DoNotOptimize(ptr.Get());
+    }
+
+    if (state.thread_index() == 0)
+    {
+        g_radAtomic.Store(nullptr);
+    }
+}
+
+void BM_StdAtomicSharedPtrLoad(benchmark::State& state)
+{
+    if (state.thread_index() == 0)
+    {
+        std::atomic_store(&g_stdAtomic, std::make_shared<Payload>());
+    }
+
+    for (auto _ : state)
+    {
+        auto ptr = std::atomic_load(&g_stdAtomic);
+        benchmark::DoNotOptimize(ptr.get());
+    }
+
+    if (state.thread_index() == 0)
+    {
+        std::atomic_store(&g_stdAtomic, std::shared_ptr<Payload>());
+    }
+}
+
+void BM_RadAtomicSharedPtrLoadStore(benchmark::State& state)
+{
+    // thread 0 keeps publishing new values while the others read
+    const bool writer = state.thread_index() == 0;
+    auto next = rad::AllocateShared<Payload>(radbench::Mallocator());
+    if (writer)
+    {
+        g_radAtomic.Store(next);
+    }
+
+    for (auto _ : state)
+    {
+        if (writer)
+        {
+            g_radAtomic.Store(next);
+        }
+        else
+        {
+            auto ptr = g_radAtomic.Load();
+            benchmark::DoNotOptimize(ptr.Get());
+        }
+    }
+
+    if (writer)
+    {
+        g_radAtomic.Store(nullptr);
+    }
+}
+
+void BM_StdAtomicSharedPtrLoadStore(benchmark::State& state)
+{
+    const bool writer = state.thread_index() == 0;
+    auto next = std::make_shared<Payload>();
+    if (writer)
+    {
+        std::atomic_store(&g_stdAtomic, next);
+    }
+
+    for (auto _ : state)
+    {
+        if (writer)
+        {
+            std::atomic_store(&g_stdAtomic, next);
+        }
+        else
+        {
+            auto ptr = std::atomic_load(&g_stdAtomic);
+            benchmark::DoNotOptimize(ptr.get());
+        }
+    }
+
+    if (writer)
+    {
+        std::atomic_store(&g_stdAtomic, std::shared_ptr<Payload>());
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_RadAllocateShared);
+BENCHMARK(BM_StdAllocateShared);
+BENCHMARK(BM_RadSharedPtrCopy);
+BENCHMARK(BM_StdSharedPtrCopy);
+BENCHMARK(BM_RadAtomicSharedPtrLoad)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_StdAtomicSharedPtrLoad)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_RadAtomicSharedPtrLoadStore)->ThreadRange(2, 8)->UseRealTime();
+BENCHMARK(BM_StdAtomicSharedPtrLoadStore)->ThreadRange(2, 8)->UseRealTime();
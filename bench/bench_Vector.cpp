@@ -0,0 +1,223 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "benchmark/benchmark.h"
+
+#include "radiant/Vector.h"
+
+#include "bench/BenchAlloc.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <string.h>
+
+namespace
+{
+using RadVector = rad::Vector<int, radbench::Mallocator>;
+
+void BM_RadVectorPushBack(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        RadVector vec;
+        for (int i = 0; i < count; ++i)
+        {
+            RAD_UNUSED(vec.PushBack(i));
+        }
+
+        benchmark::DoNotOptimize(vec.Data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_StdVectorPushBack(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        std::vector<int> vec;
+        for (int i = 0; i < count; ++i)
+        {
+            vec.push_back(i);
+        }
+
+        benchmark::DoNotOptimize(vec.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_RadVectorReservePushBack(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        RadVector vec;
+        RAD_UNUSED(vec.Reserve(static_cast<uint32_t>(count)));
+        for (int i = 0; i < count; ++i)
+        {
+            RAD_UNUSED(vec.PushBack(i));
+        }
+
+        benchmark::DoNotOptimize(vec.Data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_StdVectorReservePushBack(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        std::vector<int> vec;
+        vec.reserve(static_cast<size_t>(count));
+        for (int i = 0; i < count; ++i)
+        {
+            vec.push_back(i);
+        }
+
+        benchmark::DoNotOptimize(vec.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_RadVectorResize(benchmark::State& state)
+{
+    const uint32_t count = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state)
+    {
+        RadVector vec;
+        RAD_UNUSED(vec.Resize(count, 7));
+        benchmark::DoNotOptimize(vec.Data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) *
+                            static_cast<int64_t>(sizeof(int)));
+}
+
+void BM_StdVectorResize(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        std::vector<int> vec;
+        vec.resize(count, 7);
+        benchmark::DoNotOptimize(vec.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) *
+                            static_cast<int64_t>(sizeof(int)));
+}
+
+// Simulates reading a frame into a reused buffer, as from a socket.
+void BM_RadVectorReadResize(benchmark::State& state)
+{
+    const uint32_t count = static_cast<uint32_t>(state.range(0));
+    std::vector<uint8_t> frame(count, 5);
+    rad::Vector<uint8_t, radbench::Mallocator> vec;
+    for (auto _ : state)
+    {
+        vec.Clear();
+        RAD_UNUSED(vec.Resize(count));
+        memcpy(vec.Data(), frame.data(), count);
+        benchmark::DoNotOptimize(vec.Data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_RadVectorReadAppend(benchmark::State& state)
+{
+    const uint32_t count = static_cast<uint32_t>(state.range(0));
+    std::vector<uint8_t> frame(count, 5);
+    rad::Vector<uint8_t, radbench::Mallocator> vec;
+    for (auto _ : state)
+    {
+        vec.Clear();
+        rad::Span<uint8_t> span = vec.UninitializedAppend(count).Ok();
+        memcpy(span.Data(), frame.data(), count);
+        vec.CommitSize(count);
+        benchmark::DoNotOptimize(vec.Data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_RadVectorEqual(benchmark::State& state)
+{
+    const uint32_t count = static_cast<uint32_t>(state.range(0));
+    RadVector left;
+    RadVector right;
+    RAD_UNUSED(left.Resize(count, 3));
+    RAD_UNUSED(right.Resize(count, 3));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(left == right);
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) *
+                            static_cast<int64_t>(sizeof(int)));
+}
+
+void BM_RadFind(benchmark::State& state)
+{
+    const uint32_t count = static_cast<uint32_t>(state.range(0));
+    RadVector vec;
+    RAD_UNUSED(vec.Resize(count, 3));
+    vec.Back() = 4;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            rad::Find(vec.Data(), vec.Data() + vec.Size(), 4));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) *
+                            static_cast<int64_t>(sizeof(int)));
+}
+
+void BM_StdFind(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::vector<int> vec(count, 3);
+    vec.back() = 4;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(std::find(vec.begin(), vec.end(), 4));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) *
+                            static_cast<int64_t>(sizeof(int)));
+}
+
+} // namespace
+
+BENCHMARK(BM_RadVectorPushBack)->Range(8, 1 << 16);
+BENCHMARK(BM_StdVectorPushBack)->Range(8, 1 << 16);
+BENCHMARK(BM_RadVectorReservePushBack)->Range(8, 1 << 16);
+BENCHMARK(BM_StdVectorReservePushBack)->Range(8, 1 << 16);
+BENCHMARK(BM_RadVectorResize)->Range(8, 1 << 16);
+BENCHMARK(BM_StdVectorResize)->Range(8, 1 << 16);
+BENCHMARK(BM_RadVectorReadResize)->Range(8, 1 << 16);
+BENCHMARK(BM_RadVectorReadAppend)->Range(8, 1 << 16);
+BENCHMARK(BM_RadVectorEqual)->Range(8, 1 << 16);
+BENCHMARK(BM_RadFind)->Range(8, 1 << 16);
+BENCHMARK(BM_StdFind)->Range(8, 1 << 16);
@@ -67,3 +67,23 @@ RAD_DEFAULT_LINKOPTS = select({
     "//:gcc": RAD_GCC_LINKOPTS + RAD_ASAN_LINKOPTS,
     "//:clang": RAD_GCC_LINKOPTS,
 })
+
+# Enables 16 byte compare-exchange on x64, and with it the code paths behind
+# RAD_HAS_DWCAS. MSVC always has it on 64-bit targets.
+RAD_DWCAS_COPTS = select({
+    "//:gcc_x64": ["-mcx16"],
+    "//:clang_x64": ["-mcx16"],
+    "//conditions:default": [],
+})
+
+# Benchmarks are built without sanitizers so timings reflect release code.
+RAD_BENCH_COPTS = select({
+    "//:msvc": [
+        "/W4",
+        "/WX",
+        "/DNOMINMAX",
+        "/Zc:__cplusplus",
+    ],
+    "//:gcc": RAD_GCC_COPTS,
+    "//:clang": RAD_GCC_COPTS,
+})
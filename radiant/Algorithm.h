@@ -15,13 +15,27 @@
 #pragma once
 
 #include "radiant/TotallyRad.h"
+#include "radiant/Byte.h"
+#include "radiant/Iterator.h"
+#include "radiant/Span.h"
 // RAD_S_ASSERT_NOTHROW_MOVE_T uses TypeTraits.h
 #include "radiant/TypeTraits.h" // NOLINT(misc-include-cleaner)
 // rad::Move needs radiant/Utility.h
 #include "radiant/Utility.h" // NOLINT(misc-include-cleaner)
+#include "radiant/detail/SearchKernels.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <new> // NOLINT(misc-include-cleaner)
 
 namespace rad
 {
+// defined in radiant/Memory.h, which includes this header
+template <typename AllocT>
+class AllocTraits;
+
 template <typename T>
 void Swap(T& a, T& b) noexcept
 {
@@ -30,4 +44,1437 @@ void Swap(T& a, T& b) noexcept
     a = Move(b);
     b = Move(tmp);
 }
+
+/// @brief Function object comparing its arguments with operator<.
+/// @tparam T Type of the arguments, or void to compare any two types.
+template <typename T = void>
+struct Less
+{
+    constexpr bool operator()(const T& a, const T& b) const
+        noexcept(noexcept(a < b))
+    {
+        return a < b;
+    }
+};
+
+template <>
+struct Less<void>
+{
+    template <typename T, typename U>
+    constexpr bool operator()(const T& a, const U& b) const
+        noexcept(noexcept(a < b))
+    {
+        return a < b;
+    }
+};
+
+namespace detail
+{
+namespace sort
+{
+
+template <typename TIter>
+using ValueType = typename IteratorTraits<TIter>::ValueType;
+
+template <typename TIter>
+using DiffType = typename IteratorTraits<TIter>::DifferenceType;
+
+// Below this size ranges are insertion sorted.
+static constexpr int InsertionSortThreshold = 24;
+
+// Above this size the pivot is the pseudomedian of nine elements.
+static constexpr int NintherThreshold = 128;
+
+// Elements a partial insertion sort may move before it gives up.
+static constexpr int PartialInsertionSortLimit = 8;
+
+// Elements classified per block by the branchless partition.
+static constexpr int BlockSize = 64;
+
+// Trivially copyable elements are cheap to move around, which is what the
+// branchless partition trades its branch mispredictions for.
+template <typename T>
+RAD_INLINE_VAR constexpr bool UseBranchless =
+    IsTrivCopyCtor<T> && IsTrivCopyAssign<T> && IsTrivDtor<T>;
+
+template <typename TIter>
+struct PartitionResult
+{
+    TIter pivot;
+    bool alreadyPartitioned;
+};
+
+template <typename TIter>
+int Log2(DiffType<TIter> size) noexcept
+{
+    int log = 0;
+    while (size >>= 1)
+    {
+        ++log;
+    }
+
+    return log;
+}
+
+template <typename TIter>
+void IterSwap(TIter a, TIter b) noexcept
+{
+    Swap(*a, *b);
+}
+
+template <typename TIter, typename TComp>
+void Sort2(TIter a, TIter b, TComp& comp)
+{
+    if (comp(*b, *a))
+    {
+        IterSwap(a, b);
+    }
+}
+
+template <typename TIter, typename TComp>
+void Sort3(TIter a, TIter b, TIter c, TComp& comp)
+{
+    Sort2(a, b, comp);
+    Sort2(b, c, comp);
+    Sort2(a, b, comp);
+}
+
+template <typename TIter, typename TComp>
+void InsertionSort(TIter first, TIter last, TComp& comp)
+{
+    if (first == last)
+    {
+        return;
+    }
+
+    for (TIter cur = first + 1; cur != last; ++cur)
+    {
+        TIter sift = cur;
+        TIter prev = cur - 1;
+        if (comp(*sift, *prev))
+        {
+            ValueType<TIter> tmp = Move(*sift);
+            do
+            {
+                *sift-- = Move(*prev);
+            } while (sift != first && comp(tmp, *--prev));
+
+            *sift = Move(tmp);
+        }
+    }
+}
+
+// Requires *(first - 1) to be no greater than any element of the range, which
+// serves as the sentinel that stops each insertion.
+template <typename TIter, typename TComp>
+void UnguardedInsertionSort(TIter first, TIter last, TComp& comp)
+{
+    if (first == last)
+    {
+        return;
+    }
+
+    for (TIter cur = first + 1; cur != last; ++cur)
+    {
+        TIter sift = cur;
+        TIter prev = cur - 1;
+        if (comp(*sift, *prev))
+        {
+            ValueType<TIter> tmp = Move(*sift);
+            do
+            {
+                *sift-- = Move(*prev);
+            } while (comp(tmp, *--prev));
+
+            *sift = Move(tmp);
+        }
+    }
+}
+
+// Insertion sort which gives up once it has moved more than
+// PartialInsertionSortLimit elements. Returns true if the range is sorted.
+template <typename TIter, typename TComp>
+bool PartialInsertionSort(TIter first, TIter last, TComp& comp)
+{
+    if (first == last)
+    {
+        return true;
+    }
+
+    DiffType<TIter> moved = 0;
+    for (TIter cur = first + 1; cur != last; ++cur)
+    {
+        TIter sift = cur;
+        TIter prev = cur - 1;
+        if (comp(*sift, *prev))
+        {
+            ValueType<TIter> tmp = Move(*sift);
+            do
+            {
+                *sift-- = Move(*prev);
+            } while (sift != first && comp(tmp, *--prev));
+
+            *sift = Move(tmp);
+            moved += cur - sift;
+            if (moved > PartialInsertionSortLimit)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template <typename TIter, typename TComp>
+void SiftDown(TIter first,
+              DiffType<TIter> hole,
+              DiffType<TIter> size,
+              ValueType<TIter>&& value,
+              TComp& comp)
+{
+    DiffType<TIter> child = 2 * hole + 1;
+    while (child < size)
+    {
+        if (child + 1 < size && comp(first[child], first[child + 1]))
+        {
+            ++child;
+        }
+
+        if (!comp(value, first[child]))
+        {
+            break;
+        }
+
+        first[hole] = Move(first[child]);
+        hole = child;
+        child = 2 * hole + 1;
+    }
+
+    first[hole] = Move(value);
+}
+
+template <typename TIter, typename TComp>
+void MakeHeap(TIter first, TIter last, TComp& comp)
+{
+    const DiffType<TIter> size = last - first;
+    for (DiffType<TIter> i = size / 2; i-- > 0;)
+    {
+        ValueType<TIter> value = Move(first[i]);
+        SiftDown(first, i, size, Move(value), comp);
+    }
+}
+
+template <typename TIter, typename TComp>
+void SortHeap(TIter first, TIter last, TComp& comp)
+{
+    for (DiffType<TIter> size = last - first; size > 1; --size)
+    {
+        ValueType<TIter> value = Move(first[size - 1]);
+        first[size - 1] = Move(*first);
+        SiftDown(first, DiffType<TIter>(0), size - 1, Move(value), comp);
+    }
+}
+
+template <typename TIter, typename TComp>
+void HeapSelect(TIter first, TIter middle, TIter last, TComp& comp)
+{
+    MakeHeap(first, middle, comp);
+    const DiffType<TIter> size = middle - first;
+    for (TIter cur = middle; cur != last; ++cur)
+    {
+        if (comp(*cur, *first))
+        {
+            ValueType<TIter> value = Move(*cur);
+            *cur = Move(*first);
+            SiftDown(first, DiffType<TIter>(0), size, Move(value), comp);
+        }
+    }
+}
+
+// Moves the median of three or nine elements to *first. Afterwards some
+// element of (first, last) is no greater and *(last - 1) no less than it.
+template <typename TIter, typename TComp>
+void ChoosePivot(TIter first, TIter last, TComp& comp)
+{
+    const DiffType<TIter> size = last - first;
+    const DiffType<TIter> half = size / 2;
+    if (size > NintherThreshold)
+    {
+        Sort3(first, first + half, last - 1, comp);
+        Sort3(first + 1, first + (half - 1), last - 2, comp);
+        Sort3(first + 2, first + (half + 1), last - 3, comp);
+        Sort3(first + (half - 1), first + half, first + (half + 1), comp);
+        IterSwap(first, first + half);
+    }
+    else
+    {
+        Sort3(first + half, first, last - 1, comp);
+    }
+}
+
+// Partitions [first, last) around the pivot *first, placing elements equal
+// to it on the right, and returns the pivot's final position.
+template <typename TIter, typename TComp>
+PartitionResult<TIter> PartitionRight(TIter first, TIter last, TComp& comp)
+{
+    ValueType<TIter> pivot = Move(*first);
+    TIter left = first;
+    TIter right = last;
+
+    // ChoosePivot guarantees an element no less than the pivot on the left
+    // and, unless the pivot is the smallest element, one less on the right.
+    while (comp(*++left, pivot))
+    {
+    }
+
+    if (left - 1 == first)
+    {
+        while (left < right && !comp(*--right, pivot))
+        {
+        }
+    }
+    else
+    {
+        while (!comp(*--right, pivot))
+        {
+        }
+    }
+
+    const bool alreadyPartitioned = left >= right;
+    while (left < right)
+    {
+        IterSwap(left, right);
+        while (comp(*++left, pivot))
+        {
+        }
+
+        while (!comp(*--right, pivot))
+        {
+        }
+    }
+
+    TIter pivotPos = left - 1;
+    *first = Move(*pivotPos);
+    *pivotPos = Move(pivot);
+    return { pivotPos, alreadyPartitioned };
+}
+
+template <typename TIter>
+void SwapOffsets(TIter left,
+                 TIter right,
+                 const unsigned char* leftOffsets,
+                 const unsigned char* rightOffsets,
+                 size_t count,
+                 bool useSwaps) noexcept
+{
+    if (useSwaps)
+    {
+        // Equal counts arise from descending input, where a cyclic
+        // permutation would not leave the pairs in place.
+        for (size_t i = 0; i < count; ++i)
+        {
+            IterSwap(left + leftOffsets[i], right - rightOffsets[i]);
+        }
+    }
+    else if (count > 0)
+    {
+        TIter l = left + leftOffsets[0];
+        TIter r = right - rightOffsets[0];
+        ValueType<TIter> tmp = Move(*l);
+        *l = Move(*r);
+        for (size_t i = 1; i < count; ++i)
+        {
+            l = left + leftOffsets[i];
+            *r = Move(*l);
+            r = right - rightOffsets[i];
+            *l = Move(*r);
+        }
+
+        *r = Move(tmp);
+    }
+}
+
+// PartitionRight which classifies elements a block at a time, recording the
+// offsets of misplaced elements without branching on the comparison, then
+// swaps them in bulk. See Edelkamp and Weiss, "BlockQuicksort: How Branch
+// Mispredictions don't affect Quicksort".
+template <typename TIter, typename TComp>
+PartitionResult<TIter> PartitionRightBranchless(TIter first,
+                                                TIter last,
+                                                TComp& comp)
+{
+    ValueType<TIter> pivot = Move(*first);
+    TIter left = first;
+    TIter right = last;
+
+    while (comp(*++left, pivot))
+    {
+    }
+
+    if (left - 1 == first)
+    {
+        while (left < right && !comp(*--right, pivot))
+        {
+        }
+    }
+    else
+    {
+        while (!comp(*--right, pivot))
+        {
+        }
+    }
+
+    const bool alreadyPartitioned = left >= right;
+    if (!alreadyPartitioned)
+    {
+        IterSwap(left, right);
+        ++left;
+
+        alignas(64) unsigned char leftOffsets[BlockSize];
+        alignas(64) unsigned char rightOffsets[BlockSize];
+        TIter leftBase = left;
+        TIter rightBase = right;
+        size_t leftCount = 0;
+        size_t rightCount = 0;
+        size_t leftStart = 0;
+        size_t rightStart = 0;
+
+        while (left < right)
+        {
+            // Refill whichever blocks are empty, splitting the unclassified
+            // elements between them when both are.
+            const size_t unknown = static_cast<size_t>(right - left);
+            size_t leftSplit = 0;
+            if (leftCount == 0)
+            {
+                leftSplit = rightCount == 0 ? unknown / 2 : unknown;
+            }
+
+            size_t rightSplit = rightCount == 0 ? unknown - leftSplit : 0;
+            if (leftSplit > size_t(BlockSize))
+            {
+                leftSplit = BlockSize;
+            }
+
+            if (rightSplit > size_t(BlockSize))
+            {
+                rightSplit = BlockSize;
+            }
+
+            for (size_t i = 0; i < leftSplit; ++i)
+            {
+                leftOffsets[leftCount] = static_cast<unsigned char>(i);
+                leftCount += !comp(*left, pivot);
+                ++left;
+            }
+
+            for (size_t i = 0; i < rightSplit; ++i)
+            {
+                rightOffsets[rightCount] = static_cast<unsigned char>(i + 1);
+                rightCount += comp(*--right, pivot);
+            }
+
+            const size_t count = leftCount < rightCount ? leftCount
+                                                        : rightCount;
+            SwapOffsets(leftBase,
+                        rightBase,
+                        leftOffsets + leftStart,
+                        rightOffsets + rightStart,
+                        count,
+                        leftCount == rightCount);
+            leftCount -= count;
+            rightCount -= count;
+            leftStart += count;
+            rightStart += count;
+
+            if (leftCount == 0)
+            {
+                leftStart = 0;
+                leftBase = left;
+            }
+
+            if (rightCount == 0)
+            {
+                rightStart = 0;
+                rightBase = right;
+            }
+        }
+
+        // Every element is classified; move the leftovers of the one
+        // nonempty block to the boundary.
+        if (leftCount != 0)
+        {
+            while (leftCount-- > 0)
+            {
+                IterSwap(leftBase + leftOffsets[leftStart + leftCount],
+                         --right);
+            }
+
+            left = right;
+        }
+
+        if (rightCount != 0)
+        {
+            while (rightCount-- > 0)
+            {
+                IterSwap(rightBase - rightOffsets[rightStart + rightCount],
+                         left);
+                ++left;
+            }
+        }
+    }
+
+    TIter pivotPos = left - 1;
+    *first = Move(*pivotPos);
+    *pivotPos = Move(pivot);
+    return { pivotPos, alreadyPartitioned };
+}
+
+// Partitions [first, last) around the pivot *first, placing elements equal
+// to it on the left, and returns the pivot's final position. Used when the
+// pivot equals *(first - 1), so every element of the left part equals it.
+template <typename TIter, typename TComp>
+TIter PartitionLeft(TIter first, TIter last, TComp& comp)
+{
+    ValueType<TIter> pivot = Move(*first);
+    TIter left = first;
+    TIter right = last;
+
+    while (comp(pivot, *--right))
+    {
+    }
+
+    if (right + 1 == last)
+    {
+        while (left < right && !comp(pivot, *++left))
+        {
+        }
+    }
+    else
+    {
+        while (!comp(pivot, *++left))
+        {
+        }
+    }
+
+    while (left < right)
+    {
+        IterSwap(left, right);
+        while (comp(pivot, *--right))
+        {
+        }
+
+        while (!comp(pivot, *++left))
+        {
+        }
+    }
+
+    *first = Move(*right);
+    *right = Move(pivot);
+    return right;
+}
+
+template <typename TIter, typename TComp>
+PartitionResult<TIter> PartitionImpl(TrueType, // UseBranchless
+                                     TIter first,
+                                     TIter last,
+                                     TComp& comp)
+{
+    return PartitionRightBranchless(first, last, comp);
+}
+
+template <typename TIter, typename TComp>
+PartitionResult<TIter> PartitionImpl(FalseType, // !UseBranchless
+                                     TIter first,
+                                     TIter last,
+                                     TComp& comp)
+{
+    return PartitionRight(first, last, comp);
+}
+
+template <typename TIter, typename TComp>
+PartitionResult<TIter> Partition(TIter first, TIter last, TComp& comp)
+{
+    return PartitionImpl(
+        IntegralConstant<bool, UseBranchless<ValueType<TIter>>>{},
+        first,
+        last,
+        comp);
+}
+
+// Swaps a few elements of each side of an unbalanced partition to break up
+// the pattern which caused it.
+template <typename TIter>
+void BreakPatterns(TIter first, TIter pivot, TIter last) noexcept
+{
+    const DiffType<TIter> leftSize = pivot - first;
+    const DiffType<TIter> rightSize = last - (pivot + 1);
+    if (leftSize >= InsertionSortThreshold)
+    {
+        IterSwap(first, first + leftSize / 4);
+        IterSwap(pivot - 1, pivot - leftSize / 4);
+        if (leftSize > NintherThreshold)
+        {
+            IterSwap(first + 1, first + (leftSize / 4 + 1));
+            IterSwap(first + 2, first + (leftSize / 4 + 2));
+            IterSwap(pivot - 2, pivot - (leftSize / 4 + 1));
+            IterSwap(pivot - 3, pivot - (leftSize / 4 + 2));
+        }
+    }
+
+    if (rightSize >= InsertionSortThreshold)
+    {
+        IterSwap(pivot + 1, pivot + (1 + rightSize / 4));
+        IterSwap(last - 1, last - rightSize / 4);
+        if (rightSize > NintherThreshold)
+        {
+            IterSwap(pivot + 2, pivot + (2 + rightSize / 4));
+            IterSwap(pivot + 3, pivot + (3 + rightSize / 4));
+            IterSwap(last - 2, last - (1 + rightSize / 4));
+            IterSwap(last - 3, last - (2 + rightSize / 4));
+        }
+    }
+}
+
+// Pattern-defeating quicksort, after Orson Peters' pdqsort. Recurses into
+// the smaller partition so the stack depth stays logarithmic, and falls back
+// to heapsort after too many unbalanced partitions.
+template <typename TIter, typename TComp>
+void SortLoop(TIter first,
+              TIter last,
+              TComp& comp,
+              int badAllowed,
+              bool leftmost)
+{
+    while (true)
+    {
+        const DiffType<TIter> size = last - first;
+        if (size < InsertionSortThreshold)
+        {
+            if (leftmost)
+            {
+                InsertionSort(first, last, comp);
+            }
+            else
+            {
+                UnguardedInsertionSort(first, last, comp);
+            }
+
+            return;
+        }
+
+        ChoosePivot(first, last, comp);
+
+        // Nothing in the range is less than *(first - 1). If the pivot equals
+        // it, so does everything partitioned to its left, and only the right
+        // remains to be sorted.
+        if (!leftmost && !comp(*(first - 1), *first))
+        {
+            first = PartitionLeft(first, last, comp) + 1;
+            continue;
+        }
+
+        const PartitionResult<TIter> part = Partition(first, last, comp);
+        const TIter pivot = part.pivot;
+        const DiffType<TIter> leftSize = pivot - first;
+        const DiffType<TIter> rightSize = last - (pivot + 1);
+        if (leftSize < size / 8 || rightSize < size / 8)
+        {
+            if (--badAllowed == 0)
+            {
+                MakeHeap(first, last, comp);
+                SortHeap(first, last, comp);
+                return;
+            }
+
+            BreakPatterns(first, pivot, last);
+        }
+        else if (part.alreadyPartitioned &&
+                 PartialInsertionSort(first, pivot, comp) &&
+                 PartialInsertionSort(pivot + 1, last, comp))
+        {
+            return;
+        }
+
+        if (leftSize < rightSize)
+        {
+            SortLoop(first, pivot, comp, badAllowed, leftmost);
+            first = pivot + 1;
+            leftmost = false;
+        }
+        else
+        {
+            SortLoop(pivot + 1, last, comp, badAllowed, false);
+            last = pivot;
+        }
+    }
+}
+
+template <typename TIter, typename TComp>
+void NthElement(TIter first, TIter nth, TIter last, TComp& comp)
+{
+    int badAllowed = 2 * Log2<TIter>(last - first) + 1;
+    bool leftmost = true;
+    while (last - first > InsertionSortThreshold)
+    {
+        if (--badAllowed == 0)
+        {
+            HeapSelect(first, nth + 1, last, comp);
+            IterSwap(first, nth);
+            return;
+        }
+
+        ChoosePivot(first, last, comp);
+        if (!leftmost && !comp(*(first - 1), *first))
+        {
+            // everything up to the returned position equals the pivot
+            TIter pivot = PartitionLeft(first, last, comp);
+            if (nth <= pivot)
+            {
+                return;
+            }
+
+            first = pivot + 1;
+            continue;
+        }
+
+        const TIter pivot = Partition(first, last, comp).pivot;
+        if (pivot == nth)
+        {
+            return;
+        }
+
+        if (nth < pivot)
+        {
+            last = pivot;
+        }
+        else
+        {
+            first = pivot + 1;
+            leftmost = false;
+        }
+    }
+
+    InsertionSort(first, last, comp);
+}
+
+template <typename TIter, typename TComp>
+TIter LowerBound(TIter first,
+                 TIter last,
+                 const ValueType<TIter>& value,
+                 TComp& comp)
+{
+    DiffType<TIter> size = last - first;
+    while (size > 0)
+    {
+        const DiffType<TIter> half = size / 2;
+        if (comp(first[half], value))
+        {
+            first += half + 1;
+            size -= half + 1;
+        }
+        else
+        {
+            size = half;
+        }
+    }
+
+    return first;
+}
+
+template <typename TIter, typename TComp>
+TIter UpperBound(TIter first,
+                 TIter last,
+                 const ValueType<TIter>& value,
+                 TComp& comp)
+{
+    DiffType<TIter> size = last - first;
+    while (size > 0)
+    {
+        const DiffType<TIter> half = size / 2;
+        if (!comp(value, first[half]))
+        {
+            first += half + 1;
+            size -= half + 1;
+        }
+        else
+        {
+            size = half;
+        }
+    }
+
+    return first;
+}
+
+template <typename TIter>
+void Reverse(TIter first, TIter last) noexcept
+{
+    while (first != last && first != --last)
+    {
+        IterSwap(first, last);
+        ++first;
+    }
+}
+
+template <typename TIter>
+TIter Rotate(TIter first, TIter middle, TIter last) noexcept
+{
+    Reverse(first, middle);
+    Reverse(middle, last);
+    Reverse(first, last);
+    return first + (last - middle);
+}
+
+// Merges the sorted ranges [first, middle) and [middle, last) without extra
+// memory by rotating the upper part of the left range past the lower part of
+// the right range and recursing on both halves.
+template <typename TIter, typename TComp>
+void MergeInPlace(TIter first,
+                  TIter middle,
+                  TIter last,
+                  DiffType<TIter> leftSize,
+                  DiffType<TIter> rightSize,
+                  TComp& comp)
+{
+    while (leftSize != 0 && rightSize != 0)
+    {
+        if (leftSize + rightSize == 2)
+        {
+            Sort2(first, middle, comp);
+            return;
+        }
+
+        TIter leftCut;
+        TIter rightCut;
+        DiffType<TIter> leftCutSize;
+        DiffType<TIter> rightCutSize;
+        if (leftSize > rightSize)
+        {
+            leftCutSize = leftSize / 2;
+            leftCut = first + leftCutSize;
+            rightCut = LowerBound(middle, last, *leftCut, comp);
+            rightCutSize = rightCut - middle;
+        }
+        else
+        {
+            rightCutSize = rightSize / 2;
+            rightCut = middle + rightCutSize;
+            leftCut = UpperBound(first, middle, *rightCut, comp);
+            leftCutSize = leftCut - first;
+        }
+
+        TIter newMiddle = Rotate(leftCut, middle, rightCut);
+        MergeInPlace(first,
+                     leftCut,
+                     newMiddle,
+                     leftCutSize,
+                     rightCutSize,
+                     comp);
+        first = newMiddle;
+        middle = rightCut;
+        leftSize -= leftCutSize;
+        rightSize -= rightCutSize;
+    }
+}
+
+template <typename TIter, typename TComp>
+void StableSortInPlace(TIter first, TIter last, TComp& comp)
+{
+    const DiffType<TIter> size = last - first;
+    if (size <= InsertionSortThreshold)
+    {
+        InsertionSort(first, last, comp);
+        return;
+    }
+
+    TIter middle = first + size / 2;
+    StableSortInPlace(first, middle, comp);
+    StableSortInPlace(middle, last, comp);
+    if (comp(*middle, *(middle - 1)))
+    {
+        MergeInPlace(first, middle, last, middle - first, last - middle, comp);
+    }
+}
+
+// Merges the sorted ranges [first, middle) and [middle, last) by moving the
+// left one into uninitialized storage for at least middle - first elements.
+template <typename TIter, typename TComp>
+void MergeWithBuffer(TIter first,
+                     TIter middle,
+                     TIter last,
+                     ValueType<TIter>* buffer,
+                     TComp& comp)
+{
+    using T = ValueType<TIter>;
+
+    T* bufferEnd = buffer;
+    for (TIter cur = first; cur != middle; ++cur, ++bufferEnd)
+    {
+        ::new (static_cast<void*>(bufferEnd)) T(Move(*cur));
+    }
+
+    T* left = buffer;
+    TIter right = middle;
+    TIter out = first;
+    while (left != bufferEnd && right != last)
+    {
+        // ties take from the left to keep the sort stable
+        if (comp(*right, *left))
+        {
+            *out = Move(*right);
+            ++right;
+        }
+        else
+        {
+            *out = Move(*left);
+            ++left;
+        }
+
+        ++out;
+    }
+
+    for (; left != bufferEnd; ++left, ++out)
+    {
+        *out = Move(*left);
+    }
+
+    for (T* cur = buffer; cur != bufferEnd; ++cur)
+    {
+        cur->~T();
+    }
+}
+
+template <typename TIter, typename TComp>
+void StableSortWithBuffer(TIter first,
+                          TIter last,
+                          ValueType<TIter>* buffer,
+                          TComp& comp)
+{
+    const DiffType<TIter> size = last - first;
+    if (size <= InsertionSortThreshold)
+    {
+        InsertionSort(first, last, comp);
+        return;
+    }
+
+    TIter middle = first + size / 2;
+    StableSortWithBuffer(first, middle, buffer, comp);
+    StableSortWithBuffer(middle, last, buffer, comp);
+    if (comp(*middle, *(middle - 1)))
+    {
+        MergeWithBuffer(first, middle, last, buffer, comp);
+    }
+}
+
+} // namespace sort
+} // namespace detail
+
+/// @brief Sorts a range in place.
+/// @details Uses pattern-defeating quicksort, which runs in O(n log n) time
+/// in the worst case and in linear time on sorted, reverse sorted and many
+/// other patterned inputs. Trivially copyable elements are partitioned
+/// without branching on the comparison. The sort is not stable, neither
+/// allocates nor throws, and uses O(log n) stack.
+/// @param first Random access iterator to the first element.
+/// @param last Random access iterator past the last element.
+/// @param comp Strict weak ordering of the elements.
+template <typename TIter, typename TComp = Less<>>
+void Sort(TIter first, TIter last, TComp comp = TComp())
+{
+    RAD_S_ASSERT_NOTHROW_MOVE_T(detail::sort::ValueType<TIter>);
+    if (last - first > 1)
+    {
+        detail::sort::SortLoop(first,
+                               last,
+                               comp,
+                               detail::sort::Log2<TIter>(last - first),
+                               true);
+    }
+}
+
+/// @brief Sorts the elements of a span in place.
+/// @see Sort(TIter, TIter, TComp)
+template <typename T, SpanSizeType N, typename TComp = Less<>>
+void Sort(Span<T, N> span, TComp comp = TComp())
+{
+    Sort(span.begin(), span.end(), comp);
+}
+
+/// @brief Sorts a range in place, keeping equal elements in their original
+/// order.
+/// @details Merge sorts using a buffer for half of the elements obtained from
+/// the allocator, in O(n log n) time. If the allocation fails, the range is
+/// sorted without a buffer in O(n log^2 n) time instead, so the sort always
+/// succeeds. Using an allocator requires radiant/Memory.h.
+/// @param alloc Allocator for the merge buffer.
+/// @param first Random access iterator to the first element.
+/// @param last Random access iterator past the last element.
+/// @param comp Strict weak ordering of the elements.
+template <typename TAllocator, typename TIter, typename TComp = Less<>>
+void StableSort(TAllocator& alloc,
+                TIter first,
+                TIter last,
+                TComp comp = TComp())
+{
+    using T = detail::sort::ValueType<TIter>;
+    RAD_S_ASSERT_NOTHROW_MOVE_T(T);
+    RAD_S_ASSERTMSG(alignof(T) <= alignof(max_align_t),
+                    "StableSort does not support over-aligned types");
+
+    const auto size = last - first;
+    if (size <= detail::sort::InsertionSortThreshold)
+    {
+        detail::sort::InsertionSort(first, last, comp);
+        return;
+    }
+
+    using AllocatorTraits = AllocTraits<TAllocator>;
+    const size_t bufferCount = static_cast<size_t>(size - size / 2);
+    T* buffer = AllocatorTraits::template Alloc<T>(alloc, bufferCount);
+    if (buffer == nullptr)
+    {
+        detail::sort::StableSortInPlace(first, last, comp);
+        return;
+    }
+
+    detail::sort::StableSortWithBuffer(first, last, buffer, comp);
+    AllocatorTraits::Free(alloc, buffer, bufferCount);
+}
+
+/// @brief Stably sorts the elements of a span in place.
+/// @see StableSort(TAllocator&, TIter, TIter, TComp)
+template <typename TAllocator,
+          typename T,
+          SpanSizeType N,
+          typename TComp = Less<>>
+void StableSort(TAllocator& alloc, Span<T, N> span, TComp comp = TComp())
+{
+    StableSort(alloc, span.begin(), span.end(), comp);
+}
+
+/// @brief Rearranges a range so that [first, middle) holds its smallest
+/// elements in sorted order.
+/// @details The order of [middle, last) is unspecified. Selects the elements
+/// with a heap, in O(n log k) time for k = middle - first.
+/// @param first Random access iterator to the first element.
+/// @param middle Iterator past the last element to sort.
+/// @param last Random access iterator past the last element.
+/// @param comp Strict weak ordering of the elements.
+template <typename TIter, typename TComp = Less<>>
+void PartialSort(TIter first, TIter middle, TIter last, TComp comp = TComp())
+{
+    RAD_S_ASSERT_NOTHROW_MOVE_T(detail::sort::ValueType<TIter>);
+    if (first == middle)
+    {
+        return;
+    }
+
+    detail::sort::HeapSelect(first, middle, last, comp);
+    detail::sort::SortHeap(first, middle, comp);
+}
+
+/// @brief Partially sorts the elements of a span.
+/// @param span Elements to rearrange.
+/// @param count Number of smallest elements to sort to the front.
+/// @param comp Strict weak ordering of the elements.
+template <typename T, SpanSizeType N, typename TComp = Less<>>
+void PartialSort(Span<T, N> span, SpanSizeType count, TComp comp = TComp())
+{
+    RAD_ASSERT(count <= span.Size());
+    PartialSort(span.begin(), span.begin() + count, span.end(), comp);
+}
+
+/// @brief Rearranges a range so that *nth is the element which would be
+/// there if the range were sorted, no element before it is greater and no
+/// element after it is less.
+/// @details Runs in linear time on average, and O(n log n) in the worst case.
+/// @param first Random access iterator to the first element.
+/// @param nth Position to select the element for.
+/// @param last Random access iterator past the last element.
+/// @param comp Strict weak ordering of the elements.
+template <typename TIter, typename TComp = Less<>>
+void NthElement(TIter first, TIter nth, TIter last, TComp comp = TComp())
+{
+    RAD_S_ASSERT_NOTHROW_MOVE_T(detail::sort::ValueType<TIter>);
+    if (nth != last)
+    {
+        detail::sort::NthElement(first, nth, last, comp);
+    }
+}
+
+/// @brief Selects the nth element of a span.
+/// @see NthElement(TIter, TIter, TIter, TComp)
+template <typename T, SpanSizeType N, typename TComp = Less<>>
+void NthElement(Span<T, N> span, SpanSizeType nth, TComp comp = TComp())
+{
+    RAD_ASSERT(nth < span.Size());
+    NthElement(span.begin(), span.begin() + nth, span.end(), comp);
+}
+
+namespace detail
+{
+namespace search
+{
+
+// Pointer access to the elements of the contiguous iterators, raw pointers
+// and rad::Iterator over one.
+template <typename TIter>
+struct Contiguous
+{
+    static constexpr bool Value = false;
+};
+
+template <typename T>
+struct Contiguous<T*>
+{
+    static constexpr bool Value = true;
+    using ElementType = RemoveCV<T>;
+
+    static const ElementType* Get(T* it) noexcept
+    {
+        return it;
+    }
+};
+
+template <typename T>
+struct Contiguous<Iterator<T*>>
+{
+    static constexpr bool Value = true;
+    using ElementType = RemoveCV<T>;
+
+    static const ElementType* Get(Iterator<T*> it) noexcept
+    {
+        return it.operator->();
+    }
+};
+
+// Whether elements of T compare equal exactly when their bytes do.
+template <typename T>
+RAD_INLINE_VAR constexpr bool IsBytewiseEq =
+    IsIntegral<T> || is_enum<T>::value || IsPointer<T>;
+
+// Whether the searches over two iterator types can use the byte kernels.
+template <typename TIter1, typename TIter2>
+struct BytewiseRanges
+{
+    static constexpr bool Value = false;
+};
+
+template <typename TIter1, typename TIter2>
+using UseBytewise =
+    IntegralConstant<bool,
+                     Contiguous<TIter1>::Value && Contiguous<TIter2>::Value &&
+                         BytewiseRanges<TIter1, TIter2>::Value>;
+
+template <typename T1, typename T2>
+struct BytewiseRanges<T1*, T2*>
+{
+    static constexpr bool Value =
+        IsSame<RemoveCV<T1>, RemoveCV<T2>> && IsBytewiseEq<RemoveCV<T1>>;
+};
+
+template <typename T1, typename T2>
+struct BytewiseRanges<Iterator<T1*>, T2*> : BytewiseRanges<T1*, T2*>
+{
+};
+
+template <typename T1, typename T2>
+struct BytewiseRanges<T1*, Iterator<T2*>> : BytewiseRanges<T1*, T2*>
+{
+};
+
+template <typename T1, typename T2>
+struct BytewiseRanges<Iterator<T1*>, Iterator<T2*>> : BytewiseRanges<T1*, T2*>
+{
+};
+
+// Whether memcmp orders elements of T as operator< does.
+template <typename T>
+RAD_INLINE_VAR constexpr bool IsMemcmpOrdered =
+    sizeof(T) == 1 && ((IsIntegral<T> && !IsSigned<T>) || IsSame<T, Byte>);
+
+template <typename TIter, typename T>
+TIter Find(TIter first, TIter last, const T& value, FalseType)
+{
+    for (; first != last; ++first)
+    {
+        if (*first == value)
+        {
+            break;
+        }
+    }
+
+    return first;
+}
+
+template <typename TIter, typename T>
+TIter Find(TIter first, TIter last, const T& value, TrueType) noexcept
+{
+    const auto* begin = Contiguous<TIter>::Get(first);
+    const auto* found =
+        FindBytes(begin, Contiguous<TIter>::Get(last), value);
+    return first + (found - begin);
+}
+
+template <typename TIter, typename T>
+size_t Count(TIter first, TIter last, const T& value, FalseType)
+{
+    size_t count = 0;
+    for (; first != last; ++first)
+    {
+        if (*first == value)
+        {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+template <typename TIter, typename T>
+size_t Count(TIter first, TIter last, const T& value, TrueType) noexcept
+{
+    return CountBytes(Contiguous<TIter>::Get(first),
+                      Contiguous<TIter>::Get(last),
+                      value);
+}
+
+template <typename TIter1, typename TIter2>
+void Mismatch(TIter1& first1,
+              TIter1 last1,
+              TIter2& first2,
+              TIter2 last2,
+              FalseType)
+{
+    while (first1 != last1 && first2 != last2 && *first1 == *first2)
+    {
+        ++first1;
+        ++first2;
+    }
+}
+
+template <typename TIter1, typename TIter2>
+void Mismatch(TIter1& first1,
+              TIter1 last1,
+              TIter2& first2,
+              TIter2 last2,
+              TrueType) noexcept
+{
+    const auto* left = Contiguous<TIter1>::Get(first1);
+    const auto* right = Contiguous<TIter2>::Get(first2);
+    const auto size1 = Contiguous<TIter1>::Get(last1) - left;
+    const auto size2 = Contiguous<TIter2>::Get(last2) - right;
+    const size_t index = MismatchBytes(left,
+                                       right,
+                                       static_cast<size_t>(Min(size1, size2)));
+    first1 += static_cast<ptrdiff_t>(index);
+    first2 += static_cast<ptrdiff_t>(index);
+}
+
+template <typename TIter1, typename TIter2>
+bool Equal(
+    TIter1 first1, TIter1 last1, TIter2 first2, TIter2 last2, FalseType)
+{
+    Mismatch(first1, last1, first2, last2, FalseType());
+    return first1 == last1 && first2 == last2;
+}
+
+template <typename TIter1, typename TIter2>
+bool Equal(TIter1 first1,
+           TIter1 last1,
+           TIter2 first2,
+           TIter2 last2,
+           TrueType) noexcept
+{
+    const auto* left = Contiguous<TIter1>::Get(first1);
+    const auto* right = Contiguous<TIter2>::Get(first2);
+    const auto size = Contiguous<TIter1>::Get(last1) - left;
+    if (size != Contiguous<TIter2>::Get(last2) - right)
+    {
+        return false;
+    }
+
+    // memcmp must not be given the null pointer of an empty range
+    return size == 0 ||
+           memcmp(left, right, static_cast<size_t>(size) * sizeof(*left)) ==
+               0;
+}
+
+template <typename TIter1, typename TIter2>
+bool LexCompare(
+    TIter1 first1, TIter1 last1, TIter2 first2, TIter2 last2, FalseType)
+{
+    for (; first1 != last1 && first2 != last2; ++first1, ++first2)
+    {
+        if (*first1 < *first2)
+        {
+            return true;
+        }
+
+        if (*first2 < *first1)
+        {
+            return false;
+        }
+    }
+
+    return first1 == last1 && first2 != last2;
+}
+
+template <typename TIter1, typename TIter2>
+bool LexCompare(TIter1 first1,
+                TIter1 last1,
+                TIter2 first2,
+                TIter2 last2,
+                TrueType) noexcept
+{
+    const auto* left = Contiguous<TIter1>::Get(first1);
+    const auto* right = Contiguous<TIter2>::Get(first2);
+    const auto size1 = Contiguous<TIter1>::Get(last1) - left;
+    const auto size2 = Contiguous<TIter2>::Get(last2) - right;
+    const size_t common = static_cast<size_t>(Min(size1, size2));
+    using ElementType = typename Contiguous<TIter1>::ElementType;
+    if (IsMemcmpOrdered<ElementType>)
+    {
+        const int order = common == 0 ? 0 : memcmp(left, right, common);
+        return order != 0 ? order < 0 : size1 < size2;
+    }
+
+    const size_t index = MismatchBytes(left, right, common);
+    return index != common ? left[index] < right[index] : size1 < size2;
+}
+
+} // namespace search
+} // namespace detail
+
+/// @brief Finds the first element of a range equal to a value.
+/// @details Contiguous ranges of integers, enums and pointers are scanned a
+/// vector register at a time.
+/// @param first Iterator to the first element.
+/// @param last Iterator past the last element.
+/// @param value Value to compare the elements with.
+/// @return Iterator to the first matching element, or last if there is none.
+template <typename TIter, typename T>
+TIter Find(TIter first, TIter last, const T& value)
+{
+    using Tag = detail::search::UseBytewise<TIter, const T*>;
+    return detail::search::Find(first, last, value, Tag());
+}
+
+/// @brief Finds the first element of a span equal to a value.
+/// @see Find(TIter, TIter, const T&)
+template <typename T, SpanSizeType N, typename U>
+typename Span<T, N>::IteratorType Find(Span<T, N> span, const U& value)
+{
+    return Find(span.begin(), span.end(), value);
+}
+
+/// @brief Counts the elements of a range equal to a value.
+/// @see Find(TIter, TIter, const T&)
+template <typename TIter, typename T>
+size_t Count(TIter first, TIter last, const T& value)
+{
+    using Tag = detail::search::UseBytewise<TIter, const T*>;
+    return detail::search::Count(first, last, value, Tag());
+}
+
+/// @brief Counts the elements of a span equal to a value.
+/// @see Find(TIter, TIter, const T&)
+template <typename T, SpanSizeType N, typename U>
+size_t Count(Span<T, N> span, const U& value)
+{
+    return Count(span.begin(), span.end(), value);
+}
+
+/// @brief Iterators to the first elements at which two ranges differ.
+template <typename TIter1, typename TIter2>
+struct MismatchResult
+{
+    TIter1 first;
+    TIter2 second;
+};
+
+/// @brief Finds the first position at which two ranges differ.
+/// @details Contiguous ranges of the same integer, enum or pointer type are
+/// compared a vector register at a time.
+/// @param first1 Iterator to the first element of the first range.
+/// @param last1 Iterator past the last element of the first range.
+/// @param first2 Iterator to the first element of the second range.
+/// @param last2 Iterator past the last element of the second range.
+/// @return Iterators to the first unequal elements, or to the end of the
+/// shorter range and its counterpart in the other.
+template <typename TIter1, typename TIter2>
+MismatchResult<TIter1, TIter2> Mismatch(TIter1 first1,
+                                        TIter1 last1,
+                                        TIter2 first2,
+                                        TIter2 last2)
+{
+    detail::search::Mismatch(first1,
+                             last1,
+                             first2,
+                             last2,
+                             detail::search::UseBytewise<TIter1, TIter2>());
+    return { first1, first2 };
+}
+
+/// @brief Finds the first index at which two spans differ.
+/// @return Index of the first unequal elements, or the size of the shorter
+/// span.
+/// @see Mismatch(TIter1, TIter1, TIter2, TIter2)
+template <typename T, SpanSizeType N, typename U, SpanSizeType M>
+SpanSizeType Mismatch(Span<T, N> left, Span<U, M> right)
+{
+    const auto result =
+        Mismatch(left.begin(), left.end(), right.begin(), right.end());
+    return static_cast<SpanSizeType>(result.first - left.begin());
+}
+
+/// @brief Checks whether two ranges have the same size and equal elements.
+/// @details Contiguous ranges of the same integer, enum or pointer type are
+/// compared with memcmp.
+/// @see Mismatch(TIter1, TIter1, TIter2, TIter2)
+template <typename TIter1, typename TIter2>
+bool Equal(TIter1 first1, TIter1 last1, TIter2 first2, TIter2 last2)
+{
+    return detail::search::Equal(first1,
+                                 last1,
+                                 first2,
+                                 last2,
+                                 detail::search::UseBytewise<TIter1, TIter2>());
+}
+
+/// @brief Checks whether two spans have the same size and equal elements.
+/// @see Equal(TIter1, TIter1, TIter2, TIter2)
+template <typename T, SpanSizeType N, typename U, SpanSizeType M>
+bool Equal(Span<T, N> left, Span<U, M> right)
+{
+    return Equal(left.begin(), left.end(), right.begin(), right.end());
+}
+
+/// @brief Checks whether the first range orders lexicographically before the
+/// second, comparing elements with operator<.
+/// @details Contiguous ranges of the same integer, enum or pointer type find
+/// the first difference a vector register at a time, and unsigned bytes are
+/// ordered with memcmp.
+/// @see Mismatch(TIter1, TIter1, TIter2, TIter2)
+template <typename TIter1, typename TIter2>
+bool LexCompare(TIter1 first1, TIter1 last1, TIter2 first2, TIter2 last2)
+{
+    return detail::search::LexCompare(
+        first1,
+        last1,
+        first2,
+        last2,
+        detail::search::UseBytewise<TIter1, TIter2>());
+}
+
+/// @brief Checks whether the first span orders lexicographically before the
+/// second.
+/// @see LexCompare(TIter1, TIter1, TIter2, TIter2)
+template <typename T, SpanSizeType N, typename U, SpanSizeType M>
+bool LexCompare(Span<T, N> left, Span<U, M> right)
+{
+    return LexCompare(left.begin(), left.end(), right.begin(), right.end());
+}
+
 } // namespace rad
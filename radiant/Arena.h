@@ -0,0 +1,398 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Memory.h"
+
+#include <stddef.h>
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Header placed at the start of each arena block.
+struct ArenaBlock
+{
+    ArenaBlock* next;
+    size_t units;
+};
+
+/// @brief Internal use only. Bump state of an arena.
+struct ArenaState
+{
+    ArenaBlock* first = nullptr;
+    ArenaBlock* current = nullptr;
+    ArenaBlock* large = nullptr;
+    char* cursor = nullptr;
+    char* end = nullptr;
+};
+
+} // namespace detail
+
+/// @brief Bump allocation arena which carves allocations out of a chain of
+/// fixed-size blocks obtained from a backing allocator.
+/// @details Individual allocations are never freed. Memory is instead
+/// reclaimed in bulk, either by Reset(), which rewinds the arena in O(1) while
+/// retaining its blocks for reuse, or by Release(), which returns every block
+/// to the backing allocator. Requests larger than a block are served by a
+/// dedicated block which is returned to the backing allocator on Reset().
+///
+/// Allocations are aligned to alignof(max_align_t), matching the guarantees of
+/// typical AllocBytes implementations.
+///
+/// An arena is not thread-safe. Containers use an arena through
+/// ArenaAllocator, a lightweight handle that refers to the arena.
+/// @tparam TAllocator Backing allocator used to obtain blocks.
+/// @tparam TBlockSize Size in bytes of each block, including its header.
+template <typename TAllocator, size_t TBlockSize = 4096>
+class Arena final
+{
+private:
+
+    using UnitType = max_align_t;
+    using BlockType = detail::ArenaBlock;
+    using StateType = detail::ArenaState;
+    using AllocatorTraits = AllocTraits<TAllocator>;
+
+    static constexpr size_t UnitSize = sizeof(UnitType);
+    static constexpr size_t BlockUnits = TBlockSize / UnitSize;
+
+public:
+
+    using AllocatorType = TAllocator;
+    using ThisType = Arena<TAllocator, TBlockSize>;
+
+    static constexpr size_t BlockSize = BlockUnits * UnitSize;
+    static constexpr size_t Alignment = alignof(max_align_t);
+    static constexpr size_t HeaderSize =
+        (sizeof(BlockType) + Alignment - 1) & ~(Alignment - 1);
+
+    /// @brief Largest request which is served from a regular block.
+    static constexpr size_t MaxBlockAllocSize = BlockSize - HeaderSize;
+
+    RAD_S_ASSERTMSG(BlockSize > HeaderSize, "Arena block size is too small");
+    RAD_S_ASSERTMSG((Alignment & (Alignment - 1)) == 0,
+                    "Arena alignment must be a power of two");
+
+    RAD_NOT_COPYABLE(Arena);
+    Arena(Arena&&) = delete;
+    Arena& operator=(Arena&&) = delete;
+
+    ~Arena()
+    {
+        Release();
+    }
+
+    /// @brief Constructs an empty arena with a default-constructed backing
+    /// allocator.
+    Arena() noexcept = default;
+
+    /// @brief Constructs an empty arena with a copy-constructed backing
+    /// allocator.
+    /// @param alloc Backing allocator to copy.
+    explicit Arena(const AllocatorType& alloc) noexcept
+        : m_storage(alloc)
+    {
+    }
+
+    /// @brief Allocates a number of bytes from the arena.
+    /// @param size Number of bytes to allocate.
+    /// @return Pointer to the allocated memory, or nullptr on failure.
+    void* AllocBytes(size_t size)
+    {
+        if RAD_UNLIKELY (size > ~size_t(0) - Alignment)
+        {
+            return nullptr;
+        }
+
+        const size_t bytes = RoundUp(size == 0 ? 1 : size);
+
+        StateType& state = State();
+        if RAD_LIKELY (bytes <= static_cast<size_t>(state.end - state.cursor))
+        {
+            void* ptr = state.cursor;
+            state.cursor += bytes;
+            return ptr;
+        }
+
+        return AllocSlow(bytes);
+    }
+
+    /// @brief Attempts to grow an allocation without moving it.
+    /// @details Only the most recent allocation in the current block can grow,
+    /// and only while the block has room to spare.
+    /// @param ptr Allocation to grow.
+    /// @param size Current size of the allocation in bytes.
+    /// @param newSize Requested size of the allocation in bytes.
+    /// @return True if the allocation now spans newSize bytes, false otherwise.
+    bool TryExpandBytes(void* ptr, size_t size, size_t newSize) noexcept
+    {
+        if RAD_UNLIKELY (newSize > ~size_t(0) - Alignment)
+        {
+            return false;
+        }
+
+        StateType& state = State();
+
+        char* cur = static_cast<char*>(ptr);
+        const size_t bytes = RoundUp(size == 0 ? 1 : size);
+        if (cur == nullptr || cur + bytes != state.cursor)
+        {
+            return false;
+        }
+
+        const size_t newBytes = RoundUp(newSize == 0 ? 1 : newSize);
+        if (newBytes > static_cast<size_t>(state.end - cur))
+        {
+            return false;
+        }
+
+        state.cursor = cur + newBytes;
+        return true;
+    }
+
+    /// @brief Frees memory allocated from the arena. This is a no-op, memory is
+    /// reclaimed in bulk with Reset() or Release().
+    void FreeBytes(void* ptr, size_t size) noexcept
+    {
+        RAD_UNUSED(ptr);
+        RAD_UNUSED(size);
+    }
+
+    /// @brief Rewinds the arena, invalidating all allocations made from it.
+    /// @details Regular blocks are retained and reused by subsequent
+    /// allocations. Blocks dedicated to oversized requests are returned to the
+    /// backing allocator.
+    void Reset() noexcept
+    {
+        StateType& state = State();
+
+        FreeChain(state.large);
+        state.large = nullptr;
+
+        state.current = state.first;
+        SetCursor(state.current);
+    }
+
+    /// @brief Returns every block to the backing allocator, invalidating all
+    /// allocations made from the arena.
+    void Release() noexcept
+    {
+        StateType& state = State();
+
+        FreeChain(state.first);
+        FreeChain(state.large);
+        state = StateType();
+    }
+
+    /// @brief Returns the backing allocator.
+    /// @return The backing allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_storage.First();
+    }
+
+private:
+
+    static constexpr size_t RoundUp(size_t size) noexcept
+    {
+        return (size + Alignment - 1) & ~(Alignment - 1);
+    }
+
+    static char* Payload(BlockType* block) noexcept
+    {
+        return reinterpret_cast<char*>(block) + HeaderSize;
+    }
+
+    void SetCursor(BlockType* block) noexcept
+    {
+        StateType& state = State();
+
+        if (block == nullptr)
+        {
+            state.cursor = nullptr;
+            state.end = nullptr;
+        }
+        else
+        {
+            state.cursor = Payload(block);
+            state.end = reinterpret_cast<char*>(block) + BlockSize;
+        }
+    }
+
+    BlockType* NewBlock(size_t units)
+    {
+        UnitType* mem =
+            AllocatorTraits::template Alloc<UnitType>(Allocator(), units);
+        if (mem == nullptr)
+        {
+            return nullptr;
+        }
+
+        return ::new (static_cast<void*>(mem)) BlockType{ nullptr, units };
+    }
+
+    void FreeChain(BlockType* block) noexcept
+    {
+        while (block != nullptr)
+        {
+            BlockType* next = block->next;
+            size_t units = block->units;
+            AllocatorTraits::Free(Allocator(),
+                                  reinterpret_cast<UnitType*>(block),
+                                  units);
+            block = next;
+        }
+    }
+
+    void* AllocSlow(size_t bytes)
+    {
+        StateType& state = State();
+
+        if (bytes > MaxBlockAllocSize)
+        {
+            if RAD_UNLIKELY (bytes > ~size_t(0) - HeaderSize - UnitSize)
+            {
+                return nullptr;
+            }
+
+            const size_t units = (HeaderSize + bytes + UnitSize - 1) / UnitSize;
+            BlockType* block = NewBlock(units);
+            if (block == nullptr)
+            {
+                return nullptr;
+            }
+
+            block->next = state.large;
+            state.large = block;
+            return Payload(block);
+        }
+
+        BlockType* next =
+            (state.current != nullptr) ? state.current->next : nullptr;
+        if (next == nullptr)
+        {
+            next = NewBlock(BlockUnits);
+            if (next == nullptr)
+            {
+                return nullptr;
+            }
+
+            if (state.current != nullptr)
+            {
+                state.current->next = next;
+            }
+            else
+            {
+                state.first = next;
+            }
+        }
+
+        state.current = next;
+        SetCursor(next);
+
+        void* ptr = state.cursor;
+        state.cursor += bytes;
+        return ptr;
+    }
+
+    AllocatorType& Allocator() noexcept
+    {
+        return m_storage.First();
+    }
+
+    StateType& State() noexcept
+    {
+        return m_storage.Second();
+    }
+
+    EmptyOptimizedPair<AllocatorType, StateType> m_storage;
+};
+
+/// @brief Allocator handle referring to an Arena, satisfying the Radiant
+/// allocator contract.
+/// @details Freeing through the handle is a no-op. The arena must outlive all
+/// containers which allocate from it, and containers must not be used after
+/// the arena is reset or released. Handles compare equal when they refer to
+/// the same arena, and propagate with the containers that use them.
+/// @tparam TAllocator Backing allocator of the arena.
+/// @tparam TBlockSize Block size of the arena.
+template <typename TAllocator, size_t TBlockSize = 4096>
+class ArenaAllocator final
+{
+public:
+
+    static constexpr bool PropagateOnCopy = true;
+    static constexpr bool PropagateOnMoveAssignment = true;
+    static constexpr bool PropagateOnSwap = true;
+    static constexpr bool IsAlwaysEqual = false;
+    static constexpr bool HasTryExpandBytes = true;
+
+    using ArenaType = Arena<TAllocator, TBlockSize>;
+
+    /// @brief Constructs a handle to an arena.
+    /// @param arena Arena to allocate from.
+    explicit ArenaAllocator(ArenaType& arena) noexcept
+        : m_arena(&arena)
+    {
+    }
+
+    void* AllocBytes(size_t size)
+    {
+        return m_arena->AllocBytes(size);
+    }
+
+    bool TryExpandBytes(void* ptr, size_t size, size_t newSize) noexcept
+    {
+        return m_arena->TryExpandBytes(ptr, size, newSize);
+    }
+
+    void FreeBytes(void* ptr, size_t size) noexcept
+    {
+        RAD_UNUSED(ptr);
+        RAD_UNUSED(size);
+    }
+
+    static void HandleSizeOverflow() noexcept
+    {
+    }
+
+    bool operator==(const ArenaAllocator& other) const noexcept
+    {
+        return m_arena == other.m_arena;
+    }
+
+    bool operator!=(const ArenaAllocator& other) const noexcept
+    {
+        return m_arena != other.m_arena;
+    }
+
+    /// @brief Returns the arena this handle refers to.
+    /// @return The arena.
+    ArenaType& GetArena() const noexcept
+    {
+        return *m_arena;
+    }
+
+private:
+
+    ArenaType* m_arena;
+};
+
+} // namespace rad
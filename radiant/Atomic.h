@@ -15,8 +15,10 @@
 #pragma once
 
 #include "radiant/TotallyRad.h"
+#include "radiant/CacheAligned.h"
 #include "radiant/TypeTraits.h"
 #include "radiant/detail/AtomicIntrinsics.h"
+#include "radiant/detail/AtomicWait.h"
 
 #include <stddef.h>
 
@@ -159,6 +161,30 @@ public:
         return SelectIntrinsic<T>::FetchXor(m_val, val, Order());
     }
 
+    /// @brief Blocks until the value no longer equals old.
+    /// @details Returns only after observing a different value, but may not
+    /// notice a change which is reverted before it looks. Writers call
+    /// NotifyOne() or NotifyAll() after changing the value to wake waiters.
+    /// See RAD_ATOMIC_WAIT_PARKS for whether waiting blocks in the OS.
+    /// @param old Value to wait for a change from.
+    template <RAD_ATOMIC_MEMORDER_T>
+    void Wait(T old, RAD_ATOMIC_MEMORDER_P) const noexcept
+    {
+        detail::atomic::Wait(m_val, old, Order());
+    }
+
+    /// @brief Wakes at least one thread blocked in Wait(), if any.
+    void NotifyOne() noexcept
+    {
+        detail::atomic::NotifyOne(m_val);
+    }
+
+    /// @brief Wakes all threads blocked in Wait().
+    void NotifyAll() noexcept
+    {
+        detail::atomic::NotifyAll(m_val);
+    }
+
 #if !RAD_REQUIRE_EXPLICIT_ATOMIC_ORDERING
     operator T() const noexcept
     {
@@ -365,17 +391,127 @@ private:
     T m_val{};
 };
 
+#if RAD_HAS_DWCAS
+template <typename T>
+class AtomicDoubleWidth
+{
+public:
+
+    RAD_S_ASSERTMSG(sizeof(T) == 16,
+                    "rad::Atomic supports only integral, pointer and 16-byte "
+                    "types");
+
+    using ValueType = T;
+
+    constexpr AtomicDoubleWidth() noexcept = default;
+
+    constexpr AtomicDoubleWidth(T value) noexcept
+        : m_val(value)
+    {
+    }
+
+    RAD_NOT_COPYABLE(AtomicDoubleWidth);
+
+    template <RAD_ATOMIC_MEMORDER_T>
+    void Store(T val, RAD_ATOMIC_MEMORDER_P) noexcept
+    {
+        SelectIntrinsic<T>::Store(m_val, val, Order());
+    }
+
+    template <RAD_ATOMIC_MEMORDER_T>
+    T Load(RAD_ATOMIC_MEMORDER_P) const noexcept
+    {
+        return SelectIntrinsic<T>::Load(m_val, Order());
+    }
+
+    template <RAD_ATOMIC_MEMORDER_T>
+    T Exchange(T val, RAD_ATOMIC_MEMORDER_P) noexcept
+    {
+        return SelectIntrinsic<T>::Exchange(m_val, val, Order());
+    }
+
+    template <typename Success, typename Failure>
+    bool CompareExchangeWeak(T& expected,
+                             T desired,
+                             MemoryOrderTag<Success>,
+                             MemoryOrderTag<Failure>) noexcept
+    {
+        return SelectIntrinsic<T>::CompareExchangeWeak(m_val,
+                                                       desired,
+                                                       expected,
+                                                       Success(),
+                                                       Failure());
+    }
+
+    template <RAD_ATOMIC_MEMORDER_T>
+    bool CompareExchangeWeak(T& expected,
+                             T desired,
+                             RAD_ATOMIC_MEMORDER_P) noexcept
+    {
+        return CompareExchangeWeak<Order, Order>(expected,
+                                                 desired,
+                                                 Order(),
+                                                 Order());
+    }
+
+    template <typename Success, typename Failure>
+    bool CompareExchangeStrong(T& expected,
+                               T desired,
+                               MemoryOrderTag<Success>,
+                               MemoryOrderTag<Failure>) noexcept
+    {
+        return SelectIntrinsic<T>::CompareExchangeStrong(m_val,
+                                                         desired,
+                                                         expected,
+                                                         Success(),
+                                                         Failure());
+    }
+
+    template <RAD_ATOMIC_MEMORDER_T>
+    bool CompareExchangeStrong(T& expected,
+                               T desired,
+                               RAD_ATOMIC_MEMORDER_P) noexcept
+    {
+        return CompareExchangeStrong(expected, desired, Order(), Order());
+    }
+
+#if !RAD_REQUIRE_EXPLICIT_ATOMIC_ORDERING
+    operator T() const noexcept
+    {
+        return Load();
+    }
+
+    T operator=(T val) noexcept
+    {
+        Store(val);
+        return val;
+    }
+#endif // !RAD_REQUIRE_EXPLICIT_ATOMIC_ORDERING
+
+private:
+
+    // double-width compare-exchange requires natural alignment
+    alignas(16) mutable T m_val{};
+};
+
+template <typename T>
+using AtomicBase = Cond<IsIntegral<T>,
+                        AtomicIntegral<T>,
+                        Cond<IsPointer<T>,
+                             AtomicPointer<T>,
+                             AtomicDoubleWidth<T>>>;
+#else
+template <typename T>
+using AtomicBase = Cond<IsIntegral<T>, AtomicIntegral<T>, AtomicPointer<T>>;
+#endif
+
 } // namespace atomic
 } // namespace detail
 
 template <typename T>
-class Atomic final : public Cond<IsIntegral<T>,
-                                 detail::atomic::AtomicIntegral<T>,
-                                 detail::atomic::AtomicPointer<T>>
+class Atomic final : public detail::atomic::AtomicBase<T>
 {
-    using BaseType = Cond<IsIntegral<T>,
-                          detail::atomic::AtomicIntegral<T>,
-                          detail::atomic::AtomicPointer<T>>;
+    using BaseType = detail::atomic::AtomicBase<T>;
 
 public:
 
@@ -390,4 +526,31 @@ public:
     using BaseType::operator=;
 };
 
+RAD_BEGIN_CACHE_ALIGNED
+/// @brief Atomic which occupies a cache line of its own.
+/// @details Use for values written from different cores which would otherwise
+/// share a line with neighboring data, such as per-core statistics counters.
+/// The alignment is only honored for heap allocations when the allocator
+/// provides RAD_CACHE_LINE_SIZE alignment.
+/// @tparam T Integral or pointer type.
+template <typename T>
+class alignas(RAD_CACHE_LINE_SIZE) PaddedAtomic final
+    : public detail::atomic::AtomicBase<T>
+{
+    using BaseType = detail::atomic::AtomicBase<T>;
+
+public:
+
+    RAD_NOT_COPYABLE(PaddedAtomic);
+
+    constexpr PaddedAtomic() noexcept
+        : BaseType()
+    {
+    }
+
+    using BaseType::BaseType;
+    using BaseType::operator=;
+};
+RAD_END_CACHE_ALIGNED
+
 } // namespace rad
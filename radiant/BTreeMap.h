@@ -0,0 +1,1703 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Algorithm.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Tag selecting the constructor of a map entry
+/// from a key and the arguments of its value.
+struct BTreeEntryInPlaceTag
+{
+};
+
+/// @brief Internal use only. Bytes a B-tree node aims to occupy, a few cache
+/// lines, so a search touches a handful of lines per level.
+RAD_INLINE_VAR constexpr size_t BTreeNodeSize = 256;
+
+/// @brief Internal use only. Number of entries held by a node of a B-tree
+/// whose entries are entrySize bytes.
+constexpr uint32_t BTreeCapacity(size_t entrySize) noexcept
+{
+    return (BTreeNodeSize - 2 * sizeof(void*)) / entrySize < 3
+               ? 3
+           : (BTreeNodeSize - 2 * sizeof(void*)) / entrySize > 1024
+               ? 1024
+               : static_cast<uint32_t>((BTreeNodeSize - 2 * sizeof(void*)) /
+                                       entrySize);
+}
+
+template <typename TEntry, uint32_t TCapacity>
+struct BTreeInternalNode;
+
+/// @brief Internal use only. Node of a B-tree. Leaves are allocated as this
+/// type, internal nodes as BTreeInternalNode which adds the children.
+template <typename TEntry, uint32_t TCapacity>
+struct BTreeNode
+{
+    using InternalType = BTreeInternalNode<TEntry, TCapacity>;
+
+    BTreeNode* parent;
+    // index of this node in the parent's children
+    uint16_t position;
+    uint16_t count;
+    bool leaf;
+    alignas(TEntry) unsigned char storage[TCapacity * sizeof(TEntry)];
+
+    TEntry& Slot(uint32_t index) noexcept
+    {
+        return reinterpret_cast<TEntry*>(storage)[index];
+    }
+
+    TEntry* SlotPtr(uint32_t index) noexcept
+    {
+        return reinterpret_cast<TEntry*>(storage) + index;
+    }
+
+    BTreeNode*& Child(uint32_t index) noexcept
+    {
+        return static_cast<InternalType*>(this)->children[index];
+    }
+
+    void SetChild(uint32_t index, BTreeNode* child) noexcept
+    {
+        Child(index) = child;
+        child->parent = this;
+        child->position = static_cast<uint16_t>(index);
+    }
+};
+
+template <typename TEntry, uint32_t TCapacity>
+struct BTreeInternalNode : BTreeNode<TEntry, TCapacity>
+{
+    BTreeNode<TEntry, TCapacity>* children[TCapacity + 1];
+};
+
+} // namespace detail
+
+/// @brief Forward iterator over the entries of a B-tree, in key order.
+/// @tparam TNode Node type of the tree.
+/// @tparam TValue Type the iterator yields, possibly const.
+template <typename TNode, typename TValue>
+class BTreeIterator final
+{
+public:
+
+    using ValueType = TValue;
+
+    BTreeIterator() noexcept = default;
+
+    BTreeIterator(TNode* node, uint32_t pos) noexcept
+        : m_node(node),
+          m_pos(pos)
+    {
+    }
+
+    TValue& operator*() const noexcept
+    {
+        return m_node->Slot(m_pos);
+    }
+
+    TValue* operator->() const noexcept
+    {
+        return m_node->SlotPtr(m_pos);
+    }
+
+    BTreeIterator& operator++() noexcept
+    {
+        if (!m_node->leaf)
+        {
+            // leftmost entry of the right subtree
+            m_node = m_node->Child(m_pos + 1);
+            while (!m_node->leaf)
+            {
+                m_node = m_node->Child(0);
+            }
+
+            m_pos = 0;
+            return *this;
+        }
+
+        ++m_pos;
+        while (m_pos == m_node->count)
+        {
+            if (m_node->parent == nullptr)
+            {
+                m_node = nullptr;
+                m_pos = 0;
+                break;
+            }
+
+            m_pos = m_node->position;
+            m_node = m_node->parent;
+        }
+
+        return *this;
+    }
+
+    BTreeIterator operator++(int) noexcept
+    {
+        BTreeIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(const BTreeIterator& other) const noexcept
+    {
+        return m_node == other.m_node && m_pos == other.m_pos;
+    }
+
+    bool operator!=(const BTreeIterator& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+
+    TNode* m_node = nullptr;
+    uint32_t m_pos = 0;
+};
+
+/// @brief Pair of iterators delimiting the entries of a key range, usable
+/// in range-based for loops.
+template <typename TIter>
+struct BTreeRange
+{
+    TIter first;
+    TIter last;
+
+    TIter begin() const noexcept
+    {
+        return first;
+    }
+
+    TIter end() const noexcept
+    {
+        return last;
+    }
+};
+
+namespace detail
+{
+
+/// @brief Internal use only. B-tree shared by BTreeMap and BTreeSet.
+/// @tparam TEntry Type of the stored entries.
+/// @tparam TKeyOf Type with a static Get() returning the key of an entry.
+/// @tparam TLess Key ordering function object.
+/// @tparam TAllocator Allocator used for the nodes.
+template <typename TEntry, typename TKeyOf, typename TLess, typename TAllocator>
+class BTree final
+{
+private:
+
+    using AllocatorTraits = AllocTraits<TAllocator>;
+
+public:
+
+    using ThisType = BTree<TEntry, TKeyOf, TLess, TAllocator>;
+    using SizeType = size_t;
+
+    static constexpr uint32_t Capacity = BTreeCapacity(sizeof(TEntry));
+    // fewest entries of any node but the root
+    static constexpr uint32_t MinCount = (Capacity - 1) / 2;
+
+    using NodeType = BTreeNode<TEntry, Capacity>;
+    using InternalType = BTreeInternalNode<TEntry, Capacity>;
+
+    /// @brief Location of an entry, the node is nullptr past the end.
+    struct Position
+    {
+        NodeType* node;
+        uint32_t pos;
+    };
+
+    struct InsertPosition
+    {
+        Position at;
+        bool inserted;
+    };
+
+    RAD_NOT_COPYABLE(BTree);
+
+    ~BTree()
+    {
+        Release();
+    }
+
+    BTree() noexcept = default;
+
+    explicit BTree(const TAllocator& alloc) noexcept
+        : m_storage(alloc)
+    {
+    }
+
+    BTree(const TLess& less, const TAllocator& alloc) noexcept
+        : m_storage(alloc, less)
+    {
+    }
+
+    BTree(ThisType&& other) noexcept
+        : m_storage(other.Allocator(), other.Compare())
+    {
+        St() = other.St();
+        other.St() = State();
+    }
+
+    ThisType& operator=(ThisType&& other) noexcept
+    {
+        // Don't allow non-propagation of allocators
+        RAD_S_ASSERTMSG(
+            AllocatorTraits::IsAlwaysEqual ||
+                AllocatorTraits::PropagateOnMoveAssignment,
+            "Cannot use move assignment with this allocator, as it could cause "
+            "copies. Either change allocators, or use something like Clone().");
+
+        if RAD_UNLIKELY (this == &other)
+        {
+            return *this;
+        }
+
+        Release();
+        AllocatorTraits::PropagateOnMoveIfNeeded(Allocator(),
+                                                 other.Allocator());
+        Compare() = other.Compare();
+        St() = other.St();
+        other.St() = State();
+        return *this;
+    }
+
+    SizeType Size() const noexcept
+    {
+        return St().size;
+    }
+
+    uint32_t Height() const noexcept
+    {
+        NodeType* node = St().root;
+        if (node == nullptr)
+        {
+            return 0;
+        }
+
+        uint32_t height = 1;
+        for (; !node->leaf; node = node->Child(0))
+        {
+            ++height;
+        }
+
+        return height;
+    }
+
+    Position First() const noexcept
+    {
+        NodeType* node = St().root;
+        if (node == nullptr)
+        {
+            return Position{ nullptr, 0 };
+        }
+
+        while (!node->leaf)
+        {
+            node = node->Child(0);
+        }
+
+        return Position{ node, 0 };
+    }
+
+    template <typename TKey>
+    Position Find(const TKey& key) const noexcept
+    {
+        NodeType* node = St().root;
+        while (node != nullptr)
+        {
+            const uint32_t i = LowerIndex(node, key);
+            if (i < node->count && !Compare()(key, TKeyOf::Get(node->Slot(i))))
+            {
+                return Position{ node, i };
+            }
+
+            node = node->leaf ? nullptr : node->Child(i);
+        }
+
+        return Position{ nullptr, 0 };
+    }
+
+    template <typename TKey>
+    Position LowerBound(const TKey& key) const noexcept
+    {
+        Position result{ nullptr, 0 };
+        NodeType* node = St().root;
+        while (node != nullptr)
+        {
+            const uint32_t i = LowerIndex(node, key);
+            if (i < node->count)
+            {
+                result = Position{ node, i };
+            }
+
+            node = node->leaf ? nullptr : node->Child(i);
+        }
+
+        return result;
+    }
+
+    template <typename TKey>
+    Position UpperBound(const TKey& key) const noexcept
+    {
+        Position result{ nullptr, 0 };
+        NodeType* node = St().root;
+        while (node != nullptr)
+        {
+            const uint32_t i = UpperIndex(node, key);
+            if (i < node->count)
+            {
+                result = Position{ node, i };
+            }
+
+            node = node->leaf ? nullptr : node->Child(i);
+        }
+
+        return result;
+    }
+
+    /// @brief Inserts an entry constructed from args unless key is present.
+    template <typename TKey, typename... TArgs>
+    Res<InsertPosition> TryEmplace(const TKey& key, TArgs&&... args) noexcept(
+        IsNoThrowCtor<TEntry, TArgs&&...>)
+    {
+        RAD_S_ASSERT_NOTHROW((IsNoThrowCtor<TEntry, TArgs&&...>));
+
+        NodeType* node = St().root;
+        if (node == nullptr)
+        {
+            node = AllocateNode(true);
+            if (node == nullptr)
+            {
+                return Error::NoMemory;
+            }
+
+            node->parent = nullptr;
+            node->position = 0;
+            St().root = node;
+        }
+
+        uint32_t i;
+        while (true)
+        {
+            i = LowerIndex(node, key);
+            if (i < node->count && !Compare()(key, TKeyOf::Get(node->Slot(i))))
+            {
+                return InsertPosition{ Position{ node, i }, false };
+            }
+
+            if (node->leaf)
+            {
+                break;
+            }
+
+            node = node->Child(i);
+        }
+
+        // every full node from the leaf up splits, plus a new root if the
+        // splits reach it, so take all the nodes needed before changing
+        // anything
+        NodeType* spare = nullptr;
+        uint32_t needed = 0;
+        const NodeType* full = node;
+        for (; full != nullptr && full->count == Capacity; full = full->parent)
+        {
+            ++needed;
+        }
+
+        if (needed != 0 && full == nullptr)
+        {
+            ++needed;
+        }
+
+        for (uint32_t n = 0; n < needed; ++n)
+        {
+            // spares are used last allocated first, starting with the
+            // sibling of the leaf
+            NodeType* extra = AllocateNode(n + 1 == needed);
+            if (extra == nullptr)
+            {
+                FreeSpare(spare);
+                return Error::NoMemory;
+            }
+
+            extra->parent = spare;
+            spare = extra;
+        }
+
+        const Position at = OpenSlot(node, i, nullptr, spare);
+        RAD_ASSERT(spare == nullptr);
+        ::new (static_cast<void*>(at.node->SlotPtr(at.pos)))
+            TEntry(Forward<TArgs>(args)...);
+        ++St().size;
+        return InsertPosition{ at, true };
+    }
+
+    template <typename TKey>
+    bool Erase(const TKey& key) noexcept
+    {
+        const Position found = Find(key);
+        if (found.node == nullptr)
+        {
+            return false;
+        }
+
+        NodeType* node = found.node;
+        uint32_t i = found.pos;
+        if (!node->leaf)
+        {
+            // replace the entry with its predecessor, which is in a leaf
+            NodeType* leaf = node->Child(i);
+            while (!leaf->leaf)
+            {
+                leaf = leaf->Child(leaf->count);
+            }
+
+            node->Slot(i).~TEntry();
+            Relocate(node->SlotPtr(i), leaf->Slot(leaf->count - 1));
+            node = leaf;
+            i = node->count - 1u;
+        }
+        else
+        {
+            node->Slot(i).~TEntry();
+            for (uint32_t j = i + 1; j < node->count; ++j)
+            {
+                Relocate(node->SlotPtr(j - 1), node->Slot(j));
+            }
+        }
+
+        --node->count;
+        --St().size;
+        Rebalance(node);
+        return true;
+    }
+
+    void Clear() noexcept
+    {
+        Release();
+    }
+
+    void Swap(ThisType& other) noexcept
+    {
+        // Don't allow non-propagation of allocators
+        RAD_S_ASSERTMSG(
+            AllocatorTraits::IsAlwaysEqual || AllocatorTraits::PropagateOnSwap,
+            "Cannot use Swap with this allocator, as it could cause copies. "
+            "Either change allocators, or use move construction.");
+
+        const State state = St();
+        St() = other.St();
+        other.St() = state;
+
+        TLess less = Compare();
+        Compare() = other.Compare();
+        other.Compare() = less;
+
+        AllocatorTraits::PropagateOnSwapIfNeeded(Allocator(),
+                                                 other.Allocator());
+    }
+
+    /// @brief Copies the tree node for node, so the copy is as compact as
+    /// the original.
+    Res<ThisType> Clone() const noexcept(IsNoThrowCopyCtor<TEntry>)
+    {
+        RAD_S_ASSERT_NOTHROW(IsNoThrowCopyCtor<TEntry>);
+
+        ThisType local(Compare(),
+                       AllocatorTraits::SelectAllocOnCopy(
+                           const_cast<TAllocator&>(Allocator())));
+        if (St().root != nullptr)
+        {
+            NodeType* root = local.CloneNode(St().root);
+            if (root == nullptr)
+            {
+                return Error::NoMemory;
+            }
+
+            root->parent = nullptr;
+            root->position = 0;
+            local.St().root = root;
+            local.St().size = St().size;
+        }
+
+        return local;
+    }
+
+    TLess& Compare() noexcept
+    {
+        return m_storage.Second().First();
+    }
+
+    const TLess& Compare() const noexcept
+    {
+        return m_storage.Second().First();
+    }
+
+    TAllocator& Allocator() noexcept
+    {
+        return m_storage.First();
+    }
+
+    const TAllocator& Allocator() const noexcept
+    {
+        return m_storage.First();
+    }
+
+private:
+
+    struct State
+    {
+        NodeType* root = nullptr;
+        SizeType size = 0;
+    };
+
+    // first entry not less than key
+    template <typename TKey>
+    uint32_t LowerIndex(NodeType* node, const TKey& key) const noexcept
+    {
+        uint32_t low = 0;
+        uint32_t high = node->count;
+        while (low < high)
+        {
+            const uint32_t mid = (low + high) / 2;
+            if (Compare()(TKeyOf::Get(node->Slot(mid)), key))
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+
+        return low;
+    }
+
+    // first entry greater than key
+    template <typename TKey>
+    uint32_t UpperIndex(NodeType* node, const TKey& key) const noexcept
+    {
+        uint32_t low = 0;
+        uint32_t high = node->count;
+        while (low < high)
+        {
+            const uint32_t mid = (low + high) / 2;
+            if (!Compare()(key, TKeyOf::Get(node->Slot(mid))))
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+
+        return low;
+    }
+
+    static void Relocate(TEntry* dst, TEntry& src) noexcept
+    {
+        ::new (static_cast<void*>(dst)) TEntry(Move(src));
+        src.~TEntry();
+    }
+
+    // Makes room for an entry at pos of node, with right as the child
+    // following it in internal nodes. Full nodes are split with nodes taken
+    // from spare. Returns where the entry goes, for the caller to construct.
+    Position OpenSlot(NodeType* node,
+                      uint32_t pos,
+                      NodeType* right,
+                      NodeType*& spare) noexcept
+    {
+        if (node->count == Capacity)
+        {
+            constexpr uint32_t mid = Capacity / 2;
+            NodeType* sibling = spare;
+            spare = spare->parent;
+            RAD_ASSERT(sibling->leaf == node->leaf);
+
+            for (uint32_t j = mid + 1; j < Capacity; ++j)
+            {
+                Relocate(sibling->SlotPtr(j - mid - 1), node->Slot(j));
+            }
+
+            if (!node->leaf)
+            {
+                for (uint32_t j = mid + 1; j <= Capacity; ++j)
+                {
+                    sibling->SetChild(j - mid - 1, node->Child(j));
+                }
+            }
+
+            node->count = static_cast<uint16_t>(mid);
+            sibling->count = static_cast<uint16_t>(Capacity - mid - 1);
+
+            // the middle entry moves up, between node and its new sibling
+            NodeType* parent = node->parent;
+            if (parent == nullptr)
+            {
+                parent = spare;
+                spare = spare->parent;
+                parent->parent = nullptr;
+                parent->position = 0;
+                parent->count = 0;
+                parent->SetChild(0, node);
+                St().root = parent;
+            }
+
+            const Position up =
+                OpenSlot(parent, node->position, sibling, spare);
+            Relocate(up.node->SlotPtr(up.pos), node->Slot(mid));
+
+            if (pos > mid)
+            {
+                node = sibling;
+                pos -= mid + 1;
+            }
+        }
+
+        for (uint32_t j = node->count; j > pos; --j)
+        {
+            Relocate(node->SlotPtr(j), node->Slot(j - 1));
+        }
+
+        if (!node->leaf)
+        {
+            for (uint32_t j = node->count + 1u; j > pos + 1; --j)
+            {
+                node->SetChild(j, node->Child(j - 1));
+            }
+
+            node->SetChild(pos + 1, right);
+        }
+
+        ++node->count;
+        return Position{ node, pos };
+    }
+
+    // restores the minimum fill of node after an entry was removed from it
+    void Rebalance(NodeType* node) noexcept
+    {
+        while (true)
+        {
+            NodeType* parent = node->parent;
+            if (parent == nullptr)
+            {
+                if (node->count == 0)
+                {
+                    NodeType* child = node->leaf ? nullptr : node->Child(0);
+                    if (child != nullptr)
+                    {
+                        child->parent = nullptr;
+                        child->position = 0;
+                    }
+
+                    St().root = child;
+                    FreeNode(node);
+                }
+
+                return;
+            }
+
+            if (node->count >= MinCount)
+            {
+                return;
+            }
+
+            const uint32_t p = node->position;
+            if (p > 0 && parent->Child(p - 1)->count > MinCount)
+            {
+                RotateRight(parent, p - 1);
+                return;
+            }
+
+            if (p < parent->count && parent->Child(p + 1)->count > MinCount)
+            {
+                RotateLeft(parent, p);
+                return;
+            }
+
+            Merge(parent, p > 0 ? p - 1 : p);
+            node = parent;
+        }
+    }
+
+    // moves the last entry of child i up to the parent, and the parent's
+    // entry i down to child i + 1
+    static void RotateRight(NodeType* parent, uint32_t i) noexcept
+    {
+        NodeType* left = parent->Child(i);
+        NodeType* right = parent->Child(i + 1);
+        for (uint32_t j = right->count; j > 0; --j)
+        {
+            Relocate(right->SlotPtr(j), right->Slot(j - 1));
+        }
+
+        Relocate(right->SlotPtr(0), parent->Slot(i));
+        Relocate(parent->SlotPtr(i), left->Slot(left->count - 1u));
+        if (!right->leaf)
+        {
+            for (uint32_t j = right->count + 1u; j > 0; --j)
+            {
+                right->SetChild(j, right->Child(j - 1));
+            }
+
+            right->SetChild(0, left->Child(left->count));
+        }
+
+        --left->count;
+        ++right->count;
+    }
+
+    // moves the first entry of child i + 1 up to the parent, and the
+    // parent's entry i down to child i
+    static void RotateLeft(NodeType* parent, uint32_t i) noexcept
+    {
+        NodeType* left = parent->Child(i);
+        NodeType* right = parent->Child(i + 1);
+        Relocate(left->SlotPtr(left->count), parent->Slot(i));
+        Relocate(parent->SlotPtr(i), right->Slot(0));
+        for (uint32_t j = 1; j < right->count; ++j)
+        {
+            Relocate(right->SlotPtr(j - 1), right->Slot(j));
+        }
+
+        if (!right->leaf)
+        {
+            left->SetChild(left->count + 1u, right->Child(0));
+            for (uint32_t j = 1; j <= right->count; ++j)
+            {
+                right->SetChild(j - 1, right->Child(j));
+            }
+        }
+
+        ++left->count;
+        --right->count;
+    }
+
+    // merges child i + 1 and the parent's entry i into child i
+    void Merge(NodeType* parent, uint32_t i) noexcept
+    {
+        NodeType* left = parent->Child(i);
+        NodeType* right = parent->Child(i + 1);
+        const uint32_t base = left->count + 1u;
+        Relocate(left->SlotPtr(left->count), parent->Slot(i));
+        for (uint32_t j = 0; j < right->count; ++j)
+        {
+            Relocate(left->SlotPtr(base + j), right->Slot(j));
+        }
+
+        if (!left->leaf)
+        {
+            for (uint32_t j = 0; j <= right->count; ++j)
+            {
+                left->SetChild(base + j, right->Child(j));
+            }
+        }
+
+        left->count = static_cast<uint16_t>(base + right->count);
+        FreeNode(right);
+
+        for (uint32_t j = i + 1; j < parent->count; ++j)
+        {
+            Relocate(parent->SlotPtr(j - 1), parent->Slot(j));
+            parent->SetChild(j, parent->Child(j + 1));
+        }
+
+        --parent->count;
+    }
+
+    NodeType* AllocateNode(bool leaf) noexcept
+    {
+        NodeType* node;
+        if (leaf)
+        {
+            node = AllocatorTraits::template Alloc<NodeType>(Allocator(), 1);
+        }
+        else
+        {
+            node = AllocatorTraits::template Alloc<InternalType>(Allocator(),
+                                                                 1);
+        }
+
+        if (node != nullptr)
+        {
+            node->count = 0;
+            node->leaf = leaf;
+        }
+
+        return node;
+    }
+
+    void FreeNode(NodeType* node) noexcept
+    {
+        if (node->leaf)
+        {
+            AllocatorTraits::Free(Allocator(), node, 1);
+        }
+        else
+        {
+            AllocatorTraits::Free(Allocator(),
+                                  static_cast<InternalType*>(node),
+                                  1);
+        }
+    }
+
+    void FreeSpare(NodeType* spare) noexcept
+    {
+        while (spare != nullptr)
+        {
+            NodeType* next = spare->parent;
+            FreeNode(spare);
+            spare = next;
+        }
+    }
+
+    // destroys and frees a subtree, whose missing children are nullptr
+    void DestroyNode(NodeType* node) noexcept
+    {
+        if (!node->leaf)
+        {
+            for (uint32_t i = 0; i <= node->count; ++i)
+            {
+                if (node->Child(i) != nullptr)
+                {
+                    DestroyNode(node->Child(i));
+                }
+            }
+        }
+
+        if (!IsTrivDtor<TEntry>)
+        {
+            for (uint32_t i = 0; i < node->count; ++i)
+            {
+                node->Slot(i).~TEntry();
+            }
+        }
+
+        FreeNode(node);
+    }
+
+    NodeType* CloneNode(NodeType* src) noexcept
+    {
+        NodeType* node = AllocateNode(src->leaf);
+        if (node == nullptr)
+        {
+            return nullptr;
+        }
+
+        for (uint32_t i = 0; i < src->count; ++i)
+        {
+            ::new (static_cast<void*>(node->SlotPtr(i))) TEntry(src->Slot(i));
+        }
+
+        node->count = src->count;
+        if (!node->leaf)
+        {
+            for (uint32_t i = 0; i <= node->count; ++i)
+            {
+                node->Child(i) = nullptr;
+            }
+
+            for (uint32_t i = 0; i <= node->count; ++i)
+            {
+                NodeType* child = CloneNode(src->Child(i));
+                if (child == nullptr)
+                {
+                    DestroyNode(node);
+                    return nullptr;
+                }
+
+                node->SetChild(i, child);
+            }
+        }
+
+        return node;
+    }
+
+    void Release() noexcept
+    {
+        if (St().root != nullptr)
+        {
+            DestroyNode(St().root);
+        }
+
+        St() = State();
+    }
+
+    State& St() noexcept
+    {
+        return m_storage.Second().Second();
+    }
+
+    const State& St() const noexcept
+    {
+        return m_storage.Second().Second();
+    }
+
+    EmptyOptimizedPair<TAllocator, EmptyOptimizedPair<TLess, State>>
+        m_storage;
+};
+
+template <typename TEntry>
+struct BTreeMapKeyOf
+{
+    static const typename TEntry::KeyType& Get(const TEntry& entry) noexcept
+    {
+        return entry.Key();
+    }
+};
+
+template <typename K>
+struct BTreeSetKeyOf
+{
+    static const K& Get(const K& key) noexcept
+    {
+        return key;
+    }
+};
+
+} // namespace detail
+
+/// @brief Key and value stored in a BTreeMap.
+/// @details The key is only exposed as const, as changing it would break the
+/// ordering.
+template <typename K, typename V>
+class BTreeMapEntry final
+{
+public:
+
+    using KeyType = K;
+
+    template <typename TKey, typename... TArgs>
+    BTreeMapEntry(detail::BTreeEntryInPlaceTag,
+                  TKey&& key,
+                  TArgs&&... args) noexcept(IsNoThrowCtor<K, TKey&&> &&
+                                            IsNoThrowCtor<V, TArgs&&...>)
+        : m_key(Forward<TKey>(key)),
+          m_value(Forward<TArgs>(args)...)
+    {
+    }
+
+    BTreeMapEntry(const BTreeMapEntry&) = default;
+    BTreeMapEntry(BTreeMapEntry&&) = default;
+    BTreeMapEntry& operator=(const BTreeMapEntry&) = delete;
+    BTreeMapEntry& operator=(BTreeMapEntry&&) = delete;
+
+    const K& Key() const noexcept
+    {
+        return m_key;
+    }
+
+    V& Value() noexcept
+    {
+        return m_value;
+    }
+
+    const V& Value() const noexcept
+    {
+        return m_value;
+    }
+
+private:
+
+    K m_key;
+    V m_value;
+};
+
+/// @brief Ordered map storing its entries in a B-tree with wide nodes.
+/// @details Each node holds as many entries as fit in a few cache lines, and
+/// is searched with a binary search over its keys, so a lookup touches a few
+/// lines on each of a handful of levels rather than one node per comparison
+/// as in a binary tree. Entries are kept sorted by key, and iteration visits
+/// them in order.
+///
+/// Insertion allocates every node it may need before changing the tree, so
+/// a failed insertion returns Error::NoMemory and leaves the map unchanged.
+/// Insertion and erasure move entries between nodes, which invalidates
+/// pointers and iterators to entries.
+///
+/// Lookups are templated on the key type, so any type the comparator accepts
+/// along with K can be used to look up an entry without constructing a K.
+/// @tparam K Key type, which must be nothrow move constructible.
+/// @tparam V Value type, which must be nothrow move constructible.
+/// @tparam TAllocator Allocator used for the nodes. It comes before the
+/// comparator as it has no default in builds without a default allocator.
+/// @tparam TLess Key ordering function object.
+template <typename K,
+          typename V,
+          typename TAllocator RAD_ALLOCATOR_EQ(K),
+          typename TLess = Less<K>>
+class BTreeMap final
+{
+public:
+
+    using ThisType = BTreeMap<K, V, TAllocator, TLess>;
+    using KeyType = K;
+    using MappedType = V;
+    using EntryType = BTreeMapEntry<K, V>;
+    using SizeType = size_t;
+    using KeyCompareType = TLess;
+    using AllocatorType = TAllocator;
+
+private:
+
+    using TreeType = detail::
+        BTree<EntryType, detail::BTreeMapKeyOf<EntryType>, TLess, TAllocator>;
+    using NodeType = typename TreeType::NodeType;
+
+public:
+
+    using IteratorType = BTreeIterator<NodeType, EntryType>;
+    using ConstIteratorType = BTreeIterator<NodeType, const EntryType>;
+
+    /// @brief Number of entries held by each node.
+    static constexpr uint32_t NodeCapacity = TreeType::Capacity;
+
+    /// @brief Result of an insertion.
+    struct InsertResult
+    {
+        /// @brief Entry holding the key, either inserted or already present.
+        EntryType* entry;
+        /// @brief True if the entry was inserted.
+        bool inserted;
+    };
+
+    RAD_S_ASSERT_NOTHROW_MOVE_T(K);
+    RAD_S_ASSERT_NOTHROW_MOVE_T(V);
+
+    RAD_NOT_COPYABLE(BTreeMap);
+
+    ~BTreeMap()
+    {
+        RAD_S_ASSERT_NOTHROW_DTOR(IsNoThrowDtor<K> && IsNoThrowDtor<V>);
+    }
+
+    /// @brief Constructs an empty map with default-constructed comparator
+    /// and allocator.
+    BTreeMap() noexcept = default;
+
+    /// @brief Constructs an empty map with a copy-constructed allocator.
+    /// @param alloc Allocator to copy.
+    explicit BTreeMap(const AllocatorType& alloc) noexcept
+        : m_tree(alloc)
+    {
+    }
+
+    /// @brief Constructs an empty map with copy-constructed comparator and
+    /// allocator.
+    /// @param less Comparator to copy.
+    /// @param alloc Allocator to copy.
+    BTreeMap(const KeyCompareType& less, const AllocatorType& alloc) noexcept
+        : m_tree(less, alloc)
+    {
+    }
+
+    /// @brief Move constructs a map from another, leaving it empty.
+    /// @param other Map to steal from.
+    BTreeMap(ThisType&& other) noexcept = default;
+
+    /// @brief Moves the entries of another map into this, leaving it empty.
+    /// @param other Map to move entries from.
+    /// @return Reference to this map.
+    ThisType& operator=(ThisType&& other) noexcept
+    {
+        m_tree = Move(other.m_tree);
+        return *this;
+    }
+
+    /// @brief Checks if the map is empty.
+    /// @return True if the map holds no entries.
+    bool Empty() const noexcept
+    {
+        return m_tree.Size() == 0;
+    }
+
+    /// @brief Gets the number of entries in the map.
+    /// @return Number of entries.
+    SizeType Size() const noexcept
+    {
+        return m_tree.Size();
+    }
+
+    /// @brief Gets the number of levels of the tree.
+    /// @return Number of nodes on the path from the root to any leaf.
+    uint32_t Height() const noexcept
+    {
+        return m_tree.Height();
+    }
+
+    RAD_NODISCARD IteratorType begin() noexcept
+    {
+        return Iter<IteratorType>(m_tree.First());
+    }
+
+    RAD_NODISCARD IteratorType end() noexcept
+    {
+        return IteratorType();
+    }
+
+    RAD_NODISCARD ConstIteratorType begin() const noexcept
+    {
+        return Iter<ConstIteratorType>(m_tree.First());
+    }
+
+    RAD_NODISCARD ConstIteratorType end() const noexcept
+    {
+        return ConstIteratorType();
+    }
+
+    RAD_NODISCARD ConstIteratorType cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    RAD_NODISCARD ConstIteratorType cend() const noexcept
+    {
+        return end();
+    }
+
+    /// @brief Destroys all entries and frees the nodes.
+    /// @return Reference to this map.
+    ThisType& Clear() noexcept
+    {
+        m_tree.Clear();
+        return *this;
+    }
+
+    /// @brief Inserts an entry constructed from a key and value arguments,
+    /// unless the key is already present.
+    /// @details Nothing is constructed if the key is present.
+    /// @param key Key of the entry, used to construct a K on insertion.
+    /// @param args Arguments for V construction.
+    /// @return The entry holding the key and whether it was inserted, or
+    /// Error::NoMemory if a node could not be allocated.
+    template <typename TKey, typename... TArgs>
+    Res<InsertResult> TryEmplace(TKey&& key, TArgs&&... args) noexcept(
+        IsNoThrowCtor<K, TKey&&> && IsNoThrowCtor<V, TArgs&&...>)
+    {
+        auto res = m_tree.TryEmplace(key,
+                                     detail::BTreeEntryInPlaceTag{},
+                                     Forward<TKey>(key),
+                                     Forward<TArgs>(args)...);
+        if (res.IsErr())
+        {
+            return res.Err();
+        }
+
+        const auto at = res.Ok().at;
+        return InsertResult{ at.node->SlotPtr(at.pos), res.Ok().inserted };
+    }
+
+    /// @brief Inserts an entry unless the key is already present.
+    /// @param key Key of the entry, used to construct a K on insertion.
+    /// @param value Value of the entry, used to construct a V on insertion.
+    /// @return The entry holding the key and whether it was inserted, or
+    /// Error::NoMemory if a node could not be allocated.
+    template <typename TKey, typename TValue>
+    Res<InsertResult> Insert(TKey&& key, TValue&& value) noexcept(
+        IsNoThrowCtor<K, TKey&&> && IsNoThrowCtor<V, TValue&&>)
+    {
+        return TryEmplace(Forward<TKey>(key), Forward<TValue>(value));
+    }
+
+    /// @brief Inserts an entry, or assigns the value if the key is already
+    /// present.
+    /// @param key Key of the entry, used to construct a K on insertion.
+    /// @param value Value to assign or insert.
+    /// @return The value in the map, or Error::NoMemory if a node could not
+    /// be allocated.
+    template <typename TKey, typename TValue>
+    Res<V&> InsertOrAssign(TKey&& key, TValue&& value) noexcept(
+        IsNoThrowCtor<K, TKey&&> && IsNoThrowCtor<V, TValue&&> &&
+        IsNoThrowAssign<V&, TValue&&>)
+    {
+        RAD_S_ASSERT_NOTHROW((IsNoThrowAssign<V&, TValue&&>));
+
+        V* existing = Find(key);
+        if (existing != nullptr)
+        {
+            *existing = Forward<TValue>(value);
+            return *existing;
+        }
+
+        auto res = TryEmplace(Forward<TKey>(key), Forward<TValue>(value));
+        if (res.IsErr())
+        {
+            return res.Err();
+        }
+
+        return res.Ok().entry->Value();
+    }
+
+    /// @brief Finds the entry of a key.
+    /// @param key Key to look up.
+    /// @return The entry, or nullptr if the key is not present.
+    template <typename TKey>
+    EntryType* FindEntry(const TKey& key) noexcept
+    {
+        const auto at = m_tree.Find(key);
+        return at.node == nullptr ? nullptr : at.node->SlotPtr(at.pos);
+    }
+
+    /// @copydoc FindEntry
+    template <typename TKey>
+    const EntryType* FindEntry(const TKey& key) const noexcept
+    {
+        const auto at = m_tree.Find(key);
+        return at.node == nullptr ? nullptr : at.node->SlotPtr(at.pos);
+    }
+
+    /// @brief Finds the value of a key.
+    /// @param key Key to look up.
+    /// @return The value, or nullptr if the key is not present.
+    template <typename TKey>
+    V* Find(const TKey& key) noexcept
+    {
+        EntryType* entry = FindEntry(key);
+        return entry == nullptr ? nullptr : &entry->Value();
+    }
+
+    /// @copydoc Find
+    template <typename TKey>
+    const V* Find(const TKey& key) const noexcept
+    {
+        const EntryType* entry = FindEntry(key);
+        return entry == nullptr ? nullptr : &entry->Value();
+    }
+
+    /// @brief Seeks the value of a key.
+    /// @param key Key to look up.
+    /// @return The value, or Error::OutOfRange if the key is not present.
+    template <typename TKey>
+    Res<V&> Seek(const TKey& key) noexcept
+    {
+        V* value = Find(key);
+        if (value == nullptr)
+        {
+            return Error::OutOfRange;
+        }
+
+        return *value;
+    }
+
+    /// @copydoc Seek
+    template <typename TKey>
+    Res<const V&> Seek(const TKey& key) const noexcept
+    {
+        const V* value = Find(key);
+        if (value == nullptr)
+        {
+            return Error::OutOfRange;
+        }
+
+        return *value;
+    }
+
+    /// @brief Checks whether a key is present.
+    /// @param key Key to look up.
+    /// @return True if the map holds the key.
+    template <typename TKey>
+    bool Contains(const TKey& key) const noexcept
+    {
+        return m_tree.Find(key).node != nullptr;
+    }
+
+    /// @brief Finds the first entry whose key is not less than a key.
+    /// @param key Key to compare with.
+    /// @return Iterator to the entry, or end() if there is none.
+    template <typename TKey>
+    IteratorType LowerBound(const TKey& key) noexcept
+    {
+        return Iter<IteratorType>(m_tree.LowerBound(key));
+    }
+
+    /// @copydoc LowerBound
+    template <typename TKey>
+    ConstIteratorType LowerBound(const TKey& key) const noexcept
+    {
+        return Iter<ConstIteratorType>(m_tree.LowerBound(key));
+    }
+
+    /// @brief Finds the first entry whose key is greater than a key.
+    /// @param key Key to compare with.
+    /// @return Iterator to the entry, or end() if there is none.
+    template <typename TKey>
+    IteratorType UpperBound(const TKey& key) noexcept
+    {
+        return Iter<IteratorType>(m_tree.UpperBound(key));
+    }
+
+    /// @copydoc UpperBound
+    template <typename TKey>
+    ConstIteratorType UpperBound(const TKey& key) const noexcept
+    {
+        return Iter<ConstIteratorType>(m_tree.UpperBound(key));
+    }
+
+    /// @brief Gets the entries whose keys are in [low, high).
+    /// @param low Smallest key of the range.
+    /// @param high Key following the range.
+    /// @return The entries, in key order.
+    template <typename TKey>
+    BTreeRange<IteratorType> Range(const TKey& low, const TKey& high) noexcept
+    {
+        return { LowerBound(low), LowerBound(high) };
+    }
+
+    /// @copydoc Range
+    template <typename TKey>
+    BTreeRange<ConstIteratorType> Range(const TKey& low,
+                                        const TKey& high) const noexcept
+    {
+        return { LowerBound(low), LowerBound(high) };
+    }
+
+    /// @brief Removes the entry of a key.
+    /// @param key Key to remove.
+    /// @return True if an entry was removed.
+    template <typename TKey>
+    bool Erase(const TKey& key) noexcept
+    {
+        return m_tree.Erase(key);
+    }
+
+    /// @brief Exchanges the contents of two maps.
+    /// @param other Map to swap with.
+    /// @return Reference to this map.
+    ThisType& Swap(ThisType& other) noexcept
+    {
+        m_tree.Swap(other.m_tree);
+        return *this;
+    }
+
+    /// @brief Creates a copy of the map with the same node layout.
+    /// @return The new map on success or an error.
+    Res<ThisType> Clone() const noexcept(IsNoThrowCopyCtor<K> &&
+                                         IsNoThrowCopyCtor<V>)
+    {
+        auto res = m_tree.Clone();
+        if (res.IsErr())
+        {
+            return res.Err();
+        }
+
+        return ThisType(Move(res.Ok()));
+    }
+
+    /// @brief Returns the key comparator.
+    /// @return The key comparator.
+    KeyCompareType GetKeyCompare() const noexcept
+    {
+        return m_tree.Compare();
+    }
+
+    /// @brief Returns the allocator.
+    /// @return The allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_tree.Allocator();
+    }
+
+private:
+
+    explicit BTreeMap(TreeType&& tree) noexcept
+        : m_tree(Move(tree))
+    {
+    }
+
+    template <typename TIter>
+    static TIter Iter(typename TreeType::Position at) noexcept
+    {
+        return at.node == nullptr ? TIter() : TIter(at.node, at.pos);
+    }
+
+    TreeType m_tree;
+};
+
+/// @brief Ordered set storing its keys in a B-tree with wide nodes.
+/// @details The set counterpart of BTreeMap, with the same node layout,
+/// failure behavior and iterator invalidation. Keys are only exposed as
+/// const.
+/// @tparam K Key type, which must be nothrow move constructible.
+/// @tparam TAllocator Allocator used for the nodes.
+/// @tparam TLess Key ordering function object.
+template <typename K,
+          typename TAllocator RAD_ALLOCATOR_EQ(K),
+          typename TLess = Less<K>>
+class BTreeSet final
+{
+public:
+
+    using ThisType = BTreeSet<K, TAllocator, TLess>;
+    using KeyType = K;
+    using SizeType = size_t;
+    using KeyCompareType = TLess;
+    using AllocatorType = TAllocator;
+
+private:
+
+    using TreeType =
+        detail::BTree<K, detail::BTreeSetKeyOf<K>, TLess, TAllocator>;
+    using NodeType = typename TreeType::NodeType;
+
+public:
+
+    using IteratorType = BTreeIterator<NodeType, const K>;
+    using ConstIteratorType = IteratorType;
+
+    /// @brief Number of keys held by each node.
+    static constexpr uint32_t NodeCapacity = TreeType::Capacity;
+
+    /// @brief Result of an insertion.
+    struct InsertResult
+    {
+        /// @brief Key in the set, either inserted or already present.
+        const K* key;
+        /// @brief True if the key was inserted.
+        bool inserted;
+    };
+
+    RAD_S_ASSERT_NOTHROW_MOVE_T(K);
+
+    RAD_NOT_COPYABLE(BTreeSet);
+
+    ~BTreeSet()
+    {
+        RAD_S_ASSERT_NOTHROW_DTOR(IsNoThrowDtor<K>);
+    }
+
+    /// @brief Constructs an empty set with default-constructed comparator
+    /// and allocator.
+    BTreeSet() noexcept = default;
+
+    /// @brief Constructs an empty set with a copy-constructed allocator.
+    /// @param alloc Allocator to copy.
+    explicit BTreeSet(const AllocatorType& alloc) noexcept
+        : m_tree(alloc)
+    {
+    }
+
+    /// @brief Constructs an empty set with copy-constructed comparator and
+    /// allocator.
+    /// @param less Comparator to copy.
+    /// @param alloc Allocator to copy.
+    BTreeSet(const KeyCompareType& less, const AllocatorType& alloc) noexcept
+        : m_tree(less, alloc)
+    {
+    }
+
+    /// @brief Move constructs a set from another, leaving it empty.
+    /// @param other Set to steal from.
+    BTreeSet(ThisType&& other) noexcept = default;
+
+    /// @brief Moves the keys of another set into this, leaving it empty.
+    /// @param other Set to move keys from.
+    /// @return Reference to this set.
+    ThisType& operator=(ThisType&& other) noexcept
+    {
+        m_tree = Move(other.m_tree);
+        return *this;
+    }
+
+    /// @brief Checks if the set is empty.
+    /// @return True if the set holds no keys.
+    bool Empty() const noexcept
+    {
+        return m_tree.Size() == 0;
+    }
+
+    /// @brief Gets the number of keys in the set.
+    /// @return Number of keys.
+    SizeType Size() const noexcept
+    {
+        return m_tree.Size();
+    }
+
+    RAD_NODISCARD IteratorType begin() const noexcept
+    {
+        return Iter(m_tree.First());
+    }
+
+    RAD_NODISCARD IteratorType end() const noexcept
+    {
+        return IteratorType();
+    }
+
+    RAD_NODISCARD IteratorType cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    RAD_NODISCARD IteratorType cend() const noexcept
+    {
+        return end();
+    }
+
+    /// @brief Destroys all keys and frees the nodes.
+    /// @return Reference to this set.
+    ThisType& Clear() noexcept
+    {
+        m_tree.Clear();
+        return *this;
+    }
+
+    /// @brief Inserts a key unless it is already present.
+    /// @details Nothing is constructed if the key is present.
+    /// @param key Key to insert, used to construct a K on insertion.
+    /// @return The key in the set and whether it was inserted, or
+    /// Error::NoMemory if a node could not be allocated.
+    template <typename TKey>
+    Res<InsertResult> Insert(TKey&& key) noexcept(IsNoThrowCtor<K, TKey&&>)
+    {
+        auto res = m_tree.TryEmplace(key, Forward<TKey>(key));
+        if (res.IsErr())
+        {
+            return res.Err();
+        }
+
+        const auto at = res.Ok().at;
+        return InsertResult{ at.node->SlotPtr(at.pos), res.Ok().inserted };
+    }
+
+    /// @brief Finds a key.
+    /// @param key Key to look up.
+    /// @return The key in the set, or nullptr if it is not present.
+    template <typename TKey>
+    const K* Find(const TKey& key) const noexcept
+    {
+        const auto at = m_tree.Find(key);
+        return at.node == nullptr ? nullptr : at.node->SlotPtr(at.pos);
+    }
+
+    /// @brief Checks whether a key is present.
+    /// @param key Key to look up.
+    /// @return True if the set holds the key.
+    template <typename TKey>
+    bool Contains(const TKey& key) const noexcept
+    {
+        return m_tree.Find(key).node != nullptr;
+    }
+
+    /// @brief Finds the first key not less than a key.
+    /// @param key Key to compare with.
+    /// @return Iterator to the key, or end() if there is none.
+    template <typename TKey>
+    IteratorType LowerBound(const TKey& key) const noexcept
+    {
+        return Iter(m_tree.LowerBound(key));
+    }
+
+    /// @brief Finds the first key greater than a key.
+    /// @param key Key to compare with.
+    /// @return Iterator to the key, or end() if there is none.
+    template <typename TKey>
+    IteratorType UpperBound(const TKey& key) const noexcept
+    {
+        return Iter(m_tree.UpperBound(key));
+    }
+
+    /// @brief Gets the keys in [low, high).
+    /// @param low Smallest key of the range.
+    /// @param high Key following the range.
+    /// @return The keys, in order.
+    template <typename TKey>
+    BTreeRange<IteratorType> Range(const TKey& low,
+                                   const TKey& high) const noexcept
+    {
+        return { LowerBound(low), LowerBound(high) };
+    }
+
+    /// @brief Removes a key.
+    /// @param key Key to remove.
+    /// @return True if the key was removed.
+    template <typename TKey>
+    bool Erase(const TKey& key) noexcept
+    {
+        return m_tree.Erase(key);
+    }
+
+    /// @brief Exchanges the contents of two sets.
+    /// @param other Set to swap with.
+    /// @return Reference to this set.
+    ThisType& Swap(ThisType& other) noexcept
+    {
+        m_tree.Swap(other.m_tree);
+        return *this;
+    }
+
+    /// @brief Creates a copy of the set with the same node layout.
+    /// @return The new set on success or an error.
+    Res<ThisType> Clone() const noexcept(IsNoThrowCopyCtor<K>)
+    {
+        auto res = m_tree.Clone();
+        if (res.IsErr())
+        {
+            return res.Err();
+        }
+
+        return ThisType(Move(res.Ok()));
+    }
+
+    /// @brief Returns the key comparator.
+    /// @return The key comparator.
+    KeyCompareType GetKeyCompare() const noexcept
+    {
+        return m_tree.Compare();
+    }
+
+    /// @brief Returns the allocator.
+    /// @return The allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_tree.Allocator();
+    }
+
+private:
+
+    explicit BTreeSet(TreeType&& tree) noexcept
+        : m_tree(Move(tree))
+    {
+    }
+
+    static IteratorType Iter(typename TreeType::Position at) noexcept
+    {
+        return at.node == nullptr ? IteratorType()
+                                  : IteratorType(at.node, at.pos);
+    }
+
+    TreeType m_tree;
+};
+
+} // namespace rad
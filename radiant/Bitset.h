@@ -0,0 +1,753 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/Span.h"
+#include "radiant/Utility.h"
+#include "radiant/Vector.h"
+#include "radiant/detail/Bits.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rad
+{
+
+namespace detail
+{
+
+// Word-at-a-time operations shared by Bitset and DynamicBitset. Bits past the
+// size in the last word are kept zero, so counting and searching can look at
+// whole words.
+struct BitWords
+{
+    static constexpr size_t WordBits = 64;
+
+    static constexpr size_t WordCount(size_t bits) noexcept
+    {
+        return (bits + WordBits - 1) / WordBits;
+    }
+
+    // mask of the bits of the last word which are inside the bitset
+    static constexpr uint64_t TailMask(size_t bits) noexcept
+    {
+        return bits % WordBits == 0 ? ~uint64_t(0)
+                                    : (uint64_t(1) << (bits % WordBits)) - 1;
+    }
+
+    static uint64_t Bit(size_t index) noexcept
+    {
+        return uint64_t(1) << (index % WordBits);
+    }
+
+    static size_t Count(const uint64_t* words, size_t wordCount) noexcept
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < wordCount; ++i)
+        {
+            count += BitPopCount(words[i]);
+        }
+
+        return count;
+    }
+
+    static bool Any(const uint64_t* words, size_t wordCount) noexcept
+    {
+        for (size_t i = 0; i < wordCount; ++i)
+        {
+            if (words[i] != 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Index of the first bit at or after start which differs from the bits
+    // of invert, or bits if there is none.
+    static size_t Find(const uint64_t* words,
+                       size_t bits,
+                       size_t start,
+                       uint64_t invert) noexcept
+    {
+        if (start >= bits)
+        {
+            return bits;
+        }
+
+        const size_t wordCount = WordCount(bits);
+        size_t i = start / WordBits;
+        uint64_t word =
+            (words[i] ^ invert) & (~uint64_t(0) << start % WordBits);
+        while (word == 0)
+        {
+            if (++i == wordCount)
+            {
+                return bits;
+            }
+
+            word = words[i] ^ invert;
+        }
+
+        // the zero bits past the end read as set when inverted
+        const size_t index = i * WordBits + BitTrailingZeros(word);
+        return index < bits ? index : bits;
+    }
+
+    static size_t FindLast(const uint64_t* words, size_t bits) noexcept
+    {
+        for (size_t i = WordCount(bits); i > 0; --i)
+        {
+            if (words[i - 1] != 0)
+            {
+                return i * WordBits - 1 - BitLeadingZeros(words[i - 1]);
+            }
+        }
+
+        return bits;
+    }
+};
+
+} // namespace detail
+
+/// @brief Fixed-size set of bits.
+/// @details Bits are stored in 64-bit words, so counting and searching test
+/// 64 bits at a time using the hardware population count and bit scan
+/// instructions where the target has them. The searches return Size() when
+/// there is no matching bit, so a loop over the set bits looks like:
+/// @code
+/// for (size_t i = bits.FindFirst(); i < bits.Size(); i = bits.FindNext(i))
+/// @endcode
+/// @tparam N Number of bits.
+template <size_t N>
+class Bitset final
+{
+private:
+
+    using Words = detail::BitWords;
+
+public:
+
+    using ThisType = Bitset<N>;
+    using SizeType = size_t;
+    using WordType = uint64_t;
+
+    /// @brief Number of words holding the bits.
+    static constexpr SizeType WordCount = N == 0 ? 1 : Words::WordCount(N);
+
+    /// @brief Constructs a bitset with every bit clear.
+    constexpr Bitset() noexcept
+        : m_words()
+    {
+    }
+
+    /// @return The number of bits.
+    static constexpr SizeType Size() noexcept
+    {
+        return N;
+    }
+
+    /// @brief Tests a bit. Behavior is undefined if the index is out of range.
+    /// @param index Index of the bit.
+    /// @return True if the bit is set.
+    bool Test(SizeType index) const noexcept
+    {
+        RAD_ASSERT(index < N);
+
+        return (m_words[index / Words::WordBits] & Words::Bit(index)) != 0;
+    }
+
+    /// @copydoc Test
+    bool operator[](SizeType index) const noexcept
+    {
+        return Test(index);
+    }
+
+    /// @brief Sets or clears a bit.
+    /// @param index Index of the bit, less than Size().
+    /// @param value Value to give the bit.
+    /// @return Reference to this bitset.
+    ThisType& Set(SizeType index, bool value = true) noexcept
+    {
+        RAD_ASSERT(index < N);
+
+        uint64_t& word = m_words[index / Words::WordBits];
+        word = value ? word | Words::Bit(index) : word & ~Words::Bit(index);
+        return *this;
+    }
+
+    /// @brief Clears a bit.
+    /// @param index Index of the bit, less than Size().
+    /// @return Reference to this bitset.
+    ThisType& Reset(SizeType index) noexcept
+    {
+        return Set(index, false);
+    }
+
+    /// @brief Toggles a bit.
+    /// @param index Index of the bit, less than Size().
+    /// @return Reference to this bitset.
+    ThisType& Flip(SizeType index) noexcept
+    {
+        RAD_ASSERT(index < N);
+
+        m_words[index / Words::WordBits] ^= Words::Bit(index);
+        return *this;
+    }
+
+    /// @brief Sets every bit.
+    ThisType& SetAll() noexcept
+    {
+        for (uint64_t& word : m_words)
+        {
+            word = ~uint64_t(0);
+        }
+
+        return MaskTail();
+    }
+
+    /// @brief Clears every bit.
+    ThisType& ResetAll() noexcept
+    {
+        for (uint64_t& word : m_words)
+        {
+            word = 0;
+        }
+
+        return *this;
+    }
+
+    /// @brief Toggles every bit.
+    ThisType& FlipAll() noexcept
+    {
+        for (uint64_t& word : m_words)
+        {
+            word = ~word;
+        }
+
+        return MaskTail();
+    }
+
+    /// @return The number of set bits.
+    SizeType Count() const noexcept
+    {
+        return Words::Count(m_words, WordCount);
+    }
+
+    /// @return True if any bit is set.
+    bool Any() const noexcept
+    {
+        return Words::Any(m_words, WordCount);
+    }
+
+    /// @return True if no bit is set.
+    bool None() const noexcept
+    {
+        return !Any();
+    }
+
+    /// @return True if every bit is set, including when Size() is zero.
+    bool All() const noexcept
+    {
+        return FindFirstUnset() == N;
+    }
+
+    /// @return The index of the first set bit, or Size() if there is none.
+    SizeType FindFirst() const noexcept
+    {
+        return Words::Find(m_words, N, 0, 0);
+    }
+
+    /// @param prev Index to search after.
+    /// @return The index of the first set bit after prev, or Size() if there
+    /// is none.
+    SizeType FindNext(SizeType prev) const noexcept
+    {
+        return Words::Find(m_words, N, prev + 1, 0);
+    }
+
+    /// @return The index of the first clear bit, or Size() if there is none.
+    SizeType FindFirstUnset() const noexcept
+    {
+        return Words::Find(m_words, N, 0, ~uint64_t(0));
+    }
+
+    /// @param prev Index to search after.
+    /// @return The index of the first clear bit after prev, or Size() if
+    /// there is none.
+    SizeType FindNextUnset(SizeType prev) const noexcept
+    {
+        return Words::Find(m_words, N, prev + 1, ~uint64_t(0));
+    }
+
+    /// @return The index of the last set bit, or Size() if there is none.
+    SizeType FindLast() const noexcept
+    {
+        return Words::FindLast(m_words, N);
+    }
+
+    /// @brief Gets the words holding the bits, bit i being bit i % 64 of word
+    /// i / 64. Bits past Size() in the last word are zero.
+    Span<const WordType> ToWords() const noexcept
+    {
+        return Span<const WordType>(m_words, WordCount);
+    }
+
+    ThisType& operator&=(const ThisType& other) noexcept
+    {
+        for (SizeType i = 0; i < WordCount; ++i)
+        {
+            m_words[i] &= other.m_words[i];
+        }
+
+        return *this;
+    }
+
+    ThisType& operator|=(const ThisType& other) noexcept
+    {
+        for (SizeType i = 0; i < WordCount; ++i)
+        {
+            m_words[i] |= other.m_words[i];
+        }
+
+        return *this;
+    }
+
+    ThisType& operator^=(const ThisType& other) noexcept
+    {
+        for (SizeType i = 0; i < WordCount; ++i)
+        {
+            m_words[i] ^= other.m_words[i];
+        }
+
+        return *this;
+    }
+
+    ThisType operator~() const noexcept
+    {
+        ThisType result = *this;
+        result.FlipAll();
+        return result;
+    }
+
+    friend ThisType operator&(ThisType left, const ThisType& right) noexcept
+    {
+        return left &= right;
+    }
+
+    friend ThisType operator|(ThisType left, const ThisType& right) noexcept
+    {
+        return left |= right;
+    }
+
+    friend ThisType operator^(ThisType left, const ThisType& right) noexcept
+    {
+        return left ^= right;
+    }
+
+    friend bool operator==(const ThisType& left,
+                           const ThisType& right) noexcept
+    {
+        for (SizeType i = 0; i < WordCount; ++i)
+        {
+            if (left.m_words[i] != right.m_words[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    friend bool operator!=(const ThisType& left,
+                           const ThisType& right) noexcept
+    {
+        return !(left == right);
+    }
+
+private:
+
+    ThisType& MaskTail() noexcept
+    {
+        m_words[WordCount - 1] &= N == 0 ? 0 : Words::TailMask(N);
+        return *this;
+    }
+
+    uint64_t m_words[WordCount];
+};
+
+/// @brief Resizable set of bits, stored in words allocated from TAllocator.
+/// @details Offers the operations of Bitset. The binary operators require
+/// both bitsets to have the same size.
+/// @tparam TAllocator Allocator for the words.
+template <typename TAllocator RAD_ALLOCATOR_EQ(uint64_t)>
+class DynamicBitset final
+{
+private:
+
+    using Words = detail::BitWords;
+    using WordVector = Vector<uint64_t, TAllocator>;
+
+public:
+
+    using ThisType = DynamicBitset<TAllocator>;
+    using SizeType = size_t;
+    using WordType = uint64_t;
+    using AllocatorType = TAllocator;
+
+    RAD_NOT_COPYABLE(DynamicBitset);
+
+    /// @brief Constructs an empty bitset with a default-constructed allocator.
+    DynamicBitset() noexcept = default;
+
+    /// @brief Constructs an empty bitset with a copy-constructed allocator.
+    /// @param alloc Allocator to copy.
+    explicit DynamicBitset(const AllocatorType& alloc) noexcept
+        : m_words(alloc)
+    {
+    }
+
+    /// @brief Move constructs a bitset from another, leaving it empty.
+    DynamicBitset(ThisType&& other) noexcept
+        : m_words(::rad::Move(other.m_words)),
+          m_size(other.m_size)
+    {
+        other.m_size = 0;
+    }
+
+    /// @brief Moves the bits of another bitset into this, leaving it empty.
+    ThisType& operator=(ThisType&& other) noexcept
+    {
+        if RAD_LIKELY (this != &other)
+        {
+            m_words = ::rad::Move(other.m_words);
+            m_size = other.m_size;
+            other.m_size = 0;
+        }
+
+        return *this;
+    }
+
+    /// @return The number of bits.
+    SizeType Size() const noexcept
+    {
+        return m_size;
+    }
+
+    /// @return True if the bitset has no bits.
+    bool Empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    /// @brief Changes the number of bits.
+    /// @param count New number of bits.
+    /// @param value Value of the bits added when growing.
+    /// @return Result reference to this bitset on success, otherwise
+    /// Error::NoMemory or Error::IntegerOverflow leaving the bitset unchanged.
+    Res<ThisType&> Resize(SizeType count, bool value = false) noexcept
+    {
+        const SizeType wordCount = Words::WordCount(count);
+        if (wordCount > UINT32_MAX)
+        {
+            return Error::IntegerOverflow;
+        }
+
+        const SizeType oldSize = m_size;
+        auto res = m_words.Resize(static_cast<uint32_t>(wordCount),
+                                  value ? ~uint64_t(0) : 0);
+        if (res.IsErr())
+        {
+            return res.Err();
+        }
+
+        m_size = count;
+        if (value && count > oldSize && oldSize % Words::WordBits != 0)
+        {
+            // fill the rest of the word which held the old last bit
+            m_words[static_cast<uint32_t>(oldSize / Words::WordBits)] |=
+                ~Words::TailMask(oldSize);
+        }
+
+        MaskTail();
+        return *this;
+    }
+
+    /// @brief Appends a bit.
+    /// @param value Value of the new bit.
+    /// @return Result reference to this bitset on success or an error.
+    Res<ThisType&> PushBack(bool value) noexcept
+    {
+        if (m_size % Words::WordBits == 0)
+        {
+            // prefer this over Resize to keep the vector's growth
+            auto res = m_words.PushBack(value ? 1 : 0);
+            if (res.IsErr())
+            {
+                return res.Err();
+            }
+
+            ++m_size;
+            return *this;
+        }
+
+        ++m_size;
+        return Set(m_size - 1, value);
+    }
+
+    /// @brief Removes every bit, keeping the allocation.
+    ThisType& Clear() noexcept
+    {
+        m_words.Clear();
+        m_size = 0;
+        return *this;
+    }
+
+    /// @brief Creates a copy of the bitset.
+    /// @return The new bitset on success or an error.
+    Res<ThisType> Clone()
+    {
+        auto words = m_words.Clone();
+        if (words.IsErr())
+        {
+            return words.Err();
+        }
+
+        return ThisType(::rad::Move(words.Ok()), m_size);
+    }
+
+    /// @return The associated allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_words.GetAllocator();
+    }
+
+    /// @copydoc Bitset::Test
+    bool Test(SizeType index) const noexcept
+    {
+        RAD_ASSERT(index < m_size);
+
+        return (Word(index) & Words::Bit(index)) != 0;
+    }
+
+    /// @copydoc Bitset::Test
+    bool operator[](SizeType index) const noexcept
+    {
+        return Test(index);
+    }
+
+    /// @copydoc Bitset::Set
+    ThisType& Set(SizeType index, bool value = true) noexcept
+    {
+        RAD_ASSERT(index < m_size);
+
+        uint64_t& word = Word(index);
+        word = value ? word | Words::Bit(index) : word & ~Words::Bit(index);
+        return *this;
+    }
+
+    /// @copydoc Bitset::Reset
+    ThisType& Reset(SizeType index) noexcept
+    {
+        return Set(index, false);
+    }
+
+    /// @copydoc Bitset::Flip
+    ThisType& Flip(SizeType index) noexcept
+    {
+        RAD_ASSERT(index < m_size);
+
+        Word(index) ^= Words::Bit(index);
+        return *this;
+    }
+
+    /// @copydoc Bitset::SetAll
+    ThisType& SetAll() noexcept
+    {
+        for (uint32_t i = 0; i < m_words.Size(); ++i)
+        {
+            m_words[i] = ~uint64_t(0);
+        }
+
+        return MaskTail();
+    }
+
+    /// @copydoc Bitset::ResetAll
+    ThisType& ResetAll() noexcept
+    {
+        for (uint32_t i = 0; i < m_words.Size(); ++i)
+        {
+            m_words[i] = 0;
+        }
+
+        return *this;
+    }
+
+    /// @copydoc Bitset::FlipAll
+    ThisType& FlipAll() noexcept
+    {
+        for (uint32_t i = 0; i < m_words.Size(); ++i)
+        {
+            m_words[i] = ~m_words[i];
+        }
+
+        return MaskTail();
+    }
+
+    /// @copydoc Bitset::Count
+    SizeType Count() const noexcept
+    {
+        return Words::Count(m_words.Data(), m_words.Size());
+    }
+
+    /// @copydoc Bitset::Any
+    bool Any() const noexcept
+    {
+        return Words::Any(m_words.Data(), m_words.Size());
+    }
+
+    /// @copydoc Bitset::None
+    bool None() const noexcept
+    {
+        return !Any();
+    }
+
+    /// @copydoc Bitset::All
+    bool All() const noexcept
+    {
+        return FindFirstUnset() == m_size;
+    }
+
+    /// @copydoc Bitset::FindFirst
+    SizeType FindFirst() const noexcept
+    {
+        return Words::Find(m_words.Data(), m_size, 0, 0);
+    }
+
+    /// @copydoc Bitset::FindNext
+    SizeType FindNext(SizeType prev) const noexcept
+    {
+        return Words::Find(m_words.Data(), m_size, prev + 1, 0);
+    }
+
+    /// @copydoc Bitset::FindFirstUnset
+    SizeType FindFirstUnset() const noexcept
+    {
+        return Words::Find(m_words.Data(), m_size, 0, ~uint64_t(0));
+    }
+
+    /// @copydoc Bitset::FindNextUnset
+    SizeType FindNextUnset(SizeType prev) const noexcept
+    {
+        return Words::Find(m_words.Data(), m_size, prev + 1, ~uint64_t(0));
+    }
+
+    /// @copydoc Bitset::FindLast
+    SizeType FindLast() const noexcept
+    {
+        return Words::FindLast(m_words.Data(), m_size);
+    }
+
+    /// @copydoc Bitset::ToWords
+    Span<const WordType> ToWords() const noexcept
+    {
+        return Span<const WordType>(m_words.Data(), m_words.Size());
+    }
+
+    ThisType& operator&=(const ThisType& other) noexcept
+    {
+        RAD_ASSERT(m_size == other.m_size);
+
+        for (uint32_t i = 0; i < m_words.Size(); ++i)
+        {
+            m_words[i] &= other.m_words[i];
+        }
+
+        return *this;
+    }
+
+    ThisType& operator|=(const ThisType& other) noexcept
+    {
+        RAD_ASSERT(m_size == other.m_size);
+
+        for (uint32_t i = 0; i < m_words.Size(); ++i)
+        {
+            m_words[i] |= other.m_words[i];
+        }
+
+        return *this;
+    }
+
+    ThisType& operator^=(const ThisType& other) noexcept
+    {
+        RAD_ASSERT(m_size == other.m_size);
+
+        for (uint32_t i = 0; i < m_words.Size(); ++i)
+        {
+            m_words[i] ^= other.m_words[i];
+        }
+
+        return *this;
+    }
+
+    friend bool operator==(const ThisType& left,
+                           const ThisType& right) noexcept
+    {
+        return left.m_size == right.m_size && left.m_words == right.m_words;
+    }
+
+    friend bool operator!=(const ThisType& left,
+                           const ThisType& right) noexcept
+    {
+        return !(left == right);
+    }
+
+private:
+
+    DynamicBitset(WordVector&& words, SizeType size) noexcept
+        : m_words(::rad::Move(words)),
+          m_size(size)
+    {
+    }
+
+    uint64_t& Word(SizeType index) noexcept
+    {
+        return m_words[static_cast<uint32_t>(index / Words::WordBits)];
+    }
+
+    const uint64_t& Word(SizeType index) const noexcept
+    {
+        return m_words[static_cast<uint32_t>(index / Words::WordBits)];
+    }
+
+    ThisType& MaskTail() noexcept
+    {
+        if (!m_words.Empty())
+        {
+            m_words.Back() &= Words::TailMask(m_size);
+        }
+
+        return *this;
+    }
+
+    WordVector m_words;
+    SizeType m_size = 0;
+};
+
+} // namespace rad
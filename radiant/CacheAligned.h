@@ -0,0 +1,101 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+
+#include <stddef.h>
+
+// MSVC warns (C4324) when an alignment specifier pads a class, which is the
+// whole point of aligning to cache lines. Declarations of such classes are
+// wrapped in RAD_BEGIN_CACHE_ALIGNED and RAD_END_CACHE_ALIGNED.
+#ifdef RAD_MSC_VERSION
+#define RAD_BEGIN_CACHE_ALIGNED                                                \
+    _Pragma("warning(push)") _Pragma("warning(disable : 4324)")
+#define RAD_END_CACHE_ALIGNED _Pragma("warning(pop)")
+#else
+#define RAD_BEGIN_CACHE_ALIGNED
+#define RAD_END_CACHE_ALIGNED
+#endif
+
+namespace rad
+{
+
+RAD_BEGIN_CACHE_ALIGNED
+/// @brief Wraps a value so that it starts on a cache line boundary and shares
+/// its cache lines with nothing else.
+/// @details Use to separate data written by different cores, e.g. the slots of
+/// a per-core array or the head and tail of a queue. The alignment is only
+/// honored for heap allocations when the allocator provides
+/// RAD_CACHE_LINE_SIZE alignment, which typical AllocBytes implementations
+/// returning alignof(max_align_t) memory do not.
+/// @tparam T Type of the wrapped value.
+template <typename T>
+class alignas(RAD_CACHE_LINE_SIZE) CacheAligned final
+{
+public:
+
+    using ValueType = T;
+
+    static constexpr size_t Alignment = RAD_CACHE_LINE_SIZE;
+
+    /// @brief Constructs the wrapped value in place.
+    /// @param args Arguments for T construction.
+    template <typename... TArgs, EnIf<IsCtor<T, TArgs&&...>, int> = 0>
+    constexpr explicit CacheAligned(TArgs&&... args) noexcept(
+        IsNoThrowCtor<T, TArgs&&...>)
+        : m_value(Forward<TArgs>(args)...)
+    {
+    }
+
+    T& Get() & noexcept
+    {
+        return m_value;
+    }
+
+    const T& Get() const& noexcept
+    {
+        return m_value;
+    }
+
+    T* operator->() noexcept
+    {
+        return &m_value;
+    }
+
+    const T* operator->() const noexcept
+    {
+        return &m_value;
+    }
+
+    T& operator*() & noexcept
+    {
+        return m_value;
+    }
+
+    const T& operator*() const& noexcept
+    {
+        return m_value;
+    }
+
+private:
+
+    T m_value;
+};
+RAD_END_CACHE_ALIGNED
+
+} // namespace rad
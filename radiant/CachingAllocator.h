@@ -0,0 +1,750 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/CacheAligned.h"
+#include "radiant/Locks.h"
+#include "radiant/Memory.h"
+#include "radiant/SpinLocks.h"
+#include "radiant/detail/Bits.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if RAD_USER_MODE
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Number of size classes of a CachingHeap.
+RAD_INLINE_VAR constexpr uint32_t CachingClassCount = 20;
+
+/// @brief Internal use only. Largest size served from the size classes.
+RAD_INLINE_VAR constexpr size_t CachingMaxSmallSize = 1024;
+
+/// @brief Internal use only. Size class a request of up to
+/// CachingMaxSmallSize bytes falls in.
+/// @details Classes are 16 bytes apart up to 128 bytes, then four per power
+/// of two, so no more than a fifth of a block beyond 128 bytes is wasted.
+inline uint32_t CachingSizeClass(size_t size) noexcept
+{
+    RAD_ASSERT(size <= CachingMaxSmallSize);
+
+    if (size <= 128)
+    {
+        return size == 0 ? 0 : static_cast<uint32_t>((size - 1) >> 4);
+    }
+
+    const uint32_t log = 63 - BitLeadingZeros(size - 1);
+    return 8 + (log - 7) * 4 +
+           static_cast<uint32_t>((size - 1) >> (log - 2)) - 4;
+}
+
+/// @brief Internal use only. Block size of a size class.
+inline size_t CachingClassSize(uint32_t sizeClass) noexcept
+{
+    RAD_ASSERT(sizeClass < CachingClassCount);
+
+    if (sizeClass < 8)
+    {
+        return size_t(16) * (sizeClass + 1);
+    }
+
+    const uint32_t group = (sizeClass - 8) / 4;
+    const uint32_t step = (sizeClass - 8) % 4 + 1;
+    return (size_t(128) << group) + step * (size_t(32) << group);
+}
+
+/// @brief Internal use only. Number of blocks of a size class moved between
+/// a thread cache and the central lists at once, about 8 KiB worth.
+inline uint32_t CachingBatchCount(uint32_t sizeClass) noexcept
+{
+    const size_t count = 8192 / CachingClassSize(sizeClass);
+    return count > 64 ? 64 : static_cast<uint32_t>(count);
+}
+
+/// @brief Internal use only. Link stored in each free block. Blocks of a
+/// batch in the central lists are chained by next, and the first block of
+/// each batch links the next batch.
+struct CachingBlock
+{
+    CachingBlock* next;
+    CachingBlock* nextBatch;
+};
+
+/// @brief Internal use only. Header placed at the start of each slab.
+struct CachingSlab
+{
+    CachingSlab* next;
+};
+
+/// @brief Internal use only. Free blocks of one size class in a thread cache.
+struct CachingFreeList
+{
+    CachingBlock* free = nullptr;
+    uint32_t count = 0;
+};
+
+RAD_BEGIN_CACHE_ALIGNED
+/// @brief Internal use only. Thread cache of a CachingHeap.
+/// @details Everything but inUse is private to the thread owning the cache.
+struct CachingCache
+{
+    RAD_NOT_COPYABLE(CachingCache);
+
+    CachingCache() noexcept = default;
+
+    // keeps the caches of different threads on different cache lines
+    alignas(RAD_CACHE_LINE_SIZE) CachingFreeList lists[CachingClassCount];
+    Atomic<uint32_t> inUse{ 1 };
+    CachingCache* next = nullptr;
+};
+RAD_END_CACHE_ALIGNED
+
+/// @brief Internal use only. Blocks of one size class shared by all threads.
+struct CachingCentral
+{
+    RAD_NOT_COPYABLE(CachingCentral);
+
+    CachingCentral() noexcept = default;
+
+    TicketSpinLock lock;
+    CachingBlock* batches = nullptr;
+    // blocks freed by threads without a cache
+    CachingBlock* loose = nullptr;
+    CachingSlab* slabs = nullptr;
+    char* cursor = nullptr;
+    char* end = nullptr;
+};
+
+/// @brief Internal use only. Identity of a live CachingHeap.
+struct CachingHeapLink
+{
+    CachingHeapLink* next;
+    uint64_t id;
+};
+
+/// @brief Internal use only. Cache a thread uses for one heap.
+struct CachingThreadEntry
+{
+    uint64_t heap;
+    CachingCache* cache;
+};
+
+/// @brief Internal use only. Set of live heaps.
+/// @details Threads hand their caches back when they exit, which is only
+/// safe while the heap is alive. Heaps join the set when constructed and
+/// leave it before they free their caches, and exiting threads check the set
+/// under the same lock. Ids are never reused, so the entries of a thread
+/// never match a later heap at the same address.
+class CachingRegistry final
+{
+public:
+
+    RAD_NOT_COPYABLE(CachingRegistry);
+
+    constexpr CachingRegistry() noexcept = default;
+
+    static CachingRegistry& Global() noexcept
+    {
+        static CachingRegistry registry;
+        return registry;
+    }
+
+    void Add(CachingHeapLink& heap) noexcept
+    {
+        LockExclusive<TicketSpinLock> lock(m_lock);
+        heap.id = ++m_lastId;
+        heap.next = m_first;
+        m_first = &heap;
+    }
+
+    void Remove(CachingHeapLink& heap) noexcept
+    {
+        LockExclusive<TicketSpinLock> lock(m_lock);
+        for (CachingHeapLink** link = &m_first; *link != nullptr;
+             link = &(*link)->next)
+        {
+            if (*link == &heap)
+            {
+                *link = heap.next;
+                break;
+            }
+        }
+    }
+
+    /// @brief Forgets the entries of heaps that no longer exist.
+    /// @return Index of a free entry, or count if there is none.
+    uint32_t Purge(CachingThreadEntry* entries, uint32_t count) noexcept
+    {
+        LockExclusive<TicketSpinLock> lock(m_lock);
+        uint32_t free = count;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (entries[i].heap != 0 && !IsLive(entries[i].heap))
+            {
+                entries[i] = CachingThreadEntry{ 0, nullptr };
+            }
+
+            if (entries[i].heap == 0 && free == count)
+            {
+                free = i;
+            }
+        }
+
+        return free;
+    }
+
+    /// @brief Hands the caches of an exiting thread back to their heaps.
+    void Release(CachingThreadEntry* entries, uint32_t count) noexcept
+    {
+        LockExclusive<TicketSpinLock> lock(m_lock);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (entries[i].heap != 0 && IsLive(entries[i].heap))
+            {
+                entries[i].cache->inUse.Store(0, MemOrderRelease);
+            }
+        }
+    }
+
+private:
+
+    bool IsLive(uint64_t id) const noexcept
+    {
+        for (const CachingHeapLink* heap = m_first; heap != nullptr;
+             heap = heap->next)
+        {
+            if (heap->id == id)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    TicketSpinLock m_lock;
+    CachingHeapLink* m_first = nullptr;
+    uint64_t m_lastId = 0;
+};
+
+/// @brief Internal use only. Caches of the calling thread, handed back to
+/// their heaps when the thread exits.
+struct CachingThread
+{
+    static constexpr uint32_t EntryCount = 8;
+
+    CachingThread() noexcept = default;
+
+    ~CachingThread()
+    {
+        CachingRegistry::Global().Release(entries, EntryCount);
+    }
+
+    RAD_NOT_COPYABLE(CachingThread);
+
+    CachingThreadEntry entries[EntryCount] = {};
+};
+
+inline CachingThread& CachingCurrentThread() noexcept
+{
+    static thread_local CachingThread thread;
+    return thread;
+}
+
+} // namespace detail
+
+/// @brief Thread-safe heap serving small allocations from per-thread free
+/// lists of size classes, in front of a backing allocator.
+/// @details Requests of up to MaxSmallSize bytes are rounded up to one of
+/// ClassCount size classes. Each thread allocates and frees blocks through a
+/// cache of its own, so the common case is a pointer pop or push without
+/// synchronization. Since frees pass the size of the allocation, the size
+/// class of a block is known without a header.
+///
+/// A cache out of blocks of a class refills a batch of them from the central
+/// list of the class, and a cache holding two batches hands one back, so
+/// blocks freed on other threads than they were allocated on are reused.
+/// Central lists take a lock once per batch, and carve new batches from
+/// SlabSize slabs obtained from the backing allocator. Larger requests go to
+/// the backing allocator directly.
+///
+/// A thread's cache is created when it first uses the heap. When the thread
+/// exits the cache, along with the blocks it holds, is adopted by the next
+/// thread to use the heap. Each thread caches for a handful of heaps at
+/// once, and uses the central lists directly for any further heap.
+///
+/// Slabs are only returned to the backing allocator when the heap is
+/// destroyed. Containers use a heap through CachingAllocator handles, and the
+/// heap must outlive all of them.
+/// @tparam TBacking Thread-safe allocator used for slabs, caches and large
+/// requests.
+template <typename TBacking RAD_ALLOCATOR_EQ(void)>
+class CachingHeap final
+{
+private:
+
+    using UnitType = max_align_t;
+    using BlockType = detail::CachingBlock;
+    using SlabType = detail::CachingSlab;
+    using CacheType = detail::CachingCache;
+    using CentralType = detail::CachingCentral;
+    using ListType = detail::CachingFreeList;
+    using AllocatorTraits = AllocTraits<TBacking>;
+
+public:
+
+    using AllocatorType = TBacking;
+
+    /// @brief Number of size classes.
+    static constexpr uint32_t ClassCount = detail::CachingClassCount;
+
+    /// @brief Largest request served from the size classes.
+    static constexpr size_t MaxSmallSize = detail::CachingMaxSmallSize;
+
+    /// @brief Bytes obtained from the backing allocator per slab.
+    static constexpr size_t SlabSize = 64 * 1024;
+
+    static constexpr size_t HeaderSize = 16;
+    static constexpr size_t SlabUnits = SlabSize / sizeof(UnitType);
+
+    RAD_S_ASSERTMSG(alignof(UnitType) <= 16 && sizeof(SlabType) <= HeaderSize,
+                    "size classes only guarantee 16 byte alignment");
+
+    RAD_NOT_COPYABLE(CachingHeap);
+    CachingHeap(CachingHeap&&) = delete;
+    CachingHeap& operator=(CachingHeap&&) = delete;
+
+    /// @brief Returns every slab to the backing allocator and frees the
+    /// thread caches.
+    /// @warning Every small allocation must have been freed, and no thread
+    /// may use the heap afterwards.
+    ~CachingHeap()
+    {
+        detail::CachingRegistry::Global().Remove(m_link);
+
+        CacheType* cache = m_caches;
+        while (cache != nullptr)
+        {
+            CacheType* next = cache->next;
+            cache->~CacheType();
+            detail::FreeCacheAligned(m_backing, cache);
+            cache = next;
+        }
+
+        for (auto& central : m_central)
+        {
+            SlabType* slab = central->slabs;
+            while (slab != nullptr)
+            {
+                SlabType* next = slab->next;
+                AllocatorTraits::Free(m_backing,
+                                      reinterpret_cast<UnitType*>(slab),
+                                      SlabUnits);
+                slab = next;
+            }
+        }
+    }
+
+    /// @brief Constructs an empty heap with a default-constructed backing
+    /// allocator.
+    CachingHeap() noexcept
+    {
+        detail::CachingRegistry::Global().Add(m_link);
+    }
+
+    /// @brief Constructs an empty heap with a copy-constructed backing
+    /// allocator.
+    /// @param alloc Backing allocator to copy.
+    explicit CachingHeap(const AllocatorType& alloc) noexcept
+        : m_backing(alloc)
+    {
+        detail::CachingRegistry::Global().Add(m_link);
+    }
+
+    /// @brief Returns the size class a request falls in.
+    /// @param size Number of bytes requested, at most MaxSmallSize.
+    /// @return Index of the size class.
+    static uint32_t SizeClass(size_t size) noexcept
+    {
+        return detail::CachingSizeClass(size);
+    }
+
+    /// @brief Returns the block size of a size class.
+    /// @param sizeClass Index of the size class, see SizeClass().
+    /// @return Number of bytes each block of the class provides.
+    static size_t ClassSize(uint32_t sizeClass) noexcept
+    {
+        return detail::CachingClassSize(sizeClass);
+    }
+
+    /// @brief Allocates memory.
+    /// @param size Number of bytes requested.
+    /// @return The memory, or nullptr on failure.
+    void* AllocBytes(size_t size)
+    {
+        if RAD_LIKELY (size <= MaxSmallSize)
+        {
+            return AllocSmall(SizeClass(size));
+        }
+
+        return AllocatorTraits::AllocBytes(m_backing, size);
+    }
+
+    /// @brief Allocates memory, reporting the block size of the size class it
+    /// was served from.
+    /// @param size Number of bytes requested.
+    /// @return The memory and the number of bytes it provides, which may be
+    /// passed to FreeBytes() instead of size.
+    AllocBytesResult AllocBytesAtLeast(size_t size)
+    {
+        if RAD_LIKELY (size <= MaxSmallSize)
+        {
+            const uint32_t sizeClass = SizeClass(size);
+            return { AllocSmall(sizeClass), ClassSize(sizeClass) };
+        }
+
+        return { AllocatorTraits::AllocBytes(m_backing, size), size };
+    }
+
+    /// @brief Frees memory.
+    /// @param ptr Memory returned by AllocBytes() or AllocBytesAtLeast(), or
+    /// nullptr.
+    /// @param size Number of bytes requested when the memory was allocated.
+    void FreeBytes(void* ptr, size_t size) noexcept
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+
+        if RAD_LIKELY (size <= MaxSmallSize)
+        {
+            FreeSmall(ptr, SizeClass(size));
+            return;
+        }
+
+        AllocatorTraits::FreeBytes(m_backing, ptr, size);
+    }
+
+    /// @brief Returns the backing allocator.
+    /// @return The backing allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_backing;
+    }
+
+private:
+
+    void* AllocSmall(uint32_t sizeClass) noexcept
+    {
+        CacheType* cache = LocalCache();
+        if RAD_UNLIKELY (cache == nullptr)
+        {
+            return AllocUncached(sizeClass);
+        }
+
+        ListType& list = cache->lists[sizeClass];
+        if RAD_UNLIKELY (list.free == nullptr && !Refill(list, sizeClass))
+        {
+            return nullptr;
+        }
+
+        BlockType* block = list.free;
+        list.free = block->next;
+        --list.count;
+        return block;
+    }
+
+    void FreeSmall(void* ptr, uint32_t sizeClass) noexcept
+    {
+        CacheType* cache = LocalCache();
+        if RAD_UNLIKELY (cache == nullptr)
+        {
+            FreeUncached(ptr, sizeClass);
+            return;
+        }
+
+        ListType& list = cache->lists[sizeClass];
+        BlockType* block = ::new (ptr) BlockType;
+        block->next = list.free;
+        list.free = block;
+        if RAD_UNLIKELY (++list.count >=
+                         2 * detail::CachingBatchCount(sizeClass))
+        {
+            Flush(list, sizeClass);
+        }
+    }
+
+    CacheType* LocalCache() noexcept
+    {
+        detail::CachingThread& thread = detail::CachingCurrentThread();
+        for (const detail::CachingThreadEntry& entry : thread.entries)
+        {
+            if (entry.heap == m_link.id)
+            {
+                return entry.cache;
+            }
+        }
+
+        return AttachCache(thread);
+    }
+
+    CacheType* AttachCache(detail::CachingThread& thread) noexcept
+    {
+        const uint32_t index =
+            detail::CachingRegistry::Global().Purge(thread.entries,
+                                                    thread.EntryCount);
+        if (index == thread.EntryCount)
+        {
+            return nullptr;
+        }
+
+        CacheType* cache = AdoptCache();
+        if (cache == nullptr)
+        {
+            return nullptr;
+        }
+
+        thread.entries[index] = detail::CachingThreadEntry{ m_link.id, cache };
+        return cache;
+    }
+
+    CacheType* AdoptCache() noexcept
+    {
+        {
+            LockExclusive<TicketSpinLock> lock(m_cachesLock);
+            for (CacheType* cache = m_caches; cache != nullptr;
+                 cache = cache->next)
+            {
+                if (cache->inUse.Load(MemOrderAcquire) == 0)
+                {
+                    cache->inUse.Store(1, MemOrderRelaxed);
+                    return cache;
+                }
+            }
+        }
+
+        CacheType* cache = detail::AllocCacheAligned<CacheType>(m_backing);
+        if (cache == nullptr)
+        {
+            return nullptr;
+        }
+
+        ::new (static_cast<void*>(cache)) CacheType;
+        LockExclusive<TicketSpinLock> lock(m_cachesLock);
+        cache->next = m_caches;
+        m_caches = cache;
+        return cache;
+    }
+
+    bool Refill(ListType& list, uint32_t sizeClass) noexcept
+    {
+        CentralType& central = m_central[sizeClass].Get();
+        LockExclusive<TicketSpinLock> lock(central.lock);
+        BlockType* batch = central.batches;
+        if (batch != nullptr)
+        {
+            central.batches = batch->nextBatch;
+            list.free = batch;
+            list.count = detail::CachingBatchCount(sizeClass);
+            return true;
+        }
+
+        const size_t size = ClassSize(sizeClass);
+        if (static_cast<size_t>(central.end - central.cursor) < size &&
+            !NewSlab(central))
+        {
+            return false;
+        }
+
+        // link the blocks in address order, so a fresh batch is handed out
+        // sequentially
+        const size_t available =
+            static_cast<size_t>(central.end - central.cursor) / size;
+        const uint32_t batchCount = detail::CachingBatchCount(sizeClass);
+        const uint32_t count = available < batchCount
+                                   ? static_cast<uint32_t>(available)
+                                   : batchCount;
+        BlockType* next = nullptr;
+        for (uint32_t i = count; i-- > 0;)
+        {
+            BlockType* block =
+                ::new (static_cast<void*>(central.cursor + i * size)) BlockType;
+            block->next = next;
+            next = block;
+        }
+
+        central.cursor += count * size;
+        list.free = next;
+        list.count = count;
+        return true;
+    }
+
+    // moves a batch of blocks from the cache to the central list
+    void Flush(ListType& list, uint32_t sizeClass) noexcept
+    {
+        const uint32_t count = detail::CachingBatchCount(sizeClass);
+        BlockType* batch = list.free;
+        BlockType* last = batch;
+        for (uint32_t i = 1; i < count; ++i)
+        {
+            last = last->next;
+        }
+
+        list.free = last->next;
+        list.count -= count;
+        last->next = nullptr;
+
+        CentralType& central = m_central[sizeClass].Get();
+        LockExclusive<TicketSpinLock> lock(central.lock);
+        batch->nextBatch = central.batches;
+        central.batches = batch;
+    }
+
+    void* AllocUncached(uint32_t sizeClass) noexcept
+    {
+        CentralType& central = m_central[sizeClass].Get();
+        LockExclusive<TicketSpinLock> lock(central.lock);
+        BlockType* block = central.loose;
+        if (block != nullptr)
+        {
+            central.loose = block->next;
+            return block;
+        }
+
+        const size_t size = ClassSize(sizeClass);
+        if (static_cast<size_t>(central.end - central.cursor) < size &&
+            !NewSlab(central))
+        {
+            return nullptr;
+        }
+
+        void* ptr = central.cursor;
+        central.cursor += size;
+        return ptr;
+    }
+
+    void FreeUncached(void* ptr, uint32_t sizeClass) noexcept
+    {
+        CentralType& central = m_central[sizeClass].Get();
+        LockExclusive<TicketSpinLock> lock(central.lock);
+        BlockType* block = ::new (ptr) BlockType;
+        block->next = central.loose;
+        central.loose = block;
+    }
+
+    // called with the central lock held, the rest of the current slab is
+    // abandoned
+    bool NewSlab(CentralType& central) noexcept
+    {
+        UnitType* mem =
+            AllocatorTraits::template Alloc<UnitType>(m_backing, SlabUnits);
+        if (mem == nullptr)
+        {
+            return false;
+        }
+
+        SlabType* slab = ::new (static_cast<void*>(mem)) SlabType;
+        slab->next = central.slabs;
+        central.slabs = slab;
+        central.cursor = reinterpret_cast<char*>(mem) + HeaderSize;
+        central.end = reinterpret_cast<char*>(mem) + SlabSize;
+        return true;
+    }
+
+    detail::CachingHeapLink m_link{ nullptr, 0 };
+    AllocatorType m_backing;
+    TicketSpinLock m_cachesLock;
+    CacheType* m_caches = nullptr;
+    CacheAligned<CentralType> m_central[ClassCount];
+};
+
+/// @brief Allocator handle referring to a CachingHeap, satisfying the Radiant
+/// allocator contract.
+/// @details Handles compare equal when they refer to the same heap, and
+/// propagate with the containers that use them. The heap must outlive all
+/// containers which allocate from it.
+/// @tparam TBacking Backing allocator of the heap.
+template <typename TBacking RAD_ALLOCATOR_EQ(void)>
+class CachingAllocator final
+{
+public:
+
+    static constexpr bool PropagateOnCopy = true;
+    static constexpr bool PropagateOnMoveAssignment = true;
+    static constexpr bool PropagateOnSwap = true;
+    static constexpr bool IsAlwaysEqual = false;
+    static constexpr bool HasAllocBytesAtLeast = true;
+
+    using HeapType = CachingHeap<TBacking>;
+
+    /// @brief Constructs a handle to a heap.
+    /// @param heap Heap to allocate from.
+    explicit CachingAllocator(HeapType& heap) noexcept
+        : m_heap(&heap)
+    {
+    }
+
+    void* AllocBytes(size_t size)
+    {
+        return m_heap->AllocBytes(size);
+    }
+
+    AllocBytesResult AllocBytesAtLeast(size_t size)
+    {
+        return m_heap->AllocBytesAtLeast(size);
+    }
+
+    void FreeBytes(void* ptr, size_t size) noexcept
+    {
+        m_heap->FreeBytes(ptr, size);
+    }
+
+    static void HandleSizeOverflow() noexcept
+    {
+    }
+
+    bool operator==(const CachingAllocator& other) const noexcept
+    {
+        return m_heap == other.m_heap;
+    }
+
+    bool operator!=(const CachingAllocator& other) const noexcept
+    {
+        return m_heap != other.m_heap;
+    }
+
+    /// @brief Returns the heap this handle refers to.
+    /// @return The heap.
+    HeapType& GetHeap() const noexcept
+    {
+        return *m_heap;
+    }
+
+private:
+
+    HeapType* m_heap;
+};
+
+} // namespace rad
+
+#endif // RAD_USER_MODE
@@ -0,0 +1,425 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/CacheAligned.h"
+#include "radiant/FlatHashMap.h"
+#include "radiant/Hash.h"
+#include "radiant/Locks.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/SpinLocks.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rad
+{
+
+/// @brief Hash map for concurrent use, partitioned into shards which each
+/// hold a FlatHashMap guarded by a reader-writer lock.
+/// @details A key belongs to the shard selected by high bits of its hash, so
+/// operations on keys of different shards do not contend, and lookups only
+/// take their shard's lock shared. Each shard sits on its own cache lines.
+///
+/// Values never leave the lock by reference. Get() copies a value out, while
+/// Visit() and Update() call a function on the value with the shard locked
+/// shared or exclusively. Such functions must not call back into the map.
+/// Operations spanning shards, like Size() and ForEach(), lock one shard at
+/// a time and so do not observe a single point in time.
+/// @tparam K Key type.
+/// @tparam V Value type.
+/// @tparam TAllocator Thread-safe allocator used for the shards' tables.
+/// @tparam THash Hash function object returning uint64_t.
+/// @tparam TEq Key equality function object.
+/// @tparam TLock Reader-writer lock usable with LockShared and
+/// LockExclusive.
+/// @tparam TShards Number of shards, a power of two.
+template <typename K,
+          typename V,
+          typename TAllocator RAD_ALLOCATOR_EQ(K),
+          typename THash = Hash<K>,
+          typename TEq = EqualTo<K>,
+          typename TLock = RWSpinLock,
+          uint32_t TShards = 16>
+class ConcurrentHashMap final
+{
+public:
+
+    RAD_S_ASSERTMSG(TShards > 0 && (TShards & (TShards - 1)) == 0,
+                    "ConcurrentHashMap shard count must be a power of two");
+    RAD_S_ASSERTMSG(TShards <= (1u << 24),
+                    "ConcurrentHashMap shard count is too large");
+
+    using ThisType =
+        ConcurrentHashMap<K, V, TAllocator, THash, TEq, TLock, TShards>;
+    using MapType = FlatHashMap<K, V, TAllocator, THash, TEq>;
+    using KeyType = K;
+    using MappedType = V;
+    using EntryType = typename MapType::EntryType;
+    using SizeType = size_t;
+    using HasherType = THash;
+    using KeyEqualType = TEq;
+    using AllocatorType = TAllocator;
+    using LockType = TLock;
+
+    static constexpr uint32_t ShardCount = TShards;
+
+    RAD_NOT_COPYABLE(ConcurrentHashMap);
+    ConcurrentHashMap(ConcurrentHashMap&&) = delete;
+    ConcurrentHashMap& operator=(ConcurrentHashMap&&) = delete;
+
+    ~ConcurrentHashMap()
+    {
+        for (uint32_t i = 0; i < TShards; ++i)
+        {
+            Shards()[i].~ShardType();
+        }
+    }
+
+    /// @brief Constructs an empty map with default-constructed hasher,
+    /// comparator and allocator.
+    ConcurrentHashMap() noexcept
+    {
+        for (uint32_t i = 0; i < TShards; ++i)
+        {
+            ::new (static_cast<void*>(Shards() + i)) ShardType();
+        }
+    }
+
+    /// @brief Constructs an empty map whose shards copy the hasher,
+    /// comparator and allocator.
+    /// @param hash Hasher to copy.
+    /// @param eq Key comparator to copy.
+    /// @param alloc Allocator to copy.
+    ConcurrentHashMap(const HasherType& hash,
+                      const KeyEqualType& eq,
+                      const AllocatorType& alloc) noexcept
+    {
+        for (uint32_t i = 0; i < TShards; ++i)
+        {
+            ::new (static_cast<void*>(Shards() + i))
+                ShardType(hash, eq, alloc);
+        }
+    }
+
+    /// @brief Constructs an empty map whose shards copy the allocator.
+    /// @param alloc Allocator to copy.
+    explicit ConcurrentHashMap(const AllocatorType& alloc) noexcept
+        : ConcurrentHashMap(HasherType(), KeyEqualType(), alloc)
+    {
+    }
+
+    /// @brief Counts the entries of all shards.
+    /// @return Number of entries, which concurrent updates may already have
+    /// changed.
+    SizeType Size() const noexcept
+    {
+        SizeType size = 0;
+        for (uint32_t i = 0; i < TShards; ++i)
+        {
+            const Shard& shard = *Shards()[i];
+            LockShared<TLock> lock(shard.lock);
+            size += shard.map.Size();
+        }
+
+        return size;
+    }
+
+    /// @brief Checks if the map is empty.
+    /// @return True if no shard holds an entry.
+    bool Empty() const noexcept
+    {
+        return Size() == 0;
+    }
+
+    /// @brief Grows every shard to hold its part of count entries without
+    /// growing again, assuming keys spread evenly.
+    /// @param count Number of entries to make room for.
+    /// @return Error::NoMemory if a shard could not grow.
+    Err Reserve(SizeType count) noexcept
+    {
+        const SizeType perShard = (count + TShards - 1) / TShards;
+        for (uint32_t i = 0; i < TShards; ++i)
+        {
+            Shard& shard = *Shards()[i];
+            LockExclusive<TLock> lock(shard.lock);
+            auto res = shard.map.Reserve(perShard);
+            if (res.IsErr())
+            {
+                return res.Err();
+            }
+        }
+
+        return NoError;
+    }
+
+    /// @brief Destroys all entries.
+    void Clear() noexcept
+    {
+        for (uint32_t i = 0; i < TShards; ++i)
+        {
+            Shard& shard = *Shards()[i];
+            LockExclusive<TLock> lock(shard.lock);
+            shard.map.Clear();
+        }
+    }
+
+    /// @brief Inserts an entry constructed from a key and value arguments,
+    /// unless the key is already present.
+    /// @param key Key of the entry, used to construct a K on insertion.
+    /// @param args Arguments for V construction.
+    /// @return True if the entry was inserted, or Error::NoMemory if the
+    /// shard could not grow.
+    template <typename TKey, typename... TArgs>
+    Res<bool> TryEmplace(TKey&& key, TArgs&&... args) noexcept(
+        noexcept(DeclVal<MapType&>().TryEmplace(Forward<TKey>(key),
+                                                Forward<TArgs>(args)...)))
+    {
+        Shard& shard = ShardOf(key);
+        LockExclusive<TLock> lock(shard.lock);
+        auto res =
+            shard.map.TryEmplace(Forward<TKey>(key), Forward<TArgs>(args)...);
+        if (res.IsErr())
+        {
+            return res.Err();
+        }
+
+        return res.Ok().inserted;
+    }
+
+    /// @brief Inserts an entry unless the key is already present.
+    /// @param key Key of the entry, used to construct a K on insertion.
+    /// @param value Value of the entry, used to construct a V on insertion.
+    /// @return True if the entry was inserted, or Error::NoMemory if the
+    /// shard could not grow.
+    template <typename TKey, typename TValue>
+    Res<bool> Insert(TKey&& key, TValue&& value) noexcept(
+        noexcept(DeclVal<ThisType&>().TryEmplace(Forward<TKey>(key),
+                                                 Forward<TValue>(value))))
+    {
+        return TryEmplace(Forward<TKey>(key), Forward<TValue>(value));
+    }
+
+    /// @brief Inserts an entry, or assigns the value if the key is already
+    /// present.
+    /// @param key Key of the entry, used to construct a K on insertion.
+    /// @param value Value to assign or insert.
+    /// @return True if the entry was inserted rather than assigned, or
+    /// Error::NoMemory if the shard could not grow.
+    template <typename TKey, typename TValue>
+    Res<bool> InsertOrAssign(TKey&& key, TValue&& value) noexcept(
+        noexcept(DeclVal<MapType&>().InsertOrAssign(Forward<TKey>(key),
+                                                    Forward<TValue>(value))))
+    {
+        Shard& shard = ShardOf(key);
+        LockExclusive<TLock> lock(shard.lock);
+        const SizeType size = shard.map.Size();
+        auto res = shard.map.InsertOrAssign(Forward<TKey>(key),
+                                            Forward<TValue>(value));
+        if (res.IsErr())
+        {
+            return res.Err();
+        }
+
+        return shard.map.Size() != size;
+    }
+
+    /// @brief Copies the value of a key.
+    /// @param key Key to look up.
+    /// @return Copy of the value, or Error::OutOfRange if the key is not
+    /// present.
+    template <typename TKey>
+    Res<V> Get(const TKey& key) const noexcept(IsNoThrowCopyCtor<V>)
+    {
+        RAD_S_ASSERT_NOTHROW(IsNoThrowCopyCtor<V>);
+
+        const Shard& shard = ShardOf(key);
+        LockShared<TLock> lock(shard.lock);
+        const V* value = shard.map.Find(key);
+        if (value == nullptr)
+        {
+            return Error::OutOfRange;
+        }
+
+        return Res<V>(ResOkTag, *value);
+    }
+
+    /// @brief Checks whether a key is present.
+    /// @param key Key to look up.
+    /// @return True if the map holds the key.
+    template <typename TKey>
+    bool Contains(const TKey& key) const noexcept
+    {
+        const Shard& shard = ShardOf(key);
+        LockShared<TLock> lock(shard.lock);
+        return shard.map.Contains(key);
+    }
+
+    /// @brief Calls a function on the value of a key, with its shard locked
+    /// shared.
+    /// @param key Key to look up.
+    /// @param func Function called with a const reference to the value.
+    /// @return True if the key was present and func was called.
+    template <typename TKey, typename F>
+    bool Visit(const TKey& key, F&& func) const
+        noexcept(noexcept(func(DeclVal<const V&>())))
+    {
+        RAD_S_ASSERT_NOTHROW(noexcept(func(DeclVal<const V&>())));
+
+        const Shard& shard = ShardOf(key);
+        LockShared<TLock> lock(shard.lock);
+        const V* value = shard.map.Find(key);
+        if (value == nullptr)
+        {
+            return false;
+        }
+
+        func(*value);
+        return true;
+    }
+
+    /// @brief Calls a function on the value of a key, with its shard locked
+    /// exclusively.
+    /// @param key Key to look up.
+    /// @param func Function called with a reference to the value.
+    /// @return True if the key was present and func was called.
+    template <typename TKey, typename F>
+    bool Update(const TKey& key,
+                F&& func) noexcept(noexcept(func(DeclVal<V&>())))
+    {
+        RAD_S_ASSERT_NOTHROW(noexcept(func(DeclVal<V&>())));
+
+        Shard& shard = ShardOf(key);
+        LockExclusive<TLock> lock(shard.lock);
+        V* value = shard.map.Find(key);
+        if (value == nullptr)
+        {
+            return false;
+        }
+
+        func(*value);
+        return true;
+    }
+
+    /// @brief Removes the entry of a key.
+    /// @param key Key to remove.
+    /// @return True if an entry was removed.
+    template <typename TKey>
+    bool Erase(const TKey& key) noexcept
+    {
+        Shard& shard = ShardOf(key);
+        LockExclusive<TLock> lock(shard.lock);
+        return shard.map.Erase(key);
+    }
+
+    /// @brief Removes the entries a predicate selects, one shard at a time.
+    /// @param pred Predicate called with each entry, with its shard locked
+    /// exclusively.
+    /// @return Number of entries removed.
+    template <typename Predicate>
+    SizeType EraseIf(Predicate pred) noexcept(
+        noexcept(pred(DeclVal<const EntryType&>())))
+    {
+        SizeType count = 0;
+        for (uint32_t i = 0; i < TShards; ++i)
+        {
+            Shard& shard = *Shards()[i];
+            LockExclusive<TLock> lock(shard.lock);
+            count += shard.map.EraseIf(pred);
+        }
+
+        return count;
+    }
+
+    /// @brief Calls a function on every entry, one shard at a time.
+    /// @param func Function called with each entry, with its shard locked
+    /// shared.
+    template <typename F>
+    void ForEach(F&& func) const
+        noexcept(noexcept(func(DeclVal<const EntryType&>())))
+    {
+        RAD_S_ASSERT_NOTHROW(noexcept(func(DeclVal<const EntryType&>())));
+
+        for (uint32_t i = 0; i < TShards; ++i)
+        {
+            const Shard& shard = *Shards()[i];
+            LockShared<TLock> lock(shard.lock);
+            for (const EntryType& entry : shard.map)
+            {
+                func(entry);
+            }
+        }
+    }
+
+private:
+
+    struct Shard
+    {
+        Shard() noexcept = default;
+
+        Shard(const THash& hash,
+              const TEq& eq,
+              const TAllocator& alloc) noexcept
+            : map(hash, eq, alloc)
+        {
+        }
+
+        mutable TLock lock;
+        MapType map;
+    };
+
+    using ShardType = CacheAligned<Shard>;
+
+    template <typename TKey>
+    Shard& ShardOf(const TKey& key) noexcept
+    {
+        return *Shards()[ShardIndex(key)];
+    }
+
+    template <typename TKey>
+    const Shard& ShardOf(const TKey& key) const noexcept
+    {
+        return *Shards()[ShardIndex(key)];
+    }
+
+    // the tables use the low bits of the hash, so the shard comes from
+    // bits no table is large enough to use
+    template <typename TKey>
+    uint32_t ShardIndex(const TKey& key) const noexcept
+    {
+        const uint64_t hash = static_cast<uint64_t>(
+            Shards()[0]->map.GetHasher()(key));
+        return static_cast<uint32_t>(hash >> 40) & (TShards - 1);
+    }
+
+    ShardType* Shards() noexcept
+    {
+        return reinterpret_cast<ShardType*>(m_shards);
+    }
+
+    const ShardType* Shards() const noexcept
+    {
+        return reinterpret_cast<const ShardType*>(m_shards);
+    }
+
+    // raw storage, so that every shard can be constructed with arguments
+    alignas(ShardType) unsigned char m_shards[sizeof(ShardType) * TShards];
+};
+
+} // namespace rad
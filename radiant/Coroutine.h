@@ -0,0 +1,768 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+
+// coroutines need the compiler's std::coroutine_handle, so this header is
+// empty below C++20 or without the standard library
+#if RAD_CPP20 && RAD_ENABLE_STD
+
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/Result.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+
+#include <stddef.h>
+
+#include <coroutine>
+
+namespace rad
+{
+
+/// @brief Tag preceding the allocator argument of a coroutine, which then
+/// allocates its frame with that allocator.
+struct AllocatorArgType
+{
+    explicit AllocatorArgType() = default;
+};
+
+RAD_INLINE_VAR constexpr AllocatorArgType AllocatorArg{};
+
+template <typename T>
+class Task;
+
+template <typename T>
+class Generator;
+
+namespace detail
+{
+
+// Coroutine frames are followed by a footer holding a copy of the allocator
+// and the function freeing the frame with it, as operator delete only gets
+// the frame and its size.
+struct CoroFrameFooter
+{
+    void (*release)(void* frame, size_t size) noexcept;
+};
+
+template <typename TAlloc>
+struct CoroFrameFooterOf : CoroFrameFooter
+{
+    CoroFrameFooterOf(void (*fn)(void*, size_t) noexcept, TAlloc&& a) noexcept
+        : CoroFrameFooter{ fn },
+          alloc(Move(a))
+    {
+    }
+
+    TAlloc alloc;
+};
+
+inline size_t CoroFooterOffset(size_t size) noexcept
+{
+    return (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+}
+
+template <typename TAlloc>
+void CoroReleaseFrame(void* frame, size_t size) noexcept
+{
+    using FooterType = CoroFrameFooterOf<TAlloc>;
+
+    const size_t offset = CoroFooterOffset(size);
+    FooterType* footer =
+        reinterpret_cast<FooterType*>(static_cast<char*>(frame) + offset);
+    TAlloc alloc(Move(footer->alloc));
+    footer->~FooterType();
+    AllocTraits<TAlloc>::FreeBytes(alloc, frame, offset + sizeof(FooterType));
+}
+
+template <typename TAlloc>
+void* CoroAllocateFrame(const TAlloc& alloc, size_t size) noexcept
+{
+    using FooterType = CoroFrameFooterOf<TAlloc>;
+    RAD_S_ASSERTMSG(alignof(FooterType) <= alignof(max_align_t),
+                    "over-aligned allocators are not supported");
+    RAD_S_ASSERT_NOTHROW_MOVE_T(TAlloc);
+
+    const size_t offset = CoroFooterOffset(size);
+    TAlloc copy(alloc);
+    void* frame = AllocTraits<TAlloc>::AllocBytes(copy,
+                                                  offset + sizeof(FooterType));
+    if (frame == nullptr)
+    {
+        return nullptr;
+    }
+
+    ::new (static_cast<void*>(static_cast<char*>(frame) + offset))
+        FooterType(&CoroReleaseFrame<TAlloc>, Move(copy));
+    return frame;
+}
+
+/// @brief Internal use only. Allocation functions of the promise types.
+/// @details The frame of a coroutine whose parameters start with AllocatorArg
+/// and an allocator, after the object parameter of member coroutines, is
+/// allocated with that allocator. Other coroutines use RAD_DEFAULT_ALLOCATOR
+/// when it is defined, and fail to compile when it is not. Allocation
+/// failure makes the coroutine return an invalid Task or Generator.
+class CoroPromiseAlloc
+{
+public:
+
+    template <typename TAlloc, typename... TArgs>
+    static void* operator new(size_t size,
+                              AllocatorArgType,
+                              const TAlloc& alloc,
+                              const TArgs&...) noexcept
+    {
+        return CoroAllocateFrame(alloc, size);
+    }
+
+    template <typename TThis, typename TAlloc, typename... TArgs>
+    static void* operator new(size_t size,
+                              const TThis&,
+                              AllocatorArgType,
+                              const TAlloc& alloc,
+                              const TArgs&...) noexcept
+    {
+        return CoroAllocateFrame(alloc, size);
+    }
+
+#ifdef RAD_DEFAULT_ALLOCATOR
+    static void* operator new(size_t size) noexcept
+    {
+        return CoroAllocateFrame(RAD_DEFAULT_ALLOCATOR(), size);
+    }
+#endif
+
+    static void operator delete(void* frame, size_t size) noexcept
+    {
+        const CoroFrameFooter* footer = reinterpret_cast<CoroFrameFooter*>(
+            static_cast<char*>(frame) + CoroFooterOffset(size));
+        footer->release(frame, size);
+    }
+
+    void unhandled_exception() noexcept
+    {
+        // coroutines are expected not to throw
+        RAD_FAST_FAIL_ALWAYS();
+    }
+};
+
+template <typename T>
+struct CoroIsResult : FalseType
+{
+};
+
+template <typename T, typename E>
+struct CoroIsResult<Result<T, E>> : TrueType
+{
+};
+
+/// @brief Internal use only. Awaiter unwrapping a Result, or completing the
+/// awaiting Task with its error.
+/// @tparam TResult Result type, a reference when awaiting an lvalue.
+template <typename TResult>
+class ResultAwaiter
+{
+public:
+
+    explicit ResultAwaiter(TResult&& res) noexcept
+        : m_res(Forward<TResult>(res))
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return m_res.IsOk();
+    }
+
+    template <typename TPromise>
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<TPromise> handle) noexcept
+    {
+        // the task completes here, and is destroyed without resuming
+        TPromise& promise = handle.promise();
+        promise.Emplace(ResultErrTag, static_cast<TResult&&>(m_res).Err());
+        return promise.Continuation();
+    }
+
+    decltype(auto) await_resume() noexcept
+    {
+        return static_cast<TResult&&>(m_res).Ok();
+    }
+
+private:
+
+    TResult m_res;
+};
+
+class TaskPromiseBase : public CoroPromiseAlloc
+{
+public:
+
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        template <typename TPromise>
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<TPromise> handle) noexcept
+        {
+            return handle.promise().Continuation();
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    std::suspend_always initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    bool HasValue() const noexcept
+    {
+        return m_hasValue;
+    }
+
+    void SetContinuation(std::coroutine_handle<> continuation) noexcept
+    {
+        m_continuation = continuation;
+    }
+
+    // the coroutine to resume once the task completes
+    std::coroutine_handle<> Continuation() const noexcept
+    {
+        if (m_continuation)
+        {
+            return m_continuation;
+        }
+
+        return std::noop_coroutine();
+    }
+
+protected:
+
+    std::coroutine_handle<> m_continuation;
+    bool m_hasValue = false;
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase
+{
+public:
+
+    RAD_S_ASSERTMSG(!IsRef<T>, "Task does not support references");
+    RAD_S_ASSERT_NOTHROW_MOVE_T(T);
+
+    TaskPromise() noexcept = default;
+
+    ~TaskPromise()
+    {
+        if (m_hasValue)
+        {
+            Value().~T();
+        }
+    }
+
+    Task<T> get_return_object() noexcept
+    {
+        return Task<T>(
+            std::coroutine_handle<TaskPromise>::from_promise(*this));
+    }
+
+    static Task<T> get_return_object_on_allocation_failure() noexcept
+    {
+        return Task<T>();
+    }
+
+    template <typename U = T>
+    void return_value(U&& value) noexcept(IsNoThrowCtor<T, U&&>)
+    {
+        Emplace(Forward<U>(value));
+    }
+
+    template <typename TAwaitable>
+    TAwaitable&& await_transform(TAwaitable&& awaitable) noexcept
+    {
+        return Forward<TAwaitable>(awaitable);
+    }
+
+    /// @brief Unwraps the Ok value of an awaited Result, or completes the
+    /// task with its error, when the task itself returns a Result.
+    template <typename U,
+              typename F,
+              typename V = T,
+              EnIf<CoroIsResult<V>::value &&
+                       IsCtor<typename V::ErrType, F&&>,
+                   int> = 0>
+    ResultAwaiter<Result<U, F>> await_transform(Result<U, F>&& res) noexcept
+    {
+        return ResultAwaiter<Result<U, F>>(Move(res));
+    }
+
+    template <typename U,
+              typename F,
+              typename V = T,
+              EnIf<CoroIsResult<V>::value &&
+                       IsCtor<typename V::ErrType, F&>,
+                   int> = 0>
+    ResultAwaiter<Result<U, F>&> await_transform(Result<U, F>& res) noexcept
+    {
+        return ResultAwaiter<Result<U, F>&>(res);
+    }
+
+    template <typename... TArgs>
+    void Emplace(TArgs&&... args) noexcept(IsNoThrowCtor<T, TArgs&&...>)
+    {
+        RAD_S_ASSERT_NOTHROW((IsNoThrowCtor<T, TArgs&&...>));
+        RAD_ASSERT(!m_hasValue);
+
+        ::new (static_cast<void*>(m_storage)) T(Forward<TArgs>(args)...);
+        m_hasValue = true;
+    }
+
+    T& Value() noexcept
+    {
+        RAD_ASSERT(m_hasValue);
+        return *reinterpret_cast<T*>(m_storage);
+    }
+
+private:
+
+    alignas(T) unsigned char m_storage[sizeof(T)];
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase
+{
+public:
+
+    Task<void> get_return_object() noexcept;
+
+    static Task<void> get_return_object_on_allocation_failure() noexcept;
+
+    void return_void() noexcept
+    {
+        m_hasValue = true;
+    }
+};
+
+template <typename T>
+class GeneratorPromise : public CoroPromiseAlloc
+{
+public:
+
+    using ValueType = RemoveRef<T>;
+
+    Generator<T> get_return_object() noexcept
+    {
+        return Generator<T>(
+            std::coroutine_handle<GeneratorPromise>::from_promise(*this));
+    }
+
+    static Generator<T> get_return_object_on_allocation_failure() noexcept
+    {
+        return Generator<T>();
+    }
+
+    std::suspend_always initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    std::suspend_always final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    // the yielded value, temporaries included, outlives the suspension
+    std::suspend_always yield_value(ValueType& value) noexcept
+    {
+        m_current = AddrOf(value);
+        return {};
+    }
+
+    std::suspend_always yield_value(ValueType&& value) noexcept
+    {
+        m_current = AddrOf(value);
+        return {};
+    }
+
+    void return_void() noexcept
+    {
+    }
+
+    // generators only yield
+    template <typename TAwaitable>
+    void await_transform(TAwaitable&&) = delete;
+
+    ValueType* Current() const noexcept
+    {
+        return m_current;
+    }
+
+private:
+
+    ValueType* m_current = nullptr;
+};
+
+} // namespace detail
+
+/// @brief Lazily started coroutine producing a T.
+/// @details A Task runs when first awaited, or when Start() is called on it,
+/// and resumes its awaiter when it completes, without recursion on the
+/// stack. A task returning a Result can co_await a Result with a compatible
+/// error type: the Ok value is unwrapped, and an error completes the task
+/// with that error at once, much like `?` in Rust.
+///
+/// Frames are allocated as described for detail::CoroPromiseAlloc, so a
+/// coroutine takes AllocatorArg and an allocator as its first parameters.
+/// When a frame cannot be allocated the Task is invalid, and awaiting it
+/// yields Error::NoMemory when T can be constructed from an Error.
+/// @code
+/// Task<Res<int>> ReadSize(AllocatorArgType, Mallocator alloc, Socket& s)
+/// {
+///     Header header = co_await co_await ReadHeader(AllocatorArg, alloc, s);
+///     co_return header.size;
+/// }
+/// @endcode
+/// @tparam T Type produced by the coroutine, possibly void.
+template <typename T>
+class RAD_NODISCARD Task
+{
+public:
+
+    using promise_type = detail::TaskPromise<T>;
+    using HandleType = std::coroutine_handle<promise_type>;
+
+    RAD_NOT_COPYABLE(Task);
+
+    /// @brief Constructs an invalid task.
+    Task() noexcept = default;
+
+    Task(Task&& other) noexcept
+        : m_handle(other.m_handle)
+    {
+        other.m_handle = nullptr;
+    }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if RAD_LIKELY (this != &other)
+        {
+            Reset();
+            m_handle = other.m_handle;
+            other.m_handle = nullptr;
+        }
+
+        return *this;
+    }
+
+    /// @brief Destroys the coroutine frame, whether or not it completed.
+    ~Task()
+    {
+        Reset();
+    }
+
+    /// @brief Checks that the coroutine frame was allocated.
+    /// @return False if the frame could not be allocated.
+    bool IsValid() const noexcept
+    {
+        return static_cast<bool>(m_handle);
+    }
+
+    /// @brief Checks if the task completed.
+    /// @return True once the coroutine returned or propagated an error.
+    bool IsReady() const noexcept
+    {
+        return m_handle && m_handle.promise().HasValue();
+    }
+
+    /// @brief Runs a task that is not awaited by another coroutine until its
+    /// first suspension. Calling Start on a started task is erroneous.
+    /// @return True if the task completed.
+    bool Start() noexcept
+    {
+        if (m_handle)
+        {
+            RAD_ASSERT(!m_handle.done() && !IsReady());
+            m_handle.resume();
+        }
+
+        return IsReady();
+    }
+
+    /// @brief Gets the value of a completed task. Calling Value before the
+    /// task completed is erroneous.
+    /// @return The value produced by the coroutine.
+    template <typename U = T, EnIf<!IsSame<U, void>, int> = 0>
+    U& Value() noexcept
+    {
+        RAD_ASSERT(IsReady());
+        return m_handle.promise().Value();
+    }
+
+    class Awaiter
+    {
+    public:
+
+        explicit Awaiter(HandleType handle) noexcept
+            : m_handle(handle)
+        {
+        }
+
+        bool await_ready() const noexcept
+        {
+            return !m_handle || m_handle.promise().HasValue();
+        }
+
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<> awaiter) noexcept
+        {
+            m_handle.promise().SetContinuation(awaiter);
+            return m_handle;
+        }
+
+        T await_resume() noexcept
+        {
+            if constexpr (IsSame<T, void>)
+            {
+                RAD_FAST_FAIL(m_handle);
+            }
+            else
+            {
+                if constexpr (IsCtor<T, Error>)
+                {
+                    if RAD_UNLIKELY (!m_handle)
+                    {
+                        return T(Error::NoMemory);
+                    }
+                }
+                else
+                {
+                    RAD_FAST_FAIL(m_handle);
+                }
+
+                return Move(m_handle.promise().Value());
+            }
+        }
+
+    private:
+
+        HandleType m_handle;
+    };
+
+    /// @brief Runs the task to completion and gets its value, which is moved
+    /// out of the task.
+    Awaiter operator co_await() noexcept
+    {
+        return Awaiter(m_handle);
+    }
+
+private:
+
+    friend promise_type;
+
+    explicit Task(HandleType handle) noexcept
+        : m_handle(handle)
+    {
+    }
+
+    void Reset() noexcept
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+            m_handle = nullptr;
+        }
+    }
+
+    HandleType m_handle;
+};
+
+inline Task<void> detail::TaskPromise<void>::get_return_object() noexcept
+{
+    return Task<void>(
+        std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+inline Task<void>
+detail::TaskPromise<void>::get_return_object_on_allocation_failure() noexcept
+{
+    return Task<void>();
+}
+
+/// @brief Coroutine lazily producing a sequence of values with co_yield.
+/// @details Frames are allocated as for Task. A generator whose frame could
+/// not be allocated is invalid and yields nothing. Yielded values are
+/// referenced rather than copied, and remain valid until the generator is
+/// resumed.
+/// @code
+/// Generator<int> Iota(AllocatorArgType, Mallocator, int count)
+/// {
+///     for (int i = 0; i < count; ++i)
+///     {
+///         co_yield i;
+///     }
+/// }
+/// @endcode
+/// @tparam T Type of the yielded values.
+template <typename T>
+class RAD_NODISCARD Generator
+{
+public:
+
+    using promise_type = detail::GeneratorPromise<T>;
+    using HandleType = std::coroutine_handle<promise_type>;
+    using ValueType = RemoveRef<T>;
+
+    RAD_NOT_COPYABLE(Generator);
+
+    /// @brief Constructs an invalid generator.
+    Generator() noexcept = default;
+
+    Generator(Generator&& other) noexcept
+        : m_handle(other.m_handle)
+    {
+        other.m_handle = nullptr;
+    }
+
+    Generator& operator=(Generator&& other) noexcept
+    {
+        if RAD_LIKELY (this != &other)
+        {
+            Reset();
+            m_handle = other.m_handle;
+            other.m_handle = nullptr;
+        }
+
+        return *this;
+    }
+
+    ~Generator()
+    {
+        Reset();
+    }
+
+    /// @brief Checks that the coroutine frame was allocated.
+    /// @return False if the frame could not be allocated.
+    bool IsValid() const noexcept
+    {
+        return static_cast<bool>(m_handle);
+    }
+
+    /// @brief Resumes the coroutine until it yields the next value.
+    /// @return The value, or nullptr once the coroutine returned.
+    ValueType* Next() noexcept
+    {
+        if (!m_handle || m_handle.done())
+        {
+            return nullptr;
+        }
+
+        m_handle.resume();
+        return m_handle.done() ? nullptr : m_handle.promise().Current();
+    }
+
+    class Iterator
+    {
+    public:
+
+        Iterator() noexcept = default;
+
+        explicit Iterator(Generator* gen) noexcept
+            : m_gen(gen),
+              m_value(gen->Next())
+        {
+        }
+
+        ValueType& operator*() const noexcept
+        {
+            return *m_value;
+        }
+
+        ValueType* operator->() const noexcept
+        {
+            return m_value;
+        }
+
+        Iterator& operator++() noexcept
+        {
+            m_value = m_gen->Next();
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const noexcept
+        {
+            return m_value == other.m_value;
+        }
+
+        bool operator!=(const Iterator& other) const noexcept
+        {
+            return m_value != other.m_value;
+        }
+
+    private:
+
+        Generator* m_gen = nullptr;
+        ValueType* m_value = nullptr;
+    };
+
+    /// @brief Resumes the coroutine for its first value.
+    Iterator begin() noexcept
+    {
+        return Iterator(this);
+    }
+
+    Iterator end() noexcept
+    {
+        return Iterator();
+    }
+
+private:
+
+    friend promise_type;
+
+    explicit Generator(HandleType handle) noexcept
+        : m_handle(handle)
+    {
+    }
+
+    void Reset() noexcept
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+            m_handle = nullptr;
+        }
+    }
+
+    HandleType m_handle;
+};
+
+} // namespace rad
+
+#endif // RAD_CPP20 && RAD_ENABLE_STD
@@ -0,0 +1,768 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/Span.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+
+#include <stddef.h>
+#include <string.h>
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Default number of elements per Deque chunk,
+/// which keeps chunks near 4 KiB without making them too small to be worth
+/// the indirection.
+constexpr size_t DequeChunkSize(size_t elementSize) noexcept
+{
+    return elementSize <= 4096 / 16 ? 4096 / elementSize : 16;
+}
+
+} // namespace detail
+
+/// @brief Bidirectional iterator over the elements of a Deque.
+template <typename T, size_t TChunkSize>
+class DequeIterator final
+{
+public:
+
+    using ValueType = T;
+
+    DequeIterator() noexcept = default;
+
+    DequeIterator(T* const* node, T* const* lastNode, T* cur) noexcept
+        : m_node(node),
+          m_lastNode(lastNode),
+          m_cur(cur)
+    {
+    }
+
+    template <typename U, EnIf<IsSame<const U, T> && !IsSame<U, T>, int> = 0>
+    DequeIterator(const DequeIterator<U, TChunkSize>& other) noexcept
+        : m_node(other.m_node),
+          m_lastNode(other.m_lastNode),
+          m_cur(other.m_cur)
+    {
+    }
+
+    T& operator*() const noexcept
+    {
+        return *m_cur;
+    }
+
+    T* operator->() const noexcept
+    {
+        return m_cur;
+    }
+
+    DequeIterator& operator++() noexcept
+    {
+        ++m_cur;
+        // the end of the last chunk is the end of the deque, any other chunk
+        // end is the start of the next chunk
+        if (m_cur == *m_node + TChunkSize && m_node != m_lastNode)
+        {
+            ++m_node;
+            m_cur = *m_node;
+        }
+
+        return *this;
+    }
+
+    DequeIterator operator++(int) noexcept
+    {
+        DequeIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    DequeIterator& operator--() noexcept
+    {
+        if (m_cur == *m_node)
+        {
+            --m_node;
+            m_cur = *m_node + TChunkSize;
+        }
+
+        --m_cur;
+        return *this;
+    }
+
+    DequeIterator operator--(int) noexcept
+    {
+        DequeIterator tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    bool operator==(const DequeIterator& other) const noexcept
+    {
+        // chunks may be adjacent in memory, so the end of one chunk can have
+        // the same address as the start of another
+        return m_cur == other.m_cur && m_node == other.m_node;
+    }
+
+    bool operator!=(const DequeIterator& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+
+    template <typename, size_t>
+    friend class DequeIterator;
+
+    T* const* m_node = nullptr;
+    T* const* m_lastNode = nullptr;
+    T* m_cur = nullptr;
+};
+
+/// @brief Double-ended queue storing its elements in fixed-size chunks.
+/// @details Elements are never moved once constructed. Growing at either end
+/// allocates a chunk when the end chunk is full and, rarely, a larger array
+/// of chunk pointers, so pointers and references to elements stay valid until
+/// the element is removed. Pushing and popping at either end is O(1), and
+/// indexing costs one division by the chunk size.
+///
+/// One emptied chunk is kept as a spare, so a deque used as a queue whose
+/// size stays about level does not allocate on every chunk boundary.
+///
+/// The elements of each chunk are contiguous, and Chunk() exposes them as
+/// spans for bulk processing.
+/// @tparam T Type of elements. It need not be movable.
+/// @tparam TAllocator Allocator used for chunks and the chunk map.
+/// @tparam TChunkSize Number of elements per chunk.
+template <typename T,
+          typename TAllocator RAD_ALLOCATOR_EQ(T),
+          size_t TChunkSize = detail::DequeChunkSize(sizeof(T))>
+class Deque final
+{
+private:
+
+    using AllocatorTraits = AllocTraits<TAllocator>;
+
+    RAD_S_ASSERTMSG(TChunkSize > 0, "TChunkSize must not be zero");
+
+public:
+
+    using ThisType = Deque<T, TAllocator, TChunkSize>;
+    using ValueType = T;
+    using SizeType = size_t;
+    using AllocatorType = TAllocator;
+    using IteratorType = DequeIterator<T, TChunkSize>;
+    using ConstIteratorType = DequeIterator<const T, TChunkSize>;
+    static constexpr SizeType ChunkSize = TChunkSize;
+
+    RAD_NOT_COPYABLE(Deque);
+
+    ~Deque()
+    {
+        RAD_S_ASSERT_NOTHROW_DTOR(IsNoThrowDtor<T>);
+
+        Release();
+    }
+
+    /// @brief Constructs an empty deque with a default-constructed allocator.
+    Deque() noexcept = default;
+
+    /// @brief Constructs an empty deque with a copy-constructed allocator.
+    /// @param alloc Allocator to copy.
+    explicit Deque(const AllocatorType& alloc) noexcept
+        : m_storage(alloc)
+    {
+    }
+
+    /// @brief Move constructs a deque from another, leaving it empty.
+    /// @param other Deque to steal from.
+    Deque(ThisType&& other) noexcept
+        : m_storage(other.Allocator())
+    {
+        Chunks() = other.Chunks();
+        other.Chunks() = ChunkMap();
+    }
+
+    /// @brief Moves the elements of another deque into this, leaving it
+    /// empty.
+    /// @param other Deque to move elements from.
+    /// @return Reference to this deque.
+    ThisType& operator=(ThisType&& other) noexcept
+    {
+        // Don't allow non-propagation of allocators
+        RAD_S_ASSERTMSG(
+            AllocatorTraits::IsAlwaysEqual ||
+                AllocatorTraits::PropagateOnMoveAssignment,
+            "Cannot use move assignment with this allocator, as it could cause "
+            "copies. Either change allocators, or use something like Clone().");
+
+        if RAD_UNLIKELY (this == &other)
+        {
+            return *this;
+        }
+
+        Release();
+        AllocatorTraits::PropagateOnMoveIfNeeded(Allocator(),
+                                                 other.Allocator());
+        Chunks() = other.Chunks();
+        other.Chunks() = ChunkMap();
+        return *this;
+    }
+
+    /// @brief Checks if the deque is empty.
+    /// @return True if the deque holds no elements.
+    bool Empty() const noexcept
+    {
+        return Chunks().size == 0;
+    }
+
+    /// @brief Gets the number of elements in the deque.
+    /// @return Number of elements.
+    SizeType Size() const noexcept
+    {
+        return Chunks().size;
+    }
+
+    /// @brief Returns a reference to the element at a given index. Behavior is
+    /// undefined if the index is outside the bounds of the deque.
+    /// @param index Index of the element, counted from the front.
+    /// @return Reference to the element.
+    ValueType& At(SizeType index) noexcept
+    {
+        RAD_ASSERT(index < Chunks().size);
+
+        return *Locate(index);
+    }
+
+    /// @copydoc At(SizeType)
+    const ValueType& At(SizeType index) const noexcept
+    {
+        RAD_ASSERT(index < Chunks().size);
+
+        return *const_cast<ThisType*>(this)->Locate(index);
+    }
+
+    /// @copydoc At(SizeType)
+    ValueType& operator[](SizeType index) noexcept
+    {
+        return At(index);
+    }
+
+    /// @copydoc At(SizeType)
+    const ValueType& operator[](SizeType index) const noexcept
+    {
+        return At(index);
+    }
+
+    /// @brief Returns a reference to the first element. Behavior is undefined
+    /// if the deque is empty.
+    /// @return Reference to the first element.
+    ValueType& Front() noexcept
+    {
+        return At(0);
+    }
+
+    /// @copydoc Front()
+    const ValueType& Front() const noexcept
+    {
+        return At(0);
+    }
+
+    /// @brief Returns a reference to the last element. Behavior is undefined
+    /// if the deque is empty.
+    /// @return Reference to the last element.
+    ValueType& Back() noexcept
+    {
+        return At(Chunks().size - 1);
+    }
+
+    /// @copydoc Back()
+    const ValueType& Back() const noexcept
+    {
+        return At(Chunks().size - 1);
+    }
+
+    /// @brief Constructs an element in place at the end of the deque.
+    /// @param args Arguments to construct the element with.
+    /// @return Result reference to this deque on success, or Error::NoMemory
+    /// leaving the deque unchanged.
+    template <typename... TArgs>
+    Res<ThisType&> EmplaceBack(TArgs&&... args) noexcept(
+        IsNoThrowCtor<T, TArgs...>)
+    {
+        ChunkMap& map = Chunks();
+        const SizeType end = map.first + map.size;
+        if (end < map.count * TChunkSize)
+        {
+            new (map.nodes[map.start + end / TChunkSize] + end % TChunkSize)
+                T(Forward<TArgs>(args)...);
+            ++map.size;
+            return *this;
+        }
+
+        if (!ReserveNodeBack())
+        {
+            return Error::NoMemory;
+        }
+
+        T* chunk = AcquireChunk();
+        if (chunk == nullptr)
+        {
+            return Error::NoMemory;
+        }
+
+        {
+            ChunkGuard guard{ this, chunk };
+            new (chunk) T(Forward<TArgs>(args)...);
+            guard.chunk = nullptr;
+        }
+
+        map.nodes[map.start + map.count] = chunk;
+        ++map.count;
+        ++map.size;
+        return *this;
+    }
+
+    /// @brief Copies an element onto the end of the deque.
+    /// @param value Value to copy.
+    /// @return Result reference to this deque on success or an error.
+    Res<ThisType&> PushBack(const ValueType& value) noexcept(
+        IsNoThrowCopyCtor<T>)
+    {
+        return EmplaceBack(value);
+    }
+
+    /// @brief Moves an element onto the end of the deque.
+    /// @param value Value to move.
+    /// @return Result reference to this deque on success or an error.
+    Res<ThisType&> PushBack(ValueType&& value) noexcept(IsNoThrowMoveCtor<T>)
+    {
+        return EmplaceBack(::rad::Move(value));
+    }
+
+    /// @brief Constructs an element in place at the front of the deque.
+    /// @param args Arguments to construct the element with.
+    /// @return Result reference to this deque on success, or Error::NoMemory
+    /// leaving the deque unchanged.
+    template <typename... TArgs>
+    Res<ThisType&> EmplaceFront(TArgs&&... args) noexcept(
+        IsNoThrowCtor<T, TArgs...>)
+    {
+        ChunkMap& map = Chunks();
+        if (map.first > 0)
+        {
+            new (map.nodes[map.start] + map.first - 1)
+                T(Forward<TArgs>(args)...);
+            --map.first;
+            ++map.size;
+            return *this;
+        }
+
+        if (!ReserveNodeFront())
+        {
+            return Error::NoMemory;
+        }
+
+        T* chunk = AcquireChunk();
+        if (chunk == nullptr)
+        {
+            return Error::NoMemory;
+        }
+
+        {
+            ChunkGuard guard{ this, chunk };
+            new (chunk + TChunkSize - 1) T(Forward<TArgs>(args)...);
+            guard.chunk = nullptr;
+        }
+
+        --map.start;
+        map.nodes[map.start] = chunk;
+        ++map.count;
+        map.first = TChunkSize - 1;
+        ++map.size;
+        return *this;
+    }
+
+    /// @brief Copies an element onto the front of the deque.
+    /// @param value Value to copy.
+    /// @return Result reference to this deque on success or an error.
+    Res<ThisType&> PushFront(const ValueType& value) noexcept(
+        IsNoThrowCopyCtor<T>)
+    {
+        return EmplaceFront(value);
+    }
+
+    /// @brief Moves an element onto the front of the deque.
+    /// @param value Value to move.
+    /// @return Result reference to this deque on success or an error.
+    Res<ThisType&> PushFront(ValueType&& value) noexcept(IsNoThrowMoveCtor<T>)
+    {
+        return EmplaceFront(::rad::Move(value));
+    }
+
+    /// @brief Destroys the last element. Does nothing if the deque is empty.
+    /// @return Reference to this deque.
+    ThisType& PopBack() noexcept
+    {
+        ChunkMap& map = Chunks();
+        if RAD_LIKELY (map.size > 0)
+        {
+            --map.size;
+            const SizeType end = map.first + map.size;
+            T* chunk = map.nodes[map.start + end / TChunkSize];
+            chunk[end % TChunkSize].~T();
+
+            if (end % TChunkSize == 0 || map.size == 0)
+            {
+                // the last chunk holds no more elements
+                --map.count;
+                ReleaseChunk(chunk);
+                if (map.count == 0)
+                {
+                    map.first = 0;
+                }
+            }
+        }
+
+        return *this;
+    }
+
+    /// @brief Destroys the first element. Does nothing if the deque is empty.
+    /// @return Reference to this deque.
+    ThisType& PopFront() noexcept
+    {
+        ChunkMap& map = Chunks();
+        if RAD_LIKELY (map.size > 0)
+        {
+            T* chunk = map.nodes[map.start];
+            chunk[map.first].~T();
+            --map.size;
+            ++map.first;
+
+            if (map.first == TChunkSize || map.size == 0)
+            {
+                // the first chunk holds no more elements
+                ++map.start;
+                --map.count;
+                map.first = 0;
+                ReleaseChunk(chunk);
+            }
+        }
+
+        return *this;
+    }
+
+    /// @brief Destroys all elements, keeping one chunk and the chunk map for
+    /// reuse.
+    /// @return Reference to this deque.
+    ThisType& Clear() noexcept
+    {
+        while (!Empty())
+        {
+            PopBack();
+        }
+
+        return *this;
+    }
+
+    /// @brief Gets the number of chunks holding elements.
+    /// @return Number of chunks, each a contiguous run of elements.
+    SizeType ChunkCount() const noexcept
+    {
+        return Chunks().count;
+    }
+
+    /// @brief Gets the elements stored in one chunk.
+    /// @details Iterating the chunks in order visits every element in order.
+    /// Only the first and last chunks can be partially filled.
+    /// @param index Index of the chunk, less than ChunkCount().
+    /// @return Span of the elements of the chunk.
+    Span<ValueType> Chunk(SizeType index) noexcept
+    {
+        const ChunkMap& map = Chunks();
+        RAD_ASSERT(index < map.count);
+
+        const SizeType end = map.first + map.size;
+        const SizeType begin = index == 0 ? map.first : 0;
+        const SizeType last =
+            index == map.count - 1 ? end - index * TChunkSize : TChunkSize;
+        return Span<ValueType>(map.nodes[map.start + index] + begin,
+                               static_cast<SpanSizeType>(last - begin));
+    }
+
+    /// @copydoc Chunk(SizeType)
+    Span<const ValueType> Chunk(SizeType index) const noexcept
+    {
+        return const_cast<ThisType*>(this)->Chunk(index);
+    }
+
+    /// @brief Swaps the elements of this deque with another.
+    /// @param other Deque to swap with.
+    /// @return Reference to this deque.
+    ThisType& Swap(ThisType& other) noexcept
+    {
+        // Don't allow non-propagation of allocators
+        RAD_S_ASSERTMSG(
+            AllocatorTraits::IsAlwaysEqual || AllocatorTraits::PropagateOnSwap,
+            "Cannot use Swap with this allocator, as it could cause copies. "
+            "Either change allocators, or use move construction.");
+
+        ChunkMap tmp = Chunks();
+        Chunks() = other.Chunks();
+        other.Chunks() = tmp;
+        AllocatorTraits::PropagateOnSwapIfNeeded(Allocator(),
+                                                 other.Allocator());
+        return *this;
+    }
+
+    /// @brief Creates a copy of the deque.
+    /// @return The new deque on success or an error.
+    Res<ThisType> Clone() const noexcept(IsNoThrowCopyCtor<T>)
+    {
+        ThisType local(AllocatorTraits::SelectAllocOnCopy(Allocator()));
+        for (auto it = begin(); it != end(); ++it)
+        {
+            auto res = local.PushBack(*it);
+            if (res.IsErr())
+            {
+                return res.Err();
+            }
+        }
+
+        return local;
+    }
+
+    /// @return The associated allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return AllocatorType(Allocator());
+    }
+
+    RAD_NODISCARD IteratorType begin() noexcept
+    {
+        return MakeIterator<IteratorType>(0);
+    }
+
+    RAD_NODISCARD IteratorType end() noexcept
+    {
+        return MakeIterator<IteratorType>(Chunks().size);
+    }
+
+    RAD_NODISCARD ConstIteratorType begin() const noexcept
+    {
+        return const_cast<ThisType*>(this)->begin();
+    }
+
+    RAD_NODISCARD ConstIteratorType end() const noexcept
+    {
+        return const_cast<ThisType*>(this)->end();
+    }
+
+    RAD_NODISCARD ConstIteratorType cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    RAD_NODISCARD ConstIteratorType cend() const noexcept
+    {
+        return end();
+    }
+
+private:
+
+    // Chunks in use are nodes[start, start + count). Elements occupy the
+    // positions [first, first + size) counted from the start of
+    // nodes[start], with first less than TChunkSize.
+    struct ChunkMap
+    {
+        T** nodes = nullptr;
+        SizeType capacity = 0;
+        SizeType start = 0;
+        SizeType count = 0;
+        SizeType first = 0;
+        SizeType size = 0;
+        T* spare = nullptr;
+    };
+
+    // Hands a chunk back to the spare slot if it fails to receive its first
+    // element.
+    struct ChunkGuard
+    {
+        ~ChunkGuard()
+        {
+            if (chunk != nullptr)
+            {
+                self->ReleaseChunk(chunk);
+            }
+        }
+
+        ThisType* self;
+        T* chunk;
+    };
+
+    T* Locate(SizeType index) noexcept
+    {
+        const ChunkMap& map = Chunks();
+        const SizeType pos = map.first + index;
+        return map.nodes[map.start + pos / TChunkSize] + pos % TChunkSize;
+    }
+
+    template <typename TIterator>
+    TIterator MakeIterator(SizeType index) noexcept
+    {
+        const ChunkMap& map = Chunks();
+        if (map.count == 0)
+        {
+            return TIterator();
+        }
+
+        T* const* last = map.nodes + map.start + map.count - 1;
+        const SizeType pos = map.first + index;
+        if (index == map.size && pos % TChunkSize == 0)
+        {
+            // the end of a full last chunk
+            return TIterator(last, last, *last + TChunkSize);
+        }
+
+        T* const* node = map.nodes + map.start + pos / TChunkSize;
+        return TIterator(node, last, *node + pos % TChunkSize);
+    }
+
+    T* AcquireChunk() noexcept
+    {
+        ChunkMap& map = Chunks();
+        T* chunk = map.spare;
+        if (chunk != nullptr)
+        {
+            map.spare = nullptr;
+            return chunk;
+        }
+
+        return AllocatorTraits::template Alloc<T>(Allocator(), TChunkSize);
+    }
+
+    void ReleaseChunk(T* chunk) noexcept
+    {
+        ChunkMap& map = Chunks();
+        if (map.spare == nullptr)
+        {
+            map.spare = chunk;
+            return;
+        }
+
+        AllocatorTraits::Free(Allocator(), chunk, TChunkSize);
+    }
+
+    bool ReserveNodeBack() noexcept
+    {
+        const ChunkMap& map = Chunks();
+        return map.start + map.count < map.capacity || Recenter();
+    }
+
+    bool ReserveNodeFront() noexcept
+    {
+        return Chunks().start > 0 || Recenter();
+    }
+
+    // Makes room for a node at both ends of the map, shifting the nodes to
+    // the middle when at most half the map is used and otherwise doubling it.
+    bool Recenter() noexcept
+    {
+        ChunkMap& map = Chunks();
+        if (map.count < map.capacity / 2)
+        {
+            const SizeType start = (map.capacity - map.count) / 2;
+            memmove(map.nodes + start,
+                    map.nodes + map.start,
+                    map.count * sizeof(T*));
+            map.start = start;
+            return true;
+        }
+
+        const SizeType capacity = map.capacity < 4 ? 8 : map.capacity * 2;
+        T** nodes = AllocatorTraits::template Alloc<T*>(Allocator(), capacity);
+        if (nodes == nullptr)
+        {
+            return false;
+        }
+
+        const SizeType start = (capacity - map.count) / 2;
+        if (map.count > 0)
+        {
+            memcpy(nodes + start,
+                   map.nodes + map.start,
+                   map.count * sizeof(T*));
+        }
+
+        if (map.nodes != nullptr)
+        {
+            AllocatorTraits::Free(Allocator(), map.nodes, map.capacity);
+        }
+
+        map.nodes = nodes;
+        map.capacity = capacity;
+        map.start = start;
+        return true;
+    }
+
+    void Release() noexcept
+    {
+        Clear();
+
+        ChunkMap& map = Chunks();
+        if (map.spare != nullptr)
+        {
+            AllocatorTraits::Free(Allocator(), map.spare, TChunkSize);
+        }
+
+        if (map.nodes != nullptr)
+        {
+            AllocatorTraits::Free(Allocator(), map.nodes, map.capacity);
+        }
+
+        map = ChunkMap();
+    }
+
+    TAllocator& Allocator() noexcept
+    {
+        return m_storage.First();
+    }
+
+    const TAllocator& Allocator() const noexcept
+    {
+        return m_storage.First();
+    }
+
+    ChunkMap& Chunks() noexcept
+    {
+        return m_storage.Second();
+    }
+
+    const ChunkMap& Chunks() const noexcept
+    {
+        return m_storage.Second();
+    }
+
+    EmptyOptimizedPair<TAllocator, ChunkMap> m_storage;
+};
+
+} // namespace rad
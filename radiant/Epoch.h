@@ -0,0 +1,338 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/CacheAligned.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/detail/Retired.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rad
+{
+
+namespace detail
+{
+
+RAD_BEGIN_CACHE_ALIGNED
+/// @brief Internal use only. Per-thread record of an EpochDomain.
+/// @details Only state is written by the owner and read by other threads,
+/// the retired list is private to the owner.
+template <typename TAllocator>
+struct EpochRecord
+{
+    explicit EpochRecord(const Atomic<size_t>* global) noexcept
+        : epoch(global)
+    {
+    }
+
+    RAD_NOT_COPYABLE(EpochRecord);
+
+    // (pinned epoch << 1) | 1 while pinned, zero otherwise. Aligning it
+    // keeps the state of different records on different cache lines.
+    alignas(RAD_CACHE_LINE_SIZE) Atomic<size_t> state{ 0 };
+    Atomic<uint32_t> inUse{ 1 };
+    const Atomic<size_t>* epoch;
+    EpochRecord* next = nullptr;
+    RetiredNode<TAllocator>* retired = nullptr;
+    size_t retiredCount = 0;
+    uint32_t depth = 0;
+};
+RAD_END_CACHE_ALIGNED
+
+} // namespace detail
+
+/// @brief Epoch-based reclamation domain for lock-free data structures.
+/// @details Readers access shared objects within a Guard, which pins the
+/// reader to the current global epoch with a single store to its own record.
+/// Writers unlink objects, then Retire() them. The global epoch only advances
+/// once every pinned reader has observed it, so an object retired in epoch e
+/// is freed once the epoch reaches e + 2, when no reader can still hold it.
+///
+/// Each thread accessing the domain registers a Participant and passes it to
+/// Guard and Retire(). A participant may only be used by one thread at a
+/// time. A reader which stays pinned stops all reclamation in the domain, so
+/// guards should be short.
+///
+/// Records of unregistered participants are reused by later registrations
+/// and only freed with the domain, which must outlive every participant.
+/// @tparam TAllocator Thread-safe allocator used for participant records and
+/// retirement bookkeeping.
+template <typename TAllocator RAD_ALLOCATOR_EQ(void)>
+class EpochDomain final
+{
+private:
+
+    using RecordType = detail::EpochRecord<TAllocator>;
+    using RetiredType = detail::RetiredNode<TAllocator>;
+
+public:
+
+    using AllocatorType = TAllocator;
+    using Participant = RecordType;
+
+    /// @brief Number of retired objects after which Retire() attempts to
+    /// reclaim the participant's retired objects.
+    static constexpr size_t CollectThreshold = 64;
+
+    /// @brief RAII pin of a participant to the current epoch.
+    /// @details Guards nest, only the outermost one pins and unpins.
+    class RAD_NODISCARD Guard final
+    {
+    public:
+
+        RAD_NOT_COPYABLE(Guard);
+
+        /// @brief Pins the participant.
+        explicit Guard(Participant& participant) noexcept
+            : m_participant(participant)
+        {
+            if (m_participant.depth++ == 0)
+            {
+                // the exchange orders the pin before the reads it protects
+                const size_t epoch =
+                    m_participant.epoch->Load(MemOrderSeqCst);
+                m_participant.state.Exchange((epoch << 1) | 1,
+                                             MemOrderSeqCst);
+            }
+        }
+
+        /// @brief Unpins the participant.
+        ~Guard()
+        {
+            if (--m_participant.depth == 0)
+            {
+                m_participant.state.Store(0, MemOrderRelease);
+            }
+        }
+
+    private:
+
+        Participant& m_participant;
+    };
+
+    RAD_NOT_COPYABLE(EpochDomain);
+    EpochDomain(EpochDomain&&) = delete;
+    EpochDomain& operator=(EpochDomain&&) = delete;
+
+    /// @brief Frees every retired object and participant record.
+    /// @warning No participant may be pinned or used afterwards.
+    ~EpochDomain()
+    {
+        RecordType* record = m_records.Second().Load(MemOrderAcquire);
+        while (record != nullptr)
+        {
+            RAD_ASSERT(record->depth == 0);
+            RecordType* next = record->next;
+            detail::ReclaimAll(record->retired, Allocator());
+            record->~RecordType();
+            detail::FreeCacheAligned(Allocator(), record);
+            record = next;
+        }
+    }
+
+    /// @brief Constructs a domain using a default-constructed allocator.
+    EpochDomain() noexcept = default;
+
+    /// @brief Constructs a domain using a copy-constructed allocator.
+    /// @param alloc Allocator to copy.
+    explicit EpochDomain(const AllocatorType& alloc) noexcept
+        : m_records(alloc, nullptr)
+    {
+    }
+
+    /// @brief Registers a participant for the calling thread, reusing the
+    /// record of an unregistered participant if there is one.
+    /// @return The participant, or Error::NoMemory if no record could be
+    /// allocated.
+    Res<Participant*> Register() noexcept
+    {
+        Atomic<RecordType*>& head = m_records.Second();
+        for (RecordType* record = head.Load(MemOrderAcquire); record != nullptr;
+             record = record->next)
+        {
+            uint32_t free = 0;
+            if (record->inUse.Load(MemOrderRelaxed) == 0 &&
+                record->inUse.CompareExchangeStrong(free,
+                                                    1,
+                                                    MemOrderAcquire,
+                                                    MemOrderRelaxed))
+            {
+                return Res<Participant*>(ResOkTag, record);
+            }
+        }
+
+        RecordType* record =
+            detail::AllocCacheAligned<RecordType>(Allocator());
+        if (record == nullptr)
+        {
+            return Res<Participant*>(ResErrTag, Error::NoMemory);
+        }
+
+        ::new (static_cast<void*>(record)) RecordType(&m_epoch);
+        RecordType* first = head.Load(MemOrderRelaxed);
+        do
+        {
+            record->next = first;
+        } while (!head.CompareExchangeWeak(first,
+                                           record,
+                                           MemOrderRelease,
+                                           MemOrderRelaxed));
+
+        return Res<Participant*>(ResOkTag, record);
+    }
+
+    /// @brief Unregisters a participant, which must not be pinned.
+    /// @details Objects it retired which cannot be freed yet are handed over
+    /// to the next participant reusing the record.
+    /// @param participant Participant to unregister.
+    void Unregister(Participant& participant) noexcept
+    {
+        RAD_ASSERT(participant.depth == 0);
+
+        Collect(participant);
+        participant.inUse.Store(0, MemOrderRelease);
+    }
+
+    /// @brief Defers destroying and freeing an object until no reader can
+    /// access it anymore.
+    /// @details The object must already be unreachable for new readers. It is
+    /// destroyed and freed through the allocator it was allocated with, which
+    /// is copied.
+    /// @param participant Participant of the calling thread.
+    /// @param ptr Object to free.
+    /// @param alloc Allocator ptr was allocated from.
+    /// @return Error::NoMemory if the retirement could not be recorded, in
+    /// which case the caller still owns ptr.
+    template <typename T, typename TObjAlloc>
+    Err Retire(Participant& participant,
+               T* ptr,
+               const TObjAlloc& alloc) noexcept
+    {
+        if (ptr == nullptr)
+        {
+            return NoError;
+        }
+
+        RetiredType* node =
+            detail::MakeRetired(Allocator(),
+                                ptr,
+                                alloc,
+                                m_epoch.Load(MemOrderSeqCst));
+        if (node == nullptr)
+        {
+            return Error::NoMemory;
+        }
+
+        node->next = participant.retired;
+        participant.retired = node;
+        if (++participant.retiredCount >= CollectThreshold)
+        {
+            Collect(participant);
+        }
+
+        return NoError;
+    }
+
+    /// @brief Advances the global epoch if every pinned participant has
+    /// observed it.
+    /// @return True if the epoch was advanced, by this or another thread.
+    bool TryAdvance() noexcept
+    {
+        size_t epoch = m_epoch.Load(MemOrderSeqCst);
+        const size_t current = (epoch << 1) | 1;
+        for (RecordType* record = m_records.Second().Load(MemOrderAcquire);
+             record != nullptr;
+             record = record->next)
+        {
+            const size_t state = record->state.Load(MemOrderSeqCst);
+            if (state != 0 && state != current)
+            {
+                return false;
+            }
+        }
+
+        // a lost race means another thread advanced the epoch
+        m_epoch.CompareExchangeStrong(epoch,
+                                      epoch + 1,
+                                      MemOrderSeqCst,
+                                      MemOrderRelaxed);
+        return true;
+    }
+
+    /// @brief Advances the epoch if possible and frees the objects retired by
+    /// a participant which no reader can access anymore.
+    /// @param participant Participant of the calling thread.
+    /// @return Number of objects freed.
+    size_t Collect(Participant& participant) noexcept
+    {
+        TryAdvance();
+        const size_t epoch = m_epoch.Load(MemOrderSeqCst);
+
+        // the list is ordered newest first, so everything from the first
+        // reclaimable node on is reclaimable too
+        RetiredType** link = &participant.retired;
+        while (*link != nullptr && epoch - (*link)->tag < 2)
+        {
+            link = &(*link)->next;
+        }
+
+        RetiredType* reclaimable = *link;
+        *link = nullptr;
+        const size_t count = detail::ReclaimAll(reclaimable, Allocator());
+        participant.retiredCount -= count;
+        return count;
+    }
+
+    /// @brief Gets the number of objects retired by a participant which are
+    /// not freed yet.
+    /// @param participant Participant of the calling thread.
+    /// @return Number of objects awaiting reclamation.
+    size_t RetiredCount(const Participant& participant) const noexcept
+    {
+        return participant.retiredCount;
+    }
+
+    /// @brief Gets the global epoch.
+    /// @return The current epoch.
+    size_t Epoch() const noexcept
+    {
+        return m_epoch.Load(MemOrderRelaxed);
+    }
+
+    /// @brief Returns the allocator.
+    /// @return The allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_records.First();
+    }
+
+private:
+
+    AllocatorType& Allocator() noexcept
+    {
+        return m_records.First();
+    }
+
+    EmptyOptimizedPair<AllocatorType, Atomic<RecordType*>> m_records;
+    Atomic<size_t> m_epoch{ 0 };
+};
+
+} // namespace rad
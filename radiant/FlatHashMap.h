@@ -0,0 +1,1028 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Hash.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+#include "radiant/detail/HashGroup.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Tag selecting the constructor of a map entry
+/// from a key and the arguments of its value.
+struct HashEntryInPlaceTag
+{
+};
+
+} // namespace detail
+
+/// @brief Key and value stored in a slot of a FlatHashMap.
+/// @details The key is only exposed as const, as changing it would break the
+/// table.
+template <typename K, typename V>
+class FlatHashMapEntry final
+{
+public:
+
+    template <typename TKey, typename... TArgs>
+    FlatHashMapEntry(detail::HashEntryInPlaceTag,
+                     TKey&& key,
+                     TArgs&&... args) noexcept(IsNoThrowCtor<K, TKey&&> &&
+                                               IsNoThrowCtor<V, TArgs&&...>)
+        : m_key(Forward<TKey>(key)),
+          m_value(Forward<TArgs>(args)...)
+    {
+    }
+
+    FlatHashMapEntry(const FlatHashMapEntry&) = default;
+    FlatHashMapEntry(FlatHashMapEntry&&) = default;
+    FlatHashMapEntry& operator=(const FlatHashMapEntry&) = delete;
+    FlatHashMapEntry& operator=(FlatHashMapEntry&&) = delete;
+
+    const K& Key() const noexcept
+    {
+        return m_key;
+    }
+
+    V& Value() noexcept
+    {
+        return m_value;
+    }
+
+    const V& Value() const noexcept
+    {
+        return m_value;
+    }
+
+private:
+
+    K m_key;
+    V m_value;
+};
+
+/// @brief Forward iterator over the entries of a FlatHashMap.
+template <typename TEntry>
+class FlatHashMapIterator final
+{
+public:
+
+    using ValueType = TEntry;
+
+    FlatHashMapIterator() noexcept = default;
+
+    FlatHashMapIterator(const detail::HashCtrl* ctrl,
+                        const detail::HashCtrl* end,
+                        TEntry* slot) noexcept
+        : m_ctrl(ctrl),
+          m_end(end),
+          m_slot(slot)
+    {
+        SkipFree();
+    }
+
+    TEntry& operator*() const noexcept
+    {
+        return *m_slot;
+    }
+
+    TEntry* operator->() const noexcept
+    {
+        return m_slot;
+    }
+
+    FlatHashMapIterator& operator++() noexcept
+    {
+        ++m_ctrl;
+        ++m_slot;
+        SkipFree();
+        return *this;
+    }
+
+    FlatHashMapIterator operator++(int) noexcept
+    {
+        FlatHashMapIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(const FlatHashMapIterator& other) const noexcept
+    {
+        return m_ctrl == other.m_ctrl;
+    }
+
+    bool operator!=(const FlatHashMapIterator& other) const noexcept
+    {
+        return m_ctrl != other.m_ctrl;
+    }
+
+private:
+
+    void SkipFree() noexcept
+    {
+        while (m_ctrl != m_end && !detail::HashCtrlIsFull(*m_ctrl))
+        {
+            ++m_ctrl;
+            ++m_slot;
+        }
+    }
+
+    const detail::HashCtrl* m_ctrl = nullptr;
+    const detail::HashCtrl* m_end = nullptr;
+    TEntry* m_slot = nullptr;
+};
+
+/// @brief Unordered map storing its entries inline in an open-addressing
+/// table.
+/// @details Entries live in one flat array next to an array of control bytes
+/// holding 7 bits of each key's hash. Lookups compare a whole group of control
+/// bytes against the hash at once, with SSE2 or NEON where available, and
+/// only compare keys whose hash bits match, so most lookups touch one control
+/// group and one entry. The table grows when it is 7/8 full.
+///
+/// Insertion may need to grow the table and so returns a Res, failing with
+/// Error::NoMemory without changing the map. Growing moves the entries, which
+/// invalidates pointers and iterators to them, as does erasing an entry for
+/// that entry.
+///
+/// Lookups are templated on the key type, so any type which both the hasher
+/// and the key comparator accept can be used to look up an entry without
+/// constructing a K, such as a string view for string keys.
+/// @tparam K Key type, which must be nothrow move constructible.
+/// @tparam V Value type, which must be nothrow move constructible.
+/// @tparam TAllocator Allocator used for the table. It comes before the hash
+/// and comparator as it has no default in builds without a default allocator.
+/// @tparam THash Hash function object returning uint64_t.
+/// @tparam TEq Key equality function object.
+template <typename K,
+          typename V,
+          typename TAllocator RAD_ALLOCATOR_EQ(K),
+          typename THash = Hash<K>,
+          typename TEq = EqualTo<K>>
+class FlatHashMap final
+{
+private:
+
+    using Group = detail::HashGroup;
+    using CtrlType = detail::HashCtrl;
+    using AllocatorTraits = AllocTraits<TAllocator>;
+
+public:
+
+    using ThisType = FlatHashMap<K, V, TAllocator, THash, TEq>;
+    using KeyType = K;
+    using MappedType = V;
+    using EntryType = FlatHashMapEntry<K, V>;
+    using SizeType = size_t;
+    using HasherType = THash;
+    using KeyEqualType = TEq;
+    using AllocatorType = TAllocator;
+    using IteratorType = FlatHashMapIterator<EntryType>;
+    using ConstIteratorType = FlatHashMapIterator<const EntryType>;
+
+    /// @brief Result of an insertion.
+    struct InsertResult
+    {
+        /// @brief Entry holding the key, either inserted or already present.
+        EntryType* entry;
+        /// @brief True if the entry was inserted.
+        bool inserted;
+    };
+
+    RAD_S_ASSERT_NOTHROW_MOVE_T(K);
+    RAD_S_ASSERT_NOTHROW_MOVE_T(V);
+
+    RAD_NOT_COPYABLE(FlatHashMap);
+
+    ~FlatHashMap()
+    {
+        RAD_S_ASSERT_NOTHROW_DTOR(IsNoThrowDtor<K> && IsNoThrowDtor<V>);
+
+        Release();
+    }
+
+    /// @brief Constructs an empty map with default-constructed hasher,
+    /// comparator and allocator.
+    FlatHashMap() noexcept = default;
+
+    /// @brief Constructs an empty map with a copy-constructed allocator.
+    /// @param alloc Allocator to copy.
+    explicit FlatHashMap(const AllocatorType& alloc) noexcept
+        : m_storage(alloc)
+    {
+    }
+
+    /// @brief Constructs an empty map with copy-constructed hasher,
+    /// comparator and allocator.
+    /// @param hash Hasher to copy.
+    /// @param eq Key comparator to copy.
+    /// @param alloc Allocator to copy.
+    FlatHashMap(const HasherType& hash,
+                const KeyEqualType& eq,
+                const AllocatorType& alloc) noexcept
+        : m_storage(alloc, hash, eq)
+    {
+    }
+
+    /// @brief Move constructs a map from another, leaving it empty.
+    /// @param other Map to steal from.
+    FlatHashMap(ThisType&& other) noexcept
+        : m_storage(other.Allocator(), other.Hasher(), other.KeyEq())
+    {
+        Tab() = other.Tab();
+        other.Tab() = Table();
+    }
+
+    /// @brief Moves the entries of another map into this, leaving it empty.
+    /// @param other Map to move entries from.
+    /// @return Reference to this map.
+    ThisType& operator=(ThisType&& other) noexcept
+    {
+        // Don't allow non-propagation of allocators
+        RAD_S_ASSERTMSG(
+            AllocatorTraits::IsAlwaysEqual ||
+                AllocatorTraits::PropagateOnMoveAssignment,
+            "Cannot use move assignment with this allocator, as it could cause "
+            "copies. Either change allocators, or use something like Clone().");
+
+        if RAD_UNLIKELY (this == &other)
+        {
+            return *this;
+        }
+
+        Release();
+        AllocatorTraits::PropagateOnMoveIfNeeded(Allocator(),
+                                                 other.Allocator());
+        Hasher() = other.Hasher();
+        KeyEq() = other.KeyEq();
+        Tab() = other.Tab();
+        other.Tab() = Table();
+        return *this;
+    }
+
+    /// @brief Checks if the map is empty.
+    /// @return True if the map holds no entries.
+    bool Empty() const noexcept
+    {
+        return Tab().size == 0;
+    }
+
+    /// @brief Gets the number of entries in the map.
+    /// @return Number of entries.
+    SizeType Size() const noexcept
+    {
+        return Tab().size;
+    }
+
+    /// @brief Gets the number of slots of the table.
+    /// @details The map grows before more than 7/8 of the slots are used.
+    /// @return Number of slots.
+    SizeType Capacity() const noexcept
+    {
+        return Tab().capacity;
+    }
+
+    RAD_NODISCARD IteratorType begin() noexcept
+    {
+        const Table& table = Tab();
+        return IteratorType(table.ctrl,
+                            table.ctrl + table.capacity,
+                            table.slots);
+    }
+
+    RAD_NODISCARD IteratorType end() noexcept
+    {
+        const Table& table = Tab();
+        return IteratorType(table.ctrl + table.capacity,
+                            table.ctrl + table.capacity,
+                            table.slots + table.capacity);
+    }
+
+    RAD_NODISCARD ConstIteratorType begin() const noexcept
+    {
+        const Table& table = Tab();
+        return ConstIteratorType(table.ctrl,
+                                 table.ctrl + table.capacity,
+                                 table.slots);
+    }
+
+    RAD_NODISCARD ConstIteratorType end() const noexcept
+    {
+        const Table& table = Tab();
+        return ConstIteratorType(table.ctrl + table.capacity,
+                                 table.ctrl + table.capacity,
+                                 table.slots + table.capacity);
+    }
+
+    RAD_NODISCARD ConstIteratorType cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    RAD_NODISCARD ConstIteratorType cend() const noexcept
+    {
+        return end();
+    }
+
+    /// @brief Grows the table so that it holds at least count entries without
+    /// growing again.
+    /// @param count Number of entries to make room for.
+    /// @return Reference to this map, or Error::NoMemory or
+    /// Error::IntegerOverflow if the table could not grow.
+    Res<ThisType&> Reserve(SizeType count) noexcept
+    {
+        SizeType capacity = MinCapacity;
+        while (MaxLoad(capacity) < count)
+        {
+            if RAD_UNLIKELY (capacity > (AllocatorTraits::MaxSize >> 2))
+            {
+                return Error::IntegerOverflow;
+            }
+
+            capacity <<= 1;
+        }
+
+        if (capacity > Tab().capacity)
+        {
+            Err err = Rehash(capacity);
+            if (err.IsErr())
+            {
+                return err.Err();
+            }
+        }
+
+        return *this;
+    }
+
+    /// @brief Destroys all entries, keeping the table.
+    /// @return Reference to this map.
+    ThisType& Clear() noexcept
+    {
+        Table& table = Tab();
+        DestroyEntries();
+        ResetCtrl(table.ctrl, table.capacity);
+        table.size = 0;
+        table.growthLeft = MaxLoad(table.capacity);
+        return *this;
+    }
+
+    /// @brief Inserts an entry constructed from a key and value arguments,
+    /// unless the key is already present.
+    /// @details Nothing is constructed if the key is present.
+    /// @param key Key of the entry, used to construct a K on insertion.
+    /// @param args Arguments for V construction.
+    /// @return The entry holding the key and whether it was inserted, or
+    /// Error::NoMemory if the table could not grow.
+    template <typename TKey, typename... TArgs>
+    Res<InsertResult> TryEmplace(TKey&& key, TArgs&&... args) noexcept(
+        IsNoThrowCtor<K, TKey&&> && IsNoThrowCtor<V, TArgs&&...>)
+    {
+        RAD_S_ASSERT_NOTHROW((IsNoThrowCtor<K, TKey&&> &&
+                              IsNoThrowCtor<V, TArgs&&...>));
+
+        const uint64_t hash = HashOf(key);
+        SizeType index = FindIndex(key, hash);
+        if (index != NotFound)
+        {
+            return InsertResult{ Tab().slots + index, false };
+        }
+
+        Res<SizeType> slot = PrepareInsert(hash);
+        if (slot.IsErr())
+        {
+            return slot.Err();
+        }
+
+        index = slot.Ok();
+        EntryType* entry = Tab().slots + index;
+        ::new (static_cast<void*>(entry))
+            EntryType(detail::HashEntryInPlaceTag{},
+                      Forward<TKey>(key),
+                      Forward<TArgs>(args)...);
+        CommitInsert(index, hash);
+        return InsertResult{ entry, true };
+    }
+
+    /// @brief Inserts an entry unless the key is already present.
+    /// @param key Key of the entry, used to construct a K on insertion.
+    /// @param value Value of the entry, used to construct a V on insertion.
+    /// @return The entry holding the key and whether it was inserted, or
+    /// Error::NoMemory if the table could not grow.
+    template <typename TKey, typename TValue>
+    Res<InsertResult> Insert(TKey&& key, TValue&& value) noexcept(
+        IsNoThrowCtor<K, TKey&&> && IsNoThrowCtor<V, TValue&&>)
+    {
+        return TryEmplace(Forward<TKey>(key), Forward<TValue>(value));
+    }
+
+    /// @brief Inserts an entry, or assigns the value if the key is already
+    /// present.
+    /// @param key Key of the entry, used to construct a K on insertion.
+    /// @param value Value to assign or insert.
+    /// @return The value in the map, or Error::NoMemory if the table could
+    /// not grow.
+    template <typename TKey, typename TValue>
+    Res<V&> InsertOrAssign(TKey&& key, TValue&& value) noexcept(
+        IsNoThrowCtor<K, TKey&&> && IsNoThrowCtor<V, TValue&&> &&
+        IsNoThrowAssign<V&, TValue&&>)
+    {
+        RAD_S_ASSERT_NOTHROW((IsNoThrowAssign<V&, TValue&&>));
+
+        const uint64_t hash = HashOf(key);
+        SizeType index = FindIndex(key, hash);
+        if (index != NotFound)
+        {
+            V& existing = Tab().slots[index].Value();
+            existing = Forward<TValue>(value);
+            return existing;
+        }
+
+        auto res = TryEmplace(Forward<TKey>(key), Forward<TValue>(value));
+        if (res.IsErr())
+        {
+            return res.Err();
+        }
+
+        return res.Ok().entry->Value();
+    }
+
+    /// @brief Finds the entry of a key.
+    /// @param key Key to look up.
+    /// @return The entry, or nullptr if the key is not present.
+    template <typename TKey>
+    EntryType* FindEntry(const TKey& key) noexcept
+    {
+        const SizeType index = FindIndex(key, HashOf(key));
+        return index == NotFound ? nullptr : Tab().slots + index;
+    }
+
+    /// @copydoc FindEntry
+    template <typename TKey>
+    const EntryType* FindEntry(const TKey& key) const noexcept
+    {
+        const SizeType index = FindIndex(key, HashOf(key));
+        return index == NotFound ? nullptr : Tab().slots + index;
+    }
+
+    /// @brief Finds the value of a key.
+    /// @param key Key to look up.
+    /// @return The value, or nullptr if the key is not present.
+    template <typename TKey>
+    V* Find(const TKey& key) noexcept
+    {
+        EntryType* entry = FindEntry(key);
+        return entry == nullptr ? nullptr : &entry->Value();
+    }
+
+    /// @copydoc Find
+    template <typename TKey>
+    const V* Find(const TKey& key) const noexcept
+    {
+        const EntryType* entry = FindEntry(key);
+        return entry == nullptr ? nullptr : &entry->Value();
+    }
+
+    /// @brief Seeks the value of a key.
+    /// @param key Key to look up.
+    /// @return The value, or Error::OutOfRange if the key is not present.
+    template <typename TKey>
+    Res<V&> Seek(const TKey& key) noexcept
+    {
+        V* value = Find(key);
+        if (value == nullptr)
+        {
+            return Error::OutOfRange;
+        }
+
+        return *value;
+    }
+
+    /// @copydoc Seek
+    template <typename TKey>
+    Res<const V&> Seek(const TKey& key) const noexcept
+    {
+        const V* value = Find(key);
+        if (value == nullptr)
+        {
+            return Error::OutOfRange;
+        }
+
+        return *value;
+    }
+
+    /// @brief Checks whether a key is present.
+    /// @param key Key to look up.
+    /// @return True if the map holds the key.
+    template <typename TKey>
+    bool Contains(const TKey& key) const noexcept
+    {
+        return FindIndex(key, HashOf(key)) != NotFound;
+    }
+
+    /// @brief Removes the entry of a key.
+    /// @param key Key to remove.
+    /// @return True if an entry was removed.
+    template <typename TKey>
+    bool Erase(const TKey& key) noexcept
+    {
+        const SizeType index = FindIndex(key, HashOf(key));
+        if (index == NotFound)
+        {
+            return false;
+        }
+
+        EraseAt(index);
+        return true;
+    }
+
+    /// @brief Removes the entries a predicate selects.
+    /// @param pred Predicate called with each entry.
+    /// @return Number of entries removed.
+    template <typename Predicate>
+    SizeType EraseIf(Predicate pred) noexcept(
+        noexcept(pred(DeclVal<const EntryType&>())))
+    {
+        RAD_S_ASSERT_NOTHROW(noexcept(pred(DeclVal<const EntryType&>())));
+
+        const Table& table = Tab();
+        SizeType count = 0;
+        for (SizeType i = 0; i < table.capacity; ++i)
+        {
+            if (detail::HashCtrlIsFull(table.ctrl[i]) &&
+                pred(static_cast<const EntryType&>(table.slots[i])))
+            {
+                EraseAt(i);
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    /// @brief Exchanges the contents of two maps.
+    /// @param other Map to swap with.
+    /// @return Reference to this map.
+    ThisType& Swap(ThisType& other) noexcept
+    {
+        // Don't allow non-propagation of allocators
+        RAD_S_ASSERTMSG(
+            AllocatorTraits::IsAlwaysEqual || AllocatorTraits::PropagateOnSwap,
+            "Cannot use Swap with this allocator, as it could cause copies. "
+            "Either change allocators, or use move construction.");
+
+        const Table table = Tab();
+        Tab() = other.Tab();
+        other.Tab() = table;
+
+        HasherType hash = Hasher();
+        Hasher() = other.Hasher();
+        other.Hasher() = hash;
+
+        KeyEqualType eq = KeyEq();
+        KeyEq() = other.KeyEq();
+        other.KeyEq() = eq;
+
+        AllocatorTraits::PropagateOnSwapIfNeeded(Allocator(),
+                                                 other.Allocator());
+        return *this;
+    }
+
+    /// @brief Creates a copy of the map.
+    /// @return The new map on success or an error.
+    Res<ThisType> Clone() noexcept(IsNoThrowCopyCtor<K> &&
+                                   IsNoThrowCopyCtor<V>)
+    {
+        RAD_S_ASSERT_NOTHROW(IsNoThrowCopyCtor<K> && IsNoThrowCopyCtor<V>);
+
+        ThisType local(Hasher(),
+                       KeyEq(),
+                       AllocatorTraits::SelectAllocOnCopy(Allocator()));
+        const Table& table = Tab();
+        if (table.capacity != 0)
+        {
+            Err err = local.Allocate(table.capacity);
+            if (err.IsErr())
+            {
+                return err.Err();
+            }
+
+            // same hash function, same capacity, so every entry keeps its
+            // slot and the control bytes copy over
+            Table& copy = local.Tab();
+            for (SizeType i = 0; i < CtrlCount(table.capacity); ++i)
+            {
+                copy.ctrl[i] = table.ctrl[i];
+            }
+
+            for (SizeType i = 0; i < table.capacity; ++i)
+            {
+                if (detail::HashCtrlIsFull(table.ctrl[i]))
+                {
+                    ::new (static_cast<void*>(copy.slots + i))
+                        EntryType(table.slots[i]);
+                }
+            }
+
+            copy.size = table.size;
+            copy.growthLeft = table.growthLeft;
+        }
+
+        return local;
+    }
+
+    /// @brief Returns the hasher.
+    /// @return The hasher.
+    HasherType GetHasher() const noexcept
+    {
+        return Hasher();
+    }
+
+    /// @brief Returns the key comparator.
+    /// @return The key comparator.
+    KeyEqualType GetKeyEqual() const noexcept
+    {
+        return KeyEq();
+    }
+
+    /// @brief Returns the allocator.
+    /// @return The allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return Allocator();
+    }
+
+private:
+
+    static constexpr SizeType NotFound = ~SizeType(0);
+
+    // smallest table, which must be at least a group wide
+    static constexpr SizeType MinCapacity = 16;
+    RAD_S_ASSERT(MinCapacity >= Group::Width);
+
+    struct Table
+    {
+        EntryType* slots = nullptr;
+        CtrlType* ctrl = nullptr;
+        SizeType capacity = 0;
+        SizeType size = 0;
+        SizeType growthLeft = 0;
+    };
+
+    using StorageType =
+        EmptyOptimizedPair<TAllocator,
+                           EmptyOptimizedPair<THash,
+                                              EmptyOptimizedPair<TEq, Table>>>;
+
+    // entries allowed in a table of the given capacity
+    static constexpr SizeType MaxLoad(SizeType capacity) noexcept
+    {
+        return capacity - capacity / 8;
+    }
+
+    // control bytes, with the first group cloned past the end so that a
+    // group can be loaded at every slot
+    static constexpr SizeType CtrlCount(SizeType capacity) noexcept
+    {
+        return capacity + Group::Width - 1;
+    }
+
+    static void ResetCtrl(CtrlType* ctrl, SizeType capacity) noexcept
+    {
+        if (ctrl != nullptr)
+        {
+            for (SizeType i = 0; i < CtrlCount(capacity); ++i)
+            {
+                ctrl[i] = detail::HashCtrlEmpty;
+            }
+        }
+    }
+
+    static SizeType H1(uint64_t hash) noexcept
+    {
+        return static_cast<SizeType>(hash >> 7);
+    }
+
+    static uint8_t H2(uint64_t hash) noexcept
+    {
+        return static_cast<uint8_t>(hash & 0x7f);
+    }
+
+    template <typename TKey>
+    uint64_t HashOf(const TKey& key) const noexcept
+    {
+        RAD_S_ASSERT_NOTHROW(noexcept(Hasher()(key)));
+
+        return static_cast<uint64_t>(Hasher()(key));
+    }
+
+    template <typename TKey>
+    SizeType FindIndex(const TKey& key, uint64_t hash) const noexcept
+    {
+        RAD_S_ASSERT_NOTHROW(
+            noexcept(KeyEq()(DeclVal<const K&>(), DeclVal<const TKey&>())));
+
+        const Table& table = Tab();
+        if (table.capacity == 0)
+        {
+            return NotFound;
+        }
+
+        const SizeType mask = table.capacity - 1;
+        const uint8_t h2 = H2(hash);
+        SizeType pos = H1(hash) & mask;
+        SizeType step = 0;
+        for (;;)
+        {
+            const Group group(table.ctrl + pos);
+            for (auto match = group.Match(h2); match; match.ClearLowest())
+            {
+                const SizeType index = (pos + match.Lowest()) & mask;
+                if RAD_LIKELY (KeyEq()(table.slots[index].Key(), key))
+                {
+                    return index;
+                }
+            }
+
+            if RAD_LIKELY (group.MatchEmpty())
+            {
+                return NotFound;
+            }
+
+            step += Group::Width;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    // first empty or deleted slot on the probe sequence of hash
+    SizeType FindFreeSlot(uint64_t hash) const noexcept
+    {
+        const Table& table = Tab();
+        const SizeType mask = table.capacity - 1;
+        SizeType pos = H1(hash) & mask;
+        SizeType step = 0;
+        for (;;)
+        {
+            const auto match = Group(table.ctrl + pos).MatchEmptyOrDeleted();
+            if RAD_LIKELY (match)
+            {
+                return (pos + match.Lowest()) & mask;
+            }
+
+            step += Group::Width;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    void SetCtrl(SizeType index, CtrlType value) noexcept
+    {
+        Table& table = Tab();
+        table.ctrl[index] = value;
+        // mirrors the first Width - 1 slots into the clones past the end
+        table.ctrl[((index - (Group::Width - 1)) & (table.capacity - 1)) +
+                   (Group::Width - 1)] = value;
+    }
+
+    // finds the slot for a new entry of hash, growing the table if needed
+    Res<SizeType> PrepareInsert(uint64_t hash) noexcept
+    {
+        Table& table = Tab();
+        if (table.capacity != 0)
+        {
+            const SizeType index = FindFreeSlot(hash);
+            // reusing a deleted slot does not use up an empty one
+            if (table.growthLeft != 0 ||
+                table.ctrl[index] == detail::HashCtrlDeleted)
+            {
+                return index;
+            }
+        }
+
+        // reclaim deleted slots in place when they make up a good part of
+        // the table, otherwise double it
+        SizeType capacity = MinCapacity;
+        if (table.capacity != 0)
+        {
+            capacity = table.capacity;
+            if (table.size * 32 > table.capacity * 25)
+            {
+                if RAD_UNLIKELY (capacity > (AllocatorTraits::MaxSize >> 2))
+                {
+                    return Error::IntegerOverflow;
+                }
+
+                capacity <<= 1;
+            }
+        }
+
+        Err err = Rehash(capacity);
+        if (err.IsErr())
+        {
+            return err.Err();
+        }
+
+        return FindFreeSlot(hash);
+    }
+
+    void CommitInsert(SizeType index, uint64_t hash) noexcept
+    {
+        Table& table = Tab();
+        if (table.ctrl[index] == detail::HashCtrlEmpty)
+        {
+            --table.growthLeft;
+        }
+
+        SetCtrl(index, static_cast<CtrlType>(H2(hash)));
+        ++table.size;
+    }
+
+    void EraseAt(SizeType index) noexcept
+    {
+        Table& table = Tab();
+        table.slots[index].~EntryType();
+        --table.size;
+
+        // the slot may become empty again unless it is part of a run of
+        // Width full or deleted slots, which a probe may have passed over
+        // without stopping
+        const SizeType mask = table.capacity - 1;
+        SizeType after = 0;
+        while (after < Group::Width &&
+               table.ctrl[(index + after + 1) & mask] != detail::HashCtrlEmpty)
+        {
+            ++after;
+        }
+
+        SizeType before = 0;
+        while (before < Group::Width &&
+               table.ctrl[(index - before - 1) & mask] != detail::HashCtrlEmpty)
+        {
+            ++before;
+        }
+
+        if (before + after + 1 < Group::Width)
+        {
+            SetCtrl(index, detail::HashCtrlEmpty);
+            ++table.growthLeft;
+        }
+        else
+        {
+            SetCtrl(index, detail::HashCtrlDeleted);
+        }
+    }
+
+    // allocates an empty table, replacing the current one, which must have
+    // been released or moved away
+    Err Allocate(SizeType capacity) noexcept
+    {
+        if RAD_UNLIKELY (capacity > (AllocatorTraits::MaxSize - Group::Width) /
+                                        (sizeof(EntryType) + 1))
+        {
+            return Error::IntegerOverflow;
+        }
+
+        void* mem = AllocatorTraits::AllocBytes(
+            Allocator(),
+            capacity * sizeof(EntryType) + CtrlCount(capacity));
+        if (mem == nullptr)
+        {
+            return Error::NoMemory;
+        }
+
+        Table& table = Tab();
+        table.slots = static_cast<EntryType*>(mem);
+        table.ctrl = reinterpret_cast<CtrlType*>(table.slots + capacity);
+        table.capacity = capacity;
+        table.size = 0;
+        table.growthLeft = MaxLoad(capacity);
+        ResetCtrl(table.ctrl, capacity);
+        return NoError;
+    }
+
+    Err Rehash(SizeType capacity) noexcept
+    {
+        const Table old = Tab();
+        Err err = Allocate(capacity);
+        if (err.IsErr())
+        {
+            Tab() = old;
+            return err;
+        }
+
+        for (SizeType i = 0; i < old.capacity; ++i)
+        {
+            if (detail::HashCtrlIsFull(old.ctrl[i]))
+            {
+                EntryType& entry = old.slots[i];
+                const uint64_t hash = HashOf(entry.Key());
+                const SizeType index = FindFreeSlot(hash);
+                ::new (static_cast<void*>(Tab().slots + index))
+                    EntryType(Move(entry));
+                entry.~EntryType();
+                CommitInsert(index, hash);
+            }
+        }
+
+        FreeTable(old);
+        return NoError;
+    }
+
+    void DestroyEntries() noexcept
+    {
+        const Table& table = Tab();
+        if (!IsTrivDtor<EntryType>)
+        {
+            for (SizeType i = 0; i < table.capacity; ++i)
+            {
+                if (detail::HashCtrlIsFull(table.ctrl[i]))
+                {
+                    table.slots[i].~EntryType();
+                }
+            }
+        }
+    }
+
+    void FreeTable(const Table& table) noexcept
+    {
+        if (table.slots != nullptr)
+        {
+            AllocatorTraits::FreeBytes(Allocator(),
+                                       table.slots,
+                                       table.capacity * sizeof(EntryType) +
+                                           CtrlCount(table.capacity));
+        }
+    }
+
+    void Release() noexcept
+    {
+        DestroyEntries();
+        FreeTable(Tab());
+        Tab() = Table();
+    }
+
+    AllocatorType& Allocator() noexcept
+    {
+        return m_storage.First();
+    }
+
+    const AllocatorType& Allocator() const noexcept
+    {
+        return m_storage.First();
+    }
+
+    HasherType& Hasher() noexcept
+    {
+        return m_storage.Second().First();
+    }
+
+    const HasherType& Hasher() const noexcept
+    {
+        return m_storage.Second().First();
+    }
+
+    KeyEqualType& KeyEq() noexcept
+    {
+        return m_storage.Second().Second().First();
+    }
+
+    const KeyEqualType& KeyEq() const noexcept
+    {
+        return m_storage.Second().Second().First();
+    }
+
+    Table& Tab() noexcept
+    {
+        return m_storage.Second().Second().Second();
+    }
+
+    const Table& Tab() const noexcept
+    {
+        return m_storage.Second().Second().Second();
+    }
+
+    StorageType m_storage;
+};
+
+} // namespace rad
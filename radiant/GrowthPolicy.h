@@ -0,0 +1,135 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+//
+// Growth policies decide the capacity a container grows to when it runs out
+// of room. Each provides
+//
+//   static uint32_t Next(uint32_t capacity,
+//                        uint32_t required,
+//                        size_t elementSize) noexcept;
+//
+// which returns a capacity of at least required elements, saturating at
+// UINT32_MAX. Growing geometrically keeps the cost of appends amortized
+// constant.
+//
+
+namespace rad
+{
+
+/// @brief Grows capacity by half, to 1.5 times its current size.
+/// @details Lets freed blocks be reused for later growth, at the cost of
+/// reallocating more often than doubling. This is the default for Vector.
+struct GrowByHalf
+{
+    static uint32_t Next(uint32_t capacity,
+                         uint32_t required,
+                         size_t elementSize) noexcept
+    {
+        RAD_UNUSED(elementSize);
+
+        if (capacity > UINT32_MAX - capacity / 2)
+        {
+            return UINT32_MAX;
+        }
+
+        const uint32_t growth = capacity + capacity / 2;
+        return growth < required ? required : growth;
+    }
+};
+
+/// @brief Doubles capacity, halving the number of reallocations compared to
+/// GrowByHalf at the cost of more unused capacity.
+struct GrowDouble
+{
+    static uint32_t Next(uint32_t capacity,
+                         uint32_t required,
+                         size_t elementSize) noexcept
+    {
+        RAD_UNUSED(elementSize);
+
+        if (capacity > UINT32_MAX / 2)
+        {
+            return UINT32_MAX;
+        }
+
+        const uint32_t growth = capacity * 2;
+        return growth < required ? required : growth;
+    }
+};
+
+/// @brief Grows capacity to the next power of two that holds the required
+/// number of elements, which suits allocators with power of two size classes.
+struct GrowPowerOfTwo
+{
+    static uint32_t Next(uint32_t capacity,
+                         uint32_t required,
+                         size_t elementSize) noexcept
+    {
+        RAD_UNUSED(capacity);
+        RAD_UNUSED(elementSize);
+
+        if (required > (UINT32_MAX / 2) + 1)
+        {
+            return UINT32_MAX;
+        }
+
+        uint32_t growth = 1;
+        while (growth < required)
+        {
+            growth *= 2;
+        }
+
+        return growth;
+    }
+};
+
+/// @brief Grows capacity by half, then rounds the allocation up to a whole
+/// number of pages so that the tail of the last page holds elements.
+/// @tparam TPageSize Page size in bytes, a power of two.
+template <size_t TPageSize = 4096>
+struct GrowPageRounded
+{
+    RAD_S_ASSERTMSG(TPageSize != 0 && (TPageSize & (TPageSize - 1)) == 0,
+                    "TPageSize must be a power of two");
+
+    static uint32_t Next(uint32_t capacity,
+                         uint32_t required,
+                         size_t elementSize) noexcept
+    {
+        const uint32_t growth =
+            GrowByHalf::Next(capacity, required, elementSize);
+        if (elementSize == 0 || elementSize > TPageSize)
+        {
+            // no room for another element in a partial page
+            return growth;
+        }
+
+        const uint64_t page = TPageSize;
+        const uint64_t bytes = uint64_t(growth) * elementSize;
+        const uint64_t rounded = (bytes + page - 1) & ~(page - 1);
+        const uint64_t count = rounded / elementSize;
+
+        return count > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(count);
+    }
+};
+
+} // namespace rad
@@ -0,0 +1,385 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Byte.h"
+#include "radiant/Span.h"
+#include "radiant/TypeTraits.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(RAD_MSC_VERSION) && !defined(RAD_CLANG_VERSION) &&                 \
+    (RAD_AMD64 || RAD_ARM64)
+#include <intrin.h>
+#endif
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Finalizer spreading every input bit over the
+/// whole 64-bit result.
+constexpr inline uint64_t HashMix(uint64_t x) noexcept
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+// Internal use only. Default secret of the byte hash.
+static constexpr uint64_t HashSecret0 = 0x2d358dccaa6c78a5ull;
+static constexpr uint64_t HashSecret1 = 0x8bb84b93962eacc9ull;
+static constexpr uint64_t HashSecret2 = 0x4b33a62ed433d4a3ull;
+static constexpr uint64_t HashSecret3 = 0x4d5a2da51de1aa47ull;
+
+/// @brief Internal use only. 128-bit product of two 64-bit words.
+struct HashProduct
+{
+    uint64_t lo;
+    uint64_t hi;
+};
+
+/// @brief Internal use only. Full 64x64 to 128-bit multiply usable in
+/// constant expressions.
+constexpr inline HashProduct HashMultiplyPortable(uint64_t a,
+                                                  uint64_t b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 Wide;
+    const Wide product = static_cast<Wide>(a) * b;
+    return HashProduct{ static_cast<uint64_t>(product),
+                        static_cast<uint64_t>(product >> 64) };
+#else
+    const uint64_t aLo = a & 0xffffffffu;
+    const uint64_t aHi = a >> 32;
+    const uint64_t bLo = b & 0xffffffffu;
+    const uint64_t bHi = b >> 32;
+    const uint64_t ll = aLo * bLo;
+    const uint64_t lh = aLo * bHi;
+    const uint64_t hl = aHi * bLo;
+    const uint64_t hh = aHi * bHi;
+    const uint64_t mid = (ll >> 32) + (lh & 0xffffffffu) + (hl & 0xffffffffu);
+    return HashProduct{ (mid << 32) | (ll & 0xffffffffu),
+                        hh + (lh >> 32) + (hl >> 32) + (mid >> 32) };
+#endif
+}
+
+/// @brief Internal use only. Same as HashMultiplyPortable, using the
+/// multiply intrinsics of compilers without a 128-bit integer type.
+inline HashProduct HashMultiply(uint64_t a, uint64_t b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    return HashMultiplyPortable(a, b);
+#elif defined(RAD_MSC_VERSION) && RAD_AMD64
+    HashProduct product;
+    product.lo = _umul128(a, b, &product.hi);
+    return product;
+#elif defined(RAD_MSC_VERSION) && RAD_ARM64
+    return HashProduct{ a * b, __umulh(a, b) };
+#else
+    return HashMultiplyPortable(a, b);
+#endif
+}
+
+/// @brief Internal use only. Reads little-endian words from characters one
+/// at a time, so that hashing works in constant expressions.
+struct HashConstexprReader
+{
+    const char* data;
+
+    constexpr uint64_t Read(size_t offset, size_t count) const noexcept
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            value |= uint64_t(static_cast<unsigned char>(data[offset + i]))
+                     << (i * 8);
+        }
+
+        return value;
+    }
+
+    constexpr uint64_t Read8(size_t offset) const noexcept
+    {
+        return Read(offset, 8);
+    }
+
+    constexpr uint64_t Read4(size_t offset) const noexcept
+    {
+        return Read(offset, 4);
+    }
+
+    constexpr uint64_t Read1(size_t offset) const noexcept
+    {
+        return Read(offset, 1);
+    }
+
+    static constexpr HashProduct Multiply(uint64_t a, uint64_t b) noexcept
+    {
+        return HashMultiplyPortable(a, b);
+    }
+};
+
+/// @brief Internal use only. Reads little-endian words from memory with
+/// unaligned loads.
+struct HashMemoryReader
+{
+    const unsigned char* data;
+
+    uint64_t Read8(size_t offset) const noexcept
+    {
+        uint64_t value;
+        memcpy(&value, data + offset, sizeof(value));
+        return FromLittle(value);
+    }
+
+    uint64_t Read4(size_t offset) const noexcept
+    {
+        uint32_t value;
+        memcpy(&value, data + offset, sizeof(value));
+        return FromLittle(value);
+    }
+
+    uint64_t Read1(size_t offset) const noexcept
+    {
+        return data[offset];
+    }
+
+    static HashProduct Multiply(uint64_t a, uint64_t b) noexcept
+    {
+        return HashMultiply(a, b);
+    }
+
+private:
+
+    static uint64_t FromLittle(uint64_t value) noexcept
+    {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return __builtin_bswap64(value);
+#else
+        return value;
+#endif
+    }
+
+    static uint64_t FromLittle(uint32_t value) noexcept
+    {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return __builtin_bswap32(value);
+#else
+        return value;
+#endif
+    }
+};
+
+/// @brief Internal use only. Multiplies and folds the product in half.
+template <typename TReader>
+constexpr uint64_t HashFold(uint64_t a, uint64_t b) noexcept
+{
+    const HashProduct product = TReader::Multiply(a, b);
+    return product.lo ^ product.hi;
+}
+
+/// @brief Internal use only. Mixes 16 bytes into a lane of the hash.
+template <typename TReader>
+constexpr uint64_t HashStep(const TReader& reader,
+                            size_t offset,
+                            uint64_t secret,
+                            uint64_t lane) noexcept
+{
+    return HashFold<TReader>(reader.Read8(offset) ^ secret,
+                             reader.Read8(offset + 8) ^ lane);
+}
+
+/// @brief Internal use only. wyhash-style hash of size bytes, consuming 48
+/// bytes per iteration in three independent lanes.
+template <typename TReader>
+constexpr uint64_t HashBytesImpl(TReader reader,
+                                 size_t size,
+                                 uint64_t seed) noexcept
+{
+    seed ^= HashFold<TReader>(seed ^ HashSecret0, HashSecret1);
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if RAD_LIKELY (size <= 16)
+    {
+        if (size >= 4)
+        {
+            // two possibly overlapping reads from each end cover 4 to 16
+            // bytes without branching on the size
+            const size_t mid = (size >> 3) << 2;
+            a = (reader.Read4(0) << 32) | reader.Read4(mid);
+            b = (reader.Read4(size - 4) << 32) | reader.Read4(size - 4 - mid);
+        }
+        else if (size > 0)
+        {
+            a = (reader.Read1(0) << 16) | (reader.Read1(size >> 1) << 8) |
+                reader.Read1(size - 1);
+        }
+    }
+    else
+    {
+        size_t offset = 0;
+        size_t left = size;
+        if RAD_UNLIKELY (left > 48)
+        {
+            uint64_t lane1 = seed;
+            uint64_t lane2 = seed;
+            do
+            {
+                seed = HashStep(reader, offset, HashSecret1, seed);
+                lane1 = HashStep(reader, offset + 16, HashSecret2, lane1);
+                lane2 = HashStep(reader, offset + 32, HashSecret3, lane2);
+                offset += 48;
+                left -= 48;
+            } while (left > 48);
+
+            seed ^= lane1 ^ lane2;
+        }
+
+        while (left > 16)
+        {
+            seed = HashStep(reader, offset, HashSecret1, seed);
+            offset += 16;
+            left -= 16;
+        }
+
+        // the last 16 bytes, overlapping what was already consumed
+        a = reader.Read8(offset + left - 16);
+        b = reader.Read8(offset + left - 8);
+    }
+
+    const HashProduct product = TReader::Multiply(a ^ HashSecret1, b ^ seed);
+    return HashFold<TReader>(product.lo ^ HashSecret0 ^
+                                 static_cast<uint64_t>(size),
+                             product.hi ^ HashSecret1);
+}
+
+} // namespace detail
+
+/// @brief Hashes a range of bytes.
+/// @details A wyhash-style hash built on 64x64 to 128-bit multiplies, which
+/// reads 8 bytes at a time and keeps three multiplies in flight on long
+/// inputs. It is fast and well distributed but not cryptographic, so keys
+/// chosen by an attacker should be hashed with a secret seed.
+/// @param bytes Bytes to hash.
+/// @param seed Seed selecting a different hash function.
+/// @return 64-bit hash of the bytes.
+inline uint64_t HashBytes(Span<const Byte> bytes, uint64_t seed = 0) noexcept
+{
+    return detail::HashBytesImpl(
+        detail::HashMemoryReader{
+            reinterpret_cast<const unsigned char*>(bytes.Data()) },
+        bytes.Size(),
+        seed);
+}
+
+/// @brief Hashes characters in a constant expression.
+/// @details Yields the same hash as HashBytes over the same bytes, so keys
+/// hashed at compile time match keys hashed at run time. Prefer HashBytes at
+/// run time, which reads whole words at once.
+/// @param data Characters to hash.
+/// @param size Number of characters.
+/// @param seed Seed selecting a different hash function.
+/// @return 64-bit hash of the characters.
+constexpr inline uint64_t ConstexprHashBytes(const char* data,
+                                             size_t size,
+                                             uint64_t seed = 0) noexcept
+{
+    return detail::HashBytesImpl(detail::HashConstexprReader{ data },
+                                 size,
+                                 seed);
+}
+
+/// @brief Hashes a string literal in a constant expression, without its
+/// terminator.
+/// @param str String literal to hash.
+/// @return 64-bit hash of the characters of the literal.
+template <size_t N>
+constexpr uint64_t ConstexprHashBytes(const char (&str)[N]) noexcept
+{
+    return ConstexprHashBytes(str, N - 1);
+}
+
+/// @brief Hash function object used by the hashed containers.
+/// @details Specialize Hash for a key type to make it hashable, the second
+/// parameter is only there to constrain the specializations provided here.
+/// Results must be well distributed over all 64 bits, as containers use both
+/// the low and the high bits.
+template <typename T, typename = void>
+struct Hash;
+
+/// @brief Hashes integers and enumerations.
+template <typename T>
+struct Hash<T, EnIf<IsIntegral<T> || is_enum<T>::value>>
+{
+    constexpr uint64_t operator()(T value) const noexcept
+    {
+        return detail::HashMix(static_cast<uint64_t>(value));
+    }
+};
+
+/// @brief Hashes pointers by address.
+template <typename T>
+struct Hash<T*>
+{
+    uint64_t operator()(const T* value) const noexcept
+    {
+        return detail::HashMix(reinterpret_cast<uintptr_t>(value));
+    }
+};
+
+/// @brief Hashes the contents of byte spans.
+template <SpanSizeType N>
+struct Hash<Span<const Byte, N>>
+{
+    uint64_t operator()(Span<const Byte, N> bytes) const noexcept
+    {
+        return HashBytes(bytes);
+    }
+};
+
+/// @brief Equality function object used by the hashed containers.
+template <typename T = void>
+struct EqualTo
+{
+    constexpr bool operator()(const T& left, const T& right) const
+        noexcept(noexcept(left == right))
+    {
+        return left == right;
+    }
+};
+
+/// @brief Equality function object comparing any two types which compare
+/// with each other, for heterogeneous lookups.
+template <>
+struct EqualTo<void>
+{
+    template <typename T, typename U>
+    constexpr bool operator()(const T& left, const U& right) const
+        noexcept(noexcept(left == right))
+    {
+        return left == right;
+    }
+};
+
+} // namespace rad
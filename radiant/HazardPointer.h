@@ -0,0 +1,463 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Algorithm.h"
+#include "radiant/Atomic.h"
+#include "radiant/CacheAligned.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/detail/Retired.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rad
+{
+
+namespace detail
+{
+
+RAD_BEGIN_CACHE_ALIGNED
+/// @brief Internal use only. Hazard slot of a HazardDomain.
+struct HazardRecord
+{
+    HazardRecord() noexcept = default;
+
+    RAD_NOT_COPYABLE(HazardRecord);
+
+    // keeps the hazards of different records on different cache lines
+    alignas(RAD_CACHE_LINE_SIZE) Atomic<const void*> hazard{ nullptr };
+    Atomic<uint32_t> inUse{ 1 };
+    HazardRecord* next = nullptr;
+};
+RAD_END_CACHE_ALIGNED
+
+} // namespace detail
+
+template <typename TAllocator>
+class HazardPointer;
+
+/// @brief Hazard pointer reclamation domain for lock-free data structures.
+/// @details A reader publishes the object it is about to access in a
+/// HazardPointer, and Retire() only frees objects no hazard pointer
+/// protects. Unlike epoch-based reclamation, a reader which stalls only keeps
+/// the one object it protects alive, so memory held back stays bounded by
+/// the number of hazard pointers. The price is a store and a reload on every
+/// protected read, where an EpochDomain guard pins once for many reads.
+///
+/// Retired objects are kept on one list shared by all threads. Once enough
+/// of them accumulated since the last scan, at least ScanThreshold and twice
+/// the number of hazard slots, they are checked against a sorted snapshot of
+/// the hazard pointers, so that a scan costs O((retired + slots) log slots)
+/// and objects that stay protected do not make every Retire() scan again.
+/// Hazard slots are reused once their HazardPointer is destroyed, and only
+/// freed with the domain, which must outlive every hazard pointer.
+/// @tparam TAllocator Thread-safe allocator used for hazard slots and
+/// retirement bookkeeping.
+template <typename TAllocator RAD_ALLOCATOR_EQ(void)>
+class HazardDomain final
+{
+private:
+
+    using RecordType = detail::HazardRecord;
+    using RetiredType = detail::RetiredNode<TAllocator>;
+
+public:
+
+    using AllocatorType = TAllocator;
+
+    /// @brief Minimum number of objects retired since the last scan after
+    /// which Retire() scans for objects to free.
+    static constexpr size_t ScanThreshold = 64;
+
+    RAD_NOT_COPYABLE(HazardDomain);
+    HazardDomain(HazardDomain&&) = delete;
+    HazardDomain& operator=(HazardDomain&&) = delete;
+
+    /// @brief Frees every retired object and hazard slot.
+    /// @warning No hazard pointer of the domain may be alive.
+    ~HazardDomain()
+    {
+        detail::ReclaimAll(m_retired.Load(MemOrderAcquire), Allocator());
+
+        RecordType* record = m_records.Second().Load(MemOrderAcquire);
+        while (record != nullptr)
+        {
+            RAD_ASSERT(record->inUse.Load(MemOrderRelaxed) == 0);
+            RecordType* next = record->next;
+            record->~RecordType();
+            detail::FreeCacheAligned(Allocator(), record);
+            record = next;
+        }
+    }
+
+    /// @brief Constructs a domain using a default-constructed allocator.
+    HazardDomain() noexcept = default;
+
+    /// @brief Constructs a domain using a copy-constructed allocator.
+    /// @param alloc Allocator to copy.
+    explicit HazardDomain(const AllocatorType& alloc) noexcept
+        : m_records(alloc, nullptr)
+    {
+    }
+
+    /// @brief Creates a hazard pointer, reusing the slot of a destroyed one
+    /// if there is one.
+    /// @return The hazard pointer, or Error::NoMemory if no slot could be
+    /// allocated.
+    Res<HazardPointer<TAllocator>> MakeHazardPointer() noexcept
+    {
+        using ResType = Res<HazardPointer<TAllocator>>;
+
+        Atomic<RecordType*>& head = m_records.Second();
+        for (RecordType* record = head.Load(MemOrderAcquire); record != nullptr;
+             record = record->next)
+        {
+            uint32_t free = 0;
+            if (record->inUse.Load(MemOrderRelaxed) == 0 &&
+                record->inUse.CompareExchangeStrong(free,
+                                                    1,
+                                                    MemOrderAcquire,
+                                                    MemOrderRelaxed))
+            {
+                return ResType(ResOkTag, HazardPointer<TAllocator>(record));
+            }
+        }
+
+        RecordType* record =
+            detail::AllocCacheAligned<RecordType>(Allocator());
+        if (record == nullptr)
+        {
+            return ResType(ResErrTag, Error::NoMemory);
+        }
+
+        ::new (static_cast<void*>(record)) RecordType();
+        RecordType* first = head.Load(MemOrderRelaxed);
+        do
+        {
+            record->next = first;
+        } while (!head.CompareExchangeWeak(first,
+                                           record,
+                                           MemOrderRelease,
+                                           MemOrderRelaxed));
+
+        return ResType(ResOkTag, HazardPointer<TAllocator>(record));
+    }
+
+    /// @brief Defers destroying and freeing an object until no hazard pointer
+    /// protects it.
+    /// @details The object must already be unlinked, so that new readers
+    /// cannot protect it. It is destroyed and freed through the allocator it
+    /// was allocated with, which is copied.
+    /// @param ptr Object to free.
+    /// @param alloc Allocator ptr was allocated from.
+    /// @return Error::NoMemory if the retirement could not be recorded, in
+    /// which case the caller still owns ptr.
+    template <typename T, typename TObjAlloc>
+    Err Retire(T* ptr, const TObjAlloc& alloc) noexcept
+    {
+        if (ptr == nullptr)
+        {
+            return NoError;
+        }
+
+        RetiredType* node = detail::MakeRetired(Allocator(), ptr, alloc, 0);
+        if (node == nullptr)
+        {
+            return Error::NoMemory;
+        }
+
+        Push(node, node);
+        if (m_retiredCount.FetchAdd(1, MemOrderRelaxed) + 1 >=
+            m_scanAt.Load(MemOrderRelaxed))
+        {
+            Scan();
+        }
+
+        return NoError;
+    }
+
+    /// @brief Frees the retired objects no hazard pointer protects.
+    /// @details The hazards are copied and sorted once per scan. Should the
+    /// copy fail to allocate, every retired object is checked against the
+    /// hazard slots directly instead.
+    /// @return Number of objects freed.
+    size_t Scan() noexcept
+    {
+        // the exchange orders the unlinking of the retired objects before
+        // the reads of the hazards
+        RetiredType* node = m_retired.Exchange(nullptr, MemOrderSeqCst);
+
+        // slots are only ever prepended, so walking from one head twice
+        // visits the same slots, and slots added later cannot protect
+        // objects which were already unlinked
+        const RecordType* records = m_records.Second().Load(MemOrderAcquire);
+        size_t slots = 0;
+        for (const RecordType* record = records; record != nullptr;
+             record = record->next)
+        {
+            ++slots;
+        }
+
+        uintptr_t* hazards = nullptr;
+        size_t hazardCount = 0;
+        if (node != nullptr && slots != 0)
+        {
+            hazards = AllocTraits<TAllocator>::template Alloc<uintptr_t>(
+                Allocator(),
+                slots);
+        }
+
+        if (hazards != nullptr)
+        {
+            for (const RecordType* record = records; record != nullptr;
+                 record = record->next)
+            {
+                const void* hazard = record->hazard.Load(MemOrderSeqCst);
+                if (hazard != nullptr)
+                {
+                    hazards[hazardCount++] =
+                        reinterpret_cast<uintptr_t>(hazard);
+                }
+            }
+
+            Sort(hazards, hazards + hazardCount);
+        }
+
+        RetiredType* keptFirst = nullptr;
+        RetiredType* keptLast = nullptr;
+        size_t kept = 0;
+        size_t count = 0;
+        while (node != nullptr)
+        {
+            RetiredType* next = node->next;
+            const bool isProtected =
+                hazards != nullptr
+                    ? Contains(hazards, hazardCount, node->object)
+                    : IsProtected(records, node->object);
+            if (isProtected)
+            {
+                node->next = keptFirst;
+                keptFirst = node;
+                if (keptLast == nullptr)
+                {
+                    keptLast = node;
+                }
+
+                ++kept;
+            }
+            else
+            {
+                node->reclaim(node, Allocator());
+                ++count;
+            }
+
+            node = next;
+        }
+
+        if (hazards != nullptr)
+        {
+            AllocTraits<TAllocator>::Free(Allocator(), hazards, slots);
+        }
+
+        if (keptFirst != nullptr)
+        {
+            Push(keptFirst, keptLast);
+        }
+
+        // scanning again before enough new objects were retired would mostly
+        // find the kept objects still protected
+        const size_t interval =
+            2 * slots > ScanThreshold ? 2 * slots : ScanThreshold;
+        m_scanAt.Store(kept + interval, MemOrderRelaxed);
+        m_retiredCount.FetchSub(count, MemOrderRelaxed);
+        return count;
+    }
+
+    /// @brief Gets the number of retired objects which are not freed yet.
+    /// @return Number of objects awaiting reclamation.
+    size_t RetiredCount() const noexcept
+    {
+        return m_retiredCount.Load(MemOrderRelaxed);
+    }
+
+    /// @brief Returns the allocator.
+    /// @return The allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_records.First();
+    }
+
+private:
+
+    static bool Contains(const uintptr_t* hazards,
+                         size_t count,
+                         const void* object) noexcept
+    {
+        const uintptr_t value = reinterpret_cast<uintptr_t>(object);
+        Less<> less;
+        const uintptr_t* found =
+            detail::sort::LowerBound(hazards, hazards + count, value, less);
+        return found != hazards + count && *found == value;
+    }
+
+    static bool IsProtected(const RecordType* records,
+                            const void* object) noexcept
+    {
+        for (const RecordType* record = records; record != nullptr;
+             record = record->next)
+        {
+            if (record->hazard.Load(MemOrderSeqCst) == object)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Push(RetiredType* first, RetiredType* last) noexcept
+    {
+        RetiredType* head = m_retired.Load(MemOrderRelaxed);
+        do
+        {
+            last->next = head;
+        } while (!m_retired.CompareExchangeWeak(head,
+                                                first,
+                                                MemOrderRelease,
+                                                MemOrderRelaxed));
+    }
+
+    AllocatorType& Allocator() noexcept
+    {
+        return m_records.First();
+    }
+
+    EmptyOptimizedPair<AllocatorType, Atomic<RecordType*>> m_records;
+    Atomic<RetiredType*> m_retired{ nullptr };
+    Atomic<size_t> m_retiredCount{ 0 };
+    Atomic<size_t> m_scanAt{ ScanThreshold };
+};
+
+/// @brief Single-object protection slot of a HazardDomain.
+/// @details While an object is protected, the domain does not free it even
+/// if it is retired. A hazard pointer protects at most one object at a time
+/// and may only be used by one thread at a time. It releases its slot to the
+/// domain when destroyed.
+template <typename TAllocator>
+class HazardPointer final
+{
+public:
+
+    /// @brief Constructs a hazard pointer without a slot, which cannot
+    /// protect anything.
+    HazardPointer() noexcept = default;
+
+    RAD_NOT_COPYABLE(HazardPointer);
+
+    HazardPointer(HazardPointer&& other) noexcept
+        : m_record(other.m_record)
+    {
+        other.m_record = nullptr;
+    }
+
+    HazardPointer& operator=(HazardPointer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Release();
+            m_record = other.m_record;
+            other.m_record = nullptr;
+        }
+
+        return *this;
+    }
+
+    /// @brief Clears the protection and returns the slot to the domain.
+    ~HazardPointer()
+    {
+        Release();
+    }
+
+    /// @brief Checks whether the hazard pointer owns a slot.
+    /// @return True unless default-constructed or moved from.
+    bool IsValid() const noexcept
+    {
+        return m_record != nullptr;
+    }
+
+    /// @brief Loads a pointer and protects the object it points to.
+    /// @details Retries until the source still holds the protected pointer
+    /// after publishing it, so the object cannot have been retired and freed
+    /// before the protection became visible. Any previous protection is
+    /// replaced.
+    /// @param src Atomic pointer to load.
+    /// @return The loaded pointer, which stays safe to dereference until the
+    /// protection is replaced or reset.
+    template <typename T>
+    T* Protect(const detail::atomic::AtomicPointer<T*>& src) noexcept
+    {
+        RAD_ASSERT(m_record != nullptr);
+
+        T* ptr = src.Load(MemOrderRelaxed);
+        for (;;)
+        {
+            // the exchange orders the publication before the reload
+            m_record->hazard.Exchange(ptr, MemOrderSeqCst);
+            T* current = src.Load(MemOrderSeqCst);
+            if (current == ptr)
+            {
+                return ptr;
+            }
+
+            ptr = current;
+        }
+    }
+
+    /// @brief Clears the protection.
+    void Reset() noexcept
+    {
+        RAD_ASSERT(m_record != nullptr);
+
+        m_record->hazard.Store(nullptr, MemOrderRelease);
+    }
+
+private:
+
+    template <typename>
+    friend class HazardDomain;
+
+    explicit HazardPointer(detail::HazardRecord* record) noexcept
+        : m_record(record)
+    {
+    }
+
+    void Release() noexcept
+    {
+        if (m_record != nullptr)
+        {
+            m_record->hazard.Store(nullptr, MemOrderRelease);
+            m_record->inUse.Store(0, MemOrderRelease);
+            m_record = nullptr;
+        }
+    }
+
+    detail::HazardRecord* m_record = nullptr;
+};
+
+} // namespace rad
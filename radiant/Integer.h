@@ -12,15 +12,74 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#pragma once
+
 #include "radiant/TotallyRad.h"
 #include "radiant/Res.h"
+#include "radiant/Span.h"
 #include "radiant/TypeTraits.h"
 
 #include <stdint.h>
+#include <string.h>
+
+//
+// The checked operations use the compiler's overflow builtins where they are
+// available, which compile to the plain instruction followed by a branch on
+// the overflow or carry flag. Elsewhere the operands are widened to the next
+// larger type and the result is range checked.
+//
+#if !defined(RAD_MSC_VERSION) && RAD_HAS_BUILTIN(__builtin_add_overflow) &&  \
+    RAD_HAS_BUILTIN(__builtin_sub_overflow) &&                                \
+    RAD_HAS_BUILTIN(__builtin_mul_overflow)
+#define RAD_INTEGER_BUILTINS 1
+#else
+#define RAD_INTEGER_BUILTINS 0
+#endif
 
 namespace rad
 {
 
+namespace detail
+{
+
+template <typename W, typename T>
+constexpr bool IntegerAddOverflows(T lhs, T rhs, T& res) noexcept
+{
+#if RAD_INTEGER_BUILTINS
+    return __builtin_add_overflow(lhs, rhs, &res);
+#else
+    const W wide = static_cast<W>(static_cast<W>(lhs) + static_cast<W>(rhs));
+    res = static_cast<T>(wide);
+    return wide != static_cast<W>(res);
+#endif
+}
+
+template <typename W, typename T>
+constexpr bool IntegerSubOverflows(T lhs, T rhs, T& res) noexcept
+{
+#if RAD_INTEGER_BUILTINS
+    return __builtin_sub_overflow(lhs, rhs, &res);
+#else
+    const W wide = static_cast<W>(static_cast<W>(lhs) - static_cast<W>(rhs));
+    res = static_cast<T>(wide);
+    return wide != static_cast<W>(res);
+#endif
+}
+
+template <typename W, typename T>
+constexpr bool IntegerMulOverflows(T lhs, T rhs, T& res) noexcept
+{
+#if RAD_INTEGER_BUILTINS
+    return __builtin_mul_overflow(lhs, rhs, &res);
+#else
+    const W wide = static_cast<W>(static_cast<W>(lhs) * static_cast<W>(rhs));
+    res = static_cast<T>(wide);
+    return wide != static_cast<W>(res);
+#endif
+}
+
+} // namespace detail
+
 template <typename T>
 struct IntegerTraits;
 
@@ -30,6 +89,9 @@ struct GenericIntegerTraits;
 template <typename T, typename W, T TMin, T TMax>
 struct GenericIntegerTraits<T, W, TMin, TMax, true>
 {
+    using ValueType = T;
+    using WideType = W;
+
     static constexpr T MIN = TMin;
     static constexpr T MAX = TMax;
 
@@ -37,38 +99,38 @@ struct GenericIntegerTraits<T, W, TMin, TMax, true>
 
     static constexpr Res<T> Add(T lhs, T rhs) noexcept
     {
-        W res = static_cast<W>(lhs) + static_cast<W>(rhs);
+        T res = 0;
 
-        if ((res > MAX) || (res < MIN))
+        if (detail::IntegerAddOverflows<W>(lhs, rhs, res))
         {
             return Error::IntegerOverflow;
         }
 
-        return static_cast<T>(res);
+        return res;
     }
 
     static constexpr Res<T> Sub(T lhs, T rhs) noexcept
     {
-        W res = static_cast<W>(lhs) - static_cast<W>(rhs);
+        T res = 0;
 
-        if ((res > MAX) || (res < MIN))
+        if (detail::IntegerSubOverflows<W>(lhs, rhs, res))
         {
             return Error::IntegerOverflow;
         }
 
-        return static_cast<T>(res);
+        return res;
     }
 
     static constexpr Res<T> Mul(T lhs, T rhs) noexcept
     {
-        W res = static_cast<W>(lhs) * static_cast<W>(rhs);
+        T res = 0;
 
-        if ((res > MAX) || (res < MIN))
+        if (detail::IntegerMulOverflows<W>(lhs, rhs, res))
         {
             return Error::IntegerOverflow;
         }
 
-        return static_cast<T>(res);
+        return res;
     }
 
     static constexpr T SaturatingAdd(T lhs, T rhs) noexcept
@@ -110,6 +172,9 @@ struct GenericIntegerTraits<T, W, TMin, TMax, true>
 template <typename T, typename W, T TMin, T TMax>
 struct GenericIntegerTraits<T, W, TMin, TMax, false>
 {
+    using ValueType = T;
+    using WideType = W;
+
     static constexpr T MIN = TMin;
     static constexpr T MAX = TMax;
 
@@ -117,9 +182,9 @@ struct GenericIntegerTraits<T, W, TMin, TMax, false>
 
     static constexpr Res<T> Add(T lhs, T rhs) noexcept
     {
-        T res = lhs + rhs;
+        T res = 0;
 
-        if (res < lhs)
+        if (detail::IntegerAddOverflows<W>(lhs, rhs, res))
         {
             return Error::IntegerOverflow;
         }
@@ -129,26 +194,26 @@ struct GenericIntegerTraits<T, W, TMin, TMax, false>
 
     static constexpr Res<T> Sub(T lhs, T rhs) noexcept
     {
-        T res = lhs - rhs;
+        T res = 0;
 
-        if (res > lhs)
+        if (detail::IntegerSubOverflows<W>(lhs, rhs, res))
         {
             return Error::IntegerOverflow;
         }
 
-        return static_cast<T>(res);
+        return res;
     }
 
     static constexpr Res<T> Mul(T lhs, T rhs) noexcept
     {
-        W res = static_cast<W>(lhs) * static_cast<W>(rhs);
+        T res = 0;
 
-        if (res > MAX)
+        if (detail::IntegerMulOverflows<W>(lhs, rhs, res))
         {
             return Error::IntegerOverflow;
         }
 
-        return static_cast<T>(res);
+        return res;
     }
 
     static constexpr T SaturatingAdd(T lhs, T rhs) noexcept
@@ -505,4 +570,402 @@ constexpr inline bool operator>=(const Integer<T>& lhs,
     return static_cast<T>(lhs) >= rhs;
 }
 
+namespace detail
+{
+
+//
+// Branch free forms of the checked and saturating operations, written so the
+// compiler can vectorize loops over them. Signed results wrap through the
+// unsigned type and overflow is read from the sign bits, unsigned sums and
+// differences compare against an operand, and products are formed in the
+// wide type.
+//
+template <typename T, bool = IsSigned<T>>
+struct IntegerLanes;
+
+template <typename T>
+struct IntegerLanes<T, true>
+{
+    using U = MakeUnsigned<T>;
+    using W = typename IntegerTraits<T>::WideType;
+
+    static constexpr T Min = IntegerTraits<T>::MIN;
+    static constexpr T Max = IntegerTraits<T>::MAX;
+
+    static T Add(T lhs, T rhs) noexcept
+    {
+        return static_cast<T>(
+            static_cast<U>(static_cast<U>(lhs) + static_cast<U>(rhs)));
+    }
+
+    static T Sub(T lhs, T rhs) noexcept
+    {
+        return static_cast<T>(
+            static_cast<U>(static_cast<U>(lhs) - static_cast<U>(rhs)));
+    }
+
+    static T Mul(T lhs, T rhs) noexcept
+    {
+        return static_cast<T>(static_cast<W>(lhs) * rhs);
+    }
+
+    static bool AddOverflows(T lhs, T rhs) noexcept
+    {
+        const T res = Add(lhs, rhs);
+        return ((lhs ^ res) & (rhs ^ res)) < 0;
+    }
+
+    static bool SubOverflows(T lhs, T rhs) noexcept
+    {
+        const T res = Sub(lhs, rhs);
+        return ((lhs ^ rhs) & (lhs ^ res)) < 0;
+    }
+
+    static bool MulOverflows(T lhs, T rhs) noexcept
+    {
+        const W wide = static_cast<W>(static_cast<W>(lhs) * rhs);
+        return wide != static_cast<T>(wide);
+    }
+
+    static T SaturatingAdd(T lhs, T rhs) noexcept
+    {
+        const T limit = lhs < 0 ? Min : Max;
+        return AddOverflows(lhs, rhs) ? limit : Add(lhs, rhs);
+    }
+
+    static T SaturatingSub(T lhs, T rhs) noexcept
+    {
+        const T limit = lhs < 0 ? Min : Max;
+        return SubOverflows(lhs, rhs) ? limit : Sub(lhs, rhs);
+    }
+
+    static T SaturatingMul(T lhs, T rhs) noexcept
+    {
+        const W wide = static_cast<W>(static_cast<W>(lhs) * rhs);
+        return wide > Max ? Max : (wide < Min ? Min : static_cast<T>(wide));
+    }
+};
+
+template <typename T>
+struct IntegerLanes<T, false>
+{
+    using W = typename IntegerTraits<T>::WideType;
+
+    static constexpr T Min = IntegerTraits<T>::MIN;
+    static constexpr T Max = IntegerTraits<T>::MAX;
+
+    static T Add(T lhs, T rhs) noexcept
+    {
+        return static_cast<T>(lhs + rhs);
+    }
+
+    static T Sub(T lhs, T rhs) noexcept
+    {
+        return static_cast<T>(lhs - rhs);
+    }
+
+    static T Mul(T lhs, T rhs) noexcept
+    {
+        return static_cast<T>(static_cast<W>(lhs) * rhs);
+    }
+
+    static bool AddOverflows(T lhs, T rhs) noexcept
+    {
+        return Add(lhs, rhs) < lhs;
+    }
+
+    static bool SubOverflows(T lhs, T rhs) noexcept
+    {
+        return lhs < rhs;
+    }
+
+    static bool MulOverflows(T lhs, T rhs) noexcept
+    {
+        return static_cast<W>(static_cast<W>(lhs) * rhs) > Max;
+    }
+
+    static T SaturatingAdd(T lhs, T rhs) noexcept
+    {
+        return AddOverflows(lhs, rhs) ? Max : Add(lhs, rhs);
+    }
+
+    static T SaturatingSub(T lhs, T rhs) noexcept
+    {
+        return lhs < rhs ? Min : Sub(lhs, rhs);
+    }
+
+    static T SaturatingMul(T lhs, T rhs) noexcept
+    {
+        const W wide = static_cast<W>(static_cast<W>(lhs) * rhs);
+        return wide > Max ? Max : static_cast<T>(wide);
+    }
+};
+
+template <typename T>
+constexpr T IntegerLanes<T, true>::Min;
+template <typename T>
+constexpr T IntegerLanes<T, true>::Max;
+template <typename T>
+constexpr T IntegerLanes<T, false>::Min;
+template <typename T>
+constexpr T IntegerLanes<T, false>::Max;
+
+struct IntegerLaneAdd
+{
+    template <typename T>
+    static T Wrap(T lhs, T rhs) noexcept
+    {
+        return IntegerLanes<T>::Add(lhs, rhs);
+    }
+
+    template <typename T>
+    static bool Overflows(T lhs, T rhs) noexcept
+    {
+        return IntegerLanes<T>::AddOverflows(lhs, rhs);
+    }
+
+    template <typename T>
+    static T Saturate(T lhs, T rhs) noexcept
+    {
+        return IntegerLanes<T>::SaturatingAdd(lhs, rhs);
+    }
+};
+
+struct IntegerLaneSub
+{
+    template <typename T>
+    static T Wrap(T lhs, T rhs) noexcept
+    {
+        return IntegerLanes<T>::Sub(lhs, rhs);
+    }
+
+    template <typename T>
+    static bool Overflows(T lhs, T rhs) noexcept
+    {
+        return IntegerLanes<T>::SubOverflows(lhs, rhs);
+    }
+
+    template <typename T>
+    static T Saturate(T lhs, T rhs) noexcept
+    {
+        return IntegerLanes<T>::SaturatingSub(lhs, rhs);
+    }
+};
+
+struct IntegerLaneMul
+{
+    template <typename T>
+    static T Wrap(T lhs, T rhs) noexcept
+    {
+        return IntegerLanes<T>::Mul(lhs, rhs);
+    }
+
+    template <typename T>
+    static bool Overflows(T lhs, T rhs) noexcept
+    {
+        return IntegerLanes<T>::MulOverflows(lhs, rhs);
+    }
+
+    template <typename T>
+    static T Saturate(T lhs, T rhs) noexcept
+    {
+        return IntegerLanes<T>::SaturatingMul(lhs, rhs);
+    }
+};
+
+/// @brief Number of elements the span operations compute at a time.
+static constexpr SpanSizeType IntegerBlockSize = 64;
+
+/// @details The block is computed into a local buffer rather than straight
+/// into the destination, so the compiler can vectorize the loop without
+/// proving that the destination does not overlap the inputs.
+template <typename TOp, typename T>
+bool IntegerBlockChecked(const T* lhs, const T* rhs, T* block) noexcept
+{
+    unsigned overflow = 0;
+    for (SpanSizeType i = 0; i < IntegerBlockSize; ++i)
+    {
+        overflow |= static_cast<unsigned>(TOp::Overflows(lhs[i], rhs[i]));
+        block[i] = TOp::Wrap(lhs[i], rhs[i]);
+    }
+
+    return overflow != 0;
+}
+
+template <typename TOp, typename T>
+void IntegerBlockSaturating(const T* lhs, const T* rhs, T* block) noexcept
+{
+    for (SpanSizeType i = 0; i < IntegerBlockSize; ++i)
+    {
+        block[i] = TOp::Saturate(lhs[i], rhs[i]);
+    }
+}
+
+/// @details Full blocks are checked and computed in one pass and only copied
+/// out once they are known not to overflow, so the output may alias either
+/// input. The block which overflows, and the final partial block, are redone
+/// one element at a time.
+template <typename TOp, typename T>
+SpanSizeType IntegerChecked(const T* lhs,
+                            const T* rhs,
+                            T* out,
+                            SpanSizeType count) noexcept
+{
+    SpanSizeType start = 0;
+    for (; count - start >= IntegerBlockSize; start += IntegerBlockSize)
+    {
+        T block[IntegerBlockSize];
+        if RAD_UNLIKELY (IntegerBlockChecked<TOp>(lhs + start,
+                                                  rhs + start,
+                                                  block))
+        {
+            break;
+        }
+
+        memcpy(out + start, block, sizeof(block));
+    }
+
+    for (; start < count; ++start)
+    {
+        if (TOp::Overflows(lhs[start], rhs[start]))
+        {
+            return start;
+        }
+
+        out[start] = TOp::Wrap(lhs[start], rhs[start]);
+    }
+
+    return count;
+}
+
+template <typename TOp, typename T>
+void IntegerSaturating(const T* lhs,
+                       const T* rhs,
+                       T* out,
+                       SpanSizeType count) noexcept
+{
+    SpanSizeType start = 0;
+    for (; count - start >= IntegerBlockSize; start += IntegerBlockSize)
+    {
+        T block[IntegerBlockSize];
+        IntegerBlockSaturating<TOp>(lhs + start, rhs + start, block);
+        memcpy(out + start, block, sizeof(block));
+    }
+
+    for (; start < count; ++start)
+    {
+        out[start] = TOp::Saturate(lhs[start], rhs[start]);
+    }
+}
+
+} // namespace detail
+
+/// @brief Adds two spans of integers element by element, stopping at the
+/// first sum which overflows.
+/// @details The elements before the returned index hold the sums and the
+/// rest of @p out is left unchanged. @p out may be one of the inputs, which
+/// accumulates in place. The loops are written so the compiler vectorizes
+/// them, and overflow is tested a block at a time, so a clean run costs
+/// little more than unchecked addition.
+/// @param lhs Left hand operands.
+/// @param rhs Right hand operands, the same size as @p lhs.
+/// @param out Destination, at least the size of @p lhs.
+/// @return Index of the first overflowing element, or the size of @p lhs if
+/// none overflowed.
+template <typename T>
+SpanSizeType AddChecked(Span<const typename IntegerTraits<T>::ValueType> lhs,
+                        Span<const typename IntegerTraits<T>::ValueType> rhs,
+                        Span<T> out) noexcept
+{
+    RAD_ASSERT(rhs.Size() == lhs.Size());
+    RAD_ASSERT(out.Size() >= lhs.Size());
+    return detail::IntegerChecked<detail::IntegerLaneAdd>(lhs.Data(),
+                                                          rhs.Data(),
+                                                          out.Data(),
+                                                          lhs.Size());
+}
+
+/// @brief Subtracts two spans of integers element by element, stopping at
+/// the first difference which overflows.
+/// @see AddChecked
+template <typename T>
+SpanSizeType SubChecked(Span<const typename IntegerTraits<T>::ValueType> lhs,
+                        Span<const typename IntegerTraits<T>::ValueType> rhs,
+                        Span<T> out) noexcept
+{
+    RAD_ASSERT(rhs.Size() == lhs.Size());
+    RAD_ASSERT(out.Size() >= lhs.Size());
+    return detail::IntegerChecked<detail::IntegerLaneSub>(lhs.Data(),
+                                                          rhs.Data(),
+                                                          out.Data(),
+                                                          lhs.Size());
+}
+
+/// @brief Multiplies two spans of integers element by element, stopping at
+/// the first product which overflows.
+/// @see AddChecked
+template <typename T>
+SpanSizeType MulChecked(Span<const typename IntegerTraits<T>::ValueType> lhs,
+                        Span<const typename IntegerTraits<T>::ValueType> rhs,
+                        Span<T> out) noexcept
+{
+    RAD_ASSERT(rhs.Size() == lhs.Size());
+    RAD_ASSERT(out.Size() >= lhs.Size());
+    return detail::IntegerChecked<detail::IntegerLaneMul>(lhs.Data(),
+                                                          rhs.Data(),
+                                                          out.Data(),
+                                                          lhs.Size());
+}
+
+/// @brief Adds two spans of integers element by element, clamping each sum
+/// to the range of the type.
+/// @details @p out may be one of the inputs.
+/// @param lhs Left hand operands.
+/// @param rhs Right hand operands, the same size as @p lhs.
+/// @param out Destination, at least the size of @p lhs.
+template <typename T>
+void SaturatingAdd(Span<const typename IntegerTraits<T>::ValueType> lhs,
+                   Span<const typename IntegerTraits<T>::ValueType> rhs,
+                   Span<T> out) noexcept
+{
+    RAD_ASSERT(rhs.Size() == lhs.Size());
+    RAD_ASSERT(out.Size() >= lhs.Size());
+    detail::IntegerSaturating<detail::IntegerLaneAdd>(lhs.Data(),
+                                                        rhs.Data(),
+                                                        out.Data(),
+                                                        lhs.Size());
+}
+
+/// @brief Subtracts two spans of integers element by element, clamping each
+/// difference to the range of the type.
+/// @see SaturatingAdd
+template <typename T>
+void SaturatingSub(Span<const typename IntegerTraits<T>::ValueType> lhs,
+                   Span<const typename IntegerTraits<T>::ValueType> rhs,
+                   Span<T> out) noexcept
+{
+    RAD_ASSERT(rhs.Size() == lhs.Size());
+    RAD_ASSERT(out.Size() >= lhs.Size());
+    detail::IntegerSaturating<detail::IntegerLaneSub>(lhs.Data(),
+                                                        rhs.Data(),
+                                                        out.Data(),
+                                                        lhs.Size());
+}
+
+/// @brief Multiplies two spans of integers element by element, clamping
+/// each product to the range of the type.
+/// @see SaturatingAdd
+template <typename T>
+void SaturatingMul(Span<const typename IntegerTraits<T>::ValueType> lhs,
+                   Span<const typename IntegerTraits<T>::ValueType> rhs,
+                   Span<T> out) noexcept
+{
+    RAD_ASSERT(rhs.Size() == lhs.Size());
+    RAD_ASSERT(out.Size() >= lhs.Size());
+    detail::IntegerSaturating<detail::IntegerLaneMul>(lhs.Data(),
+                                                        rhs.Data(),
+                                                        out.Data(),
+                                                        lhs.Size());
+}
+
 } // namespace rad
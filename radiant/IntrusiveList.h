@@ -0,0 +1,536 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/detail/ListOperations.h"
+
+#include <stddef.h>
+
+#if RAD_ENABLE_STD
+#include <iterator>
+#endif // RAD_ENABLE_STD
+
+namespace rad
+{
+
+class IntrusiveListHook;
+
+template <typename T, IntrusiveListHook T::*THook>
+class IntrusiveList;
+
+namespace detail
+{
+template <typename T, IntrusiveListHook T::*THook>
+struct IntrusiveListAccess;
+} // namespace detail
+
+/// @brief Links an object into an IntrusiveList.
+/// @details Embed one hook per list the object can be on. The hook is
+/// immovable, and unlinks itself when destroyed, so an object may be destroyed
+/// while still on a list.
+class IntrusiveListHook
+{
+public:
+
+    IntrusiveListHook() noexcept = default;
+
+    ~IntrusiveListHook()
+    {
+        Unlink();
+    }
+
+    // immovable
+    RAD_NOT_COPYABLE(IntrusiveListHook);
+    IntrusiveListHook(IntrusiveListHook&&) = delete;
+    IntrusiveListHook& operator=(IntrusiveListHook&&) = delete;
+
+    /// @brief Checks if the hook is on a list.
+    /// @return True if linked.
+    bool IsLinked() const noexcept
+    {
+        return m_node.m_next != &m_node;
+    }
+
+    /// @brief Removes the hook from whichever list it is on, in O(1). Does
+    /// nothing if the hook is not linked.
+    void Unlink() noexcept
+    {
+        if (IsLinked())
+        {
+            m_node.CheckSanityBeforeRelinking();
+            m_node.m_prev->m_next = m_node.m_next;
+            m_node.m_next->m_prev = m_node.m_prev;
+            m_node.Unlink();
+        }
+    }
+
+private:
+
+    template <typename T, IntrusiveListHook T::*THook>
+    friend struct detail::IntrusiveListAccess;
+
+    detail::ListBasicNode m_node;
+};
+
+namespace detail
+{
+
+/// @brief Internal use only. Converts between objects and a hook member.
+/// @details offsetof does not accept a member pointer, and measuring one
+/// against a made-up address is undefined, so the offset of the hook is
+/// measured on the real objects handed to Hook(). An object can only be
+/// found through its hook after it was linked through Hook(), and whatever
+/// orders the linking before the lookup orders the measurement as well.
+template <typename T, typename THookType, THookType T::*THook>
+struct HookOffset
+{
+    static THookType& Hook(T& value) noexcept
+    {
+        THookType& hook = value.*THook;
+        const size_t offset =
+            static_cast<size_t>(reinterpret_cast<char*>(&hook) -
+                                reinterpret_cast<char*>(&value));
+
+        // only ever stores the one offset, so no shared line is dirtied
+        // once it is known
+        if (s_offset.Load(MemOrderRelaxed) != offset)
+        {
+            s_offset.Store(offset, MemOrderRelaxed);
+        }
+
+        return hook;
+    }
+
+    static T* Owner(THookType* hook) noexcept
+    {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(hook) -
+                                    s_offset.Load(MemOrderRelaxed));
+    }
+
+    static Atomic<size_t> s_offset;
+};
+
+template <typename T, typename THookType, THookType T::*THook>
+Atomic<size_t> HookOffset<T, THookType, THook>::s_offset{ 0 };
+
+// Converts between the objects on a list and the nodes of their hooks.
+template <typename T, IntrusiveListHook T::*THook>
+struct IntrusiveListAccess
+{
+    using OffsetType = HookOffset<T, IntrusiveListHook, THook>;
+
+    static ListBasicNode* Node(T& value) noexcept
+    {
+        return &OffsetType::Hook(value).m_node;
+    }
+
+    static T* Owner(ListBasicNode* node) noexcept
+    {
+        // the node is the only member of the standard layout hook, so they
+        // share an address
+        return OffsetType::Owner(reinterpret_cast<IntrusiveListHook*>(node));
+    }
+};
+
+template <typename T, IntrusiveListHook T::*THook, typename TValue>
+class IntrusiveListIterator
+{
+public:
+
+#if RAD_ENABLE_STD
+    using iterator_category = std::bidirectional_iterator_tag;
+#endif
+
+    using ValueType = TValue;
+    using DifferenceType = ptrdiff_t;
+    using PointerType = TValue*;
+    using ReferenceType = TValue&;
+
+    IntrusiveListIterator() = default;
+
+    explicit IntrusiveListIterator(ListBasicNode* node) noexcept
+        : m_node(node)
+    {
+    }
+
+    /* implicit */ IntrusiveListIterator(
+        const IntrusiveListIterator<T, THook, T>& other) noexcept
+        : m_node(other.m_node)
+    {
+    }
+
+    IntrusiveListIterator& operator=(const IntrusiveListIterator&) = default;
+
+    bool operator==(IntrusiveListIterator rhs) const noexcept
+    {
+        return m_node == rhs.m_node;
+    }
+
+    bool operator!=(IntrusiveListIterator rhs) const noexcept
+    {
+        return m_node != rhs.m_node;
+    }
+
+    ReferenceType operator*() const noexcept
+    {
+        m_node->AssertOnEmpty();
+        return *IntrusiveListAccess<T, THook>::Owner(m_node);
+    }
+
+    PointerType operator->() const noexcept
+    {
+        m_node->AssertOnEmpty();
+        return IntrusiveListAccess<T, THook>::Owner(m_node);
+    }
+
+    IntrusiveListIterator& operator++() noexcept
+    {
+        m_node = m_node->m_next;
+        return *this;
+    }
+
+    IntrusiveListIterator operator++(int) noexcept
+    {
+        IntrusiveListIterator retval(m_node);
+        m_node = m_node->m_next;
+        return retval;
+    }
+
+    IntrusiveListIterator& operator--() noexcept
+    {
+        m_node = m_node->m_prev;
+        return *this;
+    }
+
+    IntrusiveListIterator operator--(int) noexcept
+    {
+        IntrusiveListIterator retval(m_node);
+        m_node = m_node->m_prev;
+        return retval;
+    }
+
+private:
+
+    ListBasicNode* m_node = nullptr;
+
+    template <typename U, IntrusiveListHook U::*, typename>
+    friend class IntrusiveListIterator;
+
+    template <typename U, IntrusiveListHook U::*>
+    friend class ::rad::IntrusiveList;
+};
+
+} // namespace detail
+
+/*!
+    @brief Doubly linked list of caller-owned objects.
+
+    @details The list links objects through an IntrusiveListHook member instead
+    of allocating a node per element, so linking never allocates or fails, and
+    an object knows its own position: IntrusiveListHook::Unlink removes it from
+    the list in O(1) without a search. An object with several hooks can be on
+    several lists at once.
+
+    The list does not own its elements. Destroying or clearing the list
+    unlinks every element, and destroying an element unlinks it from the list.
+    Linking an object whose hook is already linked is erroneous.
+
+    Names and erroneous behaviors follow rad::List. There is no Size(), as
+    keeping a count would make self-unlinking impossible; use ExpensiveSize().
+
+    @code
+    struct Connection
+    {
+        IntrusiveListHook idleHook;
+        IntrusiveListHook timerHook;
+    };
+
+    IntrusiveList<Connection, &Connection::idleHook> idle;
+    @endcode
+
+    @tparam T - Type of the linked objects
+    @tparam THook - Pointer to the hook member of T to link through
+*/
+template <typename T, IntrusiveListHook T::*THook>
+class IntrusiveList
+{
+private:
+
+    using Access = detail::IntrusiveListAccess<T, THook>;
+
+public:
+
+    using ValueType = T;
+    using SizeType = size_t;
+    using IteratorType = detail::IntrusiveListIterator<T, THook, T>;
+    using ConstIteratorType = detail::IntrusiveListIterator<T, THook, const T>;
+
+    ~IntrusiveList()
+    {
+        Clear();
+    }
+
+    IntrusiveList() noexcept = default;
+
+    RAD_NOT_COPYABLE(IntrusiveList);
+
+    /// @brief Takes over the elements of another list, leaving it empty.
+    IntrusiveList(IntrusiveList&& x) noexcept
+    {
+        m_list.Swap(x.m_list);
+    }
+
+    /// @brief Unlinks the elements of this list and takes over the elements
+    /// of another, leaving it empty.
+    IntrusiveList& operator=(IntrusiveList&& x) noexcept
+    {
+        if RAD_LIKELY (this != &x)
+        {
+            Clear();
+            m_list.Swap(x.m_list);
+        }
+
+        return *this;
+    }
+
+    RAD_NODISCARD bool Empty() const noexcept
+    {
+        return m_list.m_head.m_next == &m_list.m_head;
+    }
+
+    // O(N) operation, renamed so that people don't
+    // assume it is cheap.
+    RAD_NODISCARD SizeType ExpensiveSize() const noexcept
+    {
+        return m_list.ExpensiveSize();
+    }
+
+    // Calling Front or Back while the container is empty is erroneous
+    T& Front() noexcept
+    {
+        return *begin();
+    }
+
+    const T& Front() const noexcept
+    {
+        return *begin();
+    }
+
+    T& Back() noexcept
+    {
+        return *--end();
+    }
+
+    const T& Back() const noexcept
+    {
+        return *--end();
+    }
+
+    IntrusiveList& PushFront(T& value) noexcept
+    {
+        Insert(begin(), value);
+        return *this;
+    }
+
+    IntrusiveList& PushBack(T& value) noexcept
+    {
+        Insert(end(), value);
+        return *this;
+    }
+
+    /// @brief Links an object before a position.
+    /// @param position Element to insert before, or end().
+    /// @param value Object to link, which must not already be linked through
+    /// this hook.
+    /// @return Iterator to the linked object.
+    IteratorType Insert(ConstIteratorType position, T& value) noexcept
+    {
+        detail::ListBasicNode* node = Access::Node(value);
+        RAD_ASSERT(!(value.*THook).IsLinked());
+        m_list.AttachNewNode(position.m_node, node);
+        return IteratorType(node);
+    }
+
+    // Calling PopFront or PopBack while the container is empty is erroneous
+    IntrusiveList& PopFront() noexcept
+    {
+        RAD_ASSERT(!Empty());
+        EraseOne(begin());
+        return *this;
+    }
+
+    IntrusiveList& PopBack() noexcept
+    {
+        RAD_ASSERT(!Empty());
+        EraseOne(--end());
+        return *this;
+    }
+
+    /// @brief Unlinks every element.
+    IntrusiveList& Clear() noexcept
+    {
+        EraseSome(begin(), end());
+        return *this;
+    }
+
+    /// @brief Unlinks one element.
+    /// @return Iterator to the element after the unlinked one.
+    IteratorType EraseOne(ConstIteratorType position) noexcept
+    {
+        if (position == cend())
+        {
+            return end();
+        }
+
+        detail::ListBasicNode* next = position.m_node->m_next;
+        (Access::Owner(position.m_node)->*THook).Unlink();
+        return IteratorType(next);
+    }
+
+    /// @brief Unlinks the elements in [position, last).
+    /// @return Iterator to last.
+    IteratorType EraseSome(ConstIteratorType position,
+                           ConstIteratorType last) noexcept
+    {
+        detail::ListBasicNode* cur = position.m_node;
+        detail::ListBasicNode* end = last.m_node;
+        if (cur == end)
+        {
+            return IteratorType(end);
+        }
+
+        cur->CheckSanityBeforeRelinking();
+        end->CheckSanityBeforeRelinking();
+        cur->m_prev->m_next = end;
+        end->m_prev = cur->m_prev;
+
+        while (cur != end)
+        {
+            detail::ListBasicNode* next = cur->m_next;
+            cur->Unlink();
+            cur = next;
+        }
+
+        return IteratorType(end);
+    }
+
+    /// @brief Unlinks the elements matching a predicate.
+    /// @return Number of elements unlinked.
+    template <typename Predicate>
+    SizeType EraseIf(Predicate pred)
+    {
+        SizeType count = 0;
+        IteratorType i = begin();
+        while (i != end())
+        {
+            if (pred(*i))
+            {
+                i = EraseOne(i);
+                ++count;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        return count;
+    }
+
+    /// @brief Gets an iterator to an element of this list in O(1). Behavior is
+    /// undefined if the object is not on this list.
+    IteratorType IteratorTo(T& value) noexcept
+    {
+        RAD_ASSERT((value.*THook).IsLinked());
+        return IteratorType(Access::Node(value));
+    }
+
+    // Self-splicing is erroneous behavior, with a fallback behavior of no-op.
+    IntrusiveList& SpliceAll(ConstIteratorType position,
+                             IntrusiveList& x) noexcept
+    {
+        if (&x == this)
+        {
+            RAD_ASSERT(false); // "You cannot splice a list into itself."
+            return *this;
+        }
+
+        m_list.SpliceSome(position.m_node,
+                          x.m_list.m_head.m_next,
+                          &x.m_list.m_head);
+        return *this;
+    }
+
+    // If `i` doesn't point inside `x`, the behavior is undefined.
+    IntrusiveList& SpliceOne(ConstIteratorType position,
+                             IntrusiveList& x,
+                             ConstIteratorType i) noexcept
+    {
+        RAD_UNUSED(x);
+        m_list.SpliceOne(position.m_node, i.m_node);
+        return *this;
+    }
+
+    IntrusiveList& Swap(IntrusiveList& x) noexcept
+    {
+        m_list.Swap(x.m_list);
+        return *this;
+    }
+
+    IntrusiveList& Reverse() noexcept
+    {
+        m_list.Reverse();
+        return *this;
+    }
+
+    RAD_NODISCARD IteratorType begin() noexcept
+    {
+        return IteratorType(m_list.m_head.m_next);
+    }
+
+    RAD_NODISCARD ConstIteratorType begin() const noexcept
+    {
+        return ConstIteratorType(m_list.m_head.m_next);
+    }
+
+    RAD_NODISCARD IteratorType end() noexcept
+    {
+        return IteratorType(&m_list.m_head);
+    }
+
+    RAD_NODISCARD ConstIteratorType end() const noexcept
+    {
+        return ConstIteratorType(
+            const_cast<detail::ListBasicNode*>(&m_list.m_head));
+    }
+
+    RAD_NODISCARD ConstIteratorType cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    RAD_NODISCARD ConstIteratorType cend() const noexcept
+    {
+        return end();
+    }
+
+private:
+
+    detail::ListUntyped m_list;
+};
+
+} // namespace rad
@@ -0,0 +1,308 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/TypeTraits.h"
+
+#include <stdint.h>
+
+namespace rad
+{
+
+/// @brief Mixin which embeds a reference count in an object for use with
+/// IntrusivePtr.
+/// @details Derive T from RefCounted<T>. The count starts at zero and is
+/// incremented by each IntrusivePtr referring to the object. When the last
+/// reference is released, RefCounted calls `OnRefZero() const noexcept` on T,
+/// which must destroy the object and free its memory with the allocator it was
+/// created from. The hook is resolved statically, so no virtual dispatch is
+/// involved.
+///
+/// Copying an object does not copy its reference count.
+/// @tparam T Type deriving from RefCounted.
+/// @tparam TCounter Counter type, Atomic<uint32_t> by default. Objects confined
+/// to a single thread may use a plain counter with the same interface, such as
+/// detail::LocalCounter<uint32_t>.
+template <typename T, typename TCounter = Atomic<uint32_t>>
+class RefCounted
+{
+public:
+
+    /// @brief Takes an additional reference to the object.
+    void AddRef() const noexcept
+    {
+        m_refCount.FetchAdd(1, MemOrderRelaxed);
+    }
+
+    /// @brief Drops a reference to the object, destroying it when the last
+    /// reference is dropped.
+    void Release() const noexcept
+    {
+        if (m_refCount.FetchSub(1, MemOrderAcqRel) == 1)
+        {
+            const T* self = static_cast<const T*>(this);
+            RAD_S_ASSERT(noexcept(self->OnRefZero()));
+            self->OnRefZero();
+        }
+    }
+
+    /// @brief Current refcount (this is inherently not thread-safe and only
+    /// exposed for testing)
+    uint32_t UseCount() const noexcept
+    {
+        return m_refCount.Load(MemOrderRelaxed);
+    }
+
+protected:
+
+    RefCounted() noexcept
+        : m_refCount(0)
+    {
+    }
+
+    RefCounted(const RefCounted&) noexcept
+        : m_refCount(0)
+    {
+    }
+
+    RefCounted& operator=(const RefCounted&) noexcept
+    {
+        return *this;
+    }
+
+    ~RefCounted() = default;
+
+private:
+
+    mutable TCounter m_refCount;
+};
+
+/// @brief Smart pointer to an object carrying its own reference count.
+/// @details The pointer is a single word. T must provide `AddRef() const` and
+/// `Release() const`, both noexcept, as RefCounted does.
+/// @tparam T Value type to point to
+template <typename T>
+class IntrusivePtr final
+{
+public:
+
+    using ValueType = T;
+    static constexpr bool IsTriviallyRelocatable = true;
+
+    ~IntrusivePtr()
+    {
+        Reset();
+    }
+
+    /// @brief Construct empty IntrusivePtr (nullptr)
+    constexpr IntrusivePtr() noexcept
+        : m_ptr()
+    {
+    }
+
+    /// @brief Construct empty IntrusivePtr (nullptr)
+    constexpr IntrusivePtr(rad::nullptr_t) noexcept
+        : m_ptr()
+    {
+    }
+
+    /// @brief Construct an IntrusivePtr taking a reference to an object.
+    /// @param ptr Object to refer to, may be nullptr.
+    explicit IntrusivePtr(T* ptr) noexcept
+        : m_ptr(ptr)
+    {
+        RAD_S_ASSERT(noexcept(m_ptr->AddRef()));
+
+        if (m_ptr)
+        {
+            m_ptr->AddRef();
+        }
+    }
+
+    /// @brief Construct a new IntrusivePtr taking an additional reference to
+    /// an existing pointer.
+    /// @param r Existing pointer
+    IntrusivePtr(const IntrusivePtr& r) noexcept
+        : IntrusivePtr(r.m_ptr)
+    {
+    }
+
+    /// @brief Construct a new IntrusivePtr by moving an existing IntrusivePtr.
+    /// @param r Existing pointer
+    IntrusivePtr(IntrusivePtr&& r) noexcept
+        : m_ptr(r.m_ptr)
+    {
+        r.m_ptr = nullptr;
+    }
+
+    /// @brief Construct a new IntrusivePtr from a convertible pointer.
+    /// @param r Existing pointer
+    template <typename U, EnIf<IsConv<U*, T*>, int> = 0>
+    IntrusivePtr(const IntrusivePtr<U>& r) noexcept
+        : IntrusivePtr(r.Get())
+    {
+    }
+
+    /// @brief Construct a new IntrusivePtr by moving a convertible pointer.
+    /// @param r Existing pointer
+    template <typename U, EnIf<IsConv<U*, T*>, int> = 0>
+    IntrusivePtr(IntrusivePtr<U>&& r) noexcept
+        : m_ptr(r.Detach())
+    {
+    }
+
+    /// @brief Take an additional reference to an existing pointer. Drops
+    /// reference to its current stored pointer if not nullptr.
+    IntrusivePtr& operator=(const IntrusivePtr& r) noexcept
+    {
+        IntrusivePtr(r).Swap(*this);
+        return *this;
+    }
+
+    /// @brief Take ownership of an existing pointer by move semantics. Drops
+    /// reference to its current stored pointer if not nullptr.
+    IntrusivePtr& operator=(IntrusivePtr&& r) noexcept
+    {
+        IntrusivePtr(Move(r)).Swap(*this);
+        return *this;
+    }
+
+    /// @brief Take additional reference to an existing, convertible pointer.
+    /// Drops reference to its current stored pointer if not nullptr.
+    template <typename U, EnIf<IsConv<U*, T*>, int> = 0>
+    IntrusivePtr& operator=(const IntrusivePtr<U>& r) noexcept
+    {
+        IntrusivePtr(r).Swap(*this);
+        return *this;
+    }
+
+    /// @brief bool operator returning true if the pointer is not nullptr.
+    operator bool() const noexcept
+    {
+        return m_ptr != nullptr;
+    }
+
+    /// @brief Check if the pointer is not nullptr
+    bool operator!=(rad::nullptr_t) const noexcept
+    {
+        return m_ptr != nullptr;
+    }
+
+    /// @brief Check if the pointer is nullptr
+    bool operator==(rad::nullptr_t) const noexcept
+    {
+        return m_ptr == nullptr;
+    }
+
+    /// @brief Retrieve a pointer to the stored object
+    T* Get() const noexcept
+    {
+        return m_ptr;
+    }
+
+    /// @brief Dereference the pointer
+    T& operator*() const noexcept
+    {
+        RAD_ASSERT(m_ptr != nullptr);
+        return *m_ptr;
+    }
+
+    /// @brief Dereference the pointer
+    T* operator->() const noexcept
+    {
+        RAD_ASSERT(m_ptr != nullptr);
+        return m_ptr;
+    }
+
+    /// @brief Drop existing reference if a reference is held.
+    void Reset() noexcept
+    {
+        RAD_S_ASSERT(noexcept(m_ptr->Release()));
+
+        if (m_ptr)
+        {
+            T* ptr = m_ptr;
+            m_ptr = nullptr;
+            ptr->Release();
+        }
+    }
+
+    /// @brief Replace the stored pointer, taking a reference to the new object
+    /// and dropping the reference to the old one.
+    /// @param ptr Object to refer to, may be nullptr.
+    void Reset(T* ptr) noexcept
+    {
+        IntrusivePtr(ptr).Swap(*this);
+    }
+
+    /// @brief Give up ownership of the stored reference without dropping it.
+    /// @return The stored pointer, which the caller must eventually release.
+    RAD_NODISCARD T* Detach() noexcept
+    {
+        T* ptr = m_ptr;
+        m_ptr = nullptr;
+        return ptr;
+    }
+
+    /// @brief Swaps the managed objects.
+    /// @param o Other intrusive ptr to swap with this.
+    void Swap(IntrusivePtr& o) noexcept
+    {
+        T* ptr = m_ptr;
+        m_ptr = o.m_ptr;
+        o.m_ptr = ptr;
+    }
+
+private:
+
+    T* m_ptr;
+};
+
+template <typename T>
+RAD_NODISCARD bool operator==(rad::nullptr_t, const IntrusivePtr<T>& p) noexcept
+{
+    return p.Get() == nullptr;
+}
+
+template <typename T>
+RAD_NODISCARD bool operator!=(rad::nullptr_t, const IntrusivePtr<T>& p) noexcept
+{
+    return p.Get() != nullptr;
+}
+
+template <typename T, typename U>
+RAD_NODISCARD bool operator==(const IntrusivePtr<T>& l,
+                              const IntrusivePtr<U>& r) noexcept
+{
+    return l.Get() == r.Get();
+}
+
+template <typename T, typename U>
+RAD_NODISCARD bool operator!=(const IntrusivePtr<T>& l,
+                              const IntrusivePtr<U>& r) noexcept
+{
+    return l.Get() != r.Get();
+}
+
+template <typename T, typename U>
+RAD_NODISCARD bool operator<(const IntrusivePtr<T>& l,
+                             const IntrusivePtr<U>& r) noexcept
+{
+    return l.Get() < r.Get();
+}
+
+} // namespace rad
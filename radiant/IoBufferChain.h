@@ -0,0 +1,738 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/Byte.h"
+#include "radiant/Deque.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/Span.h"
+#include "radiant/Utility.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if !RAD_WINDOWS
+#include <sys/uio.h>
+#endif
+
+namespace rad
+{
+
+#if RAD_WINDOWS
+/// @brief Scatter-gather entry, laid out like WSABUF so an array of them can
+/// be passed to WSASend and WSARecv. Declared here rather than taken from
+/// WinSock2.h, which must be included before Windows.h.
+struct IoVec
+{
+    unsigned long len;
+    char* buf;
+};
+#else
+/// @brief Scatter-gather entry for writev and readv.
+using IoVec = iovec;
+#endif
+
+namespace detail
+{
+
+inline void IoVecAssign(IoVec& vec, Byte* data, size_t size) noexcept
+{
+#if RAD_WINDOWS
+    vec.len = static_cast<unsigned long>(size);
+    vec.buf = reinterpret_cast<char*>(data);
+#else
+    vec.iov_base = data;
+    vec.iov_len = size;
+#endif
+}
+
+/// @brief Internal use only. Reference-counted block of bytes shared by the
+/// slices of one or more IoBufferChains. The bytes follow the header.
+struct IoSegment
+{
+    Atomic<uint32_t> refs;
+
+    explicit IoSegment(uint32_t count) noexcept
+        : refs(count)
+    {
+    }
+
+    Byte* Data() noexcept
+    {
+        return reinterpret_cast<Byte*>(this + 1);
+    }
+};
+
+/// @brief Internal use only. Range of bytes within a segment.
+struct IoSlice
+{
+    IoSegment* segment;
+    uint32_t begin;
+    uint32_t end;
+
+    uint32_t Size() const noexcept
+    {
+        return end - begin;
+    }
+};
+
+/// @brief Internal use only. Slices per chunk of a chain's slice deque; a
+/// frame is usually a few slices, so a chunk is kept small.
+static constexpr size_t IoSliceChunkSize = 16;
+
+} // namespace detail
+
+/// @brief Sequence of bytes held in a chain of fixed-size, reference-counted
+/// segments, for building and parsing network frames without copying
+/// payloads around.
+/// @details Bytes can be added at either end and removed from the front. A
+/// chain can share its segments with another, either whole or as a slice of
+/// any range, without copying; shared segments are freed when the last slice
+/// of them is dropped. Bytes are only copied in place into a segment that no
+/// other slice refers to, so the bytes visible through a shared slice never
+/// change. The data is handed to writev or WSASend as an array of IoVec,
+/// and space for readv or WSARecv is reserved the same way.
+///
+/// Segments are not copied when the chain is, so a chain may be moved to
+/// and dropped on another thread while others share its segments. Each
+/// chain itself is not thread safe.
+/// @tparam TAllocator Allocator for the segments and the slice list.
+/// @tparam TSegmentSize Number of bytes in each segment.
+template <typename TAllocator, uint32_t TSegmentSize = 4096>
+class IoBufferChain final
+{
+private:
+
+    using AllocatorTraits = AllocTraits<TAllocator>;
+    using SegmentSlice = detail::IoSlice;
+    using SliceList =
+        Deque<SegmentSlice, TAllocator, detail::IoSliceChunkSize>;
+
+    RAD_S_ASSERTMSG(TSegmentSize > 0, "TSegmentSize must not be zero");
+
+public:
+
+    using ThisType = IoBufferChain<TAllocator, TSegmentSize>;
+    using AllocatorType = TAllocator;
+    using SizeType = size_t;
+    static constexpr uint32_t SegmentSize = TSegmentSize;
+
+    RAD_NOT_COPYABLE(IoBufferChain);
+
+    ~IoBufferChain()
+    {
+        Clear();
+    }
+
+    /// @brief Constructs an empty chain with a default-constructed allocator.
+    IoBufferChain() noexcept = default;
+
+    /// @brief Constructs an empty chain with a copy-constructed allocator.
+    /// @param alloc Allocator to copy.
+    explicit IoBufferChain(const AllocatorType& alloc) noexcept
+        : m_storage(alloc, alloc)
+    {
+    }
+
+    /// @brief Move constructs a chain from another, leaving it empty.
+    IoBufferChain(ThisType&& other) noexcept
+        : m_storage(other.m_storage.First(), other.m_storage.First())
+    {
+        TakeFrom(other);
+    }
+
+    /// @brief Move assigns a chain from another, leaving it empty.
+    ThisType& operator=(ThisType&& other) noexcept
+    {
+        if RAD_LIKELY (this != &other)
+        {
+            Clear();
+            RAD_ASSERT(AllocatorTraits::Equal(m_storage.First(),
+                                              other.m_storage.First()));
+            TakeFrom(other);
+        }
+
+        return *this;
+    }
+
+    /// @brief Number of bytes in the chain.
+    SizeType Size() const noexcept
+    {
+        return Store().size;
+    }
+
+    /// @brief Checks whether the chain holds no bytes.
+    bool Empty() const noexcept
+    {
+        return Store().size == 0;
+    }
+
+    /// @brief Number of contiguous pieces the bytes are held in.
+    SizeType SliceCount() const noexcept
+    {
+        return Store().slices.Size() - Store().reserved;
+    }
+
+    /// @brief One contiguous piece of the bytes.
+    /// @param index Index of the piece, less than SliceCount().
+    Span<const Byte> SliceAt(SizeType index) const noexcept
+    {
+        RAD_ASSERT(index < SliceCount());
+        const SegmentSlice& slice = Store().slices[index];
+        return Span<const Byte>(slice.segment->Data() + slice.begin,
+                                slice.Size());
+    }
+
+    /// @brief Copies bytes onto the back of the chain.
+    /// @details Fills the free space of the last segment first, if no other
+    /// slice shares it, then appends new segments. On failure the chain is
+    /// left as it was.
+    Err Append(Span<const Byte> data) noexcept
+    {
+        DropReserved();
+        const SizeType oldSize = Size();
+        const Byte* src = data.Data();
+        SizeType count = data.Size();
+
+        if (count != 0 && SliceCount() != 0)
+        {
+            SegmentSlice& last = Store().slices.Back();
+            if (IsUnique(last.segment) && last.end < TSegmentSize)
+            {
+                const uint32_t take = Clamp(count, TSegmentSize - last.end);
+                memcpy(last.segment->Data() + last.end, src, take);
+                last.end += take;
+                Store().size += take;
+                src += take;
+                count -= take;
+            }
+        }
+
+        while (count != 0)
+        {
+            detail::IoSegment* segment = NewSegment();
+            const uint32_t take = Clamp(count, TSegmentSize);
+            if (segment == nullptr ||
+                Store()
+                    .slices.PushBack(SegmentSlice{ segment, 0, take })
+                    .IsErr())
+            {
+                Release(segment);
+                Truncate(oldSize);
+                return Error::NoMemory;
+            }
+
+            memcpy(segment->Data(), src, take);
+            Store().size += take;
+            src += take;
+            count -= take;
+        }
+
+        return NoError;
+    }
+
+    /// @brief Copies bytes onto the front of the chain, such as a header in
+    /// front of a payload.
+    /// @details Fills the headroom of the first segment first, if no other
+    /// slice shares it. New segments are filled from their end, which leaves
+    /// headroom for further prepends. On failure the chain is left as it
+    /// was.
+    Err Prepend(Span<const Byte> data) noexcept
+    {
+        DropReserved();
+        const Byte* const src = data.Data();
+        SizeType count = data.Size();
+        SizeType added = 0;
+
+        if (count != 0 && SliceCount() != 0)
+        {
+            SegmentSlice& first = Store().slices.Front();
+            if (IsUnique(first.segment) && first.begin > 0)
+            {
+                const uint32_t take = Clamp(count, first.begin);
+                first.begin -= take;
+                memcpy(first.segment->Data() + first.begin,
+                       src + (count - take),
+                       take);
+                Store().size += take;
+                added += take;
+                count -= take;
+            }
+        }
+
+        while (count != 0)
+        {
+            detail::IoSegment* segment = NewSegment();
+            const uint32_t take = Clamp(count, TSegmentSize);
+            const uint32_t begin = TSegmentSize - take;
+            if (segment == nullptr ||
+                Store()
+                    .slices
+                    .PushFront(SegmentSlice{ segment, begin, TSegmentSize })
+                    .IsErr())
+            {
+                Release(segment);
+                Consume(added);
+                return Error::NoMemory;
+            }
+
+            memcpy(segment->Data() + begin, src + (count - take), take);
+            Store().size += take;
+            added += take;
+            count -= take;
+        }
+
+        return NoError;
+    }
+
+    /// @brief Moves every byte of another chain onto the back of this one,
+    /// without copying. The other chain is left empty. On failure both
+    /// chains are left as they were.
+    /// @param other Chain to take from, with an equal allocator.
+    Err Append(ThisType&& other) noexcept
+    {
+        RAD_ASSERT(this != &other);
+        RAD_ASSERT(AllocatorTraits::Equal(m_storage.First(),
+                                          other.m_storage.First()));
+        DropReserved();
+        other.DropReserved();
+
+        SliceList& mine = Store().slices;
+        SliceList& theirs = other.Store().slices;
+        if (mine.Empty())
+        {
+            mine.Swap(theirs);
+        }
+        else
+        {
+            for (SizeType i = 0; i < theirs.Size(); ++i)
+            {
+                if (mine.PushBack(theirs[i]).IsErr())
+                {
+                    // the slices pushed so far still belong to other
+                    for (; i > 0; --i)
+                    {
+                        mine.PopBack();
+                    }
+
+                    return Error::NoMemory;
+                }
+            }
+
+            theirs.Clear();
+        }
+
+        Store().size += other.Store().size;
+        other.Store().size = 0;
+        return NoError;
+    }
+
+    /// @brief Shares every byte of another chain onto the back of this one,
+    /// without copying. On failure the chain is left as it was.
+    /// @param other Chain to share, with an equal allocator.
+    Err AppendShared(const ThisType& other) noexcept
+    {
+        RAD_ASSERT(this != &other);
+        RAD_ASSERT(AllocatorTraits::Equal(m_storage.First(),
+                                          other.m_storage.First()));
+        DropReserved();
+        const SizeType oldSize = Size();
+        for (SizeType i = 0; i < other.SliceCount(); ++i)
+        {
+            if (PushShared(other.Store().slices[i]).IsErr())
+            {
+                Truncate(oldSize);
+                return Error::NoMemory;
+            }
+        }
+
+        return NoError;
+    }
+
+    /// @brief Creates a chain sharing a range of this one's bytes, without
+    /// copying.
+    /// @details Fails with Error::OutOfRange if the range does not lie within
+    /// the chain.
+    /// @param offset Offset of the first byte of the range.
+    /// @param count Number of bytes in the range.
+    Res<ThisType> Slice(SizeType offset, SizeType count) const noexcept
+    {
+        if (offset > Size() || count > Size() - offset)
+        {
+            return Error::OutOfRange;
+        }
+
+        ThisType result(m_storage.First());
+        for (SizeType i = 0; i < SliceCount() && count != 0; ++i)
+        {
+            SegmentSlice slice = Store().slices[i];
+            if (offset >= slice.Size())
+            {
+                offset -= slice.Size();
+                continue;
+            }
+
+            slice.begin += static_cast<uint32_t>(offset);
+            offset = 0;
+            slice.end = slice.begin + Clamp(count, slice.Size());
+            count -= slice.Size();
+            if (result.PushShared(slice).IsErr())
+            {
+                return Error::NoMemory;
+            }
+        }
+
+        return result;
+    }
+
+    /// @brief Removes bytes from the front of the chain, such as those a
+    /// writev call reported as sent.
+    /// @param count Number of bytes to remove, at most Size().
+    void Consume(SizeType count) noexcept
+    {
+        RAD_ASSERT(count <= Size());
+        DropReserved();
+        SliceList& slices = Store().slices;
+        Store().size -= count;
+        while (count != 0)
+        {
+            SegmentSlice& first = slices.Front();
+            if (count < first.Size())
+            {
+                first.begin += static_cast<uint32_t>(count);
+                return;
+            }
+
+            count -= first.Size();
+            Release(first.segment);
+            slices.PopFront();
+        }
+    }
+
+    /// @brief Removes bytes from the back of the chain.
+    /// @param size Number of bytes to keep, at most Size().
+    void Truncate(SizeType size) noexcept
+    {
+        RAD_ASSERT(size <= Size());
+        DropReserved();
+        SliceList& slices = Store().slices;
+        SizeType count = Size() - size;
+        Store().size = size;
+        while (count != 0)
+        {
+            SegmentSlice& last = slices.Back();
+            if (count < last.Size())
+            {
+                last.end -= static_cast<uint32_t>(count);
+                return;
+            }
+
+            count -= last.Size();
+            Release(last.segment);
+            slices.PopBack();
+        }
+    }
+
+    /// @brief Removes every byte, releasing the segments.
+    void Clear() noexcept
+    {
+        SliceList& slices = Store().slices;
+        for (SizeType i = 0; i < slices.Size(); ++i)
+        {
+            Release(slices[i].segment);
+        }
+
+        slices.Clear();
+        Store().size = 0;
+        Store().reserved = 0;
+        Store().reservedTail = 0;
+    }
+
+    /// @brief Copies bytes out of the chain.
+    /// @param out Destination.
+    /// @param offset Offset of the first byte to copy, at most Size().
+    /// @return Number of bytes copied, the smaller of the size of @p out and
+    /// the number of bytes after @p offset.
+    SizeType CopyTo(Span<Byte> out, SizeType offset = 0) const noexcept
+    {
+        RAD_ASSERT(offset <= Size());
+        SizeType copied = 0;
+        for (SizeType i = 0; i < SliceCount() && copied < out.Size(); ++i)
+        {
+            const Span<const Byte> piece = SliceAt(i);
+            if (offset >= piece.Size())
+            {
+                offset -= piece.Size();
+                continue;
+            }
+
+            const SizeType take =
+                Min<SizeType>(piece.Size() - offset, out.Size() - copied);
+            memcpy(out.Data() + copied, piece.Data() + offset, take);
+            copied += take;
+            offset = 0;
+        }
+
+        return copied;
+    }
+
+    /// @brief Describes the chain's bytes for a gathering write.
+    /// @details Fills as many entries as there are slices or room in @p out.
+    /// After a partial write, Consume() the bytes written and export again.
+    /// @param out Entries to fill.
+    /// @return Number of entries filled.
+    SpanSizeType ExportIo(Span<IoVec> out) const noexcept
+    {
+        SpanSizeType count = 0;
+        for (; count < out.Size() && count < SliceCount(); ++count)
+        {
+            const SegmentSlice& slice = Store().slices[count];
+            detail::IoVecAssign(out[count],
+                                slice.segment->Data() + slice.begin,
+                                slice.Size());
+        }
+
+        return count;
+    }
+
+    /// @brief Reserves space at the back of the chain and describes it for a
+    /// scattering read.
+    /// @details The space starts in the free tail of the last segment, if no
+    /// other slice shares it, and continues in new segments. Call Commit()
+    /// with the number of bytes read to add them to the chain. Any other
+    /// change to the chain drops the reservation. Fails with
+    /// Error::OutOfRange, reserving nothing, if @p out has too few entries to
+    /// describe the space.
+    /// @param count Number of bytes of space to reserve.
+    /// @param out Entries to fill.
+    /// @return Number of entries filled.
+    Res<SpanSizeType> ReserveIo(SizeType count, Span<IoVec> out) noexcept
+    {
+        DropReserved();
+        const uint32_t tail = TailSpace();
+        const SizeType rest = count > tail ? count - tail : 0;
+        const SizeType segments = (rest + TSegmentSize - 1) / TSegmentSize;
+        const SizeType entries = (tail != 0 && count != 0 ? 1 : 0) + segments;
+        if (entries > out.Size())
+        {
+            return Error::OutOfRange;
+        }
+
+        for (SizeType i = 0; i < segments; ++i)
+        {
+            detail::IoSegment* segment = NewSegment();
+            if (segment == nullptr ||
+                Store().slices.PushBack(SegmentSlice{ segment, 0, 0 }).IsErr())
+            {
+                Release(segment);
+                DropReserved();
+                return Error::NoMemory;
+            }
+
+            ++Store().reserved;
+        }
+
+        SpanSizeType filled = 0;
+        if (tail != 0 && count != 0)
+        {
+            const SegmentSlice& last = Store().slices[SliceCount() - 1];
+            Store().reservedTail = Clamp(count, tail);
+            detail::IoVecAssign(out[filled++],
+                                last.segment->Data() + last.end,
+                                Store().reservedTail);
+        }
+
+        SizeType remaining = rest;
+        for (SizeType i = SliceCount(); i < Store().slices.Size(); ++i)
+        {
+            const SizeType take = Min<SizeType>(remaining, TSegmentSize);
+            detail::IoVecAssign(out[filled++],
+                                Store().slices[i].segment->Data(),
+                                take);
+            remaining -= take;
+        }
+
+        return filled;
+    }
+
+    /// @brief Adds bytes read into reserved space to the chain, and releases
+    /// what was not used.
+    /// @details The reserved tail of the last segment is still used if a
+    /// Slice() shared the segment since, as that slice ends before the tail.
+    /// @param count Number of bytes read, at most the space reserved.
+    void Commit(SizeType count) noexcept
+    {
+        SliceList& slices = Store().slices;
+        Store().size += count;
+        if (count != 0 && Store().reservedTail != 0)
+        {
+            const uint32_t take = Clamp(count, Store().reservedTail);
+            slices[SliceCount() - 1].end += take;
+            count -= take;
+        }
+
+        while (count != 0)
+        {
+            RAD_ASSERT(Store().reserved != 0);
+            SegmentSlice& next = slices[SliceCount()];
+            next.end = Clamp(count, TSegmentSize);
+            count -= next.end;
+            --Store().reserved;
+        }
+
+        DropReserved();
+    }
+
+    /// @brief Swaps the contents of two chains with equal allocators.
+    ThisType& Swap(ThisType& other) noexcept
+    {
+        RAD_ASSERT(AllocatorTraits::Equal(m_storage.First(),
+                                          other.m_storage.First()));
+        Store().slices.Swap(other.Store().slices);
+        rad::Swap(Store().size, other.Store().size);
+        rad::Swap(Store().reserved, other.Store().reserved);
+        rad::Swap(Store().reservedTail, other.Store().reservedTail);
+        return *this;
+    }
+
+    /// @brief Gets a copy of the allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_storage.First();
+    }
+
+private:
+
+    struct Storage
+    {
+        explicit Storage(const TAllocator& alloc) noexcept
+            : slices(alloc)
+        {
+        }
+
+        Storage() noexcept = default;
+
+        SliceList slices;
+        SizeType size = 0;
+
+        // number of empty slices at the back holding space from ReserveIo
+        SizeType reserved = 0;
+
+        // number of bytes after the last slice handed out by ReserveIo
+        uint32_t reservedTail = 0;
+    };
+
+    static uint32_t Clamp(SizeType count, uint32_t limit) noexcept
+    {
+        return count < limit ? static_cast<uint32_t>(count) : limit;
+    }
+
+    static bool IsUnique(const detail::IoSegment* segment) noexcept
+    {
+        return segment->refs.Load(MemOrderAcquire) == 1;
+    }
+
+    Storage& Store() noexcept
+    {
+        return m_storage.Second();
+    }
+
+    const Storage& Store() const noexcept
+    {
+        return m_storage.Second();
+    }
+
+    void TakeFrom(ThisType& other) noexcept
+    {
+        Store().slices.Swap(other.Store().slices);
+        Store().size = other.Store().size;
+        Store().reserved = other.Store().reserved;
+        Store().reservedTail = other.Store().reservedTail;
+        other.Store().size = 0;
+        other.Store().reserved = 0;
+        other.Store().reservedTail = 0;
+    }
+
+    // free bytes after the last slice which may be written in place
+    uint32_t TailSpace() const noexcept
+    {
+        if (SliceCount() == 0)
+        {
+            return 0;
+        }
+
+        const SegmentSlice& last = Store().slices[SliceCount() - 1];
+        return IsUnique(last.segment) ? TSegmentSize - last.end : 0;
+    }
+
+    detail::IoSegment* NewSegment() noexcept
+    {
+        void* mem = AllocatorTraits::AllocBytes(m_storage.First(),
+                                                sizeof(detail::IoSegment) +
+                                                    TSegmentSize);
+        if (mem == nullptr)
+        {
+            return nullptr;
+        }
+
+        return ::new (mem) detail::IoSegment(1);
+    }
+
+    void Release(detail::IoSegment* segment) noexcept
+    {
+        if (segment != nullptr &&
+            segment->refs.FetchSub(1, MemOrderAcqRel) == 1)
+        {
+            segment->~IoSegment();
+            AllocatorTraits::FreeBytes(m_storage.First(),
+                                       segment,
+                                       sizeof(detail::IoSegment) +
+                                           TSegmentSize);
+        }
+    }
+
+    Err PushShared(const SegmentSlice& slice) noexcept
+    {
+        slice.segment->refs.FetchAdd(1, MemOrderRelaxed);
+        if (Store().slices.PushBack(slice).IsErr())
+        {
+            Release(slice.segment);
+            return Error::NoMemory;
+        }
+
+        Store().size += slice.Size();
+        return NoError;
+    }
+
+    void DropReserved() noexcept
+    {
+        Store().reservedTail = 0;
+        for (; Store().reserved != 0; --Store().reserved)
+        {
+            Release(Store().slices.Back().segment);
+            Store().slices.PopBack();
+        }
+    }
+
+    EmptyOptimizedPair<TAllocator, Storage> m_storage;
+};
+
+} // namespace rad
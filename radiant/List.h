@@ -20,6 +20,7 @@
 #include "radiant/EmptyOptimizedPair.h"
 #include "radiant/Iterator.h"
 #include "radiant/Memory.h"
+#include "radiant/NodePool.h"
 #include "radiant/Res.h"
 #include "radiant/detail/ListOperations.h"
 
@@ -782,4 +783,16 @@ private:
     EmptyOptimizedPair<TAllocator, ::rad::detail::ListUntyped> m_storage;
 };
 
+/// @brief NodePool whose chunks hold the nodes of a List<T>.
+template <typename T, typename TAllocator, size_t TNodesPerSlab = 64>
+using ListNodePool =
+    NodePool<TAllocator, sizeof(::rad::detail::ListNode<T>), TNodesPerSlab>;
+
+/// @brief Allocator for a List<T> which draws its nodes from a ListNodePool.
+template <typename T, typename TAllocator, size_t TNodesPerSlab = 64>
+using ListNodePoolAllocator =
+    NodePoolAllocator<TAllocator,
+                      sizeof(::rad::detail::ListNode<T>),
+                      TNodesPerSlab>;
+
 } // namespace rad
@@ -0,0 +1,452 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Byte.h"
+#include "radiant/Res.h"
+#include "radiant/Span.h"
+#include "radiant/UniqueResource.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if RAD_USER_MODE
+
+#if RAD_WINDOWS
+#include <Windows.h> // NOLINT(misc-include-cleaner)
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rad
+{
+
+/// @brief How the pages of a MappedFile may be used.
+enum class MapMode
+{
+    /// Pages are read-only and shared with every other mapping of the file.
+    ReadOnly,
+
+    /// Pages are writable. The first write to a page gives this mapping a
+    /// private copy of it, and nothing is ever written back to the file.
+    CopyOnWrite,
+};
+
+/// @brief Expected access pattern for a MappedFile, passed to Advise().
+enum class MapAdvice
+{
+    /// No particular pattern.
+    Normal,
+
+    /// Pages will be read in order, so read ahead aggressively.
+    Sequential,
+
+    /// Pages will be read in no particular order, so do not read ahead.
+    Random,
+
+    /// Pages will be needed soon, so start reading them in now.
+    WillNeed,
+
+    /// Pages will not be needed again soon, so they may be dropped. In a
+    /// copy-on-write mapping this also discards any changes to them.
+    DontNeed,
+};
+
+namespace detail
+{
+
+/// @brief Internal use only. Address and length of a mapped view.
+struct MappedRegion
+{
+    void* data;
+    size_t size;
+};
+
+/// @brief Internal use only. UniqueResource policy unmapping a view.
+struct MappedRegionPolicy
+{
+    using ValueType = MappedRegion;
+    static constexpr MappedRegion InvalidValue = { nullptr, 0 };
+
+    static constexpr bool IsValid(const MappedRegion& value) noexcept
+    {
+        return value.data != nullptr;
+    }
+
+    static void Close(MappedRegion& value) noexcept
+    {
+#if RAD_WINDOWS
+        UnmapViewOfFile(value.data);
+#else
+        munmap(value.data, value.size);
+#endif
+    }
+};
+
+#if RAD_WINDOWS
+
+/// @brief Internal use only. UniqueResource policy closing a file or file
+/// mapping handle, either of which may have failed to open with its own
+/// invalid value.
+struct MappedHandlePolicy
+{
+    using ValueType = HANDLE;
+    static constexpr HANDLE InvalidValue = nullptr;
+
+    static bool IsValid(const HANDLE& value) noexcept
+    {
+        return value != nullptr && value != INVALID_HANDLE_VALUE;
+    }
+
+    static void Close(HANDLE& value) noexcept
+    {
+        CloseHandle(value);
+    }
+};
+
+using MappedHandle = UniqueResource<MappedHandlePolicy>;
+
+#else
+
+/// @brief Internal use only. Closes a file descriptor.
+struct MappedFdCloser
+{
+    static void Close(int fd) noexcept
+    {
+        close(fd);
+    }
+};
+
+using MappedFd = UniqueResourceDef<int, MappedFdCloser, -1>;
+
+#endif
+
+} // namespace detail
+
+/// @brief Read-only view of a whole file mapped into memory.
+/// @details The file's pages are loaded on first touch rather than read up
+/// front, so a large file opens in constant time, and the operating system
+/// shares clean pages between every process mapping the same file. The
+/// file itself is closed once mapped; the view stays valid until the
+/// MappedFile is closed or destroyed, and must not outlive it.
+///
+/// Spans are limited to 32-bit sizes. Data() covers files up to that size
+/// and View() reaches any window of a larger one.
+class MappedFile final
+{
+public:
+
+    RAD_NOT_COPYABLE(MappedFile);
+
+    /// @brief Constructs an object mapping nothing.
+    MappedFile() noexcept = default;
+
+    MappedFile(MappedFile&&) noexcept = default;
+    MappedFile& operator=(MappedFile&&) noexcept = default;
+
+    /// @brief Maps an entire file.
+    /// @details An empty file opens successfully and has empty data. Fails
+    /// with Error::InvalidAddress if the file cannot be opened, with
+    /// Error::IntegerOverflow if it is too large for the address space, and
+    /// with Error::NoMemory or Error::Unsuccessful if it cannot be mapped.
+    /// @param path Path of the file to map.
+    /// @param mode Whether the pages are read-only or copy-on-write.
+    static Res<MappedFile> Open(const char* path,
+                                MapMode mode = MapMode::ReadOnly) noexcept
+    {
+#if RAD_WINDOWS
+        detail::MappedHandle file(CreateFileA(path,
+                                              GENERIC_READ,
+                                              FILE_SHARE_READ,
+                                              nullptr,
+                                              OPEN_EXISTING,
+                                              FILE_ATTRIBUTE_NORMAL,
+                                              nullptr));
+        return Map(file, mode);
+#else
+        detail::MappedFd fd(open(path, O_RDONLY | O_CLOEXEC));
+        if (!fd.IsValid())
+        {
+            return Error::InvalidAddress;
+        }
+
+        struct stat info;
+        if (fstat(fd.Get(), &info) != 0)
+        {
+            return Error::Unsuccessful;
+        }
+
+        if (static_cast<uint64_t>(info.st_size) > SIZE_MAX)
+        {
+            return Error::IntegerOverflow;
+        }
+
+        MappedFile mapped;
+        mapped.m_mode = mode;
+        const size_t size = static_cast<size_t>(info.st_size);
+        if (size == 0)
+        {
+            return mapped;
+        }
+
+        const int prot =
+            mode == MapMode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+        const int flags = mode == MapMode::ReadOnly ? MAP_SHARED : MAP_PRIVATE;
+        void* data = mmap(nullptr, size, prot, flags, fd.Get(), 0);
+        if (data == MAP_FAILED)
+        {
+            return errno == ENOMEM ? Error::NoMemory : Error::Unsuccessful;
+        }
+
+        mapped.m_region.Reset({ data, size });
+        return mapped;
+#endif
+    }
+
+#if RAD_WINDOWS
+    /// @copydoc Open(const char*, MapMode)
+    static Res<MappedFile> Open(const wchar_t* path,
+                                MapMode mode = MapMode::ReadOnly) noexcept
+    {
+        detail::MappedHandle file(CreateFileW(path,
+                                              GENERIC_READ,
+                                              FILE_SHARE_READ,
+                                              nullptr,
+                                              OPEN_EXISTING,
+                                              FILE_ATTRIBUTE_NORMAL,
+                                              nullptr));
+        return Map(file, mode);
+    }
+#endif
+
+    /// @brief Checks whether a non-empty file is mapped.
+    bool IsMapped() const noexcept
+    {
+        return m_region.IsValid();
+    }
+
+    /// @brief Size of the mapped file in bytes.
+    size_t Size() const noexcept
+    {
+        return m_region.Get().size;
+    }
+
+    /// @brief Mode the file was mapped with.
+    MapMode Mode() const noexcept
+    {
+        return m_mode;
+    }
+
+    /// @brief Address of the first byte of the file, or null if nothing is
+    /// mapped.
+    const Byte* Bytes() const noexcept
+    {
+        return static_cast<const Byte*>(m_region.Get().data);
+    }
+
+    /// @brief The whole file.
+    /// @details The file must be smaller than the largest Span. Use View()
+    /// for larger files.
+    Span<const Byte> Data() const noexcept
+    {
+        RAD_ASSERT(Size() < DynamicExtent);
+        return Span<const Byte>(Bytes(), static_cast<SpanSizeType>(Size()));
+    }
+
+    /// @brief The whole file, for writing into a copy-on-write mapping.
+    /// @see Data()
+    Span<Byte> WritableData() noexcept
+    {
+        RAD_ASSERT(m_mode == MapMode::CopyOnWrite);
+        RAD_ASSERT(Size() < DynamicExtent);
+        return Span<Byte>(static_cast<Byte*>(m_region.Get().data),
+                          static_cast<SpanSizeType>(Size()));
+    }
+
+    /// @brief A window of the file.
+    /// @details Fails with Error::OutOfRange if the window does not lie
+    /// within the file.
+    /// @param offset Offset of the first byte of the window.
+    /// @param count Number of bytes in the window.
+    Res<Span<const Byte>> View(size_t offset, SpanSizeType count) const noexcept
+    {
+        if (offset > Size() || count > Size() - offset)
+        {
+            return Error::OutOfRange;
+        }
+
+        return Span<const Byte>(Bytes() + offset, count);
+    }
+
+    /// @brief Tells the operating system how the whole file will be read.
+    /// @details On Windows only MapAdvice::WillNeed has an effect, through
+    /// PrefetchVirtualMemory. The other hints are accepted and ignored.
+    Err Advise(MapAdvice advice) noexcept
+    {
+        return Advise(0, Size(), advice);
+    }
+
+    /// @brief Starts reading part of the file into memory ahead of use.
+    /// @param offset Offset of the first byte to read in.
+    /// @param count Number of bytes to read in.
+    Err Prefetch(size_t offset, size_t count) noexcept
+    {
+        return Advise(offset, count, MapAdvice::WillNeed);
+    }
+
+    /// @brief Unmaps the file.
+    void Close() noexcept
+    {
+        m_region.Reset();
+    }
+
+private:
+
+#if RAD_WINDOWS
+    static Res<MappedFile> Map(detail::MappedHandle& file,
+                               MapMode mode) noexcept
+    {
+        if (!file.IsValid())
+        {
+            return Error::InvalidAddress;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file.Get(), &fileSize))
+        {
+            return Error::Unsuccessful;
+        }
+
+        if (static_cast<uint64_t>(fileSize.QuadPart) > SIZE_MAX)
+        {
+            return Error::IntegerOverflow;
+        }
+
+        MappedFile mapped;
+        mapped.m_mode = mode;
+        const size_t size = static_cast<size_t>(fileSize.QuadPart);
+        if (size == 0)
+        {
+            return mapped;
+        }
+
+        const bool readOnly = mode == MapMode::ReadOnly;
+        detail::MappedHandle mapping(
+            CreateFileMappingW(file.Get(),
+                               nullptr,
+                               readOnly ? PAGE_READONLY : PAGE_WRITECOPY,
+                               0,
+                               0,
+                               nullptr));
+        if (!mapping.IsValid())
+        {
+            return Error::Unsuccessful;
+        }
+
+        // the view keeps the mapping object alive once its handle is closed
+        void* data = MapViewOfFile(mapping.Get(),
+                                   readOnly ? FILE_MAP_READ : FILE_MAP_COPY,
+                                   0,
+                                   0,
+                                   size);
+        if (data == nullptr)
+        {
+            return GetLastError() == ERROR_NOT_ENOUGH_MEMORY
+                       ? Error::NoMemory
+                       : Error::Unsuccessful;
+        }
+
+        mapped.m_region.Reset({ data, size });
+        return mapped;
+    }
+#endif
+
+    Err Advise(size_t offset, size_t count, MapAdvice advice) noexcept
+    {
+        if (offset > Size() || count > Size() - offset)
+        {
+            return Error::OutOfRange;
+        }
+
+        if (count == 0)
+        {
+            return NoError;
+        }
+
+#if RAD_WINDOWS
+        if (advice != MapAdvice::WillNeed)
+        {
+            return NoError;
+        }
+
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress =
+            static_cast<char*>(m_region.Get().data) + offset;
+        range.NumberOfBytes = count;
+        if (!PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0))
+        {
+            return Error::Unsuccessful;
+        }
+
+        return NoError;
+#else
+        // madvise wants a page aligned start
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t slack = offset % page;
+        char* const start =
+            static_cast<char*>(m_region.Get().data) + (offset - slack);
+
+        int hint = MADV_NORMAL;
+        switch (advice)
+        {
+            case MapAdvice::Normal:
+                hint = MADV_NORMAL;
+                break;
+            case MapAdvice::Sequential:
+                hint = MADV_SEQUENTIAL;
+                break;
+            case MapAdvice::Random:
+                hint = MADV_RANDOM;
+                break;
+            case MapAdvice::WillNeed:
+                hint = MADV_WILLNEED;
+                break;
+            case MapAdvice::DontNeed:
+                hint = MADV_DONTNEED;
+                break;
+        }
+
+        if (madvise(start, count + slack, hint) != 0)
+        {
+            return Error::Unsuccessful;
+        }
+
+        return NoError;
+#endif
+    }
+
+    UniqueResource<detail::MappedRegionPolicy> m_region;
+    MapMode m_mode = MapMode::ReadOnly;
+};
+
+} // namespace rad
+
+#endif // RAD_USER_MODE
@@ -21,6 +21,7 @@
 #include "radiant/detail/Meta.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #if RAD_ENABLE_STD
 #include <memory>
@@ -64,6 +65,9 @@ RAD_TRAIT_DETECTOR(PropagateOnMoveAssignment);
 RAD_TRAIT_DETECTOR(PropagateOnSwap);
 RAD_TRAIT_DETECTOR(HasConstructAndDestroy);
 RAD_TRAIT_DETECTOR(HasTypedAllocations);
+RAD_TRAIT_DETECTOR(HasTryExpandBytes);
+RAD_TRAIT_DETECTOR(HasReallocBytes);
+RAD_TRAIT_DETECTOR(HasAllocBytesAtLeast);
 
 #undef RAD_TRAIT_DETECTOR
 
@@ -85,6 +89,23 @@ struct IsAlwaysEqual<T, meta::VoidT<decltype(T::IsAlwaysEqual)>>
 
 } // namespace detection
 
+/// @brief Memory returned by an allocator's AllocBytesAtLeast, along with the
+/// number of bytes it actually provides.
+struct AllocBytesResult
+{
+    void* ptr;
+    size_t size;
+};
+
+/// @brief Memory returned by AllocTraits::AllocAtLeast, along with the number
+/// of elements it can hold.
+template <typename T>
+struct AllocResult
+{
+    T* ptr;
+    size_t count;
+};
+
 template <typename AllocT>
 class AllocTraits
 {
@@ -102,6 +123,12 @@ public:
         detection::HasConstructAndDestroy<AllocT>::Val; // defaults to false
     static constexpr bool HasTypedAllocations =
         detection::HasTypedAllocations<AllocT>::Val; // defaults to false
+    static constexpr bool HasTryExpandBytes =
+        detection::HasTryExpandBytes<AllocT>::Val; // defaults to false
+    static constexpr bool HasReallocBytes =
+        detection::HasReallocBytes<AllocT>::Val; // defaults to false
+    static constexpr bool HasAllocBytesAtLeast =
+        detection::HasAllocBytesAtLeast<AllocT>::Val; // defaults to false
 
     static constexpr size_t MaxSize = ~size_t(0);
 
@@ -133,6 +160,48 @@ public:
         FreeImpl(IntegralConstant<bool, HasTypedAllocations>{}, a, p, n);
     }
 
+    // Allocates room for at least n items and reports how many the memory
+    // can actually hold, so that slack from rounding by the allocator is not
+    // wasted. The memory may be freed with any count from n to the reported
+    // count. Allocators without HasAllocBytesAtLeast report exactly n.
+    template <typename T>
+    static AllocResult<T> AllocAtLeast(AllocT& a, size_t n)
+    {
+        return AllocAtLeastImpl<T>(
+            IntegralConstant<bool, HasAllocBytesAtLeast>{},
+            a,
+            n);
+    }
+
+    // Attempts to grow an allocation of n items to new_n items without
+    // moving it. Returns false, leaving the allocation untouched, when the
+    // allocator cannot do so or does not support HasTryExpandBytes.
+    template <typename T>
+    static bool TryExpand(AllocT& a, T* p, size_t n, size_t new_n) noexcept
+    {
+        return TryExpandImpl(IntegralConstant<bool, HasTryExpandBytes>{},
+                             a,
+                             p,
+                             n,
+                             new_n);
+    }
+
+    // Resizes an allocation of n items to new_n items, possibly moving it
+    // with memcpy semantics. Returns nullptr, leaving the allocation
+    // untouched, when the allocator cannot do so or does not support
+    // HasReallocBytes.
+    template <typename T>
+    static T* Realloc(AllocT& a, T* p, size_t n, size_t new_n)
+    {
+        RAD_S_ASSERTMSG(IsTrivRelocatable<T>,
+                        "Realloc requires trivially relocatable types");
+        return ReallocImpl(IntegralConstant<bool, HasReallocBytes>{},
+                           a,
+                           p,
+                           n,
+                           new_n);
+    }
+
     // constexpr construct and destroy operations
     template <class T, class... Args>
     static constexpr T* Construct(AllocT& a, T* p, Args&&... args)
@@ -253,6 +322,101 @@ private:
         a.FreeBytes(p, n * sizeof(T));
     }
 
+    template <typename T>
+    static AllocResult<T> AllocAtLeastImpl(TrueType, // HasAllocBytesAtLeast
+                                           AllocT& a,
+                                           size_t n)
+    {
+        RAD_S_ASSERTMSG(!HasTypedAllocations,
+                        "Allocator::AllocBytesAtLeast cannot be combined with "
+                        "typed allocations");
+        if (n > MaxSize / sizeof(T))
+        {
+            a.HandleSizeOverflow();
+            return { nullptr, 0 };
+        }
+
+        AllocBytesResult res = a.AllocBytesAtLeast(n * sizeof(T));
+        if (res.ptr == nullptr)
+        {
+            return { nullptr, 0 };
+        }
+
+        RAD_ASSERT(res.size >= n * sizeof(T));
+        return { static_cast<T*>(res.ptr), res.size / sizeof(T) };
+    }
+
+    template <typename T>
+    static AllocResult<T> AllocAtLeastImpl(FalseType, // !HasAllocBytesAtLeast
+                                           AllocT& a,
+                                           size_t n)
+    {
+        T* ptr = Alloc<T>(a, n);
+        return { ptr, ptr != nullptr ? n : 0 };
+    }
+
+    template <typename T>
+    static bool TryExpandImpl(TrueType, // HasTryExpandBytes
+                              AllocT& a,
+                              T* p,
+                              size_t n,
+                              size_t new_n) noexcept
+    {
+        RAD_S_ASSERTMSG(noexcept(a.TryExpandBytes(p, n, new_n)),
+                        "Allocator::TryExpandBytes must be noexcept");
+        if (new_n > MaxSize / sizeof(T))
+        {
+            return false;
+        }
+
+        return a.TryExpandBytes(p, n * sizeof(T), new_n * sizeof(T));
+    }
+
+    template <typename T>
+    static bool TryExpandImpl(FalseType, // !HasTryExpandBytes
+                              AllocT& a,
+                              T* p,
+                              size_t n,
+                              size_t new_n) noexcept
+    {
+        RAD_UNUSED(a);
+        RAD_UNUSED(p);
+        RAD_UNUSED(n);
+        RAD_UNUSED(new_n);
+        return false;
+    }
+
+    template <typename T>
+    static T* ReallocImpl(TrueType, // HasReallocBytes
+                          AllocT& a,
+                          T* p,
+                          size_t n,
+                          size_t new_n)
+    {
+        if (new_n > MaxSize / sizeof(T))
+        {
+            a.HandleSizeOverflow();
+            return nullptr;
+        }
+
+        void* mem = a.ReallocBytes(p, n * sizeof(T), new_n * sizeof(T));
+        return static_cast<T*>(mem);
+    }
+
+    template <typename T>
+    static T* ReallocImpl(FalseType, // !HasReallocBytes
+                          AllocT& a,
+                          T* p,
+                          size_t n,
+                          size_t new_n)
+    {
+        RAD_UNUSED(a);
+        RAD_UNUSED(p);
+        RAD_UNUSED(n);
+        RAD_UNUSED(new_n);
+        return nullptr;
+    }
+
     template <class T, class... Args>
     static constexpr T* ConstructImpl(TrueType, // HasConstructAndDestroy
                                       AllocT& a,
@@ -363,6 +527,51 @@ private:
     }
 };
 
+namespace detail
+{
+
+/// @brief Internal use only. Allocates memory for an object of a type
+/// aligned to cache lines.
+/// @details Allocators usually only provide alignof(max_align_t) alignment,
+/// so a cache line worth of bytes is allocated in addition and the object
+/// placed on the first boundary past the start, which is recorded in the
+/// byte before the object.
+/// @return Uninitialized memory, or nullptr if the allocation failed.
+template <typename T, typename TAllocator>
+T* AllocCacheAligned(TAllocator& alloc)
+{
+    RAD_S_ASSERT(alignof(T) <= RAD_CACHE_LINE_SIZE);
+    RAD_S_ASSERT(RAD_CACHE_LINE_SIZE <= 256);
+
+    unsigned char* raw =
+        AllocTraits<TAllocator>::template Alloc<unsigned char>(
+            alloc,
+            sizeof(T) + RAD_CACHE_LINE_SIZE);
+    if (raw == nullptr)
+    {
+        return nullptr;
+    }
+
+    const size_t offset =
+        RAD_CACHE_LINE_SIZE -
+        (reinterpret_cast<uintptr_t>(raw) & (RAD_CACHE_LINE_SIZE - 1));
+    raw[offset - 1] = static_cast<unsigned char>(offset - 1);
+    return reinterpret_cast<T*>(raw + offset);
+}
+
+/// @brief Internal use only. Frees memory returned by AllocCacheAligned.
+template <typename T, typename TAllocator>
+void FreeCacheAligned(TAllocator& alloc, T* ptr) noexcept
+{
+    unsigned char* mem = reinterpret_cast<unsigned char*>(ptr);
+    const size_t offset = size_t{ mem[-1] } + 1;
+    AllocTraits<TAllocator>::Free(alloc,
+                                  mem - offset,
+                                  sizeof(T) + RAD_CACHE_LINE_SIZE);
+}
+
+} // namespace detail
+
 #if RAD_ENABLE_STD && RAD_USER_MODE
 class StdAllocator
 {
@@ -0,0 +1,340 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/CacheAligned.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Slot of an MpmcQueue.
+/// @details The sequence number tells producers and consumers whose turn it
+/// is: a producer at position pos may fill the slot when it holds pos, and a
+/// consumer at position pos may empty it when it holds pos + 1.
+template <typename T>
+struct MpmcQueueCell
+{
+    explicit MpmcQueueCell(size_t seq) noexcept
+        : sequence(seq)
+    {
+    }
+
+    ~MpmcQueueCell()
+    {
+    }
+
+    RAD_NOT_COPYABLE(MpmcQueueCell);
+
+    Atomic<size_t> sequence;
+
+    union
+    {
+        T value;
+    };
+};
+
+} // namespace detail
+
+RAD_BEGIN_CACHE_ALIGNED
+/// @brief Bounded lock-free queue for any number of producers and consumers.
+/// @details Each slot carries a sequence number which producers and consumers
+/// claim positions against, so a push or pop is a single compare-exchange on
+/// the shared position plus one store to the slot. The producer and consumer
+/// positions live on cache lines of their own, so producers do not contend
+/// with consumers.
+///
+/// Slots are allocated once by Init(). Pushing to a full queue or popping
+/// from an empty one fails instead of waiting. Init() and destruction are
+/// not thread-safe, every other member may be called concurrently.
+/// @tparam T Element type, which must be nothrow move constructible.
+/// @tparam TAllocator Allocator used to obtain the slots.
+template <typename T, typename TAllocator RAD_ALLOCATOR_EQ(T)>
+class MpmcQueue final
+{
+private:
+
+    using CellType = detail::MpmcQueueCell<T>;
+    using AllocatorTraits = AllocTraits<TAllocator>;
+
+public:
+
+    using ValueType = T;
+    using SizeType = size_t;
+    using AllocatorType = TAllocator;
+
+    RAD_S_ASSERT_NOTHROW_MOVE_T(T);
+
+    RAD_NOT_COPYABLE(MpmcQueue);
+    MpmcQueue(MpmcQueue&&) = delete;
+    MpmcQueue& operator=(MpmcQueue&&) = delete;
+
+    ~MpmcQueue()
+    {
+        RAD_S_ASSERT_NOTHROW_DTOR(IsNoThrowDtor<T>);
+
+        Release();
+    }
+
+    /// @brief Constructs a queue without capacity using a default-constructed
+    /// allocator.
+    MpmcQueue() noexcept = default;
+
+    /// @brief Constructs a queue without capacity using a copy-constructed
+    /// allocator.
+    /// @param alloc Allocator to copy.
+    explicit MpmcQueue(const AllocatorType& alloc) noexcept
+        : m_storage(alloc, nullptr)
+    {
+    }
+
+    /// @brief Allocates the slots of the queue, destroying any elements held.
+    /// @param capacity Minimum number of elements the queue can hold, rounded
+    /// up to a power of two of at least two.
+    /// @return Error::NoMemory if the slots could not be allocated, or
+    /// Error::IntegerOverflow if the capacity is too large.
+    Err Init(SizeType capacity) noexcept
+    {
+        SizeType count = 2;
+        while (count < capacity)
+        {
+            if RAD_UNLIKELY (count > (~SizeType(0) >> 1))
+            {
+                return Error::IntegerOverflow;
+            }
+
+            count <<= 1;
+        }
+
+        CellType* cells =
+            AllocatorTraits::template Alloc<CellType>(Allocator(), count);
+        if (cells == nullptr)
+        {
+            return Error::NoMemory;
+        }
+
+        for (SizeType i = 0; i < count; ++i)
+        {
+            ::new (static_cast<void*>(cells + i)) CellType(i);
+        }
+
+        Release();
+        Cells() = cells;
+        m_mask = count - 1;
+        return NoError;
+    }
+
+    /// @brief Gets the number of elements the queue can hold.
+    /// @return The capacity, zero before Init() succeeds.
+    SizeType Capacity() const noexcept
+    {
+        return Cells() == nullptr ? 0 : m_mask + 1;
+    }
+
+    /// @brief Gets the number of elements in the queue.
+    /// @details The value may be stale by the time it is returned when other
+    /// threads push or pop concurrently.
+    /// @return Number of elements in the queue.
+    SizeType ApproxSize() const noexcept
+    {
+        const SizeType head = m_dequeuePos.Load(MemOrderRelaxed);
+        const SizeType tail = m_enqueuePos.Load(MemOrderRelaxed);
+        const SizeType size = tail - head;
+        // a pop observed after its push can make the difference negative
+        return size > Capacity() ? 0 : size;
+    }
+
+    /// @brief Copies an element into the queue.
+    /// @param value Element to copy.
+    /// @return Error::OutOfRange if the queue is full.
+    Err TryPush(const T& value) noexcept(IsNoThrowCopyCtor<T>)
+    {
+        return TryEmplace(value);
+    }
+
+    /// @brief Moves an element into the queue.
+    /// @param value Element to move.
+    /// @return Error::OutOfRange if the queue is full.
+    Err TryPush(T&& value) noexcept
+    {
+        return TryEmplace(Move(value));
+    }
+
+    /// @brief Constructs an element at the back of the queue.
+    /// @details The element is only constructed when a slot was claimed, so
+    /// the arguments are untouched on failure.
+    /// @param args Arguments for T construction.
+    /// @return Error::OutOfRange if the queue is full.
+    template <typename... TArgs>
+    Err TryEmplace(TArgs&&... args) noexcept(IsNoThrowCtor<T, TArgs&&...>)
+    {
+        RAD_S_ASSERT_NOTHROW((IsNoThrowCtor<T, TArgs&&...>));
+
+        CellType* cells = Cells();
+        if RAD_UNLIKELY (cells == nullptr)
+        {
+            return Error::OutOfRange;
+        }
+
+        SizeType pos = m_enqueuePos.Load(MemOrderRelaxed);
+        CellType* cell;
+        for (;;)
+        {
+            cell = &cells[pos & m_mask];
+            const SizeType seq = cell->sequence.Load(MemOrderAcquire);
+            const intptr_t diff = static_cast<intptr_t>(seq - pos);
+            if (diff == 0)
+            {
+                if RAD_LIKELY (m_enqueuePos.CompareExchangeWeak(
+                                   pos,
+                                   pos + 1,
+                                   MemOrderRelaxed,
+                                   MemOrderRelaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return Error::OutOfRange;
+            }
+            else
+            {
+                pos = m_enqueuePos.Load(MemOrderRelaxed);
+            }
+        }
+
+        ::new (static_cast<void*>(&cell->value)) T(Forward<TArgs>(args)...);
+        cell->sequence.Store(pos + 1, MemOrderRelease);
+        return NoError;
+    }
+
+    /// @brief Moves the element at the front out of the queue.
+    /// @return The element, or Error::OutOfRange if the queue is empty.
+    Res<T> TryPop() noexcept
+    {
+        // careful!  T could be rad::Error
+        CellType* cells = Cells();
+        if RAD_UNLIKELY (cells == nullptr)
+        {
+            return Res<T>(ResErrTag, Error::OutOfRange);
+        }
+
+        SizeType pos = m_dequeuePos.Load(MemOrderRelaxed);
+        CellType* cell;
+        for (;;)
+        {
+            cell = &cells[pos & m_mask];
+            const SizeType seq = cell->sequence.Load(MemOrderAcquire);
+            const intptr_t diff = static_cast<intptr_t>(seq - (pos + 1));
+            if (diff == 0)
+            {
+                if RAD_LIKELY (m_dequeuePos.CompareExchangeWeak(
+                                   pos,
+                                   pos + 1,
+                                   MemOrderRelaxed,
+                                   MemOrderRelaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return Res<T>(ResErrTag, Error::OutOfRange);
+            }
+            else
+            {
+                pos = m_dequeuePos.Load(MemOrderRelaxed);
+            }
+        }
+
+        Res<T> res(ResOkTag, Move(cell->value));
+        cell->value.~T();
+        cell->sequence.Store(pos + m_mask + 1, MemOrderRelease);
+        return res;
+    }
+
+    /// @brief Returns the allocator.
+    /// @return The allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_storage.First();
+    }
+
+private:
+
+    void Release() noexcept
+    {
+        CellType* cells = Cells();
+        if (cells == nullptr)
+        {
+            return;
+        }
+
+        const SizeType tail = m_enqueuePos.Load(MemOrderRelaxed);
+        for (SizeType pos = m_dequeuePos.Load(MemOrderRelaxed); pos != tail;
+             ++pos)
+        {
+            cells[pos & m_mask].value.~T();
+        }
+
+        const SizeType count = m_mask + 1;
+        for (SizeType i = 0; i < count; ++i)
+        {
+            cells[i].~CellType();
+        }
+
+        AllocatorTraits::Free(Allocator(), cells, count);
+        Cells() = nullptr;
+        m_mask = 0;
+        m_enqueuePos.Store(0, MemOrderRelaxed);
+        m_dequeuePos.Store(0, MemOrderRelaxed);
+    }
+
+    AllocatorType& Allocator() noexcept
+    {
+        return m_storage.First();
+    }
+
+    CellType*& Cells() noexcept
+    {
+        return m_storage.Second();
+    }
+
+    CellType* Cells() const noexcept
+    {
+        return m_storage.Second();
+    }
+
+    EmptyOptimizedPair<AllocatorType, CellType*> m_storage;
+    SizeType m_mask = 0;
+    PaddedAtomic<SizeType> m_enqueuePos;
+    PaddedAtomic<SizeType> m_dequeuePos;
+};
+RAD_END_CACHE_ALIGNED
+
+} // namespace rad
@@ -0,0 +1,335 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Memory.h"
+
+#include <stddef.h>
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Header placed at the start of each pool slab.
+struct NodePoolSlab
+{
+    NodePoolSlab* next;
+};
+
+/// @brief Internal use only. Link stored in each free chunk.
+struct NodePoolChunk
+{
+    NodePoolChunk* next;
+};
+
+/// @brief Internal use only. Allocation state of a node pool.
+struct NodePoolState
+{
+    NodePoolChunk* free = nullptr;
+    NodePoolSlab* slabs = nullptr;
+    char* cursor = nullptr;
+    char* end = nullptr;
+};
+
+} // namespace detail
+
+/// @brief Pool of fixed-size chunks carved from contiguous slabs obtained from
+/// a backing allocator.
+/// @details Freed chunks are kept on a free list and recycled by subsequent
+/// allocations, so a container which repeatedly inserts and erases nodes
+/// settles into a fixed set of slabs and never touches the backing allocator.
+/// Slabs are only returned to the backing allocator by Release() or when the
+/// pool is destroyed.
+///
+/// A pool is not thread-safe. Containers use a pool through NodePoolAllocator,
+/// a lightweight handle that refers to the pool.
+/// @tparam TAllocator Backing allocator used to obtain slabs.
+/// @tparam TChunkSize Largest allocation, in bytes, served from the pool.
+/// @tparam TChunksPerSlab Number of chunks in each slab.
+template <typename TAllocator, size_t TChunkSize, size_t TChunksPerSlab = 64>
+class NodePool final
+{
+private:
+
+    using UnitType = max_align_t;
+    using SlabType = detail::NodePoolSlab;
+    using ChunkType = detail::NodePoolChunk;
+    using StateType = detail::NodePoolState;
+    using AllocatorTraits = AllocTraits<TAllocator>;
+
+    static constexpr size_t MaxAlignment = alignof(max_align_t);
+    static constexpr size_t RoundUp(size_t size, size_t align) noexcept
+    {
+        return (size + align - 1) & ~(align - 1);
+    }
+
+    // Largest power of two dividing size, capped at MaxAlignment.
+    static constexpr size_t AlignmentOf(size_t size) noexcept
+    {
+        return ((size & (~size + 1)) < MaxAlignment) ? (size & (~size + 1))
+                                                      : MaxAlignment;
+    }
+
+public:
+
+    using AllocatorType = TAllocator;
+    using ThisType = NodePool<TAllocator, TChunkSize, TChunksPerSlab>;
+
+    static constexpr size_t ChunkSize = TChunkSize;
+    static constexpr size_t ChunksPerSlab = TChunksPerSlab;
+
+    /// @brief Distance between consecutive chunks of a slab.
+    static constexpr size_t Stride = RoundUp(
+        TChunkSize < sizeof(ChunkType) ? sizeof(ChunkType) : TChunkSize,
+        alignof(ChunkType));
+
+    /// @brief Alignment guaranteed for every chunk.
+    static constexpr size_t Alignment = AlignmentOf(Stride);
+
+    static constexpr size_t HeaderSize =
+        RoundUp(sizeof(SlabType), MaxAlignment);
+    static constexpr size_t SlabUnits =
+        (HeaderSize + Stride * ChunksPerSlab + sizeof(UnitType) - 1) /
+        sizeof(UnitType);
+
+    RAD_S_ASSERTMSG(TChunkSize > 0, "NodePool chunk size must not be zero");
+    RAD_S_ASSERTMSG(TChunksPerSlab > 0, "NodePool slabs must hold chunks");
+
+    RAD_NOT_COPYABLE(NodePool);
+    NodePool(NodePool&&) = delete;
+    NodePool& operator=(NodePool&&) = delete;
+
+    ~NodePool()
+    {
+        Release();
+    }
+
+    /// @brief Constructs an empty pool with a default-constructed backing
+    /// allocator.
+    NodePool() noexcept = default;
+
+    /// @brief Constructs an empty pool with a copy-constructed backing
+    /// allocator.
+    /// @param alloc Backing allocator to copy.
+    explicit NodePool(const AllocatorType& alloc) noexcept
+        : m_storage(alloc)
+    {
+    }
+
+    /// @brief Determines whether an allocation is served from the pool.
+    /// @details Requests which do not fit in a chunk, or whose natural
+    /// alignment the chunks cannot honor, must go elsewhere.
+    /// @param size Number of bytes requested.
+    /// @return True when Alloc() can satisfy the request.
+    static constexpr bool Fits(size_t size) noexcept
+    {
+        return size != 0 && size <= ChunkSize &&
+               (Alignment % AlignmentOf(size)) == 0;
+    }
+
+    /// @brief Allocates one chunk.
+    /// @return Pointer to the chunk, or nullptr on failure.
+    void* Alloc()
+    {
+        StateType& state = State();
+
+        ChunkType* chunk = state.free;
+        if RAD_LIKELY (chunk != nullptr)
+        {
+            state.free = chunk->next;
+            return chunk;
+        }
+
+        if (state.cursor == state.end)
+        {
+            if (!NewSlab())
+            {
+                return nullptr;
+            }
+        }
+
+        void* ptr = state.cursor;
+        state.cursor += Stride;
+        return ptr;
+    }
+
+    /// @brief Returns a chunk to the pool for reuse.
+    /// @param ptr Chunk previously returned by Alloc(), or nullptr.
+    void Free(void* ptr) noexcept
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+
+        StateType& state = State();
+
+        ChunkType* chunk = ::new (ptr) ChunkType;
+        chunk->next = state.free;
+        state.free = chunk;
+    }
+
+    /// @brief Returns every slab to the backing allocator, invalidating all
+    /// chunks allocated from the pool.
+    void Release() noexcept
+    {
+        StateType& state = State();
+
+        SlabType* slab = state.slabs;
+        while (slab != nullptr)
+        {
+            SlabType* next = slab->next;
+            AllocatorTraits::Free(Allocator(),
+                                  reinterpret_cast<UnitType*>(slab),
+                                  SlabUnits);
+            slab = next;
+        }
+
+        state = StateType();
+    }
+
+    /// @brief Returns the backing allocator.
+    /// @return The backing allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_storage.First();
+    }
+
+    /// @brief Returns a reference to the backing allocator.
+    /// @return The backing allocator.
+    AllocatorType& BackingAllocator() noexcept
+    {
+        return m_storage.First();
+    }
+
+private:
+
+    bool NewSlab()
+    {
+        UnitType* mem =
+            AllocatorTraits::template Alloc<UnitType>(Allocator(), SlabUnits);
+        if (mem == nullptr)
+        {
+            return false;
+        }
+
+        StateType& state = State();
+
+        SlabType* slab = ::new (static_cast<void*>(mem)) SlabType;
+        slab->next = state.slabs;
+        state.slabs = slab;
+
+        state.cursor = reinterpret_cast<char*>(slab) + HeaderSize;
+        state.end = state.cursor + Stride * ChunksPerSlab;
+        return true;
+    }
+
+    AllocatorType& Allocator() noexcept
+    {
+        return m_storage.First();
+    }
+
+    StateType& State() noexcept
+    {
+        return m_storage.Second();
+    }
+
+    EmptyOptimizedPair<AllocatorType, StateType> m_storage;
+};
+
+/// @brief Allocator handle referring to a NodePool, satisfying the Radiant
+/// allocator contract.
+/// @details Requests which fit in a chunk are served from the pool and
+/// recycled when freed. Other requests are forwarded to the pool's backing
+/// allocator. The pool must outlive all containers which allocate from it.
+/// Handles compare equal when they refer to the same pool, and propagate with
+/// the containers that use them.
+/// @tparam TAllocator Backing allocator of the pool.
+/// @tparam TChunkSize Chunk size of the pool.
+/// @tparam TChunksPerSlab Number of chunks in each slab of the pool.
+template <typename TAllocator, size_t TChunkSize, size_t TChunksPerSlab = 64>
+class NodePoolAllocator final
+{
+public:
+
+    static constexpr bool PropagateOnCopy = true;
+    static constexpr bool PropagateOnMoveAssignment = true;
+    static constexpr bool PropagateOnSwap = true;
+    static constexpr bool IsAlwaysEqual = false;
+
+    using PoolType = NodePool<TAllocator, TChunkSize, TChunksPerSlab>;
+
+    /// @brief Constructs a handle to a pool.
+    /// @param pool Pool to allocate from.
+    explicit NodePoolAllocator(PoolType& pool) noexcept
+        : m_pool(&pool)
+    {
+    }
+
+    void* AllocBytes(size_t size)
+    {
+        if RAD_LIKELY (PoolType::Fits(size))
+        {
+            return m_pool->Alloc();
+        }
+
+        return AllocTraits<TAllocator>::AllocBytes(m_pool->BackingAllocator(),
+                                                   size);
+    }
+
+    void FreeBytes(void* ptr, size_t size) noexcept
+    {
+        if RAD_LIKELY (PoolType::Fits(size))
+        {
+            m_pool->Free(ptr);
+            return;
+        }
+
+        AllocTraits<TAllocator>::FreeBytes(m_pool->BackingAllocator(),
+                                           ptr,
+                                           size);
+    }
+
+    static void HandleSizeOverflow() noexcept
+    {
+    }
+
+    bool operator==(const NodePoolAllocator& other) const noexcept
+    {
+        return m_pool == other.m_pool;
+    }
+
+    bool operator!=(const NodePoolAllocator& other) const noexcept
+    {
+        return m_pool != other.m_pool;
+    }
+
+    /// @brief Returns the pool this handle refers to.
+    /// @return The pool.
+    PoolType& GetPool() const noexcept
+    {
+        return *m_pool;
+    }
+
+private:
+
+    PoolType* m_pool;
+};
+
+} // namespace rad
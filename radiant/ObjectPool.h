@@ -0,0 +1,369 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/CacheAligned.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Locks.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/SpinLocks.h"
+#include "radiant/Utility.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Link stored in each free object slot.
+/// @details The first slot of a batch in the depot also links the next batch
+/// and records how many slots its batch holds.
+struct ObjectPoolSlot
+{
+    ObjectPoolSlot* next;
+    ObjectPoolSlot* nextBatch;
+    uint32_t count;
+};
+
+/// @brief Internal use only. Header placed at the start of each slab.
+struct ObjectPoolSlab
+{
+    ObjectPoolSlab* next;
+};
+
+RAD_BEGIN_CACHE_ALIGNED
+/// @brief Internal use only. Per-thread cache of an ObjectPool.
+/// @details Everything but inUse is private to the thread using the cache.
+struct ObjectPoolCache
+{
+    RAD_NOT_COPYABLE(ObjectPoolCache);
+
+    ObjectPoolCache() noexcept = default;
+
+    // keeps the caches of different threads on different cache lines
+    alignas(RAD_CACHE_LINE_SIZE) ObjectPoolSlot* free = nullptr;
+    uint32_t count = 0;
+    Atomic<uint32_t> inUse{ 1 };
+    ObjectPoolCache* next = nullptr;
+};
+RAD_END_CACHE_ALIGNED
+
+} // namespace detail
+
+/// @brief Thread-safe pool of objects of one type, with a free list cached
+/// per thread.
+/// @details Each thread using the pool registers a Cache and passes it to
+/// Acquire() and Release(), which normally pop and push the cache's own free
+/// list without synchronizing with other threads. A cache holding no free
+/// objects refills a batch of TBatchSize objects from a depot shared by all
+/// threads, and a cache holding twice that hands a batch back, so objects
+/// released on a different thread than they were acquired on flow back to
+/// the acquiring threads through the depot. Only the depot is protected by a
+/// lock, which is taken once per batch.
+///
+/// When the depot is empty a slab holding a batch of objects is allocated
+/// from the backing allocator. Slabs are only returned to the backing
+/// allocator when the pool is destroyed.
+///
+/// A cache may only be used by one thread at a time. Records of unregistered
+/// caches are reused by later registrations and only freed with the pool,
+/// which must outlive every cache and every object acquired from it.
+/// @tparam T Type of the pooled objects.
+/// @tparam TAllocator Thread-safe allocator used for slabs and caches.
+/// @tparam TBatchSize Number of objects moved between a cache and the depot
+/// at once.
+template <typename T,
+          typename TAllocator RAD_ALLOCATOR_EQ(void),
+          uint32_t TBatchSize = 32>
+class ObjectPool final
+{
+private:
+
+    using UnitType = max_align_t;
+    using SlotType = detail::ObjectPoolSlot;
+    using SlabType = detail::ObjectPoolSlab;
+    using CacheType = detail::ObjectPoolCache;
+    using AllocatorTraits = AllocTraits<TAllocator>;
+
+    static constexpr size_t RoundUp(size_t size, size_t align) noexcept
+    {
+        return (size + align - 1) & ~(align - 1);
+    }
+
+    static constexpr size_t Max(size_t a, size_t b) noexcept
+    {
+        return a < b ? b : a;
+    }
+
+public:
+
+    using ValueType = T;
+    using AllocatorType = TAllocator;
+    using Cache = CacheType;
+
+    static constexpr uint32_t BatchSize = TBatchSize;
+
+    /// @brief Distance between consecutive objects of a slab.
+    static constexpr size_t Stride =
+        RoundUp(Max(sizeof(T), sizeof(SlotType)),
+                Max(alignof(T), alignof(SlotType)));
+
+    static constexpr size_t HeaderSize =
+        RoundUp(sizeof(SlabType), alignof(UnitType));
+    static constexpr size_t SlabUnits =
+        (HeaderSize + Stride * BatchSize + sizeof(UnitType) - 1) /
+        sizeof(UnitType);
+
+    RAD_S_ASSERTMSG(TBatchSize > 0, "ObjectPool batches must hold objects");
+    RAD_S_ASSERTMSG(alignof(T) <= alignof(UnitType),
+                    "ObjectPool does not support over-aligned types");
+
+    RAD_NOT_COPYABLE(ObjectPool);
+    ObjectPool(ObjectPool&&) = delete;
+    ObjectPool& operator=(ObjectPool&&) = delete;
+
+    /// @brief Returns every slab to the backing allocator and frees the cache
+    /// records.
+    /// @warning Every object must have been released, and no cache may be
+    /// used afterwards.
+    ~ObjectPool()
+    {
+        CacheType* cache = m_storage.Second().caches;
+        while (cache != nullptr)
+        {
+            CacheType* next = cache->next;
+            cache->~CacheType();
+            detail::FreeCacheAligned(Allocator(), cache);
+            cache = next;
+        }
+
+        SlabType* slab = m_storage.Second().slabs;
+        while (slab != nullptr)
+        {
+            SlabType* next = slab->next;
+            AllocatorTraits::Free(Allocator(),
+                                  reinterpret_cast<UnitType*>(slab),
+                                  SlabUnits);
+            slab = next;
+        }
+    }
+
+    /// @brief Constructs an empty pool with a default-constructed backing
+    /// allocator.
+    ObjectPool() noexcept = default;
+
+    /// @brief Constructs an empty pool with a copy-constructed backing
+    /// allocator.
+    /// @param alloc Backing allocator to copy.
+    explicit ObjectPool(const AllocatorType& alloc) noexcept
+        : m_storage(alloc)
+    {
+    }
+
+    /// @brief Registers a cache for the calling thread, reusing the record of
+    /// an unregistered cache if there is one.
+    /// @return The cache, or Error::NoMemory if no record could be allocated.
+    Res<Cache*> Register() noexcept
+    {
+        {
+            LockExclusive<TicketSpinLock> lock(m_lock);
+            for (CacheType* cache = m_storage.Second().caches;
+                 cache != nullptr;
+                 cache = cache->next)
+            {
+                if (cache->inUse.Load(MemOrderAcquire) == 0)
+                {
+                    cache->inUse.Store(1, MemOrderRelaxed);
+                    return Res<Cache*>(ResOkTag, cache);
+                }
+            }
+        }
+
+        CacheType* cache = detail::AllocCacheAligned<CacheType>(Allocator());
+        if (cache == nullptr)
+        {
+            return Res<Cache*>(ResErrTag, Error::NoMemory);
+        }
+
+        ::new (static_cast<void*>(cache)) CacheType;
+        LockExclusive<TicketSpinLock> lock(m_lock);
+        cache->next = m_storage.Second().caches;
+        m_storage.Second().caches = cache;
+        return Res<Cache*>(ResOkTag, cache);
+    }
+
+    /// @brief Unregisters a cache, handing the free objects it holds to the
+    /// depot.
+    /// @param cache Cache to unregister.
+    void Unregister(Cache& cache) noexcept
+    {
+        while (cache.count != 0)
+        {
+            Flush(cache);
+        }
+
+        cache.inUse.Store(0, MemOrderRelease);
+    }
+
+    /// @brief Takes an object from the pool and constructs it.
+    /// @param cache Cache of the calling thread.
+    /// @param args Arguments to construct the object with.
+    /// @return The object, or nullptr if no slab could be allocated.
+    template <typename... TArgs>
+    T* Acquire(Cache& cache, TArgs&&... args) noexcept
+    {
+        RAD_S_ASSERT_NOTHROW(noexcept(T(Forward<TArgs>(args)...)));
+
+        if RAD_UNLIKELY (cache.count == 0 && !Refill(cache))
+        {
+            return nullptr;
+        }
+
+        SlotType* slot = cache.free;
+        cache.free = slot->next;
+        --cache.count;
+        return ::new (static_cast<void*>(slot)) T(Forward<TArgs>(args)...);
+    }
+
+    /// @brief Destroys an object and returns it to the pool.
+    /// @param cache Cache of the calling thread, which need not be the cache
+    /// the object was acquired with.
+    /// @param ptr Object previously returned by Acquire(), or nullptr.
+    void Release(Cache& cache, T* ptr) noexcept
+    {
+        RAD_S_ASSERT_NOTHROW_DTOR(noexcept(ptr->~T()));
+
+        if (ptr == nullptr)
+        {
+            return;
+        }
+
+        ptr->~T();
+        SlotType* slot = ::new (static_cast<void*>(ptr)) SlotType;
+        slot->next = cache.free;
+        cache.free = slot;
+        if RAD_UNLIKELY (++cache.count >= 2 * BatchSize)
+        {
+            Flush(cache);
+        }
+    }
+
+    /// @brief Gets the number of free objects held by a cache.
+    /// @param cache Cache to inspect.
+    /// @return Number of objects the cache can hand out without refilling.
+    uint32_t CachedCount(const Cache& cache) const noexcept
+    {
+        return cache.count;
+    }
+
+    /// @brief Returns the backing allocator.
+    /// @return The backing allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_storage.First();
+    }
+
+private:
+
+    struct State
+    {
+        SlotType* batches = nullptr;
+        SlabType* slabs = nullptr;
+        CacheType* caches = nullptr;
+    };
+
+    bool Refill(Cache& cache) noexcept
+    {
+        {
+            LockExclusive<TicketSpinLock> lock(m_lock);
+            SlotType* batch = m_storage.Second().batches;
+            if (batch != nullptr)
+            {
+                m_storage.Second().batches = batch->nextBatch;
+                cache.free = batch;
+                cache.count = batch->count;
+                return true;
+            }
+        }
+
+        UnitType* mem =
+            AllocatorTraits::template Alloc<UnitType>(Allocator(), SlabUnits);
+        if (mem == nullptr)
+        {
+            return false;
+        }
+
+        SlabType* slab = ::new (static_cast<void*>(mem)) SlabType;
+        {
+            LockExclusive<TicketSpinLock> lock(m_lock);
+            slab->next = m_storage.Second().slabs;
+            m_storage.Second().slabs = slab;
+        }
+
+        // link the slots in address order, so a fresh batch is handed out
+        // sequentially
+        char* first = reinterpret_cast<char*>(slab) + HeaderSize;
+        SlotType* next = nullptr;
+        for (uint32_t i = BatchSize; i-- > 0;)
+        {
+            SlotType* slot =
+                ::new (static_cast<void*>(first + i * Stride)) SlotType;
+            slot->next = next;
+            next = slot;
+        }
+
+        cache.free = next;
+        cache.count = BatchSize;
+        return true;
+    }
+
+    // moves up to a batch of free objects from the cache to the depot
+    void Flush(Cache& cache) noexcept
+    {
+        SlotType* batch = cache.free;
+        SlotType* last = batch;
+        uint32_t count = 1;
+        while (count < BatchSize && count < cache.count)
+        {
+            last = last->next;
+            ++count;
+        }
+
+        cache.free = last->next;
+        cache.count -= count;
+        last->next = nullptr;
+        batch->count = count;
+
+        LockExclusive<TicketSpinLock> lock(m_lock);
+        batch->nextBatch = m_storage.Second().batches;
+        m_storage.Second().batches = batch;
+    }
+
+    AllocatorType& Allocator() noexcept
+    {
+        return m_storage.First();
+    }
+
+    EmptyOptimizedPair<AllocatorType, State> m_storage;
+    TicketSpinLock m_lock;
+};
+
+} // namespace rad
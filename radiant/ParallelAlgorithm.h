@@ -0,0 +1,580 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Algorithm.h"
+#include "radiant/Atomic.h"
+#include "radiant/Locks.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/Span.h"
+#include "radiant/SpinLocks.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <new>
+
+//
+// Parallel versions of the span algorithms. Each splits its span into chunks
+// of about ParallelChunkBytes, submits a helper task per worker thread of the
+// executor and processes chunks on the calling thread too, taking the next
+// chunk from a shared counter until none are left. The call returns once
+// every helper has finished, running other queued tasks of the executor while
+// it waits. Spans of a single chunk, and executors without worker threads,
+// are processed serially on the calling thread.
+//
+// An executor is any type providing:
+//
+//     uint32_t ThreadCount();  number of threads which may run tasks
+//     Err Submit(F&& fn);      queue fn to run once on one of them
+//     bool RunOne();           run a queued task on the calling thread
+//
+// as ThreadPool does. Submit() failing is not an error, the calling thread
+// takes the chunks the helper would have processed. The callables given to
+// the algorithms are invoked concurrently and must not throw.
+//
+
+namespace rad
+{
+
+/// @brief Default number of bytes of elements each task of a parallel
+/// algorithm processes at a time, about the size of a level 1 data cache.
+static constexpr size_t ParallelChunkBytes = 32 * 1024;
+
+/// @brief Executor running every task on the submitting thread.
+/// @details Parallel algorithms given this executor run serially.
+class SerialExecutor final
+{
+public:
+
+    /// @brief Gets the number of worker threads.
+    /// @return Always zero.
+    uint32_t ThreadCount() const noexcept
+    {
+        return 0;
+    }
+
+    /// @brief Runs a task on the calling thread.
+    /// @param fn Callable invoked without arguments.
+    /// @return Always NoError.
+    template <typename F>
+    Err Submit(F&& fn) noexcept
+    {
+        fn();
+        return NoError;
+    }
+
+    /// @brief Runs a queued task, of which there never are any.
+    /// @return Always false.
+    bool RunOne() noexcept
+    {
+        return false;
+    }
+};
+
+namespace detail
+{
+namespace parallel
+{
+
+// Chunks processed by a group of threads, claimed through a shared counter.
+template <typename F>
+struct ChunkJob
+{
+    ChunkJob(const F& f, size_t count) noexcept
+        : fn(f),
+          chunkCount(count)
+    {
+    }
+
+    void Run() noexcept
+    {
+        for (;;)
+        {
+            const size_t chunk = next.FetchAdd(1, MemOrderRelaxed);
+            if (chunk >= chunkCount)
+            {
+                return;
+            }
+
+            fn(chunk);
+        }
+    }
+
+    const F& fn;
+    const size_t chunkCount;
+    Atomic<size_t> next{ 0 };
+    Atomic<size_t> finished{ 0 };
+};
+
+/// @brief Internal use only. Calls fn(i) for each i in [0, count) on the
+/// calling thread and the executor's workers, returning once all calls made.
+template <typename TExecutor, typename F>
+void ForChunks(TExecutor& exec, size_t count, const F& fn) noexcept
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    ChunkJob<F> job(fn, count);
+    const size_t helpers = Min(static_cast<size_t>(exec.ThreadCount()),
+                               count - 1);
+    size_t submitted = 0;
+    for (; submitted < helpers; ++submitted)
+    {
+        auto helper = [&job]() noexcept
+        {
+            job.Run();
+            // the job lives on the stack of the caller, which may return as
+            // soon as this is seen
+            job.finished.FetchAdd(1, MemOrderRelease);
+        };
+
+        if (exec.Submit(helper).IsErr())
+        {
+            break;
+        }
+    }
+
+    job.Run();
+
+    // helpers which have yet to start are queued in the executor, so help
+    // running its tasks rather than only waiting for them
+    SpinBackoff backoff;
+    while (job.finished.Load(MemOrderAcquire) != submitted)
+    {
+        if (!exec.RunOne())
+        {
+            backoff.Pause();
+        }
+    }
+}
+
+/// @brief Internal use only. Number of elements per chunk.
+template <typename T>
+size_t ChunkSize(SpanSizeType grain) noexcept
+{
+    if (grain != 0)
+    {
+        return grain;
+    }
+
+    return sizeof(T) < ParallelChunkBytes ? ParallelChunkBytes / sizeof(T)
+                                          : 1;
+}
+
+/// @brief Internal use only. Number of output elements of a merge of two
+/// sorted runs which come from the first.
+/// @details Elements of the first run are taken before equal ones of the
+/// second, so merges split at these points are stable.
+template <typename T, typename TComp>
+size_t MergeSplit(const T* first,
+                  size_t firstSize,
+                  const T* second,
+                  size_t secondSize,
+                  size_t outputs,
+                  TComp& comp)
+{
+    size_t low = outputs > secondSize ? outputs - secondSize : 0;
+    size_t high = Min(outputs, firstSize);
+    while (low < high)
+    {
+        const size_t mid = low + (high - low + 1) / 2;
+        if (!comp(second[outputs - mid], first[mid - 1]))
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid - 1;
+        }
+    }
+
+    return low;
+}
+
+/// @brief Internal use only. Merges sorted runs by move assignment.
+template <typename T, typename TComp>
+void MergeMove(T* first,
+               T* firstEnd,
+               T* second,
+               T* secondEnd,
+               T* out,
+               TComp& comp)
+{
+    while (first != firstEnd && second != secondEnd)
+    {
+        if (comp(*second, *first))
+        {
+            *out++ = Move(*second++);
+        }
+        else
+        {
+            *out++ = Move(*first++);
+        }
+    }
+
+    for (; first != firstEnd; ++first)
+    {
+        *out++ = Move(*first);
+    }
+
+    for (; second != secondEnd; ++second)
+    {
+        *out++ = Move(*second);
+    }
+}
+
+// Chunk of the output of merging a pair of adjacent sorted runs.
+template <typename T>
+struct MergeChunk
+{
+    MergeChunk(T* from,
+               size_t size,
+               size_t run,
+               size_t chunk,
+               size_t chunksPerPair,
+               size_t index) noexcept
+    {
+        base = index / chunksPerPair * 2 * run;
+        const size_t pairSize = Min(2 * run, size - base);
+        first = from + base;
+        firstSize = Min(run, pairSize);
+        second = first + firstSize;
+        secondSize = pairSize - firstSize;
+        begin = index % chunksPerPair * chunk;
+        end = Min(begin + chunk, pairSize);
+    }
+
+    bool Empty() const noexcept
+    {
+        return begin >= end;
+    }
+
+    bool Last() const noexcept
+    {
+        return end == firstSize + secondSize;
+    }
+
+    size_t base;
+    T* first;
+    size_t firstSize;
+    T* second;
+    size_t secondSize;
+    size_t begin;
+    size_t end;
+};
+
+/// @brief Internal use only. Number of chunks of a merge pass.
+inline size_t MergeChunkCount(size_t size, size_t run, size_t chunk) noexcept
+{
+    const size_t pairCount = (size + 2 * run - 1) / (2 * run);
+    return pairCount * ((2 * run + chunk - 1) / chunk);
+}
+
+/// @brief Internal use only. Merges each pair of adjacent sorted runs of
+/// from into to, splitting every merge into chunks.
+/// @details The split points of all chunks are found before any element is
+/// moved, as moving may modify the elements other chunks search.
+template <typename TExecutor, typename T, typename TComp>
+void MergePass(TExecutor& exec,
+               T* from,
+               T* to,
+               size_t size,
+               size_t run,
+               size_t chunk,
+               size_t* splits,
+               TComp& comp)
+{
+    const size_t chunksPerPair = (2 * run + chunk - 1) / chunk;
+    const size_t count = MergeChunkCount(size, run, chunk);
+    ForChunks(exec,
+              count,
+              [=, &comp](size_t index) noexcept
+              {
+                  MergeChunk<T> c(from, size, run, chunk, chunksPerPair, index);
+                  if (!c.Empty())
+                  {
+                      splits[index] = MergeSplit(c.first,
+                                                 c.firstSize,
+                                                 c.second,
+                                                 c.secondSize,
+                                                 c.begin,
+                                                 comp);
+                  }
+              });
+
+    ForChunks(exec,
+              count,
+              [=, &comp](size_t index) noexcept
+              {
+                  MergeChunk<T> c(from, size, run, chunk, chunksPerPair, index);
+                  if (c.Empty())
+                  {
+                      return;
+                  }
+
+                  // the next chunk of the pair starts where this one ends
+                  const size_t a = splits[index];
+                  const size_t b = c.Last() ? c.firstSize : splits[index + 1];
+                  MergeMove(c.first + a,
+                            c.first + b,
+                            c.second + (c.begin - a),
+                            c.second + (c.end - b),
+                            to + c.base + c.begin,
+                            comp);
+              });
+}
+
+} // namespace parallel
+} // namespace detail
+
+/// @brief Invokes a function on every element of a span, in parallel.
+/// @param exec Executor running the helper tasks.
+/// @param span Elements to visit.
+/// @param fn Callable invoked as fn(element) concurrently on several threads.
+/// @param grain Number of elements per task, or zero for ParallelChunkBytes
+/// worth of them.
+template <typename TExecutor, typename T, SpanSizeType N, typename F>
+void ParallelForEach(TExecutor& exec,
+                     Span<T, N> span,
+                     const F& fn,
+                     SpanSizeType grain = 0)
+{
+    const size_t size = span.Size();
+    const size_t chunk = detail::parallel::ChunkSize<T>(grain);
+    T* data = span.Data();
+    detail::parallel::ForChunks(exec,
+                                (size + chunk - 1) / chunk,
+                                [=, &fn](size_t index) noexcept
+                                {
+                                    const size_t begin = index * chunk;
+                                    const size_t end = Min(begin + chunk, size);
+                                    for (size_t i = begin; i != end; ++i)
+                                    {
+                                        fn(data[i]);
+                                    }
+                                });
+}
+
+/// @brief Assigns the result of a function of every element of a span to
+/// the element at the same index of another, in parallel.
+/// @param exec Executor running the helper tasks.
+/// @param input Elements to transform.
+/// @param output Destination, at least as large as input.
+/// @param fn Callable invoked as fn(element) concurrently on several threads.
+/// @param grain Number of elements per task, or zero for ParallelChunkBytes
+/// worth of them.
+template <typename TExecutor,
+          typename T,
+          SpanSizeType N,
+          typename U,
+          SpanSizeType M,
+          typename F>
+void ParallelTransform(TExecutor& exec,
+                       Span<T, N> input,
+                       Span<U, M> output,
+                       const F& fn,
+                       SpanSizeType grain = 0)
+{
+    RAD_ASSERT(output.Size() >= input.Size());
+    const size_t size = input.Size();
+    const size_t chunk = detail::parallel::ChunkSize<T>(grain);
+    T* in = input.Data();
+    U* out = output.Data();
+    detail::parallel::ForChunks(exec,
+                                (size + chunk - 1) / chunk,
+                                [=, &fn](size_t index) noexcept
+                                {
+                                    const size_t begin = index * chunk;
+                                    const size_t end = Min(begin + chunk, size);
+                                    for (size_t i = begin; i != end; ++i)
+                                    {
+                                        out[i] = fn(in[i]);
+                                    }
+                                });
+}
+
+/// @brief Combines the elements of a span with a binary operation, in
+/// parallel.
+/// @details The elements are combined in an unspecified order and grouping,
+/// so op must be associative and commutative for the result to be
+/// deterministic.
+/// @param exec Executor running the helper tasks.
+/// @param span Elements to combine.
+/// @param init Initial value, which must be constructible from an element.
+/// @param op Callable invoked as op(U, element) and op(U, U) concurrently on
+/// several threads, returning U.
+/// @param grain Number of elements per task, or zero for ParallelChunkBytes
+/// worth of them.
+/// @return init combined with every element.
+template <typename TExecutor,
+          typename T,
+          SpanSizeType N,
+          typename U,
+          typename TOp>
+U ParallelReduce(TExecutor& exec,
+                 Span<T, N> span,
+                 U init,
+                 const TOp& op,
+                 SpanSizeType grain = 0)
+{
+    const size_t size = span.Size();
+    const size_t chunk = detail::parallel::ChunkSize<T>(grain);
+    T* data = span.Data();
+    TicketSpinLock lock;
+    detail::parallel::ForChunks(exec,
+                                (size + chunk - 1) / chunk,
+                                [&, data, size, chunk](size_t index) noexcept
+                                {
+                                    const size_t begin = index * chunk;
+                                    const size_t end = Min(begin + chunk, size);
+                                    U partial(data[begin]);
+                                    for (size_t i = begin + 1; i != end; ++i)
+                                    {
+                                        partial = op(Move(partial), data[i]);
+                                    }
+
+                                    LockExclusive<TicketSpinLock> guard(lock);
+                                    init = op(Move(init), Move(partial));
+                                });
+
+    return init;
+}
+
+/// @brief Sorts the elements of a span, in parallel.
+/// @details Sorts runs of the span in parallel with Sort(), then merges
+/// pairs of runs into a buffer obtained from the allocator and back until
+/// one run is left, splitting every merge into chunks so the last merges
+/// are parallel too. If the allocation fails, or the span fits in a chunk,
+/// the span is sorted serially instead, so the sort always succeeds. The
+/// sort is not stable.
+/// @param exec Executor running the helper tasks.
+/// @param alloc Allocator for a buffer the size of the span, and another for
+/// the split points of the merges.
+/// @param span Elements to sort.
+/// @param comp Strict weak ordering of the elements, invoked concurrently on
+/// several threads.
+/// @param grain Minimum number of elements per task, or zero for
+/// ParallelChunkBytes worth of them.
+template <typename TExecutor,
+          typename TAllocator,
+          typename T,
+          SpanSizeType N,
+          typename TComp = Less<>>
+void ParallelSort(TExecutor& exec,
+                  TAllocator& alloc,
+                  Span<T, N> span,
+                  TComp comp = TComp(),
+                  SpanSizeType grain = 0)
+{
+    RAD_S_ASSERT_NOTHROW_MOVE_T(T);
+    RAD_S_ASSERTMSG(alignof(T) <= alignof(max_align_t),
+                    "ParallelSort does not support over-aligned types");
+
+    const size_t size = span.Size();
+    const size_t chunk = detail::parallel::ChunkSize<T>(grain);
+    const size_t threads = static_cast<size_t>(exec.ThreadCount()) + 1;
+    if (size <= chunk || threads == 1 || size > ~size_t(0) / 2 / sizeof(T))
+    {
+        Sort(span, comp);
+        return;
+    }
+
+    // about two runs per thread, so the sorts balance and the merges are few
+    const size_t run = Max(chunk, (size + 2 * threads - 1) / (2 * threads));
+    size_t splitCount = 0;
+    for (size_t width = run; width < size; width *= 2)
+    {
+        const size_t count =
+            detail::parallel::MergeChunkCount(size, width, chunk);
+        splitCount = Max(splitCount, count);
+    }
+
+    using AllocatorTraits = AllocTraits<TAllocator>;
+    T* scratch = AllocatorTraits::template Alloc<T>(alloc, size);
+    if (scratch == nullptr)
+    {
+        Sort(span, comp);
+        return;
+    }
+
+    size_t* splits =
+        AllocatorTraits::template Alloc<size_t>(alloc, splitCount);
+    if (splits == nullptr)
+    {
+        AllocatorTraits::Free(alloc, scratch, size);
+        Sort(span, comp);
+        return;
+    }
+
+    T* data = span.Data();
+    detail::parallel::ForChunks(exec,
+                                (size + run - 1) / run,
+                                [=, &comp](size_t index) noexcept
+                                {
+                                    const size_t begin = index * run;
+                                    const size_t end = Min(begin + run, size);
+                                    Sort(data + begin, data + end, comp);
+                                    for (size_t i = begin; i != end; ++i)
+                                    {
+                                        ::new (static_cast<void*>(scratch + i))
+                                            T(Move(data[i]));
+                                    }
+                                });
+
+    T* from = scratch;
+    T* to = data;
+    for (size_t width = run; width < size; width *= 2)
+    {
+        detail::parallel::MergePass(exec,
+                                    from,
+                                    to,
+                                    size,
+                                    width,
+                                    chunk,
+                                    splits,
+                                    comp);
+        Swap(from, to);
+    }
+
+    detail::parallel::ForChunks(exec,
+                                (size + chunk - 1) / chunk,
+                                [=](size_t index) noexcept
+                                {
+                                    const size_t begin = index * chunk;
+                                    const size_t end = Min(begin + chunk, size);
+                                    for (size_t i = begin; i != end; ++i)
+                                    {
+                                        if (from != data)
+                                        {
+                                            data[i] = Move(scratch[i]);
+                                        }
+
+                                        scratch[i].~T();
+                                    }
+                                });
+
+    AllocatorTraits::Free(alloc, splits, splitCount);
+    AllocatorTraits::Free(alloc, scratch, size);
+}
+
+} // namespace rad
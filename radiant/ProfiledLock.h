@@ -0,0 +1,304 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/SpinLocks.h"
+#include "radiant/Trace.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/detail/Bits.h"
+
+#include <stdint.h>
+
+#if RAD_USER_MODE
+
+namespace rad
+{
+
+/// @brief Contention statistics of a ProfiledLock at one point in time.
+/// @details Times are in TraceTimestamp() ticks. Histogram bucket 0 counts
+/// zero tick durations, bucket N durations of 2^(N-1) up to 2^N ticks, and
+/// the last bucket everything longer.
+struct LockProfile
+{
+    /// @brief Number of histogram buckets.
+    static constexpr uint32_t BucketCount = 32;
+
+    /// @brief Returns the histogram bucket a duration falls in.
+    /// @param ticks Duration in TraceTimestamp() ticks.
+    /// @return Index of the bucket.
+    static uint32_t Bucket(uint64_t ticks) noexcept
+    {
+        if (ticks == 0)
+        {
+            return 0;
+        }
+
+        const uint32_t bucket = 64 - detail::BitLeadingZeros(ticks);
+        return bucket < BucketCount ? bucket : BucketCount - 1;
+    }
+
+    /// @brief Number of times the lock was acquired, exclusive or shared.
+    uint64_t acquisitions;
+
+    /// @brief Number of acquisitions that were shared.
+    uint64_t sharedAcquisitions;
+
+    /// @brief Number of acquisitions that found the lock unavailable.
+    uint64_t contended;
+
+    /// @brief Number of times contended acquisitions retried the lock before
+    /// getting it or blocking on it.
+    uint64_t spins;
+
+    /// @brief Total ticks spent waiting for the lock.
+    uint64_t waitTicks;
+
+    /// @brief Total ticks the lock was held exclusively.
+    uint64_t holdTicks;
+
+    /// @brief Acquisitions by time spent waiting for the lock.
+    uint64_t waitHistogram[BucketCount];
+
+    /// @brief Exclusive acquisitions by time the lock was held.
+    uint64_t holdHistogram[BucketCount];
+};
+
+namespace detail
+{
+
+template <typename T, typename = void>
+struct HasTryLockExclusive : FalseType
+{
+};
+
+template <typename T>
+struct HasTryLockExclusive<
+    T,
+    meta::VoidT<decltype(DeclVal<T&>().TryLockExclusive())>> : TrueType
+{
+};
+
+template <typename T, typename = void>
+struct HasTryLockShared : FalseType
+{
+};
+
+template <typename T>
+struct HasTryLockShared<T,
+                        meta::VoidT<decltype(DeclVal<T&>().TryLockShared())>>
+    : TrueType
+{
+};
+
+} // namespace detail
+
+/// @brief Lock adapter recording how contended the lock it wraps is.
+/// @details Implements the interface expected by the guards in Locks.h by
+/// forwarding to a TLock, and counts acquisitions along with histograms of
+/// the time spent waiting for the lock and holding it exclusively. Shared
+/// holds are counted but not timed, as concurrent readers have no single
+/// acquisition time to measure from.
+///
+/// When TLock has TryLockExclusive() (or TryLockShared() for shared
+/// acquisitions), like the locks in SpinLocks.h, an acquisition first tries
+/// the lock and counts as contended if that fails. It then retries with
+/// exponential backoff, counting each retry as a spin, before blocking in
+/// the wrapped lock. The retries may let a contended acquisition overtake
+/// waiters of a fair lock. Without a try operation acquisitions are timed
+/// but neither contention nor spins can be observed.
+///
+/// Counters are updated with relaxed atomics, so Snapshot() may observe a
+/// subset of the acquisitions concurrent with it.
+template <typename TLock>
+class ProfiledLock final
+{
+public:
+
+    using LockType = TLock;
+
+    RAD_NOT_COPYABLE(ProfiledLock);
+
+    ProfiledLock() = default;
+
+    void LockExclusive() noexcept
+    {
+        RAD_S_ASSERT_NOTHROW(noexcept(m_lock.LockExclusive()));
+
+        LockImpl(detail::HasTryLockExclusive<TLock>{}, ExclusiveMode{});
+        m_heldSince = TraceTimestamp();
+    }
+
+    void LockShared() noexcept
+    {
+        RAD_S_ASSERT_NOTHROW(noexcept(m_lock.LockShared()));
+
+        LockImpl(detail::HasTryLockShared<TLock>{}, SharedMode{});
+        m_sharedAcquisitions.FetchAdd(1, MemOrderRelaxed);
+    }
+
+    void Unlock() noexcept
+    {
+        RAD_S_ASSERT_NOTHROW(noexcept(m_lock.Unlock()));
+
+        // only an exclusive holder sets the timestamp, and it cannot be
+        // changed while the caller holds the lock in either mode
+        const uint64_t heldSince = m_heldSince;
+        if (heldSince != 0)
+        {
+            m_heldSince = 0;
+            const uint64_t held = TraceTimestamp() - heldSince;
+            m_holdTicks.FetchAdd(held, MemOrderRelaxed);
+            m_holdHistogram[LockProfile::Bucket(held)].FetchAdd(
+                1,
+                MemOrderRelaxed);
+        }
+
+        m_lock.Unlock();
+    }
+
+    /// @brief Returns the wrapped lock.
+    TLock& Wrapped() noexcept
+    {
+        return m_lock;
+    }
+
+    /// @brief Copies out the statistics recorded so far.
+    LockProfile Snapshot() const noexcept
+    {
+        LockProfile profile;
+        profile.acquisitions = m_acquisitions.Load(MemOrderRelaxed);
+        profile.sharedAcquisitions = m_sharedAcquisitions.Load(MemOrderRelaxed);
+        profile.contended = m_contended.Load(MemOrderRelaxed);
+        profile.spins = m_spins.Load(MemOrderRelaxed);
+        profile.waitTicks = m_waitTicks.Load(MemOrderRelaxed);
+        profile.holdTicks = m_holdTicks.Load(MemOrderRelaxed);
+        for (uint32_t i = 0; i < LockProfile::BucketCount; ++i)
+        {
+            profile.waitHistogram[i] = m_waitHistogram[i].Load(MemOrderRelaxed);
+            profile.holdHistogram[i] = m_holdHistogram[i].Load(MemOrderRelaxed);
+        }
+
+        return profile;
+    }
+
+    /// @brief Clears the statistics. Acquisitions concurrent with the reset
+    /// may be partially recorded.
+    void Reset() noexcept
+    {
+        m_acquisitions.Store(0, MemOrderRelaxed);
+        m_sharedAcquisitions.Store(0, MemOrderRelaxed);
+        m_contended.Store(0, MemOrderRelaxed);
+        m_spins.Store(0, MemOrderRelaxed);
+        m_waitTicks.Store(0, MemOrderRelaxed);
+        m_holdTicks.Store(0, MemOrderRelaxed);
+        for (uint32_t i = 0; i < LockProfile::BucketCount; ++i)
+        {
+            m_waitHistogram[i].Store(0, MemOrderRelaxed);
+            m_holdHistogram[i].Store(0, MemOrderRelaxed);
+        }
+    }
+
+private:
+
+    struct ExclusiveMode
+    {
+        static bool Try(TLock& lock) noexcept
+        {
+            return lock.TryLockExclusive();
+        }
+
+        static void Lock(TLock& lock) noexcept
+        {
+            lock.LockExclusive();
+        }
+    };
+
+    struct SharedMode
+    {
+        static bool Try(TLock& lock) noexcept
+        {
+            return lock.TryLockShared();
+        }
+
+        static void Lock(TLock& lock) noexcept
+        {
+            lock.LockShared();
+        }
+    };
+
+    template <typename TMode>
+    void LockImpl(TrueType, TMode) noexcept
+    {
+        m_acquisitions.FetchAdd(1, MemOrderRelaxed);
+        if RAD_LIKELY (TMode::Try(m_lock))
+        {
+            m_waitHistogram[0].FetchAdd(1, MemOrderRelaxed);
+            return;
+        }
+
+        const uint64_t begin = TraceTimestamp();
+        m_contended.FetchAdd(1, MemOrderRelaxed);
+
+        detail::SpinBackoff backoff;
+        uint64_t spins = 0;
+        bool acquired = false;
+        while (!acquired && backoff.Pause())
+        {
+            ++spins;
+            acquired = TMode::Try(m_lock);
+        }
+
+        if (!acquired)
+        {
+            TMode::Lock(m_lock);
+        }
+
+        m_spins.FetchAdd(spins, MemOrderRelaxed);
+        RecordWait(TraceTimestamp() - begin);
+    }
+
+    template <typename TMode>
+    void LockImpl(FalseType, TMode) noexcept
+    {
+        m_acquisitions.FetchAdd(1, MemOrderRelaxed);
+        const uint64_t begin = TraceTimestamp();
+        TMode::Lock(m_lock);
+        RecordWait(TraceTimestamp() - begin);
+    }
+
+    void RecordWait(uint64_t ticks) noexcept
+    {
+        m_waitTicks.FetchAdd(ticks, MemOrderRelaxed);
+        m_waitHistogram[LockProfile::Bucket(ticks)].FetchAdd(1,
+                                                             MemOrderRelaxed);
+    }
+
+    TLock m_lock;
+    uint64_t m_heldSince = 0;
+    Atomic<uint64_t> m_acquisitions{ 0 };
+    Atomic<uint64_t> m_sharedAcquisitions{ 0 };
+    Atomic<uint64_t> m_contended{ 0 };
+    Atomic<uint64_t> m_spins{ 0 };
+    Atomic<uint64_t> m_waitTicks{ 0 };
+    Atomic<uint64_t> m_holdTicks{ 0 };
+    Atomic<uint64_t> m_waitHistogram[LockProfile::BucketCount] = {};
+    Atomic<uint64_t> m_holdHistogram[LockProfile::BucketCount] = {};
+};
+
+} // namespace rad
+
+#endif // RAD_USER_MODE
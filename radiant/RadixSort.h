@@ -0,0 +1,474 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Algorithm.h"
+#include "radiant/Byte.h"
+#include "radiant/Integer.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/Span.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace rad
+{
+
+namespace detail
+{
+namespace radix
+{
+
+// Below this size ranges are insertion sorted by key.
+static constexpr uint32_t InsertionSortThreshold = 64;
+
+// Levels of byte distribution before RadixSortBytes falls back to a
+// comparison sort of the remaining suffixes, bounding its stack use.
+static constexpr int MaxByteLevels = 16;
+
+struct Identity
+{
+    template <typename T>
+    constexpr const T& operator()(const T& value) const noexcept
+    {
+        return value;
+    }
+};
+
+template <typename T>
+RAD_INLINE_VAR constexpr bool IsRelocatableByCopy =
+    IsTrivCopyCtor<T> && IsTrivCopyAssign<T> && IsTrivDtor<T>;
+
+// Maps a key to an unsigned integer with the same ordering.
+template <typename T, typename = void>
+struct KeyTraits;
+
+template <typename T>
+struct KeyTraits<T, EnIf<IsIntegral<T>>>
+{
+    RAD_S_ASSERTMSG((!IsSame<T, bool>), "RadixSort does not sort bool keys");
+
+    using UnsignedType = MakeUnsigned<T>;
+
+    static constexpr UnsignedType Bits(T value) noexcept
+    {
+        // flipping the sign bit orders negative values before positive ones
+        return IsSigned<T>
+                   ? static_cast<UnsignedType>(
+                         static_cast<UnsignedType>(value) ^
+                         (UnsignedType(1) << (sizeof(T) * 8 - 1)))
+                   : static_cast<UnsignedType>(value);
+    }
+};
+
+template <typename T>
+struct KeyTraits<Integer<T>>
+{
+    using UnsignedType = typename KeyTraits<T>::UnsignedType;
+
+    static constexpr UnsignedType Bits(const Integer<T>& value) noexcept
+    {
+        return KeyTraits<T>::Bits(static_cast<T>(value));
+    }
+};
+
+template <typename T, typename TKeyFn>
+using KeyOf = RemoveCVRef<decltype(DeclVal<TKeyFn&>()(DeclVal<const T&>()))>;
+
+template <typename T, typename TKeyFn>
+struct IntegralKeyLess
+{
+    bool operator()(const T& a, const T& b) const noexcept
+    {
+        using Traits = KeyTraits<KeyOf<T, TKeyFn>>;
+        return Traits::Bits(key(a)) < Traits::Bits(key(b));
+    }
+
+    TKeyFn& key;
+};
+
+// Histogram of the byte at shift in every key.
+template <typename T, typename TKeyFn>
+void CountDigit(const T* data,
+                uint32_t size,
+                uint32_t shift,
+                TKeyFn& key,
+                uint32_t* counts)
+{
+    using Traits = KeyTraits<KeyOf<T, TKeyFn>>;
+
+    memset(counts, 0, 256 * sizeof(uint32_t));
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        ++counts[(Traits::Bits(key(data[i])) >> shift) & 0xff];
+    }
+}
+
+// Least significant digit first, one byte per pass. The histogram of the next
+// digit is gathered while scattering the current one, so only two histograms
+// live on the stack whatever the key width, and passes whose digit is the
+// same for every element are skipped.
+template <typename T, typename TKeyFn>
+void LsdSort(T* data, T* scratch, uint32_t size, TKeyFn& key)
+{
+    using Traits = KeyTraits<KeyOf<T, TKeyFn>>;
+    using UnsignedType = typename Traits::UnsignedType;
+    static constexpr uint32_t Digits = sizeof(UnsignedType);
+
+    uint32_t histograms[2][256];
+    uint32_t* offsets = histograms[0];
+    uint32_t* next = histograms[1];
+    CountDigit(data, size, 0, key, offsets);
+
+    T* src = data;
+    T* dst = scratch;
+    for (uint32_t digit = 0; digit < Digits; ++digit)
+    {
+        const uint32_t shift = digit * 8;
+        const bool last = digit + 1 == Digits;
+        if (offsets[(Traits::Bits(key(src[0])) >> shift) & 0xff] == size)
+        {
+            if (!last)
+            {
+                CountDigit(src, size, shift + 8, key, offsets);
+            }
+
+            continue;
+        }
+
+        uint32_t sum = 0;
+        for (uint32_t bucket = 0; bucket < 256; ++bucket)
+        {
+            const uint32_t count = offsets[bucket];
+            offsets[bucket] = sum;
+            sum += count;
+        }
+
+        memset(next, 0, 256 * sizeof(uint32_t));
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            const UnsignedType bits = Traits::Bits(key(src[i]));
+            dst[offsets[(bits >> shift) & 0xff]++] = src[i];
+            if (!last)
+            {
+                ++next[(bits >> (shift + 8)) & 0xff];
+            }
+        }
+
+        uint32_t* histogram = offsets;
+        offsets = next;
+        next = histogram;
+
+        T* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != data)
+    {
+        memcpy(static_cast<void*>(data), src, size * sizeof(T));
+    }
+}
+
+// Bucket of a key at a byte position, 0 when the key is shorter.
+inline uint32_t ByteBucket(Span<const Byte> key, size_t depth) noexcept
+{
+    return depth < key.Size()
+               ? 1u + static_cast<uint32_t>(key[static_cast<SpanSizeType>(
+                          depth)])
+               : 0u;
+}
+
+template <typename T, typename TKeyFn>
+struct SuffixLess
+{
+    bool operator()(const T& a, const T& b) const noexcept
+    {
+        const Span<const Byte> left = key(a);
+        const Span<const Byte> right = key(b);
+        const size_t leftSize = left.Size() - depth;
+        const size_t rightSize = right.Size() - depth;
+        const size_t common = leftSize < rightSize ? leftSize : rightSize;
+        const int cmp =
+            common == 0 ? 0 : memcmp(left.Data() + depth,
+                                     right.Data() + depth,
+                                     common);
+        return cmp < 0 || (cmp == 0 && leftSize < rightSize);
+    }
+
+    TKeyFn& key;
+    size_t depth;
+};
+
+// Distributes the elements by the byte at depth through the scratch buffer,
+// returning false without moving them when every key shares that byte. Kept
+// out of line so its histogram is not part of every MsdSort frame.
+template <typename T, typename TKeyFn>
+RAD_NOINLINE bool DistributeByte(
+    T* data, T* scratch, uint32_t size, size_t depth, TKeyFn& key)
+{
+    uint32_t offsets[257] = {};
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        ++offsets[ByteBucket(key(data[i]), depth)];
+    }
+
+    if (offsets[ByteBucket(key(data[0]), depth)] == size)
+    {
+        return false;
+    }
+
+    uint32_t sum = 0;
+    for (uint32_t bucket = 0; bucket < 257; ++bucket)
+    {
+        const uint32_t count = offsets[bucket];
+        offsets[bucket] = sum;
+        sum += count;
+    }
+
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        scratch[offsets[ByteBucket(key(data[i]), depth)]++] = data[i];
+    }
+
+    memcpy(static_cast<void*>(data), scratch, size * sizeof(T));
+    return true;
+}
+
+// Most significant byte first. Every key in [data, data + size) shares its
+// first depth bytes. Each level distributes into the scratch buffer and
+// copies back, so buckets can be sorted independently in place.
+template <typename T, typename TKeyFn>
+void MsdSort(T* data,
+             T* scratch,
+             uint32_t size,
+             size_t depth,
+             int level,
+             TKeyFn& key)
+{
+    while (true)
+    {
+        if (size <= InsertionSortThreshold || level >= MaxByteLevels)
+        {
+            SuffixLess<T, TKeyFn> less{ key, depth };
+            if (size <= InsertionSortThreshold)
+            {
+                sort::InsertionSort(data, data + size, less);
+            }
+            else
+            {
+                sort::StableSortWithBuffer(data, data + size, scratch, less);
+            }
+
+            return;
+        }
+
+        if (!DistributeByte(data, scratch, size, depth, key))
+        {
+            // a shared byte only extends the common prefix
+            if (ByteBucket(key(data[0]), depth) == 0)
+            {
+                return;
+            }
+
+            ++depth;
+            continue;
+        }
+
+        // buckets are now contiguous runs in byte order; keys which ended at
+        // this depth are equal and stay in their original order
+        uint32_t begin = 0;
+        while (begin < size)
+        {
+            const uint32_t bucket = ByteBucket(key(data[begin]), depth);
+            uint32_t end = begin + 1;
+            while (end < size && ByteBucket(key(data[end]), depth) == bucket)
+            {
+                ++end;
+            }
+
+            if (bucket != 0 && end - begin > 1)
+            {
+                MsdSort(data + begin,
+                        scratch + begin,
+                        end - begin,
+                        depth + 1,
+                        level + 1,
+                        key);
+            }
+
+            begin = end;
+        }
+
+        return;
+    }
+}
+
+template <typename T, typename TKeyFn>
+void IntegralSort(T* data, T* scratch, uint32_t size, TKeyFn& key)
+{
+    if (size <= InsertionSortThreshold)
+    {
+        IntegralKeyLess<T, TKeyFn> less{ key };
+        sort::InsertionSort(data, data + size, less);
+    }
+    else
+    {
+        LsdSort(data, scratch, size, key);
+    }
+}
+
+template <typename TAllocator, typename T>
+T* AllocScratch(TAllocator& alloc, uint32_t size)
+{
+    RAD_S_ASSERTMSG(alignof(T) <= alignof(max_align_t),
+                    "RadixSort does not support over-aligned types");
+    return AllocTraits<TAllocator>::template Alloc<T>(alloc, size);
+}
+
+template <typename TAllocator, typename T>
+void FreeScratch(TAllocator& alloc, T* scratch, uint32_t size) noexcept
+{
+    AllocTraits<TAllocator>::Free(alloc, scratch, size);
+}
+
+} // namespace radix
+} // namespace detail
+
+/// @brief Sorts elements by an integral key, keeping equal keys in their
+/// original order.
+/// @details Least significant digit radix sort, one byte of the key per pass.
+/// It runs in O(n * sizeof(key)) time and skips passes over bytes that are
+/// the same in every key, so narrow ranges of wide keys such as timestamps
+/// take few passes. Signed keys order negative values first. Short ranges are
+/// insertion sorted instead. Uses 2 KiB of stack whatever the key width.
+/// @param data Elements to sort. They must be trivially copyable.
+/// @param scratch Buffer of at least data.Size() elements, clobbered.
+/// @param key Function returning the integral or rad::Integer key of an
+/// element, by default the element itself.
+template <typename T,
+          SpanSizeType N,
+          SpanSizeType M,
+          typename TKeyFn = detail::radix::Identity>
+void RadixSort(Span<T, N> data, Span<T, M> scratch, TKeyFn key = TKeyFn())
+{
+    RAD_S_ASSERTMSG(detail::radix::IsRelocatableByCopy<T>,
+                    "RadixSort requires trivially copyable elements");
+    RAD_ASSERT(scratch.Size() >= data.Size());
+    detail::radix::IntegralSort(data.Data(),
+                                scratch.Data(),
+                                data.Size(),
+                                key);
+}
+
+/// @brief Sorts elements by an integral key, using a scratch buffer obtained
+/// from an allocator.
+/// @see RadixSort(Span<T, N>, Span<T, M>, TKeyFn)
+/// @return NoMemory, leaving the elements unchanged, if the scratch buffer
+/// cannot be allocated.
+template <typename TAllocator,
+          typename T,
+          SpanSizeType N,
+          typename TKeyFn = detail::radix::Identity>
+Err RadixSort(TAllocator& alloc, Span<T, N> data, TKeyFn key = TKeyFn())
+{
+    RAD_S_ASSERTMSG(detail::radix::IsRelocatableByCopy<T>,
+                    "RadixSort requires trivially copyable elements");
+    const uint32_t size = data.Size();
+    if (size <= detail::radix::InsertionSortThreshold)
+    {
+        detail::radix::IntegralSort(data.Data(), data.Data(), size, key);
+        return NoError;
+    }
+
+    T* scratch = detail::radix::AllocScratch<TAllocator, T>(alloc, size);
+    if (scratch == nullptr)
+    {
+        return Error::NoMemory;
+    }
+
+    detail::radix::LsdSort(data.Data(), scratch, size, key);
+    detail::radix::FreeScratch(alloc, scratch, size);
+    return NoError;
+}
+
+/// @brief Sorts elements lexicographically by a byte string key, keeping
+/// equal keys in their original order.
+/// @details Most significant byte first radix sort. Each level distributes
+/// the elements by one byte of the key into 257 buckets, the first holding
+/// keys which have ended, and shared prefixes are skipped without
+/// distributing. Short ranges, and ranges still unsorted after 16 levels,
+/// are finished with a comparison sort of the remaining bytes.
+/// @param data Elements to sort. They must be trivially copyable.
+/// @param scratch Buffer of at least data.Size() elements, clobbered.
+/// @param key Function returning the Span<const Byte> key of an element, by
+/// default the element itself.
+template <typename T,
+          SpanSizeType N,
+          SpanSizeType M,
+          typename TKeyFn = detail::radix::Identity>
+void RadixSortBytes(Span<T, N> data, Span<T, M> scratch, TKeyFn key = TKeyFn())
+{
+    RAD_S_ASSERTMSG(detail::radix::IsRelocatableByCopy<T>,
+                    "RadixSortBytes requires trivially copyable elements");
+    RAD_ASSERT(scratch.Size() >= data.Size());
+    if (data.Size() > 1)
+    {
+        detail::radix::MsdSort(data.Data(),
+                               scratch.Data(),
+                               data.Size(),
+                               0,
+                               0,
+                               key);
+    }
+}
+
+/// @brief Sorts elements by a byte string key, using a scratch buffer
+/// obtained from an allocator.
+/// @see RadixSortBytes(Span<T, N>, Span<T, M>, TKeyFn)
+/// @return NoMemory, leaving the elements unchanged, if the scratch buffer
+/// cannot be allocated.
+template <typename TAllocator,
+          typename T,
+          SpanSizeType N,
+          typename TKeyFn = detail::radix::Identity>
+Err RadixSortBytes(TAllocator& alloc, Span<T, N> data, TKeyFn key = TKeyFn())
+{
+    RAD_S_ASSERTMSG(detail::radix::IsRelocatableByCopy<T>,
+                    "RadixSortBytes requires trivially copyable elements");
+    const uint32_t size = data.Size();
+    if (size <= 1)
+    {
+        return NoError;
+    }
+
+    T* scratch = detail::radix::AllocScratch<TAllocator, T>(alloc, size);
+    if (scratch == nullptr)
+    {
+        return Error::NoMemory;
+    }
+
+    detail::radix::MsdSort(data.Data(), scratch, size, 0, 0, key);
+    detail::radix::FreeScratch(alloc, scratch, size);
+    return NoError;
+}
+
+} // namespace rad
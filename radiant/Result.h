@@ -72,6 +72,19 @@ RAD_INLINE_VAR constexpr ResultErrTagType ResultErrTag{};
 /// @brief Result "Empty" tag, indicator for explicit default construction.
 RAD_INLINE_VAR constexpr ResultEmptyTagType ResultEmptyTag{};
 
+/// @brief Opts a class type into packed pointer and reference results.
+/// @details Result<T&, E> and Result<T*, E> keep their state in the low bit
+/// of the pointer when the objects of T are known to be at least 2-byte
+/// aligned. That is known for scalar types. Class types must opt in by
+/// specializing this as TrueType, as their alignment cannot be asked for
+/// while they are incomplete. The specialization must be visible wherever
+/// such a result is used. Storing a misaligned pointer fails fast.
+/// @tparam T Type referred to, without cv-qualifiers.
+template <typename T>
+struct ResultPackPointee : FalseType
+{
+};
+
 namespace detail
 {
 
@@ -151,6 +164,38 @@ struct ResultStorage<T, E, true>
         m_state = ResultState::Empty;
     }
 
+    template <typename U>
+    constexpr void AssignOk(U&& value) noexcept(
+        noexcept(DeclVal<OkWrap&>() = Forward<U>(value)))
+    {
+        m_ok = Forward<U>(value);
+    }
+
+    constexpr ResultState GetState() const noexcept
+    {
+        return m_state;
+    }
+
+    constexpr OkWrap& OkValue() noexcept
+    {
+        return m_ok;
+    }
+
+    constexpr const OkWrap& OkValue() const noexcept
+    {
+        return m_ok;
+    }
+
+    constexpr ErrWrap& ErrValue() noexcept
+    {
+        return m_err;
+    }
+
+    constexpr const ErrWrap& ErrValue() const noexcept
+    {
+        return m_err;
+    }
+
     ResultState m_state;
 
     union
@@ -251,6 +296,38 @@ struct ResultStorage<T, E, false>
         }
     }
 
+    template <typename U>
+    constexpr void AssignOk(U&& value) noexcept(
+        noexcept(DeclVal<OkWrap&>() = Forward<U>(value)))
+    {
+        m_ok = Forward<U>(value);
+    }
+
+    constexpr ResultState GetState() const noexcept
+    {
+        return m_state;
+    }
+
+    constexpr OkWrap& OkValue() noexcept
+    {
+        return m_ok;
+    }
+
+    constexpr const OkWrap& OkValue() const noexcept
+    {
+        return m_ok;
+    }
+
+    constexpr ErrWrap& ErrValue() noexcept
+    {
+        return m_err;
+    }
+
+    constexpr const ErrWrap& ErrValue() const noexcept
+    {
+        return m_err;
+    }
+
     ResultState m_state;
 
     union
@@ -260,6 +337,317 @@ struct ResultStorage<T, E, false>
     };
 };
 
+// The niche layout needs the low byte of a pointer at the lowest address.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define RAD_RESULT_NICHE 0
+#else
+#define RAD_RESULT_NICHE 1
+#endif
+
+template <typename T, bool = is_scalar<T>::value>
+struct ResultPointeeAlign : IntegralConstant<size_t, alignof(T)>
+{
+};
+
+// a class type may be incomplete here, so its alignment is never asked for
+template <typename T>
+struct ResultPointeeAlign<T, false>
+    : IntegralConstant<size_t, ResultPackPointee<RemoveCV<T>>::value ? 2 : 1>
+{
+};
+
+/// @brief Internal use only. Guaranteed alignment of the objects a reference
+/// or pointer "Ok" type refers to, or 1 when it is not known.
+template <typename T>
+struct ResultNicheAlign : IntegralConstant<size_t, 1>
+{
+};
+
+template <typename T>
+struct ResultNicheAlign<T&> : ResultPointeeAlign<T>
+{
+};
+
+template <typename T>
+struct ResultNicheAlign<T*> : ResultPointeeAlign<T>
+{
+};
+
+/// @brief Internal use only. Whether a result can use ResultNicheStorage.
+template <typename T, typename E>
+struct ResultHasNiche
+    : IntegralConstant<bool,
+                       RAD_RESULT_NICHE && (ResultNicheAlign<T>::value >= 2) &&
+                           IsTrivCopyCtor<E> && IsTrivDtor<E> &&
+                           (alignof(E) + sizeof(E) <= sizeof(void*)) &&
+                           (alignof(E) <= alignof(void*))>
+{
+};
+
+/// @brief Result storage specialization packing the state into a pointer.
+/// @details Used for reference and pointer "Ok" types whose objects are
+/// known to be at least 2-byte aligned, see ResultPackPointee, with a small
+/// trivial "Err" type such as rad::Error, making the result a single
+/// trivially copyable word that is returned in a register. An "Ok" pointer
+/// has its low bit clear. The other states set the low bit of the first byte
+/// and keep the "Err" value in the bytes after it. Storing a misaligned "Ok"
+/// pointer fails fast rather than corrupting the state, and pointers written
+/// through Ok() must stay aligned.
+/// @tparam T "Ok" type.
+/// @tparam E "Err" type.
+template <typename T, typename E>
+struct ResultNicheStorage
+{
+    using OkWrap = TypeWrapper<T>;
+    using ErrWrap = TypeWrapper<E>;
+    using OkType = T;
+    using ErrType = E;
+
+    RAD_S_ASSERT(sizeof(OkWrap) == sizeof(uintptr_t));
+
+    ~ResultNicheStorage() noexcept = default;
+
+    ResultNicheStorage() noexcept
+        : m_raw(EmptyTag)
+    {
+    }
+
+    ResultNicheStorage(ResultEmptyTagType) noexcept
+        : ResultNicheStorage()
+    {
+    }
+
+    template <typename... TArgs>
+    ResultNicheStorage(ResultOkTagType, TArgs&&... args) noexcept(
+        IsNoThrowCtor<OkWrap, TArgs&&...>)
+        : m_ok(Forward<TArgs>(args)...)
+    {
+        RAD_S_ASSERT_NOTHROW((IsNoThrowCtor<OkWrap, TArgs&&...>));
+        VerifyOk();
+    }
+
+    template <typename... TArgs>
+    ResultNicheStorage(ResultErrTagType, TArgs&&... args) noexcept(
+        IsNoThrowCtor<ErrWrap, TArgs&&...>)
+        : m_raw(0)
+    {
+        RAD_S_ASSERT_NOTHROW((IsNoThrowCtor<ErrWrap, TArgs&&...>));
+
+        Construct(ResultErrTag, Forward<TArgs>(args)...);
+    }
+
+    void Construct(ResultEmptyTagType) noexcept
+    {
+        m_raw = EmptyTag;
+    }
+
+    template <typename... TArgs>
+    void Construct(ResultOkTagType, TArgs&&... args) noexcept(
+        IsNoThrowCtor<OkWrap, TArgs&&...>)
+    {
+        RAD_S_ASSERT_NOTHROW((IsNoThrowCtor<OkWrap, TArgs&&...>));
+
+        new (&m_ok) OkWrap(Forward<TArgs>(args)...);
+        VerifyOk();
+    }
+
+    template <typename... TArgs>
+    void Construct(ResultErrTagType, TArgs&&... args) noexcept(
+        IsNoThrowCtor<ErrWrap, TArgs&&...>)
+    {
+        RAD_S_ASSERT_NOTHROW((IsNoThrowCtor<ErrWrap, TArgs&&...>));
+
+        m_errBox.m_tag = ErrantTag;
+        new (&m_errBox.m_err) ErrWrap(Forward<TArgs>(args)...);
+    }
+
+    void Destruct() noexcept
+    {
+        m_raw = EmptyTag;
+    }
+
+    template <typename U>
+    void AssignOk(U&& value) noexcept(
+        noexcept(DeclVal<OkWrap&>() = Forward<U>(value)))
+    {
+        m_ok = Forward<U>(value);
+        VerifyOk();
+    }
+
+    // an odd pointer would read back as another state
+    void VerifyOk() const noexcept
+    {
+        RAD_FAST_FAIL((m_raw & 1) == 0);
+    }
+
+    ResultState GetState() const noexcept
+    {
+        // the low byte of the pointer, or the tag
+        const uint8_t tag =
+            *static_cast<const uint8_t*>(static_cast<const void*>(this));
+        if ((tag & 1) == 0)
+        {
+            return ResultState::Valid;
+        }
+
+        return tag == ErrantTag ? ResultState::Errant : ResultState::Empty;
+    }
+
+    OkWrap& OkValue() noexcept
+    {
+        return m_ok;
+    }
+
+    const OkWrap& OkValue() const noexcept
+    {
+        return m_ok;
+    }
+
+    ErrWrap& ErrValue() noexcept
+    {
+        return m_errBox.m_err;
+    }
+
+    const ErrWrap& ErrValue() const noexcept
+    {
+        return m_errBox.m_err;
+    }
+
+    static constexpr uint8_t EmptyTag = 1;
+    static constexpr uint8_t ErrantTag = 3;
+
+    struct ErrBox
+    {
+        uint8_t m_tag;
+        ErrWrap m_err;
+    };
+
+    union
+    {
+        OkWrap m_ok;
+        ErrBox m_errBox;
+        uintptr_t m_raw;
+    };
+};
+
+/// @brief Internal use only. Copies and moves ResultStorage according to the
+/// state of the source, leaving moved from storage empty.
+/// @tparam T "Ok" type.
+/// @tparam E "Err" type.
+template <typename T, typename E>
+struct ResultCopyStorage : ResultStorage<T, E>
+{
+    using BaseType = ResultStorage<T, E>;
+    using typename BaseType::OkWrap;
+    using typename BaseType::ErrWrap;
+
+    using BaseType::BaseType;
+
+    ~ResultCopyStorage() = default;
+
+    constexpr ResultCopyStorage() noexcept = default;
+
+    constexpr ResultCopyStorage(const ResultCopyStorage& r) noexcept(
+        IsNoThrowCtor<OkWrap, const OkWrap&> &&
+        IsNoThrowCtor<ErrWrap, const ErrWrap&>)
+        : BaseType()
+    {
+        CopyFrom(r);
+    }
+
+    constexpr ResultCopyStorage(ResultCopyStorage&& r) noexcept(
+        IsNoThrowCtor<OkWrap, OkWrap&&> && IsNoThrowCtor<ErrWrap, ErrWrap&&>)
+        : BaseType()
+    {
+        MoveFrom(r);
+    }
+
+    constexpr ResultCopyStorage& operator=(const ResultCopyStorage& r) noexcept(
+        IsNoThrowCtor<OkWrap, const OkWrap&> &&
+        IsNoThrowCtor<ErrWrap, const ErrWrap&> &&
+        noexcept(DeclVal<OkWrap&>() = DeclVal<const OkWrap&>()) &&
+        noexcept(DeclVal<ErrWrap&>() = DeclVal<const ErrWrap&>()))
+    {
+        if (this->GetState() != r.GetState())
+        {
+            this->Destruct();
+            CopyFrom(r);
+        }
+        else if (this->GetState() == ResultState::Valid)
+        {
+            this->OkValue() = r.OkValue();
+        }
+        else if (this->GetState() == ResultState::Errant)
+        {
+            this->ErrValue() = r.ErrValue();
+        }
+
+        return *this;
+    }
+
+    constexpr ResultCopyStorage& operator=(ResultCopyStorage&& r) noexcept(
+        IsNoThrowCtor<OkWrap, OkWrap&&> && IsNoThrowCtor<ErrWrap, ErrWrap&&> &&
+        noexcept(DeclVal<OkWrap&>() = DeclVal<OkWrap&&>().Get()) &&
+        noexcept(DeclVal<ErrWrap&>() = DeclVal<ErrWrap&&>().Get()))
+    {
+        if (this->GetState() != r.GetState())
+        {
+            this->Destruct();
+            MoveFrom(r);
+            return *this;
+        }
+
+        if (this->GetState() == ResultState::Valid)
+        {
+            this->OkValue() = Move(r.OkValue()).Get();
+        }
+        else if (this->GetState() == ResultState::Errant)
+        {
+            this->ErrValue() = Move(r.ErrValue()).Get();
+        }
+
+        r.Destruct();
+        return *this;
+    }
+
+private:
+
+    constexpr void CopyFrom(const ResultCopyStorage& r) noexcept(
+        IsNoThrowCtor<OkWrap, const OkWrap&> &&
+        IsNoThrowCtor<ErrWrap, const ErrWrap&>)
+    {
+        if (r.GetState() == ResultState::Valid)
+        {
+            this->Construct(ResultOkTag, r.OkValue());
+        }
+        else if (r.GetState() == ResultState::Errant)
+        {
+            this->Construct(ResultErrTag, r.ErrValue());
+        }
+    }
+
+    constexpr void MoveFrom(ResultCopyStorage& r) noexcept(
+        IsNoThrowCtor<OkWrap, OkWrap&&> && IsNoThrowCtor<ErrWrap, ErrWrap&&>)
+    {
+        if (r.GetState() == ResultState::Valid)
+        {
+            this->Construct(ResultOkTag, Move(r.OkValue()));
+        }
+        else if (r.GetState() == ResultState::Errant)
+        {
+            this->Construct(ResultErrTag, Move(r.ErrValue()));
+        }
+
+        r.Destruct();
+    }
+};
+
+// The niche storage is trivially copyable, so results using it are too.
+template <typename T, typename E>
+using ResultStorageType = Cond<ResultHasNiche<T, E>::value,
+                               ResultNicheStorage<T, E>,
+                               ResultCopyStorage<T, E>>;
+
 template <typename T, ResultState State>
 struct ResultTypeWrapper : public TypeWrapper<T>
 {
@@ -323,11 +711,11 @@ using ResultErr = detail::ResultTypeWrapper<E, ResultState::Errant>;
 /// }
 /// @endcode
 template <typename T, typename E>
-class RAD_NODISCARD Result final : private detail::ResultStorage<T, E>
+class RAD_NODISCARD Result final : private detail::ResultStorageType<T, E>
 {
 public:
 
-    using StorageType = detail::ResultStorage<T, E>;
+    using StorageType = detail::ResultStorageType<T, E>;
     using ThisType = Result<T, E>;
     using typename StorageType::OkType;
     using typename StorageType::ErrType;
@@ -475,26 +863,14 @@ public:
             (IsNoThrowCtor<StorageType, ResultErrTagType, ResultErr<U>&&>));
     }
 
-    // Copy/Move ctors
-    constexpr Result(const Result& r) noexcept(
-        noexcept(DeclVal<Result*>()->CopyCtor(DeclVal<const Result&>())))
-        : StorageType()
-    {
-        RAD_S_ASSERT_NOTHROW(noexcept(CopyCtor(r)));
-        CopyCtor(r);
-    }
-
-    constexpr Result(Result&& r) noexcept(
-        noexcept(DeclVal<Result*>()->MoveCtor(DeclVal<Result&&>())))
-        : StorageType()
-    {
-        RAD_S_ASSERT_NOTHROW(noexcept(MoveCtor(r)));
-        MoveCtor(r);
-    }
+    // Copy/Move ctors, trivial when the storage is
+    constexpr Result(const Result&) = default;
+    constexpr Result(Result&&) = default;
 
     template <typename O,
               typename F,
-              EnIf<(IsCtor<OkType, O> || IsLRefBindable<OkType, O>) &&
+              EnIf<!IsSame<Result<O, F>, Result> &&
+                       (IsCtor<OkType, O> || IsLRefBindable<OkType, O>) &&
                        (IsCtor<ErrType, F> || IsLRefBindable<ErrType, F>),
                    int> = 0>
     constexpr Result(Result<O, F>& r) noexcept(
@@ -529,32 +905,28 @@ public:
     }
 
     // Assignment
-    Result& Assign(const Result& r) noexcept(
-        noexcept(DeclVal<Result*>()->Copy(r)))
+    Result& Assign(const Result& r) noexcept(IsNoThrowCopyAssign<StorageType>)
     {
-        RAD_S_ASSERT_NOTHROW(noexcept(Copy(r)));
-        Copy(r);
-        return *this;
+        RAD_S_ASSERT_NOTHROW(IsNoThrowCopyAssign<StorageType>);
+        return *this = r;
     }
 
-    Result& Assign(Result&& r) noexcept(
-        noexcept(DeclVal<Result*>()->MoveAssign(Forward<Result>(r))))
+    Result& Assign(Result&& r) noexcept(IsNoThrowMoveAssign<StorageType>)
     {
-        RAD_S_ASSERT_NOTHROW(noexcept(MoveAssign(Forward<Result>(r))));
-        MoveAssign(Forward<Result>(r));
-        return *this;
+        RAD_S_ASSERT_NOTHROW(IsNoThrowMoveAssign<StorageType>);
+        return *this = Move(r);
     }
 
     template <typename U = OkType, EnIf<!IsRelated<U, ErrType>, int> = 0>
     constexpr Result& Assign(const OkType& r) noexcept(
-        noexcept(DeclVal<Result*>()->m_ok = r) && //
+        noexcept(DeclVal<Result*>()->OkValue() = r) && //
         noexcept(DeclVal<Result*>()->Construct(ResultOkTag, r)))
     {
-        RAD_S_ASSERT_NOTHROW(noexcept(this->m_ok = r) &&
+        RAD_S_ASSERT_NOTHROW(noexcept(this->OkValue() = r) &&
                              noexcept(Construct(ResultOkTag, r)));
         if (IsOk())
         {
-            this->m_ok = r;
+            this->AssignOk(r);
         }
         else
         {
@@ -567,16 +939,16 @@ public:
     template <typename U = OkType,
               EnIf<!IsRef<U> && !IsRelated<U, ErrType>, int> = 0>
     constexpr Result& Assign(OkType&& r) noexcept(
-        noexcept(DeclVal<Result*>()->m_ok = Forward<OkType>(r)) && //
+        noexcept(DeclVal<Result*>()->OkValue() = Forward<OkType>(r)) && //
         noexcept(DeclVal<Result*>()->Construct(ResultOkTag,
                                                Forward<OkType>(r))))
     {
         RAD_S_ASSERT_NOTHROW(
-            noexcept(this->m_ok = Forward<OkType>(r)) &&
+            noexcept(this->OkValue() = Forward<OkType>(r)) &&
             noexcept(Construct(ResultOkTag, Forward<OkType>(r))));
         if (IsOk())
         {
-            this->m_ok = Forward<OkType>(r);
+            this->AssignOk(Forward<OkType>(r));
         }
         else
         {
@@ -588,14 +960,14 @@ public:
 
     template <typename U = ErrType, EnIf<!IsRelated<OkType, U>, int> = 0>
     constexpr Result& Assign(const ErrType& r) noexcept(
-        noexcept(DeclVal<Result*>()->m_err = r) && //
+        noexcept(DeclVal<Result*>()->ErrValue() = r) && //
         noexcept(DeclVal<Result*>()->Construct(ResultErrTag, r)))
     {
-        RAD_S_ASSERT_NOTHROW(noexcept(this->m_err = r) &&
+        RAD_S_ASSERT_NOTHROW(noexcept(this->ErrValue() = r) &&
                              noexcept(Construct(ResultErrTag, r)));
         if (IsErr())
         {
-            this->m_err = r;
+            this->ErrValue() = r;
         }
         else
         {
@@ -608,16 +980,16 @@ public:
     template <typename U = ErrType,
               EnIf<!IsRef<U> && !IsRelated<OkType, U>, int> = 0>
     constexpr Result& Assign(ErrType&& r) noexcept(
-        noexcept(DeclVal<Result*>()->m_err = Forward<ErrType>(r)) && //
+        noexcept(DeclVal<Result*>()->ErrValue() = Forward<ErrType>(r)) && //
         noexcept(DeclVal<Result*>()->Construct(ResultErrTag,
                                                Forward<ErrType>(r))))
     {
         RAD_S_ASSERT_NOTHROW(
-            noexcept(this->m_err = Forward<ErrType>(r)) &&
+            noexcept(this->ErrValue() = Forward<ErrType>(r)) &&
             noexcept(Construct(ResultErrTag, Forward<ErrType>(r))));
         if (IsErr())
         {
-            this->m_err = Forward<ErrType>(r);
+            this->ErrValue() = Forward<ErrType>(r);
         }
         else
         {
@@ -629,14 +1001,14 @@ public:
 
     template <typename U>
     constexpr Result& Assign(const ResultOk<U>& r) noexcept(
-        noexcept(DeclVal<Result*>()->m_ok = r.Get()) && //
+        noexcept(DeclVal<Result*>()->OkValue() = r.Get()) && //
         noexcept(DeclVal<Result*>()->Construct(ResultOkTag, r.Get())))
     {
-        RAD_S_ASSERT_NOTHROW(noexcept(this->m_ok = r.Get()) &&
+        RAD_S_ASSERT_NOTHROW(noexcept(this->OkValue() = r.Get()) &&
                              noexcept(Construct(ResultOkTag, r.Get())));
         if (IsOk())
         {
-            this->m_ok = r.Get();
+            this->AssignOk(r.Get());
         }
         else
         {
@@ -648,18 +1020,18 @@ public:
 
     template <typename U>
     constexpr Result& Assign(ResultOk<U>&& r) noexcept(
-        noexcept(DeclVal<Result*>()->m_ok = Forward<ResultOk<U>>(r).Get()) && //
+        noexcept(DeclVal<Result*>()->OkValue() = Forward<ResultOk<U>>(r).Get()) && //
         noexcept(DeclVal<Result*>()->Construct(ResultOkTag,
                                                Forward<ResultOk<U>>(r).Get())))
     {
         // clang-format off
         RAD_S_ASSERT_NOTHROW(
-            noexcept(this->m_ok = Forward<ResultOk<U>>(r) .Get()) &&
+            noexcept(this->OkValue() = Forward<ResultOk<U>>(r) .Get()) &&
             noexcept(Construct(ResultOkTag, Forward<ResultOk<U>>(r).Get())));
         // clang-format on
         if (IsOk())
         {
-            this->m_ok = Forward<ResultOk<U>>(r).Get();
+            this->AssignOk(Forward<ResultOk<U>>(r).Get());
         }
         else
         {
@@ -671,14 +1043,14 @@ public:
 
     template <typename U = ErrType>
     constexpr Result& Assign(const ResultErr<U>& r) noexcept(
-        noexcept(DeclVal<Result*>()->m_err = r.Get()) && //
+        noexcept(DeclVal<Result*>()->ErrValue() = r.Get()) && //
         noexcept(DeclVal<Result*>()->Construct(ResultErrTag, r.Get())))
     {
-        RAD_S_ASSERT_NOTHROW(noexcept(this->m_err = r.Get()) &&
+        RAD_S_ASSERT_NOTHROW(noexcept(this->ErrValue() = r.Get()) &&
                              noexcept(Construct(ResultErrTag, r.Get())));
         if (IsErr())
         {
-            this->m_err = r.Get();
+            this->ErrValue() = r.Get();
         }
         else
         {
@@ -691,18 +1063,18 @@ public:
     template <typename U = ErrType>
     constexpr Result& Assign(ResultErr<U>&& r) noexcept(
         noexcept(
-            DeclVal<Result*>()->m_err = Forward<ResultErr<U>>(r).Get()) && //
+            DeclVal<Result*>()->ErrValue() = Forward<ResultErr<U>>(r).Get()) && //
         noexcept(DeclVal<Result*>()->Construct(ResultErrTag,
                                                Forward<ResultErr<U>>(r).Get())))
     {
         // clang-format off
         RAD_S_ASSERT_NOTHROW(
-            noexcept(this->m_err = Forward<ResultErr<U>>(r).Get()) &&
+            noexcept(this->ErrValue() = Forward<ResultErr<U>>(r).Get()) &&
             noexcept(Construct(ResultErrTag, Forward<ResultErr<U>>(r).Get())));
         // clang-format on
         if (IsErr())
         {
-            this->m_err = Forward<ResultErr<U>>(r).Get();
+            this->ErrValue() = Forward<ResultErr<U>>(r).Get();
         }
         else
         {
@@ -712,19 +1084,8 @@ public:
         return *this;
     }
 
-    constexpr Result& operator=(const Result& r) noexcept(
-        noexcept(DeclVal<Result*>()->Assign(r)))
-    {
-        RAD_S_ASSERT_NOTHROW(noexcept(Assign(r)));
-        return Assign(r);
-    }
-
-    constexpr Result& operator=(Result&& r) noexcept(
-        noexcept(DeclVal<Result*>()->Assign(Forward<Result>(r))))
-    {
-        RAD_S_ASSERT_NOTHROW(noexcept(Assign(Forward<Result>(r))));
-        return Assign(Forward<Result>(r));
-    }
+    constexpr Result& operator=(const Result&) = default;
+    constexpr Result& operator=(Result&&) = default;
 
     template <typename U = OkType, EnIf<!IsRelated<U, ErrType>, int> = 0>
     constexpr Result& operator=(const OkType& r) noexcept(
@@ -814,67 +1175,67 @@ public:
 
     constexpr ResultState State() const noexcept
     {
-        return this->m_state;
+        return this->GetState();
     }
 
     constexpr OkType& Ok() & noexcept
     {
         RAD_ASSERT(IsOk());
-        return this->m_ok.Get();
+        return this->OkValue().Get();
     }
 
     constexpr const OkType& Ok() const& noexcept
     {
         RAD_ASSERT(IsOk());
-        return this->m_ok.Get();
+        return this->OkValue().Get();
     }
 
     constexpr OkType&& Ok() && noexcept
     {
         RAD_ASSERT(IsOk());
-        return Move(this->m_ok).Get();
+        return Move(this->OkValue()).Get();
     }
 
     constexpr RemoveRef<OkType>* operator->() noexcept
     {
         RAD_ASSERT(IsOk());
-        return &this->m_ok.Get();
+        return &this->OkValue().Get();
     }
 
     constexpr const RemoveRef<OkType>* operator->() const noexcept
     {
         RAD_ASSERT(IsOk());
-        return &this->m_ok.Get();
+        return &this->OkValue().Get();
     }
 
     constexpr OkType& operator*() noexcept
     {
         RAD_ASSERT(IsOk());
-        return this->m_ok.Get();
+        return this->OkValue().Get();
     }
 
     constexpr const OkType& operator*() const noexcept
     {
         RAD_ASSERT(IsOk());
-        return this->m_ok.Get();
+        return this->OkValue().Get();
     }
 
     constexpr ErrType& Err() & noexcept
     {
         RAD_ASSERT(IsErr());
-        return this->m_err.Get();
+        return this->ErrValue().Get();
     }
 
     constexpr const ErrType& Err() const& noexcept
     {
         RAD_ASSERT(IsErr());
-        return this->m_err.Get();
+        return this->ErrValue().Get();
     }
 
     constexpr ErrType&& Err() && noexcept
     {
         RAD_ASSERT(IsErr());
-        return Move(this->m_err).Get();
+        return Move(this->ErrValue()).Get();
     }
 
     template <typename U, EnIf<IsCtor<Decay<OkType>, const U&>, int> = 0>
@@ -948,25 +1309,25 @@ private:
     template <typename R>
     constexpr void CopyCtor(R& r) noexcept(
         // clang-format off
-        noexcept(DeclVal<Result*>()->Construct(ResultOkTag, r.m_ok)) &&
-        noexcept(DeclVal<Result*>()->Construct(ResultErrTag, r.m_err)) &&
+        noexcept(DeclVal<Result*>()->Construct(ResultOkTag, r.OkValue())) &&
+        noexcept(DeclVal<Result*>()->Construct(ResultErrTag, r.ErrValue())) &&
         noexcept(DeclVal<Result*>()->Construct(ResultEmptyTag))
         // clang-format on
     )
     {
         // clang-format off
         RAD_S_ASSERT_NOTHROW(
-                noexcept(Construct(ResultOkTag, r.m_ok)) &&
-                noexcept(Construct(ResultErrTag, r.m_err)) &&
+                noexcept(Construct(ResultOkTag, r.OkValue())) &&
+                noexcept(Construct(ResultErrTag, r.ErrValue())) &&
                 noexcept(Construct(ResultEmptyTag)));
         // clang-format on
         if (r.IsOk())
         {
-            Construct(ResultOkTag, r.m_ok);
+            Construct(ResultOkTag, r.OkValue());
         }
         else if (r.IsErr())
         {
-            Construct(ResultErrTag, r.m_err);
+            Construct(ResultErrTag, r.ErrValue());
         }
         else
         {
@@ -977,25 +1338,25 @@ private:
     template <typename R>
     constexpr void CopyCtor(const R& r) noexcept(
         // clang-format off
-        noexcept(DeclVal<Result*>()->Construct(ResultOkTag, r.m_ok)) &&
-        noexcept(DeclVal<Result*>()->Construct(ResultErrTag, r.m_err)) &&
+        noexcept(DeclVal<Result*>()->Construct(ResultOkTag, r.OkValue())) &&
+        noexcept(DeclVal<Result*>()->Construct(ResultErrTag, r.ErrValue())) &&
         noexcept(DeclVal<Result*>()->Construct(ResultEmptyTag))
         // clang-format on
     )
     {
         // clang-format off
         RAD_S_ASSERT_NOTHROW(
-                noexcept(Construct(ResultOkTag, r.m_ok)) &&
-                noexcept(Construct(ResultErrTag, r.m_err)) &&
+                noexcept(Construct(ResultOkTag, r.OkValue())) &&
+                noexcept(Construct(ResultErrTag, r.ErrValue())) &&
                 noexcept(Construct(ResultEmptyTag)));
         // clang-format on
         if (r.IsOk())
         {
-            Construct(ResultOkTag, r.m_ok);
+            Construct(ResultOkTag, r.OkValue());
         }
         else if (r.IsErr())
         {
-            Construct(ResultErrTag, r.m_err);
+            Construct(ResultErrTag, r.ErrValue());
         }
         else
         {
@@ -1003,36 +1364,6 @@ private:
         }
     }
 
-    template <typename R>
-    constexpr void Copy(const R& r) noexcept(
-        // clang-format off
-        noexcept(DeclVal<Result*>()->CopyCtor(DeclVal<const R&>())) &&
-        noexcept(DeclVal<Result*>()->m_ok = r.m_ok) &&
-        noexcept(DeclVal<Result*>()->m_err = r.m_err)
-        // clang-format on
-    )
-    {
-        // clang-format off
-        RAD_S_ASSERT_NOTHROW(
-            noexcept(CopyCtor(r)) &&
-            noexcept(this->m_ok = r.m_ok) &&
-            noexcept(this->m_err = r.m_err));
-        // clang-format on
-        if (State() != r.State())
-        {
-            Destruct();
-            CopyCtor(r);
-        }
-        else if (IsOk())
-        {
-            this->m_ok = r.m_ok;
-        }
-        else if (IsErr())
-        {
-            this->m_err = r.m_err;
-        }
-    }
-
     template <typename R>
     constexpr void MoveCtor(R&& r) noexcept(
         // clang-format off
@@ -1062,39 +1393,6 @@ private:
         }
         r.Destruct();
     }
-
-    template <typename R>
-    constexpr void MoveAssign(R&& r) noexcept(
-        // clang-format off
-        noexcept(DeclVal<Result*>()->MoveCtor(Move(r))) &&
-        noexcept(DeclVal<Result*>()->m_ok = Move(r).Ok()) &&
-        noexcept(DeclVal<Result*>()->m_err = Move(r).Err())
-        // clang-format on
-    )
-    {
-        // clang-format off
-        RAD_S_ASSERT_NOTHROW(
-            noexcept(MoveCtor(Move(r))) &&
-            noexcept(this->m_ok = Move(r).Ok()) &&
-            noexcept(this->m_err = Move(r).Err()));
-        // clang-format on
-        if (State() != r.State())
-        {
-            Destruct();
-            MoveCtor(Move(r));
-            return;
-        }
-
-        if (IsOk())
-        {
-            this->m_ok = Move(r).Ok();
-        }
-        else if (IsErr())
-        {
-            this->m_err = Move(r).Err();
-        }
-        r.Destruct();
-    }
 };
 
 template <typename T1, typename E1, typename T2, typename E2>
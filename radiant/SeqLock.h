@@ -0,0 +1,214 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/CacheAligned.h"
+#include "radiant/Locks.h"
+#include "radiant/SpinLocks.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace rad
+{
+
+RAD_BEGIN_CACHE_ALIGNED
+/// @brief Value published by writers and read without writing shared memory.
+/// @details A sequence counter is odd while a writer updates the value. A
+/// reader copies the value between two reads of the counter and retries when
+/// the counter was odd or changed in between, so readers never modify the
+/// cache lines they read and do not slow each other down. Writers are
+/// serialized by TLock and may starve readers when they update continuously,
+/// so SeqLock suits small values that are read far more often than written.
+///
+/// The value is stored as words accessed atomically, which keeps torn copies
+/// well-defined. They are only ever returned when no write overlapped them.
+/// @tparam T Trivially copyable value type. It only needs to be default
+/// constructible for the default constructor.
+/// @tparam TLock Lock serializing writers, with a LockExclusive() and
+/// Unlock() usable by LockExclusive<TLock>.
+template <typename T, typename TLock = TicketSpinLock>
+class SeqLock final
+{
+private:
+
+    using WordType = uintptr_t;
+
+public:
+
+    using ValueType = T;
+    using LockType = TLock;
+
+    RAD_S_ASSERTMSG(IsTrivCopyCtor<T> && IsTrivDtor<T>,
+                    "SeqLock requires trivially copyable types");
+
+    static constexpr size_t WordCount =
+        (sizeof(T) + sizeof(WordType) - 1) / sizeof(WordType);
+
+    RAD_NOT_COPYABLE(SeqLock);
+    SeqLock(SeqLock&&) = delete;
+    SeqLock& operator=(SeqLock&&) = delete;
+
+    /// @brief Constructs a SeqLock holding a value-initialized T.
+    SeqLock() noexcept
+        : SeqLock(T())
+    {
+    }
+
+    /// @brief Constructs a SeqLock holding a copy of value.
+    /// @param value Initial value.
+    explicit SeqLock(const T& value) noexcept
+    {
+        WordType words[WordCount] = {};
+        memcpy(words, AddrOf(value), sizeof(T));
+        for (size_t i = 0; i < WordCount; ++i)
+        {
+            m_words[i].Store(words[i], MemOrderRelaxed);
+        }
+    }
+
+    /// @brief Reads a consistent copy of the value, waiting out writers.
+    /// @return The value.
+    T Load() const noexcept
+    {
+        WordType words[WordCount];
+        detail::SpinBackoff backoff;
+        while (!TryLoadWords(words))
+        {
+            backoff.Pause();
+        }
+
+        return FromWords(words);
+    }
+
+    /// @brief Makes a single attempt at reading the value.
+    /// @param value Receives the value if the attempt succeeded.
+    /// @return False if a writer updated the value during the attempt.
+    bool TryLoad(T& value) const noexcept
+    {
+        WordType words[WordCount];
+        if (!TryLoadWords(words))
+        {
+            return false;
+        }
+
+        memcpy(AddrOf(value), words, sizeof(T));
+        return true;
+    }
+
+    /// @brief Replaces the value.
+    /// @param value Value to publish.
+    void Store(const T& value) noexcept
+    {
+        LockExclusive<TLock> lock(m_lock);
+        Publish(value);
+    }
+
+    /// @brief Updates the value in place while holding the writer lock.
+    /// @param fn Callable invoked with a T& holding the current value, which
+    /// is published once fn returns.
+    template <typename F>
+    void Update(F&& fn) noexcept
+    {
+        RAD_S_ASSERT_NOTHROW(noexcept(fn(DeclVal<T&>())));
+
+        LockExclusive<TLock> lock(m_lock);
+        WordType words[WordCount];
+        for (size_t i = 0; i < WordCount; ++i)
+        {
+            words[i] = m_words[i].Load(MemOrderRelaxed);
+        }
+
+        T value = FromWords(words);
+        fn(value);
+        Publish(value);
+    }
+
+    /// @brief Gets the number of writes made so far.
+    /// @return Number of completed Store() and Update() calls.
+    uint32_t Version() const noexcept
+    {
+        return m_seq.Load(MemOrderAcquire) >> 1;
+    }
+
+    /// @brief Gets the lock serializing writers.
+    /// @return The lock.
+    TLock& WriterLock() noexcept
+    {
+        return m_lock;
+    }
+
+private:
+
+    bool TryLoadWords(WordType (&words)[WordCount]) const noexcept
+    {
+        const uint32_t seq = m_seq.Load(MemOrderAcquire);
+        if (seq & 1)
+        {
+            return false;
+        }
+
+        // acquire keeps the second read of the counter after the copy
+        for (size_t i = 0; i < WordCount; ++i)
+        {
+            words[i] = m_words[i].Load(MemOrderAcquire);
+        }
+
+        return m_seq.Load(MemOrderRelaxed) == seq;
+    }
+
+    // copies through raw storage, so T need not be default constructible
+    static T FromWords(const WordType (&words)[WordCount]) noexcept
+    {
+        struct alignas(T) Storage
+        {
+            unsigned char bytes[sizeof(T)];
+        } storage;
+
+        memcpy(storage.bytes, words, sizeof(T));
+        return *reinterpret_cast<const T*>(storage.bytes);
+    }
+
+    // called with the writer lock held
+    void Publish(const T& value) noexcept
+    {
+        WordType words[WordCount] = {};
+        memcpy(words, AddrOf(value), sizeof(T));
+
+        // release orders the odd counter before the words, and the words
+        // before the even counter
+        const uint32_t seq = m_seq.Load(MemOrderRelaxed);
+        m_seq.Store(seq + 1, MemOrderRelaxed);
+        for (size_t i = 0; i < WordCount; ++i)
+        {
+            m_words[i].Store(words[i], MemOrderRelease);
+        }
+
+        m_seq.Store(seq + 2, MemOrderRelease);
+    }
+
+    TLock m_lock;
+    // readers touch only the counter and the words, away from the lock
+    alignas(RAD_CACHE_LINE_SIZE) Atomic<uint32_t> m_seq{ 0 };
+    Atomic<WordType> m_words[WordCount];
+};
+RAD_END_CACHE_ALIGNED
+
+} // namespace rad
@@ -0,0 +1,137 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/TypeTraits.h"
+
+#include <stdint.h>
+
+#if RAD_LINUX && RAD_USER_MODE && defined(_GNU_SOURCE)
+#include <sched.h>
+#endif
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Returns a value identifying the processor or
+/// thread the caller runs on, for spreading concurrent writers across shards.
+/// @details The value is only a hint, it may change at any time as threads
+/// migrate between processors.
+inline uint32_t CurrentShardHint() noexcept
+{
+#if RAD_WINDOWS && RAD_KERNEL_MODE
+    return KeGetCurrentProcessorNumberEx(nullptr);
+#elif RAD_WINDOWS
+    return GetCurrentProcessorNumber();
+#else
+#if RAD_LINUX && RAD_USER_MODE && defined(_GNU_SOURCE)
+    const int cpu = sched_getcpu();
+    if RAD_LIKELY (cpu >= 0)
+    {
+        return static_cast<uint32_t>(cpu);
+    }
+#endif
+    // Threads run on distinct stacks, so the address of a local identifies
+    // the calling thread well enough to tell concurrent writers apart.
+    char local = 0;
+    const uint64_t addr = reinterpret_cast<uintptr_t>(&local) >> 16;
+    return static_cast<uint32_t>((addr * 0x9e3779b97f4a7c15ull) >> 32);
+#endif
+}
+
+} // namespace detail
+
+/// @brief Counter which spreads concurrent updates across cache-aligned
+/// shards and sums them on read.
+/// @details Updates go to the shard selected by the processor (or failing
+/// that, the thread) they run on, so cores incrementing the same counter do
+/// not contend for a single cache line. Reads visit every shard and are
+/// correspondingly more expensive. All operations are relaxed, a read
+/// concurrent with updates observes some of them but is not a snapshot.
+/// @tparam T Integral counter type.
+/// @tparam TShards Number of shards, a power of two.
+template <typename T, uint32_t TShards = 16>
+class ShardedCounter final
+{
+public:
+
+    RAD_S_ASSERTMSG(IsIntegral<T>, "ShardedCounter requires an integral type");
+    RAD_S_ASSERTMSG(TShards > 0 && (TShards & (TShards - 1)) == 0,
+                    "ShardedCounter shard count must be a power of two");
+
+    using ValueType = T;
+
+    static constexpr uint32_t ShardCount = TShards;
+
+    constexpr ShardedCounter() noexcept = default;
+
+    RAD_NOT_COPYABLE(ShardedCounter);
+
+    /// @brief Adds to the counter.
+    /// @param val Amount to add.
+    void Add(T val) noexcept
+    {
+        Shard().FetchAdd(val, MemOrderRelaxed);
+    }
+
+    /// @brief Subtracts from the counter.
+    /// @param val Amount to subtract.
+    void Sub(T val) noexcept
+    {
+        Shard().FetchSub(val, MemOrderRelaxed);
+    }
+
+    /// @brief Sums the shards.
+    /// @return Current value of the counter.
+    T Load() const noexcept
+    {
+        T sum = 0;
+        for (const auto& shard : m_shards)
+        {
+            sum = static_cast<T>(sum + shard.Load(MemOrderRelaxed));
+        }
+        return sum;
+    }
+
+    /// @brief Resets the counter to zero.
+    /// @details Each concurrent update is either counted in the returned value
+    /// or retained by the counter, none are lost.
+    /// @return Value of the counter before the reset.
+    T Reset() noexcept
+    {
+        T sum = 0;
+        for (auto& shard : m_shards)
+        {
+            sum = static_cast<T>(sum + shard.Exchange(0, MemOrderRelaxed));
+        }
+        return sum;
+    }
+
+private:
+
+    PaddedAtomic<T>& Shard() noexcept
+    {
+        return m_shards[detail::CurrentShardHint() & (TShards - 1)];
+    }
+
+    PaddedAtomic<T> m_shards[TShards];
+};
+
+} // namespace rad
@@ -19,11 +19,29 @@
 #include "radiant/EmptyOptimizedPair.h"
 #include "radiant/Locks.h"  // NOLINT(misc-include-cleaner)
 #include "radiant/Memory.h" // NOLINT(misc-include-cleaner)
+#include "radiant/Res.h"
+#include "radiant/Span.h"
+#include "radiant/TaggedPtr.h"
 #include "radiant/TypeTraits.h"
 #include "radiant/detail/AtomicIntrinsics.h"
 
 #include <stdint.h>
 
+#if RAD_ENABLE_TRACING
+#include "radiant/Trace.h"
+#endif
+
+//
+// Selects the lock-free AtomicSharedPtr, which requires RAD_HAS_DWCAS. When
+// disabled, AtomicSharedPtr serializes access with a small spin lock instead.
+//
+#ifndef RAD_LOCK_FREE_ATOMIC_SHARED_PTR
+#define RAD_LOCK_FREE_ATOMIC_SHARED_PTR RAD_HAS_DWCAS
+#endif
+#if RAD_LOCK_FREE_ATOMIC_SHARED_PTR && !RAD_HAS_DWCAS
+#error "RAD_LOCK_FREE_ATOMIC_SHARED_PTR requires RAD_HAS_DWCAS"
+#endif
+
 namespace rad
 {
 
@@ -37,6 +55,8 @@ class TPtrRefCount final
 {
 public:
 
+    using CounterType = TAtomic;
+
     TPtrRefCount() noexcept
         : m_strongCount(1),
           m_weakCount(1)
@@ -53,6 +73,16 @@ public:
         return m_strongCount.FetchSub(1, rad::MemOrderAcqRel) == 1;
     }
 
+    void Increment(uint32_t count) const noexcept
+    {
+        m_strongCount.FetchAdd(count, rad::MemOrderRelaxed);
+    }
+
+    bool Decrement(uint32_t count) const noexcept
+    {
+        return m_strongCount.FetchSub(count, rad::MemOrderAcqRel) == count;
+    }
+
     void IncrementWeak() const noexcept
     {
         m_weakCount.FetchAdd(1, rad::MemOrderRelaxed);
@@ -104,24 +134,90 @@ private:
     mutable TAtomic m_weakCount;
 };
 
-using PtrRefCount = TPtrRefCount<Atomic<uint32_t>>;
+/// @brief Internal use only. Plain counter exposing the subset of the Atomic
+/// interface used by TPtrRefCount, for objects confined to a single thread.
+/// @tparam T Integral counter type
+template <typename T>
+class LocalCounter final
+{
+public:
 
-class PtrBlockBase
+    constexpr LocalCounter(T value) noexcept
+        : m_val(value)
+    {
+    }
+
+    RAD_NOT_COPYABLE(LocalCounter);
+
+    template <typename TOrder>
+    T Load(TOrder) const noexcept
+    {
+        return m_val;
+    }
+
+    template <typename TOrder>
+    T FetchAdd(T val, TOrder) noexcept
+    {
+        const T prev = m_val;
+        m_val = static_cast<T>(prev + val);
+        return prev;
+    }
+
+    template <typename TOrder>
+    T FetchSub(T val, TOrder) noexcept
+    {
+        const T prev = m_val;
+        m_val = static_cast<T>(prev - val);
+        return prev;
+    }
+
+    template <typename TSuccess, typename TFailure>
+    bool CompareExchangeWeak(T& expected,
+                             T desired,
+                             TSuccess,
+                             TFailure) noexcept
+    {
+        if (m_val != expected)
+        {
+            expected = m_val;
+            return false;
+        }
+
+        m_val = desired;
+        return true;
+    }
+
+private:
+
+    T m_val;
+};
+
+using PtrRefCount = TPtrRefCount<Atomic<uint32_t>>;
+using LocalPtrRefCount = TPtrRefCount<LocalCounter<uint32_t>>;
+
+/// @brief Internal use only. Type-erased SharedPtr control block.
+/// @details Aligned to 8 bytes on every target, as AtomicSharedPtr keeps its
+/// lock in the three low order bits of a pointer to the block.
+/// @tparam TRefCount Reference count type
+template <typename TRefCount>
+class alignas(8) TPtrBlockBase
 {
 public:
 
-    virtual ~PtrBlockBase() noexcept
+    using RefCountType = TRefCount;
+
+    virtual ~TPtrBlockBase() noexcept
     {
     }
 
-    PtrBlockBase() noexcept = default;
+    TPtrBlockBase() noexcept = default;
 
-    RAD_NOT_COPYABLE(PtrBlockBase);
+    RAD_NOT_COPYABLE(TPtrBlockBase);
 
     virtual void OnRefZero() const noexcept = 0;
     virtual void OnWeakZero() const noexcept = 0;
 
-    const PtrRefCount& RefCount() const noexcept
+    const RefCountType& RefCount() const noexcept
     {
         return m_refcount;
     }
@@ -131,6 +227,11 @@ public:
         RefCount().Increment();
     }
 
+    void Acquire(uint32_t count) const noexcept
+    {
+        RefCount().Increment(count);
+    }
+
     void AcquireWeak() const noexcept
     {
         RefCount().IncrementWeak();
@@ -150,6 +251,15 @@ public:
         }
     }
 
+    void Release(uint32_t count) const noexcept
+    {
+        if (RefCount().Decrement(count))
+        {
+            OnRefZero();
+            ReleaseWeak();
+        }
+    }
+
     void ReleaseWeak() const noexcept
     {
         if (RefCount().DecrementWeak())
@@ -170,18 +280,23 @@ public:
 
 private:
 
-    PtrRefCount m_refcount;
+    RefCountType m_refcount;
 };
 
+using PtrBlockBase = TPtrBlockBase<PtrRefCount>;
+using LocalPtrBlockBase = TPtrBlockBase<LocalPtrRefCount>;
+
 /// @brief Internal use only. SharedPtr control block
 /// @tparam T Value type
 /// @tparam TAlloc Allocator type
-template <typename T, typename TAlloc>
-class PtrBlock final : public PtrBlockBase
+/// @tparam TRefCount Reference count type
+template <typename T, typename TAlloc, typename TRefCount = PtrRefCount>
+class PtrBlock final : public TPtrBlockBase<TRefCount>
 {
 private:
 
     using AllocatorTraits = AllocTraits<TAlloc>;
+    using BaseType = TPtrBlockBase<TRefCount>;
 
 public:
 
@@ -192,7 +307,7 @@ public:
     template <typename... TArgs>
     PtrBlock(const AllocatorType& alloc, TArgs&&... args) noexcept(
         noexcept(PairType(alloc, Forward<TArgs>(args)...)))
-        : PtrBlockBase(),
+        : BaseType(),
           m_pair(alloc, Forward<TArgs>(args)...)
     {
     }
@@ -252,11 +367,239 @@ private:
     mutable PairType m_pair;
 };
 
+/// @brief Internal use only. SharedPtr control block followed by an array
+/// of values in the same allocation.
+/// @tparam T Value type
+/// @tparam TAlloc Allocator type
+/// @tparam TRefCount Reference count type
+template <typename T, typename TAlloc, typename TRefCount = PtrRefCount>
+class PtrArrayBlock final : public TPtrBlockBase<TRefCount>
+{
+private:
+
+    using AllocatorTraits = AllocTraits<TAlloc>;
+    using BaseType = TPtrBlockBase<TRefCount>;
+
+public:
+
+    using AllocatorType = TAlloc;
+    using ValueType = T;
+    using UnitType = max_align_t;
+    using PairType = EmptyOptimizedPair<AllocatorType, uint32_t>;
+
+    RAD_S_ASSERTMSG(alignof(T) <= alignof(UnitType),
+                    "shared arrays do not support over-aligned types");
+
+    PtrArrayBlock(const AllocatorType& alloc, uint32_t count) noexcept
+        : BaseType(),
+          m_pair(alloc, count)
+    {
+    }
+
+    /// @brief Offset of the first value from the start of the block.
+    static constexpr size_t ValuesOffset() noexcept
+    {
+        return (sizeof(PtrArrayBlock) + alignof(UnitType) - 1) &
+               ~(alignof(UnitType) - 1);
+    }
+
+    /// @brief Determines whether a block with count values can be allocated
+    /// without the size overflowing.
+    static constexpr bool Fits(uint32_t count) noexcept
+    {
+        return count <= (AllocatorTraits::MaxSize - ValuesOffset() -
+                         sizeof(UnitType)) /
+                            sizeof(T);
+    }
+
+    /// @brief Number of allocation units a block with count values takes.
+    static constexpr size_t Units(uint32_t count) noexcept
+    {
+        return (ValuesOffset() + count * sizeof(T) + sizeof(UnitType) - 1) /
+               sizeof(UnitType);
+    }
+
+    /// @brief Values of a block starting at mem, which need not be
+    /// constructed yet.
+    static T* ValuesOf(void* mem) noexcept
+    {
+        return reinterpret_cast<T*>(static_cast<char*>(mem) + ValuesOffset());
+    }
+
+    void OnRefZero() const noexcept override
+    {
+        T* values = ValuesOf(const_cast<PtrArrayBlock*>(this));
+        for (uint32_t i = Count(); i > 0; --i)
+        {
+            values[i - 1].~ValueType();
+        }
+    }
+
+    void OnWeakZero() const noexcept override
+    {
+        AllocatorType alloc(Allocator());
+        const size_t units = Units(Count());
+        auto self = const_cast<PtrArrayBlock*>(this);
+        Allocator().~AllocatorType();
+        AllocatorTraits::Free(alloc, reinterpret_cast<UnitType*>(self), units);
+    }
+
+    const AllocatorType& Allocator() const noexcept
+    {
+        return m_pair.First();
+    }
+
+    uint32_t Count() const noexcept
+    {
+        return m_pair.Second();
+    }
+
+private:
+
+    mutable PairType m_pair;
+};
+
+template <typename T, typename TAlloc, typename TRefCount>
+class PtrBatchBlock;
+
+/// @brief Internal use only. Single allocation holding the control blocks of
+/// a batch of SharedPtrs, freed once every block has been released.
+/// @tparam T Value type
+/// @tparam TAlloc Allocator type
+/// @tparam TRefCount Reference count type
+template <typename T, typename TAlloc, typename TRefCount = PtrRefCount>
+class PtrBatchSlab final
+{
+private:
+
+    using AllocatorTraits = AllocTraits<TAlloc>;
+    using CounterType = typename TRefCount::CounterType;
+
+public:
+
+    using AllocatorType = TAlloc;
+    using BlockType = PtrBatchBlock<T, TAlloc, TRefCount>;
+    using UnitType = max_align_t;
+
+    PtrBatchSlab(const AllocatorType& alloc, uint32_t count) noexcept
+        : m_pair(alloc, count),
+          m_live(count)
+    {
+    }
+
+    RAD_NOT_COPYABLE(PtrBatchSlab);
+
+    /// @brief Offset of the first block from the start of the slab.
+    static constexpr size_t BlocksOffset() noexcept
+    {
+        return (sizeof(PtrBatchSlab) + alignof(UnitType) - 1) &
+               ~(alignof(UnitType) - 1);
+    }
+
+    /// @brief Determines whether a slab with count blocks can be allocated
+    /// without the size overflowing.
+    static constexpr bool Fits(uint32_t count) noexcept
+    {
+        return count <= (AllocatorTraits::MaxSize - BlocksOffset() -
+                         sizeof(UnitType)) /
+                            sizeof(BlockType);
+    }
+
+    /// @brief Number of allocation units a slab with count blocks takes.
+    static constexpr size_t Units(uint32_t count) noexcept
+    {
+        return (BlocksOffset() + count * sizeof(BlockType) +
+                sizeof(UnitType) - 1) /
+               sizeof(UnitType);
+    }
+
+    /// @brief Blocks of a slab starting at mem, which need not be
+    /// constructed yet.
+    static BlockType* BlocksOf(void* mem) noexcept
+    {
+        return reinterpret_cast<BlockType*>(static_cast<char*>(mem) +
+                                            BlocksOffset());
+    }
+
+    /// @brief Called by each block once its weak count drops to zero. Frees
+    /// the slab after the last one.
+    void ReleaseBlock() noexcept
+    {
+        if (m_live.FetchSub(1, MemOrderAcqRel) == 1)
+        {
+            AllocatorType alloc(m_pair.First());
+            const size_t units = Units(m_pair.Second());
+            this->~PtrBatchSlab();
+            AllocatorTraits::Free(alloc,
+                                  reinterpret_cast<UnitType*>(this),
+                                  units);
+        }
+    }
+
+private:
+
+    EmptyOptimizedPair<AllocatorType, uint32_t> m_pair;
+    CounterType m_live;
+};
+
+/// @brief Internal use only. SharedPtr control block living in a
+/// PtrBatchSlab along with the blocks of its batch.
+/// @tparam T Value type
+/// @tparam TAlloc Allocator type
+/// @tparam TRefCount Reference count type
+template <typename T, typename TAlloc, typename TRefCount>
+class PtrBatchBlock final : public TPtrBlockBase<TRefCount>
+{
+private:
+
+    using BaseType = TPtrBlockBase<TRefCount>;
+
+public:
+
+    using ValueType = T;
+    using SlabType = PtrBatchSlab<T, TAlloc, TRefCount>;
+
+    RAD_S_ASSERTMSG(alignof(T) <= alignof(max_align_t),
+                    "shared batches do not support over-aligned types");
+
+    template <typename... TArgs>
+    PtrBatchBlock(SlabType* slab, TArgs&&... args) noexcept(
+        IsNoThrowCtor<T, TArgs&&...>)
+        : BaseType(),
+          m_slab(slab),
+          m_value(Forward<TArgs>(args)...)
+    {
+    }
+
+    void OnRefZero() const noexcept override
+    {
+        Value().~ValueType();
+    }
+
+    void OnWeakZero() const noexcept override
+    {
+        m_slab->ReleaseBlock();
+    }
+
+    ValueType& Value() const noexcept
+    {
+        return m_value;
+    }
+
+private:
+
+    SlabType* m_slab;
+    mutable ValueType m_value;
+};
+
 struct AllocateSharedImpl;
 
 } // namespace detail
 
-template <typename T>
+template <typename T, typename TRefCount = detail::PtrRefCount>
+class SharedPtr;
+
+template <typename T, typename TRefCount = detail::PtrRefCount>
 class WeakPtr;
 
 template <typename T>
@@ -267,13 +610,16 @@ class AtomicWeakPtr;
 
 /// @brief Smart pointer implementing shared ownership mechanics.
 /// @tparam T Value type to point to
-template <typename T>
+/// @tparam TRefCount Reference count type of the control block
+template <typename T, typename TRefCount>
 class SharedPtr final
 {
+    using BlockType = detail::TPtrBlockBase<TRefCount>;
 
 public:
 
     using ValueType = T;
+    static constexpr bool IsTriviallyRelocatable = true;
 
     ~SharedPtr()
     {
@@ -321,7 +667,7 @@ public:
     /// @brief Construct a new SharedPtr from a convertible pointer.
     /// @param r Existing pointer
     template <typename U, EnIf<IsConv<U*, T*>, int> = 0>
-    SharedPtr(const SharedPtr<U>& r) noexcept
+    SharedPtr(const SharedPtr<U, TRefCount>& r) noexcept
         : m_block(r.m_block),
           m_ptr(r.m_ptr)
     {
@@ -436,7 +782,7 @@ public:
     /// @brief Take additional reference to an existing, convertible pointer.
     /// Drops reference to its current stored pointer if not nullptr.
     template <typename U, EnIf<IsConv<U*, T*>, int> = 0>
-    SharedPtr& operator=(const SharedPtr<U>& r) noexcept
+    SharedPtr& operator=(const SharedPtr<U, TRefCount>& r) noexcept
     {
         RAD_S_ASSERT(noexcept(m_block->Release()));
         RAD_S_ASSERT(noexcept(m_block->Acquire()));
@@ -501,90 +847,96 @@ public:
 
 private:
 
-    SharedPtr(detail::PtrBlockBase* block, T* ptr) noexcept
+    SharedPtr(BlockType* block, T* ptr) noexcept
         : m_block(block),
           m_ptr(ptr)
     {
     }
 
-    template <typename U>
+    template <typename U, typename R>
     friend class SharedPtr;
 
-    template <typename U>
+    template <typename U, typename R>
     friend class WeakPtr;
 
     friend class AtomicSharedPtr<T>;
     friend class AtomicWeakPtr<T>;
 
-    detail::PtrBlockBase* m_block;
+    BlockType* m_block;
     T* m_ptr;
 
     friend struct detail::AllocateSharedImpl;
 };
 
-template <typename T>
-RAD_NODISCARD bool operator==(rad::nullptr_t, const SharedPtr<T>& sp) noexcept
+template <typename T, typename R>
+RAD_NODISCARD bool operator==(rad::nullptr_t,
+                              const SharedPtr<T, R>& sp) noexcept
 {
     return sp == nullptr;
 }
 
-template <typename T>
-RAD_NODISCARD bool operator!=(rad::nullptr_t, const SharedPtr<T>& sp) noexcept
+template <typename T, typename R>
+RAD_NODISCARD bool operator!=(rad::nullptr_t,
+                              const SharedPtr<T, R>& sp) noexcept
 {
     return sp != nullptr;
 }
 
-template <typename T, typename U>
-RAD_NODISCARD bool operator==(const SharedPtr<T>& l,
-                              const SharedPtr<U>& r) noexcept
+template <typename T, typename U, typename R>
+RAD_NODISCARD bool operator==(const SharedPtr<T, R>& l,
+                              const SharedPtr<U, R>& r) noexcept
 {
     return l.Get() == r.Get();
 }
 
-template <typename T, typename U>
-RAD_NODISCARD bool operator!=(const SharedPtr<T>& l,
-                              const SharedPtr<U>& r) noexcept
+template <typename T, typename U, typename R>
+RAD_NODISCARD bool operator!=(const SharedPtr<T, R>& l,
+                              const SharedPtr<U, R>& r) noexcept
 {
     return l.Get() != r.Get();
 }
 
-template <typename T, typename U>
-RAD_NODISCARD bool operator<(const SharedPtr<T>& l,
-                             const SharedPtr<U>& r) noexcept
+template <typename T, typename U, typename R>
+RAD_NODISCARD bool operator<(const SharedPtr<T, R>& l,
+                             const SharedPtr<U, R>& r) noexcept
 {
     return l.Get() < r.Get();
 }
 
-template <typename T, typename U>
-RAD_NODISCARD bool operator<=(const SharedPtr<T>& l,
-                              const SharedPtr<U>& r) noexcept
+template <typename T, typename U, typename R>
+RAD_NODISCARD bool operator<=(const SharedPtr<T, R>& l,
+                              const SharedPtr<U, R>& r) noexcept
 {
     return l.Get() <= r.Get();
 }
 
-template <typename T, typename U>
-RAD_NODISCARD bool operator>(const SharedPtr<T>& l,
-                             const SharedPtr<U>& r) noexcept
+template <typename T, typename U, typename R>
+RAD_NODISCARD bool operator>(const SharedPtr<T, R>& l,
+                             const SharedPtr<U, R>& r) noexcept
 {
     return l.Get() > r.Get();
 }
 
-template <typename T, typename U>
-RAD_NODISCARD bool operator>=(const SharedPtr<T>& l,
-                              const SharedPtr<U>& r) noexcept
+template <typename T, typename U, typename R>
+RAD_NODISCARD bool operator>=(const SharedPtr<T, R>& l,
+                              const SharedPtr<U, R>& r) noexcept
 {
     return l.Get() >= r.Get();
 }
 
 /// @brief Smart pointer implementing weak ownership mechanics.
 /// @tparam T Value type to point to
-template <typename T>
+/// @tparam TRefCount Reference count type of the control block
+template <typename T, typename TRefCount>
 class WeakPtr final
 {
+    using BlockType = detail::TPtrBlockBase<TRefCount>;
+
 public:
 
     using ValueType = T;
-    using SharedType = SharedPtr<T>;
+    using SharedType = SharedPtr<T, TRefCount>;
+    static constexpr bool IsTriviallyRelocatable = true;
 
     ~WeakPtr()
     {
@@ -644,7 +996,7 @@ public:
     /// @brief Construct a new WeakPtr from a convertible pointer.
     /// @param r Existing pointer
     template <typename U, EnIf<IsConv<U*, T*>, int> = 0>
-    WeakPtr(const WeakPtr<U>& r) noexcept
+    WeakPtr(const WeakPtr<U, TRefCount>& r) noexcept
         : m_block(r.m_block),
           m_ptr(r.m_ptr)
     {
@@ -659,7 +1011,7 @@ public:
     /// @brief Construct a new WeakPtr from a convertible pointer.
     /// @param r Existing pointer
     template <typename U, EnIf<IsConv<U*, T*>, int> = 0>
-    WeakPtr(const SharedPtr<U>& r) noexcept
+    WeakPtr(const SharedPtr<U, TRefCount>& r) noexcept
         : m_block(r.m_block),
           m_ptr(r.m_ptr)
     {
@@ -675,7 +1027,7 @@ public:
     /// pointer.
     /// @param r Existing pointer
     template <typename U, EnIf<IsConv<U*, T*>, int> = 0>
-    WeakPtr(WeakPtr<U>&& r) noexcept
+    WeakPtr(WeakPtr<U, TRefCount>&& r) noexcept
         : m_block(r.m_block),
           m_ptr(r.m_ptr)
     {
@@ -714,7 +1066,7 @@ public:
     /// @param r Other object to store in this.
     /// @return Reference to this.
     template <typename U, EnIf<IsConv<U*, T*>, int> = 0>
-    WeakPtr& operator=(const WeakPtr<U>& r) noexcept
+    WeakPtr& operator=(const WeakPtr<U, TRefCount>& r) noexcept
     {
         RAD_S_ASSERT(noexcept(m_block->ReleaseWeak()));
         RAD_S_ASSERT(noexcept(m_block->AcquireWeak()));
@@ -763,7 +1115,7 @@ public:
     /// @param r Other object to store in this.
     /// @return Reference to this.
     template <typename U, EnIf<IsConv<U*, T*>, int> = 0>
-    WeakPtr& operator=(const SharedPtr<U>& r) noexcept
+    WeakPtr& operator=(const SharedPtr<U, TRefCount>& r) noexcept
     {
         RAD_S_ASSERT(noexcept(m_block->ReleaseWeak()));
         RAD_S_ASSERT(noexcept(m_block->AcquireWeak()));
@@ -811,7 +1163,7 @@ public:
     /// @param r Other object to move into this.
     /// @return Reference to this.
     template <typename U, EnIf<IsConv<U*, T*>, int> = 0>
-    WeakPtr& operator=(WeakPtr<U>&& r) noexcept
+    WeakPtr& operator=(WeakPtr<U, TRefCount>&& r) noexcept
     {
         RAD_S_ASSERT(noexcept(m_block->ReleaseWeak()));
 
@@ -887,18 +1239,18 @@ public:
 
 private:
 
-    WeakPtr(detail::PtrBlockBase* block, T* ptr) noexcept
+    WeakPtr(BlockType* block, T* ptr) noexcept
         : m_block(block),
           m_ptr(ptr)
     {
     }
 
-    template <typename U>
+    template <typename U, typename R>
     friend class WeakPtr;
 
     friend class AtomicWeakPtr<T>;
 
-    detail::PtrBlockBase* m_block;
+    BlockType* m_block;
     T* m_ptr;
 };
 
@@ -927,11 +1279,14 @@ struct AllocateSharedImpl
         BlockType* block = nullptr;
     };
 
-    template <typename T, typename TAlloc, typename... TArgs>
-    static inline SharedPtr<T> AllocateShared(const TAlloc& alloc,
-                                              TArgs&&... args)
+    template <typename T,
+              typename TRefCount,
+              typename TAlloc,
+              typename... TArgs>
+    static inline SharedPtr<T, TRefCount> AllocateShared(const TAlloc& alloc,
+                                                         TArgs&&... args)
     {
-        using BlockType = PtrBlock<T, TAlloc>;
+        using BlockType = PtrBlock<T, TAlloc, TRefCount>;
 
         AllocateSharedHelper<BlockType, TAlloc> excSafe(alloc);
 
@@ -940,10 +1295,122 @@ struct AllocateSharedImpl
             new (excSafe.block) BlockType(alloc, Forward<TArgs>(args)...);
             auto block = excSafe.block;
             excSafe.block = nullptr;
-            return SharedPtr<T>(block, &block->Value());
+            return SharedPtr<T, TRefCount>(block, &block->Value());
         }
         return nullptr;
     }
+
+    /// @brief RAII-safety wrapper freeing an allocation and destroying the
+    /// objects constructed in it so far.
+    template <typename T, typename TAlloc>
+    struct AllocateArrayHelper
+    {
+        using UnitType = max_align_t;
+
+        AllocateArrayHelper(const TAlloc& ta, size_t n) noexcept
+            : alloc(ta),
+              units(n)
+        {
+            mem = AllocTraits<TAlloc>::template Alloc<UnitType>(alloc, units);
+        }
+
+        ~AllocateArrayHelper()
+        {
+            if (mem != nullptr)
+            {
+                while (constructed > 0)
+                {
+                    objects[--constructed].~T();
+                }
+
+                AllocTraits<TAlloc>::Free(alloc, mem, units);
+            }
+        }
+
+        TAlloc alloc;
+        size_t units;
+        UnitType* mem = nullptr;
+        T* objects = nullptr;
+        uint32_t constructed = 0;
+    };
+
+    template <typename T, typename TRefCount, typename TAlloc>
+    static inline SharedPtr<T, TRefCount> AllocateSharedArray(
+        const TAlloc& alloc, uint32_t count)
+    {
+        using BlockType = PtrArrayBlock<T, TAlloc, TRefCount>;
+
+        if RAD_UNLIKELY (!BlockType::Fits(count))
+        {
+            return nullptr;
+        }
+
+        AllocateArrayHelper<T, TAlloc> excSafe(alloc, BlockType::Units(count));
+        if RAD_UNLIKELY (excSafe.mem == nullptr)
+        {
+            return nullptr;
+        }
+
+        excSafe.objects = BlockType::ValuesOf(excSafe.mem);
+        while (excSafe.constructed < count)
+        {
+            new (excSafe.objects + excSafe.constructed) T();
+            ++excSafe.constructed;
+        }
+
+        auto block = new (excSafe.mem) BlockType(alloc, count);
+        excSafe.mem = nullptr;
+        return SharedPtr<T, TRefCount>(block, BlockType::ValuesOf(block));
+    }
+
+    template <typename T,
+              typename TRefCount,
+              typename TAlloc,
+              typename... TArgs>
+    static inline Err AllocateSharedBatch(const TAlloc& alloc,
+                                          Span<SharedPtr<T, TRefCount>> out,
+                                          const TArgs&... args)
+    {
+        using SlabType = PtrBatchSlab<T, TAlloc, TRefCount>;
+        using BlockType = typename SlabType::BlockType;
+
+        const uint32_t count = out.Size();
+        if (count == 0)
+        {
+            return NoError;
+        }
+
+        if RAD_UNLIKELY (!SlabType::Fits(count))
+        {
+            return Error::NoMemory;
+        }
+
+        AllocateArrayHelper<BlockType, TAlloc> excSafe(alloc,
+                                                       SlabType::Units(count));
+        if RAD_UNLIKELY (excSafe.mem == nullptr)
+        {
+            return Error::NoMemory;
+        }
+
+        auto slab = reinterpret_cast<SlabType*>(excSafe.mem);
+        excSafe.objects = SlabType::BlocksOf(excSafe.mem);
+        while (excSafe.constructed < count)
+        {
+            new (excSafe.objects + excSafe.constructed)
+                BlockType(slab, args...);
+            ++excSafe.constructed;
+        }
+
+        new (excSafe.mem) SlabType(alloc, count);
+        excSafe.mem = nullptr;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            BlockType* block = excSafe.objects + i;
+            out[i] = SharedPtr<T, TRefCount>(block, &block->Value());
+        }
+
+        return NoError;
+    }
 };
 
 } // namespace detail
@@ -957,12 +1424,54 @@ struct AllocateSharedImpl
 /// @return A SharedPtr<T, TAlloc>
 template <typename T, typename TAlloc, typename... TArgs>
 SharedPtr<T> AllocateShared(const TAlloc& alloc, TArgs&&... args) //
-    noexcept(noexcept(detail::AllocateSharedImpl::AllocateShared<T, TAlloc>(
-        alloc, Forward<TArgs>(args)...)))
+    noexcept(noexcept(detail::AllocateSharedImpl::
+                          AllocateShared<T, detail::PtrRefCount, TAlloc>(
+                              alloc, Forward<TArgs>(args)...)))
 {
-    return detail::AllocateSharedImpl::AllocateShared<T, TAlloc>(
-        alloc,
-        Forward<TArgs>(args)...);
+    return detail::AllocateSharedImpl::
+        AllocateShared<T, detail::PtrRefCount, TAlloc>(alloc,
+                                                       Forward<TArgs>(args)...);
+}
+
+/// @brief Constructs an array of value-initialized objects of type T in the
+/// same allocation as the control block managing them.
+/// @details The objects are destroyed in reverse order when the last
+/// SharedPtr to them is released.
+/// @tparam T Type of the array elements
+/// @tparam TAlloc Type of the custom allocator
+/// @param alloc Allocator instance
+/// @param count Number of elements
+/// @return A SharedPtr<T> to the first element, or nullptr if the allocation
+/// failed
+template <typename T, typename TAlloc>
+SharedPtr<T> AllocateSharedArray(const TAlloc& alloc, uint32_t count)
+{
+    return detail::AllocateSharedImpl::
+        AllocateSharedArray<T, detail::PtrRefCount, TAlloc>(alloc, count);
+}
+
+/// @brief Constructs a batch of objects of type T, each managed by its own
+/// SharedPtr, with a single allocation.
+/// @details Every object is constructed from the same arguments and has its
+/// own reference counts, so is destroyed when its last SharedPtr is
+/// released. The allocation is freed once every object's last SharedPtr and
+/// WeakPtr have been released.
+/// @tparam T Type of object to construct
+/// @tparam TAlloc Type of the custom allocator
+/// @param alloc Allocator instance
+/// @param out SharedPtrs receiving the objects, one per object
+/// @param args Arguments for T construction
+/// @return Error::NoMemory if the allocation failed, in which case out is
+/// left untouched
+template <typename T, typename TAlloc, typename... TArgs>
+Err AllocateSharedBatch(const TAlloc& alloc,
+                        Span<SharedPtr<T>> out,
+                        const TArgs&... args)
+{
+    return detail::AllocateSharedImpl::
+        AllocateSharedBatch<T, detail::PtrRefCount, TAlloc>(alloc,
+                                                            out,
+                                                            args...);
 }
 
 #ifdef RAD_DEFAULT_ALLOCATOR
@@ -981,6 +1490,55 @@ SharedPtr<T> MakeShared(TArgs&&... args) noexcept(
 }
 #endif
 
+/// @brief Shared pointer whose reference counts are not atomic.
+/// @details Copying and releasing a LocalSharedPtr costs plain increments and
+/// decrements. All copies, including LocalWeakPtr references, must be used and
+/// released by a single thread at a time. LocalSharedPtr does not convert to
+/// or from SharedPtr.
+/// @tparam T Value type to point to
+template <typename T>
+using LocalSharedPtr = SharedPtr<T, detail::LocalPtrRefCount>;
+
+/// @brief Weak pointer companion of LocalSharedPtr.
+/// @tparam T Value type to point to
+template <typename T>
+using LocalWeakPtr = WeakPtr<T, detail::LocalPtrRefCount>;
+
+/// @brief Constructs and wraps an object of type T in a LocalSharedPtr with a
+/// custom allocator.
+/// @tparam T Type of object to construct
+/// @tparam TAlloc Type of the custom allocator
+/// @param alloc Allocator instance
+/// @param args Arguments for T construction
+/// @return A LocalSharedPtr<T>
+template <typename T, typename TAlloc, typename... TArgs>
+LocalSharedPtr<T> AllocateLocalShared(const TAlloc& alloc, TArgs&&... args) //
+    noexcept(noexcept(detail::AllocateSharedImpl::
+                          AllocateShared<T, detail::LocalPtrRefCount, TAlloc>(
+                              alloc, Forward<TArgs>(args)...)))
+{
+    return detail::AllocateSharedImpl::
+        AllocateShared<T, detail::LocalPtrRefCount, TAlloc>(
+            alloc,
+            Forward<TArgs>(args)...);
+}
+
+#ifdef RAD_DEFAULT_ALLOCATOR
+/// @brief Constructs and wraps an object of type T in a LocalSharedPtr with the
+/// default allocator.
+/// @tparam T Type of object to construct
+/// @tparam TAlloc Type of the custom allocator
+/// @param args Arguments for T construction
+/// @return A LocalSharedPtr<T>
+template <typename T, typename TAlloc RAD_ALLOCATOR_EQ(T), typename... TArgs>
+LocalSharedPtr<T> MakeLocalShared(TArgs&&... args) noexcept(noexcept(
+    AllocateLocalShared<T>(DeclVal<TAlloc&>(), Forward<TArgs>(args)...)))
+{
+    TAlloc alloc;
+    return AllocateLocalShared<T>(alloc, Forward<TArgs>(args)...);
+}
+#endif
+
 namespace detail
 {
 
@@ -992,22 +1550,25 @@ public:
     // can consider making this 3 on 64-bit systems
     static constexpr uintptr_t ExclusiveBit = 2;
     static constexpr uintptr_t ExclusiveFlag = 1 << ExclusiveBit;
-    RAD_S_ASSERTMSG(alignof(T) >= ExclusiveFlag,
-                    "low order bits are needed by LockablePtr");
     static constexpr uintptr_t SharedMax = ExclusiveFlag - 1;
     static constexpr uintptr_t LockMask = (ExclusiveFlag | SharedMax);
-    static constexpr uintptr_t PtrMask = ~LockMask;
+    RAD_S_ASSERTMSG(alignof(T) > LockMask,
+                    "low order bits are needed by LockablePtr");
 
     using ThisType = LockablePtr<T>;
     using ValueType = T;
     using PointerType = T*;
+    using StorageType = AtomicTaggedPtr<T, ExclusiveBit + 1>;
+    using TaggedType = typename StorageType::ValueType;
+
+    RAD_S_ASSERT(StorageType::TagMask == LockMask);
 
     ~LockablePtr() = default;
 
     constexpr LockablePtr() noexcept = default;
 
     constexpr LockablePtr(PointerType value) noexcept
-        : m_storage(reinterpret_cast<uintptr_t>(value))
+        : m_storage(TaggedType(value))
     {
     }
 
@@ -1015,44 +1576,47 @@ public:
 
     RAD_NODISCARD PointerType UnsafeGet() const noexcept
     {
-        return reinterpret_cast<PointerType>(m_storage.Load(MemOrderRelaxed) &
-                                             PtrMask);
+        return m_storage.Load(MemOrderRelaxed).Ptr();
     }
 
     void UnsafeSet(PointerType value) noexcept
     {
         auto ptr = m_storage.Load(MemOrderRelaxed);
-        m_storage.Store(reinterpret_cast<uintptr_t>(value) | (ptr & LockMask),
-                        MemOrderRelaxed);
+        m_storage.Store(ptr.WithPtr(value), MemOrderRelaxed);
     }
 
     void Unlock() noexcept
     {
-        if (m_storage.Load(MemOrderRelaxed) & ExclusiveFlag)
+        // A pending exclusive locker sets its flag before the shared holders
+        // have drained, so only the shared count tells the holders apart.
+        if (m_storage.Load(MemOrderRelaxed).Tag() & SharedMax)
         {
-            m_storage.FetchAnd(~ExclusiveFlag, MemOrderRelease);
+            m_storage.FetchSubTag(1, MemOrderRelease);
         }
         else
         {
-            m_storage.FetchSub(1, MemOrderRelease);
+            m_storage.FetchAndTag(SharedMax, MemOrderRelease);
         }
     }
 
     void LockShared() noexcept
     {
+        RAD_TRACE_SCOPE("rad::AtomicSharedPtr::LockShared");
         auto ptr = m_storage.Load(MemOrderAcquire);
 
         for (;; RAD_YIELD_PROCESSOR())
         {
-            if ((ptr & LockMask) >= SharedMax)
+            if (ptr.Tag() >= SharedMax)
             {
+                ptr = m_storage.Load(MemOrderAcquire);
                 continue;
             }
 
-            if RAD_LIKELY (m_storage.CompareExchangeWeak(ptr,
-                                                         ptr + 1,
-                                                         MemOrderAcqRel,
-                                                         MemOrderRelaxed))
+            if RAD_LIKELY (m_storage.CompareExchangeWeak(
+                               ptr,
+                               ptr.WithTag(ptr.Tag() + 1),
+                               MemOrderAcqRel,
+                               MemOrderRelaxed))
             {
                 break;
             }
@@ -1061,25 +1625,28 @@ public:
 
     void LockExclusive() noexcept
     {
+        RAD_TRACE_SCOPE("rad::AtomicSharedPtr::LockExclusive");
         auto ptr = m_storage.Load(MemOrderAcquire);
 
         for (;; RAD_YIELD_PROCESSOR())
         {
-            if (ptr & ExclusiveFlag)
+            if (ptr.Tag() & ExclusiveFlag)
             {
+                ptr = m_storage.Load(MemOrderAcquire);
                 continue;
             }
 
-            if RAD_LIKELY (m_storage.CompareExchangeWeak(ptr,
-                                                         ptr | ExclusiveFlag,
-                                                         MemOrderAcqRel,
-                                                         MemOrderRelaxed))
+            if RAD_LIKELY (m_storage.CompareExchangeWeak(
+                               ptr,
+                               ptr.WithTag(ptr.Tag() | ExclusiveFlag),
+                               MemOrderAcqRel,
+                               MemOrderRelaxed))
             {
                 break;
             }
         }
 
-        for (; ptr & SharedMax; RAD_YIELD_PROCESSOR())
+        for (; ptr.Tag() & SharedMax; RAD_YIELD_PROCESSOR())
         {
             ptr = m_storage.Load(MemOrderAcquire);
         }
@@ -1087,11 +1654,223 @@ public:
 
 private:
 
-    Atomic<uintptr_t> m_storage{ 0 };
+    StorageType m_storage;
 };
 
 } // namespace detail
 
+#if RAD_LOCK_FREE_ATOMIC_SHARED_PTR
+/// @brief Object for atomically managing a shared pointer strong reference.
+/// @details Lock-free implementation using split reference counts. The control
+/// block, the offset of the stored pointer into it and a count of references
+/// claimed by readers share a single double-width word. A non-empty object
+/// holds a batch of strong references on the block up front, so Load() claims
+/// one with a single compare-exchange and never touches a block it does not
+/// already own a reference to. Readers return claimed references to the batch
+/// once half of it is used, so UseCount() of a stored pointer reports more
+/// owners than there are SharedPtr instances.
+/// @warning Load() is not strictly lock-free. Once readers have claimed the
+/// whole batch, which takes thousands of them between their compare-exchange
+/// and returning their claims, further Load() calls spin until one of them
+/// does. A reader preempted at that point can therefore block the others.
+/// @tparam T Type held in a shared pointer.
+template <typename T>
+class AtomicSharedPtr final
+{
+    using BlockType = detail::PtrBlockBase;
+    using StorageType = detail::atomic::AtomicDoubleWord;
+    using StateType = detail::atomic::DoubleWord;
+
+    static constexpr uint32_t BatchSize = 1u << 14;
+    static constexpr uint64_t CountMask = 0xffffffff;
+    static constexpr uint32_t CountShift = 32;
+
+public:
+
+    using ThisType = AtomicSharedPtr<T>;
+    using ValueType = SharedPtr<T>;
+
+    ~AtomicSharedPtr()
+    {
+        const StateType state = m_state.Load();
+        BlockType* block = Block(state);
+        if (block)
+        {
+            block->Release(BatchSize - Count(state));
+        }
+    }
+
+    constexpr AtomicSharedPtr() noexcept = default;
+
+    constexpr AtomicSharedPtr(rad::nullptr_t) noexcept
+        : m_state()
+    {
+    }
+
+    /// @brief Constructs from an existing shared pointer.
+    /// @param value Shared pointer to store.
+    AtomicSharedPtr(const ValueType& value) noexcept
+        : m_state(Pack(value.m_block, value.m_ptr))
+    {
+        if (value.m_block)
+        {
+            value.m_block->Acquire(BatchSize);
+        }
+    }
+
+    RAD_NOT_COPYABLE(AtomicSharedPtr);
+
+    /// @brief Stores a shared pointer in the atomic storage.
+    /// @param value Shared pointer to store.
+    void Store(ValueType value) noexcept
+    {
+        ValueType prev = Exchange(Move(value));
+    }
+
+    /// @brief Loads the shared pointer from atomic storage.
+    /// @details Spins while the batch is exhausted, see the class
+    /// documentation.
+    /// @return Shared pointer.
+    RAD_NODISCARD ValueType Load() const noexcept
+    {
+        ValueType res;
+        StateType state = m_state.Load();
+        for (;;)
+        {
+            if (Block(state) == nullptr)
+            {
+                return res;
+            }
+
+            // the batch keeps at least one reference for the stored pointer,
+            // and taking one outside it needs a reference on the block
+            // already, so wait for readers to return theirs
+            if RAD_UNLIKELY (Count(state) >= BatchSize - 1)
+            {
+                RAD_YIELD_PROCESSOR();
+                state = m_state.Load();
+                continue;
+            }
+
+            if RAD_LIKELY (m_state.CompareExchange(
+                               state,
+                               StateType{ state.low, state.high + 1 }))
+            {
+                break;
+            }
+        }
+
+        res.m_block = Block(state);
+        res.m_ptr = Ptr(state);
+
+        const uint32_t claimed = Count(state) + 1;
+        if RAD_UNLIKELY (claimed >= BatchSize / 2)
+        {
+            Replenish(res.m_block, claimed);
+        }
+
+        return res;
+    }
+
+    /// @brief Exchanges the stored shared pointer with another.
+    /// @param value Shared pointer to store.
+    /// @return Previously stored shared pointer.
+    RAD_NODISCARD ValueType Exchange(ValueType value) noexcept
+    {
+        const StateType desired = Pack(value.m_block, value.m_ptr);
+        if (value.m_block)
+        {
+            value.m_block->Acquire(BatchSize - 1);
+        }
+        value.m_block = nullptr;
+        value.m_ptr = nullptr;
+
+        StateType state = m_state.Load();
+        while (!m_state.CompareExchange(state, desired))
+        {
+        }
+
+        ValueType res;
+        res.m_block = Block(state);
+        res.m_ptr = Ptr(state);
+
+        // keep one of the unclaimed references for the result
+        const uint32_t unclaimed = BatchSize - Count(state);
+        if (res.m_block && unclaimed > 1)
+        {
+            res.m_block->Release(unclaimed - 1);
+        }
+
+        return res;
+    }
+
+    void operator=(ValueType value) noexcept
+    {
+        Store(Move(value));
+    }
+
+    operator ValueType() const noexcept
+    {
+        return Load();
+    }
+
+private:
+
+    static StateType Pack(BlockType* block, T* ptr) noexcept
+    {
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block);
+        const uint64_t offset =
+            block ? reinterpret_cast<uintptr_t>(ptr) - base : 0;
+        RAD_ASSERT(offset <= CountMask);
+        return StateType{ base, offset << CountShift };
+    }
+
+    static BlockType* Block(const StateType& state) noexcept
+    {
+        return reinterpret_cast<BlockType*>(static_cast<uintptr_t>(state.low));
+    }
+
+    static T* Ptr(const StateType& state) noexcept
+    {
+        if (state.low == 0)
+        {
+            return nullptr;
+        }
+
+        return reinterpret_cast<T*>(
+            static_cast<uintptr_t>(state.low + (state.high >> CountShift)));
+    }
+
+    static uint32_t Count(const StateType& state) noexcept
+    {
+        return static_cast<uint32_t>(state.high & CountMask);
+    }
+
+    // Moves references claimed by a reader back into the batch. Other readers
+    // may have claimed more in the meantime, and the block may have been
+    // replaced and stored again, the references belong to the block either
+    // way. The caller owns a reference so the block stays alive throughout.
+    void Replenish(BlockType* block, uint32_t claimed) const noexcept
+    {
+        block->Acquire(claimed);
+
+        StateType state = m_state.Load();
+        while (Block(state) == block && Count(state) >= claimed)
+        {
+            if (m_state.CompareExchange(
+                    state,
+                    StateType{ state.low, state.high - claimed }))
+            {
+                return;
+            }
+        }
+
+        block->Release(claimed);
+    }
+
+    mutable StorageType m_state;
+};
+#else
 /// @brief Object for atomically managing a shared pointer strong reference.
 /// @tparam T Type held in a shared pointer.
 /// @tparam TAlloc Allocator for the shared pointer.
@@ -1199,6 +1978,7 @@ private:
     mutable LockType m_block;
     Atomic<T*> m_ptr{ nullptr };
 };
+#endif
 
 /// @brief Object for atomically managing a weak pointer reference.
 /// @tparam T Type held in a weak pointer.
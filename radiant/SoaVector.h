@@ -0,0 +1,650 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/GrowthPolicy.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/Span.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+#include "radiant/detail/Meta.h"
+#include "radiant/detail/VectorOperations.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Column pointers of a SoaVector, one per type,
+/// along with the operations applied to every column of a range of rows.
+template <typename... Ts>
+struct SoaColumns
+{
+    static constexpr size_t RowBytes = 0;
+    static constexpr size_t Padding = 0;
+    static constexpr bool IsNoThrowDefault = true;
+    static constexpr bool IsNoThrowCopy = true;
+
+    template <typename... Us>
+    static constexpr bool IsNoThrowFrom() noexcept
+    {
+        return true;
+    }
+
+    void Place(char* base, size_t offset, uint32_t capacity) noexcept
+    {
+        RAD_UNUSED(base);
+        RAD_UNUSED(offset);
+        RAD_UNUSED(capacity);
+    }
+
+    void Relocate(SoaColumns& dest, uint32_t count) noexcept
+    {
+        RAD_UNUSED(dest);
+        RAD_UNUSED(count);
+    }
+
+    void Construct(uint32_t index) noexcept
+    {
+        RAD_UNUSED(index);
+    }
+
+    void DefaultCtor(uint32_t index, uint32_t count) noexcept
+    {
+        RAD_UNUSED(index);
+        RAD_UNUSED(count);
+    }
+
+    void CopyTo(SoaColumns& dest, uint32_t count) const noexcept
+    {
+        RAD_UNUSED(dest);
+        RAD_UNUSED(count);
+    }
+
+    void Destroy(uint32_t first, uint32_t last) noexcept
+    {
+        RAD_UNUSED(first);
+        RAD_UNUSED(last);
+    }
+
+    void MoveRows(uint32_t dest, uint32_t src, uint32_t count) noexcept
+    {
+        RAD_UNUSED(dest);
+        RAD_UNUSED(src);
+        RAD_UNUSED(count);
+    }
+};
+
+template <typename T, typename... Ts>
+struct SoaColumns<T, Ts...>
+{
+    using Rest = SoaColumns<Ts...>;
+    using ManipType = VectorManipulation<T>;
+
+    RAD_S_ASSERTMSG(alignof(T) <= alignof(max_align_t),
+                    "SoaVector does not support over-aligned columns");
+
+    static constexpr size_t RowBytes = sizeof(T) + Rest::RowBytes;
+    // most bytes lost to aligning the columns after the first
+    static constexpr size_t Padding = alignof(T) - 1 + Rest::Padding;
+    static constexpr bool IsNoThrowDefault =
+        IsNoThrowDefaultCtor<T> && Rest::IsNoThrowDefault;
+    static constexpr bool IsNoThrowCopy =
+        IsNoThrowCopyCtor<T> && Rest::IsNoThrowCopy;
+
+    template <typename U, typename... Us>
+    static constexpr bool IsNoThrowFrom() noexcept
+    {
+        return IsNoThrowCtor<T, U&&> && Rest::template IsNoThrowFrom<Us...>();
+    }
+
+    // points the columns into a block of capacity rows
+    void Place(char* base, size_t offset, uint32_t capacity) noexcept
+    {
+        offset = (offset + alignof(T) - 1) & ~(alignof(T) - 1);
+        data = reinterpret_cast<T*>(base + offset);
+        rest.Place(base, offset + capacity * sizeof(T), capacity);
+    }
+
+    void Relocate(SoaColumns& dest, uint32_t count) noexcept
+    {
+        ManipType().MoveCtorDtorSrcRange(dest.data, data, count);
+        rest.Relocate(dest.rest, count);
+    }
+
+    template <typename U, typename... Us>
+    void Construct(uint32_t index, U&& value, Us&&... values) noexcept(
+        IsNoThrowFrom<U, Us...>())
+    {
+        ::new (static_cast<void*>(data + index)) T(Forward<U>(value));
+        rest.Construct(index, Forward<Us>(values)...);
+    }
+
+    void DefaultCtor(uint32_t index, uint32_t count) noexcept(IsNoThrowDefault)
+    {
+        ManipType().DefaultCtor(data + index, count);
+        rest.DefaultCtor(index, count);
+    }
+
+    void CopyTo(SoaColumns& dest, uint32_t count) const
+        noexcept(IsNoThrowCopy)
+    {
+        ManipType().CopyCtorRange(dest.data, data, count);
+        rest.CopyTo(dest.rest, count);
+    }
+
+    void Destroy(uint32_t first, uint32_t last) noexcept
+    {
+        ManipType().DtorRange(data + first, data + last);
+        rest.Destroy(first, last);
+    }
+
+    // move assigns count rows at src to dest, which comes first
+    void MoveRows(uint32_t dest, uint32_t src, uint32_t count) noexcept
+    {
+        ManipType().MoveAssignRange(data + dest, data + src, count);
+        rest.MoveRows(dest, src, count);
+    }
+
+    T* data = nullptr;
+    Rest rest;
+};
+
+/// @brief Internal use only. Gets column I of a SoaColumns.
+template <size_t I>
+struct SoaColumnAt
+{
+    template <typename TColumns>
+    static auto Get(TColumns& columns) noexcept
+    {
+        return SoaColumnAt<I - 1>::Get(columns.rest);
+    }
+};
+
+template <>
+struct SoaColumnAt<0>
+{
+    template <typename TColumns>
+    static auto Get(TColumns& columns) noexcept
+    {
+        return columns.data;
+    }
+};
+
+} // namespace detail
+
+/// @brief Vector of rows whose fields are each stored in their own
+/// contiguous column.
+/// @details A loop reading a few fields of every row only pulls those
+/// columns through the cache, instead of whole rows as a Vector of structs
+/// would, and each column is a plain array the compiler can vectorize over.
+/// Column<I>() exposes column I as a Span.
+///
+/// All columns live in a single allocation and grow together, following
+/// GrowByHalf, with the elements moved by the same machinery as Vector.
+/// Growth invalidates spans and pointers into the columns.
+/// @tparam TAllocator Allocator used for the columns. It comes first as the
+/// column types are variadic.
+/// @tparam Ts Column types, which must be nothrow move constructible and no
+/// more aligned than max_align_t.
+template <typename TAllocator, typename... Ts>
+class SoaVector final
+{
+private:
+
+    using AllocatorTraits = AllocTraits<TAllocator>;
+    using ColumnsType = detail::SoaColumns<Ts...>;
+    using UnitType = max_align_t;
+    using GrowthType = GrowByHalf;
+
+    struct State
+    {
+        ColumnsType columns;
+        uint32_t size = 0;
+        uint32_t capacity = 0;
+    };
+
+public:
+
+    using ThisType = SoaVector<TAllocator, Ts...>;
+    using SizeType = uint32_t;
+    using AllocatorType = TAllocator;
+
+    /// @brief Type of column I.
+    template <size_t I>
+    using ColumnType = typename meta::GetAt<I, meta::TypeList<Ts...>>::Type;
+
+    /// @brief Number of columns.
+    static constexpr size_t ColumnCount = sizeof...(Ts);
+
+    RAD_S_ASSERTMSG(sizeof...(Ts) > 0, "SoaVector needs at least one column");
+    RAD_S_ASSERTMSG(
+        (meta::And<meta::integral_constant<
+             bool,
+             IsNoThrowMoveCtor<Ts> && IsNoThrowDtor<Ts>>...>::value),
+        "SoaVector requires nothrow move and destruction");
+
+    RAD_NOT_COPYABLE(SoaVector);
+
+    ~SoaVector()
+    {
+        Release();
+    }
+
+    /// @brief Constructs an empty container with a default-constructed
+    /// allocator.
+    SoaVector() noexcept = default;
+
+    /// @brief Constructs an empty container with a copy-constructed
+    /// allocator.
+    /// @param alloc Allocator to copy.
+    explicit SoaVector(const AllocatorType& alloc) noexcept
+        : m_storage(alloc)
+    {
+    }
+
+    /// @brief Move constructs a container from another, leaving it empty.
+    /// @param other Container to steal from.
+    SoaVector(ThisType&& other) noexcept
+        : m_storage(other.Allocator())
+    {
+        St() = other.St();
+        other.St() = State();
+    }
+
+    /// @brief Moves the rows of another container into this, leaving it
+    /// empty.
+    /// @param other Container to move rows from.
+    /// @return Reference to this container.
+    ThisType& operator=(ThisType&& other) noexcept
+    {
+        // Don't allow non-propagation of allocators
+        RAD_S_ASSERTMSG(
+            AllocatorTraits::IsAlwaysEqual ||
+                AllocatorTraits::PropagateOnMoveAssignment,
+            "Cannot use move assignment with this allocator, as it could cause "
+            "copies. Either change allocators, or use something like Clone().");
+
+        if RAD_UNLIKELY (this == &other)
+        {
+            return *this;
+        }
+
+        Release();
+        AllocatorTraits::PropagateOnMoveIfNeeded(Allocator(),
+                                                 other.Allocator());
+        St() = other.St();
+        other.St() = State();
+        return *this;
+    }
+
+    /// @brief Checks if the container is empty.
+    /// @return True if there are no rows.
+    bool Empty() const noexcept
+    {
+        return St().size == 0;
+    }
+
+    /// @brief Gets the number of rows.
+    /// @return Number of rows.
+    SizeType Size() const noexcept
+    {
+        return St().size;
+    }
+
+    /// @brief Gets the number of rows the columns have room for.
+    /// @return Capacity in rows.
+    SizeType Capacity() const noexcept
+    {
+        return St().capacity;
+    }
+
+    /// @brief Gets column I.
+    /// @return The elements of the column, one per row.
+    template <size_t I>
+    Span<ColumnType<I>> Column() noexcept
+    {
+        return Span<ColumnType<I>>(Data<I>(), St().size);
+    }
+
+    /// @copydoc Column
+    template <size_t I>
+    Span<const ColumnType<I>> Column() const noexcept
+    {
+        return Span<const ColumnType<I>>(Data<I>(), St().size);
+    }
+
+    /// @brief Gets the first element of column I.
+    /// @return Pointer to the column, nullptr if nothing was ever allocated.
+    template <size_t I>
+    ColumnType<I>* Data() noexcept
+    {
+        return detail::SoaColumnAt<I>::Get(St().columns);
+    }
+
+    /// @copydoc Data
+    template <size_t I>
+    const ColumnType<I>* Data() const noexcept
+    {
+        return detail::SoaColumnAt<I>::Get(St().columns);
+    }
+
+    /// @brief Gets the field of a row in column I. Calling At with an index
+    /// past the end is erroneous.
+    /// @param index Row index.
+    /// @return The field.
+    template <size_t I>
+    ColumnType<I>& At(SizeType index) noexcept
+    {
+        RAD_ASSERT(index < St().size);
+        return Data<I>()[index];
+    }
+
+    /// @copydoc At
+    template <size_t I>
+    const ColumnType<I>& At(SizeType index) const noexcept
+    {
+        RAD_ASSERT(index < St().size);
+        return Data<I>()[index];
+    }
+
+    /// @brief Grows the columns to hold at least capacity rows.
+    /// @param capacity Number of rows to make room for.
+    /// @return Reference to this container, or Error::NoMemory.
+    Res<ThisType&> Reserve(SizeType capacity) noexcept
+    {
+        if (capacity > St().capacity)
+        {
+            Err res = Grow(capacity);
+            if (res.IsErr())
+            {
+                return res.Err();
+            }
+        }
+
+        return *this;
+    }
+
+    /// @brief Appends a row constructed from one argument per column.
+    /// @param args Arguments, constructing the field of each column in turn.
+    /// @return Reference to this container, or an error if it could not
+    /// grow.
+    template <typename... TArgs>
+    Res<ThisType&> EmplaceBack(TArgs&&... args) noexcept(
+        ColumnsType::template IsNoThrowFrom<TArgs...>())
+    {
+        RAD_S_ASSERTMSG(sizeof...(TArgs) == sizeof...(Ts),
+                        "EmplaceBack takes one argument per column");
+        RAD_S_ASSERT_NOTHROW(
+            (ColumnsType::template IsNoThrowFrom<TArgs...>()));
+
+        State& st = St();
+        if (st.size == st.capacity)
+        {
+            if RAD_UNLIKELY (st.size == UINT32_MAX)
+            {
+                return Error::IntegerOverflow;
+            }
+
+            Err res = Grow(GrowthType::Next(st.capacity,
+                                            st.size + 1,
+                                            ColumnsType::RowBytes));
+            if (res.IsErr())
+            {
+                return res.Err();
+            }
+        }
+
+        st.columns.Construct(st.size, Forward<TArgs>(args)...);
+        ++st.size;
+        return *this;
+    }
+
+    /// @brief Appends a row of copied fields.
+    /// @param values Field of each column.
+    /// @return Reference to this container, or an error if it could not
+    /// grow.
+    Res<ThisType&> PushBack(const Ts&... values) noexcept(
+        ColumnsType::IsNoThrowCopy)
+    {
+        return EmplaceBack(values...);
+    }
+
+    /// @brief Removes the last row. Calling PopBack while the container is
+    /// empty is erroneous.
+    /// @return Reference to this container.
+    ThisType& PopBack() noexcept
+    {
+        RAD_ASSERT(St().size > 0);
+        --St().size;
+        St().columns.Destroy(St().size, St().size + 1);
+        return *this;
+    }
+
+    /// @brief Grows or shrinks to count rows, value-initializing new ones.
+    /// @param count Number of rows.
+    /// @return Reference to this container, or Error::NoMemory.
+    Res<ThisType&> Resize(SizeType count) noexcept(
+        ColumnsType::IsNoThrowDefault)
+    {
+        RAD_S_ASSERT_NOTHROW(ColumnsType::IsNoThrowDefault);
+
+        State& st = St();
+        if (count < st.size)
+        {
+            st.columns.Destroy(count, st.size);
+        }
+        else if (count > st.size)
+        {
+            if (count > st.capacity)
+            {
+                Err res = Grow(GrowthType::Next(st.capacity,
+                                                count,
+                                                ColumnsType::RowBytes));
+                if (res.IsErr())
+                {
+                    return res.Err();
+                }
+            }
+
+            st.columns.DefaultCtor(st.size, count - st.size);
+        }
+
+        st.size = count;
+        return *this;
+    }
+
+    /// @brief Removes a row, shifting the following rows down. Calling Erase
+    /// with an index past the end is erroneous.
+    /// @param index Row to remove.
+    /// @return Reference to this container.
+    ThisType& Erase(SizeType index) noexcept
+    {
+        State& st = St();
+        RAD_ASSERT(index < st.size);
+        st.columns.MoveRows(index, index + 1, st.size - index - 1);
+        --st.size;
+        st.columns.Destroy(st.size, st.size + 1);
+        return *this;
+    }
+
+    /// @brief Removes a row in O(1) by moving the last row into its place.
+    /// Calling EraseUnordered with an index past the end is erroneous.
+    /// @param index Row to remove.
+    /// @return Reference to this container.
+    ThisType& EraseUnordered(SizeType index) noexcept
+    {
+        State& st = St();
+        RAD_ASSERT(index < st.size);
+        --st.size;
+        if (index != st.size)
+        {
+            st.columns.MoveRows(index, st.size, 1);
+        }
+
+        st.columns.Destroy(st.size, st.size + 1);
+        return *this;
+    }
+
+    /// @brief Destroys every row, keeping the capacity.
+    /// @return Reference to this container.
+    ThisType& Clear() noexcept
+    {
+        St().columns.Destroy(0, St().size);
+        St().size = 0;
+        return *this;
+    }
+
+    /// @brief Exchanges the contents of two containers.
+    /// @param other Container to swap with.
+    /// @return Reference to this container.
+    ThisType& Swap(ThisType& other) noexcept
+    {
+        // Don't allow non-propagation of allocators
+        RAD_S_ASSERTMSG(
+            AllocatorTraits::IsAlwaysEqual || AllocatorTraits::PropagateOnSwap,
+            "Cannot use Swap with this allocator, as it could cause copies. "
+            "Either change allocators, or use move construction.");
+
+        const State state = St();
+        St() = other.St();
+        other.St() = state;
+        AllocatorTraits::PropagateOnSwapIfNeeded(Allocator(),
+                                                 other.Allocator());
+        return *this;
+    }
+
+    /// @brief Creates a copy of the container.
+    /// @return The new container on success or an error.
+    Res<ThisType> Clone() const noexcept(ColumnsType::IsNoThrowCopy)
+    {
+        RAD_S_ASSERT_NOTHROW(ColumnsType::IsNoThrowCopy);
+
+        ThisType local(AllocatorTraits::SelectAllocOnCopy(
+            const_cast<TAllocator&>(Allocator())));
+        if (St().size != 0)
+        {
+            Err res = local.Grow(St().size);
+            if (res.IsErr())
+            {
+                return res.Err();
+            }
+
+            St().columns.CopyTo(local.St().columns, St().size);
+            local.St().size = St().size;
+        }
+
+        return local;
+    }
+
+    /// @brief Returns the allocator.
+    /// @return The allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return Allocator();
+    }
+
+private:
+
+    static size_t Units(uint32_t capacity) noexcept
+    {
+        return (capacity * ColumnsType::RowBytes + ColumnsType::Padding +
+                sizeof(UnitType) - 1) /
+               sizeof(UnitType);
+    }
+
+    // moves the rows to a block of capacity rows
+    Err Grow(uint32_t capacity) noexcept
+    {
+        if RAD_UNLIKELY (capacity > (SIZE_MAX - ColumnsType::Padding -
+                                     sizeof(UnitType)) /
+                                        ColumnsType::RowBytes)
+        {
+            return Error::IntegerOverflow;
+        }
+
+        UnitType* block = AllocatorTraits::template Alloc<UnitType>(
+            Allocator(),
+            Units(capacity));
+        if (block == nullptr)
+        {
+            return Error::NoMemory;
+        }
+
+        State& st = St();
+        ColumnsType columns;
+        columns.Place(reinterpret_cast<char*>(block), 0, capacity);
+        if (st.capacity != 0)
+        {
+            st.columns.Relocate(columns, st.size);
+            FreeBlock();
+        }
+
+        st.columns = columns;
+        st.capacity = capacity;
+        return NoError;
+    }
+
+    // the first column starts the block
+    void FreeBlock() noexcept
+    {
+        AllocatorTraits::Free(
+            Allocator(),
+            reinterpret_cast<UnitType*>(St().columns.data),
+            Units(St().capacity));
+    }
+
+    void Release() noexcept
+    {
+        if (St().capacity != 0)
+        {
+            St().columns.Destroy(0, St().size);
+            FreeBlock();
+        }
+
+        St() = State();
+    }
+
+    TAllocator& Allocator() noexcept
+    {
+        return m_storage.First();
+    }
+
+    const TAllocator& Allocator() const noexcept
+    {
+        return m_storage.First();
+    }
+
+    State& St() noexcept
+    {
+        return m_storage.Second();
+    }
+
+    const State& St() const noexcept
+    {
+        return m_storage.Second();
+    }
+
+    EmptyOptimizedPair<TAllocator, State> m_storage;
+};
+
+} // namespace rad
@@ -0,0 +1,523 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Byte.h"
+#include "radiant/Res.h"
+#include "radiant/Span.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/detail/Bits.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace rad
+{
+
+/// @brief Order in which the bytes of a multi-byte integer are stored.
+enum class ByteOrder
+{
+    Little,
+    Big,
+};
+
+namespace detail
+{
+
+// Integers are copied out of and into the bytes with memcpy, which compiles
+// to a single unaligned load or store, and swapped when the requested order
+// differs from the host's.
+template <size_t N>
+struct CursorWord;
+
+template <>
+struct CursorWord<1>
+{
+    using Type = uint8_t;
+};
+
+template <>
+struct CursorWord<2>
+{
+    using Type = uint16_t;
+};
+
+template <>
+struct CursorWord<4>
+{
+    using Type = uint32_t;
+};
+
+template <>
+struct CursorWord<8>
+{
+    using Type = uint64_t;
+};
+
+/// @brief Internal use only. Fixed-width unsigned type of the same size as
+/// T, so that long and long long pick the same byte swap as their width.
+template <typename T>
+using CursorUnsigned = typename CursorWord<sizeof(T)>::Type;
+
+template <typename T>
+RAD_INLINE_VAR constexpr bool CursorIsInteger =
+    IsIntegral<T> && !IsSame<T, bool>;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static constexpr ByteOrder CursorHostOrder = ByteOrder::Big;
+#else
+static constexpr ByteOrder CursorHostOrder = ByteOrder::Little;
+#endif
+
+template <typename U>
+U CursorReorder(U value, ByteOrder order) noexcept
+{
+    return order == CursorHostOrder ? value : BitByteSwap(value);
+}
+
+template <typename T>
+CursorUnsigned<T> CursorLoad(const Byte* data, ByteOrder order) noexcept
+{
+    CursorUnsigned<T> value;
+    memcpy(&value, data, sizeof(value));
+    return CursorReorder(value, order);
+}
+
+template <typename T>
+void CursorStore(Byte* data, CursorUnsigned<T> value, ByteOrder order) noexcept
+{
+    value = CursorReorder(value, order);
+    memcpy(data, &value, sizeof(value));
+}
+
+/// @brief Longest encoding of a 64-bit varint.
+static constexpr SpanSizeType CursorMaxVarintSize = 10;
+
+} // namespace detail
+
+/// @brief Forward cursor for decoding binary data in place.
+/// @details The reader views the bytes it was given and never copies them.
+/// Sub-spans it hands out point into the same bytes and are valid for as
+/// long as those are. Every read is checked against the end of the data and
+/// fails with Error::OutOfRange, leaving the position unchanged, rather than
+/// reading past it.
+class SpanReader final
+{
+public:
+
+    /// @brief Constructs a reader over no data.
+    constexpr SpanReader() noexcept = default;
+
+    /// @brief Constructs a reader positioned at the first byte of @p data.
+    constexpr explicit SpanReader(Span<const Byte> data) noexcept
+        : m_data(data)
+    {
+    }
+
+    /// @brief Number of bytes being read.
+    constexpr SpanSizeType Size() const noexcept
+    {
+        return m_data.Size();
+    }
+
+    /// @brief Offset of the next byte to be read.
+    constexpr SpanSizeType Position() const noexcept
+    {
+        return m_position;
+    }
+
+    /// @brief Number of bytes left to read.
+    constexpr SpanSizeType Remaining() const noexcept
+    {
+        return m_data.Size() - m_position;
+    }
+
+    /// @brief Checks whether every byte has been read.
+    constexpr bool AtEnd() const noexcept
+    {
+        return m_position == m_data.Size();
+    }
+
+    /// @brief Every byte being read, including those already read.
+    constexpr Span<const Byte> Data() const noexcept
+    {
+        return m_data;
+    }
+
+    /// @brief The bytes left to read.
+    constexpr Span<const Byte> RemainingData() const noexcept
+    {
+        return m_data.Subspan(m_position);
+    }
+
+    /// @brief Moves the position to an absolute offset.
+    /// @param position Offset to read from next, at most Size().
+    Err Seek(SpanSizeType position) noexcept
+    {
+        if (position > m_data.Size())
+        {
+            return Error::OutOfRange;
+        }
+
+        m_position = position;
+        return NoError;
+    }
+
+    /// @brief Moves the position forward without reading.
+    Err Skip(SpanSizeType count) noexcept
+    {
+        if (count > Remaining())
+        {
+            return Error::OutOfRange;
+        }
+
+        m_position += count;
+        return NoError;
+    }
+
+    /// @brief Reads a single byte.
+    Res<uint8_t> ReadU8() noexcept
+    {
+        if (AtEnd())
+        {
+            return Error::OutOfRange;
+        }
+
+        return static_cast<uint8_t>(m_data.Data()[m_position++]);
+    }
+
+    /// @brief Reads a fixed-width integer in the given byte order.
+    /// @tparam T Integer type to read, of any width and signedness.
+    template <typename T>
+    Res<T> Read(ByteOrder order) noexcept
+    {
+        RAD_S_ASSERTMSG(detail::CursorIsInteger<T>,
+                        "SpanReader reads integer types");
+
+        if (sizeof(T) > Remaining())
+        {
+            return Error::OutOfRange;
+        }
+
+        const auto value =
+            detail::CursorLoad<T>(m_data.Data() + m_position, order);
+        m_position += static_cast<SpanSizeType>(sizeof(T));
+        return static_cast<T>(value);
+    }
+
+    /// @brief Reads a little-endian fixed-width integer.
+    template <typename T>
+    Res<T> ReadLittle() noexcept
+    {
+        return Read<T>(ByteOrder::Little);
+    }
+
+    /// @brief Reads a big-endian fixed-width integer.
+    template <typename T>
+    Res<T> ReadBig() noexcept
+    {
+        return Read<T>(ByteOrder::Big);
+    }
+
+    /// @brief Reads an unsigned LEB128 varint, seven bits to a byte with the
+    /// high bit set on all but the last.
+    /// @details Fails with Error::OutOfRange if the data ends before the
+    /// last byte, and with Error::IntegerOverflow if the value does not fit
+    /// in 64 bits.
+    Res<uint64_t> ReadVarint() noexcept
+    {
+        const Byte* const data = m_data.Data() + m_position;
+        const SpanSizeType available = Remaining();
+        const SpanSizeType limit = available < detail::CursorMaxVarintSize
+                                       ? available
+                                       : detail::CursorMaxVarintSize;
+
+        uint64_t value = 0;
+        for (SpanSizeType i = 0; i < limit; ++i)
+        {
+            const auto byte = static_cast<uint64_t>(data[i]);
+            if (i == detail::CursorMaxVarintSize - 1 && byte > 1)
+            {
+                return Error::IntegerOverflow;
+            }
+
+            value |= (byte & 0x7f) << (7 * i);
+            if ((byte & 0x80) == 0)
+            {
+                m_position += i + 1;
+                return value;
+            }
+        }
+
+        if (limit == detail::CursorMaxVarintSize)
+        {
+            return Error::IntegerOverflow;
+        }
+
+        return Error::OutOfRange;
+    }
+
+    /// @brief Reads a signed varint stored with zigzag encoding, which maps
+    /// small negative values to small unsigned ones.
+    Res<int64_t> ReadSignedVarint() noexcept
+    {
+        const Res<uint64_t> res = ReadVarint();
+        if (res.IsErr())
+        {
+            return res.Err();
+        }
+
+        const uint64_t value = res.Ok();
+        return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
+    /// @brief Takes the next bytes as a view into the data, without copying.
+    /// @param count Number of bytes to take.
+    Res<Span<const Byte>> ReadSpan(SpanSizeType count) noexcept
+    {
+        if (count > Remaining())
+        {
+            return Error::OutOfRange;
+        }
+
+        const Span<const Byte> span = m_data.Subspan(m_position, count);
+        m_position += count;
+        return span;
+    }
+
+    /// @brief Takes the next bytes as a reader of their own, such as for a
+    /// length-prefixed nested message.
+    /// @param count Number of bytes the new reader covers.
+    Res<SpanReader> ReadReader(SpanSizeType count) noexcept
+    {
+        const Res<Span<const Byte>> res = ReadSpan(count);
+        if (res.IsErr())
+        {
+            return res.Err();
+        }
+
+        return SpanReader(res.Ok());
+    }
+
+    /// @brief Copies the next bytes out of the data.
+    /// @param out Destination, filled completely.
+    Err ReadInto(Span<Byte> out) noexcept
+    {
+        if (out.Size() > Remaining())
+        {
+            return Error::OutOfRange;
+        }
+
+        if (!out.Empty())
+        {
+            memcpy(out.Data(), m_data.Data() + m_position, out.Size());
+        }
+
+        m_position += out.Size();
+        return NoError;
+    }
+
+private:
+
+    Span<const Byte> m_data;
+    SpanSizeType m_position = 0;
+};
+
+/// @brief Forward cursor for encoding binary data into a caller-owned
+/// buffer.
+/// @details Every write is checked against the end of the buffer and fails
+/// with Error::OutOfRange, writing nothing and leaving the position
+/// unchanged, rather than writing past it.
+class SpanWriter final
+{
+public:
+
+    /// @brief Constructs a writer with no space.
+    constexpr SpanWriter() noexcept = default;
+
+    /// @brief Constructs a writer positioned at the first byte of @p data.
+    constexpr explicit SpanWriter(Span<Byte> data) noexcept
+        : m_data(data)
+    {
+    }
+
+    /// @brief Number of bytes in the buffer.
+    constexpr SpanSizeType Size() const noexcept
+    {
+        return m_data.Size();
+    }
+
+    /// @brief Offset of the next byte to be written, which is also the
+    /// number of bytes written so far.
+    constexpr SpanSizeType Position() const noexcept
+    {
+        return m_position;
+    }
+
+    /// @brief Number of bytes of space left.
+    constexpr SpanSizeType Remaining() const noexcept
+    {
+        return m_data.Size() - m_position;
+    }
+
+    /// @brief The bytes written so far.
+    constexpr Span<Byte> Written() const noexcept
+    {
+        return m_data.First(m_position);
+    }
+
+    /// @brief Writes a single byte.
+    Err WriteU8(uint8_t value) noexcept
+    {
+        if (Remaining() == 0)
+        {
+            return Error::OutOfRange;
+        }
+
+        m_data.Data()[m_position++] = static_cast<Byte>(value);
+        return NoError;
+    }
+
+    /// @brief Writes a fixed-width integer in the given byte order.
+    /// @tparam T Integer type to write, of any width and signedness.
+    template <typename T>
+    Err Write(T value, ByteOrder order) noexcept
+    {
+        RAD_S_ASSERTMSG(detail::CursorIsInteger<T>,
+                        "SpanWriter writes integer types");
+
+        if (sizeof(T) > Remaining())
+        {
+            return Error::OutOfRange;
+        }
+
+        detail::CursorStore<T>(m_data.Data() + m_position,
+                               static_cast<detail::CursorUnsigned<T>>(value),
+                               order);
+        m_position += static_cast<SpanSizeType>(sizeof(T));
+        return NoError;
+    }
+
+    /// @brief Writes a little-endian fixed-width integer.
+    template <typename T>
+    Err WriteLittle(T value) noexcept
+    {
+        return Write<T>(value, ByteOrder::Little);
+    }
+
+    /// @brief Writes a big-endian fixed-width integer.
+    template <typename T>
+    Err WriteBig(T value) noexcept
+    {
+        return Write<T>(value, ByteOrder::Big);
+    }
+
+    /// @brief Writes an unsigned LEB128 varint.
+    /// @see SpanReader::ReadVarint
+    Err WriteVarint(uint64_t value) noexcept
+    {
+        SpanSizeType size = 1;
+        for (uint64_t rest = value >> 7; rest != 0; rest >>= 7)
+        {
+            ++size;
+        }
+
+        if (size > Remaining())
+        {
+            return Error::OutOfRange;
+        }
+
+        Byte* const data = m_data.Data() + m_position;
+        for (SpanSizeType i = 0; i + 1 < size; ++i)
+        {
+            data[i] = static_cast<Byte>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+
+        data[size - 1] = static_cast<Byte>(value);
+        m_position += size;
+        return NoError;
+    }
+
+    /// @brief Writes a signed varint with zigzag encoding.
+    /// @see SpanReader::ReadSignedVarint
+    Err WriteSignedVarint(int64_t value) noexcept
+    {
+        const uint64_t sign = value < 0 ? ~uint64_t(0) : 0;
+        return WriteVarint((static_cast<uint64_t>(value) << 1) ^ sign);
+    }
+
+    /// @brief Copies bytes into the buffer.
+    Err Write(Span<const Byte> bytes) noexcept
+    {
+        if (bytes.Size() > Remaining())
+        {
+            return Error::OutOfRange;
+        }
+
+        if (!bytes.Empty())
+        {
+            memcpy(m_data.Data() + m_position, bytes.Data(), bytes.Size());
+        }
+
+        m_position += bytes.Size();
+        return NoError;
+    }
+
+    /// @brief Hands out the next bytes of the buffer to be filled in place,
+    /// such as by a nested encoder or a later length fix-up.
+    /// @param count Number of bytes to take.
+    Res<Span<Byte>> Reserve(SpanSizeType count) noexcept
+    {
+        if (count > Remaining())
+        {
+            return Error::OutOfRange;
+        }
+
+        const Span<Byte> span = m_data.Subspan(m_position, count);
+        m_position += count;
+        return span;
+    }
+
+    /// @brief Hands out the rest of the buffer as a writer of its own.
+    /// @details Nothing is reserved; once the nested writer is done, pass its
+    /// Position() to Skip() to keep what it wrote.
+    SpanWriter RemainingWriter() const noexcept
+    {
+        return SpanWriter(m_data.Subspan(m_position));
+    }
+
+    /// @brief Moves the position forward over bytes written in place.
+    Err Skip(SpanSizeType count) noexcept
+    {
+        if (count > Remaining())
+        {
+            return Error::OutOfRange;
+        }
+
+        m_position += count;
+        return NoError;
+    }
+
+private:
+
+    Span<Byte> m_data;
+    SpanSizeType m_position = 0;
+};
+
+} // namespace rad
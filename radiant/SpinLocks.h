@@ -0,0 +1,428 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+
+#include <stdint.h>
+
+#if !RAD_WINDOWS
+#include <sched.h>
+#endif
+
+// Spin locks implementing the interface expected by the guards in Locks.h.
+// None of them allocate. Waiters back off exponentially on RAD_YIELD_PROCESSOR
+// while the lock is unavailable, and after a bounded spin park on the lock
+// with Atomic Wait(). Where RAD_ATOMIC_WAIT_PARKS is 0, such as in kernel
+// mode, parking keeps polling, so the locks never block in the OS there.
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Exponential backoff for spin loops.
+class SpinBackoff final
+{
+public:
+
+    static constexpr uint32_t MaxSpins = 64;
+
+    /// @brief Yields the processor, twice as long as the previous call up to
+    /// MaxSpins yields.
+    /// @return False once the backoff has reached MaxSpins, after which the
+    /// caller should park rather than keep spinning.
+    bool Pause() noexcept
+    {
+        for (uint32_t i = 0; i < m_spins; ++i)
+        {
+            RAD_YIELD_PROCESSOR();
+        }
+
+        if (m_spins < MaxSpins)
+        {
+            m_spins <<= 1;
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+
+    uint32_t m_spins = 1;
+};
+
+/// @brief Internal use only. Counts the threads parked on a lock word so that
+/// unlocking only issues a wake when somebody sleeps.
+/// @details The unlocking change to the word must be sequentially consistent
+/// so that it is ordered with the parked count read by WakeAll() and
+/// WakeOne().
+class SpinParking final
+{
+public:
+
+    constexpr SpinParking() noexcept = default;
+
+    RAD_NOT_COPYABLE(SpinParking);
+
+    template <typename T>
+    void Park(const Atomic<T>& word, T old) noexcept
+    {
+        m_parked.FetchAdd(1, MemOrderSeqCst);
+        word.Wait(old, MemOrderSeqCst);
+        m_parked.FetchSub(1, MemOrderRelaxed);
+    }
+
+    template <typename T>
+    void WakeAll(Atomic<T>& word) noexcept
+    {
+        if (m_parked.Load(MemOrderSeqCst) != 0)
+        {
+            word.NotifyAll();
+        }
+    }
+
+    template <typename T>
+    void WakeOne(Atomic<T>& word) noexcept
+    {
+        if (m_parked.Load(MemOrderSeqCst) != 0)
+        {
+            word.NotifyOne();
+        }
+    }
+
+private:
+
+    Atomic<uint32_t> m_parked{ 0 };
+};
+
+} // namespace detail
+
+/// @brief Fair exclusive spin lock granting the lock in arrival order.
+/// @details Each locker draws a ticket and waits for it to be served, so no
+/// waiter can be overtaken. All waiters poll the same cache line, prefer
+/// QueuedSpinLock when many processors contend for the lock.
+class TicketSpinLock final
+{
+public:
+
+    constexpr TicketSpinLock() noexcept = default;
+
+    RAD_NOT_COPYABLE(TicketSpinLock);
+
+    void LockExclusive() noexcept
+    {
+        const uint32_t ticket = m_next.FetchAdd(1, MemOrderRelaxed);
+
+        detail::SpinBackoff backoff;
+        uint32_t serving;
+        while ((serving = m_serving.Load(MemOrderAcquire)) != ticket)
+        {
+            if (!backoff.Pause())
+            {
+                m_parking.Park(m_serving, serving);
+            }
+        }
+    }
+
+    /// @brief Acquires the lock if it is free and nobody is waiting for it.
+    /// @return True if the lock was acquired.
+    bool TryLockExclusive() noexcept
+    {
+        uint32_t ticket = m_serving.Load(MemOrderAcquire);
+        return m_next.CompareExchangeStrong(ticket,
+                                            ticket + 1,
+                                            MemOrderAcquire,
+                                            MemOrderRelaxed);
+    }
+
+    void Unlock() noexcept
+    {
+        // only the holder advances the serving ticket
+        const uint32_t serving = m_serving.Load(MemOrderRelaxed);
+        m_serving.Store(serving + 1, MemOrderSeqCst);
+        m_parking.WakeAll(m_serving);
+    }
+
+private:
+
+    Atomic<uint32_t> m_next{ 0 };
+    Atomic<uint32_t> m_serving{ 0 };
+    detail::SpinParking m_parking;
+};
+
+/// @brief Reader-writer spin lock preferring writers.
+/// @details Any number of shared holders or a single exclusive holder may
+/// hold the lock. A waiting writer stops new readers from entering, so
+/// writers are not starved by a steady stream of readers. Conversely readers
+/// may be starved by a steady stream of writers.
+class RWSpinLock final
+{
+public:
+
+    constexpr RWSpinLock() noexcept = default;
+
+    RAD_NOT_COPYABLE(RWSpinLock);
+
+    void LockExclusive() noexcept
+    {
+        detail::SpinBackoff backoff;
+        uint32_t state = m_state.Load(MemOrderRelaxed);
+        for (;;)
+        {
+            // acquiring clears the pending flag, other pending writers set it
+            // again on their next attempt
+            if ((state & ~WriterPending) == 0)
+            {
+                if RAD_LIKELY (m_state.CompareExchangeWeak(state,
+                                                           WriterHeld,
+                                                           MemOrderAcquire,
+                                                           MemOrderRelaxed))
+                {
+                    return;
+                }
+
+                continue;
+            }
+
+            if ((state & WriterPending) == 0)
+            {
+                state = m_state.FetchOr(WriterPending, MemOrderRelaxed) |
+                        WriterPending;
+            }
+
+            if (!backoff.Pause())
+            {
+                m_parking.Park(m_state, state);
+            }
+
+            state = m_state.Load(MemOrderRelaxed);
+        }
+    }
+
+    void LockShared() noexcept
+    {
+        detail::SpinBackoff backoff;
+        uint32_t state = m_state.Load(MemOrderRelaxed);
+        for (;;)
+        {
+            if ((state & (WriterHeld | WriterPending)) == 0)
+            {
+                if RAD_LIKELY (m_state.CompareExchangeWeak(state,
+                                                           state + Reader,
+                                                           MemOrderAcquire,
+                                                           MemOrderRelaxed))
+                {
+                    return;
+                }
+
+                continue;
+            }
+
+            if (!backoff.Pause())
+            {
+                m_parking.Park(m_state, state);
+            }
+
+            state = m_state.Load(MemOrderRelaxed);
+        }
+    }
+
+    /// @brief Acquires the lock exclusively if nobody holds it.
+    /// @return True if the lock was acquired.
+    bool TryLockExclusive() noexcept
+    {
+        uint32_t state = m_state.Load(MemOrderRelaxed);
+        return (state & ~WriterPending) == 0 &&
+               m_state.CompareExchangeStrong(state,
+                                             WriterHeld,
+                                             MemOrderAcquire,
+                                             MemOrderRelaxed);
+    }
+
+    /// @brief Acquires the lock shared if no writer holds or waits for it.
+    /// @return True if the lock was acquired.
+    bool TryLockShared() noexcept
+    {
+        uint32_t state = m_state.Load(MemOrderRelaxed);
+        return (state & (WriterHeld | WriterPending)) == 0 &&
+               m_state.CompareExchangeStrong(state,
+                                             state + Reader,
+                                             MemOrderAcquire,
+                                             MemOrderRelaxed);
+    }
+
+    void Unlock() noexcept
+    {
+        // readers and a writer never hold the lock together, so the writer
+        // flag tells the holders apart
+        if (m_state.Load(MemOrderRelaxed) & WriterHeld)
+        {
+            m_state.FetchAnd(~WriterHeld, MemOrderSeqCst);
+        }
+        else
+        {
+            m_state.FetchSub(Reader, MemOrderSeqCst);
+        }
+
+        m_parking.WakeAll(m_state);
+    }
+
+private:
+
+    static constexpr uint32_t WriterHeld = 1;
+    static constexpr uint32_t WriterPending = 2;
+    static constexpr uint32_t Reader = 4;
+
+    Atomic<uint32_t> m_state{ 0 };
+    detail::SpinParking m_parking;
+};
+
+/// @brief Fair exclusive spin lock in which each waiter spins on its own
+/// cache line.
+/// @details Waiters form an MCS queue of nodes on their stacks and are granted
+/// the lock in arrival order. Only the waiter at the head of the queue polls
+/// the lock itself, every other waiter polls its own node until its
+/// predecessor hands it the head, so handing over the lock does not make all
+/// waiters contend for the same cache line. A node is only needed while
+/// waiting, which lets LockExclusive() and Unlock() take no arguments.
+class QueuedSpinLock final
+{
+public:
+
+    constexpr QueuedSpinLock() noexcept = default;
+
+    RAD_NOT_COPYABLE(QueuedSpinLock);
+
+    void LockExclusive() noexcept
+    {
+        Node node;
+        Node* pred = m_tail.Exchange(&node, MemOrderAcqRel);
+        if (pred != nullptr)
+        {
+            pred->next.Store(&node, MemOrderRelease);
+
+            detail::SpinBackoff backoff;
+            while (node.state.Load(MemOrderAcquire) != NodeHead)
+            {
+                if (!backoff.Pause())
+                {
+                    uint32_t state = NodeWaiting;
+                    if (node.state.CompareExchangeStrong(state,
+                                                         NodeParked,
+                                                         MemOrderRelaxed,
+                                                         MemOrderRelaxed) ||
+                        state == NodeParked)
+                    {
+                        node.state.Wait(NodeParked, MemOrderRelaxed);
+                    }
+                }
+            }
+        }
+
+        detail::SpinBackoff backoff;
+        uint32_t locked = Unlocked;
+        while (!m_locked.CompareExchangeWeak(locked,
+                                             Locked,
+                                             MemOrderAcquire,
+                                             MemOrderRelaxed))
+        {
+            if (locked != Unlocked && !backoff.Pause())
+            {
+                if (locked == Locked &&
+                    m_locked.CompareExchangeStrong(locked,
+                                                   LockedParked,
+                                                   MemOrderRelaxed,
+                                                   MemOrderRelaxed))
+                {
+                    locked = LockedParked;
+                }
+
+                if (locked == LockedParked)
+                {
+                    m_locked.Wait(LockedParked, MemOrderRelaxed);
+                }
+            }
+
+            locked = Unlocked;
+        }
+
+        // make the successor the head of the queue, waiting for it to link
+        // itself if it has already swapped itself into the tail
+        Node* expected = &node;
+        if (!m_tail.CompareExchangeStrong(expected,
+                                          nullptr,
+                                          MemOrderAcqRel,
+                                          MemOrderRelaxed))
+        {
+            Node* next;
+            while ((next = node.next.Load(MemOrderAcquire)) == nullptr)
+            {
+                RAD_YIELD_PROCESSOR();
+            }
+
+            // the successor cannot leave before this thread unlocks, so its
+            // node is still alive for the notify
+            if (next->state.Exchange(NodeHead, MemOrderRelease) == NodeParked)
+            {
+                next->state.NotifyOne();
+            }
+        }
+    }
+
+    /// @brief Acquires the lock if it is free and nobody is waiting for it.
+    /// @return True if the lock was acquired.
+    bool TryLockExclusive() noexcept
+    {
+        uint32_t locked = Unlocked;
+        return m_tail.Load(MemOrderRelaxed) == nullptr &&
+               m_locked.CompareExchangeStrong(locked,
+                                              Locked,
+                                              MemOrderAcquire,
+                                              MemOrderRelaxed);
+    }
+
+    void Unlock() noexcept
+    {
+        if (m_locked.Exchange(Unlocked, MemOrderRelease) == LockedParked)
+        {
+            m_locked.NotifyOne();
+        }
+    }
+
+private:
+
+    static constexpr uint32_t Unlocked = 0;
+    static constexpr uint32_t Locked = 1;
+    static constexpr uint32_t LockedParked = 2;
+
+    static constexpr uint32_t NodeWaiting = 0;
+    static constexpr uint32_t NodeHead = 1;
+    static constexpr uint32_t NodeParked = 2;
+
+    struct Node
+    {
+        Atomic<Node*> next{ nullptr };
+        Atomic<uint32_t> state{ NodeWaiting };
+    };
+
+    Atomic<Node*> m_tail{ nullptr };
+    Atomic<uint32_t> m_locked{ Unlocked };
+};
+
+} // namespace rad
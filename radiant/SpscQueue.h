@@ -0,0 +1,333 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/CacheAligned.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/Span.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+
+#include <stddef.h>
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Position owned by one side of an SpscQueue,
+/// along with that side's last observation of the other side's position.
+struct SpscQueueIndex
+{
+    Atomic<size_t> pos;
+    size_t cachedOther = 0;
+};
+
+} // namespace detail
+
+RAD_BEGIN_CACHE_ALIGNED
+/// @brief Bounded lock-free queue for a single producer and a single consumer.
+/// @details Each side owns its position on a cache line of its own and caches
+/// the other side's position, so it only reads the other side's cache line
+/// when the cached value says the queue is full or empty. PushBatch() and
+/// PopBatch() move many elements with a single release store, amortizing the
+/// synchronization over the batch.
+///
+/// Slots are allocated once by Init(). Init() and destruction are not
+/// thread-safe. Otherwise one thread at a time may push and one thread at a
+/// time may pop.
+/// @tparam T Element type, which must be nothrow move constructible.
+/// @tparam TAllocator Allocator used to obtain the slots.
+template <typename T, typename TAllocator RAD_ALLOCATOR_EQ(T)>
+class SpscQueue final
+{
+private:
+
+    using AllocatorTraits = AllocTraits<TAllocator>;
+    using IndexType = CacheAligned<detail::SpscQueueIndex>;
+
+public:
+
+    using ValueType = T;
+    using SizeType = size_t;
+    using AllocatorType = TAllocator;
+
+    RAD_S_ASSERT_NOTHROW_MOVE_T(T);
+
+    RAD_NOT_COPYABLE(SpscQueue);
+    SpscQueue(SpscQueue&&) = delete;
+    SpscQueue& operator=(SpscQueue&&) = delete;
+
+    ~SpscQueue()
+    {
+        RAD_S_ASSERT_NOTHROW_DTOR(IsNoThrowDtor<T>);
+
+        Release();
+    }
+
+    /// @brief Constructs a queue without capacity using a default-constructed
+    /// allocator.
+    SpscQueue() noexcept = default;
+
+    /// @brief Constructs a queue without capacity using a copy-constructed
+    /// allocator.
+    /// @param alloc Allocator to copy.
+    explicit SpscQueue(const AllocatorType& alloc) noexcept
+        : m_storage(alloc, nullptr)
+    {
+    }
+
+    /// @brief Allocates the slots of the queue, destroying any elements held.
+    /// @param capacity Minimum number of elements the queue can hold, rounded
+    /// up to a power of two.
+    /// @return Error::NoMemory if the slots could not be allocated, or
+    /// Error::IntegerOverflow if the capacity is too large.
+    Err Init(SizeType capacity) noexcept
+    {
+        SizeType count = 1;
+        while (count < capacity)
+        {
+            if RAD_UNLIKELY (count > (~SizeType(0) >> 1))
+            {
+                return Error::IntegerOverflow;
+            }
+
+            count <<= 1;
+        }
+
+        T* slots = AllocatorTraits::template Alloc<T>(Allocator(), count);
+        if (slots == nullptr)
+        {
+            return Error::NoMemory;
+        }
+
+        Release();
+        Slots() = slots;
+        m_mask = count - 1;
+        return NoError;
+    }
+
+    /// @brief Gets the number of elements the queue can hold.
+    /// @return The capacity, zero before Init() succeeds.
+    SizeType Capacity() const noexcept
+    {
+        return Slots() == nullptr ? 0 : m_mask + 1;
+    }
+
+    /// @brief Gets the number of elements in the queue.
+    /// @details The value may be stale by the time it is returned when the
+    /// other side pushes or pops concurrently.
+    /// @return Number of elements in the queue.
+    SizeType ApproxSize() const noexcept
+    {
+        const SizeType head = m_consumer->pos.Load(MemOrderAcquire);
+        const SizeType tail = m_producer->pos.Load(MemOrderAcquire);
+        const SizeType size = tail - head;
+        return size > Capacity() ? 0 : size;
+    }
+
+    /// @brief Copies an element into the queue. Producer only.
+    /// @param value Element to copy.
+    /// @return Error::OutOfRange if the queue is full.
+    Err TryPush(const T& value) noexcept(IsNoThrowCopyCtor<T>)
+    {
+        return TryEmplace(value);
+    }
+
+    /// @brief Moves an element into the queue. Producer only.
+    /// @param value Element to move.
+    /// @return Error::OutOfRange if the queue is full.
+    Err TryPush(T&& value) noexcept
+    {
+        return TryEmplace(Move(value));
+    }
+
+    /// @brief Constructs an element at the back of the queue. Producer only.
+    /// @param args Arguments for T construction.
+    /// @return Error::OutOfRange if the queue is full.
+    template <typename... TArgs>
+    Err TryEmplace(TArgs&&... args) noexcept(IsNoThrowCtor<T, TArgs&&...>)
+    {
+        RAD_S_ASSERT_NOTHROW((IsNoThrowCtor<T, TArgs&&...>));
+
+        const SizeType tail = m_producer->pos.Load(MemOrderRelaxed);
+        if (FreeSlots(tail, 1) == 0)
+        {
+            return Error::OutOfRange;
+        }
+
+        ::new (static_cast<void*>(Slots() + (tail & m_mask)))
+            T(Forward<TArgs>(args)...);
+        m_producer->pos.Store(tail + 1, MemOrderRelease);
+        return NoError;
+    }
+
+    /// @brief Moves as many elements as fit from the front of a span into the
+    /// queue, publishing them together. Producer only.
+    /// @param items Elements to move, which are left moved-from.
+    /// @return Number of elements pushed, from the start of items.
+    SizeType PushBatch(Span<T> items) noexcept
+    {
+        const SizeType tail = m_producer->pos.Load(MemOrderRelaxed);
+        const SizeType count = FreeSlots(tail, items.Size());
+
+        T* slots = Slots();
+        T* src = items.Data();
+        for (SizeType i = 0; i < count; ++i)
+        {
+            ::new (static_cast<void*>(slots + ((tail + i) & m_mask)))
+                T(Move(src[i]));
+        }
+
+        if (count != 0)
+        {
+            m_producer->pos.Store(tail + count, MemOrderRelease);
+        }
+
+        return count;
+    }
+
+    /// @brief Moves the element at the front out of the queue. Consumer only.
+    /// @return The element, or Error::OutOfRange if the queue is empty.
+    Res<T> TryPop() noexcept
+    {
+        // careful!  T could be rad::Error
+        const SizeType head = m_consumer->pos.Load(MemOrderRelaxed);
+        if (UsedSlots(head, 1) == 0)
+        {
+            return Res<T>(ResErrTag, Error::OutOfRange);
+        }
+
+        T& slot = Slots()[head & m_mask];
+        Res<T> res(ResOkTag, Move(slot));
+        slot.~T();
+        m_consumer->pos.Store(head + 1, MemOrderRelease);
+        return res;
+    }
+
+    /// @brief Moves as many elements as are available, up to the size of a
+    /// span, out of the queue, releasing their slots together. Consumer only.
+    /// @param out Elements to move assign the popped elements to.
+    /// @return Number of elements popped, to the start of out.
+    SizeType PopBatch(Span<T> out) noexcept
+    {
+        const SizeType head = m_consumer->pos.Load(MemOrderRelaxed);
+        const SizeType count = UsedSlots(head, out.Size());
+
+        T* slots = Slots();
+        T* dest = out.Data();
+        for (SizeType i = 0; i < count; ++i)
+        {
+            T& slot = slots[(head + i) & m_mask];
+            dest[i] = Move(slot);
+            slot.~T();
+        }
+
+        if (count != 0)
+        {
+            m_consumer->pos.Store(head + count, MemOrderRelease);
+        }
+
+        return count;
+    }
+
+    /// @brief Returns the allocator.
+    /// @return The allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_storage.First();
+    }
+
+private:
+
+    // Number of slots, up to wanted, the producer at tail may fill.
+    SizeType FreeSlots(SizeType tail, SizeType wanted) noexcept
+    {
+        const SizeType capacity = Capacity();
+        SizeType free = capacity - (tail - m_producer->cachedOther);
+        if (free < wanted)
+        {
+            m_producer->cachedOther = m_consumer->pos.Load(MemOrderAcquire);
+            free = capacity - (tail - m_producer->cachedOther);
+        }
+
+        return free < wanted ? free : wanted;
+    }
+
+    // Number of elements, up to wanted, the consumer at head may take.
+    SizeType UsedSlots(SizeType head, SizeType wanted) noexcept
+    {
+        SizeType used = m_consumer->cachedOther - head;
+        if (used < wanted)
+        {
+            m_consumer->cachedOther = m_producer->pos.Load(MemOrderAcquire);
+            used = m_consumer->cachedOther - head;
+        }
+
+        return used < wanted ? used : wanted;
+    }
+
+    void Release() noexcept
+    {
+        T* slots = Slots();
+        if (slots == nullptr)
+        {
+            return;
+        }
+
+        const SizeType tail = m_producer->pos.Load(MemOrderRelaxed);
+        for (SizeType pos = m_consumer->pos.Load(MemOrderRelaxed); pos != tail;
+             ++pos)
+        {
+            slots[pos & m_mask].~T();
+        }
+
+        AllocatorTraits::Free(Allocator(), slots, m_mask + 1);
+        Slots() = nullptr;
+        m_mask = 0;
+        m_producer->pos.Store(0, MemOrderRelaxed);
+        m_producer->cachedOther = 0;
+        m_consumer->pos.Store(0, MemOrderRelaxed);
+        m_consumer->cachedOther = 0;
+    }
+
+    AllocatorType& Allocator() noexcept
+    {
+        return m_storage.First();
+    }
+
+    T*& Slots() noexcept
+    {
+        return m_storage.Second();
+    }
+
+    T* Slots() const noexcept
+    {
+        return m_storage.Second();
+    }
+
+    EmptyOptimizedPair<AllocatorType, T*> m_storage;
+    SizeType m_mask = 0;
+    IndexType m_producer;
+    IndexType m_consumer;
+};
+RAD_END_CACHE_ALIGNED
+
+} // namespace rad
@@ -0,0 +1,412 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/Memory.h"
+#include "radiant/ShardedCounter.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rad
+{
+
+/// @brief Allocation statistics recorded by StatsAllocator handles.
+/// @details Tracks the number of allocations in each power of two size
+/// class, the number of frees and failed allocations, the bytes currently
+/// live, and the highest number of live bytes seen. Each handle may also
+/// carry a tag, and live bytes and allocation counts are kept per tag, so
+/// that containers sharing one AllocStats can be told apart.
+///
+/// Every counter is a ShardedCounter, so cores recording at the same time
+/// update cache lines of their own. Live bytes are also gathered per shard,
+/// and only moved into the shared total, which the high-water mark follows,
+/// once a shard gathered more than the peak slack. The high-water mark may
+/// therefore miss up to ShardCount times the slack, and a slack of zero makes
+/// it exact at the cost of a shared update on every allocation and free.
+/// Reads concurrent with updates observe some of them but are not a
+/// consistent snapshot.
+///
+/// The statistics must outlive every handle and container that records into
+/// them.
+class AllocStats final
+{
+public:
+
+    /// @brief Number of size classes. Class 0 counts allocations of up to
+    /// 16 bytes, class N those of up to 16 << N bytes, and the last class
+    /// everything larger.
+    static constexpr uint32_t SizeClassCount = 16;
+
+    /// @brief Number of distinct tags. Tag 0 is used by untagged handles.
+    static constexpr uint32_t TagCount = 16;
+
+    /// @brief Number of shards each counter is spread across.
+    static constexpr uint32_t ShardCount = 8;
+
+    /// @brief Default number of live bytes a shard gathers before moving
+    /// them to the shared total.
+    static constexpr size_t DefaultPeakSlack = 64 * 1024;
+
+    /// @brief Constructs empty statistics.
+    /// @param peakSlack Number of live bytes a shard may gather before moving
+    /// them to the shared total, see the class description.
+    explicit AllocStats(size_t peakSlack = DefaultPeakSlack) noexcept
+        : m_peakSlack(static_cast<int64_t>(
+              peakSlack < size_t(INT64_MAX) ? peakSlack : size_t(INT64_MAX)))
+    {
+    }
+
+    RAD_NOT_COPYABLE(AllocStats);
+
+    /// @brief Returns the size class an allocation of a given size falls in.
+    /// @param size Allocation size in bytes.
+    /// @return Index of the size class.
+    static uint32_t SizeClass(size_t size) noexcept
+    {
+        uint32_t sizeClass = 0;
+        while (sizeClass < SizeClassCount - 1 &&
+               size > (size_t(16) << sizeClass))
+        {
+            ++sizeClass;
+        }
+
+        return sizeClass;
+    }
+
+    /// @brief Records a successful allocation.
+    /// @param size Allocation size in bytes.
+    /// @param tag Tag of the allocating handle.
+    void RecordAlloc(size_t size, uint32_t tag) noexcept
+    {
+        m_classes[SizeClass(size)].Add(1);
+        TagStats& tagStats = m_tags[tag & (TagCount - 1)];
+        tagStats.allocations.Add(1);
+        tagStats.liveBytes.Add(size);
+        AddLive(static_cast<int64_t>(size));
+    }
+
+    /// @brief Records a free.
+    /// @param size Allocation size in bytes.
+    /// @param tag Tag of the freeing handle.
+    void RecordFree(size_t size, uint32_t tag) noexcept
+    {
+        m_frees.Add(1);
+        m_tags[tag & (TagCount - 1)].liveBytes.Sub(size);
+        AddLive(-static_cast<int64_t>(size));
+    }
+
+    /// @brief Records an allocation changing size in place or by reallocation.
+    /// @param size Previous allocation size in bytes.
+    /// @param newSize New allocation size in bytes.
+    /// @param tag Tag of the handle.
+    void RecordResize(size_t size, size_t newSize, uint32_t tag) noexcept
+    {
+        TagStats& tagStats = m_tags[tag & (TagCount - 1)];
+        if (newSize >= size)
+        {
+            tagStats.liveBytes.Add(newSize - size);
+            AddLive(static_cast<int64_t>(newSize - size));
+        }
+        else
+        {
+            tagStats.liveBytes.Sub(size - newSize);
+            AddLive(-static_cast<int64_t>(size - newSize));
+        }
+    }
+
+    /// @brief Records an allocation the underlying allocator failed.
+    void RecordFailure() noexcept
+    {
+        m_failures.Add(1);
+    }
+
+    /// @brief Returns the number of successful allocations.
+    uint64_t Allocations() const noexcept
+    {
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < SizeClassCount; ++i)
+        {
+            sum += Allocations(i);
+        }
+
+        return sum;
+    }
+
+    /// @brief Returns the number of successful allocations in a size class.
+    /// @param sizeClass Index of the size class, see SizeClass().
+    uint64_t Allocations(uint32_t sizeClass) const noexcept
+    {
+        RAD_ASSERT(sizeClass < SizeClassCount);
+        return m_classes[sizeClass].Load();
+    }
+
+    /// @brief Returns the number of frees.
+    uint64_t Frees() const noexcept
+    {
+        return m_frees.Load();
+    }
+
+    /// @brief Returns the number of failed allocations.
+    uint64_t Failures() const noexcept
+    {
+        return m_failures.Load();
+    }
+
+    /// @brief Returns the number of bytes currently allocated.
+    size_t LiveBytes() const noexcept
+    {
+        int64_t gathered = 0;
+        for (const auto& shard : m_gathered)
+        {
+            gathered += shard.Load(MemOrderRelaxed);
+        }
+
+        return m_liveBytes.Load(MemOrderRelaxed) +
+               static_cast<size_t>(gathered);
+    }
+
+    /// @brief Returns the highest number of bytes allocated at once since
+    /// construction or the last ResetPeak(), within the peak slack.
+    size_t PeakBytes() const noexcept
+    {
+        const size_t peak = m_peakBytes.Load(MemOrderRelaxed);
+        const size_t live = LiveBytes();
+        return live > peak ? live : peak;
+    }
+
+    /// @brief Lowers the high-water mark to the bytes currently allocated.
+    void ResetPeak() noexcept
+    {
+        m_peakBytes.Store(LiveBytes(), MemOrderRelaxed);
+    }
+
+    /// @brief Returns the number of successful allocations made with a tag.
+    /// @param tag Tag of the handles.
+    uint64_t TagAllocations(uint32_t tag) const noexcept
+    {
+        RAD_ASSERT(tag < TagCount);
+        return m_tags[tag].allocations.Load();
+    }
+
+    /// @brief Returns the number of bytes currently allocated with a tag.
+    /// @param tag Tag of the handles.
+    size_t TagLiveBytes(uint32_t tag) const noexcept
+    {
+        RAD_ASSERT(tag < TagCount);
+        return m_tags[tag].liveBytes.Load();
+    }
+
+private:
+
+    struct TagStats
+    {
+        ShardedCounter<uint64_t, ShardCount> allocations;
+        ShardedCounter<size_t, ShardCount> liveBytes;
+    };
+
+    void AddLive(int64_t delta) noexcept
+    {
+        PaddedAtomic<int64_t>& shard =
+            m_gathered[detail::CurrentShardHint() & (ShardCount - 1)];
+        const int64_t gathered = shard.FetchAdd(delta, MemOrderRelaxed) + delta;
+        if RAD_LIKELY (gathered <= m_peakSlack && gathered >= -m_peakSlack)
+        {
+            return;
+        }
+
+        // another thread may have moved the bytes already
+        const int64_t taken = shard.Exchange(0, MemOrderRelaxed);
+        const size_t live =
+            m_liveBytes.FetchAdd(static_cast<size_t>(taken), MemOrderRelaxed) +
+            static_cast<size_t>(taken);
+        size_t peak = m_peakBytes.Load(MemOrderRelaxed);
+        while (taken > 0 && live > peak &&
+               !m_peakBytes.CompareExchangeWeak(peak,
+                                                live,
+                                                MemOrderRelaxed,
+                                                MemOrderRelaxed))
+        {
+        }
+    }
+
+    ShardedCounter<uint64_t, ShardCount> m_classes[SizeClassCount];
+    ShardedCounter<uint64_t, ShardCount> m_frees;
+    ShardedCounter<uint64_t, ShardCount> m_failures;
+    TagStats m_tags[TagCount];
+
+    // live bytes not yet moved to m_liveBytes, per shard
+    PaddedAtomic<int64_t> m_gathered[ShardCount];
+    PaddedAtomic<size_t> m_liveBytes;
+    PaddedAtomic<size_t> m_peakBytes;
+    const int64_t m_peakSlack;
+};
+
+/// @brief Allocator adapter which forwards to another allocator and records
+/// what passes through it in an AllocStats.
+/// @details Handles compare equal when they record into the same statistics
+/// with the same tag and their wrapped allocators compare equal. They
+/// propagate with the containers that use them, so that memory is always
+/// freed through a handle which recorded its allocation.
+/// @tparam TAllocator Wrapped allocator.
+template <typename TAllocator>
+class StatsAllocator final
+{
+    using InnerTraits = AllocTraits<TAllocator>;
+
+public:
+
+    static constexpr bool PropagateOnCopy = true;
+    static constexpr bool PropagateOnMoveAssignment = true;
+    static constexpr bool PropagateOnSwap = true;
+    static constexpr bool IsAlwaysEqual = false;
+    static constexpr bool HasTryExpandBytes = InnerTraits::HasTryExpandBytes;
+    static constexpr bool HasReallocBytes = InnerTraits::HasReallocBytes;
+
+    using AllocatorType = TAllocator;
+
+    /// @brief Constructs a handle wrapping a default constructed allocator.
+    /// @param stats Statistics to record into.
+    /// @param tag Tag to record allocations under, less than
+    /// AllocStats::TagCount.
+    explicit StatsAllocator(AllocStats& stats, uint32_t tag = 0) noexcept
+        : m_stats(&stats),
+          m_tag(tag),
+          m_inner()
+    {
+        RAD_ASSERT(tag < AllocStats::TagCount);
+    }
+
+    /// @brief Constructs a handle wrapping a copy of an allocator.
+    /// @param alloc Allocator to forward to.
+    /// @param stats Statistics to record into.
+    /// @param tag Tag to record allocations under, less than
+    /// AllocStats::TagCount.
+    StatsAllocator(const TAllocator& alloc,
+                   AllocStats& stats,
+                   uint32_t tag = 0) noexcept
+        : m_stats(&stats),
+          m_tag(tag),
+          m_inner(alloc)
+    {
+        RAD_ASSERT(tag < AllocStats::TagCount);
+    }
+
+    void* AllocBytes(size_t size)
+    {
+        void* ptr = InnerTraits::AllocBytes(Inner(), size);
+        if RAD_LIKELY (ptr != nullptr)
+        {
+            Stats().RecordAlloc(size, Tag());
+        }
+        else
+        {
+            Stats().RecordFailure();
+        }
+
+        return ptr;
+    }
+
+    void FreeBytes(void* ptr, size_t size) noexcept
+    {
+        if (ptr != nullptr)
+        {
+            Stats().RecordFree(size, Tag());
+        }
+
+        InnerTraits::FreeBytes(Inner(), ptr, size);
+    }
+
+    bool TryExpandBytes(void* ptr, size_t size, size_t newSize) noexcept
+    {
+        if (Inner().TryExpandBytes(ptr, size, newSize))
+        {
+            Stats().RecordResize(size, newSize, Tag());
+            return true;
+        }
+
+        return false;
+    }
+
+    void* ReallocBytes(void* ptr, size_t size, size_t newSize)
+    {
+        void* mem = Inner().ReallocBytes(ptr, size, newSize);
+        if (mem != nullptr)
+        {
+            Stats().RecordResize(size, newSize, Tag());
+        }
+        else
+        {
+            Stats().RecordFailure();
+        }
+
+        return mem;
+    }
+
+    void HandleSizeOverflow()
+    {
+        Inner().HandleSizeOverflow();
+    }
+
+    bool operator==(const StatsAllocator& other) const noexcept
+    {
+        return m_stats == other.m_stats && m_tag == other.m_tag &&
+               InnerTraits::Equal(m_inner, other.m_inner);
+    }
+
+    bool operator!=(const StatsAllocator& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+    /// @brief Returns the statistics this handle records into.
+    AllocStats& GetStats() const noexcept
+    {
+        return *m_stats;
+    }
+
+    /// @brief Returns the tag this handle records allocations under.
+    uint32_t Tag() const noexcept
+    {
+        return m_tag;
+    }
+
+    /// @brief Returns the wrapped allocator.
+    const TAllocator& GetInner() const noexcept
+    {
+        return m_inner;
+    }
+
+private:
+
+    TAllocator& Inner() noexcept
+    {
+        return m_inner;
+    }
+
+    AllocStats& Stats() const noexcept
+    {
+        return *m_stats;
+    }
+
+    // an empty inner allocator packs in after the tag
+    AllocStats* m_stats;
+    uint32_t m_tag;
+    TAllocator m_inner;
+};
+
+} // namespace rad
@@ -0,0 +1,674 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Hash.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/Span.h"
+#include "radiant/Utility.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace rad
+{
+
+/// @brief Null-terminated sequence of characters with a small-string
+/// optimization.
+/// @details The string is three pointers large. Strings of up to
+/// InlineCapacity characters, 23 on 64-bit targets, are stored in the string
+/// object itself and never touch the allocator. Longer strings are stored in
+/// one allocation holding the characters and the terminator.
+///
+/// The inline characters share their bytes with the pointer, size and
+/// capacity of the allocated representation. The last byte tells them apart:
+/// it holds the number of unused inline characters, so that it doubles as
+/// the terminator of a full inline string, or a marker for an allocated one.
+///
+/// Operations which may allocate return a Res and fail with Error::NoMemory
+/// without changing the string. Size() excludes the terminator, and the
+/// characters may contain embedded nulls.
+/// @tparam TAllocator Allocator type to use.
+template <typename TAllocator RAD_ALLOCATOR_EQ(char)>
+class String final
+{
+public:
+
+    using ThisType = String<TAllocator>;
+    using ValueType = char;
+    using SizeType = uint32_t;
+    using AllocatorType = TAllocator;
+
+private:
+
+    using AllocatorTraits = AllocTraits<TAllocator>;
+
+    struct Rep
+    {
+        char* data;
+        SizeType size;
+        SizeType capacity;
+        char unused[sizeof(void*) - 1];
+        unsigned char tag;
+    };
+
+    static constexpr unsigned char AllocatedTag = 0x80;
+
+public:
+
+    /// @brief Number of characters the string holds without allocating.
+    static constexpr SizeType InlineCapacity = sizeof(Rep) - 1;
+
+    RAD_S_ASSERT(InlineCapacity < AllocatedTag);
+
+    /// @brief Strings hold no pointers into themselves, so relocating one is
+    /// a byte copy when its allocator allows it.
+    static constexpr bool IsTriviallyRelocatable =
+        IsTrivRelocatable<TAllocator>;
+
+    RAD_NOT_COPYABLE(String);
+
+    ~String()
+    {
+        RAD_S_ASSERT_NOTHROW_DTOR(IsNoThrowDtor<TAllocator>);
+
+        Release();
+    }
+
+    /// @brief Constructs an empty string with a default-constructed
+    /// allocator.
+    String() noexcept
+    {
+        SetInline(0);
+    }
+
+    /// @brief Constructs an empty string with a copy-constructed allocator.
+    /// @param alloc Allocator to copy.
+    explicit String(const AllocatorType& alloc) noexcept
+        : m_storage(alloc)
+    {
+        SetInline(0);
+    }
+
+    /// @brief Move constructs a string from another, leaving it empty.
+    /// @param other String to steal from.
+    String(ThisType&& other) noexcept
+        : m_storage(other.Allocator())
+    {
+        Steal(other);
+    }
+
+    /// @brief Moves the characters of another string into this, leaving it
+    /// empty.
+    /// @param other String to move characters from.
+    /// @return Reference to this string.
+    ThisType& operator=(ThisType&& other) noexcept
+    {
+        // Don't allow non-propagation of allocators
+        RAD_S_ASSERTMSG(
+            AllocatorTraits::IsAlwaysEqual ||
+                AllocatorTraits::PropagateOnMoveAssignment,
+            "Cannot use move assignment with this allocator, as it could cause "
+            "copies. Either change allocators, or use something like Clone().");
+
+        if RAD_UNLIKELY (this == &other)
+        {
+            return *this;
+        }
+
+        Release();
+        AllocatorTraits::PropagateOnMoveIfNeeded(Allocator(),
+                                                 other.Allocator());
+        Steal(other);
+        return *this;
+    }
+
+    /// @brief Checks if the string is empty.
+    /// @return True if the string has no characters.
+    bool Empty() const noexcept
+    {
+        return Size() == 0;
+    }
+
+    /// @brief Gets the number of characters, excluding the terminator.
+    /// @return Number of characters.
+    SizeType Size() const noexcept
+    {
+        return IsInline() ? static_cast<SizeType>(InlineCapacity - Tag())
+                          : Large().size;
+    }
+
+    /// @brief Gets the number of characters the string can hold without
+    /// allocating.
+    /// @return Capacity, excluding the terminator.
+    SizeType Capacity() const noexcept
+    {
+        return IsInline() ? SizeType(InlineCapacity) : Large().capacity;
+    }
+
+    /// @brief Checks whether the characters are stored in the string object.
+    /// @return True if the characters are not allocated.
+    bool IsInline() const noexcept
+    {
+        return Tag() != AllocatedTag;
+    }
+
+    /// @brief Gets the null-terminated characters.
+    /// @return Pointer to Size() characters followed by a terminator.
+    char* Data() noexcept
+    {
+        return IsInline() ? InlineData() : Large().data;
+    }
+
+    /// @copydoc Data
+    const char* Data() const noexcept
+    {
+        return IsInline() ? InlineData() : Large().data;
+    }
+
+    /// @copydoc Data
+    const char* CStr() const noexcept
+    {
+        return Data();
+    }
+
+    /// @brief Returns a reference to the character at a given index. Behavior
+    /// is undefined if the index is outside the bounds of the string.
+    /// @param index Index of the character.
+    /// @return Reference to the character.
+    char& operator[](SizeType index) noexcept
+    {
+        RAD_ASSERT(index < Size());
+
+        return Data()[index];
+    }
+
+    /// @copydoc operator[]
+    const char& operator[](SizeType index) const noexcept
+    {
+        RAD_ASSERT(index < Size());
+
+        return Data()[index];
+    }
+
+    /// @brief Views the characters, excluding the terminator.
+    /// @return Span of the characters.
+    Span<char> ToSpan() noexcept
+    {
+        return Span<char>(Data(), Size());
+    }
+
+    /// @copydoc ToSpan
+    Span<const char> ToSpan() const noexcept
+    {
+        return Span<const char>(Data(), Size());
+    }
+
+    /// @brief Ensures the string can hold a number of characters without
+    /// allocating again.
+    /// @param capacity Number of characters, excluding the terminator.
+    /// @return Reference to this string, or Error::NoMemory.
+    Res<ThisType&> Reserve(SizeType capacity) noexcept
+    {
+        if (capacity > Capacity())
+        {
+            Err err = Reallocate(capacity);
+            if (err.IsErr())
+            {
+                return err.Err();
+            }
+        }
+
+        return *this;
+    }
+
+    /// @brief Removes all characters, keeping the capacity.
+    /// @return Reference to this string.
+    ThisType& Clear() noexcept
+    {
+        SetSize(0);
+        return *this;
+    }
+
+    /// @brief Changes the number of characters, appending copies of a
+    /// character when growing.
+    /// @param count New number of characters.
+    /// @param ch Character to append.
+    /// @return Reference to this string, or Error::NoMemory.
+    Res<ThisType&> Resize(SizeType count, char ch = '\0') noexcept
+    {
+        const SizeType size = Size();
+        if (count > size)
+        {
+            Err err = Grow(count - size);
+            if (err.IsErr())
+            {
+                return err.Err();
+            }
+
+            memset(Data() + size, ch, count - size);
+        }
+
+        SetSize(count);
+        return *this;
+    }
+
+    /// @brief Replaces the characters with copies of others.
+    /// @param str Characters to copy, which must not be part of this string.
+    /// @return Reference to this string, or Error::NoMemory.
+    Res<ThisType&> Assign(Span<const char> str) noexcept
+    {
+        if (str.Size() > Capacity())
+        {
+            Err err = Reallocate(str.Size(), false);
+            if (err.IsErr())
+            {
+                return err.Err();
+            }
+        }
+
+        Copy(Data(), str);
+        SetSize(str.Size());
+        return *this;
+    }
+
+    /// @brief Replaces the characters with those of a null-terminated string.
+    /// @param str Null-terminated characters to copy.
+    /// @return Reference to this string, or Error::NoMemory.
+    Res<ThisType&> Assign(const char* str) noexcept
+    {
+        return Assign(Terminated(str));
+    }
+
+    /// @brief Appends copies of characters.
+    /// @param str Characters to copy, which may be part of this string.
+    /// @return Reference to this string, or Error::NoMemory.
+    Res<ThisType&> Append(Span<const char> str) noexcept
+    {
+        if (str.Empty())
+        {
+            return *this;
+        }
+
+        const SizeType size = Size();
+        if (str.Size() > Capacity() - size)
+        {
+            // copy out of the old buffer before it is freed
+            const char* const begin = Data();
+            const bool inside =
+                str.Data() >= begin && str.Data() < begin + size;
+            const SizeType offset =
+                inside ? static_cast<SizeType>(str.Data() - begin) : 0;
+            Err err = Grow(str.Size());
+            if (err.IsErr())
+            {
+                return err.Err();
+            }
+
+            if (inside)
+            {
+                str = Span<const char>(Data() + offset, str.Size());
+            }
+        }
+
+        memmove(Data() + size, str.Data(), str.Size());
+        SetSize(size + str.Size());
+        return *this;
+    }
+
+    /// @brief Appends the characters of a null-terminated string.
+    /// @param str Null-terminated characters to copy.
+    /// @return Reference to this string, or Error::NoMemory.
+    Res<ThisType&> Append(const char* str) noexcept
+    {
+        return Append(Terminated(str));
+    }
+
+    /// @brief Appends a character.
+    /// @param ch Character to append.
+    /// @return Reference to this string, or Error::NoMemory.
+    Res<ThisType&> PushBack(char ch) noexcept
+    {
+        const SizeType size = Size();
+        if (size == Capacity())
+        {
+            Err err = Grow(1);
+            if (err.IsErr())
+            {
+                return err.Err();
+            }
+        }
+
+        Data()[size] = ch;
+        SetSize(size + 1);
+        return *this;
+    }
+
+    /// @brief Removes the last character of a non-empty string.
+    /// @return Reference to this string.
+    ThisType& PopBack() noexcept
+    {
+        RAD_ASSERT(!Empty());
+
+        SetSize(Size() - 1);
+        return *this;
+    }
+
+    /// @brief Compares the characters with others, byte by byte.
+    /// @param str Characters to compare with.
+    /// @return Negative, zero or positive if this string orders before, the
+    /// same as, or after str.
+    int Compare(Span<const char> str) const noexcept
+    {
+        const SizeType size = Size();
+        const SizeType common = Min(size, str.Size());
+        const int res = common == 0 ? 0 : memcmp(Data(), str.Data(), common);
+        if (res != 0)
+        {
+            return res;
+        }
+
+        return size < str.Size() ? -1 : (size > str.Size() ? 1 : 0);
+    }
+
+    /// @brief Exchanges the contents of two strings.
+    /// @param other String to swap with.
+    /// @return Reference to this string.
+    ThisType& Swap(ThisType& other) noexcept
+    {
+        // Don't allow non-propagation of allocators
+        RAD_S_ASSERTMSG(
+            AllocatorTraits::IsAlwaysEqual || AllocatorTraits::PropagateOnSwap,
+            "Cannot use Swap with this allocator, as it could cause copies. "
+            "Either change allocators, or use move construction.");
+
+        Rep rep;
+        memcpy(&rep, &Representation(), sizeof(Rep));
+        memcpy(&Representation(), &other.Representation(), sizeof(Rep));
+        memcpy(&other.Representation(), &rep, sizeof(Rep));
+        AllocatorTraits::PropagateOnSwapIfNeeded(Allocator(),
+                                                 other.Allocator());
+        return *this;
+    }
+
+    /// @brief Creates a copy of the string.
+    /// @return The new string on success or an error.
+    Res<ThisType> Clone() noexcept
+    {
+        ThisType local(AllocatorTraits::SelectAllocOnCopy(Allocator()));
+        auto res = local.Assign(ToSpan());
+        if (res.IsErr())
+        {
+            return res.Err();
+        }
+
+        return local;
+    }
+
+    /// @brief Returns the allocator.
+    /// @return The allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return AllocatorType(Allocator());
+    }
+
+private:
+
+    static Span<const char> Terminated(const char* str) noexcept
+    {
+        return Span<const char>(str, static_cast<SizeType>(strlen(str)));
+    }
+
+    static void Copy(char* dest, Span<const char> src) noexcept
+    {
+        if (src.Size() != 0)
+        {
+            memcpy(dest, src.Data(), src.Size());
+        }
+    }
+
+    unsigned char Tag() const noexcept
+    {
+        return Representation().tag;
+    }
+
+    char* InlineData() noexcept
+    {
+        // the inline characters overlay the whole representation, which
+        // character pointers may access
+        return reinterpret_cast<char*>(&Representation());
+    }
+
+    const char* InlineData() const noexcept
+    {
+        return reinterpret_cast<const char*>(&Representation());
+    }
+
+    Rep& Large() noexcept
+    {
+        return Representation();
+    }
+
+    const Rep& Large() const noexcept
+    {
+        return Representation();
+    }
+
+    void SetInline(SizeType size) noexcept
+    {
+        InlineData()[size] = '\0';
+        Representation().tag =
+            static_cast<unsigned char>(InlineCapacity - size);
+    }
+
+    // sets the size of the string, which must fit the capacity
+    void SetSize(SizeType size) noexcept
+    {
+        if (IsInline())
+        {
+            SetInline(size);
+        }
+        else
+        {
+            Large().size = size;
+            Large().data[size] = '\0';
+        }
+    }
+
+    // grows the capacity so that count more characters fit, at least
+    // doubling it so that appending takes amortized constant time
+    Err Grow(SizeType count) noexcept
+    {
+        const SizeType size = Size();
+        if RAD_UNLIKELY (count > MaxCapacity - size)
+        {
+            return Error::IntegerOverflow;
+        }
+
+        const SizeType capacity = Capacity();
+        SizeType target = size + count;
+        if (capacity <= MaxCapacity / 2)
+        {
+            target = Max(target, static_cast<SizeType>(capacity * 2));
+        }
+
+        return Reallocate(target);
+    }
+
+    // moves the characters to an allocation of the given capacity, copying
+    // them over unless the caller is about to replace them
+    Err Reallocate(SizeType capacity, bool keep = true) noexcept
+    {
+        if RAD_UNLIKELY (capacity > MaxCapacity)
+        {
+            return Error::IntegerOverflow;
+        }
+
+        char* data =
+            AllocatorTraits::template Alloc<char>(Allocator(), capacity + 1u);
+        if (data == nullptr)
+        {
+            return Error::NoMemory;
+        }
+
+        const SizeType size = keep ? Size() : 0;
+        Copy(data, Span<const char>(Data(), size));
+        data[size] = '\0';
+        FreeAllocation();
+
+        Rep& rep = Large();
+        rep.data = data;
+        rep.size = size;
+        rep.capacity = capacity;
+        rep.tag = AllocatedTag;
+        return NoError;
+    }
+
+    void FreeAllocation() noexcept
+    {
+        if (!IsInline())
+        {
+            AllocatorTraits::Free(Allocator(),
+                                  Large().data,
+                                  Large().capacity + 1u);
+        }
+    }
+
+    void Release() noexcept
+    {
+        FreeAllocation();
+        SetInline(0);
+    }
+
+    void Steal(ThisType& other) noexcept
+    {
+        // inline characters overlay the pointer, so copy the bytes
+        memcpy(&Representation(), &other.Representation(), sizeof(Rep));
+        other.SetInline(0);
+    }
+
+    AllocatorType& Allocator() noexcept
+    {
+        return m_storage.First();
+    }
+
+    const AllocatorType& Allocator() const noexcept
+    {
+        return m_storage.First();
+    }
+
+    Rep& Representation() noexcept
+    {
+        return m_storage.Second();
+    }
+
+    const Rep& Representation() const noexcept
+    {
+        return m_storage.Second();
+    }
+
+    // keeps capacity + 1 representable
+    static constexpr SizeType MaxCapacity = ~SizeType(0) - 1;
+
+    EmptyOptimizedPair<TAllocator, Rep> m_storage;
+};
+
+template <typename TAllocator, typename UAllocator>
+inline bool operator==(const String<TAllocator>& left,
+                       const String<UAllocator>& right) noexcept
+{
+    return left.Compare(right.ToSpan()) == 0;
+}
+
+template <typename TAllocator>
+inline bool operator==(const String<TAllocator>& left,
+                       Span<const char> right) noexcept
+{
+    return left.Compare(right) == 0;
+}
+
+template <typename TAllocator>
+inline bool operator==(Span<const char> left,
+                       const String<TAllocator>& right) noexcept
+{
+    return right.Compare(left) == 0;
+}
+
+template <typename TAllocator>
+inline bool operator==(const String<TAllocator>& left,
+                       const char* right) noexcept
+{
+    return left.Compare(Span<const char>(
+               right,
+               static_cast<SpanSizeType>(strlen(right)))) == 0;
+}
+
+template <typename TAllocator, typename UAllocator>
+inline bool operator!=(const String<TAllocator>& left,
+                       const String<UAllocator>& right) noexcept
+{
+    return !(left == right);
+}
+
+template <typename TAllocator>
+inline bool operator!=(const String<TAllocator>& left,
+                       Span<const char> right) noexcept
+{
+    return !(left == right);
+}
+
+template <typename TAllocator>
+inline bool operator!=(Span<const char> left,
+                       const String<TAllocator>& right) noexcept
+{
+    return !(left == right);
+}
+
+template <typename TAllocator>
+inline bool operator!=(const String<TAllocator>& left,
+                       const char* right) noexcept
+{
+    return !(left == right);
+}
+
+template <typename TAllocator, typename UAllocator>
+inline bool operator<(const String<TAllocator>& left,
+                      const String<UAllocator>& right) noexcept
+{
+    return left.Compare(right.ToSpan()) < 0;
+}
+
+/// @brief Hashes strings by their characters.
+/// @details Also hashes character spans the same way, so that maps keyed by
+/// strings can be searched with spans.
+template <typename TAllocator>
+struct Hash<String<TAllocator>>
+{
+    uint64_t operator()(const String<TAllocator>& str) const noexcept
+    {
+        return (*this)(str.ToSpan());
+    }
+
+    uint64_t operator()(Span<const char> str) const noexcept
+    {
+        return HashBytes(str.AsBytes());
+    }
+};
+
+} // namespace rad
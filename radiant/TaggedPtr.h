@@ -0,0 +1,308 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+
+#include <stdint.h>
+
+namespace rad
+{
+
+/// @brief Pointer carrying a small tag in its unused low order bits.
+/// @details Objects aligned to 2^TBits bytes leave the low TBits bits of
+/// their addresses zero, and TaggedPtr keeps a tag there, so the pair
+/// occupies a single word. This is checked when the pointer is first used
+/// rather than when the class is instantiated, so a type may hold a
+/// TaggedPtr to itself.
+/// @tparam T Type pointed to, aligned to at least 2^TBits bytes.
+/// @tparam TBits Number of tag bits.
+template <typename T, uint32_t TBits>
+class TaggedPtr final
+{
+public:
+
+    RAD_S_ASSERTMSG(TBits >= 1 && TBits <= 8,
+                    "TaggedPtr supports 1 to 8 tag bits");
+
+    using ThisType = TaggedPtr<T, TBits>;
+    using ValueType = T;
+    using PointerType = T*;
+    using TagType = uintptr_t;
+
+    static constexpr uint32_t TagBits = TBits;
+    static constexpr TagType TagMask = (TagType{ 1 } << TBits) - 1;
+    static constexpr uintptr_t PtrMask = ~TagMask;
+
+    /// @brief Constructs a null pointer with a zero tag.
+    constexpr TaggedPtr() noexcept = default;
+
+    /// @brief Constructs a tagged pointer.
+    /// @param ptr Pointer, which must be aligned to 2^TBits bytes.
+    /// @param tag Tag, which must not exceed TagMask.
+    constexpr explicit TaggedPtr(PointerType ptr, TagType tag = 0) noexcept
+        : m_bits(Pack(ptr, tag))
+    {
+    }
+
+    /// @brief Reconstructs a tagged pointer from the word returned by Bits().
+    /// @param bits Packed pointer and tag.
+    /// @return The tagged pointer.
+    static ThisType FromBits(uintptr_t bits) noexcept
+    {
+        ThisType result;
+        result.m_bits = bits;
+        return result;
+    }
+
+    /// @brief Gets the pointer and tag packed into a single word.
+    /// @return The packed word.
+    constexpr uintptr_t Bits() const noexcept
+    {
+        return m_bits;
+    }
+
+    /// @brief Gets the pointer.
+    /// @return The pointer without its tag.
+    PointerType Ptr() const noexcept
+    {
+        return reinterpret_cast<PointerType>(m_bits & PtrMask);
+    }
+
+    /// @brief Gets the tag.
+    /// @return The tag.
+    TagType Tag() const noexcept
+    {
+        return m_bits & TagMask;
+    }
+
+    /// @brief Replaces the pointer, keeping the tag.
+    /// @param ptr Pointer, which must be aligned to 2^TBits bytes.
+    void SetPtr(PointerType ptr) noexcept
+    {
+        m_bits = Pack(ptr, Tag());
+    }
+
+    /// @brief Replaces the tag, keeping the pointer.
+    /// @param tag Tag, which must not exceed TagMask.
+    void SetTag(TagType tag) noexcept
+    {
+        RAD_ASSERT(tag <= TagMask);
+        m_bits = (m_bits & PtrMask) | tag;
+    }
+
+    /// @brief Gets a copy of this pointer with a different tag.
+    /// @param tag Tag, which must not exceed TagMask.
+    /// @return The retagged pointer.
+    ThisType WithTag(TagType tag) const noexcept
+    {
+        ThisType result = *this;
+        result.SetTag(tag);
+        return result;
+    }
+
+    /// @brief Gets a copy of this tagged pointer with a different pointer.
+    /// @param ptr Pointer, which must be aligned to 2^TBits bytes.
+    /// @return The tagged pointer.
+    ThisType WithPtr(PointerType ptr) const noexcept
+    {
+        return ThisType(ptr, Tag());
+    }
+
+    PointerType operator->() const noexcept
+    {
+        return Ptr();
+    }
+
+    T& operator*() const noexcept
+    {
+        return *Ptr();
+    }
+
+    /// @brief Checks if the pointer is non-null, regardless of the tag.
+    explicit operator bool() const noexcept
+    {
+        return (m_bits & PtrMask) != 0;
+    }
+
+    /// @brief Compares both the pointer and the tag.
+    bool operator==(const ThisType& other) const noexcept
+    {
+        return m_bits == other.m_bits;
+    }
+
+    bool operator!=(const ThisType& other) const noexcept
+    {
+        return m_bits != other.m_bits;
+    }
+
+private:
+
+    static constexpr uintptr_t Pack(PointerType ptr, TagType tag) noexcept
+    {
+        RAD_S_ASSERTMSG(alignof(T) >= (size_t{ 1 } << TBits),
+                        "T is not aligned enough to hold TBits tag bits");
+
+        const uintptr_t bits = reinterpret_cast<uintptr_t>(ptr);
+        RAD_ASSERT((bits & TagMask) == 0);
+        RAD_ASSERT(tag <= TagMask);
+        return bits | tag;
+    }
+
+    uintptr_t m_bits = 0;
+};
+
+/// @brief Atomic TaggedPtr, updating the pointer and its tag together.
+/// @details Compare-exchange operates on the pointer and the tag at once, so
+/// a tag can act as a lock, a state or a mark on the pointer. Tag
+/// arithmetic leaves the pointer untouched as long as it does not overflow
+/// TagMask, which the caller must ensure.
+/// @tparam T Type pointed to, aligned to at least 2^TBits bytes.
+/// @tparam TBits Number of tag bits.
+template <typename T, uint32_t TBits>
+class AtomicTaggedPtr final
+{
+public:
+
+    using ValueType = TaggedPtr<T, TBits>;
+    using PointerType = typename ValueType::PointerType;
+    using TagType = typename ValueType::TagType;
+
+    static constexpr TagType TagMask = ValueType::TagMask;
+
+    RAD_NOT_COPYABLE(AtomicTaggedPtr);
+
+    /// @brief Constructs a null pointer with a zero tag.
+    constexpr AtomicTaggedPtr() noexcept = default;
+
+    /// @brief Constructs from a tagged pointer.
+    /// @param value Initial value.
+    constexpr AtomicTaggedPtr(ValueType value) noexcept
+        : m_bits(value.Bits())
+    {
+    }
+
+    template <RAD_ATOMIC_MEMORDER_T>
+    ValueType Load(RAD_ATOMIC_MEMORDER_P) const noexcept
+    {
+        return ValueType::FromBits(m_bits.Load(Order()));
+    }
+
+    template <RAD_ATOMIC_MEMORDER_T>
+    void Store(ValueType value, RAD_ATOMIC_MEMORDER_P) noexcept
+    {
+        m_bits.Store(value.Bits(), Order());
+    }
+
+    template <RAD_ATOMIC_MEMORDER_T>
+    ValueType Exchange(ValueType value, RAD_ATOMIC_MEMORDER_P) noexcept
+    {
+        return ValueType::FromBits(m_bits.Exchange(value.Bits(), Order()));
+    }
+
+    template <typename Success, typename Failure>
+    bool CompareExchangeWeak(ValueType& expected,
+                             ValueType desired,
+                             MemoryOrderTag<Success> success,
+                             MemoryOrderTag<Failure> failure) noexcept
+    {
+        uintptr_t bits = expected.Bits();
+        const bool result = m_bits.CompareExchangeWeak(bits,
+                                                       desired.Bits(),
+                                                       success,
+                                                       failure);
+        expected = ValueType::FromBits(bits);
+        return result;
+    }
+
+    template <RAD_ATOMIC_MEMORDER_T>
+    bool CompareExchangeWeak(ValueType& expected,
+                             ValueType desired,
+                             RAD_ATOMIC_MEMORDER_P) noexcept
+    {
+        return CompareExchangeWeak(expected, desired, Order(), Order());
+    }
+
+    template <typename Success, typename Failure>
+    bool CompareExchangeStrong(ValueType& expected,
+                               ValueType desired,
+                               MemoryOrderTag<Success> success,
+                               MemoryOrderTag<Failure> failure) noexcept
+    {
+        uintptr_t bits = expected.Bits();
+        const bool result = m_bits.CompareExchangeStrong(bits,
+                                                         desired.Bits(),
+                                                         success,
+                                                         failure);
+        expected = ValueType::FromBits(bits);
+        return result;
+    }
+
+    template <RAD_ATOMIC_MEMORDER_T>
+    bool CompareExchangeStrong(ValueType& expected,
+                               ValueType desired,
+                               RAD_ATOMIC_MEMORDER_P) noexcept
+    {
+        return CompareExchangeStrong(expected, desired, Order(), Order());
+    }
+
+    /// @brief Adds to the tag.
+    /// @param tag Value to add, which must not carry the tag past TagMask.
+    /// @return The previous value.
+    template <RAD_ATOMIC_MEMORDER_T>
+    ValueType FetchAddTag(TagType tag, RAD_ATOMIC_MEMORDER_P) noexcept
+    {
+        RAD_ASSERT(tag <= TagMask);
+        return ValueType::FromBits(m_bits.FetchAdd(tag, Order()));
+    }
+
+    /// @brief Subtracts from the tag.
+    /// @param tag Value to subtract, which must not exceed the tag.
+    /// @return The previous value.
+    template <RAD_ATOMIC_MEMORDER_T>
+    ValueType FetchSubTag(TagType tag, RAD_ATOMIC_MEMORDER_P) noexcept
+    {
+        RAD_ASSERT(tag <= TagMask);
+        return ValueType::FromBits(m_bits.FetchSub(tag, Order()));
+    }
+
+    /// @brief Sets bits of the tag.
+    /// @param tag Bits to set.
+    /// @return The previous value.
+    template <RAD_ATOMIC_MEMORDER_T>
+    ValueType FetchOrTag(TagType tag, RAD_ATOMIC_MEMORDER_P) noexcept
+    {
+        RAD_ASSERT(tag <= TagMask);
+        return ValueType::FromBits(m_bits.FetchOr(tag, Order()));
+    }
+
+    /// @brief Clears bits of the tag.
+    /// @param tag Bits of the tag to keep.
+    /// @return The previous value.
+    template <RAD_ATOMIC_MEMORDER_T>
+    ValueType FetchAndTag(TagType tag, RAD_ATOMIC_MEMORDER_P) noexcept
+    {
+        RAD_ASSERT(tag <= TagMask);
+        return ValueType::FromBits(
+            m_bits.FetchAnd(ValueType::PtrMask | tag, Order()));
+    }
+
+private:
+
+    Atomic<uintptr_t> m_bits{ 0 };
+};
+
+} // namespace rad
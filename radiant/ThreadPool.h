@@ -0,0 +1,551 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Memory.h"
+#include "radiant/MpmcQueue.h"
+#include "radiant/Res.h"
+#include "radiant/SpinLocks.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+#include "radiant/WorkStealingDeque.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if RAD_USER_MODE
+
+#if RAD_WINDOWS
+#include <Windows.h> // NOLINT(misc-include-cleaner)
+#else
+#include <pthread.h>
+#endif
+
+namespace rad
+{
+
+namespace detail
+{
+
+/// @brief Internal use only. Type-erased task owned by a ThreadPool.
+template <typename TAllocator>
+struct PoolTask
+{
+    // runs the task, then destroys and frees it
+    void (*run)(PoolTask* task, TAllocator& alloc);
+};
+
+/// @brief Internal use only. Task holding the callable submitted to a
+/// ThreadPool.
+template <typename F, typename TAllocator>
+struct PoolTaskImpl final : PoolTask<TAllocator>
+{
+    template <typename TFn>
+    explicit PoolTaskImpl(TFn&& f) noexcept
+        : PoolTask<TAllocator>{ &Run },
+          fn(Forward<TFn>(f))
+    {
+    }
+
+    static void Run(PoolTask<TAllocator>* task, TAllocator& alloc)
+    {
+        PoolTaskImpl* self = static_cast<PoolTaskImpl*>(task);
+        self->fn();
+        self->~PoolTaskImpl();
+        AllocTraits<TAllocator>::Free(alloc, self, 1);
+    }
+
+    F fn;
+};
+
+/// @brief Internal use only. Joinable OS thread running a function pointer.
+class PoolThread final
+{
+public:
+
+    using EntryType = void (*)(void* arg);
+
+    PoolThread() noexcept = default;
+
+    RAD_NOT_COPYABLE(PoolThread);
+
+    /// @brief Starts the thread.
+    /// @return False if the OS could not create the thread.
+    bool Start(EntryType entry, void* arg) noexcept
+    {
+        m_entry = entry;
+        m_arg = arg;
+#if RAD_WINDOWS
+        m_handle = CreateThread(nullptr, 0, &Trampoline, this, 0, nullptr);
+        return m_handle != nullptr;
+#else
+        m_started = pthread_create(&m_thread, nullptr, &Trampoline, this) == 0;
+        return m_started;
+#endif
+    }
+
+    /// @brief Waits for a started thread to exit.
+    void Join() noexcept
+    {
+#if RAD_WINDOWS
+        if (m_handle != nullptr)
+        {
+            WaitForSingleObject(m_handle, INFINITE);
+            CloseHandle(m_handle);
+            m_handle = nullptr;
+        }
+#else
+        if (m_started)
+        {
+            pthread_join(m_thread, nullptr);
+            m_started = false;
+        }
+#endif
+    }
+
+private:
+
+#if RAD_WINDOWS
+    static DWORD WINAPI Trampoline(LPVOID arg)
+    {
+        PoolThread* self = static_cast<PoolThread*>(arg);
+        self->m_entry(self->m_arg);
+        return 0;
+    }
+
+    HANDLE m_handle = nullptr;
+#else
+    static void* Trampoline(void* arg)
+    {
+        PoolThread* self = static_cast<PoolThread*>(arg);
+        self->m_entry(self->m_arg);
+        return nullptr;
+    }
+
+    pthread_t m_thread{};
+    bool m_started = false;
+#endif
+    EntryType m_entry = nullptr;
+    void* m_arg = nullptr;
+};
+
+} // namespace detail
+
+/// @brief Fixed-size pool of threads running submitted tasks.
+/// @details Every worker owns a WorkStealingDeque. Tasks submitted from a
+/// worker go to its own deque, where it runs them newest first while idle
+/// workers steal the oldest ones, so there is no central queue for work that
+/// fans out from within tasks. Tasks submitted from other threads go through
+/// a bounded MpmcQueue. Idle workers park until new work is submitted.
+///
+/// Tasks are allocated from the pool's allocator and freed once run, so the
+/// allocator must be safe to use from several threads at once. When the
+/// queue a task is submitted to is full, or before Start() succeeded, the
+/// submitting thread runs the task itself.
+///
+/// Start() and destruction are not thread-safe, every other member may be
+/// called concurrently, including from within tasks.
+/// @tparam TAllocator Thread-safe allocator used for tasks and queues.
+template <typename TAllocator RAD_ALLOCATOR_EQ(void)>
+class ThreadPool final
+{
+private:
+
+    using TaskType = detail::PoolTask<TAllocator>;
+    using AllocatorTraits = AllocTraits<TAllocator>;
+
+    struct Worker
+    {
+        Worker(ThreadPool* p, uint32_t i, const TAllocator& alloc) noexcept
+            : deque(alloc),
+              pool(p),
+              index(i)
+        {
+        }
+
+        WorkStealingDeque<TaskType*, TAllocator> deque;
+        ThreadPool* pool;
+        uint32_t index;
+        detail::PoolThread thread;
+    };
+
+public:
+
+    using AllocatorType = TAllocator;
+
+    RAD_NOT_COPYABLE(ThreadPool);
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    /// @brief Runs all submitted tasks, then stops and joins the workers.
+    ~ThreadPool()
+    {
+        WaitIdle();
+        StopWorkers(m_workerCount);
+        DestroyWorkers();
+    }
+
+    /// @brief Constructs a pool without workers using a default-constructed
+    /// allocator.
+    ThreadPool() noexcept = default;
+
+    /// @brief Constructs a pool without workers using a copy-constructed
+    /// allocator.
+    /// @param alloc Allocator to copy.
+    explicit ThreadPool(const AllocatorType& alloc) noexcept
+        : m_workers(alloc, nullptr),
+          m_injected(alloc)
+    {
+    }
+
+    /// @brief Allocates the queues and starts the worker threads.
+    /// @param threadCount Number of worker threads, at least one.
+    /// @param queueCapacity Minimum number of tasks each queue can hold.
+    /// @return Error::OutOfRange if threadCount is zero, Error::NoMemory if
+    /// the queues could not be allocated, Error::IntegerOverflow if the sizes
+    /// are too large, or Error::Unsuccessful if the pool was already started
+    /// or a thread could not be created.
+    Err Start(uint32_t threadCount, size_t queueCapacity = 1024) noexcept
+    {
+        // without workers, queued tasks would only run once someone waits
+        if RAD_UNLIKELY (threadCount == 0)
+        {
+            return Error::OutOfRange;
+        }
+
+        if RAD_UNLIKELY (m_workerMemory != nullptr)
+        {
+            return Error::Unsuccessful;
+        }
+
+        if (threadCount > (AllocatorTraits::MaxSize - alignof(Worker)) /
+                              sizeof(Worker))
+        {
+            return Error::IntegerOverflow;
+        }
+
+        // workers are over-aligned, so align them within the allocation
+        const size_t bytes = threadCount * sizeof(Worker) + alignof(Worker);
+        void* mem = AllocatorTraits::AllocBytes(Allocator(), bytes);
+        if (mem == nullptr)
+        {
+            return Error::NoMemory;
+        }
+
+        const uintptr_t addr = reinterpret_cast<uintptr_t>(mem);
+        const uintptr_t aligned =
+            (addr + alignof(Worker) - 1) & ~uintptr_t(alignof(Worker) - 1);
+        Worker* workers = reinterpret_cast<Worker*>(aligned);
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            ::new (static_cast<void*>(workers + i))
+                Worker(this, i, m_workers.First());
+        }
+
+        m_workerMemory = mem;
+        m_workerBytes = bytes;
+        Workers() = workers;
+        m_workerCount = threadCount;
+
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            Err err = workers[i].deque.Init(queueCapacity);
+            if (err.IsErr())
+            {
+                DestroyWorkers();
+                return err;
+            }
+        }
+
+        Err err = m_injected.Init(queueCapacity);
+        if (err.IsErr())
+        {
+            DestroyWorkers();
+            return err;
+        }
+
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            if (!workers[i].thread.Start(&WorkerMain, workers + i))
+            {
+                StopWorkers(i);
+                DestroyWorkers();
+                return Error::Unsuccessful;
+            }
+        }
+
+        return NoError;
+    }
+
+    /// @brief Gets the number of worker threads.
+    /// @return The number of workers, zero before Start() succeeds.
+    uint32_t ThreadCount() const noexcept
+    {
+        return m_workerCount;
+    }
+
+    /// @brief Submits a task to run on the pool.
+    /// @details The task is moved into an allocation owned by the pool, and
+    /// runs on the submitting thread if it cannot be queued. Tasks must not
+    /// throw.
+    /// @param fn Callable invoked without arguments.
+    /// @return Error::NoMemory if the task could not be allocated.
+    template <typename F>
+    Err Submit(F&& fn) noexcept
+    {
+        using ImplType = detail::PoolTaskImpl<Decay<F>, TAllocator>;
+        RAD_S_ASSERT_NOTHROW((IsNoThrowCtor<Decay<F>, F&&>));
+
+        ImplType* impl =
+            AllocatorTraits::template Alloc<ImplType>(Allocator(), 1);
+        if (impl == nullptr)
+        {
+            return Error::NoMemory;
+        }
+
+        ::new (static_cast<void*>(impl)) ImplType(Forward<F>(fn));
+        TaskType* task = impl;
+        m_pending.FetchAdd(1, MemOrderRelaxed);
+
+        // only queue once Start() succeeded, as nothing would run the task
+        // after a failed Start() left the injection queue behind
+        Worker* self = CurrentWorker();
+        const bool queued = m_workerCount != 0 &&
+                            ((self != nullptr && self->pool == this &&
+                              self->deque.Push(task).IsOk()) ||
+                             m_injected.TryPush(task).IsOk());
+        if (!queued)
+        {
+            Execute(task);
+            return NoError;
+        }
+
+        m_epoch.FetchAdd(1, MemOrderSeqCst);
+        m_sleepers.WakeOne(m_epoch);
+        return NoError;
+    }
+
+    /// @brief Runs one queued task on the calling thread, if any.
+    /// @return True if a task was run.
+    bool RunOne() noexcept
+    {
+        Worker* self = CurrentWorker();
+        TaskType* task =
+            FindTask(self != nullptr && self->pool == this ? self : nullptr);
+        if (task == nullptr)
+        {
+            return false;
+        }
+
+        Execute(task);
+        return true;
+    }
+
+    /// @brief Blocks until every submitted task has run, helping to run them
+    /// meanwhile.
+    /// @details Must not be called from within a task of this pool, as that
+    /// task counts as not yet run.
+    void WaitIdle() noexcept
+    {
+        for (;;)
+        {
+            const size_t pending = m_pending.Load(MemOrderAcquire);
+            if (pending == 0)
+            {
+                return;
+            }
+
+            if (!RunOne())
+            {
+                m_idleWaiters.Park(m_pending, pending);
+            }
+        }
+    }
+
+    /// @brief Returns the allocator.
+    /// @return The allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_workers.First();
+    }
+
+private:
+
+    static Worker*& CurrentWorker() noexcept
+    {
+        static thread_local Worker* s_current = nullptr;
+        return s_current;
+    }
+
+    static void WorkerMain(void* arg) noexcept
+    {
+        Worker* self = static_cast<Worker*>(arg);
+        CurrentWorker() = self;
+        self->pool->WorkerLoop(self);
+        CurrentWorker() = nullptr;
+    }
+
+    void WorkerLoop(Worker* self) noexcept
+    {
+        for (;;)
+        {
+            TaskType* task = FindTask(self);
+            if (task != nullptr)
+            {
+                Execute(task);
+                continue;
+            }
+
+            // look once more after reading the epoch, so a task submitted
+            // after the first look changes the epoch before parking on it
+            const uint32_t epoch = m_epoch.Load(MemOrderSeqCst);
+            task = FindTask(self);
+            if (task != nullptr)
+            {
+                Execute(task);
+                continue;
+            }
+
+            if (m_stop.Load(MemOrderSeqCst) != 0)
+            {
+                return;
+            }
+
+            m_sleepers.Park(m_epoch, epoch);
+        }
+    }
+
+    TaskType* FindTask(Worker* self) noexcept
+    {
+        if (self != nullptr)
+        {
+            Res<TaskType*> res = self->deque.Pop();
+            if (res.IsOk())
+            {
+                return res.Ok();
+            }
+        }
+
+        Res<TaskType*> res = m_injected.TryPop();
+        if (res.IsOk())
+        {
+            return res.Ok();
+        }
+
+        // start with the next worker so thieves spread over the victims
+        Worker* workers = Workers();
+        const uint32_t count = m_workerCount;
+        const uint32_t start = self != nullptr ? self->index + 1 : 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Worker& victim = workers[(start + i) % count];
+            if (&victim == self)
+            {
+                continue;
+            }
+
+            // losing a race means another thread took a task, try again
+            Res<TaskType*> stolen = victim.deque.Steal();
+            while (stolen.IsErr() && stolen.Err() == Error::Unsuccessful)
+            {
+                stolen = victim.deque.Steal();
+            }
+
+            if (stolen.IsOk())
+            {
+                return stolen.Ok();
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Execute(TaskType* task) noexcept
+    {
+        task->run(task, Allocator());
+        if (m_pending.FetchSub(1, MemOrderSeqCst) == 1)
+        {
+            m_idleWaiters.WakeAll(m_pending);
+        }
+    }
+
+    void StopWorkers(uint32_t started) noexcept
+    {
+        if (started == 0)
+        {
+            return;
+        }
+
+        m_stop.Store(1, MemOrderSeqCst);
+        m_epoch.FetchAdd(1, MemOrderSeqCst);
+        m_epoch.NotifyAll();
+
+        Worker* workers = Workers();
+        for (uint32_t i = 0; i < started; ++i)
+        {
+            workers[i].thread.Join();
+        }
+
+        m_stop.Store(0, MemOrderRelaxed);
+    }
+
+    void DestroyWorkers() noexcept
+    {
+        if (m_workerMemory == nullptr)
+        {
+            return;
+        }
+
+        Worker* workers = Workers();
+        for (uint32_t i = 0; i < m_workerCount; ++i)
+        {
+            workers[i].~Worker();
+        }
+
+        AllocatorTraits::FreeBytes(Allocator(), m_workerMemory, m_workerBytes);
+        m_workerMemory = nullptr;
+        m_workerBytes = 0;
+        Workers() = nullptr;
+        m_workerCount = 0;
+    }
+
+    AllocatorType& Allocator() noexcept
+    {
+        return m_workers.First();
+    }
+
+    Worker*& Workers() noexcept
+    {
+        return m_workers.Second();
+    }
+
+    EmptyOptimizedPair<AllocatorType, Worker*> m_workers;
+    uint32_t m_workerCount = 0;
+    void* m_workerMemory = nullptr;
+    size_t m_workerBytes = 0;
+    MpmcQueue<TaskType*, TAllocator> m_injected;
+    Atomic<size_t> m_pending{ 0 };
+    Atomic<uint32_t> m_epoch{ 0 };
+    Atomic<uint32_t> m_stop{ 0 };
+    detail::SpinParking m_sleepers;
+    detail::SpinParking m_idleWaiters;
+};
+
+} // namespace rad
+
+#endif // RAD_USER_MODE
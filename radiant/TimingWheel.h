@@ -0,0 +1,355 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/IntrusiveList.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/Utility.h"
+#include "radiant/detail/Bits.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rad
+{
+
+class TimingWheelHook;
+
+template <typename T, TimingWheelHook T::*THook, uint32_t TLevels>
+class TimingWheel;
+
+/// @brief Links an object into a TimingWheel as a timer.
+/// @details Embed one hook per wheel the object can be scheduled on. Like
+/// IntrusiveListHook, the hook is immovable and cancels itself when
+/// destroyed, so a timer may be destroyed while scheduled.
+class TimingWheelHook
+{
+public:
+
+    TimingWheelHook() noexcept = default;
+    ~TimingWheelHook() = default;
+
+    // immovable
+    RAD_NOT_COPYABLE(TimingWheelHook);
+    TimingWheelHook(TimingWheelHook&&) = delete;
+    TimingWheelHook& operator=(TimingWheelHook&&) = delete;
+
+    /// @brief Checks if the timer is scheduled.
+    /// @return True if the timer is waiting on a wheel.
+    bool IsScheduled() const noexcept
+    {
+        return m_link.IsLinked();
+    }
+
+    /// @brief Gets the tick the timer was last scheduled for.
+    /// @return The deadline.
+    uint64_t Deadline() const noexcept
+    {
+        return m_deadline;
+    }
+
+    /// @brief Unschedules the timer in O(1). Does nothing if the timer is
+    /// not scheduled.
+    void Cancel() noexcept
+    {
+        m_link.Unlink();
+    }
+
+private:
+
+    template <typename T, TimingWheelHook T::*THook, uint32_t TLevels>
+    friend class TimingWheel;
+
+    IntrusiveListHook m_link;
+    uint64_t m_deadline = 0;
+};
+
+/*!
+    @brief Hierarchical timing wheel of caller-owned timers.
+
+    @details Timers are linked through a TimingWheelHook member into one of
+    TLevels wheels of 64 slots. Level 0 holds the timers due within the
+    current 64 ticks, one slot per tick, and each level above covers 64 times
+    the span of the one below it. Timers further out than every level wait
+    on an overflow list.
+
+    Scheduling computes the level and slot from the deadline and links the
+    hook, and cancelling unlinks it, both in O(1) without allocating.
+    Advancing the clock fires the level 0 slots it passes over. Whenever the
+    ticks below a level wrap around, the next slot of that level is
+    cascaded, its timers moving down to the level their deadline now falls
+    in. A timer moves down at most once per level, so a tick costs amortized
+    O(1) per timer. Empty level 0 slots are skipped using a bitmap of
+    occupied slots.
+
+    Ticks are whatever unit the caller advances the clock in. Timers due at
+    the same tick fire in an unspecified order. The wheel does not own its
+    timers and is not thread-safe.
+
+    @code
+    struct Connection
+    {
+        TimingWheelHook timeout;
+    };
+
+    TimingWheel<Connection, &Connection::timeout> wheel;
+    wheel.ScheduleAfter(conn, 30000);
+    wheel.Advance(nowMs, [](Connection& c) noexcept { Close(c); });
+    @endcode
+
+    @tparam T - Type of the timer objects
+    @tparam THook - Pointer to the hook member of T to link through
+    @tparam TLevels - Number of wheels, spanning 64^TLevels ticks
+*/
+template <typename T, TimingWheelHook T::*THook, uint32_t TLevels = 4>
+class TimingWheel
+{
+private:
+
+    using Access = detail::HookOffset<T, TimingWheelHook, THook>;
+    using SlotType = IntrusiveList<TimingWheelHook, &TimingWheelHook::m_link>;
+
+    static constexpr uint32_t SlotBits = 6;
+    static constexpr uint64_t SlotMask = (1u << SlotBits) - 1;
+
+public:
+
+    using ValueType = T;
+    using SizeType = size_t;
+
+    RAD_S_ASSERTMSG(TLevels >= 1 && TLevels * SlotBits < 64,
+                    "TimingWheel supports 1 to 10 levels");
+
+    /// @brief Number of slots in each level.
+    static constexpr uint32_t SlotCount = 1u << SlotBits;
+
+    /// @brief Number of ticks ahead a timer can be scheduled without going to
+    /// the overflow list.
+    static constexpr uint64_t Span = uint64_t{ 1 } << (TLevels * SlotBits);
+
+    RAD_NOT_COPYABLE(TimingWheel);
+    TimingWheel(TimingWheel&&) = delete;
+    TimingWheel& operator=(TimingWheel&&) = delete;
+
+    /// @brief Constructs an empty wheel.
+    /// @param now Current tick.
+    explicit TimingWheel(uint64_t now = 0) noexcept
+        : m_now(now)
+    {
+    }
+
+    /// @brief Unlinks every scheduled timer.
+    ~TimingWheel() = default;
+
+    /// @brief Gets the current tick.
+    /// @return The tick the wheel was last advanced to.
+    uint64_t Now() const noexcept
+    {
+        return m_now;
+    }
+
+    /// @brief Schedules a timer, or reschedules it if it is already scheduled
+    /// on this wheel.
+    /// @param timer Timer to schedule, which must not be scheduled on another
+    /// wheel through the same hook.
+    /// @param deadline Tick at which the timer fires. Deadlines that have
+    /// already passed fire on the next tick.
+    void Schedule(T& timer, uint64_t deadline) noexcept
+    {
+        TimingWheelHook& hook = Access::Hook(timer);
+        hook.Cancel();
+        hook.m_deadline = deadline;
+        Place(hook, deadline > m_now ? deadline : m_now + 1);
+    }
+
+    /// @brief Schedules a timer relative to the current tick.
+    /// @param timer Timer to schedule.
+    /// @param delay Number of ticks from now at which the timer fires.
+    void ScheduleAfter(T& timer, uint64_t delay) noexcept
+    {
+        Schedule(timer, m_now + delay);
+    }
+
+    /// @brief Unschedules a timer in O(1). Does nothing if the timer is not
+    /// scheduled.
+    /// @param timer Timer to cancel.
+    static void Cancel(T& timer) noexcept
+    {
+        (timer.*THook).Cancel();
+    }
+
+    /// @brief Moves the clock forward, firing the timers that come due.
+    /// @details Each expired timer is unscheduled before fn is called with
+    /// it, so fn may reschedule or destroy it, and may schedule or cancel
+    /// other timers. Calling Advance from fn is erroneous.
+    /// @param now Tick to advance to. Ticks that have already passed are
+    /// ignored.
+    /// @param fn Callable invoked with a T& for each expired timer.
+    /// @return Number of timers fired.
+    template <typename F>
+    SizeType Advance(uint64_t now, F&& fn) noexcept
+    {
+        RAD_S_ASSERT_NOTHROW(noexcept(fn(DeclVal<T&>())));
+
+        SizeType fired = 0;
+        while (m_now < now)
+        {
+            uint64_t tick = m_now + 1;
+            if ((tick & SlotMask) != 0)
+            {
+                // nothing cascades before the end of this turn of level 0,
+                // so go straight to its next occupied slot
+                const uint64_t turnEnd = (tick | SlotMask) + 1;
+                const uint64_t pending = m_occupied[0] >> (tick & SlotMask);
+                const uint64_t next =
+                    pending == 0 ? turnEnd
+                                 : tick + detail::BitTrailingZeros(pending);
+                if (next > now)
+                {
+                    m_now = now;
+                    break;
+                }
+
+                if (next == turnEnd)
+                {
+                    m_now = turnEnd - 1;
+                    continue;
+                }
+
+                tick = next;
+            }
+
+            m_now = tick;
+            fired += Tick(fn);
+        }
+
+        return fired;
+    }
+
+    /// @brief Unlinks every scheduled timer.
+    void Clear() noexcept
+    {
+        for (auto& level : m_slots)
+        {
+            for (SlotType& slot : level)
+            {
+                slot.Clear();
+            }
+        }
+
+        for (uint64_t& occupied : m_occupied)
+        {
+            occupied = 0;
+        }
+
+        m_overflow.Clear();
+    }
+
+private:
+
+    // links a hook into the slot of a deadline after m_now
+    void Place(TimingWheelHook& hook, uint64_t deadline) noexcept
+    {
+        RAD_ASSERT(deadline > m_now);
+
+        // the highest level at which the deadline and now differ
+        const uint32_t level =
+            (63 - detail::BitLeadingZeros(deadline ^ m_now)) / SlotBits;
+        if (level >= TLevels)
+        {
+            m_overflow.PushBack(hook);
+            return;
+        }
+
+        const uint32_t slot =
+            static_cast<uint32_t>((deadline >> (level * SlotBits)) & SlotMask);
+        m_slots[level][slot].PushBack(hook);
+        m_occupied[level] |= uint64_t{ 1 } << slot;
+    }
+
+    // moves the timers of a list down to where they now belong, or to the
+    // expired list when due
+    void Cascade(SlotType& list, SlotType& expired) noexcept
+    {
+        SlotType pending;
+        pending.SpliceAll(pending.end(), list);
+        while (!pending.Empty())
+        {
+            TimingWheelHook& hook = pending.Front();
+            pending.PopFront();
+            if (hook.m_deadline <= m_now)
+            {
+                expired.PushBack(hook);
+            }
+            else
+            {
+                Place(hook, hook.m_deadline);
+            }
+        }
+    }
+
+    // processes m_now, which has just been reached
+    template <typename F>
+    SizeType Tick(F& fn) noexcept
+    {
+        SlotType expired;
+
+        // levels whose lower ticks wrapped around cascade, highest first
+        uint32_t level = 1;
+        while (level <= TLevels &&
+               (m_now & ((uint64_t{ 1 } << (level * SlotBits)) - 1)) == 0)
+        {
+            ++level;
+        }
+
+        if (level > TLevels)
+        {
+            Cascade(m_overflow, expired);
+            --level;
+        }
+
+        while (--level > 0)
+        {
+            const uint32_t slot =
+                static_cast<uint32_t>((m_now >> (level * SlotBits)) & SlotMask);
+            m_occupied[level] &= ~(uint64_t{ 1 } << slot);
+            Cascade(m_slots[level][slot], expired);
+        }
+
+        const uint32_t slot = static_cast<uint32_t>(m_now & SlotMask);
+        m_occupied[0] &= ~(uint64_t{ 1 } << slot);
+        expired.SpliceAll(expired.end(), m_slots[0][slot]);
+
+        SizeType fired = 0;
+        while (!expired.Empty())
+        {
+            TimingWheelHook& hook = expired.Front();
+            expired.PopFront();
+            fn(*Access::Owner(&hook));
+            ++fired;
+        }
+
+        return fired;
+    }
+
+    uint64_t m_now;
+    // bit i is set while slot i of a level may hold timers
+    uint64_t m_occupied[TLevels] = {};
+    SlotType m_slots[TLevels][SlotCount];
+    SlotType m_overflow;
+};
+
+} // namespace rad
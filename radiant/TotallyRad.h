@@ -88,6 +88,14 @@
 #define RAD_MSVC_VERSION _MSVC_VER
 #endif
 
+#if defined(RAD_MSC_VERSION)
+#define RAD_NOINLINE __declspec(noinline)
+#elif defined(__GNUC__) && __GNUC__
+#define RAD_NOINLINE __attribute__((noinline))
+#else
+#define RAD_NOINLINE
+#endif
+
 #if !defined(NDEBUG) || defined(_DEBUG)
 #define RAD_DBG 1
 #else
@@ -152,6 +160,19 @@ static_assert(!(RAD_WINDOWS && RAD_MACOS), "env invalid os");
 #error unsupported hardware
 #endif
 
+//
+// Size of the unit in which caches transfer and invalidate memory. Data written
+// by different cores should be kept at least this far apart to avoid false
+// sharing. Apple ARM64 cores use 128-byte lines.
+//
+#ifndef RAD_CACHE_LINE_SIZE
+#if RAD_ARM64 && RAD_MACOS
+#define RAD_CACHE_LINE_SIZE 128
+#else
+#define RAD_CACHE_LINE_SIZE 64
+#endif
+#endif
+
 #define RAD_UNUSED(x) ((void)x)
 
 #ifdef RAD_MSC_VERSION
@@ -234,6 +255,18 @@ extern "C" __declspec(noreturn) void __fastfail(unsigned int code);
 #define RAD_S_ASSERT(x)       static_assert(x, #x)
 #define RAD_S_ASSERTMSG(x, m) static_assert(x, m)
 
+//
+// Enables RAD_TRACE_SCOPE, which records timed scopes into per-thread buffers
+// drained by a collector, along with the trace points built into Radiant. See
+// Trace.h. When disabled, trace scopes compile to nothing.
+//
+#ifndef RAD_ENABLE_TRACING
+#define RAD_ENABLE_TRACING 0
+#endif
+#if !RAD_ENABLE_TRACING
+#define RAD_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
 //
 // Enables broad assertions that objects do not throw exceptions.
 //
@@ -0,0 +1,363 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/CacheAligned.h"
+#include "radiant/Locks.h"
+#include "radiant/Span.h"
+#include "radiant/SpinLocks.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if RAD_ENABLE_TRACING && !RAD_USER_MODE
+#error "RAD_ENABLE_TRACING requires RAD_USER_MODE"
+#endif
+
+#if RAD_USER_MODE
+
+#ifdef RAD_MSC_VERSION
+#include <intrin.h>
+#elif RAD_AMD64 || RAD_I386
+#include <x86intrin.h>
+#endif
+
+#if RAD_WINDOWS && !(RAD_AMD64 || RAD_I386 || RAD_ARM64)
+#include <Windows.h> // NOLINT(misc-include-cleaner)
+#elif !RAD_WINDOWS && !(RAD_AMD64 || RAD_I386 || RAD_ARM64)
+#include <time.h>
+#endif
+
+//
+// Number of events each thread's trace buffer holds until the collector drains
+// it. Must be a power of two. Events recorded while the buffer is full are
+// dropped and counted.
+//
+#ifndef RAD_TRACE_BUFFER_SIZE
+#define RAD_TRACE_BUFFER_SIZE 1024
+#endif
+
+#if RAD_ENABLE_TRACING
+/// @brief Records the time spent in the rest of the enclosing scope as a trace
+/// event named @p name, which must be a string literal or otherwise outlive
+/// the collector's use of it.
+#define RAD_TRACE_SCOPE(name)                                                  \
+    ::rad::TraceScope RAD_CONCAT(radTraceScope, __LINE__)(name)
+#endif
+
+namespace rad
+{
+
+/// @brief Reads the cheapest monotonic timestamp counter of the processor.
+/// @details The TSC on x86 and the virtual counter on ARM64, which take a few
+/// nanoseconds to read and run at a fixed rate on current processors. Other
+/// targets fall back to QueryPerformanceCounter or CLOCK_MONOTONIC
+/// nanoseconds. Timestamps are in counter ticks, compare them with each other
+/// rather than with wall clock time.
+inline uint64_t TraceTimestamp() noexcept
+{
+#if RAD_AMD64 || RAD_I386
+    return __rdtsc();
+#elif RAD_ARM64 && defined(RAD_MSC_VERSION)
+    return static_cast<uint64_t>(_ReadStatusReg(ARM64_CNTVCT));
+#elif RAD_ARM64
+    uint64_t ticks;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#elif RAD_WINDOWS
+    LARGE_INTEGER ticks;
+    QueryPerformanceCounter(&ticks);
+    return static_cast<uint64_t>(ticks.QuadPart);
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000u +
+           static_cast<uint64_t>(ts.tv_nsec);
+#endif
+}
+
+/// @brief Timed scope recorded by a thread.
+struct TraceEvent
+{
+    /// @brief Name the scope was traced with.
+    const char* name;
+
+    /// @brief TraceTimestamp() when the scope was entered.
+    uint64_t begin;
+
+    /// @brief TraceTimestamp() when the scope was left.
+    uint64_t end;
+
+    /// @brief Number identifying the recording thread, starting from one in
+    /// the order threads first traced a scope.
+    uint32_t thread;
+};
+
+namespace detail
+{
+
+/// @brief Internal use only. Event as stored in a trace buffer.
+struct TraceSlot
+{
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+};
+
+RAD_BEGIN_CACHE_ALIGNED
+/// @brief Internal use only. Ring of events written by its thread and read by
+/// the collector.
+/// @details As in SpscQueue, each side owns its position on a cache line of
+/// its own, and the writer only reads the collector's position when its
+/// cached copy says the ring is full.
+struct TraceBuffer
+{
+    static constexpr uint32_t Capacity = RAD_TRACE_BUFFER_SIZE;
+    RAD_S_ASSERTMSG(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                    "RAD_TRACE_BUFFER_SIZE must be a power of two");
+
+    TraceBuffer() noexcept = default;
+
+    RAD_NOT_COPYABLE(TraceBuffer);
+
+    void Record(const char* name, uint64_t begin, uint64_t end) noexcept
+    {
+        const uint32_t pos = head.Get().Load(MemOrderRelaxed);
+        if RAD_UNLIKELY (pos - cachedTail == Capacity)
+        {
+            cachedTail = tail.Get().Load(MemOrderAcquire);
+            if (pos - cachedTail == Capacity)
+            {
+                // only this thread writes the count
+                dropped.Store(dropped.Load(MemOrderRelaxed) + 1,
+                              MemOrderRelaxed);
+                return;
+            }
+        }
+
+        TraceSlot& slot = slots[pos & (Capacity - 1)];
+        slot.name = name;
+        slot.begin = begin;
+        slot.end = end;
+        head.Get().Store(pos + 1, MemOrderRelease);
+    }
+
+    size_t Drain(Span<TraceEvent> out) noexcept
+    {
+        const uint32_t first = tail.Get().Load(MemOrderRelaxed);
+        const uint32_t available = head.Get().Load(MemOrderAcquire) - first;
+        const uint32_t count =
+            available < out.Size() ? available : out.Size();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const TraceSlot& slot = slots[(first + i) & (Capacity - 1)];
+            out[i] = TraceEvent{ slot.name, slot.begin, slot.end, thread };
+        }
+
+        tail.Get().Store(first + count, MemOrderRelease);
+        return count;
+    }
+
+    uint32_t Pending() const noexcept
+    {
+        return head.Get().Load(MemOrderAcquire) -
+               tail.Get().Load(MemOrderRelaxed);
+    }
+
+    CacheAligned<Atomic<uint32_t>> head{ 0u };
+    uint32_t cachedTail = 0;
+    Atomic<uint64_t> dropped{ 0 };
+    CacheAligned<Atomic<uint32_t>> tail{ 0u };
+
+    // owned by the registry
+    TraceBuffer* next = nullptr;
+    uint32_t thread = 0;
+
+    TraceSlot slots[Capacity];
+};
+RAD_END_CACHE_ALIGNED
+
+/// @brief Internal use only. Set of the trace buffers of running threads.
+/// @details Threads add their buffer when they first trace a scope and
+/// remove it when they exit. The lock only serializes those with the
+/// collector, recording never takes it.
+class TraceRegistry final
+{
+public:
+
+    RAD_NOT_COPYABLE(TraceRegistry);
+
+    TraceRegistry() noexcept = default;
+
+    static TraceRegistry& Global() noexcept
+    {
+        static TraceRegistry registry;
+        return registry;
+    }
+
+    void Add(TraceBuffer& buffer) noexcept
+    {
+        LockExclusive<TicketSpinLock> lock(m_lock);
+        buffer.thread = ++m_threads;
+        buffer.next = m_first;
+        m_first = &buffer;
+    }
+
+    void Remove(TraceBuffer& buffer) noexcept
+    {
+        LockExclusive<TicketSpinLock> lock(m_lock);
+        for (TraceBuffer** link = &m_first; *link != nullptr;
+             link = &(*link)->next)
+        {
+            if (*link == &buffer)
+            {
+                *link = buffer.next;
+                break;
+            }
+        }
+
+        // events the collector did not get to are lost with the thread
+        m_dropped += buffer.dropped.Load(MemOrderRelaxed) + buffer.Pending();
+    }
+
+    size_t Drain(Span<TraceEvent> out) noexcept
+    {
+        LockExclusive<TicketSpinLock> lock(m_lock);
+        size_t count = 0;
+        for (TraceBuffer* buffer = m_first;
+             buffer != nullptr && count < out.Size();
+             buffer = buffer->next)
+        {
+            count += buffer->Drain(
+                out.Subspan(static_cast<SpanSizeType>(count)));
+        }
+
+        return count;
+    }
+
+    uint64_t Dropped() noexcept
+    {
+        LockExclusive<TicketSpinLock> lock(m_lock);
+        uint64_t dropped = m_dropped;
+        for (TraceBuffer* buffer = m_first; buffer != nullptr;
+             buffer = buffer->next)
+        {
+            dropped += buffer->dropped.Load(MemOrderRelaxed);
+        }
+
+        return dropped;
+    }
+
+private:
+
+    TicketSpinLock m_lock;
+    TraceBuffer* m_first = nullptr;
+    uint64_t m_dropped = 0;
+    uint32_t m_threads = 0;
+};
+
+/// @brief Internal use only. Trace buffer of a thread, registered for the
+/// lifetime of the thread.
+struct TraceThread
+{
+    TraceThread() noexcept
+    {
+        TraceRegistry::Global().Add(buffer);
+    }
+
+    ~TraceThread()
+    {
+        TraceRegistry::Global().Remove(buffer);
+    }
+
+    RAD_NOT_COPYABLE(TraceThread);
+
+    TraceBuffer buffer;
+};
+
+inline TraceBuffer& TraceCurrentBuffer() noexcept
+{
+    static thread_local TraceThread thread;
+    return thread.buffer;
+}
+
+} // namespace detail
+
+/// @brief Records a timed scope into the calling thread's trace buffer.
+/// @details Wait-free, the first call on a thread registers its buffer. The
+/// event is dropped if the buffer is full.
+/// @param name Name of the scope, which must outlive the collector's use of
+/// it.
+/// @param begin TraceTimestamp() when the scope was entered.
+/// @param end TraceTimestamp() when the scope was left.
+inline void TraceRecord(const char* name, uint64_t begin, uint64_t end) noexcept
+{
+    detail::TraceCurrentBuffer().Record(name, begin, end);
+}
+
+/// @brief Moves recorded events out of the trace buffers of running threads.
+/// @details Meant to be called periodically by one collector thread, often
+/// enough that the buffers do not fill up. Each thread's events are in the
+/// order they ended. Events still buffered when their thread exits are
+/// dropped.
+/// @param out Destination for the events.
+/// @return Number of events written to @p out.
+inline size_t TraceDrain(Span<TraceEvent> out) noexcept
+{
+    return detail::TraceRegistry::Global().Drain(out);
+}
+
+/// @brief Number of events dropped so far because a trace buffer was full or
+/// its thread exited before they were drained.
+inline uint64_t TraceDroppedCount() noexcept
+{
+    return detail::TraceRegistry::Global().Dropped();
+}
+
+/// @brief RAII trace of the lifetime of a scope, see RAD_TRACE_SCOPE.
+/// @details Reads the timestamp counter on entry and exit and records one
+/// event holding both when the scope is left.
+class RAD_NODISCARD TraceScope final
+{
+public:
+
+    RAD_NOT_COPYABLE(TraceScope);
+
+    /// @brief Starts timing the scope.
+    /// @param name Name of the scope, which must outlive the collector's use
+    /// of it.
+    explicit TraceScope(const char* name) noexcept
+        : m_name(name),
+          m_begin(TraceTimestamp())
+    {
+    }
+
+    /// @brief Records the scope.
+    ~TraceScope()
+    {
+        TraceRecord(m_name, m_begin, TraceTimestamp());
+    }
+
+private:
+
+    const char* m_name;
+    uint64_t m_begin;
+};
+
+} // namespace rad
+
+#endif // RAD_USER_MODE
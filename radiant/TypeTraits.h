@@ -15,6 +15,7 @@
 #pragma once
 
 #include "radiant/TotallyRad.h"
+#include "radiant/detail/Meta.h"
 #include "radiant/detail/StdTypeTraits.h"
 
 #include <stdint.h>
@@ -230,6 +231,35 @@ RAD_INLINE_VAR constexpr bool IsTrivDtor = is_trivially_destructible<T>::value;
 template <typename T>
 RAD_INLINE_VAR constexpr bool IsNoThrowDtor = is_nothrow_destructible<T>::value;
 
+namespace detail
+{
+template <typename T, typename = void>
+struct DeclaresTrivRelocatable
+{
+    static constexpr bool Val = false;
+};
+
+template <typename T>
+struct DeclaresTrivRelocatable<
+    T,
+    meta::VoidT<decltype(T::IsTriviallyRelocatable)>>
+{
+    static constexpr bool Val = T::IsTriviallyRelocatable;
+};
+} // namespace detail
+
+/// @brief True when moving a T to new storage and destroying the source is
+/// equivalent to copying its bytes.
+/// @details Trivially move constructible and destructible types qualify
+/// implicitly. Other types may opt in by declaring
+/// `static constexpr bool IsTriviallyRelocatable = true;`, which is only
+/// correct when the type holds no pointers into itself and nothing tracks its
+/// address.
+template <typename T>
+RAD_INLINE_VAR constexpr bool IsTrivRelocatable =
+    (IsTrivMoveCtor<T> && IsTrivDtor<T>) ||
+    detail::DeclaresTrivRelocatable<T>::Val;
+
 namespace detail
 {
 template <typename>
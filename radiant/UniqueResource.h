@@ -36,6 +36,7 @@ public:
     using ValueType = typename Policy::ValueType;
     static constexpr ValueType InvalidValue = Policy::InvalidValue;
     using ThisType = UniqueResource<Policy>;
+    static constexpr bool IsTriviallyRelocatable = true;
 
     RAD_S_ASSERTMSG(IsTriv<ValueType>,
                     "UniqueResource manages a trivial type.");
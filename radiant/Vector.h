@@ -15,7 +15,9 @@
 #pragma once
 
 #include "radiant/TotallyRad.h"
+#include "radiant/Algorithm.h"
 #include "radiant/EmptyOptimizedPair.h"
+#include "radiant/GrowthPolicy.h"
 #include "radiant/Memory.h"
 #include "radiant/Res.h"
 #include "radiant/Span.h"
@@ -34,26 +36,36 @@ namespace rad
 /// @tparam TAllocator Allocator type to use.
 /// @tparam TInlineCount Optionally specifies a number of elements for inline
 /// storage which may be used for small optimizations.
+/// @tparam TGrowth Growth policy deciding the capacity to grow to when the
+/// container runs out of room. See GrowthPolicy.h.
 template <typename T,
           typename TAllocator RAD_ALLOCATOR_EQ(T),
-          uint16_t TInlineCount = 0>
+          uint16_t TInlineCount = 0,
+          typename TGrowth = GrowByHalf>
 class Vector final
 {
 private:
 
-    using OperationalType = detail::VectorOperations<T, TInlineCount>;
+    using OperationalType =
+        detail::VectorOperations<T, TInlineCount, TGrowth>;
     using StorageType = EmptyOptimizedPair<TAllocator, OperationalType>;
     using AllocatorTraits = AllocTraits<TAllocator>;
 
 public:
 
-    using ThisType = Vector<T, TAllocator, TInlineCount>;
+    using ThisType = Vector<T, TAllocator, TInlineCount, TGrowth>;
     using ValueType = T;
     using SizeType = uint32_t;
     static constexpr uint16_t InlineCount = TInlineCount;
     using AllocatorType = TAllocator;
+    using GrowthType = TGrowth;
     template <typename OtherTAllocator, uint16_t OtherTInlineCount = 0>
-    using OtherType = Vector<T, OtherTAllocator, OtherTInlineCount>;
+    using OtherType = Vector<T, OtherTAllocator, OtherTInlineCount, TGrowth>;
+
+    /// @brief Vectors hold no pointers into themselves, so relocating one is a
+    /// byte copy when its allocator and any inline elements allow it.
+    static constexpr bool IsTriviallyRelocatable =
+        detail::VectorRelocatable<T, TAllocator, (TInlineCount > 0)>::Val;
 
     RAD_S_ASSERT_NOTHROW_MOVE_T(T);
 
@@ -289,6 +301,59 @@ public:
         return Storage().Resize(Allocator(), count, value).OnOk(*this);
     }
 
+    /// @brief Resizes the number of elements in the container without
+    /// initializing new elements.
+    /// @details Appended elements have indeterminate values and must be written
+    /// before they are read. Only available for trivial types.
+    /// @param count Requested size of the container.
+    /// @return Result reference to this container on success or an error.
+    Res<ThisType&> ResizeForOverwrite(SizeType count) noexcept
+    {
+        RAD_S_ASSERTMSG((IsTrivDefaultCtor<T> && IsTrivDtor<T>),
+                        "ResizeForOverwrite requires a trivial type");
+
+        return Storage().ResizeForOverwrite(Allocator(), count).OnOk(*this);
+    }
+
+    /// @brief Reserves room for a number of elements past the end of the
+    /// container, to be written directly.
+    /// @details The size of the container is unchanged. Once the elements are
+    /// written, call CommitSize to include them. Only available for trivial
+    /// types.
+    /// @param count Number of elements to make room for.
+    /// @return Span of uninitialized elements following the current elements
+    /// on success or an error.
+    Res<Span<ValueType>> UninitializedAppend(SizeType count) noexcept
+    {
+        RAD_S_ASSERTMSG((IsTrivDefaultCtor<T> && IsTrivDtor<T>),
+                        "UninitializedAppend requires a trivial type");
+
+        Err res = Storage().ReserveAppend(Allocator(), count);
+        if (res.IsErr())
+        {
+            return res.Err();
+        }
+
+        return Span<ValueType>(Data() + Size(), count);
+    }
+
+    /// @brief Sets the number of elements in the container, adopting elements
+    /// written to the storage returned by UninitializedAppend.
+    /// @param count New size of the container, at most Capacity().
+    /// @return Reference to this container.
+    ThisType& CommitSize(SizeType count) noexcept
+    {
+        RAD_S_ASSERTMSG((IsTrivDefaultCtor<T> && IsTrivDtor<T>),
+                        "CommitSize requires a trivial type");
+
+        if RAD_LIKELY (RAD_VERIFY(count <= Capacity()))
+        {
+            Storage().m_size = count;
+        }
+
+        return *this;
+    }
+
     /// @brief Replaces the contents of the container.
     /// @param count Number of elements to assign to the container.
     /// @param value Value to initialize elements with.
@@ -352,6 +417,91 @@ public:
         return EmplaceBack(Forward<ValueType>(value));
     }
 
+    /// @brief Inserts a new element at a given index, shifting the elements
+    /// from that index up by one.
+    /// @tparam ...TArgs Argument types forward to the constructor of the
+    /// element.
+    /// @param index Index of the new element, at most Size().
+    /// @param ...args Arguments to forward to the constructor of the element.
+    /// @return Result reference to this container on success or an error.
+    template <typename... TArgs>
+    Res<ThisType&> Emplace(SizeType index, TArgs&&... args) noexcept(
+        IsNoThrowCtor<T, TArgs...>)
+    {
+        return Storage()
+            .Emplace(Allocator(), index, Forward<TArgs>(args)...)
+            .OnOk(*this);
+    }
+
+    /// @brief Inserts an element at a given index, shifting the elements from
+    /// that index up by one.
+    /// @param index Index of the new element, at most Size().
+    /// @param value Value to be inserted.
+    /// @return Result reference to this container on success or an error.
+    Res<ThisType&> Insert(SizeType index, const ValueType& value) noexcept(
+        IsNoThrowCopyCtor<T>)
+    {
+        return Emplace(index, value);
+    }
+
+    /// @brief Inserts an element at a given index, shifting the elements from
+    /// that index up by one.
+    /// @param index Index of the new element, at most Size().
+    /// @param value Value to be inserted.
+    /// @return Result reference to this container on success or an error.
+    Res<ThisType&> Insert(SizeType index, ValueType&& value) noexcept
+    {
+        return Emplace(index, Forward<ValueType>(value));
+    }
+
+    /// @brief Inserts copies of a span of elements at a given index.
+    /// @details Storage is reserved once and the elements from the index are
+    /// shifted up once, with memmove for trivially relocatable types.
+    /// @param index Index of the first new element, at most Size().
+    /// @param span Span of values to copy, which must not refer to elements of
+    /// this container.
+    /// @return Result reference to this container on success or an error.
+    Res<ThisType&> InsertRange(SizeType index,
+                               Span<const ValueType> span) noexcept(
+        IsNoThrowCopyCtor<T>)
+    {
+        return Storage().InsertRange(Allocator(), index, span).OnOk(*this);
+    }
+
+    /// @brief Removes a number of elements starting at a given index, shifting
+    /// the following elements down once.
+    /// @param index Index of the first element to remove, at most Size().
+    /// @param count Number of elements to remove. Elements past the end are
+    /// ignored.
+    /// @return Reference to this container.
+    ThisType& Erase(SizeType index, SizeType count = 1) noexcept
+    {
+        Storage().Erase(index, count);
+        return *this;
+    }
+
+    /// @brief Removes the elements a predicate selects, keeping the order of
+    /// the rest.
+    /// @details Every kept element is moved at most once.
+    /// @param pred Predicate called with each element.
+    /// @return Number of elements removed.
+    template <typename Predicate>
+    SizeType EraseIf(Predicate pred) noexcept(
+        noexcept(pred(DeclVal<const ValueType&>())))
+    {
+        return Storage().EraseIf(pred);
+    }
+
+    /// @brief Removes the element at a given index in constant time by moving
+    /// the last element into its place. Does not keep the order of elements.
+    /// @param index Index of the element to remove.
+    /// @return Reference to this container.
+    ThisType& SwapErase(SizeType index) noexcept
+    {
+        Storage().SwapErase(index);
+        return *this;
+    }
+
     /// @brief Removes the last element from the back of the container.
     /// @return Reference to this container.
     ThisType& PopBack() noexcept
@@ -530,54 +680,53 @@ private:
     StorageType m_storage;
 };
 
-template <typename T, typename Allocator, uint16_t TInlineCount>
-constexpr uint16_t Vector<T, Allocator, TInlineCount>::InlineCount;
+template <typename T,
+          typename Allocator,
+          uint16_t TInlineCount,
+          typename TGrowth>
+constexpr uint16_t Vector<T, Allocator, TInlineCount, TGrowth>::InlineCount;
 
 /// @brief Stores a contiguous set of elements.
 /// @tparam T The type of elements.
 /// @tparam TInlineCount Specifies a number of elements for inline storage which
 /// may be used for small optimizations.
 /// @tparam TAllocator Allocator type to use.
+/// @tparam TGrowth Growth policy for the container.
 template <typename T,
           uint16_t TInlineCount,
-          typename TAllocator RAD_ALLOCATOR_EQ(T)>
-using InlineVector = Vector<T, TAllocator, TInlineCount>;
+          typename TAllocator RAD_ALLOCATOR_EQ(T),
+          typename TGrowth = GrowByHalf>
+using InlineVector = Vector<T, TAllocator, TInlineCount, TGrowth>;
 
 template <typename T,
           typename TAllocator,
           uint16_t TInlineCount,
+          typename TGrowth,
           typename U,
           typename UAllocator,
-          uint16_t UInlineCount>
+          uint16_t UInlineCount,
+          typename UGrowth>
 constexpr inline bool operator==(
-    const Vector<T, TAllocator, TInlineCount>& left,
-    const Vector<U, UAllocator, UInlineCount>& right)
+    const Vector<T, TAllocator, TInlineCount, TGrowth>& left,
+    const Vector<U, UAllocator, UInlineCount, UGrowth>& right)
 {
-    if (left.Size() != right.Size())
-    {
-        return false;
-    }
-
-    for (uint32_t i = 0; i < left.Size(); i++)
-    {
-        if (left[i] != right[i])
-        {
-            return false;
-        }
-    }
-
-    return true;
+    return Equal(left.Data(),
+                 left.Data() + left.Size(),
+                 right.Data(),
+                 right.Data() + right.Size());
 }
 
 template <typename T,
           typename TAllocator,
           uint16_t TInlineCount,
+          typename TGrowth,
           typename U,
           typename UAllocator,
-          uint16_t UInlineCount>
+          uint16_t UInlineCount,
+          typename UGrowth>
 constexpr inline bool operator!=(
-    const Vector<T, TAllocator, TInlineCount>& left,
-    const Vector<U, UAllocator, UInlineCount>& right)
+    const Vector<T, TAllocator, TInlineCount, TGrowth>& left,
+    const Vector<U, UAllocator, UInlineCount, UGrowth>& right)
 {
     return !(left == right);
 }
@@ -585,39 +734,32 @@ constexpr inline bool operator!=(
 template <typename T,
           typename TAllocator,
           uint16_t TInlineCount,
+          typename TGrowth,
           typename U,
           typename UAllocator,
-          uint16_t UInlineCount>
+          uint16_t UInlineCount,
+          typename UGrowth>
 constexpr inline bool operator<(
-    const Vector<T, TAllocator, TInlineCount>& left,
-    const Vector<U, UAllocator, UInlineCount>& right)
+    const Vector<T, TAllocator, TInlineCount, TGrowth>& left,
+    const Vector<U, UAllocator, UInlineCount, UGrowth>& right)
 {
-    auto min = Min(left.Size(), right.Size());
-    for (uint32_t i = 0; i < min; i++)
-    {
-        if (left[i] < right[i])
-        {
-            return true;
-        }
-
-        if (left[i] > right[i])
-        {
-            return false;
-        }
-    }
-
-    return left.Size() < right.Size();
+    return LexCompare(left.Data(),
+                      left.Data() + left.Size(),
+                      right.Data(),
+                      right.Data() + right.Size());
 }
 
 template <typename T,
           typename TAllocator,
           uint16_t TInlineCount,
+          typename TGrowth,
           typename U,
           typename UAllocator,
-          uint16_t UInlineCount>
+          uint16_t UInlineCount,
+          typename UGrowth>
 constexpr inline bool operator>(
-    const Vector<T, TAllocator, TInlineCount>& left,
-    const Vector<U, UAllocator, UInlineCount>& right)
+    const Vector<T, TAllocator, TInlineCount, TGrowth>& left,
+    const Vector<U, UAllocator, UInlineCount, UGrowth>& right)
 {
     return right < left;
 }
@@ -625,12 +767,14 @@ constexpr inline bool operator>(
 template <typename T,
           typename TAllocator,
           uint16_t TInlineCount,
+          typename TGrowth,
           typename U,
           typename UAllocator,
-          uint16_t UInlineCount>
+          uint16_t UInlineCount,
+          typename UGrowth>
 constexpr inline bool operator<=(
-    const Vector<T, TAllocator, TInlineCount>& left,
-    const Vector<U, UAllocator, UInlineCount>& right)
+    const Vector<T, TAllocator, TInlineCount, TGrowth>& left,
+    const Vector<U, UAllocator, UInlineCount, UGrowth>& right)
 {
     return !(right < left);
 }
@@ -638,12 +782,14 @@ constexpr inline bool operator<=(
 template <typename T,
           typename TAllocator,
           uint16_t TInlineCount,
+          typename TGrowth,
           typename U,
           typename UAllocator,
-          uint16_t UInlineCount>
+          uint16_t UInlineCount,
+          typename UGrowth>
 constexpr inline bool operator>=(
-    const Vector<T, TAllocator, TInlineCount>& left,
-    const Vector<U, UAllocator, UInlineCount>& right)
+    const Vector<T, TAllocator, TInlineCount, TGrowth>& left,
+    const Vector<U, UAllocator, UInlineCount, UGrowth>& right)
 {
     return !(left < right);
 }
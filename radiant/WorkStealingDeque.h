@@ -0,0 +1,272 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Atomic.h"
+#include "radiant/CacheAligned.h"
+#include "radiant/EmptyOptimizedPair.h"
+#include "radiant/Memory.h"
+#include "radiant/Res.h"
+#include "radiant/TypeTraits.h"
+
+#include <stddef.h>
+
+namespace rad
+{
+
+RAD_BEGIN_CACHE_ALIGNED
+/// @brief Bounded Chase-Lev work-stealing deque.
+/// @details The owning thread pushes and pops at the bottom like a stack,
+/// while any number of thieves steal from the top. The owner only contends
+/// with thieves when a single element is left. Top and bottom live on cache
+/// lines of their own.
+///
+/// Slots are allocated once by Init(). Init() and destruction are not
+/// thread-safe, Push() and Pop() may only be called by the owning thread, and
+/// Steal() may be called by any thread.
+/// @tparam T Integral or pointer type of the elements, typically a pointer to
+/// a task.
+/// @tparam TAllocator Allocator used to obtain the slots.
+template <typename T, typename TAllocator RAD_ALLOCATOR_EQ(T)>
+class WorkStealingDeque final
+{
+private:
+
+    using SlotType = Atomic<T>;
+    using AllocatorTraits = AllocTraits<TAllocator>;
+
+public:
+
+    using ValueType = T;
+    using SizeType = size_t;
+    using AllocatorType = TAllocator;
+
+    RAD_S_ASSERTMSG(IsIntegral<T> || IsPointer<T>,
+                    "WorkStealingDeque supports only integral and pointer "
+                    "types");
+
+    RAD_NOT_COPYABLE(WorkStealingDeque);
+    WorkStealingDeque(WorkStealingDeque&&) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+    ~WorkStealingDeque()
+    {
+        Release();
+    }
+
+    /// @brief Constructs a deque without capacity using a default-constructed
+    /// allocator.
+    WorkStealingDeque() noexcept = default;
+
+    /// @brief Constructs a deque without capacity using a copy-constructed
+    /// allocator.
+    /// @param alloc Allocator to copy.
+    explicit WorkStealingDeque(const AllocatorType& alloc) noexcept
+        : m_storage(alloc, nullptr)
+    {
+    }
+
+    /// @brief Allocates the slots of the deque, discarding any elements held.
+    /// @param capacity Minimum number of elements the deque can hold, rounded
+    /// up to a power of two.
+    /// @return Error::NoMemory if the slots could not be allocated, or
+    /// Error::IntegerOverflow if the capacity is too large.
+    Err Init(SizeType capacity) noexcept
+    {
+        SizeType count = 1;
+        while (count < capacity)
+        {
+            if RAD_UNLIKELY (count > (~SizeType(0) >> 2))
+            {
+                return Error::IntegerOverflow;
+            }
+
+            count <<= 1;
+        }
+
+        SlotType* slots =
+            AllocatorTraits::template Alloc<SlotType>(Allocator(), count);
+        if (slots == nullptr)
+        {
+            return Error::NoMemory;
+        }
+
+        for (SizeType i = 0; i < count; ++i)
+        {
+            ::new (static_cast<void*>(slots + i)) SlotType();
+        }
+
+        Release();
+        Slots() = slots;
+        m_mask = count - 1;
+        return NoError;
+    }
+
+    /// @brief Gets the number of elements the deque can hold.
+    /// @return The capacity, zero before Init() succeeds.
+    SizeType Capacity() const noexcept
+    {
+        return Slots() == nullptr ? 0 : m_mask + 1;
+    }
+
+    /// @brief Gets the number of elements in the deque.
+    /// @details The value may be stale by the time it is returned when other
+    /// threads operate on the deque concurrently.
+    /// @return Number of elements in the deque.
+    SizeType ApproxSize() const noexcept
+    {
+        const ptrdiff_t top = m_top.Load(MemOrderRelaxed);
+        const ptrdiff_t bottom = m_bottom.Load(MemOrderRelaxed);
+        return bottom > top ? static_cast<SizeType>(bottom - top) : 0;
+    }
+
+    /// @brief Pushes an element at the bottom. Owner only.
+    /// @param value Element to push.
+    /// @return Error::OutOfRange if the deque is full.
+    Err Push(T value) noexcept
+    {
+        const ptrdiff_t bottom = m_bottom.Load(MemOrderRelaxed);
+        const ptrdiff_t top = m_top.Load(MemOrderAcquire);
+        if (static_cast<SizeType>(bottom - top) >= Capacity())
+        {
+            return Error::OutOfRange;
+        }
+
+        Slots()[static_cast<SizeType>(bottom) & m_mask].Store(value,
+                                                              MemOrderRelaxed);
+        m_bottom.Store(bottom + 1, MemOrderRelease);
+        return NoError;
+    }
+
+    /// @brief Pops the most recently pushed element. Owner only.
+    /// @return The element, or Error::OutOfRange if the deque is empty.
+    Res<T> Pop() noexcept
+    {
+        if RAD_UNLIKELY (Slots() == nullptr)
+        {
+            return Res<T>(ResErrTag, Error::OutOfRange);
+        }
+
+        // reserve the bottom element before looking at top; the exchange
+        // orders the two like a full fence would
+        const ptrdiff_t bottom = m_bottom.Load(MemOrderRelaxed) - 1;
+        m_bottom.Exchange(bottom, MemOrderSeqCst);
+        ptrdiff_t top = m_top.Load(MemOrderSeqCst);
+
+        if (top > bottom)
+        {
+            m_bottom.Store(bottom + 1, MemOrderRelaxed);
+            return Res<T>(ResErrTag, Error::OutOfRange);
+        }
+
+        const T value = Slots()[static_cast<SizeType>(bottom) & m_mask].Load(
+            MemOrderRelaxed);
+        if (top == bottom)
+        {
+            // last element, race thieves for it
+            const bool won = m_top.CompareExchangeStrong(top,
+                                                         top + 1,
+                                                         MemOrderSeqCst,
+                                                         MemOrderRelaxed);
+            m_bottom.Store(bottom + 1, MemOrderRelaxed);
+            if (!won)
+            {
+                return Res<T>(ResErrTag, Error::OutOfRange);
+            }
+        }
+
+        return Res<T>(ResOkTag, value);
+    }
+
+    /// @brief Steals the least recently pushed element.
+    /// @return The element, Error::OutOfRange if the deque is empty, or
+    /// Error::Unsuccessful if another thread took the element first, in which
+    /// case retrying may succeed.
+    Res<T> Steal() noexcept
+    {
+        ptrdiff_t top = m_top.Load(MemOrderSeqCst);
+        const ptrdiff_t bottom = m_bottom.Load(MemOrderSeqCst);
+        if (top >= bottom)
+        {
+            return Res<T>(ResErrTag, Error::OutOfRange);
+        }
+
+        const T value =
+            Slots()[static_cast<SizeType>(top) & m_mask].Load(MemOrderRelaxed);
+        if (!m_top.CompareExchangeStrong(top,
+                                         top + 1,
+                                         MemOrderSeqCst,
+                                         MemOrderRelaxed))
+        {
+            return Res<T>(ResErrTag, Error::Unsuccessful);
+        }
+
+        return Res<T>(ResOkTag, value);
+    }
+
+    /// @brief Returns the allocator.
+    /// @return The allocator.
+    AllocatorType GetAllocator() const noexcept
+    {
+        return m_storage.First();
+    }
+
+private:
+
+    void Release() noexcept
+    {
+        SlotType* slots = Slots();
+        if (slots == nullptr)
+        {
+            return;
+        }
+
+        const SizeType count = m_mask + 1;
+        for (SizeType i = 0; i < count; ++i)
+        {
+            slots[i].~SlotType();
+        }
+
+        AllocatorTraits::Free(Allocator(), slots, count);
+        Slots() = nullptr;
+        m_mask = 0;
+        m_top.Store(0, MemOrderRelaxed);
+        m_bottom.Store(0, MemOrderRelaxed);
+    }
+
+    AllocatorType& Allocator() noexcept
+    {
+        return m_storage.First();
+    }
+
+    SlotType*& Slots() noexcept
+    {
+        return m_storage.Second();
+    }
+
+    SlotType* Slots() const noexcept
+    {
+        return m_storage.Second();
+    }
+
+    EmptyOptimizedPair<AllocatorType, SlotType*> m_storage;
+    SizeType m_mask = 0;
+    PaddedAtomic<ptrdiff_t> m_top;
+    PaddedAtomic<ptrdiff_t> m_bottom;
+};
+RAD_END_CACHE_ALIGNED
+
+} // namespace rad
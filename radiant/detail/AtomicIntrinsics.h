@@ -20,6 +20,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #if RAD_WINDOWS && RAD_KERNEL_MODE
 #include <ntddk.h>
@@ -32,6 +33,22 @@
 #include <ntstatus.h> // NOLINT(misc-include-cleaner)
 #endif
 
+//
+// RAD_HAS_DWCAS is 1 when a lock-free compare-exchange of two adjacent 64-bit
+// words is available, e.g. cmpxchg16b on x64 or casp on ARM64. GCC and Clang
+// only provide it inline when the target enables it, e.g. with -mcx16. When
+// it is 1, rad::Atomic also supports 16-byte trivially copyable types, such
+// as a pointer paired with an ABA tag.
+//
+#if defined(RAD_MSC_VERSION) && (RAD_AMD64 || RAD_ARM64)
+#define RAD_HAS_DWCAS 1
+#elif (defined(RAD_GCC_VERSION) || defined(RAD_CLANG_VERSION)) &&              \
+    defined(__SIZEOF_INT128__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+#define RAD_HAS_DWCAS 1
+#else
+#define RAD_HAS_DWCAS 0
+#endif
+
 namespace rad
 {
 enum class MemoryOrder : int
@@ -1666,6 +1683,201 @@ struct SelectIntrinsic
 };
 #endif
 
+#if RAD_HAS_DWCAS
+/// @brief Internal use only. Compares and exchanges two adjacent 64-bit words
+/// as a unit, with sequentially consistent ordering.
+/// @param storage 16-byte aligned words to update.
+/// @param expected Words to compare with, receives the stored words.
+/// @param desired Words to store.
+/// @return True if the words were replaced.
+inline bool CompareExchange128(volatile uint64_t* storage,
+                               uint64_t (&expected)[2],
+                               const uint64_t (&desired)[2]) noexcept
+{
+#ifdef RAD_MSC_VERSION
+    // NOLINTBEGIN(misc-include-cleaner)
+    __int64 comparand[2] = { static_cast<__int64>(expected[0]),
+                             static_cast<__int64>(expected[1]) };
+    const bool res = _InterlockedCompareExchange128(
+                         reinterpret_cast<volatile __int64*>(storage),
+                         static_cast<__int64>(desired[1]),
+                         static_cast<__int64>(desired[0]),
+                         comparand) != 0;
+    // NOLINTEND(misc-include-cleaner)
+    expected[0] = static_cast<uint64_t>(comparand[0]);
+    expected[1] = static_cast<uint64_t>(comparand[1]);
+    return res;
+#else
+    // __atomic builtins on 16 bytes call into libatomic, the legacy __sync
+    // builtin is expanded inline to cmpxchg16b or casp.
+    __extension__ typedef unsigned __int128 Bits;
+    const Bits comparand = (static_cast<Bits>(expected[1]) << 64) | expected[0];
+    const Bits prev = __sync_val_compare_and_swap(
+        reinterpret_cast<volatile Bits*>(storage),
+        comparand,
+        (static_cast<Bits>(desired[1]) << 64) | desired[0]);
+    expected[0] = static_cast<uint64_t>(prev);
+    expected[1] = static_cast<uint64_t>(prev >> 64);
+    return prev == comparand;
+#endif
+}
+
+/// @brief Double-width operations on 16-byte trivially copyable types.
+/// @details Every operation is a compare-exchange of the whole value, so is
+/// sequentially consistent whatever order is requested. Values are compared
+/// bitwise, so T should not have padding. The storage must be 16-byte
+/// aligned.
+/// @warning Loads write to the storage, so unlike the other widths Load()
+/// does not accept const storage. Owners with a const Load() keep the storage
+/// mutable instead, which also keeps it out of read-only memory.
+template <typename T>
+struct SelectIntrinsic<T, 16>
+{
+    RAD_S_ASSERTMSG(IsTrivCopyCtor<T> && IsTrivDtor<T>,
+                    "double-width atomics require trivially copyable types");
+
+    template <typename TOrder>
+    static inline T Load(volatile T& storage, OrderTag<TOrder>) noexcept
+    {
+        CheckLoadMemoryOrder<TOrder>();
+
+        // a failed exchange still reports the current value
+        uint64_t words[2] = { 0, 0 };
+        CompareExchange128(Words(storage), words, words);
+        return FromWords(words);
+    }
+
+    template <typename TOrder>
+    static void Load(const volatile T& storage, OrderTag<TOrder>) = delete;
+
+    template <typename TOrder>
+    static inline void Store(volatile T& storage,
+                             T val,
+                             OrderTag<TOrder>) noexcept
+    {
+        CheckStoreMemoryOrder<TOrder>();
+        Exchange(storage, val, SeqCstTag());
+    }
+
+    template <typename TOrder>
+    static inline T Exchange(volatile T& storage,
+                             T val,
+                             OrderTag<TOrder>) noexcept
+    {
+        uint64_t desired[2];
+        ToWords(val, desired);
+        uint64_t expected[2] = { 0, 0 };
+        while (!CompareExchange128(Words(storage), expected, desired))
+        {
+        }
+
+        return FromWords(expected);
+    }
+
+    template <typename Ts, typename Tf>
+    static inline bool CompareExchangeWeak(volatile T& storage,
+                                           T val,
+                                           T& expected,
+                                           OrderTag<Ts>,
+                                           OrderTag<Tf>) noexcept
+    {
+        Ts success;
+        Tf fail;
+        return CompareExchangeStrong(storage, val, expected, success, fail);
+    }
+
+    template <typename Ts, typename Tf>
+    static inline bool CompareExchangeStrong(volatile T& storage,
+                                             T val,
+                                             T& expected,
+                                             OrderTag<Ts>,
+                                             OrderTag<Tf>) noexcept
+    {
+        CheckLoadMemoryOrder<Tf>();
+        CheckCasMemoryOrdering<Ts, Tf>();
+        uint64_t desired[2];
+        ToWords(val, desired);
+        uint64_t words[2];
+        ToWords(expected, words);
+        if (CompareExchange128(Words(storage), words, desired))
+        {
+            return true;
+        }
+
+        expected = FromWords(words);
+        return false;
+    }
+
+private:
+
+    static inline volatile uint64_t* Words(volatile T& storage) noexcept
+    {
+        return reinterpret_cast<volatile uint64_t*>(&storage);
+    }
+
+    static inline void ToWords(const T& val, uint64_t (&words)[2]) noexcept
+    {
+        memcpy(words, AddrOf(val), sizeof(words));
+    }
+
+    static inline T FromWords(const uint64_t (&words)[2]) noexcept
+    {
+        T val;
+        memcpy(AddrOf(val), words, sizeof(words));
+        return val;
+    }
+};
+
+/// @brief Internal use only. Value of an AtomicDoubleWord.
+struct DoubleWord
+{
+    uint64_t low;
+    uint64_t high;
+};
+
+/// @brief Internal use only. Pair of 64-bit words which are compared and
+/// exchanged as a unit. All operations are sequentially consistent.
+class AtomicDoubleWord
+{
+public:
+
+    constexpr AtomicDoubleWord() noexcept
+        : m_value{ 0, 0 }
+    {
+    }
+
+    constexpr AtomicDoubleWord(DoubleWord value) noexcept
+        : m_value(value)
+    {
+    }
+
+    RAD_NOT_COPYABLE(AtomicDoubleWord);
+
+    DoubleWord Load() const noexcept
+    {
+        return SelectIntrinsic<DoubleWord>::Load(m_value, SeqCstTag());
+    }
+
+    /// @brief Replaces the stored value with desired if it equals expected.
+    /// @param expected Value to compare with, receives the stored value.
+    /// @param desired Value to store.
+    /// @return True if the value was replaced.
+    bool CompareExchange(DoubleWord& expected, DoubleWord desired) noexcept
+    {
+        return SelectIntrinsic<DoubleWord>::CompareExchangeStrong(m_value,
+                                                                  desired,
+                                                                  expected,
+                                                                  SeqCstTag(),
+                                                                  SeqCstTag());
+    }
+
+private:
+
+    // loads compare-exchange the value
+    alignas(16) mutable DoubleWord m_value;
+};
+#endif
+
 } // namespace atomic
 } // namespace detail
 } // namespace rad
@@ -0,0 +1,182 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/detail/AtomicIntrinsics.h"
+
+#include <stdint.h>
+
+#if RAD_LINUX && RAD_USER_MODE
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif !RAD_WINDOWS
+#include <sched.h>
+#endif
+
+//
+// RAD_ATOMIC_WAIT_PARKS is 1 when Atomic Wait() puts the calling thread to
+// sleep in the OS, using futex on Linux and WaitOnAddress in Windows user
+// mode. Elsewhere, including kernel mode, Wait() polls the value while
+// yielding the processor, and NotifyOne() and NotifyAll() do nothing.
+//
+#if (RAD_LINUX || RAD_WINDOWS) && RAD_USER_MODE
+#define RAD_ATOMIC_WAIT_PARKS 1
+#else
+#define RAD_ATOMIC_WAIT_PARKS 0
+#endif
+
+#if RAD_WINDOWS && RAD_USER_MODE && defined(RAD_MSC_VERSION)
+#pragma comment(lib, "Synchronization.lib")
+#endif
+
+namespace rad
+{
+namespace detail
+{
+namespace atomic
+{
+
+#if RAD_LINUX && RAD_USER_MODE
+inline void FutexWait(const volatile uint32_t* addr, uint32_t val) noexcept
+{
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, nullptr, nullptr, 0);
+}
+
+inline void FutexWake(const volatile uint32_t* addr, int count) noexcept
+{
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+// futex only waits on 32-bit words. Other sizes wait on a sequence number,
+// shared by all addresses hashing to it, which is bumped on every notify.
+inline volatile uint32_t& WaitSequence(const volatile void* addr) noexcept
+{
+    static volatile uint32_t s_sequences[64];
+
+    const uintptr_t bits = reinterpret_cast<uintptr_t>(addr);
+    return s_sequences[((bits >> 2) ^ (bits >> 8)) & 63];
+}
+
+template <typename T, typename TOrder>
+inline void WaitWhileEqual(const volatile T& storage,
+                           T old,
+                           OrderTag<TOrder> order,
+                           TrueType) noexcept
+{
+    while (SelectIntrinsic<T>::Load(storage, order) == old)
+    {
+        FutexWait(reinterpret_cast<const volatile uint32_t*>(&storage),
+                  static_cast<uint32_t>(old));
+    }
+}
+
+template <typename T, typename TOrder>
+inline void WaitWhileEqual(const volatile T& storage,
+                           T old,
+                           OrderTag<TOrder> order,
+                           FalseType) noexcept
+{
+    volatile uint32_t& sequence = WaitSequence(&storage);
+    for (;;)
+    {
+        const uint32_t seq =
+            SelectIntrinsic<uint32_t>::Load(sequence, SeqCstTag());
+        if (SelectIntrinsic<T>::Load(storage, order) != old)
+        {
+            return;
+        }
+
+        FutexWait(&sequence, seq);
+    }
+}
+
+template <typename T>
+inline void Wake(const volatile T& storage, int count, TrueType) noexcept
+{
+    FutexWake(reinterpret_cast<const volatile uint32_t*>(&storage), count);
+}
+
+template <typename T>
+inline void Wake(const volatile T& storage, int, FalseType) noexcept
+{
+    // waiters on other addresses share the sequence, so wake all of them
+    volatile uint32_t& sequence = WaitSequence(&storage);
+    SelectIntrinsic<uint32_t>::FetchAdd(sequence, 1u, SeqCstTag());
+    FutexWake(&sequence, INT32_MAX);
+}
+#endif
+
+/// @brief Internal use only. Blocks while storage holds old.
+/// @details May return spuriously, callers re-check the value.
+template <typename T, typename TOrder>
+inline void Wait(const volatile T& storage,
+                 T old,
+                 OrderTag<TOrder> order) noexcept
+{
+#if RAD_WINDOWS && RAD_USER_MODE
+    while (SelectIntrinsic<T>::Load(storage, order) == old)
+    {
+        WaitOnAddress(const_cast<T*>(&storage), &old, sizeof(T), INFINITE);
+    }
+#elif RAD_LINUX && RAD_USER_MODE
+    WaitWhileEqual(storage,
+                   old,
+                   order,
+                   IntegralConstant<bool, sizeof(T) == sizeof(uint32_t)>());
+#else
+    while (SelectIntrinsic<T>::Load(storage, order) == old)
+    {
+        RAD_YIELD_PROCESSOR();
+    }
+#endif
+}
+
+/// @brief Internal use only. Wakes at least one thread blocked in Wait() on
+/// storage, if any.
+template <typename T>
+inline void NotifyOne(const volatile T& storage) noexcept
+{
+#if RAD_WINDOWS && RAD_USER_MODE
+    WakeByAddressSingle(const_cast<T*>(&storage));
+#elif RAD_LINUX && RAD_USER_MODE
+    Wake(storage,
+         1,
+         IntegralConstant<bool, sizeof(T) == sizeof(uint32_t)>());
+#else
+    RAD_UNUSED(storage);
+#endif
+}
+
+/// @brief Internal use only. Wakes all threads blocked in Wait() on storage.
+template <typename T>
+inline void NotifyAll(const volatile T& storage) noexcept
+{
+#if RAD_WINDOWS && RAD_USER_MODE
+    WakeByAddressAll(const_cast<T*>(&storage));
+#elif RAD_LINUX && RAD_USER_MODE
+    Wake(storage,
+         INT32_MAX,
+         IntegralConstant<bool, sizeof(T) == sizeof(uint32_t)>());
+#else
+    RAD_UNUSED(storage);
+#endif
+}
+
+} // namespace atomic
+} // namespace detail
+} // namespace rad
@@ -0,0 +1,142 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+
+#include <stdint.h>
+
+#if defined(RAD_MSC_VERSION) && !defined(RAD_CLANG_VERSION)
+#include <intrin.h>
+#include <stdlib.h>
+#endif
+
+//
+// Bit counting on 64-bit words, and byte reversal. GCC and Clang builtins
+// lower to POPCNT, TZCNT, LZCNT and BSWAP (or their NEON equivalents) when
+// the target has them. MSVC uses the BitScan and byteswap intrinsics, which
+// every x86 and ARM target supports, and a portable population count since
+// __popcnt64 needs the POPCNT instruction.
+//
+namespace rad
+{
+namespace detail
+{
+
+/// @brief Internal use only. Number of set bits in a value.
+inline uint32_t BitPopCount(uint64_t value) noexcept
+{
+#if defined(RAD_MSC_VERSION) && !defined(RAD_CLANG_VERSION)
+    value = value - ((value >> 1) & 0x5555555555555555ull);
+    value = (value & 0x3333333333333333ull) +
+            ((value >> 2) & 0x3333333333333333ull);
+    value = (value + (value >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<uint32_t>((value * 0x0101010101010101ull) >> 56);
+#else
+    return static_cast<uint32_t>(__builtin_popcountll(value));
+#endif
+}
+
+/// @brief Internal use only. Index of the lowest set bit of a non-zero value.
+inline uint32_t BitTrailingZeros(uint64_t value) noexcept
+{
+    RAD_ASSERT(value != 0);
+
+#if defined(RAD_MSC_VERSION) && !defined(RAD_CLANG_VERSION)
+    unsigned long index;
+#if RAD_AMD64 || RAD_ARM64
+    _BitScanForward64(&index, value);
+#else
+    if (static_cast<uint32_t>(value) != 0)
+    {
+        _BitScanForward(&index, static_cast<uint32_t>(value));
+    }
+    else
+    {
+        _BitScanForward(&index, static_cast<uint32_t>(value >> 32));
+        index += 32;
+    }
+#endif
+    return index;
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+}
+
+/// @brief Internal use only. Number of zero bits above the highest set bit of
+/// a non-zero value.
+inline uint32_t BitLeadingZeros(uint64_t value) noexcept
+{
+    RAD_ASSERT(value != 0);
+
+#if defined(RAD_MSC_VERSION) && !defined(RAD_CLANG_VERSION)
+    unsigned long index;
+#if RAD_AMD64 || RAD_ARM64
+    _BitScanReverse64(&index, value);
+#else
+    if ((value >> 32) != 0)
+    {
+        _BitScanReverse(&index, static_cast<uint32_t>(value >> 32));
+        index += 32;
+    }
+    else
+    {
+        _BitScanReverse(&index, static_cast<uint32_t>(value));
+    }
+#endif
+    return 63 - index;
+#else
+    return static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+}
+
+/// @brief Internal use only. Reverses the bytes of a value.
+inline uint8_t BitByteSwap(uint8_t value) noexcept
+{
+    return value;
+}
+
+/// @copydoc BitByteSwap(uint8_t)
+inline uint16_t BitByteSwap(uint16_t value) noexcept
+{
+#if defined(RAD_MSC_VERSION) && !defined(RAD_CLANG_VERSION)
+    return _byteswap_ushort(value);
+#else
+    return __builtin_bswap16(value);
+#endif
+}
+
+/// @copydoc BitByteSwap(uint8_t)
+inline uint32_t BitByteSwap(uint32_t value) noexcept
+{
+#if defined(RAD_MSC_VERSION) && !defined(RAD_CLANG_VERSION)
+    return _byteswap_ulong(value);
+#else
+    return __builtin_bswap32(value);
+#endif
+}
+
+/// @copydoc BitByteSwap(uint8_t)
+inline uint64_t BitByteSwap(uint64_t value) noexcept
+{
+#if defined(RAD_MSC_VERSION) && !defined(RAD_CLANG_VERSION)
+    return _byteswap_uint64(value);
+#else
+    return __builtin_bswap64(value);
+#endif
+}
+
+} // namespace detail
+} // namespace rad
@@ -0,0 +1,248 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/detail/Bits.h"
+
+#include <stdint.h>
+
+//
+// Control bytes of open-addressing hash tables, matched a group at a time.
+// Every slot of a table has a control byte which is either empty, deleted, or
+// holds the low 7 bits of the hash of the key stored in the slot. A group is
+// a run of control bytes starting at any slot, compared against a byte in one
+// go. SSE2 and NEON compare 16 bytes at once, the portable fallback compares
+// 8 bytes in a 64-bit word.
+//
+#if RAD_AMD64 ||                                                               \
+    (RAD_I386 && (defined(__SSE2__) ||                                         \
+                  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define RAD_HASH_GROUP_SSE2 1
+#include <emmintrin.h>
+#else
+#define RAD_HASH_GROUP_SSE2 0
+#endif
+
+#if RAD_ARM64 && !RAD_HASH_GROUP_SSE2
+#define RAD_HASH_GROUP_NEON 1
+#include <arm_neon.h>
+#else
+#define RAD_HASH_GROUP_NEON 0
+#endif
+
+namespace rad
+{
+namespace detail
+{
+
+using HashCtrl = int8_t;
+
+static constexpr HashCtrl HashCtrlEmpty = -128;
+static constexpr HashCtrl HashCtrlDeleted = -2;
+
+constexpr inline bool HashCtrlIsFull(HashCtrl ctrl) noexcept
+{
+    return ctrl >= 0;
+}
+
+/// @brief Internal use only. Index of the lowest set bit of a non-zero value.
+inline uint32_t HashTrailingZeros(uint64_t value) noexcept
+{
+    return BitTrailingZeros(value);
+}
+
+/// @brief Internal use only. Set of slots within a group, one bit per slot
+/// every 1 << TShift bits.
+template <typename T, uint32_t TShift>
+class HashBitMask final
+{
+public:
+
+    explicit HashBitMask(T mask) noexcept
+        : m_mask(mask)
+    {
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_mask != 0;
+    }
+
+    /// @brief Gets the lowest slot of a non-empty set.
+    uint32_t Lowest() const noexcept
+    {
+        return HashTrailingZeros(m_mask) >> TShift;
+    }
+
+    /// @brief Removes the lowest slot from a non-empty set.
+    void ClearLowest() noexcept
+    {
+        m_mask &= static_cast<T>(m_mask - 1);
+    }
+
+private:
+
+    T m_mask;
+};
+
+/// @brief Internal use only. Group of 8 control bytes matched with 64-bit
+/// integer arithmetic.
+class HashGroupPortable final
+{
+public:
+
+    static constexpr uint32_t Width = 8;
+
+    using MaskType = HashBitMask<uint64_t, 3>;
+
+    explicit HashGroupPortable(const HashCtrl* ctrl) noexcept
+        : m_ctrl(0)
+    {
+        // assembled byte by byte so the first slot is the lowest byte on any
+        // byte order, compilers fold this into a single load
+        for (uint32_t i = 0; i < Width; ++i)
+        {
+            m_ctrl |= uint64_t(static_cast<uint8_t>(ctrl[i])) << (i * 8);
+        }
+    }
+
+    /// @brief Slots whose control byte is h2. May include a slot following
+    /// a match which does not hold h2.
+    MaskType Match(uint8_t h2) const noexcept
+    {
+        const uint64_t x = m_ctrl ^ (Lsbs * h2);
+        return MaskType((x - Lsbs) & ~x & Msbs);
+    }
+
+    MaskType MatchEmpty() const noexcept
+    {
+        // only empty has the high bit set and bit 1 clear
+        return MaskType(m_ctrl & (~m_ctrl << 6) & Msbs);
+    }
+
+    MaskType MatchEmptyOrDeleted() const noexcept
+    {
+        // only empty and deleted have the high bit set and bit 0 clear
+        return MaskType(m_ctrl & (~m_ctrl << 7) & Msbs);
+    }
+
+private:
+
+    static constexpr uint64_t Lsbs = 0x0101010101010101ull;
+    static constexpr uint64_t Msbs = 0x8080808080808080ull;
+
+    uint64_t m_ctrl;
+};
+
+#if RAD_HASH_GROUP_SSE2
+/// @brief Internal use only. Group of 16 control bytes matched with SSE2.
+class HashGroupSse2 final
+{
+public:
+
+    static constexpr uint32_t Width = 16;
+
+    using MaskType = HashBitMask<uint32_t, 0>;
+
+    explicit HashGroupSse2(const HashCtrl* ctrl) noexcept
+        : m_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)))
+    {
+    }
+
+    MaskType Match(uint8_t h2) const noexcept
+    {
+        const __m128i match = _mm_set1_epi8(static_cast<char>(h2));
+        return ToMask(_mm_cmpeq_epi8(match, m_ctrl));
+    }
+
+    MaskType MatchEmpty() const noexcept
+    {
+        return ToMask(_mm_cmpeq_epi8(_mm_set1_epi8(HashCtrlEmpty), m_ctrl));
+    }
+
+    MaskType MatchEmptyOrDeleted() const noexcept
+    {
+        // empty and deleted are the only values below -1
+        return ToMask(_mm_cmpgt_epi8(_mm_set1_epi8(-1), m_ctrl));
+    }
+
+private:
+
+    static MaskType ToMask(__m128i bytes) noexcept
+    {
+        return MaskType(static_cast<uint32_t>(_mm_movemask_epi8(bytes)));
+    }
+
+    __m128i m_ctrl;
+};
+#endif
+
+#if RAD_HASH_GROUP_NEON
+/// @brief Internal use only. Group of 16 control bytes matched with NEON.
+class HashGroupNeon final
+{
+public:
+
+    static constexpr uint32_t Width = 16;
+
+    // NEON has no byte movemask, narrowing yields 4 bits per slot instead
+    using MaskType = HashBitMask<uint64_t, 2>;
+
+    explicit HashGroupNeon(const HashCtrl* ctrl) noexcept
+        : m_ctrl(vld1q_s8(ctrl))
+    {
+    }
+
+    MaskType Match(uint8_t h2) const noexcept
+    {
+        return ToMask(vceqq_s8(m_ctrl, vdupq_n_s8(static_cast<int8_t>(h2))));
+    }
+
+    MaskType MatchEmpty() const noexcept
+    {
+        return ToMask(vceqq_s8(m_ctrl, vdupq_n_s8(HashCtrlEmpty)));
+    }
+
+    MaskType MatchEmptyOrDeleted() const noexcept
+    {
+        // empty and deleted are the only values below -1
+        return ToMask(vcltq_s8(m_ctrl, vdupq_n_s8(-1)));
+    }
+
+private:
+
+    static MaskType ToMask(uint8x16_t bytes) noexcept
+    {
+        const uint8x8_t nibbles =
+            vshrn_n_u16(vreinterpretq_u16_u8(bytes), 4);
+        return MaskType(vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) &
+                        0x8888888888888888ull);
+    }
+
+    int8x16_t m_ctrl;
+};
+#endif
+
+#if RAD_HASH_GROUP_SSE2
+using HashGroup = HashGroupSse2;
+#elif RAD_HASH_GROUP_NEON
+using HashGroup = HashGroupNeon;
+#else
+using HashGroup = HashGroupPortable;
+#endif
+
+} // namespace detail
+} // namespace rad
@@ -0,0 +1,105 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/Memory.h"
+#include "radiant/TypeTraits.h"
+
+#include <stddef.h>
+
+namespace rad
+{
+namespace detail
+{
+
+/// @brief Internal use only. Type-erased record of an object retired to a
+/// reclamation domain, allocated from the domain's allocator.
+template <typename TAllocator>
+struct RetiredNode
+{
+    // destroys and frees the object, then the node itself
+    void (*reclaim)(RetiredNode* node, TAllocator& alloc);
+    RetiredNode* next;
+    const void* object;
+    size_t tag;
+};
+
+/// @brief Internal use only. Retired object freed through the allocator it
+/// was allocated from.
+template <typename T, typename TObjAlloc, typename TAllocator>
+struct RetiredObject final : RetiredNode<TAllocator>
+{
+    RetiredObject(T* p, const TObjAlloc& alloc, size_t t) noexcept
+        : RetiredNode<TAllocator>{ &Reclaim, nullptr, p, t },
+          ptr(p),
+          objAlloc(alloc)
+    {
+    }
+
+    static void Reclaim(RetiredNode<TAllocator>* node, TAllocator& alloc)
+    {
+        RetiredObject* self = static_cast<RetiredObject*>(node);
+        self->ptr->~T();
+        AllocTraits<TObjAlloc>::Free(self->objAlloc, self->ptr, 1);
+        self->~RetiredObject();
+        AllocTraits<TAllocator>::Free(alloc, self, 1);
+    }
+
+    T* ptr;
+    TObjAlloc objAlloc;
+};
+
+/// @brief Internal use only. Allocates the record of a retired object.
+/// @return The record, or nullptr if it could not be allocated.
+template <typename TAllocator, typename T, typename TObjAlloc>
+RetiredNode<TAllocator>* MakeRetired(TAllocator& alloc,
+                                     T* ptr,
+                                     const TObjAlloc& objAlloc,
+                                     size_t tag) noexcept
+{
+    using NodeType = RetiredObject<T, TObjAlloc, TAllocator>;
+    RAD_S_ASSERT_NOTHROW_DTOR(IsNoThrowDtor<T>);
+    RAD_S_ASSERT_NOTHROW(IsNoThrowCopyCtor<TObjAlloc>);
+
+    NodeType* node =
+        AllocTraits<TAllocator>::template Alloc<NodeType>(alloc, 1);
+    if (node == nullptr)
+    {
+        return nullptr;
+    }
+
+    return ::new (static_cast<void*>(node)) NodeType(ptr, objAlloc, tag);
+}
+
+/// @brief Internal use only. Reclaims every node of a list.
+/// @return Number of nodes reclaimed.
+template <typename TAllocator>
+size_t ReclaimAll(RetiredNode<TAllocator>* node, TAllocator& alloc) noexcept
+{
+    size_t count = 0;
+    while (node != nullptr)
+    {
+        RetiredNode<TAllocator>* next = node->next;
+        node->reclaim(node, alloc);
+        node = next;
+        ++count;
+    }
+
+    return count;
+}
+
+} // namespace detail
+} // namespace rad
@@ -0,0 +1,459 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "radiant/TotallyRad.h"
+#include "radiant/TypeTraits.h"
+#include "radiant/detail/Bits.h"
+#include "radiant/detail/HashGroup.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+//
+// Vectorized scans over contiguous arrays of 1, 2, 4 or 8 byte values which
+// compare equal exactly when their bytes do. Each kernel compares a
+// register's worth of elements at a time and turns the result into a mask
+// with BitsPerByte bits per byte, so the matching elements are found with
+// TrailingZeros and counted with PopCount. AVX2 is used when the compiler
+// targets it, otherwise SSE2 or NEON where HashGroup.h found them. The
+// remainder of each array, and every array on other targets, is handled one
+// element at a time.
+//
+#if RAD_HASH_GROUP_SSE2 && defined(__AVX2__)
+#define RAD_SEARCH_AVX2 1
+#include <immintrin.h>
+#else
+#define RAD_SEARCH_AVX2 0
+#endif
+
+namespace rad
+{
+namespace detail
+{
+namespace search
+{
+
+inline uint32_t PopCount(uint64_t value) noexcept
+{
+    return BitPopCount(value);
+}
+
+#if RAD_SEARCH_AVX2
+
+struct SimdAvx2
+{
+    static constexpr uint32_t Width = 32;
+    static constexpr uint32_t BitsPerByte = 1;
+    static constexpr uint64_t AllEqual = 0xffffffffull;
+
+    using RegType = __m256i;
+
+    static RegType Load(const void* ptr) noexcept
+    {
+        return _mm256_loadu_si256(static_cast<const __m256i*>(ptr));
+    }
+
+    template <size_t W>
+    static RegType Broadcast(const void* value) noexcept
+    {
+        return BroadcastImpl(IntegralConstant<size_t, W>{}, value);
+    }
+
+    template <size_t W>
+    static uint64_t EqMask(RegType a, RegType b) noexcept
+    {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(
+            EqImpl(IntegralConstant<size_t, W>{}, a, b)));
+    }
+
+private:
+
+    static RegType BroadcastImpl(IntegralConstant<size_t, 1>,
+                                 const void* value) noexcept
+    {
+        int8_t bits;
+        memcpy(&bits, value, sizeof(bits));
+        return _mm256_set1_epi8(bits);
+    }
+
+    static RegType BroadcastImpl(IntegralConstant<size_t, 2>,
+                                 const void* value) noexcept
+    {
+        int16_t bits;
+        memcpy(&bits, value, sizeof(bits));
+        return _mm256_set1_epi16(bits);
+    }
+
+    static RegType BroadcastImpl(IntegralConstant<size_t, 4>,
+                                 const void* value) noexcept
+    {
+        int32_t bits;
+        memcpy(&bits, value, sizeof(bits));
+        return _mm256_set1_epi32(bits);
+    }
+
+    static RegType BroadcastImpl(IntegralConstant<size_t, 8>,
+                                 const void* value) noexcept
+    {
+        int64_t bits;
+        memcpy(&bits, value, sizeof(bits));
+        return _mm256_set1_epi64x(bits);
+    }
+
+    static RegType EqImpl(IntegralConstant<size_t, 1>,
+                          RegType a,
+                          RegType b) noexcept
+    {
+        return _mm256_cmpeq_epi8(a, b);
+    }
+
+    static RegType EqImpl(IntegralConstant<size_t, 2>,
+                          RegType a,
+                          RegType b) noexcept
+    {
+        return _mm256_cmpeq_epi16(a, b);
+    }
+
+    static RegType EqImpl(IntegralConstant<size_t, 4>,
+                          RegType a,
+                          RegType b) noexcept
+    {
+        return _mm256_cmpeq_epi32(a, b);
+    }
+
+    static RegType EqImpl(IntegralConstant<size_t, 8>,
+                          RegType a,
+                          RegType b) noexcept
+    {
+        return _mm256_cmpeq_epi64(a, b);
+    }
+};
+
+using Simd = SimdAvx2;
+#define RAD_SEARCH_SIMD 1
+
+#elif RAD_HASH_GROUP_SSE2
+
+struct SimdSse2
+{
+    static constexpr uint32_t Width = 16;
+    static constexpr uint32_t BitsPerByte = 1;
+    static constexpr uint64_t AllEqual = 0xffffull;
+
+    using RegType = __m128i;
+
+    static RegType Load(const void* ptr) noexcept
+    {
+        return _mm_loadu_si128(static_cast<const __m128i*>(ptr));
+    }
+
+    template <size_t W>
+    static RegType Broadcast(const void* value) noexcept
+    {
+        return BroadcastImpl(IntegralConstant<size_t, W>{}, value);
+    }
+
+    template <size_t W>
+    static uint64_t EqMask(RegType a, RegType b) noexcept
+    {
+        return static_cast<uint32_t>(
+            _mm_movemask_epi8(EqImpl(IntegralConstant<size_t, W>{}, a, b)));
+    }
+
+private:
+
+    static RegType BroadcastImpl(IntegralConstant<size_t, 1>,
+                                 const void* value) noexcept
+    {
+        int8_t bits;
+        memcpy(&bits, value, sizeof(bits));
+        return _mm_set1_epi8(bits);
+    }
+
+    static RegType BroadcastImpl(IntegralConstant<size_t, 2>,
+                                 const void* value) noexcept
+    {
+        int16_t bits;
+        memcpy(&bits, value, sizeof(bits));
+        return _mm_set1_epi16(bits);
+    }
+
+    static RegType BroadcastImpl(IntegralConstant<size_t, 4>,
+                                 const void* value) noexcept
+    {
+        int32_t bits;
+        memcpy(&bits, value, sizeof(bits));
+        return _mm_set1_epi32(bits);
+    }
+
+    static RegType BroadcastImpl(IntegralConstant<size_t, 8>,
+                                 const void* value) noexcept
+    {
+        // two 32-bit halves, as _mm_set1_epi64x is missing on some 32-bit
+        // targets
+        int32_t bits[2];
+        memcpy(bits, value, sizeof(bits));
+        return _mm_set_epi32(bits[1], bits[0], bits[1], bits[0]);
+    }
+
+    static RegType EqImpl(IntegralConstant<size_t, 1>,
+                          RegType a,
+                          RegType b) noexcept
+    {
+        return _mm_cmpeq_epi8(a, b);
+    }
+
+    static RegType EqImpl(IntegralConstant<size_t, 2>,
+                          RegType a,
+                          RegType b) noexcept
+    {
+        return _mm_cmpeq_epi16(a, b);
+    }
+
+    static RegType EqImpl(IntegralConstant<size_t, 4>,
+                          RegType a,
+                          RegType b) noexcept
+    {
+        return _mm_cmpeq_epi32(a, b);
+    }
+
+    static RegType EqImpl(IntegralConstant<size_t, 8>,
+                          RegType a,
+                          RegType b) noexcept
+    {
+        // SSE2 has no 64-bit compare, both 32-bit halves must match
+        const __m128i eq = _mm_cmpeq_epi32(a, b);
+        const __m128i swapped = _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm_and_si128(eq, swapped);
+    }
+};
+
+using Simd = SimdSse2;
+#define RAD_SEARCH_SIMD 1
+
+#elif RAD_HASH_GROUP_NEON
+
+struct SimdNeon
+{
+    static constexpr uint32_t Width = 16;
+    static constexpr uint32_t BitsPerByte = 4;
+    static constexpr uint64_t AllEqual = ~uint64_t(0);
+
+    using RegType = uint8x16_t;
+
+    static RegType Load(const void* ptr) noexcept
+    {
+        return vld1q_u8(static_cast<const uint8_t*>(ptr));
+    }
+
+    template <size_t W>
+    static RegType Broadcast(const void* value) noexcept
+    {
+        return BroadcastImpl(IntegralConstant<size_t, W>{}, value);
+    }
+
+    template <size_t W>
+    static uint64_t EqMask(RegType a, RegType b) noexcept
+    {
+        // narrowing each 16-bit lane by 4 leaves a nibble per byte
+        const uint8x16_t eq = EqImpl(IntegralConstant<size_t, W>{}, a, b);
+        const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+    }
+
+private:
+
+    static RegType BroadcastImpl(IntegralConstant<size_t, 1>,
+                                 const void* value) noexcept
+    {
+        uint8_t bits;
+        memcpy(&bits, value, sizeof(bits));
+        return vdupq_n_u8(bits);
+    }
+
+    static RegType BroadcastImpl(IntegralConstant<size_t, 2>,
+                                 const void* value) noexcept
+    {
+        uint16_t bits;
+        memcpy(&bits, value, sizeof(bits));
+        return vreinterpretq_u8_u16(vdupq_n_u16(bits));
+    }
+
+    static RegType BroadcastImpl(IntegralConstant<size_t, 4>,
+                                 const void* value) noexcept
+    {
+        uint32_t bits;
+        memcpy(&bits, value, sizeof(bits));
+        return vreinterpretq_u8_u32(vdupq_n_u32(bits));
+    }
+
+    static RegType BroadcastImpl(IntegralConstant<size_t, 8>,
+                                 const void* value) noexcept
+    {
+        uint64_t bits;
+        memcpy(&bits, value, sizeof(bits));
+        return vreinterpretq_u8_u64(vdupq_n_u64(bits));
+    }
+
+    static RegType EqImpl(IntegralConstant<size_t, 1>,
+                          RegType a,
+                          RegType b) noexcept
+    {
+        return vceqq_u8(a, b);
+    }
+
+    static RegType EqImpl(IntegralConstant<size_t, 2>,
+                          RegType a,
+                          RegType b) noexcept
+    {
+        return vreinterpretq_u8_u16(
+            vceqq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+    }
+
+    static RegType EqImpl(IntegralConstant<size_t, 4>,
+                          RegType a,
+                          RegType b) noexcept
+    {
+        return vreinterpretq_u8_u32(
+            vceqq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+    }
+
+    static RegType EqImpl(IntegralConstant<size_t, 8>,
+                          RegType a,
+                          RegType b) noexcept
+    {
+        return vreinterpretq_u8_u64(
+            vceqq_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b)));
+    }
+};
+
+using Simd = SimdNeon;
+#define RAD_SEARCH_SIMD 1
+
+#else
+#define RAD_SEARCH_SIMD 0
+#endif
+
+/// @brief Internal use only. First element of [first, last) whose bytes
+/// equal those of value, or last.
+template <typename T>
+const T* FindBytes(const T* first, const T* last, const T& value) noexcept
+{
+    if (sizeof(T) == 1)
+    {
+        // memchr must not be given the null pointer of an empty range
+        if (first == last)
+        {
+            return last;
+        }
+
+        unsigned char byte;
+        memcpy(&byte, &value, 1);
+        const void* found =
+            memchr(first, byte, static_cast<size_t>(last - first));
+        return found != nullptr ? static_cast<const T*>(found) : last;
+    }
+
+#if RAD_SEARCH_SIMD
+    static constexpr ptrdiff_t PerReg = Simd::Width / sizeof(T);
+    static constexpr uint32_t BitsPerElement = Simd::BitsPerByte * sizeof(T);
+    const Simd::RegType needle = Simd::Broadcast<sizeof(T)>(&value);
+    for (; last - first >= PerReg; first += PerReg)
+    {
+        const uint64_t mask =
+            Simd::EqMask<sizeof(T)>(Simd::Load(first), needle);
+        if (mask != 0)
+        {
+            return first + HashTrailingZeros(mask) / BitsPerElement;
+        }
+    }
+#endif
+
+    for (; first != last; ++first)
+    {
+        if (memcmp(first, &value, sizeof(T)) == 0)
+        {
+            break;
+        }
+    }
+
+    return first;
+}
+
+/// @brief Internal use only. Number of elements of [first, last) whose bytes
+/// equal those of value.
+template <typename T>
+size_t CountBytes(const T* first, const T* last, const T& value) noexcept
+{
+    size_t count = 0;
+#if RAD_SEARCH_SIMD
+    static constexpr ptrdiff_t PerReg = Simd::Width / sizeof(T);
+    static constexpr uint32_t BitsPerElement = Simd::BitsPerByte * sizeof(T);
+    const Simd::RegType needle = Simd::Broadcast<sizeof(T)>(&value);
+    for (; last - first >= PerReg; first += PerReg)
+    {
+        count += PopCount(Simd::EqMask<sizeof(T)>(Simd::Load(first), needle)) /
+                 BitsPerElement;
+    }
+#endif
+
+    for (; first != last; ++first)
+    {
+        count += memcmp(first, &value, sizeof(T)) == 0;
+    }
+
+    return count;
+}
+
+/// @brief Internal use only. Index of the first of size elements whose bytes
+/// differ between left and right, or size.
+template <typename T>
+size_t MismatchBytes(const T* left, const T* right, size_t size) noexcept
+{
+    const unsigned char* a = reinterpret_cast<const unsigned char*>(left);
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(right);
+    const size_t bytes = size * sizeof(T);
+    size_t offset = 0;
+#if RAD_SEARCH_SIMD
+    for (; bytes - offset >= Simd::Width; offset += Simd::Width)
+    {
+        const uint64_t mask =
+            Simd::EqMask<1>(Simd::Load(a + offset), Simd::Load(b + offset));
+        if (mask != Simd::AllEqual)
+        {
+            const size_t byte =
+                offset + HashTrailingZeros(~mask) / Simd::BitsPerByte;
+            return byte / sizeof(T);
+        }
+    }
+#endif
+
+    for (; offset != bytes; ++offset)
+    {
+        if (a[offset] != b[offset])
+        {
+            break;
+        }
+    }
+
+    return offset / sizeof(T);
+}
+
+} // namespace search
+} // namespace detail
+} // namespace rad
@@ -23,6 +23,11 @@
 #include "radiant/TypeTraits.h"
 
 #include <stdint.h>
+#include <string.h>
+
+#if RAD_ENABLE_TRACING
+#include "radiant/Trace.h"
+#endif
 
 namespace rad
 {
@@ -60,13 +65,17 @@ public:
     {
         RAD_ASSERT(buffer == nullptr);
 
-        buffer = AllocatorTraits::template Alloc<T>(allocator, count);
+        AllocResult<T> res =
+            AllocatorTraits::template AllocAtLeast<T>(allocator, count);
+        buffer = res.ptr;
         if (!buffer)
         {
             return false;
         }
 
-        capacity = count;
+        // any slack reported by the allocator becomes usable capacity
+        capacity = res.count > UINT32_MAX ? UINT32_MAX
+                                          : static_cast<uint32_t>(res.count);
         size = 0;
 
         return true;
@@ -252,7 +261,7 @@ struct VectorManipulation
         }
     }
 
-    template <typename U = T, EnIf<IsTrivMoveCtor<U>, int> = 0>
+    template <typename U = T, EnIf<IsTrivRelocatable<U>, int> = 0>
     inline void MoveCtorDtorSrcRange(T* dest, T* src, uint32_t count) noexcept
     {
         //
@@ -263,13 +272,16 @@ struct VectorManipulation
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Warray-bounds"
 #endif
-        memmove(dest, src, count * sizeof(T));
+        // trivially relocatable types need not be trivially copyable
+        memmove(static_cast<void*>(dest),
+                static_cast<const void*>(src),
+                count * sizeof(T));
 #if !RAD_DBG && defined(RAD_GCC_VERSION)
 #pragma GCC diagnostic pop
 #endif
     }
 
-    template <typename U = T, EnIf<!IsTrivMoveCtor<U>, int> = 0>
+    template <typename U = T, EnIf<!IsTrivRelocatable<U>, int> = 0>
     inline void MoveCtorDtorSrcRange(T* dest, T* src, uint32_t count) noexcept(
         IsNoThrowMoveCtor<T>)
     {
@@ -285,6 +297,34 @@ struct VectorManipulation
         }
     }
 
+    // overlapping ranges where dest is after src, trivially relocatable types
+    // are shifted with memmove
+    template <typename U = T, EnIf<IsTrivRelocatable<U>, int> = 0>
+    inline void MoveCtorDtorSrcRangeBackward(T* dest,
+                                             T* src,
+                                             uint32_t count) noexcept
+    {
+        MoveCtorDtorSrcRange(dest, src, count);
+    }
+
+    template <typename U = T, EnIf<!IsTrivRelocatable<U>, int> = 0>
+    inline void MoveCtorDtorSrcRangeBackward(T* dest,
+                                             T* src,
+                                             uint32_t count) noexcept(
+        IsNoThrowMoveCtor<T>)
+    {
+        RAD_S_ASSERT_NOTHROW_DTOR(IsNoThrowDtor<T>);
+
+        for (uint32_t i = count; i > 0; i--)
+        {
+            T* s = src + i - 1;
+            T* d = dest + i - 1;
+
+            new (d) T(Move(*s));
+            s->~T();
+        }
+    }
+
     template <typename Out, typename U = T, EnIf<IsTrivCopyCtor<U>, int> = 0>
     inline void CopyCtorRange(Out& dest, const T* src, uint32_t count) noexcept
     {
@@ -348,6 +388,20 @@ void VectorAlloc<T, TAllocator>::Clear()
     size = 0;
 }
 
+template <typename T, typename TAllocator, bool TInline>
+struct VectorRelocatable
+{
+    static constexpr bool Val = IsTrivRelocatable<TAllocator>;
+};
+
+template <typename T, typename TAllocator>
+struct VectorRelocatable<T, TAllocator, true>
+{
+    // inline elements are relocated along with the vector
+    static constexpr bool Val =
+        IsTrivRelocatable<TAllocator> && IsTrivRelocatable<T>;
+};
+
 template <typename T, uint16_t TInlineCount, bool = (TInlineCount > 0)>
 struct VectorStorage;
 
@@ -418,7 +472,7 @@ struct VectorStorage<T, TInlineCount, false>
         Free(alloc);
 
         m_data = vec.Release();
-        m_capacity = m_size;
+        m_capacity = vec.capacity;
 
         return NoError;
     }
@@ -536,7 +590,7 @@ struct VectorStorage<T, TInlineCount, true>
             Free(alloc);
 
             m_data = vec.Release();
-            m_capacity = m_size;
+            m_capacity = vec.capacity;
         }
 
         return NoError;
@@ -618,10 +672,10 @@ struct VectorStorage<T, TInlineCount, true>
     SizeType m_capacity;
 };
 
-template <typename T, uint16_t TInlineCount>
+template <typename T, uint16_t TInlineCount, typename TGrowth>
 struct VectorOperations : public VectorStorage<T, TInlineCount>
 {
-    using ThisType = VectorOperations<T, TInlineCount>;
+    using ThisType = VectorOperations<T, TInlineCount, TGrowth>;
     using ValueType = T;
     using SizeType = uint32_t;
     static constexpr uint16_t InlineCount = TInlineCount;
@@ -631,18 +685,7 @@ struct VectorOperations : public VectorStorage<T, TInlineCount>
 
     SizeType GrowthFor(SizeType size) noexcept
     {
-        if (m_capacity > UINT32_MAX - m_capacity / 2)
-        {
-            return UINT32_MAX;
-        }
-
-        SizeType growth = m_capacity + m_capacity / 2;
-        if (growth < size)
-        {
-            return size;
-        }
-
-        return growth;
+        return TGrowth::Next(m_capacity, size, sizeof(T));
     }
 
     void Clear() noexcept
@@ -659,6 +702,28 @@ struct VectorOperations : public VectorStorage<T, TInlineCount>
             return NoError;
         }
 
+        RAD_TRACE_SCOPE("rad::Vector::Reserve");
+        if (!IsInline() && m_data != nullptr)
+        {
+            //
+            // Prefer growing the existing buffer, which avoids relocating
+            // every element when the allocator supports it.
+            //
+            if (AllocTraits<TAllocator>::TryExpand(alloc,
+                                                   m_data,
+                                                   m_capacity,
+                                                   capacity))
+            {
+                m_capacity = capacity;
+                return NoError;
+            }
+
+            if (Realloc(alloc, capacity))
+            {
+                return NoError;
+            }
+        }
+
         VectorAlloc<ValueType, TAllocator> vec(alloc);
         if (!vec.Alloc(capacity))
         {
@@ -670,11 +735,41 @@ struct VectorOperations : public VectorStorage<T, TInlineCount>
         Free(alloc);
 
         m_data = vec.Release();
-        m_capacity = capacity;
+        m_capacity = vec.capacity;
 
         return NoError;
     }
 
+    template <typename TAllocator,
+              typename U = T,
+              EnIf<IsTrivRelocatable<U>, int> = 0>
+    bool Realloc(TAllocator& alloc, SizeType capacity) noexcept
+    {
+        ValueType* data = AllocTraits<TAllocator>::Realloc(alloc,
+                                                           m_data,
+                                                           m_capacity,
+                                                           capacity);
+        if (data == nullptr)
+        {
+            return false;
+        }
+
+        m_data = data;
+        m_capacity = capacity;
+
+        return true;
+    }
+
+    template <typename TAllocator,
+              typename U = T,
+              EnIf<!IsTrivRelocatable<U>, int> = 0>
+    bool Realloc(TAllocator& alloc, SizeType capacity) noexcept
+    {
+        RAD_UNUSED(alloc);
+        RAD_UNUSED(capacity);
+        return false;
+    }
+
     template <typename TAllocator>
     void Move(TAllocator& to_alloc, ThisType& to) noexcept
     {
@@ -793,6 +888,41 @@ struct VectorOperations : public VectorStorage<T, TInlineCount>
         }
     }
 
+    // Changes the size without constructing or destroying elements, so the
+    // caller must only use this with trivial types.
+    template <typename TAllocator>
+    Err ResizeForOverwrite(TAllocator& alloc, SizeType count) noexcept
+    {
+        if (count > m_capacity)
+        {
+            Err res = Reserve(alloc, GrowthFor(count));
+            if (!res.IsOk())
+            {
+                return res;
+            }
+        }
+
+        m_size = count;
+
+        return NoError;
+    }
+
+    template <typename TAllocator>
+    Err ReserveAppend(TAllocator& alloc, SizeType count) noexcept
+    {
+        if RAD_UNLIKELY (count > UINT32_MAX - m_size)
+        {
+            return Error::IntegerOverflow;
+        }
+
+        if (m_size + count > m_capacity)
+        {
+            return Reserve(alloc, GrowthFor(m_size + count));
+        }
+
+        return NoError;
+    }
+
     template <typename TAllocator,
               typename U = T,
               EnIf<!IsNoThrowCopyCtor<U> || !IsNoThrowDefaultCtor<U>, int> = 0>
@@ -898,7 +1028,7 @@ struct VectorOperations : public VectorStorage<T, TInlineCount>
             Free(alloc);
 
             m_data = vec.Release();
-            m_capacity = count;
+            m_capacity = vec.capacity;
         }
 
         m_size = count;
@@ -937,7 +1067,7 @@ struct VectorOperations : public VectorStorage<T, TInlineCount>
             Free(alloc);
 
             m_data = vec.Release();
-            m_capacity = count;
+            m_capacity = vec.capacity;
         }
 
         m_size = count;
@@ -977,7 +1107,7 @@ struct VectorOperations : public VectorStorage<T, TInlineCount>
             Free(alloc);
 
             m_data = vec.Release();
-            m_capacity = span.Size();
+            m_capacity = vec.capacity;
         }
 
         m_size = span.Size();
@@ -1049,8 +1179,258 @@ struct VectorOperations : public VectorStorage<T, TInlineCount>
         return Error::IntegerOverflow;
     }
 
+    // Makes room for count elements at index, leaving them unconstructed and
+    // m_size unchanged. Elements are moved once, into a larger buffer when
+    // the current one is full and cannot be expanded in place.
+    template <typename TAllocator>
+    Err OpenGap(TAllocator& alloc, SizeType index, SizeType count) noexcept
+    {
+        if RAD_UNLIKELY (count > UINT32_MAX - m_size)
+        {
+            return Error::IntegerOverflow;
+        }
+
+        ValueType* data = Data();
+        if (m_size + count > m_capacity)
+        {
+            const SizeType capacity = GrowthFor(m_size + count);
+            if (IsInline() || m_data == nullptr ||
+                !AllocTraits<TAllocator>::TryExpand(alloc,
+                                                    m_data,
+                                                    m_capacity,
+                                                    capacity))
+            {
+                VectorAlloc<ValueType, TAllocator> vec(alloc);
+                if (!vec.Alloc(capacity))
+                {
+                    return Error::NoMemory;
+                }
+
+                ManipType().MoveCtorDtorSrcRange(vec.buffer, data, index);
+                ManipType().MoveCtorDtorSrcRange(vec.buffer + index + count,
+                                                 data + index,
+                                                 m_size - index);
+
+                Free(alloc);
+
+                m_data = vec.Release();
+                m_capacity = vec.capacity;
+
+                return NoError;
+            }
+
+            m_capacity = capacity;
+        }
+
+        ManipType().MoveCtorDtorSrcRangeBackward(data + index + count,
+                                                 data + index,
+                                                 m_size - index);
+
+        return NoError;
+    }
+
+    template <typename TAllocator, typename... TArgs>
+    Err Emplace(TAllocator& alloc,
+                SizeType index,
+                TArgs&&... args) noexcept(IsNoThrowCtor<T, TArgs...>)
+    {
+        if (index == m_size)
+        {
+            return EmplaceBack(alloc, Forward<TArgs>(args)...);
+        }
+
+        if RAD_UNLIKELY (index > m_size)
+        {
+            return Error::OutOfRange;
+        }
+
+        // The arguments may refer to elements which are about to move, and
+        // constructing first leaves the container untouched if it throws.
+        ValueType value(Forward<TArgs>(args)...);
+        Err res = OpenGap(alloc, index, 1);
+        if (!res.IsOk())
+        {
+            return res;
+        }
+
+        new (AddrOf(Data()[index])) ValueType(::rad::Move(value));
+        m_size++;
+
+        return NoError;
+    }
+
+    template <typename TAllocator,
+              typename U = T,
+              EnIf<!IsNoThrowCopyCtor<U>, int> = 0>
+    Err InsertRange(TAllocator& alloc,
+                    SizeType index,
+                    Span<const ValueType> span)
+    {
+        if (SpansOverlap(span, Span<const ValueType>(Data(), m_size)))
+        {
+            return Error::InvalidAddress;
+        }
+
+        if RAD_UNLIKELY (index > m_size)
+        {
+            return Error::OutOfRange;
+        }
+
+        if (span.Empty())
+        {
+            return NoError;
+        }
+
+        // copies are made before any element moves, so a throwing copy leaves
+        // the container untouched
+        VectorAlloc<ValueType, TAllocator> vec(alloc);
+        if (!vec.Alloc(span.Size()))
+        {
+            return Error::NoMemory;
+        }
+
+        ManipType().CopyCtorRange(vec, span.Data(), span.Size());
+        Err res = OpenGap(alloc, index, span.Size());
+        if (!res.IsOk())
+        {
+            return res;
+        }
+
+        ManipType().MoveCtorDtorSrcRange(Data() + index,
+                                         vec.buffer,
+                                         vec.size);
+        vec.size = 0;
+        m_size += span.Size();
+
+        return NoError;
+    }
+
+    template <typename TAllocator,
+              typename U = T,
+              EnIf<IsNoThrowCopyCtor<U>, int> = 0>
+    Err InsertRange(TAllocator& alloc,
+                    SizeType index,
+                    Span<const ValueType> span) noexcept
+    {
+        if (SpansOverlap(span, Span<const ValueType>(Data(), m_size)))
+        {
+            return Error::InvalidAddress;
+        }
+
+        if RAD_UNLIKELY (index > m_size)
+        {
+            return Error::OutOfRange;
+        }
+
+        if (span.Empty())
+        {
+            return NoError;
+        }
+
+        Err res = OpenGap(alloc, index, span.Size());
+        if (!res.IsOk())
+        {
+            return res;
+        }
+
+        ManipType().CopyCtorRange(Data() + index, span.Data(), span.Size());
+        m_size += span.Size();
+
+        return NoError;
+    }
+
+    void Erase(SizeType index, SizeType count) noexcept
+    {
+        if (!RAD_VERIFY(index <= m_size))
+        {
+            return;
+        }
+
+        count = Min(count, m_size - index);
+        if (count == 0)
+        {
+            return;
+        }
+
+        ValueType* first = Data() + index;
+        ManipType().DtorRange(first, first + count);
+        ManipType().MoveCtorDtorSrcRange(first,
+                                         first + count,
+                                         m_size - index - count);
+        m_size -= count;
+    }
+
+    template <typename Predicate>
+    SizeType EraseIf(Predicate& pred) noexcept(
+        noexcept(pred(DeclVal<const ValueType&>())))
+    {
+        // Kept elements are compacted as they are found, and the rest are
+        // shifted down even when the predicate throws part way through.
+        struct Compactor
+        {
+            ~Compactor()
+            {
+                if (read != size)
+                {
+                    ManipType().MoveCtorDtorSrcRange(data + kept,
+                                                     data + read,
+                                                     size - read);
+                }
+
+                *sizePtr = kept + size - read;
+            }
+
+            ValueType* data;
+            SizeType* sizePtr;
+            SizeType size;
+            SizeType read;
+            SizeType kept;
+        };
+
+        Compactor compactor{ Data(), &m_size, m_size, 0, 0 };
+        ValueType* data = compactor.data;
+        for (; compactor.read < compactor.size; compactor.read++)
+        {
+            ValueType* item = data + compactor.read;
+            if (pred(static_cast<const ValueType&>(*item)))
+            {
+                ManipType().Dtor(item);
+            }
+            else
+            {
+                if (compactor.kept != compactor.read)
+                {
+                    ManipType().MoveCtorDtorSrcRange(data + compactor.kept,
+                                                     item,
+                                                     1);
+                }
+
+                compactor.kept++;
+            }
+        }
+
+        return compactor.size - compactor.kept;
+    }
+
+    void SwapErase(SizeType index) noexcept
+    {
+        if (!RAD_VERIFY(index < m_size))
+        {
+            return;
+        }
+
+        ValueType* item = Data() + index;
+        ManipType().Dtor(item);
+        m_size--;
+        if (index != m_size)
+        {
+            ManipType().MoveCtorDtorSrcRange(item, Data() + m_size, 1);
+        }
+    }
+
     using BaseType::Data;
     using BaseType::Free;
+    using BaseType::IsInline;
     using BaseType::Swap;
     using BaseType::ShrinkToFit;
 
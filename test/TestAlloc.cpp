@@ -21,6 +21,7 @@ namespace radtest
 
 const uint32_t StatefulAllocator::k_BadState;
 const uint32_t StatefulCountingAllocator::k_BadState;
+const size_t RoundingAllocator::Granularity;
 
 uint32_t CountingAllocator::g_FreeCount = 0;
 uint32_t CountingAllocator::g_AllocCount = 0;
@@ -30,5 +31,7 @@ uint32_t StatefulCountingAllocator::g_FreeCount = 0;
 uint32_t StatefulCountingAllocator::g_AllocCount = 0;
 size_t StatefulCountingAllocator::g_FreeBytesCount = 0;
 size_t StatefulCountingAllocator::g_AllocBytesCount = 0;
+uint32_t ReallocatingAllocator::g_ReallocCount = 0;
+uint32_t RoundingAllocator::g_AllocCount = 0;
 
 } // namespace radtest
@@ -17,6 +17,7 @@
 #include "gtest/gtest.h"
 
 #include "radiant/TotallyRad.h"
+#include "radiant/Memory.h"
 
 #include <stddef.h>
 #include <stdint.h>
@@ -537,6 +538,73 @@ public:
     Res* m_res;
 };
 
+class ReallocatingAllocator
+{
+public:
+
+    static constexpr bool HasReallocBytes = true;
+
+    static uint32_t g_ReallocCount;
+
+    void FreeBytes(void* ptr, size_t byte_count) noexcept
+    {
+        RAD_UNUSED(byte_count);
+        free(ptr);
+    }
+
+    void* AllocBytes(size_t byte_count) noexcept
+    {
+        return malloc(byte_count);
+    }
+
+    void* ReallocBytes(void* ptr,
+                       size_t byte_count,
+                       size_t new_byte_count) noexcept
+    {
+        RAD_UNUSED(byte_count);
+        ++g_ReallocCount;
+        return realloc(ptr, new_byte_count);
+    }
+
+    static void HandleSizeOverflow()
+    {
+    }
+};
+
+// Rounds allocations up to a granularity and reports the rounded size, as a
+// page or size class allocator would.
+class RoundingAllocator
+{
+public:
+
+    static constexpr bool HasAllocBytesAtLeast = true;
+    static constexpr size_t Granularity = 256;
+
+    static uint32_t g_AllocCount;
+
+    void FreeBytes(void* ptr, size_t byte_count) noexcept
+    {
+        RAD_UNUSED(byte_count);
+        free(ptr);
+    }
+
+    void* AllocBytes(size_t byte_count) noexcept
+    {
+        return AllocBytesAtLeast(byte_count).ptr;
+    }
+
+    rad::AllocBytesResult AllocBytesAtLeast(size_t byte_count) noexcept
+    {
+        ++g_AllocCount;
+        const size_t size = (byte_count + Granularity - 1) & ~(Granularity - 1);
+        return { malloc(size), size };
+    }
+
+    static void HandleSizeOverflow()
+    {
+    }
+};
+
 class TypedAllocator
 {
 public:
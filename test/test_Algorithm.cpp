@@ -0,0 +1,519 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "gtest/gtest.h"
+
+#include "radiant/Algorithm.h"
+
+#include "test/TestAlloc.h"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace
+{
+// Not trivially copyable, so sorting it takes the branching partition.
+struct Boxed
+{
+    Boxed() = default;
+
+    explicit Boxed(int v) noexcept
+        : value(v)
+    {
+    }
+
+    Boxed(const Boxed& other) noexcept
+        : value(other.value)
+    {
+    }
+
+    Boxed& operator=(const Boxed& other) noexcept
+    {
+        value = other.value;
+        return *this;
+    }
+
+    bool operator<(const Boxed& other) const noexcept
+    {
+        return value < other.value;
+    }
+
+    bool operator==(const Boxed& other) const noexcept
+    {
+        return value == other.value;
+    }
+
+    int value = 0;
+};
+
+struct Record
+{
+    int key;
+    int seq;
+};
+
+bool KeyLess(const Record& a, const Record& b) noexcept
+{
+    return a.key < b.key;
+}
+
+enum class Pattern
+{
+    Random,
+    Sorted,
+    Reversed,
+    Equal,
+    FewUnique,
+    OrganPipe,
+    Sawtooth,
+};
+
+const Pattern AllPatterns[] = { Pattern::Random,    Pattern::Sorted,
+                                Pattern::Reversed,  Pattern::Equal,
+                                Pattern::FewUnique, Pattern::OrganPipe,
+                                Pattern::Sawtooth };
+
+std::vector<int> Generate(Pattern pattern, int size, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<int> values(static_cast<size_t>(size));
+    for (int i = 0; i < size; ++i)
+    {
+        int value = 0;
+        switch (pattern)
+        {
+            case Pattern::Random:
+                value = static_cast<int>(rng() % 100000);
+                break;
+            case Pattern::Sorted:
+                value = i;
+                break;
+            case Pattern::Reversed:
+                value = size - i;
+                break;
+            case Pattern::Equal:
+                value = 7;
+                break;
+            case Pattern::FewUnique:
+                value = static_cast<int>(rng() % 4);
+                break;
+            case Pattern::OrganPipe:
+                value = i < size / 2 ? i : size - i;
+                break;
+            case Pattern::Sawtooth:
+                value = i % 50;
+                break;
+        }
+
+        values[static_cast<size_t>(i)] = value;
+    }
+
+    return values;
+}
+
+const int Sizes[] = { 0, 1, 2, 3, 10, 23, 24, 25, 100, 129, 1000, 5000 };
+
+} // namespace
+
+TEST(AlgorithmTest, SortMatchesStd)
+{
+    for (Pattern pattern : AllPatterns)
+    {
+        for (int size : Sizes)
+        {
+            std::vector<int> values = Generate(pattern, size, 1);
+            std::vector<int> expected = values;
+            std::sort(expected.begin(), expected.end());
+
+            rad::Sort(values.data(), values.data() + values.size());
+            EXPECT_EQ(values, expected) << static_cast<int>(pattern) << " "
+                                        << size;
+        }
+    }
+}
+
+TEST(AlgorithmTest, SortNonTrivial)
+{
+    for (Pattern pattern : AllPatterns)
+    {
+        std::vector<int> ints = Generate(pattern, 3000, 2);
+        std::vector<Boxed> values(ints.begin(), ints.end());
+        std::vector<Boxed> expected = values;
+        std::sort(expected.begin(), expected.end());
+
+        rad::Sort(values.data(), values.data() + values.size());
+        EXPECT_EQ(values, expected) << static_cast<int>(pattern);
+    }
+}
+
+TEST(AlgorithmTest, SortSpanAndComparator)
+{
+    std::vector<int> values = Generate(Pattern::Random, 500, 3);
+    std::vector<int> expected = values;
+    std::sort(expected.begin(), expected.end(), std::greater<int>());
+
+    rad::Span<int> span(values.data(),
+                        static_cast<rad::SpanSizeType>(values.size()));
+    rad::Sort(span, std::greater<int>());
+    EXPECT_EQ(values, expected);
+
+    // rad::Iterator over a span
+    rad::Sort(span.begin(), span.end());
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+
+    int fixed[] = { 3, 1, 2 };
+    rad::Sort(rad::Span<int, 3>(fixed));
+    EXPECT_EQ(fixed[0], 1);
+    EXPECT_EQ(fixed[2], 3);
+
+    EXPECT_TRUE(rad::Less<>()(1, 2L));
+    EXPECT_FALSE(rad::Less<int>()(2, 2));
+}
+
+TEST(AlgorithmTest, StableSort)
+{
+    radtest::Mallocator alloc;
+    for (Pattern pattern : AllPatterns)
+    {
+        for (int size : Sizes)
+        {
+            std::vector<int> keys = Generate(pattern, size, 4);
+            std::vector<Record> values;
+            for (int i = 0; i < size; ++i)
+            {
+                values.push_back({ keys[static_cast<size_t>(i)] % 100, i });
+            }
+
+            std::vector<Record> expected = values;
+            std::stable_sort(expected.begin(), expected.end(), KeyLess);
+
+            rad::StableSort(alloc,
+                            values.data(),
+                            values.data() + values.size(),
+                            KeyLess);
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                ASSERT_EQ(values[i].key, expected[i].key) << i;
+                ASSERT_EQ(values[i].seq, expected[i].seq) << i;
+            }
+        }
+    }
+}
+
+TEST(AlgorithmTest, StableSortAllocations)
+{
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+
+    std::vector<int> values = Generate(Pattern::Random, 1000, 5);
+    std::vector<int> expected = values;
+    std::sort(expected.begin(), expected.end());
+    rad::StableSort(alloc, values.data(), values.data() + values.size());
+    EXPECT_EQ(values, expected);
+    alloc.VerifyCounts(1, 1);
+
+    // short ranges are insertion sorted without a buffer
+    rad::StableSort(alloc, values.data(), values.data() + 10);
+    alloc.VerifyCounts(1, 1);
+}
+
+TEST(AlgorithmTest, StableSortTypedAllocator)
+{
+    radtest::TypedAllocator alloc;
+    std::vector<int> values = Generate(Pattern::Random, 1000, 7);
+    std::vector<int> expected = values;
+    std::sort(expected.begin(), expected.end());
+    rad::StableSort(alloc, values.data(), values.data() + values.size());
+    EXPECT_EQ(values, expected);
+}
+
+TEST(AlgorithmTest, StableSortWithoutMemory)
+{
+    radtest::FailingAllocator alloc;
+    std::vector<int> keys = Generate(Pattern::Random, 3000, 6);
+    std::vector<Record> values;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        values.push_back({ keys[i] % 50, static_cast<int>(i) });
+    }
+
+    std::vector<Record> expected = values;
+    std::stable_sort(expected.begin(), expected.end(), KeyLess);
+
+    rad::Span<Record> span(values.data(),
+                           static_cast<rad::SpanSizeType>(values.size()));
+    rad::StableSort(alloc, span, KeyLess);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        ASSERT_EQ(values[i].key, expected[i].key) << i;
+        ASSERT_EQ(values[i].seq, expected[i].seq) << i;
+    }
+}
+
+TEST(AlgorithmTest, PartialSort)
+{
+    for (Pattern pattern : AllPatterns)
+    {
+        std::vector<int> values = Generate(pattern, 1000, 7);
+        std::vector<int> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+
+        for (size_t count : { size_t(0), size_t(1), size_t(10), size_t(1000) })
+        {
+            std::vector<int> copy = values;
+            rad::PartialSort(copy.data(),
+                             copy.data() + count,
+                             copy.data() + copy.size());
+            EXPECT_TRUE(std::equal(copy.begin(),
+                                   copy.begin() + static_cast<ptrdiff_t>(count),
+                                   sorted.begin()))
+                << static_cast<int>(pattern) << " " << count;
+
+            std::sort(copy.begin(), copy.end());
+            EXPECT_EQ(copy, sorted);
+        }
+    }
+
+    int values[] = { 5, 4, 3, 2, 1 };
+    rad::PartialSort(rad::Span<int>(values), 2, std::greater<int>());
+    EXPECT_EQ(values[0], 5);
+    EXPECT_EQ(values[1], 4);
+}
+
+TEST(AlgorithmTest, NthElement)
+{
+    for (Pattern pattern : AllPatterns)
+    {
+        std::vector<int> values = Generate(pattern, 2000, 8);
+        std::vector<int> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+
+        for (size_t nth : { size_t(0), size_t(1), size_t(500), size_t(1999) })
+        {
+            std::vector<int> copy = values;
+            rad::NthElement(copy.data(),
+                            copy.data() + nth,
+                            copy.data() + copy.size());
+            ASSERT_EQ(copy[nth], sorted[nth])
+                << static_cast<int>(pattern) << " " << nth;
+            for (size_t i = 0; i < copy.size(); ++i)
+            {
+                if (i < nth)
+                {
+                    ASSERT_LE(copy[i], copy[nth]);
+                }
+                else
+                {
+                    ASSERT_GE(copy[i], copy[nth]);
+                }
+            }
+        }
+    }
+
+    std::vector<Boxed> boxed;
+    for (int i = 0; i < 100; ++i)
+    {
+        boxed.emplace_back((i * 37) % 100);
+    }
+
+    rad::Span<Boxed> span(boxed.data(),
+                          static_cast<rad::SpanSizeType>(boxed.size()));
+    rad::NthElement(span, 42);
+    EXPECT_EQ(boxed[42].value, 42);
+}
+
+namespace
+{
+// Checks every search at each size, offset and position of the element
+// being looked for, across the vector and scalar tails.
+template <typename T>
+void CheckSearches()
+{
+    std::vector<T> buffer(80 + 4);
+    std::vector<T> other(80 + 4);
+    for (size_t offset = 0; offset < 4; ++offset)
+    {
+        for (size_t size = 0; size <= 70; ++size)
+        {
+            T* data = buffer.data() + offset;
+            T* copy = other.data() + (3 - offset);
+            for (size_t i = 0; i < size; ++i)
+            {
+                data[i] = static_cast<T>(i % 5 + 1);
+                copy[i] = data[i];
+            }
+
+            EXPECT_EQ(rad::Find(data, data + size, T(0)), data + size);
+            EXPECT_EQ(rad::Count(data, data + size, T(3)),
+                      static_cast<size_t>(std::count(data, data + size, 3)));
+            EXPECT_TRUE(rad::Equal(data, data + size, copy, copy + size));
+            EXPECT_FALSE(rad::LexCompare(data, data + size, copy, copy + size));
+            if (size > 0)
+            {
+                EXPECT_FALSE(
+                    rad::Equal(data, data + size, copy, copy + size - 1));
+                EXPECT_TRUE(
+                    rad::LexCompare(copy, copy + size - 1, data, data + size));
+            }
+
+            for (size_t pos = 0; pos < size; ++pos)
+            {
+                // the high bit also catches mixed up signed comparisons
+                const T saved = data[pos];
+                data[pos] = static_cast<T>(uint64_t(1) << (sizeof(T) * 8 - 1));
+                ASSERT_EQ(rad::Find(data, data + size, data[pos]), data + pos)
+                    << size << " " << pos;
+                EXPECT_EQ(rad::Count(data, data + size, data[pos]), 1u);
+
+                auto mismatch = rad::Mismatch(data,
+                                              data + size,
+                                              copy,
+                                              copy + size);
+                ASSERT_EQ(mismatch.first, data + pos) << size << " " << pos;
+                EXPECT_EQ(mismatch.second, copy + pos);
+                EXPECT_FALSE(rad::Equal(data, data + size, copy, copy + size));
+                EXPECT_EQ(
+                    rad::LexCompare(data, data + size, copy, copy + size),
+                    std::lexicographical_compare(data,
+                                                 data + size,
+                                                 copy,
+                                                 copy + size));
+                EXPECT_EQ(
+                    rad::LexCompare(copy, copy + size, data, data + size),
+                    std::lexicographical_compare(copy,
+                                                 copy + size,
+                                                 data,
+                                                 data + size));
+                data[pos] = saved;
+            }
+        }
+    }
+}
+
+enum class Color : uint16_t
+{
+    Red,
+    Green,
+    Blue
+};
+
+} // namespace
+
+TEST(AlgorithmTest, SearchWidths)
+{
+    CheckSearches<int8_t>();
+    CheckSearches<uint8_t>();
+    CheckSearches<int16_t>();
+    CheckSearches<uint16_t>();
+    CheckSearches<int32_t>();
+    CheckSearches<uint32_t>();
+    CheckSearches<int64_t>();
+    CheckSearches<uint64_t>();
+}
+
+TEST(AlgorithmTest, SearchSpans)
+{
+    int values[] = { 4, 8, 15, 16, 23, 42 };
+    rad::Span<int> span(values);
+    rad::Span<const int> view(values);
+
+    EXPECT_EQ(rad::Find(span, 16), span.begin() + 3);
+    EXPECT_EQ(rad::Find(view, 7), view.end());
+    EXPECT_EQ(rad::Count(span, 42), 1u);
+    EXPECT_TRUE(rad::Equal(span, view));
+    EXPECT_FALSE(rad::Equal(span, view.Subspan(1)));
+    EXPECT_EQ(rad::Mismatch(span, view), span.Size());
+    EXPECT_EQ(rad::Mismatch(span.Subspan(0, 3), view), 3u);
+    EXPECT_FALSE(rad::LexCompare(span, view));
+    EXPECT_TRUE(rad::LexCompare(view.Subspan(0, 2), span));
+
+    int changed[] = { 4, 8, 15, 17, 23 };
+    EXPECT_EQ(rad::Mismatch(span, rad::Span<int>(changed)), 3u);
+    EXPECT_TRUE(rad::LexCompare(span, rad::Span<int>(changed)));
+
+    // a value of another type is compared one element at a time
+    EXPECT_EQ(rad::Find(span, 23.0), span.begin() + 4);
+    EXPECT_EQ(rad::Count(span, 8L), 1u);
+
+    rad::Span<int> empty;
+    EXPECT_TRUE(rad::Equal(empty, view.Subspan(0, 0)));
+    EXPECT_FALSE(rad::LexCompare(empty, empty));
+    EXPECT_TRUE(rad::LexCompare(empty, view));
+    EXPECT_EQ(rad::Find(empty, 4), empty.end());
+
+    // the null data of an empty byte range is never handed to memchr
+    rad::Span<const char> noBytes;
+    EXPECT_EQ(rad::Find(noBytes, 'a'), noBytes.end());
+}
+
+TEST(AlgorithmTest, SearchBytesAndEnums)
+{
+    // memcmp ordering is only used where it agrees with operator<
+    const signed char negative[] = { 1, -1 };
+    const signed char positive[] = { 1, 1 };
+    EXPECT_TRUE(
+        rad::LexCompare(negative, negative + 2, positive, positive + 2));
+
+    const rad::Byte low[] = { rad::Byte(1), rad::Byte(0x7f) };
+    const rad::Byte high[] = { rad::Byte(1), rad::Byte(0x80) };
+    EXPECT_TRUE(rad::LexCompare(low, low + 2, high, high + 2));
+    EXPECT_FALSE(rad::LexCompare(high, high + 2, low, low + 2));
+    EXPECT_EQ(rad::Find(high, high + 2, rad::Byte(0x80)), high + 1);
+
+    std::vector<Color> colors(40, Color::Green);
+    colors[33] = Color::Blue;
+    EXPECT_EQ(rad::Find(colors.data(),
+                        colors.data() + colors.size(),
+                        Color::Blue),
+              colors.data() + 33);
+    EXPECT_EQ(rad::Count(colors.data(),
+                         colors.data() + colors.size(),
+                         Color::Green),
+              39u);
+
+    int a = 0;
+    int b = 0;
+    int* pointers[] = { &a, &a, &b, &a };
+    EXPECT_EQ(rad::Find(pointers, pointers + 4, &b), pointers + 2);
+    EXPECT_EQ(rad::Count(pointers, pointers + 4, &a), 3u);
+}
+
+TEST(AlgorithmTest, SearchGeneric)
+{
+    std::vector<Boxed> left;
+    for (int i = 0; i < 20; ++i)
+    {
+        left.emplace_back(i);
+    }
+
+    std::vector<Boxed> right = left;
+    const Boxed* first = left.data();
+    const Boxed* last = left.data() + left.size();
+    EXPECT_EQ(rad::Find(first, last, Boxed(7)), first + 7);
+    EXPECT_EQ(rad::Count(first, last, Boxed(30)), 0u);
+    EXPECT_TRUE(rad::Equal(first, last, right.data(), right.data() + 20));
+
+    right[12].value = -1;
+    auto mismatch = rad::Mismatch(first, last, right.data(), right.data() + 20);
+    EXPECT_EQ(mismatch.first, first + 12);
+    EXPECT_TRUE(rad::LexCompare(right.data(), right.data() + 20, first, last));
+
+    // floating point takes the generic path, so -0.0 equals 0.0
+    const double zeros[] = { 0.0, -0.0 };
+    EXPECT_EQ(rad::Count(zeros, zeros + 2, 0.0), 2u);
+    EXPECT_TRUE(rad::Equal(zeros, zeros + 1, zeros + 1, zeros + 2));
+}
@@ -134,6 +134,52 @@ TEST(AllocatorTests, MinimalAlloc)
     }
 }
 
+TEST(AllocatorTests, AllocAtLeast)
+{
+    {
+        radtest::Mallocator mal;
+        using allt = rad::AllocTraits<radtest::Mallocator>;
+        RAD_S_ASSERT(!allt::HasAllocBytesAtLeast);
+
+        rad::AllocResult<uint64_t> res = allt::AllocAtLeast<uint64_t>(mal, 3);
+        EXPECT_NE(res.ptr, nullptr);
+        EXPECT_EQ(res.count, 3u);
+        allt::Free(mal, res.ptr, res.count);
+
+        res = allt::AllocAtLeast<uint64_t>(mal, ~size_t(0) / 2);
+        EXPECT_EQ(res.ptr, nullptr);
+        EXPECT_EQ(res.count, 0u);
+    }
+
+    {
+        radtest::RoundingAllocator ral;
+        using allt = rad::AllocTraits<radtest::RoundingAllocator>;
+        RAD_S_ASSERT(allt::HasAllocBytesAtLeast);
+
+        // the rounded up bytes are reported as whole elements
+        rad::AllocResult<uint64_t> res = allt::AllocAtLeast<uint64_t>(ral, 3);
+        EXPECT_NE(res.ptr, nullptr);
+        EXPECT_EQ(res.count, radtest::RoundingAllocator::Granularity / 8);
+        allt::Free(ral, res.ptr, res.count);
+
+        struct Odd
+        {
+            char bytes[100];
+        };
+
+        // 300 bytes round up to 512, which holds five whole elements, and the
+        // memory may be freed with any count from the request up
+        rad::AllocResult<Odd> odd = allt::AllocAtLeast<Odd>(ral, 3);
+        EXPECT_NE(odd.ptr, nullptr);
+        EXPECT_EQ(odd.count, 5u);
+        allt::Free(ral, odd.ptr, 3);
+
+        res = allt::AllocAtLeast<uint64_t>(ral, ~size_t(0) / 2);
+        EXPECT_EQ(res.ptr, nullptr);
+        EXPECT_EQ(res.count, 0u);
+    }
+}
+
 TEST(AllocatorTests, PropagatingAllocator)
 {
     constexpr uint32_t kMainTag = 42;
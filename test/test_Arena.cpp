@@ -0,0 +1,323 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/Arena.h"
+#include "radiant/List.h"
+#include "radiant/Vector.h"
+
+#include "test/TestAlloc.h"
+
+#include <stdint.h>
+#include <string.h>
+
+namespace
+{
+using TestArena = rad::Arena<radtest::CountingAllocator, 256>;
+using TestArenaAllocator =
+    rad::ArenaAllocator<radtest::CountingAllocator, 256>;
+
+bool IsAligned(void* ptr)
+{
+    return (reinterpret_cast<uintptr_t>(ptr) & (TestArena::Alignment - 1)) ==
+           0;
+}
+} // namespace
+
+RAD_S_ASSERT(!TestArenaAllocator::IsAlwaysEqual);
+RAD_S_ASSERT(TestArenaAllocator::PropagateOnCopy);
+RAD_S_ASSERT(TestArenaAllocator::PropagateOnMoveAssignment);
+RAD_S_ASSERT(TestArenaAllocator::PropagateOnSwap);
+RAD_S_ASSERT(noexcept(rad::DeclVal<TestArenaAllocator&>().FreeBytes(nullptr,
+                                                                    0)));
+
+TEST(ArenaTest, BumpAllocations)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        TestArena arena;
+
+        void* first = arena.AllocBytes(1);
+        void* second = arena.AllocBytes(3);
+        void* third = arena.AllocBytes(0);
+        ASSERT_NE(first, nullptr);
+        ASSERT_NE(second, nullptr);
+        ASSERT_NE(third, nullptr);
+        EXPECT_NE(first, second);
+        EXPECT_NE(second, third);
+        EXPECT_TRUE(IsAligned(first));
+        EXPECT_TRUE(IsAligned(second));
+        EXPECT_TRUE(IsAligned(third));
+        EXPECT_EQ(static_cast<char*>(second) - static_cast<char*>(first),
+                  static_cast<ptrdiff_t>(TestArena::Alignment));
+
+        // all served from the same block
+        counter.VerifyCounts(1, 0);
+
+        arena.FreeBytes(first, 1);
+        counter.VerifyCounts(1, 0);
+    }
+    counter.VerifyCounts(1, 1);
+    counter.VerifyCounts();
+}
+
+TEST(ArenaTest, ChainsBlocks)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        TestArena arena;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            void* ptr = arena.AllocBytes(TestArena::MaxBlockAllocSize);
+            ASSERT_NE(ptr, nullptr);
+            EXPECT_TRUE(IsAligned(ptr));
+            memset(ptr, i, TestArena::MaxBlockAllocSize);
+        }
+        counter.VerifyCounts(4, 0);
+    }
+    counter.VerifyCounts(4, 4);
+    counter.VerifyCounts();
+}
+
+TEST(ArenaTest, ResetReusesBlocks)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        TestArena arena;
+
+        void* first = arena.AllocBytes(TestArena::MaxBlockAllocSize);
+        void* second = arena.AllocBytes(TestArena::MaxBlockAllocSize);
+        ASSERT_NE(first, nullptr);
+        ASSERT_NE(second, nullptr);
+        counter.VerifyCounts(2, 0);
+
+        arena.Reset();
+        counter.VerifyCounts(2, 0);
+
+        EXPECT_EQ(arena.AllocBytes(TestArena::MaxBlockAllocSize), first);
+        EXPECT_EQ(arena.AllocBytes(TestArena::MaxBlockAllocSize), second);
+        counter.VerifyCounts(2, 0);
+
+        EXPECT_NE(arena.AllocBytes(1), nullptr);
+        counter.VerifyCounts(3, 0);
+    }
+    counter.VerifyCounts(3, 3);
+    counter.VerifyCounts();
+}
+
+TEST(ArenaTest, LargeAllocations)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        TestArena arena;
+
+        void* small = arena.AllocBytes(8);
+        ASSERT_NE(small, nullptr);
+
+        void* large = arena.AllocBytes(TestArena::BlockSize * 3);
+        ASSERT_NE(large, nullptr);
+        EXPECT_TRUE(IsAligned(large));
+        memset(large, 0xcc, TestArena::BlockSize * 3);
+        counter.VerifyCounts(2, 0);
+
+        // the regular block is still current
+        void* next = arena.AllocBytes(8);
+        EXPECT_EQ(static_cast<char*>(next) - static_cast<char*>(small),
+                  static_cast<ptrdiff_t>(TestArena::Alignment));
+        counter.VerifyCounts(2, 0);
+
+        arena.Reset();
+        counter.VerifyCounts(2, 1);
+        EXPECT_EQ(arena.AllocBytes(8), small);
+    }
+    counter.VerifyCounts(2, 2);
+    counter.VerifyCounts();
+}
+
+TEST(ArenaTest, TryExpandBytes)
+{
+    TestArena arena;
+
+    void* first = arena.AllocBytes(8);
+    ASSERT_NE(first, nullptr);
+    EXPECT_TRUE(arena.TryExpandBytes(first, 8, 64));
+    EXPECT_TRUE(arena.TryExpandBytes(first, 64, 64));
+    EXPECT_FALSE(arena.TryExpandBytes(first, 64, TestArena::BlockSize));
+
+    void* second = arena.AllocBytes(8);
+    EXPECT_EQ(static_cast<char*>(second) - static_cast<char*>(first), 64);
+
+    // only the most recent allocation can grow
+    EXPECT_FALSE(arena.TryExpandBytes(first, 64, 128));
+    EXPECT_TRUE(arena.TryExpandBytes(second, 8, 32));
+    EXPECT_FALSE(arena.TryExpandBytes(nullptr, 0, 32));
+    EXPECT_FALSE(arena.TryExpandBytes(second, 32, ~size_t(0)));
+
+    TestArenaAllocator alloc(arena);
+    RAD_S_ASSERT(rad::AllocTraits<TestArenaAllocator>::HasTryExpandBytes);
+    EXPECT_TRUE(rad::AllocTraits<TestArenaAllocator>::TryExpand(
+        alloc,
+        static_cast<char*>(second),
+        32,
+        48));
+}
+
+TEST(ArenaTest, Release)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+
+    TestArena arena;
+    EXPECT_NE(arena.AllocBytes(8), nullptr);
+    EXPECT_NE(arena.AllocBytes(TestArena::BlockSize), nullptr);
+    counter.VerifyCounts(2, 0);
+
+    arena.Release();
+    counter.VerifyCounts(2, 2);
+
+    EXPECT_NE(arena.AllocBytes(8), nullptr);
+    counter.VerifyCounts(3, 2);
+
+    arena.Release();
+    counter.VerifyCounts();
+}
+
+TEST(ArenaTest, Overflow)
+{
+    TestArena arena;
+    EXPECT_EQ(arena.AllocBytes(~size_t(0)), nullptr);
+    EXPECT_EQ(arena.AllocBytes(~size_t(0) - TestArena::Alignment), nullptr);
+}
+
+TEST(ArenaTest, BackingFailure)
+{
+    rad::Arena<radtest::FailingAllocator> arena;
+    EXPECT_EQ(arena.AllocBytes(8), nullptr);
+    EXPECT_EQ(arena.AllocBytes(8192), nullptr);
+    arena.Reset();
+    arena.Release();
+
+    rad::ArenaAllocator<radtest::FailingAllocator> alloc(arena);
+    rad::Vector<int, decltype(alloc)> vec(alloc);
+    EXPECT_EQ(vec.PushBack(1), rad::Error::NoMemory);
+}
+
+TEST(ArenaTest, TypedBackingAllocator)
+{
+    rad::Arena<radtest::TypedAllocator> arena;
+    void* ptr = arena.AllocBytes(100);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_TRUE(IsAligned(ptr));
+    memset(ptr, 0, 100);
+}
+
+TEST(ArenaAllocatorTest, Equality)
+{
+    TestArena arena1;
+    TestArena arena2;
+
+    TestArenaAllocator alloc1(arena1);
+    TestArenaAllocator alloc1b(arena1);
+    TestArenaAllocator alloc2(arena2);
+
+    EXPECT_TRUE(alloc1 == alloc1b);
+    EXPECT_FALSE(alloc1 != alloc1b);
+    EXPECT_FALSE(alloc1 == alloc2);
+    EXPECT_TRUE(alloc1 != alloc2);
+    EXPECT_EQ(&alloc1.GetArena(), &arena1);
+}
+
+TEST(ArenaAllocatorTest, Vector)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        TestArena arena;
+        TestArenaAllocator alloc(arena);
+
+        rad::Vector<int, TestArenaAllocator> vec(alloc);
+        for (int i = 0; i < 100; ++i)
+        {
+            ASSERT_TRUE(vec.PushBack(i).IsOk());
+        }
+        ASSERT_EQ(vec.Size(), 100u);
+        for (int i = 0; i < 100; ++i)
+        {
+            EXPECT_EQ(vec[static_cast<uint32_t>(i)], i);
+        }
+
+        auto copy = vec.Clone();
+        ASSERT_TRUE(copy.IsOk());
+        EXPECT_TRUE(copy.Ok().GetAllocator() == alloc);
+        EXPECT_TRUE(copy.Ok() == vec);
+
+        rad::Vector<int, TestArenaAllocator> other(alloc);
+        other = rad::Move(vec);
+        EXPECT_EQ(other.Size(), 100u);
+        EXPECT_TRUE(vec.Empty());
+
+        // no memory is returned to the backing allocator until the arena is
+        // destroyed
+        EXPECT_EQ(counter.FreeCount(), 0u);
+    }
+    counter.VerifyCounts();
+}
+
+TEST(ArenaAllocatorTest, List)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        TestArena arena;
+        TestArenaAllocator alloc(arena);
+        {
+            rad::List<int, TestArenaAllocator> list(alloc);
+            for (int i = 0; i < 50; ++i)
+            {
+                ASSERT_TRUE(list.PushBack(i).IsOk());
+            }
+            EXPECT_EQ(list.ExpensiveSize(), 50u);
+
+            int expected = 0;
+            for (int val : list)
+            {
+                EXPECT_EQ(val, expected);
+                ++expected;
+            }
+
+            list.PopFront();
+            EXPECT_EQ(list.ExpensiveSize(), 49u);
+        }
+        const uint32_t allocs = counter.AllocCount();
+        EXPECT_EQ(counter.FreeCount(), 0u);
+
+        // rewinding reuses the blocks for the next batch of nodes
+        arena.Reset();
+        {
+            rad::List<int, TestArenaAllocator> list(alloc);
+            for (int i = 0; i < 50; ++i)
+            {
+                ASSERT_TRUE(list.PushBack(i).IsOk());
+            }
+        }
+        EXPECT_EQ(counter.AllocCount(), allocs);
+    }
+    counter.VerifyCounts();
+}
@@ -19,6 +19,8 @@
 #include "radiant/Atomic.h"
 #include "radiant/Utility.h"
 
+#include <thread>
+
 #if defined(RAD_GCC_VERSION) || defined(RAD_CLANG_VERSION)
 RAD_S_ASSERT((static_cast<int>(rad::MemoryOrder::Relaxed) == __ATOMIC_RELAXED));
 RAD_S_ASSERT((static_cast<int>(rad::MemoryOrder::Consume) == __ATOMIC_CONSUME));
@@ -3288,3 +3290,202 @@ TEST(AtomicTests, IntrinSelect64FetchXorSeqCst)
     EXPECT_EQ(value, 0x505050505050505ull);
     EXPECT_EQ(result, 0x606060606060606ull);
 }
+
+RAD_S_ASSERT(alignof(rad::PaddedAtomic<uint32_t>) == RAD_CACHE_LINE_SIZE);
+RAD_S_ASSERT(sizeof(rad::PaddedAtomic<uint32_t>) == RAD_CACHE_LINE_SIZE);
+RAD_S_ASSERT(sizeof(rad::PaddedAtomic<int*>) == RAD_CACHE_LINE_SIZE);
+RAD_S_ASSERT((RAD_CACHE_LINE_SIZE & (RAD_CACHE_LINE_SIZE - 1)) == 0);
+
+TEST(AtomicTests, PaddedAtomic)
+{
+    rad::PaddedAtomic<uint32_t> counters[2];
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&counters[0]) % RAD_CACHE_LINE_SIZE,
+              0u);
+    EXPECT_EQ(reinterpret_cast<char*>(&counters[1]) -
+                  reinterpret_cast<char*>(&counters[0]),
+              RAD_CACHE_LINE_SIZE);
+
+    EXPECT_EQ(counters[0].Load(), 0u);
+    counters[0].FetchAdd(2);
+    ++counters[0];
+    counters[1] = 7;
+    EXPECT_EQ(counters[0].Load(), 3u);
+    EXPECT_EQ(counters[1].Load(), 7u);
+
+    int value = 0;
+    rad::PaddedAtomic<int*> ptr(&value);
+    EXPECT_EQ(ptr.Exchange(nullptr), &value);
+    EXPECT_EQ(ptr.Load(), nullptr);
+}
+
+#if RAD_HAS_DWCAS
+namespace
+{
+struct TaggedPtr
+{
+    int* ptr;
+    uint64_t tag;
+};
+
+bool operator==(const TaggedPtr& a, const TaggedPtr& b)
+{
+    return a.ptr == b.ptr && a.tag == b.tag;
+}
+} // namespace
+
+RAD_S_ASSERT(alignof(rad::Atomic<TaggedPtr>) == 16);
+
+TEST(AtomicTests, IntrinSelect128)
+{
+    alignas(16) TaggedPtr storage{ nullptr, 0 };
+    int value = 0;
+    const TaggedPtr first{ &value, 1 };
+    const TaggedPtr second{ &value, 2 };
+
+    SI<TaggedPtr>::Store(storage, first, SeqCst());
+    EXPECT_EQ(SI<TaggedPtr>::Load(storage, Acquire()), first);
+    EXPECT_EQ(SI<TaggedPtr>::Exchange(storage, second, AcqRel()), first);
+
+    TaggedPtr expected = first;
+    EXPECT_FALSE(SI<TaggedPtr>::CompareExchangeStrong(storage,
+                                                      first,
+                                                      expected,
+                                                      SeqCst(),
+                                                      Relaxed()));
+    EXPECT_EQ(expected, second);
+    EXPECT_TRUE(SI<TaggedPtr>::CompareExchangeWeak(storage,
+                                                   first,
+                                                   expected,
+                                                   Release(),
+                                                   Relaxed()));
+    EXPECT_EQ(storage, first);
+}
+
+TEST(AtomicTests, AtomicDoubleWidth)
+{
+    int values[2] = {};
+    rad::Atomic<TaggedPtr> atomic(TaggedPtr{ &values[0], 0 });
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&atomic) % 16, 0u);
+    EXPECT_EQ(atomic.Load(rad::MemOrderAcquire), (TaggedPtr{ &values[0], 0 }));
+
+    // a stale tag fails even when the pointer matches
+    TaggedPtr expected{ &values[0], 1 };
+    EXPECT_FALSE(atomic.CompareExchangeStrong(expected,
+                                              TaggedPtr{ &values[1], 1 }));
+    EXPECT_EQ(expected.tag, 0u);
+    EXPECT_TRUE(atomic.CompareExchangeStrong(expected,
+                                             TaggedPtr{ &values[1], 1 },
+                                             rad::MemOrderAcqRel,
+                                             rad::MemOrderAcquire));
+
+    atomic.Store(TaggedPtr{ nullptr, 5 }, rad::MemOrderRelease);
+    EXPECT_EQ(atomic.Exchange(TaggedPtr{ &values[1], 6 }),
+              (TaggedPtr{ nullptr, 5 }));
+    atomic = TaggedPtr{ &values[0], 7 };
+    const TaggedPtr loaded = atomic;
+    EXPECT_EQ(loaded, (TaggedPtr{ &values[0], 7 }));
+
+    rad::PaddedAtomic<TaggedPtr> padded;
+    EXPECT_EQ(padded.Load(), (TaggedPtr{ nullptr, 0 }));
+}
+
+TEST(AtomicTests, AtomicDoubleWidthConcurrent)
+{
+    constexpr int ThreadCount = 4;
+    constexpr uint64_t Iterations = 10000;
+    rad::Atomic<atom::DoubleWord> atomic(atom::DoubleWord{ 0, 0 });
+
+    // both words always change together
+    std::thread threads[ThreadCount];
+    for (auto& thread : threads)
+    {
+        thread = std::thread(
+            [&]()
+            {
+                for (uint64_t i = 0; i < Iterations; ++i)
+                {
+                    atom::DoubleWord expected =
+                        atomic.Load(rad::MemOrderRelaxed);
+                    atom::DoubleWord desired;
+                    do
+                    {
+                        EXPECT_EQ(expected.high, expected.low * 3);
+                        desired = { expected.low + 1, expected.high + 3 };
+                    } while (!atomic.CompareExchangeWeak(expected, desired));
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    const atom::DoubleWord final = atomic.Load();
+    EXPECT_EQ(final.low, ThreadCount * Iterations);
+    EXPECT_EQ(final.high, 3 * ThreadCount * Iterations);
+}
+#endif
+
+TEST(AtomicTests, WaitReturnsOnChangedValue)
+{
+    rad::Atomic<uint32_t> word(1);
+    word.Wait(0);
+    word.Wait(5, rad::MemOrderAcquire);
+
+    rad::Atomic<uint8_t> byte(1);
+    byte.Wait(0);
+    byte.NotifyOne();
+    byte.NotifyAll();
+}
+
+template <typename T>
+void WaitNotifyThreads()
+{
+    rad::Atomic<T> value(0);
+    rad::Atomic<int> woken(0);
+
+    std::thread threads[4];
+    for (auto& thread : threads)
+    {
+        thread = std::thread(
+            [&]
+            {
+                value.Wait(0, rad::MemOrderAcquire);
+                ++woken;
+            });
+    }
+
+    for (int i = 0; i < 1000 && woken.Load() == 0; ++i)
+    {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(woken.Load(), 0);
+
+    value.Store(1, rad::MemOrderRelease);
+    value.NotifyAll();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(woken.Load(), 4);
+}
+
+TEST(AtomicTests, WaitNotify)
+{
+    WaitNotifyThreads<uint32_t>();
+    WaitNotifyThreads<int32_t>();
+    WaitNotifyThreads<uint8_t>();
+    WaitNotifyThreads<uint64_t>();
+}
+
+TEST(AtomicTests, NotifyOne)
+{
+    rad::Atomic<uint64_t> value(0);
+    std::thread waiter([&] { value.Wait(0); });
+
+    value.Store(1);
+    value.NotifyOne();
+    waiter.join();
+    EXPECT_EQ(value.Load(), 1u);
+}
@@ -0,0 +1,545 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/BTreeMap.h"
+
+#include "test/TestAlloc.h"
+
+#include <stdint.h>
+
+#include <iterator>
+#include <map>
+
+namespace
+{
+template <typename V, typename TAllocator = radtest::Mallocator>
+using Map = rad::BTreeMap<int, V, TAllocator>;
+using IntMap = Map<int>;
+
+int g_Live = 0;
+
+struct Tracked
+{
+    explicit Tracked(int v) noexcept
+        : value(v)
+    {
+        ++g_Live;
+    }
+
+    Tracked(const Tracked& other) noexcept
+        : value(other.value)
+    {
+        ++g_Live;
+    }
+
+    Tracked(Tracked&& other) noexcept
+        : value(other.value)
+    {
+        ++g_Live;
+    }
+
+    Tracked& operator=(const Tracked& other) noexcept
+    {
+        value = other.value;
+        return *this;
+    }
+
+    ~Tracked()
+    {
+        --g_Live;
+    }
+
+    int value;
+};
+
+// large enough for the smallest nodes
+struct Big
+{
+    int64_t data[40];
+};
+
+// scatters consecutive i over [0, 10007)
+int Shuffled(int i)
+{
+    return static_cast<int>((static_cast<uint32_t>(i) * 7919u) % 10007u);
+}
+
+template <typename TMap>
+void ExpectMatches(const TMap& map, const std::map<int, int>& expected)
+{
+    ASSERT_EQ(map.Size(), expected.size());
+    auto it = expected.begin();
+    for (const auto& entry : map)
+    {
+        ASSERT_NE(it, expected.end());
+        EXPECT_EQ(entry.Key(), it->first);
+        EXPECT_EQ(entry.Value(), it->second);
+        ++it;
+    }
+
+    EXPECT_EQ(it, expected.end());
+}
+} // namespace
+
+RAD_S_ASSERT(IntMap::NodeCapacity >= 16);
+RAD_S_ASSERT(Map<Big>::NodeCapacity == 3);
+
+TEST(TestBTreeMap, DefaultConstruct)
+{
+    IntMap map;
+    EXPECT_TRUE(map.Empty());
+    EXPECT_EQ(map.Size(), 0u);
+    EXPECT_EQ(map.Height(), 0u);
+    EXPECT_EQ(map.begin(), map.end());
+    EXPECT_EQ(map.Find(1), nullptr);
+    EXPECT_FALSE(map.Contains(1));
+    EXPECT_EQ(map.LowerBound(1), map.end());
+    EXPECT_FALSE(map.Erase(1));
+    EXPECT_EQ(map.Seek(1), rad::Error::OutOfRange);
+}
+
+TEST(TestBTreeMap, InsertFindErase)
+{
+    IntMap map;
+    auto res = map.Insert(1, 10);
+    ASSERT_TRUE(res.IsOk());
+    EXPECT_TRUE(res.Ok().inserted);
+    EXPECT_EQ(res.Ok().entry->Key(), 1);
+    EXPECT_EQ(res.Ok().entry->Value(), 10);
+
+    // existing keys are not overwritten
+    res = map.Insert(1, 20);
+    ASSERT_TRUE(res.IsOk());
+    EXPECT_FALSE(res.Ok().inserted);
+    EXPECT_EQ(res.Ok().entry->Value(), 10);
+
+    EXPECT_EQ(map.InsertOrAssign(1, 30).Ok(), 30);
+    EXPECT_EQ(*map.Find(1), 30);
+    EXPECT_EQ(map.InsertOrAssign(2, 40).Ok(), 40);
+    EXPECT_EQ(map.Seek(2).Ok(), 40);
+    EXPECT_EQ(map.Size(), 2u);
+
+    EXPECT_TRUE(map.Erase(1));
+    EXPECT_FALSE(map.Erase(1));
+    EXPECT_FALSE(map.Contains(1));
+    EXPECT_TRUE(map.Contains(2));
+    EXPECT_EQ(map.Size(), 1u);
+
+    map.Clear();
+    EXPECT_TRUE(map.Empty());
+    EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(TestBTreeMap, Grow)
+{
+    IntMap map;
+    std::map<int, int> expected;
+    for (int i = 0; i < 5000; ++i)
+    {
+        const int key = Shuffled(i);
+        ASSERT_TRUE(map.Insert(key, i).Ok().inserted);
+        expected[key] = i;
+    }
+
+    ExpectMatches(map, expected);
+    EXPECT_GE(map.Height(), 2u);
+    EXPECT_LE(map.Height(), 4u);
+
+    for (const auto& pair : expected)
+    {
+        ASSERT_NE(map.Find(pair.first), nullptr);
+        EXPECT_EQ(*map.Find(pair.first), pair.second);
+    }
+
+    EXPECT_EQ(map.Find(10007), nullptr);
+}
+
+TEST(TestBTreeMap, Erase)
+{
+    // small nodes give deep trees, covering every rebalancing case
+    Map<Big> small;
+
+    IntMap map;
+    std::map<int, int> expected;
+    for (int i = 0; i < 3000; ++i)
+    {
+        const int key = Shuffled(i);
+        ASSERT_TRUE(map.Insert(key, i).IsOk());
+        ASSERT_TRUE(small.TryEmplace(key).IsOk());
+        expected[key] = i;
+    }
+
+    EXPECT_GE(small.Height(), 6u);
+    for (int i = 0; i < 3000; i += 2)
+    {
+        const int key = Shuffled(i * 3 % 3000);
+        const bool present = expected.erase(key) == 1;
+        EXPECT_EQ(map.Erase(key), present);
+        EXPECT_EQ(small.Erase(key), present);
+    }
+
+    ExpectMatches(map, expected);
+    ASSERT_EQ(small.Size(), expected.size());
+    auto it = expected.begin();
+    for (const auto& entry : small)
+    {
+        EXPECT_EQ(entry.Key(), it->first);
+        ++it;
+    }
+
+    for (const auto& pair : expected)
+    {
+        ASSERT_TRUE(map.Erase(pair.first));
+        ASSERT_TRUE(small.Erase(pair.first));
+    }
+
+    EXPECT_TRUE(map.Empty());
+    EXPECT_TRUE(small.Empty());
+    EXPECT_EQ(map.Height(), 0u);
+    EXPECT_EQ(small.Height(), 0u);
+    EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(TestBTreeMap, Churn)
+{
+    Map<Big> map;
+    std::map<int, int> expected;
+    uint32_t state = 1;
+    for (int i = 0; i < 20000; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        const int key = static_cast<int>((state >> 16) % 500);
+        if (state & 0x80000000u)
+        {
+            const bool inserted = map.TryEmplace(key).Ok().inserted;
+            EXPECT_EQ(inserted, expected.emplace(key, 0).second);
+        }
+        else
+        {
+            EXPECT_EQ(map.Erase(key), expected.erase(key) == 1);
+        }
+    }
+
+    ASSERT_EQ(map.Size(), expected.size());
+    auto it = expected.begin();
+    for (const auto& entry : map)
+    {
+        EXPECT_EQ(entry.Key(), it->first);
+        ++it;
+    }
+}
+
+TEST(TestBTreeMap, Bounds)
+{
+    IntMap map;
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(map.Insert(i * 2, i).IsOk());
+    }
+
+    EXPECT_EQ(map.LowerBound(-5)->Key(), 0);
+    EXPECT_EQ(map.LowerBound(10)->Key(), 10);
+    EXPECT_EQ(map.LowerBound(11)->Key(), 12);
+    EXPECT_EQ(map.UpperBound(10)->Key(), 12);
+    EXPECT_EQ(map.UpperBound(11)->Key(), 12);
+    EXPECT_EQ(map.LowerBound(1998)->Key(), 1998);
+    EXPECT_EQ(map.LowerBound(1999), map.end());
+    EXPECT_EQ(map.UpperBound(1998), map.end());
+
+    int expected = 100;
+    for (auto& entry : map.Range(99, 301))
+    {
+        EXPECT_EQ(entry.Key(), expected);
+        entry.Value() = -1;
+        expected += 2;
+    }
+
+    EXPECT_EQ(expected, 302);
+    EXPECT_EQ(*map.Find(300), -1);
+    EXPECT_EQ(*map.Find(302), 151);
+
+    const IntMap& cmap = map;
+    int count = 0;
+    for (const auto& entry : cmap.Range(1990, 5000))
+    {
+        EXPECT_EQ(entry.Key(), 1990 + count * 2);
+        ++count;
+    }
+
+    EXPECT_EQ(count, 5);
+    EXPECT_EQ(cmap.Range(7, 8).begin(), cmap.Range(7, 8).end());
+}
+
+TEST(TestBTreeMap, HeterogeneousLookup)
+{
+    rad::BTreeMap<int64_t, int, radtest::Mallocator, rad::Less<>> map;
+    ASSERT_TRUE(map.Insert(int64_t{ 5 }, 1).IsOk());
+    ASSERT_TRUE(map.Insert(int64_t{ 7 }, 2).IsOk());
+
+    EXPECT_EQ(*map.Find(5), 1);
+    EXPECT_TRUE(map.Contains(7u));
+    EXPECT_EQ(map.LowerBound(6)->Key(), 7);
+    EXPECT_TRUE(map.Erase(5));
+    EXPECT_EQ(map.Size(), 1u);
+}
+
+TEST(TestBTreeMap, Descending)
+{
+    struct Greater
+    {
+        bool operator()(int a, int b) const noexcept
+        {
+            return a > b;
+        }
+    };
+
+    rad::BTreeMap<int, int, radtest::Mallocator, Greater> map;
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(map.Insert(i, i).IsOk());
+    }
+
+    int expected = 99;
+    for (const auto& entry : map)
+    {
+        EXPECT_EQ(entry.Key(), expected--);
+    }
+
+    EXPECT_EQ(map.LowerBound(50)->Key(), 50);
+    EXPECT_EQ(map.UpperBound(50)->Key(), 49);
+}
+
+TEST(TestBTreeMap, Lifetimes)
+{
+    {
+        Map<Tracked> map;
+        for (int i = 0; i < 500; ++i)
+        {
+            ASSERT_TRUE(map.TryEmplace(Shuffled(i), i).IsOk());
+        }
+
+        EXPECT_EQ(g_Live, 500);
+
+        // nothing is constructed for present keys
+        EXPECT_FALSE(map.TryEmplace(Shuffled(3), 0).Ok().inserted);
+        EXPECT_EQ(g_Live, 500);
+
+        for (int i = 0; i < 250; ++i)
+        {
+            ASSERT_TRUE(map.Erase(Shuffled(i)));
+        }
+
+        EXPECT_EQ(g_Live, 250);
+        EXPECT_EQ(map.Find(Shuffled(300))->value, 300);
+    }
+
+    EXPECT_EQ(g_Live, 0);
+}
+
+TEST(TestBTreeMap, Allocations)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        Map<int, radtest::CountingAllocator> map;
+        ASSERT_TRUE(map.Insert(1, 1).IsOk());
+        EXPECT_EQ(counter.AllocCount(), 1u);
+
+        // the root leaf fills up before splitting into three nodes
+        for (int i = 2; i <= static_cast<int>(IntMap::NodeCapacity); ++i)
+        {
+            ASSERT_TRUE(map.Insert(i, i).IsOk());
+        }
+
+        EXPECT_EQ(counter.AllocCount(), 1u);
+        ASSERT_TRUE(map.Insert(0, 0).IsOk());
+        EXPECT_EQ(counter.AllocCount(), 3u);
+        EXPECT_EQ(map.Height(), 2u);
+
+        // erasing merges the leaves back into a single root
+        for (int i = 0; i < 10; ++i)
+        {
+            map.Erase(i);
+        }
+
+        EXPECT_EQ(map.Height(), 1u);
+        EXPECT_EQ(counter.FreeCount(), 2u);
+        map.Clear();
+        EXPECT_EQ(counter.FreeCount(), 3u);
+    }
+
+    counter.VerifyCounts();
+}
+
+TEST(TestBTreeMap, NoMemory)
+{
+    Map<int, radtest::FailingAllocator> failing;
+    EXPECT_EQ(failing.Insert(1, 1), rad::Error::NoMemory);
+    EXPECT_EQ(failing.InsertOrAssign(1, 1), rad::Error::NoMemory);
+    EXPECT_TRUE(failing.Empty());
+    EXPECT_EQ(failing.Height(), 0u);
+
+    // the first split needs two nodes, and fails on the second
+    Map<int, radtest::OOMAllocator> map(radtest::OOMAllocator(2));
+    std::map<int, int> expected;
+    int i = 0;
+    for (; map.Insert(i, i).IsOk(); ++i)
+    {
+        expected[i] = i;
+    }
+
+    EXPECT_EQ(i, static_cast<int>(IntMap::NodeCapacity));
+    EXPECT_EQ(map.Insert(i, i), rad::Error::NoMemory);
+    ExpectMatches(map, expected);
+    EXPECT_EQ(map.Height(), 1u);
+
+    // present keys need no memory
+    EXPECT_FALSE(map.Insert(0, 5).Ok().inserted);
+    EXPECT_EQ(map.InsertOrAssign(0, 5).Ok(), 5);
+
+    // and neither does filling the hole left by an erased one
+    EXPECT_TRUE(map.Erase(1));
+    EXPECT_TRUE(map.Insert(-1, -1).IsOk());
+}
+
+TEST(TestBTreeMap, MoveAndSwap)
+{
+    IntMap a;
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(a.Insert(i, i).IsOk());
+    }
+
+    IntMap b(std::move(a));
+    EXPECT_TRUE(a.Empty());
+    EXPECT_EQ(a.begin(), a.end());
+    EXPECT_EQ(b.Size(), 100u);
+
+    // moved from maps are usable
+    ASSERT_TRUE(a.Insert(-1, -1).IsOk());
+
+    a.Swap(b);
+    EXPECT_EQ(a.Size(), 100u);
+    EXPECT_EQ(b.Size(), 1u);
+    EXPECT_EQ(*b.Find(-1), -1);
+
+    b = std::move(a);
+    EXPECT_TRUE(a.Empty());
+    EXPECT_EQ(b.Size(), 100u);
+    EXPECT_EQ(*b.Find(99), 99);
+}
+
+TEST(TestBTreeMap, Clone)
+{
+    {
+        Map<Tracked> map;
+        for (int i = 0; i < 1000; ++i)
+        {
+            ASSERT_TRUE(map.TryEmplace(Shuffled(i), i).IsOk());
+        }
+
+        auto res = map.Clone();
+        ASSERT_TRUE(res.IsOk());
+        auto& copy = res.Ok();
+        EXPECT_EQ(copy.Size(), 1000u);
+        EXPECT_EQ(copy.Height(), map.Height());
+        EXPECT_EQ(g_Live, 2000);
+
+        auto it = map.begin();
+        for (const auto& entry : copy)
+        {
+            EXPECT_EQ(entry.Key(), it->Key());
+            EXPECT_EQ(entry.Value().value, it->Value().value);
+            ++it;
+        }
+    }
+
+    EXPECT_EQ(g_Live, 0);
+
+    // a partial copy is torn down
+    constexpr int Budget = 1 << 20;
+    Map<int, radtest::OOMAllocator> map(radtest::OOMAllocator{ Budget });
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(map.Insert(Shuffled(i), i).IsOk());
+    }
+
+    const int nodes = Budget - map.GetAllocator().m_oom;
+    EXPECT_GT(nodes, 10);
+
+    // the copy of the allocator runs out halfway through
+    Map<int, radtest::OOMAllocator> half(
+        radtest::OOMAllocator{ nodes + nodes / 2 });
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(half.Insert(Shuffled(i), i).IsOk());
+    }
+
+    EXPECT_EQ(half.Clone(), rad::Error::NoMemory);
+}
+
+TEST(TestBTreeSet, Basics)
+{
+    rad::BTreeSet<int, radtest::Mallocator> set;
+    std::map<int, int> expected;
+    for (int i = 0; i < 2000; ++i)
+    {
+        const int key = Shuffled(i) % 1500;
+        EXPECT_EQ(set.Insert(key).Ok().inserted,
+                  expected.emplace(key, 0).second);
+        EXPECT_EQ(*set.Find(key), key);
+    }
+
+    ASSERT_EQ(set.Size(), expected.size());
+    auto it = expected.begin();
+    for (int key : set)
+    {
+        EXPECT_EQ(key, it->first);
+        ++it;
+    }
+
+    const int low = *set.LowerBound(700);
+    EXPECT_EQ(low, expected.lower_bound(700)->first);
+    EXPECT_EQ(*set.UpperBound(low), expected.upper_bound(low)->first);
+    EXPECT_EQ(set.LowerBound(1500), set.end());
+
+    int count = 0;
+    for (int key : set.Range(100, 200))
+    {
+        EXPECT_GE(key, 100);
+        EXPECT_LT(key, 200);
+        ++count;
+    }
+
+    EXPECT_EQ(count,
+              std::distance(expected.lower_bound(100),
+                            expected.lower_bound(200)));
+
+    for (int i = 0; i < 1500; ++i)
+    {
+        EXPECT_EQ(set.Erase(i), expected.erase(i) == 1);
+    }
+
+    EXPECT_TRUE(set.Empty());
+
+    ASSERT_TRUE(set.Insert(3).IsOk());
+    auto copy = set.Clone();
+    ASSERT_TRUE(copy.IsOk());
+    EXPECT_TRUE(copy.Ok().Contains(3));
+
+    rad::BTreeSet<int, radtest::FailingAllocator> failing;
+    EXPECT_EQ(failing.Insert(1), rad::Error::NoMemory);
+}
@@ -0,0 +1,326 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/Bitset.h"
+
+#include "test/TestAlloc.h"
+
+#include <bitset>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+using DynamicBitset = rad::DynamicBitset<radtest::Mallocator>;
+
+template <typename TBits>
+std::vector<size_t> SetBits(const TBits& bits)
+{
+    std::vector<size_t> result;
+    for (size_t i = bits.FindFirst(); i < bits.Size(); i = bits.FindNext(i))
+    {
+        result.push_back(i);
+    }
+
+    return result;
+}
+
+template <typename TBits>
+std::vector<size_t> UnsetBits(const TBits& bits)
+{
+    std::vector<size_t> result;
+    for (size_t i = bits.FindFirstUnset(); i < bits.Size();
+         i = bits.FindNextUnset(i))
+    {
+        result.push_back(i);
+    }
+
+    return result;
+}
+
+} // namespace
+
+TEST(BitsTest, Intrinsics)
+{
+    EXPECT_EQ(rad::detail::BitPopCount(0), 0u);
+    EXPECT_EQ(rad::detail::BitPopCount(~uint64_t(0)), 64u);
+    EXPECT_EQ(rad::detail::BitPopCount(0x8000000000000101ull), 3u);
+    EXPECT_EQ(rad::detail::BitTrailingZeros(1), 0u);
+    EXPECT_EQ(rad::detail::BitTrailingZeros(0x8000000000000000ull), 63u);
+    EXPECT_EQ(rad::detail::BitTrailingZeros(0x0000000100000000ull), 32u);
+    EXPECT_EQ(rad::detail::BitLeadingZeros(1), 63u);
+    EXPECT_EQ(rad::detail::BitLeadingZeros(0x8000000000000000ull), 0u);
+    EXPECT_EQ(rad::detail::BitLeadingZeros(0x00000000ffffffffull), 32u);
+}
+
+TEST(BitsetTest, Layout)
+{
+    EXPECT_EQ(sizeof(rad::Bitset<1>), 8u);
+    EXPECT_EQ(sizeof(rad::Bitset<64>), 8u);
+    EXPECT_EQ(sizeof(rad::Bitset<65>), 16u);
+    RAD_S_ASSERT(rad::Bitset<100>::Size() == 100);
+}
+
+TEST(BitsetTest, SetResetFlip)
+{
+    rad::Bitset<130> bits;
+    EXPECT_TRUE(bits.None());
+    EXPECT_FALSE(bits.Any());
+    EXPECT_EQ(bits.Count(), 0u);
+
+    bits.Set(0).Set(64).Set(129);
+    EXPECT_TRUE(bits.Test(0));
+    EXPECT_TRUE(bits[64]);
+    EXPECT_TRUE(bits[129]);
+    EXPECT_FALSE(bits[1]);
+    EXPECT_EQ(bits.Count(), 3u);
+
+    bits.Reset(64).Flip(1).Flip(0).Set(2, true).Set(129, false);
+    EXPECT_EQ(SetBits(bits), (std::vector<size_t>{ 1, 2 }));
+
+    bits.SetAll();
+    EXPECT_TRUE(bits.All());
+    EXPECT_EQ(bits.Count(), 130u);
+    EXPECT_EQ(bits.FindFirstUnset(), bits.Size());
+
+    bits.Reset(100);
+    EXPECT_FALSE(bits.All());
+    bits.FlipAll();
+    EXPECT_EQ(bits.Count(), 1u);
+    EXPECT_EQ(bits.FindFirst(), 100u);
+
+    bits.ResetAll();
+    EXPECT_TRUE(bits.None());
+}
+
+TEST(BitsetTest, Find)
+{
+    rad::Bitset<200> bits;
+    EXPECT_EQ(bits.FindFirst(), 200u);
+    EXPECT_EQ(bits.FindLast(), 200u);
+    EXPECT_EQ(bits.FindFirstUnset(), 0u);
+
+    const size_t set[] = { 3, 63, 64, 65, 127, 128, 199 };
+    for (size_t i : set)
+    {
+        bits.Set(i);
+    }
+
+    EXPECT_EQ(SetBits(bits), std::vector<size_t>(std::begin(set),
+                                                  std::end(set)));
+    EXPECT_EQ(bits.FindLast(), 199u);
+    EXPECT_EQ(bits.FindNext(199), 200u);
+    EXPECT_EQ(bits.FindNext(65), 127u);
+
+    std::vector<size_t> unset = UnsetBits(bits);
+    EXPECT_EQ(unset.size(), 200u - 7u);
+    EXPECT_EQ(unset.front(), 0u);
+    EXPECT_EQ(unset.back(), 198u);
+
+    // the padding bits of the last word are never found
+    bits.SetAll();
+    EXPECT_EQ(bits.FindFirstUnset(), 200u);
+    bits.Reset(5);
+    EXPECT_EQ(bits.FindNextUnset(5), 200u);
+}
+
+TEST(BitsetTest, Operators)
+{
+    rad::Bitset<70> a;
+    rad::Bitset<70> b;
+    a.Set(1).Set(2).Set(69);
+    b.Set(2).Set(3).Set(69);
+
+    EXPECT_EQ(SetBits(a & b), (std::vector<size_t>{ 2, 69 }));
+    EXPECT_EQ(SetBits(a | b), (std::vector<size_t>{ 1, 2, 3, 69 }));
+    EXPECT_EQ(SetBits(a ^ b), (std::vector<size_t>{ 1, 3 }));
+    EXPECT_EQ((~a).Count(), 67u);
+    EXPECT_TRUE((a ^ a).None());
+
+    rad::Bitset<70> c = a;
+    EXPECT_TRUE(c == a);
+    EXPECT_FALSE(c != a);
+    c ^= b;
+    EXPECT_TRUE(c != a);
+    c |= a;
+    c &= b;
+    EXPECT_EQ(SetBits(c), (std::vector<size_t>{ 2, 3, 69 }));
+
+    rad::Span<const uint64_t> words = a.ToWords();
+    ASSERT_EQ(words.Size(), 2u);
+    EXPECT_EQ(words[0], 6u);
+    EXPECT_EQ(words[1], 32u);
+}
+
+TEST(BitsetTest, MatchesStd)
+{
+    rad::Bitset<300> bits;
+    std::bitset<300> expected;
+    uint32_t state = 1;
+    for (int i = 0; i < 1000; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        const size_t index = (state >> 8) % 300;
+        bits.Flip(index);
+        expected.flip(index);
+    }
+
+    EXPECT_EQ(bits.Count(), expected.count());
+    for (size_t i = 0; i < 300; ++i)
+    {
+        EXPECT_EQ(bits[i], expected[i]);
+    }
+
+    std::vector<size_t> set = SetBits(bits);
+    EXPECT_EQ(set.size(), expected.count());
+    for (size_t i : set)
+    {
+        EXPECT_TRUE(expected[i]);
+    }
+}
+
+TEST(DynamicBitsetTest, Empty)
+{
+    DynamicBitset bits;
+    EXPECT_TRUE(bits.Empty());
+    EXPECT_EQ(bits.Size(), 0u);
+    EXPECT_EQ(bits.Count(), 0u);
+    EXPECT_TRUE(bits.None());
+    EXPECT_TRUE(bits.All());
+    EXPECT_EQ(bits.FindFirst(), 0u);
+    EXPECT_EQ(bits.FindFirstUnset(), 0u);
+    EXPECT_EQ(bits.FindLast(), 0u);
+    bits.SetAll().FlipAll().ResetAll();
+    EXPECT_TRUE(bits.ToWords().Empty());
+}
+
+TEST(DynamicBitsetTest, Resize)
+{
+    DynamicBitset bits;
+    ASSERT_TRUE(bits.Resize(10).IsOk());
+    EXPECT_EQ(bits.Size(), 10u);
+    EXPECT_TRUE(bits.None());
+
+    // new bits take the given value, old bits keep theirs
+    bits.Set(9);
+    ASSERT_TRUE(bits.Resize(100, true).IsOk());
+    EXPECT_EQ(bits.Count(), 91u);
+    EXPECT_FALSE(bits[8]);
+    EXPECT_TRUE(bits[9]);
+    EXPECT_TRUE(bits[10]);
+    EXPECT_TRUE(bits[99]);
+    EXPECT_EQ(bits.ToWords().Size(), 2u);
+    EXPECT_EQ(bits.ToWords()[1], (uint64_t(1) << 36) - 1);
+
+    // shrinking drops the bits past the end
+    ASSERT_TRUE(bits.Resize(64).IsOk());
+    EXPECT_EQ(bits.Count(), 55u);
+    ASSERT_TRUE(bits.Resize(70).IsOk());
+    EXPECT_EQ(bits.Count(), 55u);
+    EXPECT_EQ(bits.FindLast(), 63u);
+    ASSERT_TRUE(bits.Resize(20).IsOk());
+    EXPECT_EQ(bits.Count(), 11u);
+    ASSERT_TRUE(bits.Resize(30).IsOk());
+    EXPECT_EQ(bits.Count(), 11u);
+
+    bits.Clear();
+    EXPECT_TRUE(bits.Empty());
+}
+
+TEST(DynamicBitsetTest, PushBack)
+{
+    DynamicBitset bits;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        ASSERT_TRUE(bits.PushBack(i % 3 == 0).IsOk());
+    }
+
+    EXPECT_EQ(bits.Size(), 200u);
+    EXPECT_EQ(bits.Count(), 67u);
+    std::vector<size_t> set = SetBits(bits);
+    ASSERT_EQ(set.size(), 67u);
+    for (size_t i = 0; i < set.size(); ++i)
+    {
+        EXPECT_EQ(set[i], i * 3);
+    }
+}
+
+TEST(DynamicBitsetTest, FindAndOperators)
+{
+    DynamicBitset a;
+    DynamicBitset b;
+    ASSERT_TRUE(a.Resize(150).IsOk());
+    ASSERT_TRUE(b.Resize(150).IsOk());
+    a.Set(0).Set(70).Set(149);
+    b.Set(70).Set(100);
+
+    EXPECT_EQ(SetBits(a), (std::vector<size_t>{ 0, 70, 149 }));
+    EXPECT_EQ(a.FindLast(), 149u);
+    EXPECT_EQ(a.FindFirstUnset(), 1u);
+
+    a |= b;
+    EXPECT_EQ(SetBits(a), (std::vector<size_t>{ 0, 70, 100, 149 }));
+    a ^= b;
+    EXPECT_EQ(SetBits(a), (std::vector<size_t>{ 0, 149 }));
+    a |= b;
+    a &= b;
+    EXPECT_TRUE(a == b);
+    b.Flip(0);
+    EXPECT_TRUE(a != b);
+
+    a.SetAll();
+    EXPECT_TRUE(a.All());
+    EXPECT_EQ(a.Count(), 150u);
+    EXPECT_EQ(UnsetBits(a), std::vector<size_t>());
+    a.FlipAll();
+    EXPECT_TRUE(a.None());
+}
+
+TEST(DynamicBitsetTest, MoveClone)
+{
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+    {
+        rad::DynamicBitset<radtest::CountingAllocator> bits;
+        ASSERT_TRUE(bits.Resize(100).IsOk());
+        bits.Set(42);
+
+        auto clone = bits.Clone();
+        ASSERT_TRUE(clone.IsOk());
+        EXPECT_TRUE(clone.Ok() == bits);
+
+        rad::DynamicBitset<radtest::CountingAllocator> moved(
+            rad::Move(bits));
+        EXPECT_TRUE(bits.Empty());
+        EXPECT_TRUE(moved[42]);
+
+        bits = rad::Move(moved);
+        EXPECT_TRUE(moved.Empty());
+        EXPECT_EQ(bits.Size(), 100u);
+        EXPECT_EQ(bits.FindFirst(), 42u);
+    }
+
+    alloc.VerifyCounts();
+}
+
+TEST(DynamicBitsetTest, NoMemory)
+{
+    rad::DynamicBitset<radtest::FailingAllocator> bits;
+    EXPECT_EQ(bits.Resize(10).Err(), rad::Error::NoMemory);
+    EXPECT_EQ(bits.PushBack(true).Err(), rad::Error::NoMemory);
+    EXPECT_TRUE(bits.Empty());
+    EXPECT_EQ(bits.Resize(0).IsOk(), true);
+}
@@ -0,0 +1,77 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/Atomic.h"
+#include "radiant/CacheAligned.h"
+
+#include <stdint.h>
+
+namespace
+{
+struct Pair
+{
+    Pair(int a, int b) noexcept
+        : first(a),
+          second(b)
+    {
+    }
+
+    int first;
+    int second;
+};
+
+struct Large
+{
+    char bytes[RAD_CACHE_LINE_SIZE + 1];
+};
+} // namespace
+
+RAD_S_ASSERT(alignof(rad::CacheAligned<char>) == RAD_CACHE_LINE_SIZE);
+RAD_S_ASSERT(sizeof(rad::CacheAligned<char>) == RAD_CACHE_LINE_SIZE);
+RAD_S_ASSERT(sizeof(rad::CacheAligned<Large>) == 2 * RAD_CACHE_LINE_SIZE);
+RAD_S_ASSERT(rad::CacheAligned<int>::Alignment == RAD_CACHE_LINE_SIZE);
+RAD_S_ASSERT(!(rad::IsCtor<rad::CacheAligned<Pair>>));
+RAD_S_ASSERT(!(rad::IsConv<int, rad::CacheAligned<int>>));
+
+TEST(CacheAlignedTest, Construct)
+{
+    rad::CacheAligned<int> value;
+    EXPECT_EQ(value.Get(), 0);
+
+    rad::CacheAligned<Pair> pair(1, 2);
+    EXPECT_EQ(pair->first, 1);
+    EXPECT_EQ((*pair).second, 2);
+
+    const rad::CacheAligned<Pair> copy(pair);
+    EXPECT_EQ(copy.Get().first, 1);
+    EXPECT_EQ(copy->second, 2);
+}
+
+TEST(CacheAlignedTest, Separated)
+{
+    rad::CacheAligned<rad::Atomic<uint32_t>> slots[4];
+    for (auto& slot : slots)
+    {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(&slot) % RAD_CACHE_LINE_SIZE,
+                  0u);
+        slot->FetchAdd(1, rad::MemOrderRelaxed);
+    }
+
+    EXPECT_EQ(reinterpret_cast<char*>(&slots[1].Get()) -
+                  reinterpret_cast<char*>(&slots[0].Get()),
+              RAD_CACHE_LINE_SIZE);
+    EXPECT_EQ(slots[3]->Load(rad::MemOrderRelaxed), 1u);
+}
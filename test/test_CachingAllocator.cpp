@@ -0,0 +1,314 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/CachingAllocator.h"
+#include "radiant/List.h"
+#include "radiant/Vector.h"
+
+#include "test/TestAlloc.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+using TestHeap = rad::CachingHeap<radtest::CountingAllocator>;
+using TestAllocator = rad::CachingAllocator<radtest::CountingAllocator>;
+
+bool IsAligned(void* ptr, size_t align)
+{
+    return (reinterpret_cast<uintptr_t>(ptr) & (align - 1)) == 0;
+}
+} // namespace
+
+RAD_S_ASSERT(!TestAllocator::IsAlwaysEqual);
+RAD_S_ASSERT(TestAllocator::PropagateOnCopy);
+RAD_S_ASSERT(rad::AllocTraits<TestAllocator>::HasAllocBytesAtLeast);
+
+TEST(TestCachingAllocator, SizeClasses)
+{
+    EXPECT_EQ(TestHeap::SizeClass(0), 0u);
+    EXPECT_EQ(TestHeap::SizeClass(1), 0u);
+    EXPECT_EQ(TestHeap::SizeClass(16), 0u);
+    EXPECT_EQ(TestHeap::SizeClass(17), 1u);
+    EXPECT_EQ(TestHeap::SizeClass(128), 7u);
+    EXPECT_EQ(TestHeap::SizeClass(129), 8u);
+    EXPECT_EQ(TestHeap::SizeClass(160), 8u);
+    EXPECT_EQ(TestHeap::SizeClass(161), 9u);
+    EXPECT_EQ(TestHeap::SizeClass(256), 11u);
+    EXPECT_EQ(TestHeap::SizeClass(257), 12u);
+    EXPECT_EQ(TestHeap::SizeClass(TestHeap::MaxSmallSize),
+              TestHeap::ClassCount - 1);
+
+    EXPECT_EQ(TestHeap::ClassSize(0), 16u);
+    EXPECT_EQ(TestHeap::ClassSize(7), 128u);
+    EXPECT_EQ(TestHeap::ClassSize(8), 160u);
+    EXPECT_EQ(TestHeap::ClassSize(12), 320u);
+    EXPECT_EQ(TestHeap::ClassSize(TestHeap::ClassCount - 1),
+              TestHeap::MaxSmallSize);
+
+    // every size lands in the smallest class that holds it
+    for (size_t size = 1; size <= TestHeap::MaxSmallSize; ++size)
+    {
+        const uint32_t sizeClass = TestHeap::SizeClass(size);
+        ASSERT_GE(TestHeap::ClassSize(sizeClass), size);
+        if (sizeClass > 0)
+        {
+            ASSERT_LT(TestHeap::ClassSize(sizeClass - 1), size);
+        }
+    }
+}
+
+TEST(TestCachingAllocator, AllocFree)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        TestHeap heap;
+        void* first = heap.AllocBytes(24);
+        ASSERT_NE(first, nullptr);
+        EXPECT_TRUE(IsAligned(first, 16));
+
+        // a cache and a slab
+        EXPECT_EQ(counter.AllocCount(), 2u);
+
+        void* second = heap.AllocBytes(32);
+        EXPECT_EQ(static_cast<char*>(second) - static_cast<char*>(first), 32);
+        memset(first, 0xcc, 24);
+        memset(second, 0xcc, 32);
+
+        // freed blocks are reused first
+        heap.FreeBytes(first, 24);
+        EXPECT_EQ(heap.AllocBytes(30), first);
+        heap.FreeBytes(first, 30);
+        heap.FreeBytes(second, 32);
+        heap.FreeBytes(nullptr, 32);
+
+        void* other = heap.AllocBytes(100);
+        EXPECT_TRUE(IsAligned(other, 16));
+        EXPECT_EQ(counter.AllocCount(), 3u);
+        heap.FreeBytes(other, 100);
+
+        // large requests go to the backing allocator
+        void* large = heap.AllocBytes(TestHeap::MaxSmallSize + 1);
+        ASSERT_NE(large, nullptr);
+        EXPECT_EQ(counter.AllocCount(), 4u);
+        heap.FreeBytes(large, TestHeap::MaxSmallSize + 1);
+        EXPECT_EQ(counter.FreeCount(), 1u);
+    }
+
+    EXPECT_EQ(counter.FreeCount(), counter.AllocCount());
+}
+
+TEST(TestCachingAllocator, AllocAtLeast)
+{
+    TestHeap heap;
+    rad::AllocBytesResult res = heap.AllocBytesAtLeast(130);
+    ASSERT_NE(res.ptr, nullptr);
+    EXPECT_EQ(res.size, 160u);
+    heap.FreeBytes(res.ptr, res.size);
+
+    res = heap.AllocBytesAtLeast(5000);
+    ASSERT_NE(res.ptr, nullptr);
+    EXPECT_EQ(res.size, 5000u);
+    heap.FreeBytes(res.ptr, res.size);
+}
+
+TEST(TestCachingAllocator, Batches)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        TestHeap heap;
+
+        // 8 KiB worth of 1 KiB blocks move at once
+        std::vector<void*> blocks;
+        for (int i = 0; i < 40; ++i)
+        {
+            blocks.push_back(heap.AllocBytes(1000));
+        }
+
+        for (void* block : blocks)
+        {
+            heap.FreeBytes(block, 1000);
+        }
+
+        const uint32_t allocs = counter.AllocCount();
+        for (void*& block : blocks)
+        {
+            block = heap.AllocBytes(1000);
+        }
+
+        EXPECT_EQ(counter.AllocCount(), allocs);
+        for (void* block : blocks)
+        {
+            heap.FreeBytes(block, 1000);
+        }
+    }
+
+    EXPECT_EQ(counter.FreeCount(), counter.AllocCount());
+}
+
+TEST(TestCachingAllocator, Containers)
+{
+    TestHeap heap;
+    {
+        rad::Vector<int, TestAllocator> vec(TestAllocator{ heap });
+        for (int i = 0; i < 1000; ++i)
+        {
+            ASSERT_TRUE(vec.PushBack(i).IsOk());
+        }
+
+        rad::List<int, TestAllocator> list(TestAllocator{ heap });
+        for (int i = 0; i < 1000; ++i)
+        {
+            ASSERT_TRUE(list.PushBack(i).IsOk());
+        }
+
+        int expected = 0;
+        for (int value : list)
+        {
+            EXPECT_EQ(value, expected);
+            EXPECT_EQ(vec[static_cast<uint32_t>(expected)], expected);
+            ++expected;
+        }
+    }
+}
+
+TEST(TestCachingAllocator, Threads)
+{
+    constexpr int ThreadCount = 4;
+    constexpr int Iterations = 5000;
+    rad::CachingHeap<radtest::Mallocator> heap;
+
+    // blocks allocated on one thread are freed on the next
+    std::vector<void*> handoff[ThreadCount];
+    std::vector<std::thread> threads;
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back(
+            [&heap, &handoff, t]()
+            {
+                for (int i = 0; i < Iterations; ++i)
+                {
+                    const size_t size = static_cast<size_t>(i % 700) + 1;
+                    void* ptr = heap.AllocBytes(size);
+                    ASSERT_NE(ptr, nullptr);
+                    memset(ptr, t, size);
+                    if (i % 4 == 0)
+                    {
+                        handoff[t].push_back(ptr);
+                    }
+                    else
+                    {
+                        heap.FreeBytes(ptr, size);
+                    }
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    threads.clear();
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back(
+            [&heap, &handoff, t]()
+            {
+                const std::vector<void*>& blocks =
+                    handoff[(t + 1) % ThreadCount];
+                for (size_t i = 0; i < blocks.size(); ++i)
+                {
+                    const size_t size = (i * 4) % 700 + 1;
+                    heap.FreeBytes(blocks[i], size);
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+TEST(TestCachingAllocator, ThreadCachesAdopted)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    TestHeap heap;
+
+    void* block = nullptr;
+    std::thread first(
+        [&heap, &block]()
+        {
+            block = heap.AllocBytes(48);
+            heap.FreeBytes(block, 48);
+        });
+    first.join();
+    const uint32_t allocs = counter.AllocCount();
+
+    // the cache of the exited thread, and the block in it, are reused
+    void* again = nullptr;
+    std::thread second([&heap, &again]() { again = heap.AllocBytes(48); });
+    second.join();
+    EXPECT_EQ(again, block);
+    EXPECT_EQ(counter.AllocCount(), allocs);
+    heap.FreeBytes(again, 48);
+}
+
+TEST(TestCachingAllocator, ManyHeaps)
+{
+    // a thread caches for a few heaps and uses the others uncached
+    {
+        rad::CachingHeap<radtest::Mallocator> heaps[12];
+        for (int round = 0; round < 2; ++round)
+        {
+            for (auto& heap : heaps)
+            {
+                void* first = heap.AllocBytes(64);
+                void* second = heap.AllocBytes(64);
+                ASSERT_NE(first, nullptr);
+                ASSERT_NE(second, nullptr);
+                EXPECT_NE(first, second);
+                heap.FreeBytes(first, 64);
+                heap.FreeBytes(second, 64);
+            }
+        }
+    }
+
+    // destroyed heaps free up the thread's entries for new ones
+    rad::CachingHeap<radtest::Mallocator> heap;
+    void* ptr = heap.AllocBytes(64);
+    ASSERT_NE(ptr, nullptr);
+    heap.FreeBytes(ptr, 64);
+}
+
+TEST(TestCachingAllocator, AllocFailure)
+{
+    rad::CachingHeap<radtest::FailingAllocator> failing;
+    EXPECT_EQ(failing.AllocBytes(16), nullptr);
+    EXPECT_EQ(failing.AllocBytes(5000), nullptr);
+
+    // the cache fits, the slab does not
+    rad::CachingHeap<radtest::OOMAllocator> oom(radtest::OOMAllocator(1));
+    EXPECT_EQ(oom.AllocBytes(16), nullptr);
+}
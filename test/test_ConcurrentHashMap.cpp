@@ -0,0 +1,179 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/ConcurrentHashMap.h"
+
+#include "test/TestAlloc.h"
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Map = rad::ConcurrentHashMap<int, int, radtest::Mallocator>;
+} // namespace
+
+TEST(TestConcurrentHashMap, InsertFindErase)
+{
+    Map map;
+    EXPECT_TRUE(map.Empty());
+
+    auto res = map.Insert(1, 10);
+    ASSERT_TRUE(res.IsOk());
+    EXPECT_TRUE(res.Ok());
+    EXPECT_FALSE(map.Insert(1, 20).Ok());
+    EXPECT_EQ(map.Get(1).Ok(), 10);
+
+    EXPECT_FALSE(map.InsertOrAssign(1, 30).Ok());
+    EXPECT_EQ(map.Get(1).Ok(), 30);
+    EXPECT_TRUE(map.InsertOrAssign(2, 40).Ok());
+    EXPECT_EQ(map.Size(), 2u);
+
+    EXPECT_TRUE(map.Contains(2));
+    EXPECT_FALSE(map.Contains(3));
+    EXPECT_EQ(map.Get(3).Err(), rad::Error::OutOfRange);
+
+    EXPECT_TRUE(map.Erase(1));
+    EXPECT_FALSE(map.Erase(1));
+    EXPECT_EQ(map.Size(), 1u);
+
+    map.Clear();
+    EXPECT_TRUE(map.Empty());
+}
+
+TEST(TestConcurrentHashMap, VisitUpdate)
+{
+    Map map;
+    ASSERT_TRUE(map.Insert(5, 1).IsOk());
+
+    int seen = 0;
+    EXPECT_TRUE(map.Visit(5, [&](const int& value) noexcept { seen = value; }));
+    EXPECT_EQ(seen, 1);
+    EXPECT_FALSE(map.Visit(6, [&](const int&) noexcept { seen = -1; }));
+    EXPECT_EQ(seen, 1);
+
+    EXPECT_TRUE(map.Update(5, [](int& value) noexcept { value += 41; }));
+    EXPECT_EQ(map.Get(5).Ok(), 42);
+    EXPECT_FALSE(map.Update(6, [](int& value) noexcept { value = 0; }));
+}
+
+TEST(TestConcurrentHashMap, Shards)
+{
+    Map map;
+    ASSERT_TRUE(map.Reserve(1000).IsOk());
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(map.Insert(i, i).IsOk());
+    }
+
+    EXPECT_EQ(map.Size(), 1000u);
+
+    long long sum = 0;
+    map.ForEach([&](const Map::EntryType& entry) noexcept
+                { sum += entry.Value(); });
+    EXPECT_EQ(sum, 999 * 1000 / 2);
+
+    EXPECT_EQ(map.EraseIf([](const Map::EntryType& entry) noexcept
+                          { return entry.Key() % 2 == 0; }),
+              500u);
+    EXPECT_EQ(map.Size(), 500u);
+    EXPECT_FALSE(map.Contains(10));
+    EXPECT_TRUE(map.Contains(11));
+}
+
+TEST(TestConcurrentHashMap, SingleShard)
+{
+    rad::ConcurrentHashMap<int, int, radtest::Mallocator, rad::Hash<int>,
+                           rad::EqualTo<int>, rad::RWSpinLock, 1>
+        map;
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(map.Insert(i, i).IsOk());
+    }
+
+    EXPECT_EQ(map.Size(), 100u);
+    EXPECT_EQ(map.Get(99).Ok(), 99);
+}
+
+TEST(TestConcurrentHashMap, NoMemory)
+{
+    rad::ConcurrentHashMap<int, int, radtest::FailingAllocator> map;
+    EXPECT_EQ(map.Insert(1, 1).Err(), rad::Error::NoMemory);
+    EXPECT_EQ(map.InsertOrAssign(1, 1).Err(), rad::Error::NoMemory);
+    EXPECT_TRUE(map.Reserve(10).IsErr());
+    EXPECT_TRUE(map.Empty());
+}
+
+TEST(TestConcurrentHashMap, Concurrent)
+{
+    constexpr int Writers = 2;
+    constexpr int Readers = 2;
+    constexpr int Count = 2000;
+
+    Map map;
+    std::vector<std::thread> threads;
+    for (int w = 0; w < Writers; ++w)
+    {
+        threads.emplace_back(
+            [&map, w]
+            {
+                for (int i = w; i < Count; i += Writers)
+                {
+                    EXPECT_TRUE(map.Insert(i, i * 3).Ok());
+                    if (i % 4 == 0)
+                    {
+                        EXPECT_TRUE(map.Update(i,
+                                               [](int& value) noexcept
+                                               { value += 1; }));
+                    }
+                }
+            });
+    }
+
+    for (int r = 0; r < Readers; ++r)
+    {
+        threads.emplace_back(
+            [&map]
+            {
+                for (int pass = 0; pass < 3; ++pass)
+                {
+                    for (int i = 0; i < Count; ++i)
+                    {
+                        // a value is either missing, inserted, or updated
+                        map.Visit(i,
+                                  [i](const int& value) noexcept
+                                  {
+                                      EXPECT_TRUE(value == i * 3 ||
+                                                  value == i * 3 + 1);
+                                  });
+                    }
+
+                    std::this_thread::yield();
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(map.Size(), static_cast<size_t>(Count));
+    for (int i = 0; i < Count; ++i)
+    {
+        EXPECT_EQ(map.Get(i).Ok(), i * 3 + (i % 4 == 0 ? 1 : 0));
+    }
+}
@@ -0,0 +1,298 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/Coroutine.h"
+
+#if RAD_CPP20 && RAD_ENABLE_STD
+
+#include "test/TestAlloc.h"
+
+namespace
+{
+using rad::AllocatorArg;
+using rad::AllocatorArgType;
+using rad::Generator;
+using rad::Task;
+
+template <typename TAlloc>
+Task<int> Add(AllocatorArgType, TAlloc, int a, int b)
+{
+    co_return a + b;
+}
+
+template <typename TAlloc>
+Task<int> Sum(AllocatorArgType, TAlloc alloc, int count)
+{
+    int total = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        total = co_await Add(AllocatorArg, alloc, total, i);
+    }
+
+    co_return total;
+}
+
+template <typename TAlloc>
+Task<rad::Res<int>> Parse(AllocatorArgType, TAlloc, int value)
+{
+    if (value < 0)
+    {
+        co_return rad::Error::OutOfRange;
+    }
+
+    co_return value * 2;
+}
+
+int g_Steps = 0;
+
+template <typename TAlloc>
+Task<rad::Res<int>> ParseBoth(AllocatorArgType, TAlloc alloc, int a, int b)
+{
+    const int x = co_await co_await Parse(AllocatorArg, alloc, a);
+    ++g_Steps;
+    rad::Res<int> second = co_await Parse(AllocatorArg, alloc, b);
+    const int y = co_await second;
+    ++g_Steps;
+    co_return x + y;
+}
+
+Task<rad::Res<int>> ParseFailing(AllocatorArgType, radtest::Mallocator)
+{
+    const int x =
+        co_await co_await Parse(AllocatorArg, radtest::FailingAllocator(), 1);
+    ++g_Steps;
+    co_return x;
+}
+
+// resumes its waiter when set, from whoever sets it
+class Event
+{
+public:
+
+    bool await_ready() const noexcept
+    {
+        return m_set;
+    }
+
+    void await_suspend(std::coroutine_handle<> waiter) noexcept
+    {
+        m_waiter = waiter;
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+    void Set() noexcept
+    {
+        m_set = true;
+        if (m_waiter)
+        {
+            std::coroutine_handle<> waiter = m_waiter;
+            m_waiter = nullptr;
+            waiter.resume();
+        }
+    }
+
+private:
+
+    std::coroutine_handle<> m_waiter;
+    bool m_set = false;
+};
+
+Task<void> WaitTwice(AllocatorArgType,
+                     radtest::Mallocator,
+                     Event& a,
+                     Event& b,
+                     int& state)
+{
+    state = 1;
+    co_await a;
+    state = 2;
+    co_await b;
+    state = 3;
+}
+
+template <typename TAlloc>
+Generator<int> Iota(AllocatorArgType, TAlloc, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        co_yield i;
+    }
+}
+
+struct Counter
+{
+    Task<int> Next(AllocatorArgType, radtest::Mallocator)
+    {
+        co_return ++value;
+    }
+
+    int value = 0;
+};
+} // namespace
+
+TEST(CoroutineTest, TaskIsLazy)
+{
+    Task<int> task = Add(AllocatorArg, radtest::Mallocator(), 2, 3);
+    ASSERT_TRUE(task.IsValid());
+    EXPECT_FALSE(task.IsReady());
+    EXPECT_TRUE(task.Start());
+    EXPECT_EQ(task.Value(), 5);
+
+    Task<int> moved(std::move(task));
+    EXPECT_FALSE(task.IsValid());
+    EXPECT_EQ(moved.Value(), 5);
+}
+
+TEST(CoroutineTest, NestedTasks)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        Task<int> task = Sum(AllocatorArg, counter, 100);
+        EXPECT_EQ(counter.AllocCount(), 1u);
+        EXPECT_TRUE(task.Start());
+        EXPECT_EQ(task.Value(), 4950);
+
+        // a frame for each child task, freed once it completed
+        EXPECT_EQ(counter.AllocCount(), 101u);
+        EXPECT_EQ(counter.FreeCount(), 100u);
+    }
+
+    counter.VerifyCounts();
+}
+
+TEST(CoroutineTest, MemberCoroutine)
+{
+    Counter counter;
+    Task<int> a = counter.Next(AllocatorArg, radtest::Mallocator());
+    Task<int> b = counter.Next(AllocatorArg, radtest::Mallocator());
+    EXPECT_TRUE(b.Start());
+    EXPECT_TRUE(a.Start());
+    EXPECT_EQ(a.Value(), 2);
+    EXPECT_EQ(b.Value(), 1);
+}
+
+TEST(CoroutineTest, AllocationFailure)
+{
+    Task<int> task = Add(AllocatorArg, radtest::FailingAllocator(), 1, 2);
+    EXPECT_FALSE(task.IsValid());
+    EXPECT_FALSE(task.IsReady());
+    EXPECT_FALSE(task.Start());
+
+    // awaiting a task that never ran gives NoMemory
+    Task<rad::Res<int>> outer =
+        ParseFailing(AllocatorArg, radtest::Mallocator());
+    ASSERT_TRUE(outer.IsValid());
+    g_Steps = 0;
+    EXPECT_TRUE(outer.Start());
+    EXPECT_EQ(outer.Value(), rad::Error::NoMemory);
+    EXPECT_EQ(g_Steps, 0);
+}
+
+TEST(CoroutineTest, ResultPropagation)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        g_Steps = 0;
+        auto ok = ParseBoth(AllocatorArg, counter, 3, 4);
+        EXPECT_TRUE(ok.Start());
+        ASSERT_TRUE(ok.Value().IsOk());
+        EXPECT_EQ(ok.Value().Ok(), 14);
+        EXPECT_EQ(g_Steps, 2);
+
+        // an error completes the task without running the rest of it
+        g_Steps = 0;
+        auto first = ParseBoth(AllocatorArg, counter, -1, 4);
+        EXPECT_TRUE(first.Start());
+        EXPECT_EQ(first.Value(), rad::Error::OutOfRange);
+        EXPECT_EQ(g_Steps, 0);
+
+        g_Steps = 0;
+        auto second = ParseBoth(AllocatorArg, counter, 1, -4);
+        EXPECT_TRUE(second.Start());
+        EXPECT_EQ(second.Value(), rad::Error::OutOfRange);
+        EXPECT_EQ(g_Steps, 1);
+    }
+
+    counter.VerifyCounts();
+}
+
+TEST(CoroutineTest, ResumedExternally)
+{
+    Event a;
+    Event b;
+    int state = 0;
+    Task<void> task =
+        WaitTwice(AllocatorArg, radtest::Mallocator(), a, b, state);
+    EXPECT_EQ(state, 0);
+    EXPECT_FALSE(task.Start());
+    EXPECT_EQ(state, 1);
+    a.Set();
+    EXPECT_EQ(state, 2);
+    EXPECT_FALSE(task.IsReady());
+    b.Set();
+    EXPECT_EQ(state, 3);
+    EXPECT_TRUE(task.IsReady());
+
+    // destroying a suspended task frees its frame
+    Event never;
+    Task<void> pending =
+        WaitTwice(AllocatorArg, radtest::Mallocator(), never, never, state);
+    EXPECT_FALSE(pending.Start());
+}
+
+TEST(CoroutineTest, Generator)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        int expected = 0;
+        for (int value : Iota(AllocatorArg, counter, 10))
+        {
+            EXPECT_EQ(value, expected);
+            ++expected;
+        }
+
+        EXPECT_EQ(expected, 10);
+        EXPECT_EQ(counter.AllocCount(), 1u);
+
+        Generator<int> gen = Iota(AllocatorArg, counter, 2);
+        ASSERT_TRUE(gen.IsValid());
+        int* value = gen.Next();
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(*value, 0);
+        EXPECT_EQ(*gen.Next(), 1);
+        EXPECT_EQ(gen.Next(), nullptr);
+        EXPECT_EQ(gen.Next(), nullptr);
+
+        // abandoned midway
+        Generator<int> partial = Iota(AllocatorArg, counter, 100);
+        EXPECT_EQ(*partial.Next(), 0);
+    }
+
+    counter.VerifyCounts();
+
+    Generator<int> failed = Iota(AllocatorArg, radtest::FailingAllocator(), 5);
+    EXPECT_FALSE(failed.IsValid());
+    EXPECT_EQ(failed.Next(), nullptr);
+    EXPECT_TRUE(failed.begin() == failed.end());
+}
+
+#endif // RAD_CPP20 && RAD_ENABLE_STD
@@ -0,0 +1,482 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/Deque.h"
+
+#include "test/TestAlloc.h"
+#include "test/TestThrow.h"
+
+#include <deque>
+
+namespace
+{
+// small chunks so the tests cross many chunk boundaries
+using Deque = rad::Deque<int, radtest::Mallocator, 4>;
+using CountingDeque = rad::Deque<int, radtest::CountingAllocator, 4>;
+
+struct Pinned
+{
+    explicit Pinned(int v) noexcept
+        : value(v)
+    {
+    }
+
+    Pinned(const Pinned&) = delete;
+    Pinned& operator=(const Pinned&) = delete;
+
+    int value;
+};
+
+// fails the test when handed a null pointer to free
+class NonNullFreeAllocator
+{
+public:
+
+    void FreeBytes(void* ptr, size_t byte_count) noexcept
+    {
+        RAD_UNUSED(byte_count);
+        EXPECT_NE(ptr, nullptr);
+        free(ptr);
+    }
+
+    void* AllocBytes(size_t byte_count) noexcept
+    {
+        return malloc(byte_count);
+    }
+
+    static void HandleSizeOverflow()
+    {
+    }
+};
+
+template <typename TDeque>
+void ExpectContents(const TDeque& deque, const std::deque<int>& expected)
+{
+    ASSERT_EQ(deque.Size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(deque[i], expected[i]);
+    }
+
+    size_t i = 0;
+    for (int value : deque)
+    {
+        EXPECT_EQ(value, expected[i]);
+        ++i;
+    }
+
+    EXPECT_EQ(i, expected.size());
+}
+
+} // namespace
+
+TEST(DequeTest, DefaultChunkSize)
+{
+    const size_t bytes = rad::Deque<char, radtest::Mallocator>::ChunkSize;
+    const size_t words = rad::Deque<uint64_t, radtest::Mallocator>::ChunkSize;
+    const size_t large =
+        rad::Deque<char[1000], radtest::Mallocator>::ChunkSize;
+    EXPECT_EQ(bytes, 4096u);
+    EXPECT_EQ(words, 512u);
+    EXPECT_EQ(large, 16u);
+}
+
+TEST(DequeTest, DefaultConstruct)
+{
+    Deque deque;
+    EXPECT_TRUE(deque.Empty());
+    EXPECT_EQ(deque.Size(), 0u);
+    EXPECT_EQ(deque.ChunkCount(), 0u);
+    EXPECT_EQ(deque.begin(), deque.end());
+    EXPECT_EQ(deque.cbegin(), deque.cend());
+}
+
+TEST(DequeTest, PushBack)
+{
+    Deque deque;
+    std::deque<int> expected;
+    for (int i = 0; i < 50; ++i)
+    {
+        ASSERT_TRUE(deque.PushBack(i).IsOk());
+        expected.push_back(i);
+        EXPECT_EQ(deque.Back(), i);
+        EXPECT_EQ(deque.Front(), 0);
+    }
+
+    ExpectContents(deque, expected);
+    EXPECT_EQ(deque.ChunkCount(), 13u);
+}
+
+TEST(DequeTest, PushFront)
+{
+    Deque deque;
+    std::deque<int> expected;
+    for (int i = 0; i < 50; ++i)
+    {
+        ASSERT_TRUE(deque.PushFront(i).IsOk());
+        expected.push_front(i);
+        EXPECT_EQ(deque.Front(), i);
+        EXPECT_EQ(deque.Back(), 0);
+    }
+
+    ExpectContents(deque, expected);
+    EXPECT_EQ(deque.ChunkCount(), 13u);
+}
+
+TEST(DequeTest, PopBothEnds)
+{
+    Deque deque;
+    std::deque<int> expected;
+    for (int i = 0; i < 20; ++i)
+    {
+        ASSERT_TRUE(deque.PushBack(i).IsOk());
+        ASSERT_TRUE(deque.PushFront(-i).IsOk());
+        expected.push_back(i);
+        expected.push_front(-i);
+    }
+
+    while (!expected.empty())
+    {
+        deque.PopFront();
+        expected.pop_front();
+        ExpectContents(deque, expected);
+        if (!expected.empty())
+        {
+            deque.PopBack();
+            expected.pop_back();
+            ExpectContents(deque, expected);
+        }
+    }
+
+    EXPECT_EQ(deque.ChunkCount(), 0u);
+
+    // popping an empty deque does nothing
+    deque.PopBack().PopFront();
+    EXPECT_TRUE(deque.Empty());
+}
+
+TEST(DequeTest, Mixed)
+{
+    Deque deque;
+    std::deque<int> expected;
+    uint32_t state = 12345;
+    for (int i = 0; i < 2000; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        switch ((state >> 16) % 5)
+        {
+            case 0:
+            case 1:
+                ASSERT_TRUE(deque.PushBack(i).IsOk());
+                expected.push_back(i);
+                break;
+            case 2:
+                ASSERT_TRUE(deque.PushFront(i).IsOk());
+                expected.push_front(i);
+                break;
+            case 3:
+                deque.PopFront();
+                if (!expected.empty())
+                {
+                    expected.pop_front();
+                }
+                break;
+            default:
+                deque.PopBack();
+                if (!expected.empty())
+                {
+                    expected.pop_back();
+                }
+                break;
+        }
+
+        ASSERT_EQ(deque.Size(), expected.size());
+    }
+
+    ExpectContents(deque, expected);
+}
+
+TEST(DequeTest, StableAddresses)
+{
+    Deque deque;
+    ASSERT_TRUE(deque.PushBack(7).IsOk());
+    const int* seven = &deque.Front();
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(deque.PushBack(i).IsOk());
+        ASSERT_TRUE(deque.PushFront(i).IsOk());
+    }
+
+    EXPECT_EQ(seven, &deque[1000]);
+    EXPECT_EQ(*seven, 7);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        deque.PopFront();
+    }
+
+    EXPECT_EQ(seven, &deque.Front());
+}
+
+TEST(DequeTest, NonMovable)
+{
+    rad::Deque<Pinned, radtest::Mallocator, 4> deque;
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_TRUE(deque.EmplaceBack(i).IsOk());
+        ASSERT_TRUE(deque.EmplaceFront(-i).IsOk());
+    }
+
+    EXPECT_EQ(deque.Size(), 20u);
+    EXPECT_EQ(deque.Front().value, -9);
+    EXPECT_EQ(deque.Back().value, 9);
+}
+
+TEST(DequeTest, Chunks)
+{
+    Deque deque;
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_TRUE(deque.PushBack(i).IsOk());
+    }
+
+    ASSERT_TRUE(deque.PushFront(-1).IsOk());
+
+    // [-1] [0 1 2 3] [4 5 6 7] [8 9]
+    ASSERT_EQ(deque.ChunkCount(), 4u);
+    EXPECT_EQ(deque.Chunk(0).Size(), 1u);
+    EXPECT_EQ(deque.Chunk(1).Size(), 4u);
+    EXPECT_EQ(deque.Chunk(2).Size(), 4u);
+    EXPECT_EQ(deque.Chunk(3).Size(), 2u);
+    EXPECT_EQ(deque.Chunk(0)[0], -1);
+    EXPECT_EQ(deque.Chunk(3)[1], 9);
+    EXPECT_EQ(&deque.Chunk(3)[1], &deque.Back());
+
+    int expected = -1;
+    const Deque& cdeque = deque;
+    for (size_t c = 0; c < cdeque.ChunkCount(); ++c)
+    {
+        rad::Span<const int> chunk = cdeque.Chunk(c);
+        for (int value : chunk)
+        {
+            EXPECT_EQ(value, expected);
+            ++expected;
+        }
+    }
+
+    EXPECT_EQ(expected, 10);
+
+    // a single partial chunk
+    Deque one;
+    ASSERT_TRUE(one.PushFront(1).IsOk());
+    ASSERT_TRUE(one.PushFront(0).IsOk());
+    ASSERT_EQ(one.ChunkCount(), 1u);
+    EXPECT_EQ(one.Chunk(0).Size(), 2u);
+    EXPECT_EQ(one.Chunk(0)[0], 0);
+}
+
+TEST(DequeTest, Iterators)
+{
+    Deque deque;
+    for (int i = 0; i < 8; ++i)
+    {
+        ASSERT_TRUE(deque.PushBack(i).IsOk());
+    }
+
+    // the end sits on a chunk boundary
+    auto it = deque.end();
+    for (int i = 7; i >= 0; --i)
+    {
+        --it;
+        EXPECT_EQ(*it, i);
+    }
+
+    EXPECT_EQ(it, deque.begin());
+
+    Deque::ConstIteratorType cit = deque.begin();
+    cit++;
+    EXPECT_EQ(*cit, 1);
+
+    for (int& value : deque)
+    {
+        value *= 2;
+    }
+
+    EXPECT_EQ(deque[7], 14);
+}
+
+TEST(DequeTest, ChunkReuse)
+{
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+    {
+        CountingDeque deque;
+
+        // a queue whose size stays level cycles through the spare chunk
+        for (int i = 0; i < 100; ++i)
+        {
+            ASSERT_TRUE(deque.PushBack(i).IsOk());
+            deque.PopFront();
+        }
+
+        // the emptied chunk is kept and reused, so only the chunk map and
+        // one chunk are ever allocated
+        alloc.VerifyCounts(2, 0);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            ASSERT_TRUE(deque.PushBack(i).IsOk());
+        }
+
+        deque.Clear();
+        EXPECT_TRUE(deque.Empty());
+        EXPECT_EQ(deque.ChunkCount(), 0u);
+    }
+
+    alloc.VerifyCounts();
+}
+
+TEST(DequeTest, NoMemory)
+{
+    using OOMDeque = rad::Deque<int, radtest::OOMAllocator, 4>;
+
+    // the chunk map fails
+    OOMDeque none(radtest::OOMAllocator(0));
+    EXPECT_EQ(none.PushBack(1).Err(), rad::Error::NoMemory);
+    EXPECT_EQ(none.PushFront(1).Err(), rad::Error::NoMemory);
+    EXPECT_TRUE(none.Empty());
+
+    // the map and one chunk succeed, the second chunk fails
+    OOMDeque deque(radtest::OOMAllocator(2));
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(deque.PushBack(i).IsOk());
+    }
+
+    EXPECT_EQ(deque.PushBack(4).Err(), rad::Error::NoMemory);
+    EXPECT_EQ(deque.PushFront(-1).Err(), rad::Error::NoMemory);
+    EXPECT_EQ(deque.Size(), 4u);
+    EXPECT_EQ(deque.ChunkCount(), 1u);
+    EXPECT_EQ(deque.Back(), 3);
+
+    // the map of 8 chunks starts centered, so the fifth chunk at the back
+    // needs the map to grow, which fails
+    OOMDeque grow(radtest::OOMAllocator(5));
+    for (int i = 0; i < 16; ++i)
+    {
+        ASSERT_TRUE(grow.PushBack(i).IsOk());
+    }
+
+    EXPECT_EQ(grow.PushBack(16).Err(), rad::Error::NoMemory);
+    EXPECT_EQ(grow.Size(), 16u);
+    EXPECT_EQ(grow.Back(), 15);
+}
+
+TEST(DequeTest, ThrowingObject)
+{
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+    {
+        rad::Deque<radtest::ThrowingObject, radtest::CountingAllocator, 4>
+            deque;
+        for (int i = 2; i < 6; ++i)
+        {
+            ASSERT_TRUE(deque.EmplaceBack(i).IsOk());
+        }
+
+        // a throw into a fresh chunk leaves the deque unchanged
+        EXPECT_THROW(deque.EmplaceBack(1).IsOk(), std::exception);
+        EXPECT_THROW(deque.EmplaceFront(1).IsOk(), std::exception);
+        EXPECT_EQ(deque.Size(), 4u);
+        EXPECT_EQ(deque.ChunkCount(), 1u);
+        EXPECT_EQ(deque.Front(), 2);
+        EXPECT_EQ(deque.Back(), 5);
+
+        // and so does a throw into a partial chunk
+        ASSERT_TRUE(deque.EmplaceBack(6).IsOk());
+        EXPECT_THROW(deque.EmplaceBack(1).IsOk(), std::exception);
+        EXPECT_EQ(deque.Size(), 5u);
+        EXPECT_EQ(deque.Back(), 6);
+    }
+
+    alloc.VerifyCounts();
+}
+
+TEST(DequeTest, MoveCloneSwap)
+{
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+    {
+        CountingDeque deque;
+        for (int i = 0; i < 10; ++i)
+        {
+            ASSERT_TRUE(deque.PushBack(i).IsOk());
+        }
+
+        const int* front = &deque.Front();
+        CountingDeque moved(rad::Move(deque));
+        EXPECT_TRUE(deque.Empty());
+        EXPECT_EQ(&moved.Front(), front);
+        EXPECT_EQ(moved.Size(), 10u);
+
+        auto clone = moved.Clone();
+        ASSERT_TRUE(clone.IsOk());
+        ExpectContents(clone.Ok(), { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+        EXPECT_NE(&clone.Ok().Front(), front);
+
+        ASSERT_TRUE(deque.PushBack(42).IsOk());
+        deque.Swap(moved);
+        EXPECT_EQ(deque.Size(), 10u);
+        EXPECT_EQ(&deque.Front(), front);
+        EXPECT_EQ(moved.Size(), 1u);
+        EXPECT_EQ(moved.Front(), 42);
+
+        moved = rad::Move(deque);
+        EXPECT_TRUE(deque.Empty());
+        EXPECT_EQ(&moved.Front(), front);
+        moved = rad::Move(moved);
+        EXPECT_EQ(moved.Size(), 10u);
+    }
+
+    alloc.VerifyCounts();
+}
+
+TEST(DequeTest, ReleaseSkipsNull)
+{
+    using NonNullDeque = rad::Deque<int, NonNullFreeAllocator, 4>;
+    {
+        // nothing was allocated
+        NonNullDeque deque;
+    }
+    {
+        // the chunk map exists but no spare chunk was kept
+        NonNullDeque deque;
+        ASSERT_TRUE(deque.PushBack(1).IsOk());
+    }
+    {
+        NonNullDeque deque;
+        ASSERT_TRUE(deque.PushBack(1).IsOk());
+        NonNullDeque moved(rad::Move(deque));
+        deque = rad::Move(moved);
+    }
+
+    RAD_S_ASSERT(noexcept(rad::DeclVal<const Deque&>().Clone()));
+    RAD_S_ASSERT(!noexcept(
+        rad::DeclVal<const rad::Deque<radtest::ThrowingObject,
+                                       radtest::Mallocator,
+                                       4>&>()
+            .Clone()));
+}
@@ -0,0 +1,231 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/Epoch.h"
+
+#include "test/TestAlloc.h"
+
+#include <thread>
+
+namespace
+{
+using Domain = rad::EpochDomain<radtest::Mallocator>;
+
+int g_Live = 0;
+
+struct Tracked
+{
+    explicit Tracked(int v) noexcept
+        : value(v)
+    {
+        ++g_Live;
+    }
+
+    ~Tracked()
+    {
+        value = -1;
+        --g_Live;
+    }
+
+    int value;
+};
+
+Tracked* NewTracked(int value)
+{
+    radtest::Mallocator alloc;
+    Tracked* obj =
+        rad::AllocTraits<radtest::Mallocator>::Alloc<Tracked>(alloc, 1);
+    return ::new (static_cast<void*>(obj)) Tracked(value);
+}
+} // namespace
+
+TEST(TestEpoch, Register)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        rad::EpochDomain<radtest::CountingAllocator> domain;
+        auto first = domain.Register();
+        auto second = domain.Register();
+        ASSERT_TRUE(first.IsOk());
+        ASSERT_TRUE(second.IsOk());
+        EXPECT_NE(first.Ok(), second.Ok());
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(first.Ok()) % RAD_CACHE_LINE_SIZE,
+                  0u);
+        counter.VerifyCounts(2, 0);
+
+        // unregistered records are reused
+        domain.Unregister(*first.Ok());
+        auto third = domain.Register();
+        ASSERT_TRUE(third.IsOk());
+        EXPECT_EQ(third.Ok(), first.Ok());
+        counter.VerifyCounts(2, 0);
+    }
+    counter.VerifyCounts(2, 2);
+    counter.VerifyCounts();
+
+    rad::EpochDomain<radtest::FailingAllocator> failing;
+    EXPECT_EQ(failing.Register(), rad::Error::NoMemory);
+}
+
+TEST(TestEpoch, GuardBlocksAdvance)
+{
+    Domain domain;
+    Domain::Participant& reader = *domain.Register().Ok();
+
+    EXPECT_TRUE(domain.TryAdvance());
+    EXPECT_EQ(domain.Epoch(), 1u);
+    {
+        Domain::Guard guard(reader);
+        {
+            Domain::Guard nested(reader);
+        }
+
+        // the pinned reader observed epoch 1, but not epoch 2
+        EXPECT_TRUE(domain.TryAdvance());
+        EXPECT_EQ(domain.Epoch(), 2u);
+        EXPECT_FALSE(domain.TryAdvance());
+        EXPECT_FALSE(domain.TryAdvance());
+        EXPECT_EQ(domain.Epoch(), 2u);
+    }
+    EXPECT_TRUE(domain.TryAdvance());
+    EXPECT_EQ(domain.Epoch(), 3u);
+
+    domain.Unregister(reader);
+}
+
+TEST(TestEpoch, RetireDefersFree)
+{
+    g_Live = 0;
+    radtest::Mallocator alloc;
+    Domain domain;
+    Domain::Participant& reader = *domain.Register().Ok();
+    Domain::Participant& writer = *domain.Register().Ok();
+
+    EXPECT_TRUE(domain.Retire(writer, static_cast<Tracked*>(nullptr), alloc)
+                    .IsOk());
+    EXPECT_EQ(domain.RetiredCount(writer), 0u);
+
+    {
+        Domain::Guard guard(reader);
+        Tracked* obj = NewTracked(1);
+        EXPECT_TRUE(domain.Retire(writer, obj, alloc).IsOk());
+        EXPECT_EQ(domain.RetiredCount(writer), 1u);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_EQ(domain.Collect(writer), 0u);
+        }
+        EXPECT_EQ(obj->value, 1);
+        EXPECT_EQ(g_Live, 1);
+    }
+
+    // the epoch passed the retirement once while the reader was pinned, the
+    // second time frees the object
+    EXPECT_EQ(domain.Epoch(), 1u);
+    EXPECT_EQ(domain.Collect(writer), 1u);
+    EXPECT_EQ(domain.Epoch(), 2u);
+    EXPECT_EQ(domain.RetiredCount(writer), 0u);
+    EXPECT_EQ(g_Live, 0);
+
+    domain.Unregister(reader);
+    domain.Unregister(writer);
+}
+
+TEST(TestEpoch, RetireCollectsAutomatically)
+{
+    g_Live = 0;
+    radtest::Mallocator alloc;
+    {
+        Domain domain;
+        Domain::Participant& writer = *domain.Register().Ok();
+        for (int i = 0; i < 1000; ++i)
+        {
+            EXPECT_TRUE(domain.Retire(writer, NewTracked(i), alloc).IsOk());
+        }
+        const size_t threshold = Domain::CollectThreshold;
+        EXPECT_LT(domain.RetiredCount(writer), threshold);
+        EXPECT_LT(g_Live, static_cast<int>(threshold));
+
+        // what is left is handed over through the record, then freed with
+        // the domain
+        domain.Unregister(writer);
+        EXPECT_GT(g_Live, 0);
+    }
+    EXPECT_EQ(g_Live, 0);
+
+    rad::EpochDomain<radtest::FailingAllocator> failing;
+    EXPECT_EQ(failing.Register(), rad::Error::NoMemory);
+}
+
+TEST(TestEpoch, Concurrent)
+{
+    static constexpr int ReaderCount = 3;
+    static constexpr int Swaps = 20000;
+
+    g_Live = 0;
+    radtest::Mallocator alloc;
+    {
+        Domain domain;
+        rad::Atomic<Tracked*> shared{ NewTracked(0) };
+        rad::Atomic<int> done{ 0 };
+
+        std::thread readers[ReaderCount];
+        for (auto& reader : readers)
+        {
+            reader = std::thread(
+                [&]
+                {
+                    Domain::Participant& self = *domain.Register().Ok();
+                    int last = 0;
+                    while (done.Load(rad::MemOrderAcquire) == 0)
+                    {
+                        Domain::Guard guard(self);
+                        const int value =
+                            shared.Load(rad::MemOrderAcquire)->value;
+                        EXPECT_GE(value, last);
+                        last = value;
+                        std::this_thread::yield();
+                    }
+
+                    domain.Unregister(self);
+                });
+        }
+
+        Domain::Participant& writer = *domain.Register().Ok();
+        for (int i = 1; i <= Swaps; ++i)
+        {
+            Tracked* old = shared.Exchange(NewTracked(i), rad::MemOrderAcqRel);
+            EXPECT_TRUE(domain.Retire(writer, old, alloc).IsOk());
+            if (i % 64 == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        done.Store(1, rad::MemOrderRelease);
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+
+        EXPECT_TRUE(
+            domain.Retire(writer, shared.Load(rad::MemOrderRelaxed), alloc)
+                .IsOk());
+        domain.Unregister(writer);
+    }
+    EXPECT_EQ(g_Live, 0);
+}
@@ -0,0 +1,478 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/FlatHashMap.h"
+
+#include "test/TestAlloc.h"
+
+#include <string.h>
+
+namespace
+{
+template <typename V, typename TAllocator = radtest::Mallocator>
+using Map = rad::FlatHashMap<int, V, TAllocator>;
+using IntMap = Map<int>;
+
+int g_Live = 0;
+
+struct Tracked
+{
+    explicit Tracked(int v) noexcept
+        : value(v)
+    {
+        ++g_Live;
+    }
+
+    Tracked(const Tracked& other) noexcept
+        : value(other.value)
+    {
+        ++g_Live;
+    }
+
+    Tracked(Tracked&& other) noexcept
+        : value(other.value)
+    {
+        ++g_Live;
+    }
+
+    Tracked& operator=(const Tracked& other) noexcept
+    {
+        value = other.value;
+        return *this;
+    }
+
+    ~Tracked()
+    {
+        --g_Live;
+    }
+
+    int value;
+};
+
+// every key collides, so lookups walk the whole probe sequence
+struct CollidingHash
+{
+    uint64_t operator()(int) const noexcept
+    {
+        return 0x2a;
+    }
+};
+
+struct Name
+{
+    explicit Name(const char* str) noexcept
+    {
+        strncpy(text, str, sizeof(text) - 1);
+    }
+
+    char text[16] = {};
+};
+
+// hashes and compares names and C strings alike
+struct NameHash
+{
+    uint64_t operator()(const char* str) const noexcept
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (; *str != '\0'; ++str)
+        {
+            hash = (hash ^ static_cast<uint8_t>(*str)) * 0x100000001b3ull;
+        }
+
+        return rad::Hash<uint64_t>()(hash);
+    }
+
+    uint64_t operator()(const Name& name) const noexcept
+    {
+        return (*this)(name.text);
+    }
+};
+
+struct NameEq
+{
+    bool operator()(const Name& left, const char* right) const noexcept
+    {
+        return strcmp(left.text, right) == 0;
+    }
+
+    bool operator()(const Name& left, const Name& right) const noexcept
+    {
+        return strcmp(left.text, right.text) == 0;
+    }
+};
+
+template <typename TGroup>
+void VerifyGroup()
+{
+    constexpr uint32_t width = TGroup::Width;
+    rad::detail::HashCtrl ctrl[width];
+    for (uint32_t i = 0; i < width; ++i)
+    {
+        ctrl[i] = rad::detail::HashCtrlEmpty;
+    }
+
+    ctrl[1] = 0x15;
+    ctrl[3] = rad::detail::HashCtrlDeleted;
+    ctrl[width - 1] = 0x15;
+    ctrl[width - 2] = 0x7f;
+
+    TGroup group(ctrl);
+    auto match = group.Match(0x15);
+    ASSERT_TRUE(static_cast<bool>(match));
+    EXPECT_EQ(match.Lowest(), 1u);
+    match.ClearLowest();
+    ASSERT_TRUE(static_cast<bool>(match));
+    EXPECT_EQ(match.Lowest(), width - 1);
+    match.ClearLowest();
+    EXPECT_FALSE(static_cast<bool>(match));
+
+    EXPECT_FALSE(static_cast<bool>(group.Match(0x16)));
+    EXPECT_EQ(group.Match(0x7f).Lowest(), width - 2);
+
+    auto empty = group.MatchEmpty();
+    EXPECT_EQ(empty.Lowest(), 0u);
+    empty.ClearLowest();
+    EXPECT_EQ(empty.Lowest(), 2u);
+
+    auto free = group.MatchEmptyOrDeleted();
+    uint32_t count = 0;
+    for (; free; free.ClearLowest())
+    {
+        EXPECT_NE(free.Lowest(), 1u);
+        EXPECT_NE(free.Lowest(), width - 1);
+        EXPECT_NE(free.Lowest(), width - 2);
+        ++count;
+    }
+
+    EXPECT_EQ(count, width - 3);
+}
+
+} // namespace
+
+TEST(TestFlatHashMap, Groups)
+{
+    VerifyGroup<rad::detail::HashGroupPortable>();
+    VerifyGroup<rad::detail::HashGroup>();
+}
+
+TEST(TestFlatHashMap, DefaultConstruct)
+{
+    IntMap map;
+    EXPECT_TRUE(map.Empty());
+    EXPECT_EQ(map.Size(), 0u);
+    EXPECT_EQ(map.Capacity(), 0u);
+    EXPECT_EQ(map.Find(1), nullptr);
+    EXPECT_FALSE(map.Contains(1));
+    EXPECT_FALSE(map.Erase(1));
+    EXPECT_TRUE(map.Seek(1).IsErr());
+    EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(TestFlatHashMap, InsertFindErase)
+{
+    IntMap map;
+    auto res = map.Insert(1, 10);
+    ASSERT_TRUE(res.IsOk());
+    EXPECT_TRUE(res.Ok().inserted);
+    EXPECT_EQ(res.Ok().entry->Key(), 1);
+    EXPECT_EQ(res.Ok().entry->Value(), 10);
+
+    res = map.TryEmplace(1, 20);
+    ASSERT_TRUE(res.IsOk());
+    EXPECT_FALSE(res.Ok().inserted);
+    EXPECT_EQ(res.Ok().entry->Value(), 10);
+
+    auto assigned = map.InsertOrAssign(1, 30);
+    ASSERT_TRUE(assigned.IsOk());
+    EXPECT_EQ(assigned.Ok(), 30);
+    EXPECT_EQ(map.Size(), 1u);
+
+    ASSERT_TRUE(map.InsertOrAssign(2, 40).IsOk());
+    EXPECT_EQ(map.Size(), 2u);
+    ASSERT_NE(map.Find(2), nullptr);
+    EXPECT_EQ(*map.Find(2), 40);
+    EXPECT_EQ(map.Seek(1).Ok(), 30);
+    EXPECT_EQ(map.Seek(3).Err(), rad::Error::OutOfRange);
+
+    const IntMap& cmap = map;
+    ASSERT_NE(cmap.Find(1), nullptr);
+    EXPECT_EQ(*cmap.Find(1), 30);
+    EXPECT_TRUE(cmap.Contains(2));
+
+    EXPECT_TRUE(map.Erase(1));
+    EXPECT_FALSE(map.Erase(1));
+    EXPECT_EQ(map.Find(1), nullptr);
+    EXPECT_EQ(map.Size(), 1u);
+    EXPECT_TRUE(map.Contains(2));
+}
+
+TEST(TestFlatHashMap, Grow)
+{
+    IntMap map;
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(map.Insert(i * 7, i).IsOk());
+        EXPECT_LE(map.Size(), map.Capacity() - map.Capacity() / 8);
+    }
+
+    EXPECT_EQ(map.Size(), 1000u);
+    for (int i = 0; i < 1000; ++i)
+    {
+        int* value = map.Find(i * 7);
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(*value, i);
+        EXPECT_FALSE(map.Contains(i * 7 + 1));
+    }
+}
+
+TEST(TestFlatHashMap, Reserve)
+{
+    IntMap map;
+    ASSERT_TRUE(map.Reserve(100).IsOk());
+    const size_t capacity = map.Capacity();
+    EXPECT_GE(capacity - capacity / 8, 100u);
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(map.Insert(i, i).IsOk());
+    }
+
+    EXPECT_EQ(map.Capacity(), capacity);
+    ASSERT_TRUE(map.Reserve(10).IsOk());
+    EXPECT_EQ(map.Capacity(), capacity);
+}
+
+TEST(TestFlatHashMap, Collisions)
+{
+    rad::FlatHashMap<int, int, radtest::Mallocator, CollidingHash> map;
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(map.Insert(i, -i).IsOk());
+    }
+
+    for (int i = 0; i < 100; i += 2)
+    {
+        EXPECT_TRUE(map.Erase(i));
+    }
+
+    EXPECT_EQ(map.Size(), 50u);
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(map.Contains(i), i % 2 == 1) << i;
+    }
+
+    // deleted slots are reused without growing the table
+    const size_t capacity = map.Capacity();
+    for (int i = 0; i < 100; i += 2)
+    {
+        ASSERT_TRUE(map.Insert(i, -i).IsOk());
+    }
+
+    EXPECT_EQ(map.Capacity(), capacity);
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_NE(map.Find(i), nullptr);
+        EXPECT_EQ(*map.Find(i), -i);
+    }
+}
+
+TEST(TestFlatHashMap, Churn)
+{
+    // inserting and erasing forever reclaims deleted slots instead of
+    // growing the table
+    IntMap map;
+    for (int i = 0; i < 100000; ++i)
+    {
+        ASSERT_TRUE(map.Insert(i, i).IsOk());
+        if (i >= 50)
+        {
+            ASSERT_TRUE(map.Erase(i - 50));
+        }
+    }
+
+    EXPECT_EQ(map.Size(), 50u);
+    EXPECT_LE(map.Capacity(), 128u);
+    for (int i = 100000 - 50; i < 100000; ++i)
+    {
+        EXPECT_TRUE(map.Contains(i));
+    }
+}
+
+TEST(TestFlatHashMap, HeterogeneousLookup)
+{
+    rad::FlatHashMap<Name, int, radtest::Mallocator, NameHash, NameEq> map;
+    ASSERT_TRUE(map.TryEmplace("one", 1).IsOk());
+    ASSERT_TRUE(map.TryEmplace("two", 2).IsOk());
+    ASSERT_TRUE(map.TryEmplace(Name("three"), 3).IsOk());
+    EXPECT_FALSE(map.TryEmplace("two", 22).Ok().inserted);
+
+    ASSERT_NE(map.Find("two"), nullptr);
+    EXPECT_EQ(*map.Find("two"), 2);
+    EXPECT_EQ(*map.Find(Name("three")), 3);
+    EXPECT_EQ(map.Find("four"), nullptr);
+    EXPECT_TRUE(map.Erase("one"));
+    EXPECT_FALSE(map.Contains("one"));
+    EXPECT_EQ(map.Size(), 2u);
+}
+
+TEST(TestFlatHashMap, Iterate)
+{
+    IntMap map;
+    for (int i = 0; i < 50; ++i)
+    {
+        ASSERT_TRUE(map.Insert(i, i * 2).IsOk());
+    }
+
+    int keys = 0;
+    int count = 0;
+    for (auto& entry : map)
+    {
+        EXPECT_EQ(entry.Value(), entry.Key() * 2);
+        entry.Value() = 0;
+        keys += entry.Key();
+        ++count;
+    }
+
+    EXPECT_EQ(count, 50);
+    EXPECT_EQ(keys, 49 * 50 / 2);
+
+    const IntMap& cmap = map;
+    for (auto it = cmap.cbegin(); it != cmap.cend(); ++it)
+    {
+        EXPECT_EQ(it->Value(), 0);
+    }
+}
+
+TEST(TestFlatHashMap, EraseIf)
+{
+    IntMap map;
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(map.Insert(i, i).IsOk());
+    }
+
+    EXPECT_EQ(map.EraseIf([](const IntMap::EntryType& entry) noexcept
+                          { return entry.Key() % 3 == 0; }),
+              34u);
+    EXPECT_EQ(map.Size(), 66u);
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(map.Contains(i), i % 3 != 0);
+    }
+}
+
+TEST(TestFlatHashMap, Lifetimes)
+{
+    g_Live = 0;
+    {
+        Map<Tracked> map;
+        for (int i = 0; i < 100; ++i)
+        {
+            ASSERT_TRUE(map.TryEmplace(i, i).IsOk());
+        }
+
+        EXPECT_EQ(g_Live, 100);
+        EXPECT_FALSE(map.TryEmplace(5, 5).Ok().inserted);
+        EXPECT_EQ(g_Live, 100);
+
+        EXPECT_TRUE(map.Erase(5));
+        EXPECT_EQ(g_Live, 99);
+
+        auto clone = map.Clone();
+        ASSERT_TRUE(clone.IsOk());
+        EXPECT_EQ(g_Live, 198);
+        EXPECT_EQ(clone.Ok().Size(), 99u);
+        EXPECT_EQ(clone.Ok().Find(6)->value, 6);
+        EXPECT_EQ(clone.Ok().Find(5), nullptr);
+
+        map.Clear();
+        EXPECT_EQ(g_Live, 99);
+        EXPECT_TRUE(map.Empty());
+        EXPECT_NE(map.Capacity(), 0u);
+    }
+
+    EXPECT_EQ(g_Live, 0);
+}
+
+TEST(TestFlatHashMap, Allocations)
+{
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+    {
+        Map<int, radtest::CountingAllocator> map;
+        for (int i = 0; i < 14; ++i)
+        {
+            ASSERT_TRUE(map.Insert(i, i).IsOk());
+        }
+
+        alloc.VerifyCounts(1, 0);
+        ASSERT_TRUE(map.Insert(14, 14).IsOk());
+        alloc.VerifyCounts(2, 1);
+        EXPECT_EQ(map.Capacity(), 32u);
+    }
+
+    alloc.VerifyCounts();
+}
+
+TEST(TestFlatHashMap, NoMemory)
+{
+    Map<int, radtest::FailingAllocator> map;
+    auto res = map.Insert(1, 1);
+    ASSERT_TRUE(res.IsErr());
+    EXPECT_EQ(res.Err(), rad::Error::NoMemory);
+    EXPECT_TRUE(map.Reserve(10).IsErr());
+    EXPECT_TRUE(map.InsertOrAssign(1, 1).IsErr());
+    EXPECT_TRUE(map.Empty());
+    EXPECT_EQ(map.Capacity(), 0u);
+
+    // a failed growth leaves the map untouched
+    Map<int, radtest::OOMAllocator> limited(radtest::OOMAllocator(1));
+    for (int i = 0; i < 14; ++i)
+    {
+        ASSERT_TRUE(limited.Insert(i, i).IsOk());
+    }
+
+    EXPECT_EQ(limited.Insert(14, 14).Err(), rad::Error::NoMemory);
+    EXPECT_EQ(limited.Size(), 14u);
+    for (int i = 0; i < 14; ++i)
+    {
+        EXPECT_TRUE(limited.Contains(i));
+    }
+}
+
+TEST(TestFlatHashMap, MoveAndSwap)
+{
+    IntMap map;
+    ASSERT_TRUE(map.Insert(1, 1).IsOk());
+
+    IntMap moved(rad::Move(map));
+    EXPECT_TRUE(map.Empty());
+    EXPECT_EQ(map.Capacity(), 0u);
+    EXPECT_TRUE(moved.Contains(1));
+
+    IntMap other;
+    ASSERT_TRUE(other.Insert(2, 2).IsOk());
+    ASSERT_TRUE(other.Insert(3, 3).IsOk());
+    moved.Swap(other);
+    EXPECT_EQ(moved.Size(), 2u);
+    EXPECT_TRUE(moved.Contains(3));
+    EXPECT_EQ(other.Size(), 1u);
+    EXPECT_TRUE(other.Contains(1));
+
+    map = rad::Move(moved);
+    EXPECT_TRUE(moved.Empty());
+    EXPECT_EQ(map.Size(), 2u);
+    EXPECT_TRUE(map.Contains(2));
+}
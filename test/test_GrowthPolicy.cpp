@@ -0,0 +1,61 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/GrowthPolicy.h"
+
+TEST(TestGrowthPolicy, GrowByHalf)
+{
+    EXPECT_EQ(rad::GrowByHalf::Next(0, 1, 4), 1u);
+    EXPECT_EQ(rad::GrowByHalf::Next(10, 11, 4), 15u);
+    EXPECT_EQ(rad::GrowByHalf::Next(10, 40, 4), 40u);
+    EXPECT_EQ(rad::GrowByHalf::Next(UINT32_MAX - 5, UINT32_MAX - 4, 4),
+              UINT32_MAX);
+}
+
+TEST(TestGrowthPolicy, GrowDouble)
+{
+    EXPECT_EQ(rad::GrowDouble::Next(0, 1, 4), 1u);
+    EXPECT_EQ(rad::GrowDouble::Next(8, 9, 4), 16u);
+    EXPECT_EQ(rad::GrowDouble::Next(8, 100, 4), 100u);
+    EXPECT_EQ(rad::GrowDouble::Next(0x80000000u, 0x80000001u, 4), UINT32_MAX);
+}
+
+TEST(TestGrowthPolicy, GrowPowerOfTwo)
+{
+    EXPECT_EQ(rad::GrowPowerOfTwo::Next(0, 1, 4), 1u);
+    EXPECT_EQ(rad::GrowPowerOfTwo::Next(5, 6, 4), 8u);
+    EXPECT_EQ(rad::GrowPowerOfTwo::Next(8, 9, 4), 16u);
+    EXPECT_EQ(rad::GrowPowerOfTwo::Next(0, 1000, 4), 1024u);
+    EXPECT_EQ(rad::GrowPowerOfTwo::Next(0, 0x80000000u, 4), 0x80000000u);
+    EXPECT_EQ(rad::GrowPowerOfTwo::Next(0, 0x80000001u, 4), UINT32_MAX);
+}
+
+TEST(TestGrowthPolicy, GrowPageRounded)
+{
+    using Policy = rad::GrowPageRounded<>;
+
+    // the first growth fills a whole page
+    EXPECT_EQ(Policy::Next(0, 1, 4), 1024u);
+    EXPECT_EQ(Policy::Next(1024, 1025, 4), 2048u);
+    EXPECT_EQ(Policy::Next(0, 1, 100), 40u);
+
+    // elements larger than a page gain nothing from rounding
+    EXPECT_EQ(Policy::Next(2, 3, 5000), 3u);
+
+    EXPECT_EQ(Policy::Next(UINT32_MAX - 1, UINT32_MAX, 4), UINT32_MAX);
+
+    EXPECT_EQ(rad::GrowPageRounded<256>::Next(0, 3, 8), 32u);
+}
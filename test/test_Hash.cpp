@@ -0,0 +1,117 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/Hash.h"
+
+#include <set>
+
+namespace
+{
+enum class Color
+{
+    Red,
+    Green
+};
+
+rad::Span<const rad::Byte> Bytes(const char* data, size_t size)
+{
+    return rad::Span<const rad::Byte>(reinterpret_cast<const rad::Byte*>(data),
+                                      static_cast<rad::SpanSizeType>(size));
+}
+
+// usable as a compile-time switch key
+constexpr uint64_t HelloHash = rad::ConstexprHashBytes("hello");
+RAD_S_ASSERT(HelloHash != rad::ConstexprHashBytes("hellp"));
+
+} // namespace
+
+TEST(TestHash, Integers)
+{
+    constexpr rad::Hash<int> hash{};
+    RAD_S_ASSERT(hash(1) != hash(2));
+    EXPECT_EQ(hash(42), rad::Hash<int>()(42));
+    EXPECT_NE(rad::Hash<Color>()(Color::Red), rad::Hash<Color>()(Color::Green));
+
+    int values[2] = {};
+    rad::Hash<int*> ptrHash;
+    EXPECT_NE(ptrHash(&values[0]), ptrHash(&values[1]));
+    EXPECT_EQ(ptrHash(&values[0]), ptrHash(values));
+}
+
+TEST(TestHash, EqualTo)
+{
+    EXPECT_TRUE(rad::EqualTo<int>()(1, 1));
+    EXPECT_FALSE(rad::EqualTo<int>()(1, 2));
+    EXPECT_TRUE(rad::EqualTo<>()(1, 1L));
+}
+
+TEST(TestHash, ConstexprMatchesRuntime)
+{
+    char data[300];
+    for (size_t i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = static_cast<char>(i * 131 + 7);
+    }
+
+    for (size_t size = 0; size <= sizeof(data); ++size)
+    {
+        EXPECT_EQ(rad::HashBytes(Bytes(data, size)),
+                  rad::ConstexprHashBytes(data, size))
+            << size;
+        EXPECT_EQ(rad::HashBytes(Bytes(data, size), 99),
+                  rad::ConstexprHashBytes(data, size, 99))
+            << size;
+    }
+
+    EXPECT_EQ(rad::HashBytes(Bytes("hello", 5)), HelloHash);
+}
+
+TEST(TestHash, Distribution)
+{
+    // every length and every single-bit change gives a different hash
+    char data[128] = {};
+    std::set<uint64_t> seen;
+    for (size_t size = 0; size <= sizeof(data); ++size)
+    {
+        EXPECT_TRUE(seen.insert(rad::HashBytes(Bytes(data, size))).second)
+            << size;
+    }
+
+    for (size_t size : { size_t(3), size_t(8), size_t(16), size_t(100) })
+    {
+        for (size_t bit = 0; bit < size * 8; ++bit)
+        {
+            data[bit / 8] = static_cast<char>(1 << (bit % 8));
+            EXPECT_TRUE(seen.insert(rad::HashBytes(Bytes(data, size))).second)
+                << size << " " << bit;
+            data[bit / 8] = 0;
+        }
+    }
+
+    EXPECT_NE(rad::HashBytes(Bytes(data, 8), 1),
+              rad::HashBytes(Bytes(data, 8), 2));
+}
+
+TEST(TestHash, Spans)
+{
+    rad::Hash<rad::Span<const rad::Byte>> hash;
+    EXPECT_EQ(hash(Bytes("abc", 3)), rad::HashBytes(Bytes("abc", 3)));
+
+    const char text[] = "abc";
+    const rad::Span<const char, 3> fixed(text, 3);
+    const rad::Hash<rad::Span<const rad::Byte, 3>> fixedHash;
+    EXPECT_EQ(fixedHash(fixed.AsBytes()), rad::ConstexprHashBytes(text));
+}
@@ -0,0 +1,268 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/HazardPointer.h"
+
+#include "test/TestAlloc.h"
+
+#include <thread>
+
+namespace
+{
+using Domain = rad::HazardDomain<radtest::Mallocator>;
+using Hazard = rad::HazardPointer<radtest::Mallocator>;
+
+int g_Live = 0;
+
+struct Tracked
+{
+    explicit Tracked(int v) noexcept
+        : value(v)
+    {
+        ++g_Live;
+    }
+
+    ~Tracked()
+    {
+        value = -1;
+        --g_Live;
+    }
+
+    int value;
+};
+
+Tracked* NewTracked(int value)
+{
+    radtest::Mallocator alloc;
+    Tracked* obj =
+        rad::AllocTraits<radtest::Mallocator>::Alloc<Tracked>(alloc, 1);
+    return ::new (static_cast<void*>(obj)) Tracked(value);
+}
+} // namespace
+
+TEST(TestHazardPointer, Slots)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        rad::HazardDomain<radtest::CountingAllocator> domain;
+        rad::HazardPointer<radtest::CountingAllocator> empty;
+        EXPECT_FALSE(empty.IsValid());
+
+        auto first = domain.MakeHazardPointer();
+        ASSERT_TRUE(first.IsOk());
+        EXPECT_TRUE(first.Ok().IsValid());
+        {
+            auto second = domain.MakeHazardPointer();
+            ASSERT_TRUE(second.IsOk());
+            counter.VerifyCounts(2, 0);
+
+            empty = rad::Move(second.Ok());
+            EXPECT_TRUE(empty.IsValid());
+            EXPECT_FALSE(second.Ok().IsValid());
+        }
+
+        // slots of destroyed hazard pointers are reused
+        empty = rad::HazardPointer<radtest::CountingAllocator>();
+        auto third = domain.MakeHazardPointer();
+        ASSERT_TRUE(third.IsOk());
+        counter.VerifyCounts(2, 0);
+    }
+    counter.VerifyCounts(2, 2);
+    counter.VerifyCounts();
+
+    rad::HazardDomain<radtest::FailingAllocator> failing;
+    EXPECT_EQ(failing.MakeHazardPointer(), rad::Error::NoMemory);
+}
+
+TEST(TestHazardPointer, ProtectDefersFree)
+{
+    g_Live = 0;
+    radtest::Mallocator alloc;
+    Domain domain;
+    Hazard hazard = rad::Move(domain.MakeHazardPointer().Ok());
+
+    rad::Atomic<Tracked*> shared{ NewTracked(1) };
+    Tracked* protectedObj = hazard.Protect(shared);
+    EXPECT_EQ(protectedObj->value, 1);
+
+    Tracked* other = NewTracked(2);
+    EXPECT_TRUE(domain.Retire(shared.Exchange(nullptr, rad::MemOrderSeqCst),
+                              alloc)
+                    .IsOk());
+    EXPECT_TRUE(domain.Retire(other, alloc).IsOk());
+    EXPECT_TRUE(domain.Retire(static_cast<Tracked*>(nullptr), alloc).IsOk());
+    EXPECT_EQ(domain.RetiredCount(), 2u);
+
+    // only the unprotected object is freed
+    EXPECT_EQ(domain.Scan(), 1u);
+    EXPECT_EQ(domain.RetiredCount(), 1u);
+    EXPECT_EQ(g_Live, 1);
+    EXPECT_EQ(protectedObj->value, 1);
+
+    EXPECT_EQ(hazard.Protect(shared), nullptr);
+    EXPECT_EQ(domain.Scan(), 1u);
+    EXPECT_EQ(domain.RetiredCount(), 0u);
+    EXPECT_EQ(g_Live, 0);
+}
+
+TEST(TestHazardPointer, RetireScansAutomatically)
+{
+    g_Live = 0;
+    radtest::Mallocator alloc;
+    {
+        Domain domain;
+        Hazard hazard = rad::Move(domain.MakeHazardPointer().Ok());
+        rad::Atomic<Tracked*> shared{ NewTracked(-2) };
+        Tracked* kept = hazard.Protect(shared);
+        EXPECT_TRUE(domain.Retire(kept, alloc).IsOk());
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            EXPECT_TRUE(domain.Retire(NewTracked(i), alloc).IsOk());
+        }
+
+        const size_t threshold = Domain::ScanThreshold;
+        EXPECT_LT(domain.RetiredCount(), threshold);
+        EXPECT_EQ(kept->value, -2);
+
+        // the protected object is freed with the domain
+        hazard.Reset();
+    }
+    EXPECT_EQ(g_Live, 0);
+}
+
+TEST(TestHazardPointer, ProtectedObjectsDelayScans)
+{
+    static constexpr int Protected = 100;
+
+    g_Live = 0;
+    radtest::Mallocator alloc;
+    {
+        Domain domain;
+        Hazard hazards[Protected];
+        for (Hazard& hazard : hazards)
+        {
+            hazard = rad::Move(domain.MakeHazardPointer().Ok());
+            rad::Atomic<Tracked*> shared{ NewTracked(0) };
+            EXPECT_TRUE(domain.Retire(hazard.Protect(shared), alloc).IsOk());
+        }
+
+        EXPECT_EQ(domain.Scan(), 0u);
+        EXPECT_EQ(domain.RetiredCount(), size_t{ Protected });
+
+        // the next scan waits for twice as many objects as there are slots
+        for (int i = 1; i < 2 * Protected; ++i)
+        {
+            EXPECT_TRUE(domain.Retire(NewTracked(i), alloc).IsOk());
+        }
+
+        EXPECT_EQ(domain.RetiredCount(), size_t{ 3 * Protected - 1 });
+        EXPECT_TRUE(domain.Retire(NewTracked(0), alloc).IsOk());
+        EXPECT_EQ(domain.RetiredCount(), size_t{ Protected });
+        EXPECT_EQ(g_Live, Protected);
+
+        for (Hazard& hazard : hazards)
+        {
+            hazard.Reset();
+        }
+
+        EXPECT_EQ(domain.Scan(), size_t{ Protected });
+    }
+    EXPECT_EQ(g_Live, 0);
+}
+
+TEST(TestHazardPointer, StalledReaderDoesNotBlock)
+{
+    g_Live = 0;
+    radtest::Mallocator alloc;
+    Domain domain;
+    Hazard stalled = rad::Move(domain.MakeHazardPointer().Ok());
+    rad::Atomic<Tracked*> shared{ NewTracked(0) };
+    Tracked* held = stalled.Protect(shared);
+
+    // a reader that never lets go only keeps its own object alive
+    for (int i = 1; i <= 1000; ++i)
+    {
+        Tracked* old = shared.Exchange(NewTracked(i), rad::MemOrderSeqCst);
+        EXPECT_TRUE(domain.Retire(old, alloc).IsOk());
+    }
+    domain.Scan();
+    EXPECT_EQ(domain.RetiredCount(), 1u);
+    EXPECT_EQ(held->value, 0);
+    EXPECT_EQ(g_Live, 2);
+
+    stalled.Reset();
+    EXPECT_EQ(domain.Scan(), 1u);
+    EXPECT_TRUE(
+        domain.Retire(shared.Exchange(nullptr, rad::MemOrderSeqCst), alloc)
+            .IsOk());
+    EXPECT_EQ(domain.Scan(), 1u);
+    EXPECT_EQ(g_Live, 0);
+}
+
+TEST(TestHazardPointer, Concurrent)
+{
+    static constexpr int ReaderCount = 3;
+    static constexpr int Swaps = 20000;
+
+    g_Live = 0;
+    radtest::Mallocator alloc;
+    {
+        Domain domain;
+        rad::Atomic<Tracked*> shared{ NewTracked(0) };
+        rad::Atomic<int> done{ 0 };
+
+        std::thread readers[ReaderCount];
+        for (auto& reader : readers)
+        {
+            reader = std::thread(
+                [&]
+                {
+                    auto hazard = domain.MakeHazardPointer();
+                    ASSERT_TRUE(hazard.IsOk());
+                    int last = 0;
+                    while (done.Load(rad::MemOrderAcquire) == 0)
+                    {
+                        const int value = hazard.Ok().Protect(shared)->value;
+                        EXPECT_GE(value, last);
+                        last = value;
+                        std::this_thread::yield();
+                    }
+                });
+        }
+
+        for (int i = 1; i <= Swaps; ++i)
+        {
+            Tracked* old = shared.Exchange(NewTracked(i), rad::MemOrderSeqCst);
+            EXPECT_TRUE(domain.Retire(old, alloc).IsOk());
+            if (i % 64 == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        done.Store(1, rad::MemOrderRelease);
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+
+        EXPECT_TRUE(
+            domain.Retire(shared.Load(rad::MemOrderRelaxed), alloc).IsOk());
+    }
+    EXPECT_EQ(g_Live, 0);
+}
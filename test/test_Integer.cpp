@@ -16,6 +16,9 @@
 
 #include "radiant/Integer.h"
 
+#include <algorithm>
+#include <vector>
+
 // clang-format off
 
 RAD_S_ASSERT(noexcept(rad::i8()));
@@ -1176,3 +1179,248 @@ TEST(IntegerTests, u32_Compare)
     EXPECT_TRUE(rad::u32(2) > static_cast<unsigned int>(1));
     EXPECT_TRUE(rad::u32(2) >= static_cast<unsigned int>(1));
 }
+
+namespace
+{
+
+template <typename T>
+void VerifyLanesExhaustive()
+{
+    using Traits = rad::IntegerTraits<T>;
+    const int min = Traits::MIN;
+    const int max = Traits::MAX;
+
+    // every pair of operands, laid out so the spans cover full blocks and a
+    // partial one
+    std::vector<T> lhs;
+    std::vector<T> rhs;
+    for (int l = min; l <= max; ++l)
+    {
+        for (int r = min; r <= max; ++r)
+        {
+            lhs.push_back(static_cast<T>(l));
+            rhs.push_back(static_cast<T>(r));
+        }
+    }
+
+    const auto count = static_cast<uint32_t>(lhs.size());
+    rad::Span<const T> left(lhs.data(), count);
+    rad::Span<const T> right(rhs.data(), count);
+    std::vector<T> sum(count);
+    std::vector<T> diff(count);
+    std::vector<T> prod(count);
+    rad::SaturatingAdd(left, right, rad::Span<T>(sum.data(), count));
+    rad::SaturatingSub(left, right, rad::Span<T>(diff.data(), count));
+    rad::SaturatingMul(left, right, rad::Span<T>(prod.data(), count));
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const int l = lhs[i];
+        const int r = rhs[i];
+        const auto clamp = [&](int value)
+        {
+            return static_cast<T>(value < min ? min
+                                              : (value > max ? max : value));
+        };
+
+        ASSERT_EQ(Traits::Add(lhs[i], rhs[i]).IsOk(), clamp(l + r) == l + r);
+        ASSERT_EQ(Traits::Sub(lhs[i], rhs[i]).IsOk(), clamp(l - r) == l - r);
+        ASSERT_EQ(Traits::Mul(lhs[i], rhs[i]).IsOk(), clamp(l * r) == l * r);
+        ASSERT_EQ(sum[i], clamp(l + r));
+        ASSERT_EQ(diff[i], clamp(l - r));
+        ASSERT_EQ(prod[i], clamp(l * r));
+    }
+}
+
+template <typename T>
+void VerifyCheckedEdges()
+{
+    using Traits = rad::IntegerTraits<T>;
+    const T min = Traits::MIN;
+    const T max = Traits::MAX;
+    const T edges[] = { min,
+                        static_cast<T>(min + 1),
+                        static_cast<T>(min / 2),
+                        static_cast<T>(-1),
+                        0,
+                        1,
+                        2,
+                        static_cast<T>(max / 2),
+                        static_cast<T>(max / 2 + 1),
+                        static_cast<T>(max - 1),
+                        max };
+
+    for (T l : edges)
+    {
+        for (T r : edges)
+        {
+            T out = 7;
+            const auto add = rad::AddChecked(rad::Span<const T>(&l, 1),
+                                             rad::Span<const T>(&r, 1),
+                                             rad::Span<T>(&out, 1));
+            ASSERT_EQ(add == 0, Traits::Add(l, r).IsErr());
+            ASSERT_EQ(out, add == 0 ? 7 : Traits::Add(l, r).Ok());
+
+            out = 7;
+            const auto sub = rad::SubChecked(rad::Span<const T>(&l, 1),
+                                             rad::Span<const T>(&r, 1),
+                                             rad::Span<T>(&out, 1));
+            ASSERT_EQ(sub == 0, Traits::Sub(l, r).IsErr());
+            ASSERT_EQ(out, sub == 0 ? 7 : Traits::Sub(l, r).Ok());
+
+            out = 7;
+            const auto mul = rad::MulChecked(rad::Span<const T>(&l, 1),
+                                             rad::Span<const T>(&r, 1),
+                                             rad::Span<T>(&out, 1));
+            ASSERT_EQ(mul == 0, Traits::Mul(l, r).IsErr());
+            ASSERT_EQ(out, mul == 0 ? 7 : Traits::Mul(l, r).Ok());
+
+            out = 7;
+            rad::SaturatingAdd(rad::Span<const T>(&l, 1),
+                               rad::Span<const T>(&r, 1),
+                               rad::Span<T>(&out, 1));
+            ASSERT_EQ(out, Traits::SaturatingAdd(l, r));
+            rad::SaturatingSub(rad::Span<const T>(&l, 1),
+                               rad::Span<const T>(&r, 1),
+                               rad::Span<T>(&out, 1));
+            ASSERT_EQ(out, Traits::SaturatingSub(l, r));
+            rad::SaturatingMul(rad::Span<const T>(&l, 1),
+                               rad::Span<const T>(&r, 1),
+                               rad::Span<T>(&out, 1));
+            ASSERT_EQ(out, Traits::SaturatingMul(l, r));
+        }
+    }
+}
+
+} // namespace
+
+TEST(IntegerTests, SpanLanesExhaustive)
+{
+    VerifyLanesExhaustive<int8_t>();
+    VerifyLanesExhaustive<uint8_t>();
+}
+
+TEST(IntegerTests, SpanCheckedEdges)
+{
+    VerifyCheckedEdges<int8_t>();
+    VerifyCheckedEdges<uint8_t>();
+    VerifyCheckedEdges<int16_t>();
+    VerifyCheckedEdges<uint16_t>();
+    VerifyCheckedEdges<int32_t>();
+    VerifyCheckedEdges<uint32_t>();
+}
+
+TEST(IntegerTests, AddCheckedFirstOverflow)
+{
+    const uint32_t count = 300;
+    std::vector<uint32_t> lhs(count, 1);
+    std::vector<uint32_t> rhs(count, 2);
+    std::vector<uint32_t> out(count, 0);
+    rad::Span<const uint32_t> left(lhs.data(), count);
+    rad::Span<const uint32_t> right(rhs.data(), count);
+    rad::Span<uint32_t> dest(out.data(), count);
+
+    EXPECT_EQ(rad::AddChecked(left, right, dest), count);
+    for (uint32_t value : out)
+    {
+        EXPECT_EQ(value, 3u);
+    }
+
+    // an overflow inside a full block, a second one later on
+    lhs[130] = UINT32_MAX;
+    lhs[290] = UINT32_MAX;
+    std::fill(out.begin(), out.end(), 0u);
+    EXPECT_EQ(rad::AddChecked(left, right, dest), 130u);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(out[i], i < 130 ? 3u : 0u);
+    }
+
+    // an overflow in the final partial block
+    lhs[130] = 1;
+    EXPECT_EQ(rad::AddChecked(left, right, dest), 290u);
+    EXPECT_EQ(out[289], 3u);
+    EXPECT_EQ(out[290], 0u);
+
+    EXPECT_EQ(rad::AddChecked(rad::Span<const uint32_t>(),
+                              rad::Span<const uint32_t>(),
+                              rad::Span<uint32_t>()),
+              0u);
+}
+
+TEST(IntegerTests, CheckedAccumulateInPlace)
+{
+    const uint32_t count = 200;
+    std::vector<int32_t> acc(count, 0);
+    std::vector<int32_t> step(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        step[i] = static_cast<int32_t>(i) - 100;
+    }
+
+    rad::Span<int32_t> total(acc.data(), count);
+    rad::Span<const int32_t> delta(step.data(), count);
+    for (int round = 0; round < 3; ++round)
+    {
+        ASSERT_EQ(rad::AddChecked<int32_t>(total, delta, total), count);
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(acc[i], 3 * step[i]);
+    }
+
+    // an overflow leaves the overflowing element and the rest untouched
+    acc[150] = INT32_MAX;
+    EXPECT_EQ(rad::AddChecked<int32_t>(total, delta, total), 150u);
+    EXPECT_EQ(acc[149], 4 * step[149]);
+    EXPECT_EQ(acc[150], INT32_MAX);
+    EXPECT_EQ(acc[151], 3 * step[151]);
+
+    EXPECT_EQ(rad::SubChecked<int32_t>(total, delta, total), count);
+    EXPECT_EQ(acc[149], 3 * step[149]);
+    EXPECT_EQ(acc[150], INT32_MAX - step[150]);
+
+    std::vector<int16_t> wide(count, 300);
+    rad::Span<int16_t> grow(wide.data(), count);
+    EXPECT_EQ(rad::MulChecked<int16_t>(grow, grow, grow), 0u);
+    EXPECT_EQ(wide[0], 300);
+}
+
+TEST(IntegerTests, SaturatingSpans)
+{
+    const uint32_t count = 150;
+    std::vector<uint16_t> lhs(count);
+    std::vector<uint16_t> rhs(count, 6000);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        lhs[i] = static_cast<uint16_t>(i * 400);
+    }
+
+    std::vector<uint16_t> out(count);
+    rad::Span<const uint16_t> left(lhs.data(), count);
+    rad::Span<const uint16_t> right(rhs.data(), count);
+    rad::Span<uint16_t> dest(out.data(), count);
+
+    rad::SaturatingAdd(left, right, dest);
+    EXPECT_EQ(out[0], 6000u);
+    EXPECT_EQ(out[100], 46000u);
+    EXPECT_EQ(out[148], 65200u);
+    EXPECT_EQ(out[149], UINT16_MAX);
+
+    rad::SaturatingSub(left, right, dest);
+    EXPECT_EQ(out[0], 0u);
+    EXPECT_EQ(out[14], 0u);
+    EXPECT_EQ(out[15], 0u);
+    EXPECT_EQ(out[16], 400u);
+
+    rad::SaturatingMul(left, right, dest);
+    EXPECT_EQ(out[0], 0u);
+    EXPECT_EQ(out[1], UINT16_MAX);
+
+    std::vector<int8_t> bytes(count, 100);
+    rad::Span<int8_t> inPlace(bytes.data(), count);
+    rad::SaturatingAdd<int8_t>(inPlace, inPlace, inPlace);
+    EXPECT_EQ(bytes[0], INT8_MAX);
+    EXPECT_EQ(bytes[149], INT8_MAX);
+}
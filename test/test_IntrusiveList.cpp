@@ -0,0 +1,265 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/IntrusiveList.h"
+
+#include <initializer_list>
+
+namespace
+{
+struct Connection
+{
+    Connection(int i) noexcept
+        : id(i)
+    {
+    }
+
+    int id;
+    rad::IntrusiveListHook idleHook;
+    double padding = 0;
+    rad::IntrusiveListHook timerHook;
+};
+
+using IdleList = rad::IntrusiveList<Connection, &Connection::idleHook>;
+using TimerList = rad::IntrusiveList<Connection, &Connection::timerHook>;
+
+template <typename TList>
+void ExpectIds(const TList& list, std::initializer_list<int> ids)
+{
+    EXPECT_EQ(list.ExpensiveSize(), ids.size());
+    EXPECT_EQ(list.Empty(), ids.size() == 0);
+    auto it = list.begin();
+    for (int id : ids)
+    {
+        ASSERT_NE(it, list.end());
+        EXPECT_EQ(it->id, id);
+        ++it;
+    }
+
+    EXPECT_EQ(it, list.end());
+}
+
+} // namespace
+
+TEST(IntrusiveListTest, Empty)
+{
+    IdleList list;
+    EXPECT_TRUE(list.Empty());
+    EXPECT_EQ(list.ExpensiveSize(), 0u);
+    EXPECT_EQ(list.begin(), list.end());
+    EXPECT_EQ(list.cbegin(), list.cend());
+
+    rad::IntrusiveListHook hook;
+    EXPECT_FALSE(hook.IsLinked());
+    hook.Unlink();
+    EXPECT_FALSE(hook.IsLinked());
+}
+
+TEST(IntrusiveListTest, PushPop)
+{
+    Connection a(1);
+    Connection b(2);
+    Connection c(3);
+
+    IdleList list;
+    list.PushBack(b).PushFront(a).PushBack(c);
+    ExpectIds(list, { 1, 2, 3 });
+    EXPECT_EQ(&list.Front(), &a);
+    EXPECT_EQ(&list.Back(), &c);
+    EXPECT_TRUE(a.idleHook.IsLinked());
+    EXPECT_FALSE(a.timerHook.IsLinked());
+
+    list.PopFront();
+    ExpectIds(list, { 2, 3 });
+    EXPECT_FALSE(a.idleHook.IsLinked());
+
+    list.PopBack();
+    ExpectIds(list, { 2 });
+    EXPECT_FALSE(c.idleHook.IsLinked());
+
+    list.PopBack();
+    ExpectIds(list, {});
+}
+
+TEST(IntrusiveListTest, SeveralLists)
+{
+    Connection conns[4] = { { 0 }, { 1 }, { 2 }, { 3 } };
+
+    IdleList idle;
+    TimerList timers;
+    for (Connection& conn : conns)
+    {
+        idle.PushBack(conn);
+        timers.PushFront(conn);
+    }
+
+    ExpectIds(idle, { 0, 1, 2, 3 });
+    ExpectIds(timers, { 3, 2, 1, 0 });
+
+    // unlinking from one list leaves the other alone
+    conns[1].idleHook.Unlink();
+    conns[2].timerHook.Unlink();
+    ExpectIds(idle, { 0, 2, 3 });
+    ExpectIds(timers, { 3, 1, 0 });
+}
+
+TEST(IntrusiveListTest, SelfUnlinkOnDestroy)
+{
+    Connection a(1);
+    IdleList list;
+    list.PushBack(a);
+    {
+        Connection b(2);
+        list.PushBack(b);
+        {
+            Connection c(3);
+            list.PushFront(c);
+            ExpectIds(list, { 3, 1, 2 });
+        }
+
+        ExpectIds(list, { 1, 2 });
+    }
+
+    ExpectIds(list, { 1 });
+}
+
+TEST(IntrusiveListTest, ListDestroyedFirst)
+{
+    Connection a(1);
+    Connection b(2);
+    {
+        IdleList list;
+        list.PushBack(a).PushBack(b);
+    }
+
+    EXPECT_FALSE(a.idleHook.IsLinked());
+    EXPECT_FALSE(b.idleHook.IsLinked());
+
+    IdleList list;
+    list.PushBack(a).PushBack(b);
+    list.Clear();
+    EXPECT_TRUE(list.Empty());
+    EXPECT_FALSE(a.idleHook.IsLinked());
+    EXPECT_FALSE(b.idleHook.IsLinked());
+}
+
+TEST(IntrusiveListTest, InsertErase)
+{
+    Connection conns[5] = { { 0 }, { 1 }, { 2 }, { 3 }, { 4 } };
+
+    IdleList list;
+    list.PushBack(conns[0]).PushBack(conns[4]);
+    auto it = list.Insert(list.IteratorTo(conns[4]), conns[2]);
+    EXPECT_EQ(&*it, &conns[2]);
+    list.Insert(it, conns[1]);
+    list.Insert(list.IteratorTo(conns[4]), conns[3]);
+    ExpectIds(list, { 0, 1, 2, 3, 4 });
+
+    it = list.EraseOne(list.IteratorTo(conns[1]));
+    EXPECT_EQ(it->id, 2);
+    EXPECT_EQ(list.EraseOne(list.end()), list.end());
+    ExpectIds(list, { 0, 2, 3, 4 });
+
+    it = list.EraseSome(it, list.IteratorTo(conns[4]));
+    EXPECT_EQ(it->id, 4);
+    ExpectIds(list, { 0, 4 });
+    EXPECT_FALSE(conns[2].idleHook.IsLinked());
+    EXPECT_FALSE(conns[3].idleHook.IsLinked());
+
+    list.PushBack(conns[1]).PushBack(conns[2]).PushBack(conns[3]);
+    EXPECT_EQ(list.EraseIf([](const Connection& c) { return c.id % 2 == 1; }),
+              2u);
+    ExpectIds(list, { 0, 4, 2 });
+}
+
+TEST(IntrusiveListTest, Iterators)
+{
+    Connection a(1);
+    Connection b(2);
+    IdleList list;
+    list.PushBack(a).PushBack(b);
+
+    auto it = list.end();
+    --it;
+    EXPECT_EQ(it->id, 2);
+    it--;
+    EXPECT_EQ(it->id, 1);
+    EXPECT_EQ(it++, list.begin());
+
+    for (Connection& conn : list)
+    {
+        conn.id *= 10;
+    }
+
+    const IdleList& clist = list;
+    IdleList::ConstIteratorType cit = list.begin();
+    EXPECT_EQ(cit, clist.begin());
+    EXPECT_EQ(cit->id, 10);
+    ExpectIds(clist, { 10, 20 });
+}
+
+TEST(IntrusiveListTest, SpliceSwapReverse)
+{
+    Connection conns[4] = { { 0 }, { 1 }, { 2 }, { 3 } };
+
+    IdleList first;
+    IdleList second;
+    first.PushBack(conns[0]).PushBack(conns[1]);
+    second.PushBack(conns[2]).PushBack(conns[3]);
+
+    first.SpliceAll(first.end(), second);
+    ExpectIds(first, { 0, 1, 2, 3 });
+    ExpectIds(second, {});
+
+    second.SpliceOne(second.end(), first, first.IteratorTo(conns[1]));
+    ExpectIds(first, { 0, 2, 3 });
+    ExpectIds(second, { 1 });
+
+    first.Swap(second);
+    ExpectIds(first, { 1 });
+    ExpectIds(second, { 0, 2, 3 });
+
+    second.Reverse();
+    ExpectIds(second, { 3, 2, 0 });
+
+    IdleList empty;
+    first.Swap(empty);
+    ExpectIds(first, {});
+    ExpectIds(empty, { 1 });
+}
+
+TEST(IntrusiveListTest, Move)
+{
+    Connection a(1);
+    Connection b(2);
+    Connection c(3);
+    IdleList list;
+    list.PushBack(a).PushBack(b);
+
+    IdleList moved(rad::Move(list));
+    ExpectIds(list, {});
+    ExpectIds(moved, { 1, 2 });
+
+    IdleList other;
+    other.PushBack(c);
+    other = rad::Move(moved);
+    ExpectIds(other, { 1, 2 });
+    ExpectIds(moved, {});
+    EXPECT_FALSE(c.idleHook.IsLinked());
+
+    a.idleHook.Unlink();
+    ExpectIds(other, { 2 });
+}
@@ -0,0 +1,220 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/IntrusivePtr.h"
+#include "radiant/SharedPtr.h"
+
+#include "test/TestAlloc.h"
+
+namespace
+{
+int g_Destroyed = 0;
+
+class Node : public rad::RefCounted<Node>
+{
+public:
+
+    explicit Node(int v) noexcept
+        : value(v)
+    {
+    }
+
+    virtual ~Node()
+    {
+        ++g_Destroyed;
+    }
+
+    static Node* Create(int v)
+    {
+        void* mem = radtest::Mallocator::AllocBytes(sizeof(Node));
+        return mem ? ::new (mem) Node(v) : nullptr;
+    }
+
+    void OnRefZero() const noexcept
+    {
+        Node* self = const_cast<Node*>(this);
+        self->~Node();
+        radtest::Mallocator::FreeBytes(self, sizeof(Node));
+    }
+
+    int value;
+};
+
+class DerivedNode : public Node
+{
+public:
+
+    explicit DerivedNode(int v) noexcept
+        : Node(v)
+    {
+    }
+
+    static DerivedNode* Create(int v)
+    {
+        void* mem = radtest::Mallocator::AllocBytes(sizeof(DerivedNode));
+        return mem ? ::new (mem) DerivedNode(v) : nullptr;
+    }
+};
+
+class LocalNode
+    : public rad::RefCounted<LocalNode, rad::detail::LocalCounter<uint32_t>>
+{
+public:
+
+    void OnRefZero() const noexcept
+    {
+        ++g_Destroyed;
+    }
+};
+} // namespace
+
+RAD_S_ASSERT(sizeof(rad::IntrusivePtr<Node>) == sizeof(void*));
+RAD_S_ASSERT(rad::IsTrivRelocatable<rad::IntrusivePtr<Node>>);
+RAD_S_ASSERT(!(rad::IsConv<Node*, rad::IntrusivePtr<Node>>));
+RAD_S_ASSERT(sizeof(LocalNode) == sizeof(uint32_t));
+
+TEST(TestIntrusivePtr, Empty)
+{
+    rad::IntrusivePtr<Node> ptr;
+    EXPECT_EQ(ptr, nullptr);
+    EXPECT_EQ(nullptr, ptr);
+    EXPECT_FALSE(ptr);
+    EXPECT_EQ(ptr.Get(), nullptr);
+
+    rad::IntrusivePtr<Node> ptrTwo(nullptr);
+    EXPECT_EQ(ptr, ptrTwo);
+    ptr.Reset();
+
+    rad::IntrusivePtr<Node> ptrThree(static_cast<Node*>(nullptr));
+    EXPECT_EQ(ptrThree, nullptr);
+}
+
+TEST(TestIntrusivePtr, Lifetime)
+{
+    g_Destroyed = 0;
+    {
+        rad::IntrusivePtr<Node> ptr(Node::Create(5));
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_NE(nullptr, ptr);
+        EXPECT_EQ(ptr->value, 5);
+        EXPECT_EQ((*ptr).value, 5);
+        EXPECT_EQ(ptr->UseCount(), 1u);
+
+        rad::IntrusivePtr<Node> copy(ptr);
+        EXPECT_EQ(copy, ptr);
+        EXPECT_EQ(ptr->UseCount(), 2u);
+
+        rad::IntrusivePtr<Node> moved(rad::Move(copy));
+        EXPECT_EQ(copy, nullptr);
+        EXPECT_EQ(ptr->UseCount(), 2u);
+
+        // a raw pointer can be rewrapped since the count lives in the object
+        rad::IntrusivePtr<Node> rewrapped(moved.Get());
+        EXPECT_EQ(ptr->UseCount(), 3u);
+
+        moved.Reset();
+        rewrapped = nullptr;
+        EXPECT_EQ(ptr->UseCount(), 1u);
+        EXPECT_EQ(g_Destroyed, 0);
+    }
+    EXPECT_EQ(g_Destroyed, 1);
+}
+
+TEST(TestIntrusivePtr, Assign)
+{
+    g_Destroyed = 0;
+    {
+        rad::IntrusivePtr<Node> first(Node::Create(1));
+        rad::IntrusivePtr<Node> second(Node::Create(2));
+
+        first = second;
+        EXPECT_EQ(g_Destroyed, 1);
+        EXPECT_EQ(first->value, 2);
+        EXPECT_EQ(second->UseCount(), 2u);
+
+        const auto& alias = first;
+        first = alias;
+        EXPECT_EQ(second->UseCount(), 2u);
+
+        first = rad::Move(second);
+        EXPECT_EQ(second, nullptr);
+        EXPECT_EQ(first->UseCount(), 1u);
+
+        first.Reset(Node::Create(3));
+        EXPECT_EQ(g_Destroyed, 2);
+        EXPECT_EQ(first->value, 3);
+    }
+    EXPECT_EQ(g_Destroyed, 3);
+}
+
+TEST(TestIntrusivePtr, Convert)
+{
+    g_Destroyed = 0;
+    {
+        rad::IntrusivePtr<DerivedNode> derived(DerivedNode::Create(4));
+        ASSERT_NE(derived, nullptr);
+
+        rad::IntrusivePtr<Node> base(derived);
+        EXPECT_EQ(base.Get(), derived.Get());
+        EXPECT_EQ(base->UseCount(), 2u);
+
+        base = derived;
+        EXPECT_EQ(base->UseCount(), 2u);
+
+        rad::IntrusivePtr<Node> moved(rad::Move(derived));
+        EXPECT_EQ(derived, nullptr);
+        EXPECT_EQ(moved, base);
+        EXPECT_EQ(base->UseCount(), 2u);
+    }
+    EXPECT_EQ(g_Destroyed, 1);
+}
+
+TEST(TestIntrusivePtr, DetachSwap)
+{
+    g_Destroyed = 0;
+    {
+        rad::IntrusivePtr<Node> first(Node::Create(1));
+        rad::IntrusivePtr<Node> second;
+
+        first.Swap(second);
+        EXPECT_EQ(first, nullptr);
+        ASSERT_NE(second, nullptr);
+        EXPECT_EQ(second->value, 1);
+
+        Node* raw = second.Detach();
+        EXPECT_EQ(second, nullptr);
+        EXPECT_EQ(raw->UseCount(), 1u);
+        EXPECT_EQ(g_Destroyed, 0);
+
+        raw->Release();
+        EXPECT_EQ(g_Destroyed, 1);
+    }
+    EXPECT_EQ(g_Destroyed, 1);
+}
+
+TEST(TestIntrusivePtr, LocalCounter)
+{
+    g_Destroyed = 0;
+
+    LocalNode node;
+    {
+        rad::IntrusivePtr<LocalNode> ptr(&node);
+        rad::IntrusivePtr<LocalNode> copy = ptr;
+        EXPECT_EQ(node.UseCount(), 2u);
+    }
+    EXPECT_EQ(node.UseCount(), 0u);
+    EXPECT_EQ(g_Destroyed, 1);
+}
@@ -0,0 +1,411 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "gtest/gtest.h"
+
+#include "radiant/IoBufferChain.h"
+
+#include "test/TestAlloc.h"
+
+#include <string.h>
+
+#include <string>
+
+#if !RAD_WINDOWS
+#include <unistd.h>
+#endif
+
+namespace
+{
+using Chain = rad::IoBufferChain<radtest::Mallocator, 8>;
+using CountingChain = rad::IoBufferChain<radtest::CountingAllocator, 8>;
+
+rad::Span<const rad::Byte> Bytes(const char* str)
+{
+    return rad::Span<const rad::Byte>(
+        reinterpret_cast<const rad::Byte*>(str),
+        static_cast<rad::SpanSizeType>(strlen(str)));
+}
+
+template <typename T>
+std::string Contents(const T& chain)
+{
+    std::string result(chain.Size(), '\0');
+    rad::Span<rad::Byte> out(reinterpret_cast<rad::Byte*>(&result[0]),
+                             static_cast<rad::SpanSizeType>(result.size()));
+    EXPECT_EQ(chain.CopyTo(out), chain.Size());
+    return result;
+}
+
+size_t IoVecSize(const rad::IoVec& vec)
+{
+#if RAD_WINDOWS
+    return vec.len;
+#else
+    return vec.iov_len;
+#endif
+}
+
+void* IoVecData(const rad::IoVec& vec)
+{
+#if RAD_WINDOWS
+    return vec.buf;
+#else
+    return vec.iov_base;
+#endif
+}
+
+} // namespace
+
+TEST(TestIoBufferChain, DefaultConstruct)
+{
+    Chain chain;
+    EXPECT_TRUE(chain.Empty());
+    EXPECT_EQ(chain.Size(), 0u);
+    EXPECT_EQ(chain.SliceCount(), 0u);
+
+    rad::IoVec vecs[2];
+    EXPECT_EQ(chain.ExportIo(vecs), 0u);
+}
+
+TEST(TestIoBufferChain, Append)
+{
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+    {
+        CountingChain chain;
+        ASSERT_TRUE(chain.Append(Bytes("hello")).IsOk());
+        EXPECT_EQ(chain.Size(), 5u);
+        EXPECT_EQ(chain.SliceCount(), 1u);
+
+        // fills the first segment before starting another
+        ASSERT_TRUE(chain.Append(Bytes(" world, again")).IsOk());
+        EXPECT_EQ(chain.Size(), 18u);
+        EXPECT_EQ(chain.SliceCount(), 3u);
+        EXPECT_EQ(chain.SliceAt(0).Size(), 8u);
+        EXPECT_EQ(chain.SliceAt(1).Size(), 8u);
+        EXPECT_EQ(chain.SliceAt(2).Size(), 2u);
+        EXPECT_EQ(Contents(chain), "hello world, again");
+
+        ASSERT_TRUE(chain.Append(rad::Span<const rad::Byte>()).IsOk());
+        EXPECT_EQ(chain.Size(), 18u);
+    }
+
+    alloc.VerifyCounts();
+}
+
+TEST(TestIoBufferChain, Prepend)
+{
+    Chain chain;
+    ASSERT_TRUE(chain.Append(Bytes("payload")).IsOk());
+
+    // the head segment has no headroom, so the header gets its own
+    ASSERT_TRUE(chain.Prepend(Bytes("hdr:")).IsOk());
+    EXPECT_EQ(chain.SliceCount(), 2u);
+    EXPECT_EQ(Contents(chain), "hdr:payload");
+
+    // the new head has headroom from being filled from its end
+    ASSERT_TRUE(chain.Prepend(Bytes("v1/")).IsOk());
+    EXPECT_EQ(chain.SliceCount(), 2u);
+    EXPECT_EQ(chain.SliceAt(0).Size(), 7u);
+    EXPECT_EQ(Contents(chain), "v1/hdr:payload");
+
+    ASSERT_TRUE(chain.Prepend(Bytes("a long prefix ")).IsOk());
+    EXPECT_EQ(chain.Size(), 28u);
+    EXPECT_EQ(Contents(chain), "a long prefix v1/hdr:payload");
+}
+
+TEST(TestIoBufferChain, ConsumeTruncate)
+{
+    Chain chain;
+    ASSERT_TRUE(chain.Append(Bytes("0123456789abcdefghij")).IsOk());
+
+    chain.Consume(3);
+    EXPECT_EQ(Contents(chain), "3456789abcdefghij");
+    chain.Consume(5);
+    EXPECT_EQ(chain.SliceCount(), 2u);
+    EXPECT_EQ(Contents(chain), "89abcdefghij");
+
+    chain.Truncate(7);
+    EXPECT_EQ(Contents(chain), "89abcde");
+    chain.Truncate(0);
+    EXPECT_TRUE(chain.Empty());
+    EXPECT_EQ(chain.SliceCount(), 0u);
+
+    ASSERT_TRUE(chain.Append(Bytes("xyz")).IsOk());
+    chain.Consume(3);
+    EXPECT_TRUE(chain.Empty());
+}
+
+TEST(TestIoBufferChain, CopyTo)
+{
+    Chain chain;
+    ASSERT_TRUE(chain.Append(Bytes("0123456789abcdefghij")).IsOk());
+
+    char out[6] = {};
+    rad::Span<rad::Byte> span(reinterpret_cast<rad::Byte*>(out), 5);
+    EXPECT_EQ(chain.CopyTo(span, 6), 5u);
+    EXPECT_STREQ(out, "6789a");
+    EXPECT_EQ(chain.CopyTo(span, 17), 3u);
+    EXPECT_EQ(memcmp(out, "hij", 3), 0);
+    EXPECT_EQ(chain.CopyTo(span, 20), 0u);
+}
+
+TEST(TestIoBufferChain, Share)
+{
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+    {
+        CountingChain chain;
+        ASSERT_TRUE(chain.Append(Bytes("0123456789abc")).IsOk());
+        const uint32_t allocs = alloc.AllocCount();
+
+        auto slice = chain.Slice(6, 5);
+        ASSERT_TRUE(slice.IsOk());
+        EXPECT_EQ(Contents(slice.Ok()), "6789a");
+        EXPECT_EQ(slice.Ok().SliceCount(), 2u);
+
+        EXPECT_EQ(chain.Slice(10, 4).Err(), rad::Error::OutOfRange);
+        EXPECT_EQ(chain.Slice(14, 0).Err(), rad::Error::OutOfRange);
+        EXPECT_TRUE(chain.Slice(13, 0).Ok().Empty());
+
+        // shared segments are not written in place
+        ASSERT_TRUE(slice.Ok().Append(Bytes("!")).IsOk());
+        ASSERT_TRUE(chain.Append(Bytes("?")).IsOk());
+        EXPECT_EQ(Contents(slice.Ok()), "6789a!");
+        EXPECT_EQ(Contents(chain), "0123456789abc?");
+
+        CountingChain other;
+        ASSERT_TRUE(other.Append(Bytes("<")).IsOk());
+        ASSERT_TRUE(other.AppendShared(chain).IsOk());
+        EXPECT_EQ(Contents(other), "<0123456789abc?");
+
+        // segments outlive the chain they were created in
+        chain.Clear();
+        EXPECT_EQ(Contents(other), "<0123456789abc?");
+        EXPECT_EQ(Contents(slice.Ok()), "6789a!");
+        EXPECT_GT(alloc.AllocCount(), allocs);
+    }
+
+    alloc.VerifyCounts();
+}
+
+TEST(TestIoBufferChain, AppendMove)
+{
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+    {
+        CountingChain head;
+        CountingChain body;
+        ASSERT_TRUE(body.Append(Bytes("body bytes")).IsOk());
+        ASSERT_TRUE(head.Append(Bytes("head:")).IsOk());
+
+        const uint32_t allocs = alloc.AllocCount();
+        ASSERT_TRUE(head.Append(rad::Move(body)).IsOk());
+        EXPECT_TRUE(body.Empty());
+        EXPECT_EQ(Contents(head), "head:body bytes");
+        EXPECT_EQ(alloc.AllocCount(), allocs);
+
+        CountingChain empty;
+        ASSERT_TRUE(empty.Append(rad::Move(head)).IsOk());
+        EXPECT_TRUE(head.Empty());
+        EXPECT_EQ(Contents(empty), "head:body bytes");
+
+        CountingChain moved(rad::Move(empty));
+        EXPECT_TRUE(empty.Empty());
+        EXPECT_EQ(Contents(moved), "head:body bytes");
+
+        head = rad::Move(moved);
+        EXPECT_EQ(Contents(head), "head:body bytes");
+
+        head.Swap(body);
+        EXPECT_TRUE(head.Empty());
+        EXPECT_EQ(body.Size(), 15u);
+    }
+
+    alloc.VerifyCounts();
+}
+
+TEST(TestIoBufferChain, ExportIo)
+{
+    Chain chain;
+    ASSERT_TRUE(chain.Append(Bytes("0123456789abcdefghij")).IsOk());
+    chain.Consume(2);
+
+    rad::IoVec vecs[4];
+    ASSERT_EQ(chain.ExportIo(vecs), 3u);
+    EXPECT_EQ(IoVecSize(vecs[0]), 6u);
+    EXPECT_EQ(memcmp(IoVecData(vecs[0]), "234567", 6), 0);
+    EXPECT_EQ(IoVecSize(vecs[1]), 8u);
+    EXPECT_EQ(IoVecSize(vecs[2]), 4u);
+    EXPECT_EQ(memcmp(IoVecData(vecs[2]), "ghij", 4), 0);
+
+    // a short array describes the front of the chain
+    EXPECT_EQ(chain.ExportIo(rad::Span<rad::IoVec>(vecs, 1)), 1u);
+    EXPECT_EQ(IoVecData(vecs[0]), chain.SliceAt(0).Data());
+}
+
+TEST(TestIoBufferChain, ReserveCommit)
+{
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+    {
+        CountingChain chain;
+        ASSERT_TRUE(chain.Append(Bytes("abc")).IsOk());
+
+        rad::IoVec vecs[4];
+        EXPECT_EQ(chain.ReserveIo(29, rad::Span<rad::IoVec>(vecs, 3)).Err(),
+                  rad::Error::OutOfRange);
+
+        auto reserved = chain.ReserveIo(29, vecs);
+        ASSERT_TRUE(reserved.IsOk());
+        ASSERT_EQ(reserved.Ok(), 4u);
+        EXPECT_EQ(IoVecSize(vecs[0]), 5u);
+        EXPECT_EQ(IoVecSize(vecs[1]), 8u);
+        EXPECT_EQ(IoVecSize(vecs[2]), 8u);
+        EXPECT_EQ(IoVecSize(vecs[3]), 8u);
+        EXPECT_EQ(chain.Size(), 3u);
+        EXPECT_EQ(chain.SliceCount(), 1u);
+
+        // the read landed in the tail and part of the first new segment
+        memcpy(IoVecData(vecs[0]), "defgh", 5);
+        memcpy(IoVecData(vecs[1]), "ijk", 3);
+        chain.Commit(8);
+        EXPECT_EQ(chain.SliceCount(), 2u);
+        EXPECT_EQ(Contents(chain), "abcdefghijk");
+
+        // reserving nothing, or only the tail
+        ASSERT_TRUE(chain.ReserveIo(0, vecs).IsOk());
+        ASSERT_EQ(chain.ReserveIo(2, vecs).Ok(), 1u);
+        memcpy(IoVecData(vecs[0]), "lm", 2);
+        chain.Commit(2);
+        EXPECT_EQ(Contents(chain), "abcdefghijklm");
+
+        // any other change drops the reservation
+        ASSERT_EQ(chain.ReserveIo(19, vecs).Ok(), 3u);
+        chain.Consume(1);
+        EXPECT_EQ(chain.SliceCount(), 2u);
+        EXPECT_EQ(Contents(chain), "bcdefghijklm");
+
+        ASSERT_EQ(chain.ReserveIo(19, vecs).Ok(), 3u);
+        chain.Commit(0);
+        EXPECT_EQ(chain.SliceCount(), 2u);
+    }
+
+    alloc.VerifyCounts();
+}
+
+TEST(TestIoBufferChain, SharedTailIsNotReserved)
+{
+    Chain chain;
+    ASSERT_TRUE(chain.Append(Bytes("abc")).IsOk());
+    auto slice = chain.Slice(0, 3);
+    ASSERT_TRUE(slice.IsOk());
+
+    rad::IoVec vecs[1];
+    ASSERT_EQ(chain.ReserveIo(4, vecs).Ok(), 1u);
+    EXPECT_EQ(IoVecSize(vecs[0]), 4u);
+    EXPECT_NE(IoVecData(vecs[0]), chain.SliceAt(0).Data() + 3);
+    memcpy(IoVecData(vecs[0]), "defg", 4);
+    chain.Commit(4);
+    EXPECT_EQ(Contents(chain), "abcdefg");
+    EXPECT_EQ(Contents(slice.Ok()), "abc");
+}
+
+TEST(TestIoBufferChain, SliceWhileReserved)
+{
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+    {
+        CountingChain chain;
+        ASSERT_TRUE(chain.Append(Bytes("abc")).IsOk());
+
+        rad::IoVec vecs[2];
+        ASSERT_EQ(chain.ReserveIo(7, vecs).Ok(), 2u);
+        EXPECT_EQ(IoVecData(vecs[0]), chain.SliceAt(0).Data() + 3);
+
+        // sharing the last segment leaves the reserved tail in use
+        auto slice = chain.Slice(1, 2);
+        ASSERT_TRUE(slice.IsOk());
+        EXPECT_EQ(slice.Ok().SliceCount(), 1u);
+        memcpy(IoVecData(vecs[0]), "defgh", 5);
+        memcpy(IoVecData(vecs[1]), "ij", 2);
+        chain.Commit(7);
+        EXPECT_EQ(chain.SliceCount(), 2u);
+        EXPECT_EQ(Contents(chain), "abcdefghij");
+        EXPECT_EQ(Contents(slice.Ok()), "bc");
+
+        // the new last segment has its own tail
+        ASSERT_EQ(chain.ReserveIo(6, vecs).Ok(), 1u);
+        EXPECT_EQ(IoVecData(vecs[0]), chain.SliceAt(1).Data() + 2);
+        chain.Commit(0);
+    }
+
+    alloc.VerifyCounts();
+}
+
+TEST(TestIoBufferChain, NoMemory)
+{
+    rad::IoBufferChain<radtest::FailingAllocator, 8> failing;
+    EXPECT_EQ(failing.Append(Bytes("abc")).Err(), rad::Error::NoMemory);
+    EXPECT_EQ(failing.Prepend(Bytes("abc")).Err(), rad::Error::NoMemory);
+    EXPECT_TRUE(failing.Empty());
+
+    // the first segment and the slice list succeed, the rest fail
+    using OOMChain = rad::IoBufferChain<radtest::OOMAllocator, 8>;
+    OOMChain chain(radtest::OOMAllocator(3));
+    ASSERT_TRUE(chain.Append(Bytes("0123")).IsOk());
+    ASSERT_TRUE(chain.Append(Bytes("45678")).IsOk());
+    EXPECT_EQ(chain.Append(Bytes("a string spanning several")).Err(),
+              rad::Error::NoMemory);
+    EXPECT_EQ(Contents(chain), "012345678");
+    EXPECT_EQ(chain.Prepend(Bytes("a string spanning several")).Err(),
+              rad::Error::NoMemory);
+    EXPECT_EQ(Contents(chain), "012345678");
+
+    rad::IoVec vecs[4];
+    EXPECT_EQ(chain.ReserveIo(30, vecs).Err(), rad::Error::NoMemory);
+    EXPECT_EQ(chain.SliceCount(), 2u);
+    ASSERT_EQ(chain.ReserveIo(7, vecs).Ok(), 1u);
+}
+
+#if !RAD_WINDOWS
+TEST(TestIoBufferChain, Pipe)
+{
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    Chain out;
+    ASSERT_TRUE(out.Append(Bytes("a frame body spread over segments")).IsOk());
+    ASSERT_TRUE(out.Prepend(Bytes("[33]")).IsOk());
+
+    rad::IoVec vecs[8];
+    const rad::SpanSizeType count = out.ExportIo(vecs);
+    ASSERT_EQ(writev(fds[1], vecs, static_cast<int>(count)),
+              static_cast<ssize_t>(out.Size()));
+    out.Consume(out.Size());
+
+    Chain in;
+    auto reserved = in.ReserveIo(64, vecs);
+    ASSERT_TRUE(reserved.IsOk());
+    const ssize_t got = readv(fds[0], vecs, static_cast<int>(reserved.Ok()));
+    ASSERT_EQ(got, 37);
+    in.Commit(static_cast<size_t>(got));
+    EXPECT_EQ(Contents(in), "[33]a frame body spread over segments");
+
+    close(fds[0]);
+    close(fds[1]);
+}
+#endif
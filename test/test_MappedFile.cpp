@@ -0,0 +1,229 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "gtest/gtest.h"
+
+#include "radiant/MappedFile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+namespace
+{
+
+class MappedFileTests : public ::testing::Test
+{
+public:
+
+    void SetUp() override
+    {
+        const char* dir = getenv("TEST_TMPDIR");
+        if (dir == nullptr)
+        {
+            dir = getenv("TMPDIR");
+        }
+        if (dir == nullptr)
+        {
+            dir = getenv("TEMP");
+        }
+
+        m_path = dir != nullptr ? dir : ".";
+        m_path += "/radiant_mapped_";
+        m_path +=
+            ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        m_path += ".bin";
+    }
+
+    void TearDown() override
+    {
+        remove(m_path.c_str());
+    }
+
+    void WriteFile(const void* data, size_t size)
+    {
+        FILE* file = fopen(m_path.c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        if (size != 0)
+        {
+            ASSERT_EQ(fwrite(data, 1, size, file), size);
+        }
+        fclose(file);
+    }
+
+    std::string ReadFile()
+    {
+        std::string contents;
+        FILE* file = fopen(m_path.c_str(), "rb");
+        if (file != nullptr)
+        {
+            char buffer[256];
+            size_t count;
+            while ((count = fread(buffer, 1, sizeof(buffer), file)) != 0)
+            {
+                contents.append(buffer, count);
+            }
+            fclose(file);
+        }
+
+        return contents;
+    }
+
+    std::string m_path;
+};
+
+} // namespace
+
+TEST_F(MappedFileTests, DefaultConstruct)
+{
+    rad::MappedFile file;
+    EXPECT_FALSE(file.IsMapped());
+    EXPECT_EQ(file.Size(), 0u);
+    EXPECT_EQ(file.Bytes(), nullptr);
+    EXPECT_TRUE(file.Data().Empty());
+    EXPECT_TRUE(file.Advise(rad::MapAdvice::Sequential).IsOk());
+}
+
+TEST_F(MappedFileTests, MissingFile)
+{
+    auto res = rad::MappedFile::Open(m_path.c_str());
+    ASSERT_TRUE(res.IsErr());
+    EXPECT_EQ(res.Err(), rad::Error::InvalidAddress);
+}
+
+TEST_F(MappedFileTests, ReadOnly)
+{
+    const char text[] = "a lookup table which is mapped rather than read";
+    WriteFile(text, sizeof(text));
+
+    auto res = rad::MappedFile::Open(m_path.c_str());
+    ASSERT_TRUE(res.IsOk());
+    rad::MappedFile& file = res.Ok();
+    EXPECT_TRUE(file.IsMapped());
+    EXPECT_EQ(file.Mode(), rad::MapMode::ReadOnly);
+    ASSERT_EQ(file.Size(), sizeof(text));
+
+    const rad::Span<const rad::Byte> data = file.Data();
+    EXPECT_EQ(data.Size(), sizeof(text));
+    EXPECT_EQ(data.Data(), file.Bytes());
+    EXPECT_EQ(memcmp(data.Data(), text, sizeof(text)), 0);
+
+    file.Close();
+    EXPECT_FALSE(file.IsMapped());
+    EXPECT_TRUE(file.Data().Empty());
+}
+
+TEST_F(MappedFileTests, EmptyFile)
+{
+    WriteFile(nullptr, 0);
+
+    auto res = rad::MappedFile::Open(m_path.c_str());
+    ASSERT_TRUE(res.IsOk());
+    EXPECT_FALSE(res.Ok().IsMapped());
+    EXPECT_EQ(res.Ok().Size(), 0u);
+    EXPECT_TRUE(res.Ok().Data().Empty());
+    EXPECT_TRUE(res.Ok().Prefetch(0, 0).IsOk());
+    EXPECT_EQ(res.Ok().View(0, 1).Err(), rad::Error::OutOfRange);
+}
+
+TEST_F(MappedFileTests, CopyOnWrite)
+{
+    const char text[] = "original contents";
+    WriteFile(text, sizeof(text) - 1);
+
+    auto res = rad::MappedFile::Open(m_path.c_str(), rad::MapMode::CopyOnWrite);
+    ASSERT_TRUE(res.IsOk());
+    rad::MappedFile& file = res.Ok();
+    EXPECT_EQ(file.Mode(), rad::MapMode::CopyOnWrite);
+
+    rad::Span<rad::Byte> data = file.WritableData();
+    ASSERT_EQ(data.Size(), sizeof(text) - 1);
+    memcpy(data.Data(), "modified", 8);
+    EXPECT_EQ(memcmp(file.Bytes(), "modified contents", 17), 0);
+
+    // neither the file nor a fresh mapping of it sees the change
+    EXPECT_EQ(ReadFile(), "original contents");
+    auto other = rad::MappedFile::Open(m_path.c_str());
+    ASSERT_TRUE(other.IsOk());
+    EXPECT_EQ(memcmp(other.Ok().Bytes(), text, sizeof(text) - 1), 0);
+}
+
+TEST_F(MappedFileTests, View)
+{
+    char bytes[10000];
+    for (size_t i = 0; i < sizeof(bytes); ++i)
+    {
+        bytes[i] = static_cast<char>(i % 251);
+    }
+    WriteFile(bytes, sizeof(bytes));
+
+    auto res = rad::MappedFile::Open(m_path.c_str());
+    ASSERT_TRUE(res.IsOk());
+    const rad::MappedFile& file = res.Ok();
+
+    auto view = file.View(5000, 100);
+    ASSERT_TRUE(view.IsOk());
+    EXPECT_EQ(view.Ok().Data(), file.Bytes() + 5000);
+    EXPECT_EQ(static_cast<uint8_t>(view.Ok()[0]), 5000 % 251);
+
+    EXPECT_TRUE(file.View(0, 10000).IsOk());
+    EXPECT_TRUE(file.View(10000, 0).IsOk());
+    EXPECT_EQ(file.View(9950, 51).Err(), rad::Error::OutOfRange);
+    EXPECT_EQ(file.View(10001, 0).Err(), rad::Error::OutOfRange);
+}
+
+TEST_F(MappedFileTests, Advise)
+{
+    char bytes[20000] = {};
+    WriteFile(bytes, sizeof(bytes));
+
+    auto res = rad::MappedFile::Open(m_path.c_str());
+    ASSERT_TRUE(res.IsOk());
+    rad::MappedFile& file = res.Ok();
+
+    EXPECT_TRUE(file.Advise(rad::MapAdvice::Normal).IsOk());
+    EXPECT_TRUE(file.Advise(rad::MapAdvice::Sequential).IsOk());
+    EXPECT_TRUE(file.Advise(rad::MapAdvice::Random).IsOk());
+    EXPECT_TRUE(file.Advise(rad::MapAdvice::WillNeed).IsOk());
+    EXPECT_TRUE(file.Advise(rad::MapAdvice::DontNeed).IsOk());
+
+    // ranges need not start on a page boundary
+    EXPECT_TRUE(file.Prefetch(100, 15000).IsOk());
+    EXPECT_TRUE(file.Prefetch(19999, 1).IsOk());
+    EXPECT_EQ(file.Prefetch(19999, 2).Err(), rad::Error::OutOfRange);
+    EXPECT_EQ(static_cast<uint8_t>(file.Data()[12345]), 0u);
+}
+
+TEST_F(MappedFileTests, Move)
+{
+    const char text[] = "moved";
+    WriteFile(text, sizeof(text));
+
+    auto res = rad::MappedFile::Open(m_path.c_str());
+    ASSERT_TRUE(res.IsOk());
+    const rad::Byte* bytes = res.Ok().Bytes();
+
+    rad::MappedFile file(rad::Move(res.Ok()));
+    EXPECT_FALSE(res.Ok().IsMapped());
+    EXPECT_EQ(file.Bytes(), bytes);
+
+    rad::MappedFile other;
+    other = rad::Move(file);
+    EXPECT_FALSE(file.IsMapped());
+    EXPECT_EQ(other.Bytes(), bytes);
+    EXPECT_EQ(memcmp(other.Bytes(), text, sizeof(text)), 0);
+}
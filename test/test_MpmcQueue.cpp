@@ -0,0 +1,211 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/MpmcQueue.h"
+
+#include "test/TestAlloc.h"
+
+#include <thread>
+
+namespace
+{
+int g_Live = 0;
+
+struct Tracked
+{
+    explicit Tracked(int v) noexcept
+        : value(v)
+    {
+        ++g_Live;
+    }
+
+    Tracked(Tracked&& other) noexcept
+        : value(other.value)
+    {
+        other.value = -1;
+        ++g_Live;
+    }
+
+    ~Tracked()
+    {
+        --g_Live;
+    }
+
+    Tracked& operator=(Tracked&& other) noexcept
+    {
+        value = other.value;
+        other.value = -1;
+        return *this;
+    }
+
+    int value;
+};
+
+using IntQueue = rad::MpmcQueue<int, radtest::Mallocator>;
+} // namespace
+
+TEST(TestMpmcQueue, Uninitialized)
+{
+    IntQueue queue;
+    EXPECT_EQ(queue.Capacity(), 0u);
+    EXPECT_EQ(queue.ApproxSize(), 0u);
+    EXPECT_EQ(queue.TryPush(1), rad::Error::OutOfRange);
+    EXPECT_EQ(queue.TryPop(), rad::Error::OutOfRange);
+}
+
+TEST(TestMpmcQueue, Capacity)
+{
+    IntQueue queue;
+    EXPECT_TRUE(queue.Init(0).IsOk());
+    EXPECT_EQ(queue.Capacity(), 2u);
+    EXPECT_TRUE(queue.Init(5).IsOk());
+    EXPECT_EQ(queue.Capacity(), 8u);
+    EXPECT_TRUE(queue.Init(16).IsOk());
+    EXPECT_EQ(queue.Capacity(), 16u);
+    EXPECT_EQ(queue.Init(~size_t(0)), rad::Error::IntegerOverflow);
+    EXPECT_EQ(queue.Capacity(), 16u);
+
+    rad::MpmcQueue<int, radtest::FailingAllocator> failing;
+    EXPECT_EQ(failing.Init(4), rad::Error::NoMemory);
+    EXPECT_EQ(failing.Capacity(), 0u);
+}
+
+TEST(TestMpmcQueue, Fifo)
+{
+    IntQueue queue;
+    ASSERT_TRUE(queue.Init(4).IsOk());
+
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_TRUE(queue.TryPush(round * 10 + i).IsOk());
+        }
+        EXPECT_EQ(queue.TryPush(99), rad::Error::OutOfRange);
+        EXPECT_EQ(queue.ApproxSize(), 4u);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            auto res = queue.TryPop();
+            ASSERT_TRUE(res.IsOk());
+            EXPECT_EQ(res.Ok(), round * 10 + i);
+        }
+        EXPECT_EQ(queue.TryPop(), rad::Error::OutOfRange);
+        EXPECT_EQ(queue.ApproxSize(), 0u);
+    }
+}
+
+TEST(TestMpmcQueue, ElementLifetime)
+{
+    g_Live = 0;
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        rad::MpmcQueue<Tracked, radtest::CountingAllocator> queue;
+        ASSERT_TRUE(queue.Init(4).IsOk());
+        counter.VerifyCounts(1, 0);
+
+        EXPECT_TRUE(queue.TryEmplace(1).IsOk());
+        Tracked two(2);
+        EXPECT_TRUE(queue.TryPush(rad::Move(two)).IsOk());
+        EXPECT_EQ(two.value, -1);
+        EXPECT_TRUE(queue.TryEmplace(3).IsOk());
+        EXPECT_EQ(g_Live, 4);
+
+        {
+            auto res = queue.TryPop();
+            ASSERT_TRUE(res.IsOk());
+            EXPECT_EQ(res.Ok().value, 1);
+        }
+        EXPECT_EQ(g_Live, 3);
+    }
+    // the elements left in the queue are destroyed with it
+    EXPECT_EQ(g_Live, 0);
+    counter.VerifyCounts(1, 1);
+    counter.VerifyCounts();
+}
+
+TEST(TestMpmcQueue, Concurrent)
+{
+    static constexpr int ProducerCount = 4;
+    static constexpr int ConsumerCount = 4;
+    static constexpr int PerProducer = 20000;
+
+    rad::MpmcQueue<uint64_t, radtest::Mallocator> queue;
+    ASSERT_TRUE(queue.Init(64).IsOk());
+
+    rad::Atomic<int> consumed{ 0 };
+    uint64_t sums[ConsumerCount] = {};
+
+    std::thread producers[ProducerCount];
+    for (int p = 0; p < ProducerCount; ++p)
+    {
+        producers[p] = std::thread(
+            [&queue, p]
+            {
+                for (int i = 1; i <= PerProducer; ++i)
+                {
+                    const uint64_t value =
+                        static_cast<uint64_t>(p) * PerProducer + i;
+                    while (!queue.TryPush(value).IsOk())
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+
+    std::thread consumers[ConsumerCount];
+    for (int c = 0; c < ConsumerCount; ++c)
+    {
+        consumers[c] = std::thread(
+            [&, c]
+            {
+                while (consumed.Load(rad::MemOrderRelaxed) <
+                       ProducerCount * PerProducer)
+                {
+                    auto res = queue.TryPop();
+                    if (res.IsOk())
+                    {
+                        sums[c] += res.Ok();
+                        consumed.FetchAdd(1, rad::MemOrderRelaxed);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+
+    for (auto& thread : producers)
+    {
+        thread.join();
+    }
+    for (auto& thread : consumers)
+    {
+        thread.join();
+    }
+
+    uint64_t total = 0;
+    for (uint64_t sum : sums)
+    {
+        total += sum;
+    }
+    const uint64_t n = ProducerCount * PerProducer;
+    EXPECT_EQ(total, n * (n + 1) / 2);
+    EXPECT_EQ(queue.TryPop(), rad::Error::OutOfRange);
+}
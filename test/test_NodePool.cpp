@@ -0,0 +1,239 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/List.h"
+#include "radiant/NodePool.h"
+
+#include "test/TestAlloc.h"
+
+#include <stdint.h>
+#include <string.h>
+
+namespace
+{
+using TestPool = rad::NodePool<radtest::CountingAllocator, 24, 4>;
+using TestPoolAllocator =
+    rad::NodePoolAllocator<radtest::CountingAllocator, 24, 4>;
+
+bool IsAligned(void* ptr, size_t align)
+{
+    return (reinterpret_cast<uintptr_t>(ptr) & (align - 1)) == 0;
+}
+} // namespace
+
+RAD_S_ASSERT(TestPool::Stride == 24);
+RAD_S_ASSERT(TestPool::Alignment == 8);
+RAD_S_ASSERT(TestPool::Fits(1));
+RAD_S_ASSERT(TestPool::Fits(8));
+RAD_S_ASSERT(TestPool::Fits(24));
+RAD_S_ASSERT(!TestPool::Fits(0));
+RAD_S_ASSERT(!TestPool::Fits(16));
+RAD_S_ASSERT(!TestPool::Fits(32));
+RAD_S_ASSERT((rad::NodePool<radtest::Mallocator, 1>::Stride == sizeof(void*)));
+RAD_S_ASSERT((rad::NodePool<radtest::Mallocator, 32>::Alignment ==
+              alignof(max_align_t)));
+
+RAD_S_ASSERT(!TestPoolAllocator::IsAlwaysEqual);
+RAD_S_ASSERT(TestPoolAllocator::PropagateOnCopy);
+RAD_S_ASSERT(TestPoolAllocator::PropagateOnMoveAssignment);
+RAD_S_ASSERT(TestPoolAllocator::PropagateOnSwap);
+
+TEST(NodePoolTest, CarvesSlabs)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        TestPool pool;
+
+        void* chunks[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            chunks[i] = pool.Alloc();
+            ASSERT_NE(chunks[i], nullptr);
+            EXPECT_TRUE(IsAligned(chunks[i], TestPool::Alignment));
+            memset(chunks[i], i, TestPool::ChunkSize);
+        }
+
+        // chunks of a slab are contiguous
+        for (int i = 1; i < 4; ++i)
+        {
+            EXPECT_EQ(static_cast<char*>(chunks[i]) -
+                          static_cast<char*>(chunks[i - 1]),
+                      static_cast<ptrdiff_t>(TestPool::Stride));
+        }
+
+        counter.VerifyCounts(2, 0);
+    }
+    counter.VerifyCounts(2, 2);
+    counter.VerifyCounts();
+}
+
+TEST(NodePoolTest, RecyclesChunks)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        TestPool pool;
+
+        void* first = pool.Alloc();
+        void* second = pool.Alloc();
+        ASSERT_NE(first, nullptr);
+        ASSERT_NE(second, nullptr);
+
+        pool.Free(first);
+        pool.Free(second);
+        pool.Free(nullptr);
+
+        // most recently freed first
+        EXPECT_EQ(pool.Alloc(), second);
+        EXPECT_EQ(pool.Alloc(), first);
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            void* ptr = pool.Alloc();
+            ASSERT_NE(ptr, nullptr);
+            pool.Free(ptr);
+        }
+
+        counter.VerifyCounts(1, 0);
+    }
+    counter.VerifyCounts();
+}
+
+TEST(NodePoolTest, Release)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+
+    TestPool pool;
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_NE(pool.Alloc(), nullptr);
+    }
+    counter.VerifyCounts(2, 0);
+
+    pool.Release();
+    counter.VerifyCounts(2, 2);
+
+    EXPECT_NE(pool.Alloc(), nullptr);
+    counter.VerifyCounts(3, 2);
+
+    pool.Release();
+    counter.VerifyCounts();
+}
+
+TEST(NodePoolTest, BackingFailure)
+{
+    rad::ListNodePool<int, radtest::FailingAllocator> pool;
+    EXPECT_EQ(pool.Alloc(), nullptr);
+
+    rad::ListNodePoolAllocator<int, radtest::FailingAllocator> alloc(pool);
+    rad::List<int, decltype(alloc)> list(alloc);
+    EXPECT_EQ(list.PushBack(1), rad::Error::NoMemory);
+}
+
+TEST(NodePoolAllocatorTest, ForwardsOtherSizes)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        TestPool pool;
+        TestPoolAllocator alloc(pool);
+
+        void* small = alloc.AllocBytes(24);
+        ASSERT_NE(small, nullptr);
+        counter.VerifyCounts(1, 0);
+
+        void* large = alloc.AllocBytes(100);
+        ASSERT_NE(large, nullptr);
+        counter.VerifyCounts(2, 0);
+
+        void* misaligned = alloc.AllocBytes(16);
+        ASSERT_NE(misaligned, nullptr);
+        counter.VerifyCounts(3, 0);
+
+        alloc.FreeBytes(large, 100);
+        alloc.FreeBytes(misaligned, 16);
+        counter.VerifyCounts(3, 2);
+
+        alloc.FreeBytes(small, 24);
+        counter.VerifyCounts(3, 2);
+        EXPECT_EQ(alloc.AllocBytes(24), small);
+    }
+    counter.VerifyCounts();
+}
+
+TEST(NodePoolAllocatorTest, Equality)
+{
+    TestPool pool1;
+    TestPool pool2;
+
+    TestPoolAllocator alloc1(pool1);
+    TestPoolAllocator alloc1b(pool1);
+    TestPoolAllocator alloc2(pool2);
+
+    EXPECT_TRUE(alloc1 == alloc1b);
+    EXPECT_FALSE(alloc1 != alloc1b);
+    EXPECT_FALSE(alloc1 == alloc2);
+    EXPECT_TRUE(alloc1 != alloc2);
+    EXPECT_EQ(&alloc1.GetPool(), &pool1);
+}
+
+TEST(NodePoolAllocatorTest, List)
+{
+    using PoolType = rad::ListNodePool<int, radtest::CountingAllocator, 16>;
+    using AllocType =
+        rad::ListNodePoolAllocator<int, radtest::CountingAllocator, 16>;
+
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        PoolType pool;
+        AllocType alloc(pool);
+        rad::List<int, AllocType> list(alloc);
+
+        for (int i = 0; i < 32; ++i)
+        {
+            ASSERT_TRUE(list.PushBack(i).IsOk());
+        }
+        counter.VerifyCounts(2, 0);
+
+        // erasing and inserting recycles nodes without new slabs
+        for (int i = 0; i < 1000; ++i)
+        {
+            list.PopFront();
+            ASSERT_TRUE(list.PushBack(i).IsOk());
+        }
+        EXPECT_EQ(list.ExpensiveSize(), 32u);
+        counter.VerifyCounts(2, 0);
+
+        int expected = 1000 - 32;
+        for (int val : list)
+        {
+            EXPECT_EQ(val, expected);
+            ++expected;
+        }
+
+        auto clone = list.Clone();
+        ASSERT_TRUE(clone.IsOk());
+        EXPECT_TRUE(clone.Ok().GetAllocator() == alloc);
+
+        list.Clear();
+        clone.Ok().Clear();
+        counter.VerifyCounts(4, 0);
+    }
+    counter.VerifyCounts();
+}
@@ -0,0 +1,227 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/ObjectPool.h"
+
+#include "test/TestAlloc.h"
+
+#include <stdint.h>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+int g_Live = 0;
+
+struct Tracked
+{
+    explicit Tracked(int v) noexcept
+        : value(v)
+    {
+        ++g_Live;
+    }
+
+    ~Tracked()
+    {
+        --g_Live;
+    }
+
+    int value;
+};
+
+using TestPool = rad::ObjectPool<Tracked, radtest::CountingAllocator, 4>;
+} // namespace
+
+RAD_S_ASSERT(TestPool::BatchSize == 4);
+RAD_S_ASSERT(TestPool::Stride == sizeof(rad::detail::ObjectPoolSlot));
+RAD_S_ASSERT((rad::ObjectPool<char[40], radtest::Mallocator>::Stride == 40));
+
+TEST(TestObjectPool, AcquireRelease)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        TestPool pool;
+        TestPool::Cache* cache = pool.Register().Ok();
+        ASSERT_NE(cache, nullptr);
+        EXPECT_EQ(counter.AllocCount(), 1u);
+        EXPECT_EQ(pool.CachedCount(*cache), 0u);
+
+        Tracked* first = pool.Acquire(*cache, 1);
+        ASSERT_NE(first, nullptr);
+        EXPECT_EQ(first->value, 1);
+        EXPECT_EQ(g_Live, 1);
+        EXPECT_EQ(counter.AllocCount(), 2u);
+        EXPECT_EQ(pool.CachedCount(*cache), 3u);
+
+        // the rest of the batch is carved from the same slab
+        Tracked* objs[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            objs[i] = pool.Acquire(*cache, i);
+            ASSERT_NE(objs[i], nullptr);
+            EXPECT_EQ(reinterpret_cast<char*>(objs[i]) -
+                          reinterpret_cast<char*>(first),
+                      static_cast<ptrdiff_t>((i + 1) * TestPool::Stride));
+        }
+
+        EXPECT_EQ(counter.AllocCount(), 2u);
+        EXPECT_EQ(g_Live, 4);
+
+        pool.Release(*cache, objs[2]);
+        EXPECT_EQ(g_Live, 3);
+        EXPECT_EQ(pool.Acquire(*cache, 7), objs[2]);
+        EXPECT_EQ(objs[2]->value, 7);
+
+        pool.Release(*cache, nullptr);
+        pool.Release(*cache, first);
+        for (Tracked* obj : objs)
+        {
+            pool.Release(*cache, obj);
+        }
+
+        EXPECT_EQ(g_Live, 0);
+        EXPECT_EQ(pool.CachedCount(*cache), 4u);
+        pool.Unregister(*cache);
+        EXPECT_EQ(counter.AllocCount(), 2u);
+        EXPECT_EQ(counter.FreeCount(), 0u);
+    }
+
+    EXPECT_EQ(counter.FreeCount(), 2u);
+}
+
+TEST(TestObjectPool, Depot)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        TestPool pool;
+        TestPool::Cache* producer = pool.Register().Ok();
+        TestPool::Cache* consumer = pool.Register().Ok();
+        EXPECT_NE(producer, consumer);
+
+        Tracked* objs[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            objs[i] = pool.Acquire(*producer, i);
+        }
+
+        EXPECT_EQ(counter.AllocCount(), 4u);
+
+        // releasing two batches on another cache hands one to the depot
+        for (Tracked* obj : objs)
+        {
+            pool.Release(*consumer, obj);
+        }
+
+        EXPECT_EQ(pool.CachedCount(*consumer), 4u);
+
+        // which refills the producer without a new slab
+        Tracked* obj = pool.Acquire(*producer, 8);
+        EXPECT_EQ(pool.CachedCount(*producer), 3u);
+        EXPECT_EQ(counter.AllocCount(), 4u);
+        pool.Release(*producer, obj);
+
+        pool.Unregister(*producer);
+        pool.Unregister(*consumer);
+        EXPECT_EQ(pool.CachedCount(*producer), 0u);
+        EXPECT_EQ(pool.CachedCount(*consumer), 0u);
+
+        // an unregistered cache is reused
+        EXPECT_EQ(pool.Register().Ok(), consumer);
+        EXPECT_EQ(counter.AllocCount(), 4u);
+        for (int i = 0; i < 8; ++i)
+        {
+            objs[i] = pool.Acquire(*consumer, i);
+        }
+
+        EXPECT_EQ(counter.AllocCount(), 4u);
+        for (Tracked* o : objs)
+        {
+            pool.Release(*consumer, o);
+        }
+    }
+
+    EXPECT_EQ(counter.FreeCount(), 4u);
+    EXPECT_EQ(g_Live, 0);
+}
+
+TEST(TestObjectPool, AllocFailure)
+{
+    radtest::FailingAllocator alloc;
+    rad::ObjectPool<int, radtest::FailingAllocator> pool(alloc);
+    EXPECT_EQ(pool.Register(), rad::Error::NoMemory);
+
+    // the cache record fits, the slab does not
+    rad::ObjectPool<int, radtest::OOMAllocator> oom(radtest::OOMAllocator(1));
+    auto* cache = oom.Register().Ok();
+    ASSERT_NE(cache, nullptr);
+    EXPECT_EQ(oom.Acquire(*cache, 1), nullptr);
+    oom.Unregister(*cache);
+}
+
+TEST(TestObjectPool, Threads)
+{
+    constexpr int ThreadCount = 4;
+    constexpr int Iterations = 2000;
+    rad::ObjectPool<Tracked, radtest::Mallocator, 8> pool;
+
+    std::vector<std::thread> threads;
+    std::vector<Tracked*> handoff[ThreadCount];
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back(
+            [&pool, &handoff, t]()
+            {
+                auto* cache = pool.Register().Ok();
+                for (int i = 0; i < Iterations; ++i)
+                {
+                    Tracked* obj = pool.Acquire(*cache, i);
+                    ASSERT_NE(obj, nullptr);
+                    EXPECT_EQ(obj->value, i);
+                    if (i % 3 == 0)
+                    {
+                        handoff[t].push_back(obj);
+                    }
+                    else
+                    {
+                        pool.Release(*cache, obj);
+                    }
+                }
+
+                pool.Unregister(*cache);
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // objects acquired by the workers are released by another thread
+    auto* cache = pool.Register().Ok();
+    for (auto& objs : handoff)
+    {
+        for (Tracked* obj : objs)
+        {
+            pool.Release(*cache, obj);
+        }
+    }
+
+    pool.Unregister(*cache);
+    EXPECT_EQ(g_Live, 0);
+}
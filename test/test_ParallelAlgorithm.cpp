@@ -0,0 +1,256 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "gtest/gtest.h"
+
+#include "radiant/ParallelAlgorithm.h"
+#include "radiant/ThreadPool.h"
+
+#include "test/TestAlloc.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+using Pool = rad::ThreadPool<radtest::Mallocator>;
+
+template <typename T>
+rad::Span<T> ToSpan(std::vector<T>& vec)
+{
+    return rad::Span<T>(vec.data(), static_cast<rad::SpanSizeType>(vec.size()));
+}
+
+std::vector<uint32_t> RandomValues(size_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint32_t> values(count);
+    for (auto& value : values)
+    {
+        value = static_cast<uint32_t>(rng() % 1000);
+    }
+
+    return values;
+}
+
+} // namespace
+
+TEST(ParallelAlgorithmTest, ForEach)
+{
+    Pool pool;
+    ASSERT_TRUE(pool.Start(3).IsOk());
+
+    for (size_t size : { 0u, 1u, 100u, 10000u, 100001u })
+    {
+        std::vector<int> values(size, 1);
+        rad::ParallelForEach(pool,
+                             ToSpan(values),
+                             [](int& value) noexcept { value *= 3; },
+                             64);
+        EXPECT_EQ(std::count(values.begin(), values.end(), 3),
+                  static_cast<std::ptrdiff_t>(size));
+    }
+
+    // the calling thread is counted while the workers are busy
+    rad::Atomic<int> visits{ 0 };
+    std::vector<int> values(5000);
+    rad::ParallelForEach(pool,
+                         ToSpan(values),
+                         [&visits](int&) noexcept
+                         { visits.FetchAdd(1, rad::MemOrderRelaxed); });
+    EXPECT_EQ(visits.Load(rad::MemOrderRelaxed), 5000);
+}
+
+TEST(ParallelAlgorithmTest, Transform)
+{
+    Pool pool;
+    ASSERT_TRUE(pool.Start(2).IsOk());
+
+    std::vector<uint32_t> input = RandomValues(50000, 1);
+    std::vector<uint64_t> output(input.size());
+    rad::ParallelTransform(pool,
+                           rad::Span<const uint32_t>(ToSpan(input)),
+                           ToSpan(output),
+                           [](uint32_t value) noexcept
+                           { return uint64_t(value) * value; },
+                           1000);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        ASSERT_EQ(output[i], uint64_t(input[i]) * input[i]);
+    }
+}
+
+TEST(ParallelAlgorithmTest, Reduce)
+{
+    Pool pool;
+    ASSERT_TRUE(pool.Start(4).IsOk());
+
+    std::vector<uint32_t> values = RandomValues(123457, 2);
+    uint64_t expected = 10;
+    for (uint32_t value : values)
+    {
+        expected += value;
+    }
+
+    auto plus = [](uint64_t sum, uint64_t value) noexcept
+    { return sum + value; };
+    EXPECT_EQ(rad::ParallelReduce(pool, ToSpan(values), uint64_t(10), plus),
+              expected);
+    EXPECT_EQ(
+        rad::ParallelReduce(pool, ToSpan(values), uint64_t(10), plus, 7),
+        expected);
+
+    std::vector<uint32_t> empty;
+    EXPECT_EQ(rad::ParallelReduce(pool, ToSpan(empty), uint64_t(5), plus), 5u);
+
+    auto max = [](uint32_t a, uint32_t b) noexcept { return a < b ? b : a; };
+    values[777] = 5000;
+    EXPECT_EQ(rad::ParallelReduce(pool, ToSpan(values), 0u, max, 100), 5000u);
+}
+
+TEST(ParallelAlgorithmTest, Sort)
+{
+    Pool pool;
+    ASSERT_TRUE(pool.Start(3).IsOk());
+    radtest::Mallocator alloc;
+
+    for (size_t size : { 0u, 10u, 1000u, 4097u, 65537u })
+    {
+        for (rad::SpanSizeType grain : { 0u, 100u, 999u })
+        {
+            std::vector<uint32_t> values =
+                RandomValues(size, static_cast<uint32_t>(size + grain));
+            std::vector<uint32_t> expected = values;
+            std::sort(expected.begin(), expected.end());
+            rad::ParallelSort(pool,
+                              alloc,
+                              ToSpan(values),
+                              rad::Less<>(),
+                              grain);
+            ASSERT_EQ(values, expected) << size << " " << grain;
+        }
+    }
+
+    std::vector<uint32_t> values = RandomValues(20000, 3);
+    std::vector<uint32_t> expected = values;
+    std::sort(expected.begin(), expected.end(), std::greater<uint32_t>());
+    rad::ParallelSort(pool,
+                      alloc,
+                      ToSpan(values),
+                      [](uint32_t a, uint32_t b) noexcept { return b < a; },
+                      128);
+    EXPECT_EQ(values, expected);
+}
+
+TEST(ParallelAlgorithmTest, SortNonTrivial)
+{
+    Pool pool;
+    ASSERT_TRUE(pool.Start(2).IsOk());
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+
+    std::vector<std::string> values;
+    std::mt19937 rng(4);
+    for (int i = 0; i < 5000; ++i)
+    {
+        values.push_back(std::to_string(rng()) + " is long enough to allocate");
+    }
+
+    std::vector<std::string> expected = values;
+    std::sort(expected.begin(), expected.end());
+    rad::ParallelSort(pool, alloc, ToSpan(values), rad::Less<>(), 50);
+    EXPECT_EQ(values, expected);
+
+    // the buffer and the split points
+    alloc.VerifyCounts(2, 2);
+}
+
+TEST(ParallelAlgorithmTest, SortTypedAllocator)
+{
+    Pool pool;
+    ASSERT_TRUE(pool.Start(2).IsOk());
+    radtest::TypedAllocator alloc;
+
+    std::vector<uint32_t> values = RandomValues(30000, 7);
+    std::vector<uint32_t> expected = values;
+    std::sort(expected.begin(), expected.end());
+    rad::ParallelSort(pool, alloc, ToSpan(values), rad::Less<>(), 100);
+    EXPECT_EQ(values, expected);
+}
+
+TEST(ParallelAlgorithmTest, SortWithoutMemory)
+{
+    Pool pool;
+    ASSERT_TRUE(pool.Start(2).IsOk());
+    radtest::FailingAllocator alloc;
+
+    std::vector<uint32_t> values = RandomValues(30000, 5);
+    std::vector<uint32_t> expected = values;
+    std::sort(expected.begin(), expected.end());
+    rad::ParallelSort(pool, alloc, ToSpan(values), rad::Less<>(), 100);
+    EXPECT_EQ(values, expected);
+}
+
+TEST(ParallelAlgorithmTest, SerialExecutor)
+{
+    rad::SerialExecutor exec;
+    radtest::FailingAllocator alloc;
+
+    std::vector<uint32_t> values = RandomValues(10000, 6);
+    std::vector<uint32_t> expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    // without workers nothing is allocated and everything runs in order
+    rad::ParallelSort(exec, alloc, ToSpan(values), rad::Less<>(), 10);
+    EXPECT_EQ(values, expected);
+
+    uint32_t previous = 0;
+    bool ordered = true;
+    rad::ParallelForEach(exec,
+                         ToSpan(values),
+                         [&](uint32_t value) noexcept
+                         {
+                             ordered = ordered && previous <= value;
+                             previous = value;
+                         },
+                         10);
+    EXPECT_TRUE(ordered);
+}
+
+TEST(ParallelAlgorithmTest, Nested)
+{
+    Pool pool;
+    ASSERT_TRUE(pool.Start(2, 64).IsOk());
+
+    // parallel calls from within the tasks of another help rather than wait
+    std::vector<std::vector<int>> rows(16, std::vector<int>(1000, 1));
+    rad::ParallelForEach(pool,
+                         ToSpan(rows),
+                         [&pool](std::vector<int>& row) noexcept
+                         {
+                             rad::ParallelForEach(pool,
+                                                  ToSpan(row),
+                                                  [](int& value) noexcept
+                                                  { value = 2; },
+                                                  10);
+                         },
+                         1);
+    for (const auto& row : rows)
+    {
+        EXPECT_EQ(std::count(row.begin(), row.end(), 2), 1000);
+    }
+}
@@ -0,0 +1,198 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/Locks.h"
+#include "radiant/ProfiledLock.h"
+#include "radiant/SpinLocks.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// lock without try operations
+struct PlainLock
+{
+    void LockExclusive() noexcept
+    {
+        ++locks;
+    }
+
+    void Unlock() noexcept
+    {
+        ++unlocks;
+    }
+
+    int locks{};
+    int unlocks{};
+};
+
+uint64_t Sum(const uint64_t (&histogram)[rad::LockProfile::BucketCount])
+{
+    uint64_t sum = 0;
+    for (uint64_t count : histogram)
+    {
+        sum += count;
+    }
+
+    return sum;
+}
+
+} // namespace
+
+TEST(TestProfiledLock, Bucket)
+{
+    EXPECT_EQ(rad::LockProfile::Bucket(0), 0u);
+    EXPECT_EQ(rad::LockProfile::Bucket(1), 1u);
+    EXPECT_EQ(rad::LockProfile::Bucket(2), 2u);
+    EXPECT_EQ(rad::LockProfile::Bucket(3), 2u);
+    EXPECT_EQ(rad::LockProfile::Bucket(4), 3u);
+    EXPECT_EQ(rad::LockProfile::Bucket(1u << 30), 31u);
+    EXPECT_EQ(rad::LockProfile::Bucket(UINT64_MAX),
+              rad::LockProfile::BucketCount - 1);
+}
+
+TEST(TestProfiledLock, Uncontended)
+{
+    rad::ProfiledLock<rad::RWSpinLock> lock;
+    {
+        rad::LockExclusive<rad::ProfiledLock<rad::RWSpinLock>> guard(lock);
+        EXPECT_FALSE(lock.Wrapped().TryLockShared());
+    }
+    {
+        rad::LockShared<rad::ProfiledLock<rad::RWSpinLock>> first(lock);
+        rad::LockShared<rad::ProfiledLock<rad::RWSpinLock>> second(lock);
+        EXPECT_FALSE(lock.Wrapped().TryLockExclusive());
+    }
+
+    EXPECT_TRUE(lock.Wrapped().TryLockExclusive());
+    lock.Wrapped().Unlock();
+
+    const rad::LockProfile profile = lock.Snapshot();
+    EXPECT_EQ(profile.acquisitions, 3u);
+    EXPECT_EQ(profile.sharedAcquisitions, 2u);
+    EXPECT_EQ(profile.contended, 0u);
+    EXPECT_EQ(profile.spins, 0u);
+    EXPECT_EQ(profile.waitTicks, 0u);
+    EXPECT_EQ(profile.waitHistogram[0], 3u);
+    EXPECT_EQ(Sum(profile.waitHistogram), 3u);
+    EXPECT_EQ(Sum(profile.holdHistogram), 1u);
+}
+
+TEST(TestProfiledLock, WithoutTry)
+{
+    rad::ProfiledLock<PlainLock> lock;
+    {
+        rad::LockExclusive<rad::ProfiledLock<PlainLock>> guard(lock);
+    }
+    {
+        rad::RelockableExclusive<rad::ProfiledLock<PlainLock>> guard(lock);
+        guard.Unlock();
+        guard.Lock();
+    }
+
+    EXPECT_EQ(lock.Wrapped().locks, 3);
+    EXPECT_EQ(lock.Wrapped().unlocks, 3);
+
+    const rad::LockProfile profile = lock.Snapshot();
+    EXPECT_EQ(profile.acquisitions, 3u);
+    EXPECT_EQ(profile.sharedAcquisitions, 0u);
+    EXPECT_EQ(profile.contended, 0u);
+    EXPECT_EQ(Sum(profile.waitHistogram), 3u);
+    EXPECT_EQ(Sum(profile.holdHistogram), 3u);
+}
+
+TEST(TestProfiledLock, Contended)
+{
+    rad::ProfiledLock<rad::TicketSpinLock> lock;
+    rad::Atomic<bool> waiting{ false };
+
+    std::thread thread;
+    {
+        rad::LockExclusive<rad::ProfiledLock<rad::TicketSpinLock>> guard(lock);
+        thread = std::thread(
+            [&]()
+            {
+                waiting.Store(true, rad::MemOrderRelaxed);
+                rad::LockExclusive<rad::ProfiledLock<rad::TicketSpinLock>>
+                    inner(lock);
+            });
+
+        while (!waiting.Load(rad::MemOrderRelaxed))
+        {
+            std::this_thread::yield();
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    thread.join();
+
+    const rad::LockProfile profile = lock.Snapshot();
+    EXPECT_EQ(profile.acquisitions, 2u);
+    EXPECT_EQ(profile.contended, 1u);
+    EXPECT_GT(profile.spins, 0u);
+    EXPECT_GT(profile.waitTicks, 0u);
+    EXPECT_GT(profile.holdTicks, 0u);
+    EXPECT_EQ(Sum(profile.waitHistogram), 2u);
+    EXPECT_EQ(Sum(profile.holdHistogram), 2u);
+
+    lock.Reset();
+    const rad::LockProfile reset = lock.Snapshot();
+    EXPECT_EQ(reset.acquisitions, 0u);
+    EXPECT_EQ(reset.contended, 0u);
+    EXPECT_EQ(reset.waitTicks, 0u);
+    EXPECT_EQ(Sum(reset.waitHistogram), 0u);
+    EXPECT_EQ(Sum(reset.holdHistogram), 0u);
+}
+
+TEST(TestProfiledLock, Threads)
+{
+    constexpr int ThreadCount = 4;
+    constexpr int Iterations = 1000;
+    rad::ProfiledLock<rad::QueuedSpinLock> lock;
+    int counter = 0;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                for (int i = 0; i < Iterations; ++i)
+                {
+                    rad::LockExclusive<rad::ProfiledLock<rad::QueuedSpinLock>>
+                        guard(lock);
+                    ++counter;
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter, ThreadCount * Iterations);
+    const rad::LockProfile profile = lock.Snapshot();
+    EXPECT_EQ(profile.acquisitions,
+              static_cast<uint64_t>(ThreadCount * Iterations));
+    EXPECT_LE(profile.contended, profile.acquisitions);
+    EXPECT_EQ(Sum(profile.waitHistogram), profile.acquisitions);
+    EXPECT_EQ(Sum(profile.holdHistogram), profile.acquisitions);
+}
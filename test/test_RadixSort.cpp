@@ -0,0 +1,294 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "gtest/gtest.h"
+
+#include "radiant/RadixSort.h"
+
+#include "test/TestAlloc.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+template <typename T>
+rad::Span<T> ToSpan(std::vector<T>& values)
+{
+    return rad::Span<T>(values.data(),
+                        static_cast<rad::SpanSizeType>(values.size()));
+}
+
+template <typename T>
+void CheckIntegral(size_t size, uint32_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<T> values(size);
+    for (auto& value : values)
+    {
+        value = static_cast<T>(rng());
+    }
+
+    std::vector<T> expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<T> scratch(size);
+    rad::RadixSort(ToSpan(values), ToSpan(scratch));
+    EXPECT_EQ(values, expected) << sizeof(T) << " " << size;
+}
+
+struct Event
+{
+    int64_t timestamp;
+    uint32_t seq;
+};
+
+rad::Span<const rad::Byte> Bytes(const std::string& str)
+{
+    return rad::Span<const rad::Byte>(
+        reinterpret_cast<const rad::Byte*>(str.data()),
+        static_cast<rad::SpanSizeType>(str.size()));
+}
+
+} // namespace
+
+TEST(RadixSortTest, Integral)
+{
+    for (size_t size : { 0u, 1u, 2u, 64u, 65u, 1000u, 20000u })
+    {
+        CheckIntegral<uint8_t>(size, 1);
+        CheckIntegral<int8_t>(size, 2);
+        CheckIntegral<uint16_t>(size, 3);
+        CheckIntegral<int16_t>(size, 4);
+        CheckIntegral<uint32_t>(size, 5);
+        CheckIntegral<int32_t>(size, 6);
+        CheckIntegral<uint64_t>(size, 7);
+        CheckIntegral<int64_t>(size, 8);
+    }
+}
+
+TEST(RadixSortTest, SignedExtremes)
+{
+    std::vector<int32_t> values = { 0,  INT32_MAX, -1, INT32_MIN, 1,
+                                    -2, 2,         5,  -5,        0 };
+    for (int i = 0; i < 100; ++i)
+    {
+        values.push_back(i % 2 == 0 ? -i : i);
+    }
+
+    std::vector<int32_t> expected = values;
+    std::sort(expected.begin(), expected.end());
+    std::vector<int32_t> scratch(values.size());
+    rad::RadixSort(ToSpan(values), ToSpan(scratch));
+    EXPECT_EQ(values, expected);
+}
+
+TEST(RadixSortTest, StableByKey)
+{
+    // timestamps within a narrow window only differ in their low bytes
+    std::mt19937 rng(9);
+    std::vector<Event> events;
+    for (uint32_t i = 0; i < 5000; ++i)
+    {
+        events.push_back(
+            { 1700000000000LL + static_cast<int64_t>(rng() % 1000), i });
+    }
+
+    std::vector<Event> expected = events;
+    std::stable_sort(expected.begin(),
+                     expected.end(),
+                     [](const Event& a, const Event& b)
+                     { return a.timestamp < b.timestamp; });
+
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+    ASSERT_TRUE(rad::RadixSort(alloc,
+                               ToSpan(events),
+                               [](const Event& event) noexcept
+                               { return event.timestamp; })
+                    .IsOk());
+    alloc.VerifyCounts(1, 1);
+
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        ASSERT_EQ(events[i].timestamp, expected[i].timestamp) << i;
+        ASSERT_EQ(events[i].seq, expected[i].seq) << i;
+    }
+}
+
+TEST(RadixSortTest, IntegerKeys)
+{
+    std::vector<int16_t> values;
+    for (int i = 0; i < 200; ++i)
+    {
+        values.push_back(static_cast<int16_t>((i * 7919) % 601 - 300));
+    }
+
+    radtest::Mallocator alloc;
+    ASSERT_TRUE(rad::RadixSort(alloc,
+                               ToSpan(values),
+                               [](const int16_t& value) noexcept
+                               { return rad::Integer<int16_t>(value); })
+                    .IsOk());
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+}
+
+TEST(RadixSortTest, TypedAllocator)
+{
+    std::vector<uint32_t> values;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        values.push_back(i * 2654435761u);
+    }
+
+    radtest::TypedAllocator alloc;
+    ASSERT_TRUE(rad::RadixSort(alloc, ToSpan(values)).IsOk());
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+
+    std::vector<std::string> strings = { "b", "ab", "", "a", "abc", "b" };
+    std::vector<rad::Span<const rad::Byte>> keys;
+    for (const auto& str : strings)
+    {
+        keys.push_back(Bytes(str));
+    }
+
+    std::vector<std::string> expected = strings;
+    std::sort(expected.begin(), expected.end());
+    ASSERT_TRUE(rad::RadixSortBytes(alloc, ToSpan(keys)).IsOk());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        EXPECT_EQ(std::string(reinterpret_cast<const char*>(keys[i].Data()),
+                              keys[i].Size()),
+                  expected[i]);
+    }
+}
+
+TEST(RadixSortTest, NoMemory)
+{
+    radtest::FailingAllocator alloc;
+    std::vector<int> values(100);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = static_cast<int>(values.size() - i);
+    }
+
+    const std::vector<int> original = values;
+    EXPECT_EQ(rad::RadixSort(alloc, ToSpan(values)).Err(),
+              rad::Error::NoMemory);
+    EXPECT_EQ(values, original);
+    EXPECT_EQ(rad::RadixSortBytes(alloc,
+                                  ToSpan(values),
+                                  [](const int&) noexcept
+                                  { return rad::Span<const rad::Byte>(); })
+                  .Err(),
+              rad::Error::NoMemory);
+
+    // short ranges need no scratch
+    values.resize(10);
+    EXPECT_TRUE(rad::RadixSort(alloc, ToSpan(values)).IsOk());
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+}
+
+TEST(RadixSortTest, Bytes)
+{
+    std::mt19937 rng(10);
+    std::vector<std::string> strings = { "", "", "a", "ab", "abc", "b" };
+    for (int i = 0; i < 3000; ++i)
+    {
+        // shared prefixes, embedded zeros and high bytes
+        std::string str = i % 3 == 0 ? "common/prefix/" : "";
+        const size_t length = rng() % 12;
+        for (size_t c = 0; c < length; ++c)
+        {
+            str.push_back(static_cast<char>(rng() % 4 == 0 ? 0 : rng()));
+        }
+
+        strings.push_back(str);
+    }
+
+    std::vector<rad::Span<const rad::Byte>> keys;
+    for (const auto& str : strings)
+    {
+        keys.push_back(Bytes(str));
+    }
+
+    std::vector<std::string> expected = strings;
+    std::sort(expected.begin(),
+              expected.end(),
+              [](const std::string& a, const std::string& b)
+              {
+                  return std::lexicographical_compare(
+                      a.begin(),
+                      a.end(),
+                      b.begin(),
+                      b.end(),
+                      [](char x, char y)
+                      {
+                          return static_cast<unsigned char>(x) <
+                                 static_cast<unsigned char>(y);
+                      });
+              });
+
+    std::vector<rad::Span<const rad::Byte>> scratch(keys.size());
+    rad::RadixSortBytes(ToSpan(keys), ToSpan(scratch));
+    ASSERT_EQ(keys.size(), expected.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        ASSERT_EQ(std::string(reinterpret_cast<const char*>(keys[i].Data()),
+                              keys[i].Size()),
+                  expected[i])
+            << i;
+    }
+}
+
+TEST(RadixSortTest, BytesStableByKey)
+{
+    // keys which are prefixes of each other split off one bucket per level,
+    // exhausting the distribution levels before the range gets short
+    std::vector<std::string> names;
+    for (int i = 0; i < 500; ++i)
+    {
+        names.push_back(std::string(static_cast<size_t>(i % 50 + 1), 'x'));
+    }
+
+    struct Row
+    {
+        const std::string* name;
+        int seq;
+    };
+
+    std::vector<Row> rows;
+    for (int i = 0; i < 500; ++i)
+    {
+        rows.push_back({ &names[static_cast<size_t>(i)], i });
+    }
+
+    auto key = [](const Row& row) noexcept { return Bytes(*row.name); };
+    std::vector<Row> expected = rows;
+    std::stable_sort(expected.begin(),
+                     expected.end(),
+                     [](const Row& a, const Row& b)
+                     { return *a.name < *b.name; });
+
+    radtest::Mallocator alloc;
+    ASSERT_TRUE(rad::RadixSortBytes(alloc, ToSpan(rows), key).IsOk());
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        ASSERT_EQ(*rows[i].name, *expected[i].name) << i;
+        ASSERT_EQ(rows[i].seq, expected[i].seq) << i;
+    }
+}
@@ -3188,3 +3188,155 @@ TEST(ResultTests, CompareRes)
     EXPECT_FALSE(value != rad::ResultErr<MYSTATUS>(MYSTATUS_UNSUCCESSFUL));
     EXPECT_FALSE(rad::ResultErr<MYSTATUS>(MYSTATUS_UNSUCCESSFUL) != value);
 }
+
+namespace
+{
+enum class NicheErr : uint16_t
+{
+    Failed = 1,
+    Busy
+};
+
+template <typename T>
+using NicheResult = rad::Result<T, NicheErr>;
+
+struct Opaque;
+struct Linked;
+
+NicheResult<Opaque*> FindOpaque(Opaque* ptr)
+{
+    if (ptr == nullptr)
+    {
+        return NicheErr::Failed;
+    }
+
+    return ptr;
+}
+
+} // namespace
+
+namespace rad
+{
+template <>
+struct ResultPackPointee<Linked> : TrueType
+{
+};
+} // namespace rad
+
+namespace
+{
+// packed while still incomplete
+RAD_S_ASSERT(sizeof(NicheResult<Linked*>) == sizeof(void*));
+
+struct alignas(8) Linked
+{
+    Linked* next = nullptr;
+};
+
+} // namespace
+
+TEST(ResultTests, NicheLayout)
+{
+    RAD_S_ASSERT(sizeof(NicheResult<int&>) == sizeof(void*));
+    RAD_S_ASSERT(sizeof(NicheResult<int**>) == sizeof(void*));
+    RAD_S_ASSERT(sizeof(NicheResult<const Linked&>) == sizeof(void*));
+    RAD_S_ASSERT(sizeof(NicheResult<const int*>) == sizeof(void*));
+    RAD_S_ASSERT(sizeof(rad::Result<uint64_t*, uint8_t>) == sizeof(void*));
+
+    // no spare bit in the pointer, or no room for the error
+    RAD_S_ASSERT(sizeof(NicheResult<char&>) > sizeof(void*));
+    RAD_S_ASSERT(sizeof(NicheResult<void*>) > sizeof(void*));
+
+    // class types are packed only when opted in
+    RAD_S_ASSERT(sizeof(NicheResult<std::string&>) > sizeof(void*));
+    RAD_S_ASSERT(sizeof(rad::Result<int*, void*>) > sizeof(void*));
+    RAD_S_ASSERT(sizeof(rad::Result<int&, std::string>) > sizeof(void*));
+
+    // packed results are returned in a register
+    RAD_S_ASSERT(rad::IsTrivCopyCtor<NicheResult<int&>>);
+    RAD_S_ASSERT(rad::IsTrivMoveCtor<NicheResult<const int*>>);
+    RAD_S_ASSERT(rad::IsTrivCopyAssign<NicheResult<int*>>);
+    RAD_S_ASSERT(rad::IsTrivDtor<NicheResult<int*>>);
+    RAD_S_ASSERT(!rad::IsTrivCopyCtor<NicheResult<char*>>);
+}
+
+TEST(ResultTests, NicheIncompletePointee)
+{
+    // the layout never depends on whether the type is complete
+    RAD_S_ASSERT(sizeof(NicheResult<Opaque*>) > sizeof(void*));
+    RAD_S_ASSERT(sizeof(NicheResult<Opaque&>) > sizeof(void*));
+    RAD_S_ASSERT(sizeof(NicheResult<Linked*>) == sizeof(void*));
+
+    alignas(8) char storage[8] = {};
+    Opaque* opaque = reinterpret_cast<Opaque*>(storage);
+    NicheResult<Opaque*> res = FindOpaque(opaque);
+    ASSERT_TRUE(res.IsOk());
+    EXPECT_EQ(res.Ok(), opaque);
+    EXPECT_EQ(FindOpaque(nullptr), NicheErr::Failed);
+
+    NicheResult<Opaque&> ref = *opaque;
+    EXPECT_EQ(&ref.Ok(), opaque);
+
+    Linked first;
+    Linked second;
+    first.next = &second;
+    NicheResult<Linked*> next = first.next;
+    ASSERT_TRUE(next.IsOk());
+    EXPECT_EQ(next.Ok(), &second);
+    next = NicheErr::Busy;
+    EXPECT_EQ(next.Err(), NicheErr::Busy);
+}
+
+TEST(ResultTests, NicheStates)
+{
+    int value = 42;
+    int other = 7;
+
+    NicheResult<int&> res;
+    EXPECT_TRUE(res.IsEmpty());
+
+    res = value;
+    EXPECT_TRUE(res.IsOk());
+    EXPECT_EQ(&res.Ok(), &value);
+    EXPECT_EQ(*res, 42);
+
+    res = NicheErr::Busy;
+    EXPECT_TRUE(res.IsErr());
+    EXPECT_EQ(res.Err(), NicheErr::Busy);
+
+    NicheResult<int&> copy = res;
+    EXPECT_TRUE(copy.IsErr());
+    EXPECT_EQ(copy.Err(), NicheErr::Busy);
+
+    // packed results are trivially copied, moves included
+    copy = other;
+    NicheResult<int&> moved(std::move(copy));
+    EXPECT_EQ(&copy.Ok(), &other);
+    EXPECT_EQ(&moved.Ok(), &other);
+    NicheResult<int&> assigned;
+    EXPECT_TRUE(assigned.Assign(std::move(moved)).IsOk());
+    EXPECT_EQ(&moved.Ok(), &other);
+
+    moved = res;
+    EXPECT_TRUE(moved.IsErr());
+    EXPECT_TRUE(moved == res);
+    EXPECT_TRUE(moved != NicheResult<int&>(value));
+
+    // null is a valid "Ok" pointer
+    NicheResult<const int*> ptr = static_cast<const int*>(nullptr);
+    EXPECT_TRUE(ptr.IsOk());
+    EXPECT_EQ(ptr.Ok(), nullptr);
+    ptr = &value;
+    EXPECT_EQ(*ptr.Ok(), 42);
+    ptr = NicheErr::Failed;
+    EXPECT_TRUE(ptr.IsErr());
+    EXPECT_EQ(ptr.OnOk(1).Err(), NicheErr::Failed);
+
+    // converting to a result without the niche keeps the state
+    const NicheResult<const int*> narrow = &other;
+    NicheResult<const void*> wide = narrow;
+    EXPECT_EQ(wide.Ok(), &other);
+    const NicheResult<const int*> narrowErr = NicheErr::Failed;
+    wide = NicheResult<const void*>(narrowErr);
+    EXPECT_EQ(wide.Err(), NicheErr::Failed);
+}
@@ -0,0 +1,215 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/SeqLock.h"
+#include "radiant/SpinLocks.h"
+
+#include <stdint.h>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct Snapshot
+{
+    uint64_t version;
+    uint32_t values[13];
+};
+
+struct Point
+{
+    Point(int16_t px, int16_t py) noexcept
+        : x(px),
+          y(py)
+    {
+    }
+
+    int16_t x;
+    int16_t y;
+};
+
+// lock counting its acquisitions
+struct CountingLock
+{
+    void LockExclusive() noexcept
+    {
+        ++locks;
+    }
+
+    void Unlock() noexcept
+    {
+        ++unlocks;
+    }
+
+    int locks{};
+    int unlocks{};
+};
+
+Snapshot MakeSnapshot(uint64_t version)
+{
+    Snapshot snapshot;
+    snapshot.version = version;
+    for (uint32_t i = 0; i < 13; ++i)
+    {
+        snapshot.values[i] = static_cast<uint32_t>(version) * (i + 1);
+    }
+
+    return snapshot;
+}
+
+bool IsConsistent(const Snapshot& snapshot)
+{
+    for (uint32_t i = 0; i < 13; ++i)
+    {
+        const uint32_t version = static_cast<uint32_t>(snapshot.version);
+        if (snapshot.values[i] != version * (i + 1))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+RAD_S_ASSERT(rad::SeqLock<char>::WordCount == 1);
+RAD_S_ASSERT(rad::SeqLock<Snapshot>::WordCount * sizeof(uintptr_t) >=
+             sizeof(Snapshot));
+
+TEST(TestSeqLock, LoadStore)
+{
+    rad::SeqLock<Snapshot> lock;
+    Snapshot snapshot = lock.Load();
+    EXPECT_EQ(snapshot.version, 0u);
+    EXPECT_EQ(snapshot.values[12], 0u);
+    EXPECT_EQ(lock.Version(), 0u);
+
+    lock.Store(MakeSnapshot(3));
+    snapshot = lock.Load();
+    EXPECT_EQ(snapshot.version, 3u);
+    EXPECT_TRUE(IsConsistent(snapshot));
+    EXPECT_EQ(lock.Version(), 1u);
+
+    Snapshot other{};
+    EXPECT_TRUE(lock.TryLoad(other));
+    EXPECT_EQ(other.version, 3u);
+
+    rad::SeqLock<uint16_t> small(7);
+    EXPECT_EQ(small.Load(), 7u);
+    small.Store(9);
+    EXPECT_EQ(small.Load(), 9u);
+}
+
+TEST(TestSeqLock, NotDefaultConstructible)
+{
+    rad::SeqLock<Point> lock(Point(1, 2));
+    Point point = lock.Load();
+    EXPECT_EQ(point.x, 1);
+    EXPECT_EQ(point.y, 2);
+
+    lock.Store(Point(-3, 4));
+    lock.Update([](Point& p) noexcept { p.y = 5; });
+    point = lock.Load();
+    EXPECT_EQ(point.x, -3);
+    EXPECT_EQ(point.y, 5);
+}
+
+TEST(TestSeqLock, Update)
+{
+    rad::SeqLock<Snapshot, CountingLock> lock(MakeSnapshot(1));
+    lock.Update([](Snapshot& snapshot) noexcept
+                { snapshot = MakeSnapshot(snapshot.version + 1); });
+    lock.Store(MakeSnapshot(5));
+
+    EXPECT_EQ(lock.Load().version, 5u);
+    EXPECT_EQ(lock.Version(), 2u);
+    EXPECT_EQ(lock.WriterLock().locks, 2);
+    EXPECT_EQ(lock.WriterLock().unlocks, 2);
+}
+
+TEST(TestSeqLock, TryLoadDuringWrite)
+{
+    rad::SeqLock<Snapshot> lock(MakeSnapshot(1));
+    lock.Update(
+        [&lock](Snapshot& snapshot) noexcept
+        {
+            // the writer lock is held, but publishing has not started
+            Snapshot seen{};
+            EXPECT_TRUE(lock.TryLoad(seen));
+            EXPECT_EQ(seen.version, 1u);
+            snapshot.version = 2;
+        });
+
+    EXPECT_EQ(lock.Load().version, 2u);
+}
+
+TEST(TestSeqLock, Concurrent)
+{
+    constexpr int ReaderCount = 4;
+    constexpr uint64_t Writes = 5000;
+    rad::SeqLock<Snapshot, rad::QueuedSpinLock> lock(MakeSnapshot(0));
+    rad::Atomic<bool> done{ false };
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < ReaderCount; ++r)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                uint64_t last = 0;
+                while (!done.Load(rad::MemOrderAcquire))
+                {
+                    const Snapshot snapshot = lock.Load();
+                    ASSERT_TRUE(IsConsistent(snapshot));
+                    ASSERT_GE(snapshot.version, last);
+                    last = snapshot.version;
+                }
+            });
+    }
+
+    // two writers, each publishing every other version
+    std::thread writers[2];
+    for (uint64_t w = 0; w < 2; ++w)
+    {
+        writers[w] = std::thread(
+            [&lock]()
+            {
+                for (uint64_t i = 0; i < Writes; ++i)
+                {
+                    lock.Update(
+                        [](Snapshot& snapshot) noexcept
+                        { snapshot = MakeSnapshot(snapshot.version + 1); });
+                }
+            });
+    }
+
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+
+    done.Store(true, rad::MemOrderRelease);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(lock.Load().version, 2 * Writes);
+    EXPECT_EQ(lock.Version(), static_cast<uint32_t>(2 * Writes));
+}
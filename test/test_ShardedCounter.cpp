@@ -0,0 +1,88 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/ShardedCounter.h"
+
+#include <thread>
+
+RAD_S_ASSERT(sizeof(rad::ShardedCounter<uint64_t>) == 16 * RAD_CACHE_LINE_SIZE);
+RAD_S_ASSERT((sizeof(rad::ShardedCounter<int, 1>) == RAD_CACHE_LINE_SIZE));
+RAD_S_ASSERT((rad::ShardedCounter<int, 4>::ShardCount == 4));
+
+TEST(TestShardedCounter, AddSub)
+{
+    rad::ShardedCounter<int> counter;
+    EXPECT_EQ(counter.Load(), 0);
+
+    counter.Add(5);
+    counter.Add(3);
+    EXPECT_EQ(counter.Load(), 8);
+
+    counter.Sub(10);
+    EXPECT_EQ(counter.Load(), -2);
+
+    EXPECT_EQ(counter.Reset(), -2);
+    EXPECT_EQ(counter.Load(), 0);
+    EXPECT_EQ(counter.Reset(), 0);
+}
+
+TEST(TestShardedCounter, Unsigned)
+{
+    rad::ShardedCounter<uint32_t, 1> counter;
+    counter.Add(1);
+    counter.Sub(2);
+    EXPECT_EQ(counter.Load(), UINT32_MAX);
+    counter.Add(1);
+    EXPECT_EQ(counter.Load(), 0u);
+}
+
+TEST(TestShardedCounter, Concurrent)
+{
+    static constexpr int ThreadCount = 8;
+    static constexpr int Iterations = 20000;
+
+    rad::ShardedCounter<uint64_t> counter;
+    uint64_t drained[ThreadCount] = {};
+
+    std::thread threads[ThreadCount];
+    for (int i = 0; i < ThreadCount; ++i)
+    {
+        threads[i] = std::thread(
+            [&counter, &drained, i]
+            {
+                for (int j = 0; j < Iterations; ++j)
+                {
+                    counter.Add(2);
+                    counter.Sub(1);
+                    if (j % 1000 == 0)
+                    {
+                        drained[i] += counter.Reset();
+                    }
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    uint64_t total = counter.Load();
+    for (uint64_t value : drained)
+    {
+        total += value;
+    }
+    EXPECT_EQ(total, static_cast<uint64_t>(ThreadCount) * Iterations);
+}
@@ -20,8 +20,43 @@
 
 #include "radiant/SharedPtr.h"
 
+#include <thread>
+
+RAD_S_ASSERT(rad::IsTrivRelocatable<rad::SharedPtr<int>>);
+RAD_S_ASSERT(rad::IsTrivRelocatable<rad::WeakPtr<int>>);
+
 namespace sptestobjs
 {
+int g_Live = 0;
+int g_ThrowAt = -1;
+
+struct Counted
+{
+    Counted()
+        : value(g_Live)
+    {
+        if (g_Live == g_ThrowAt)
+        {
+            throw std::exception();
+        }
+
+        ++g_Live;
+    }
+
+    explicit Counted(int v)
+        : Counted()
+    {
+        value = v;
+    }
+
+    ~Counted()
+    {
+        --g_Live;
+    }
+
+    int value;
+};
+
 // clang-format off
 using NoThrowAllocSp = rad::SharedPtr<int>;
 using NoThrowObjBlock = rad::detail::PtrBlock<int, radtest::Mallocator>;
@@ -33,6 +68,11 @@ using NoThrowObjSp = NoThrowAllocSp;
 using ThrowObjSp = rad::SharedPtr<radtest::ThrowingObject>;
 // clang-format on
 
+// AtomicSharedPtr locks in the three low order bits of a block pointer
+RAD_S_ASSERT(alignof(NoThrowObjBlock) >= 8);
+RAD_S_ASSERT(alignof(rad::detail::PtrArrayBlock<char, radtest::Mallocator>) >=
+             8);
+
 // PtrBlock::PairType construction noexcept
 RAD_S_ASSERT(noexcept(NoThrowPair(rad::DeclVal<NoThrowPair::FirstType&>(), 1)));
 RAD_S_ASSERT(!noexcept(ThrowPair(rad::DeclVal<ThrowPair::FirstType&>())));
@@ -672,6 +712,133 @@ TEST(TestSharedPtr, UsesTypedAlloc)
     ptr.Reset();
 }
 
+TEST(TestSharedPtr, AllocateSharedArray)
+{
+    radtest::StatefulCountingAllocator alloc;
+    alloc.ResetCounts();
+
+    {
+        auto ptr = rad::AllocateSharedArray<sptestobjs::Counted>(alloc, 5);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_EQ(sptestobjs::g_Live, 5);
+        EXPECT_EQ(alloc.AllocCount(), 1u);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr.Get()) %
+                      alignof(max_align_t),
+                  0u);
+        for (int i = 0; i < 5; ++i)
+        {
+            EXPECT_EQ(ptr.Get()[i].value, i);
+        }
+
+        rad::WeakPtr<sptestobjs::Counted> wptr = ptr;
+        auto copy = ptr;
+        EXPECT_EQ(ptr.UseCount(), 2u);
+
+        ptr.Reset();
+        copy.Reset();
+        EXPECT_EQ(sptestobjs::g_Live, 0);
+        EXPECT_TRUE(wptr.Expired());
+        EXPECT_EQ(alloc.FreeCount(), 0u);
+    }
+
+    EXPECT_EQ(alloc.AllocCount(), 1u);
+    alloc.VerifyCounts();
+
+    auto ints = rad::AllocateSharedArray<int>(alloc, 3);
+    ASSERT_NE(ints, nullptr);
+    EXPECT_EQ(ints.Get()[0], 0);
+    EXPECT_EQ(ints.Get()[2], 0);
+}
+
+TEST(TestSharedPtr, AllocateSharedArrayFailure)
+{
+    radtest::StatefulCountingAllocator alloc;
+    alloc.ResetCounts();
+
+    sptestobjs::g_ThrowAt = 3;
+    EXPECT_THROW(rad::AllocateSharedArray<sptestobjs::Counted>(alloc, 5),
+                 std::exception);
+    sptestobjs::g_ThrowAt = -1;
+    EXPECT_EQ(sptestobjs::g_Live, 0);
+    alloc.VerifyCounts();
+
+    EXPECT_EQ(rad::AllocateSharedArray<int>(radtest::FailingAllocator(), 2),
+              nullptr);
+}
+
+TEST(TestSharedPtr, AllocateSharedBatch)
+{
+    radtest::StatefulCountingAllocator alloc;
+    alloc.ResetCounts();
+
+    {
+        rad::SharedPtr<sptestobjs::Counted> ptrs[4];
+        ASSERT_TRUE(rad::AllocateSharedBatch<sptestobjs::Counted>(
+                        alloc,
+                        rad::Span<rad::SharedPtr<sptestobjs::Counted>>(ptrs),
+                        9)
+                        .IsOk());
+        EXPECT_EQ(alloc.AllocCount(), 1u);
+        EXPECT_EQ(sptestobjs::g_Live, 4);
+
+        for (auto& ptr : ptrs)
+        {
+            ASSERT_NE(ptr, nullptr);
+            EXPECT_EQ(ptr->value, 9);
+            EXPECT_EQ(ptr.UseCount(), 1u);
+        }
+
+        EXPECT_NE(ptrs[0].Get(), ptrs[1].Get());
+
+        // each object has its own counts, the allocation outlives them all
+        rad::WeakPtr<sptestobjs::Counted> wptr = ptrs[1];
+        ptrs[1].Reset();
+        EXPECT_EQ(sptestobjs::g_Live, 3);
+        EXPECT_TRUE(wptr.Expired());
+        EXPECT_EQ(ptrs[0]->value, 9);
+
+        ptrs[0].Reset();
+        ptrs[2].Reset();
+        ptrs[3].Reset();
+        EXPECT_EQ(sptestobjs::g_Live, 0);
+        EXPECT_EQ(alloc.FreeCount(), 0u);
+    }
+
+    EXPECT_EQ(alloc.FreeCount(), 1u);
+    alloc.VerifyCounts();
+
+    rad::SharedPtr<int> ints[2];
+    rad::Span<rad::SharedPtr<int>> span(ints);
+    EXPECT_TRUE(rad::AllocateSharedBatch<int>(alloc, span.Subspan(0, 0)).IsOk());
+    EXPECT_TRUE(rad::AllocateSharedBatch<int>(alloc, span).IsOk());
+    EXPECT_EQ(*ints[0], 0);
+    EXPECT_EQ(*ints[1], 0);
+}
+
+TEST(TestSharedPtr, AllocateSharedBatchFailure)
+{
+    radtest::StatefulCountingAllocator alloc;
+    alloc.ResetCounts();
+
+    rad::SharedPtr<sptestobjs::Counted> ptrs[4];
+    rad::Span<rad::SharedPtr<sptestobjs::Counted>> span(ptrs);
+    sptestobjs::g_ThrowAt = 2;
+    EXPECT_THROW(rad::AllocateSharedBatch<sptestobjs::Counted>(alloc, span),
+                 std::exception);
+    sptestobjs::g_ThrowAt = -1;
+    EXPECT_EQ(sptestobjs::g_Live, 0);
+    alloc.VerifyCounts();
+
+    EXPECT_EQ(rad::AllocateSharedBatch<sptestobjs::Counted>(
+                  radtest::FailingAllocator(),
+                  span),
+              rad::Error::NoMemory);
+    for (auto& ptr : ptrs)
+    {
+        EXPECT_EQ(ptr, nullptr);
+    }
+}
+
 TEST(TestWeakPtr, ConstructEmpy)
 {
     rad::WeakPtr<int> weak;
@@ -933,6 +1100,76 @@ TEST(TestWeakPtr, PolymorphicAssign)
     alloc.VerifyCounts();
 }
 
+RAD_S_ASSERT(rad::IsTrivRelocatable<rad::LocalSharedPtr<int>>);
+RAD_S_ASSERT(!(rad::IsConv<rad::SharedPtr<int>, rad::LocalSharedPtr<int>>));
+RAD_S_ASSERT(!(rad::IsConv<rad::LocalSharedPtr<int>, rad::SharedPtr<int>>));
+RAD_S_ASSERT(sizeof(rad::LocalSharedPtr<int>) == sizeof(rad::SharedPtr<int>));
+
+TEST(TestLocalSharedPtr, AllocateLocalShared)
+{
+    radtest::StatefulCountingAllocator alloc;
+    alloc.ResetCounts();
+
+    {
+        rad::LocalSharedPtr<int> ptr = rad::AllocateLocalShared<int>(alloc, 7);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_EQ(*ptr, 7);
+        EXPECT_EQ(ptr.UseCount(), 1u);
+
+        auto copy = ptr;
+        EXPECT_EQ(ptr.UseCount(), 2u);
+        EXPECT_EQ(copy, ptr);
+
+        auto moved = rad::Move(copy);
+        EXPECT_EQ(copy, nullptr);
+        EXPECT_EQ(ptr.UseCount(), 2u);
+
+        moved.Reset();
+        EXPECT_EQ(ptr.UseCount(), 1u);
+        EXPECT_EQ(alloc.FreeCount(), 0u);
+    }
+
+    EXPECT_EQ(alloc.AllocCount(), 1u);
+    alloc.VerifyCounts();
+}
+
+TEST(TestLocalSharedPtr, MakeLocalShared)
+{
+    auto ptr = rad::MakeLocalShared<sptestobjs::Derived>();
+    ptr->extra = 2;
+
+    rad::LocalSharedPtr<sptestobjs::Extra> eptr = ptr;
+    EXPECT_EQ(eptr.Get(), static_cast<sptestobjs::Extra*>(ptr.Get()));
+    EXPECT_EQ(eptr->extra, 2);
+    EXPECT_EQ(ptr.UseCount(), 2u);
+}
+
+TEST(TestLocalSharedPtr, Weak)
+{
+    radtest::StatefulCountingAllocator alloc;
+    alloc.ResetCounts();
+
+    {
+        rad::LocalWeakPtr<int> wptr;
+        {
+            auto ptr = rad::AllocateLocalShared<int>(alloc, 3);
+            wptr = ptr;
+            EXPECT_EQ(ptr.WeakCount(), 2u);
+            EXPECT_FALSE(wptr.Expired());
+
+            auto locked = wptr.Lock();
+            EXPECT_EQ(locked, ptr);
+            EXPECT_EQ(ptr.UseCount(), 2u);
+        }
+
+        EXPECT_TRUE(wptr.Expired());
+        EXPECT_EQ(wptr.Lock(), nullptr);
+        EXPECT_EQ(alloc.FreeCount(), 0u);
+    }
+
+    alloc.VerifyCounts();
+}
+
 TEST(TestAtomicSharedPtr, Construct)
 {
     rad::AtomicSharedPtr<int> aptr;
@@ -992,6 +1229,111 @@ TEST(TestAtomicSharedPtr, ConversionOperator)
     EXPECT_EQ(ptrTwo.Get(), ptr.Get());
 }
 
+TEST(TestAtomicSharedPtr, ManyLoads)
+{
+    radtest::StatefulCountingAllocator alloc;
+    alloc.ResetCounts();
+
+    {
+        rad::AtomicSharedPtr<int> aptr(rad::AllocateShared<int>(alloc, 7));
+
+        // hold enough references to cycle through several batches
+        rad::SharedPtr<int> held[64];
+        for (int i = 0; i < 100000; ++i)
+        {
+            auto ptr = aptr.Load();
+            ASSERT_NE(ptr, nullptr);
+            EXPECT_EQ(*ptr, 7);
+            held[i % 64] = ptr;
+        }
+
+        aptr.Store(nullptr);
+        EXPECT_EQ(held[0].UseCount(), 64u);
+        EXPECT_EQ(alloc.FreeCount(), 0u);
+    }
+
+    EXPECT_EQ(alloc.AllocCount(), 1u);
+    alloc.VerifyCounts();
+}
+
+TEST(TestAtomicSharedPtr, Polymorphic)
+{
+    auto ptr = rad::MakeShared<sptestobjs::Derived>();
+    ptr->extra = 2;
+
+    rad::AtomicSharedPtr<sptestobjs::Extra> aptr(ptr);
+    rad::SharedPtr<sptestobjs::Extra> eptr = aptr.Load();
+    EXPECT_EQ(eptr.Get(), static_cast<sptestobjs::Extra*>(ptr.Get()));
+    EXPECT_EQ(eptr->extra, 2);
+
+    auto prev = aptr.Exchange(nullptr);
+    EXPECT_EQ(prev.Get(), eptr.Get());
+    EXPECT_EQ(aptr.Load(), nullptr);
+}
+
+namespace
+{
+struct AtomicTracked
+{
+    static rad::Atomic<int> g_Live;
+
+    explicit AtomicTracked(int v) noexcept
+        : value(v)
+    {
+        g_Live.FetchAdd(1, rad::MemOrderRelaxed);
+    }
+
+    ~AtomicTracked()
+    {
+        g_Live.FetchSub(1, rad::MemOrderRelaxed);
+    }
+
+    int value;
+};
+
+rad::Atomic<int> AtomicTracked::g_Live{ 0 };
+} // namespace
+
+TEST(TestAtomicSharedPtr, Concurrent)
+{
+    {
+        rad::AtomicSharedPtr<AtomicTracked> aptr(
+            rad::MakeShared<AtomicTracked>(0));
+
+        std::thread threads[4];
+        for (int t = 0; t < 4; ++t)
+        {
+            threads[t] = std::thread(
+                [&aptr, t]
+                {
+                    for (int i = 0; i < 20000; ++i)
+                    {
+                        if (i % 8 == 0)
+                        {
+                            aptr = rad::MakeShared<AtomicTracked>(t);
+                        }
+                        else
+                        {
+                            auto ptr = aptr.Load();
+                            EXPECT_NE(ptr, nullptr);
+                            EXPECT_GE(ptr->value, 0);
+                            EXPECT_LT(ptr->value, 4);
+                        }
+                    }
+                });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        EXPECT_EQ(AtomicTracked::g_Live.Load(rad::MemOrderRelaxed), 1);
+    }
+
+    EXPECT_EQ(AtomicTracked::g_Live.Load(rad::MemOrderRelaxed), 0);
+}
+
 TEST(TestAtomicWeakPtr, Construct)
 {
     rad::AtomicWeakPtr<int> aptr;
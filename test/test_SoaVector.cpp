@@ -0,0 +1,268 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/SoaVector.h"
+
+#include "test/TestAlloc.h"
+
+#include <stdint.h>
+
+namespace
+{
+int g_Live = 0;
+
+struct Tracked
+{
+    explicit Tracked(int v = -1) noexcept
+        : value(v)
+    {
+        ++g_Live;
+    }
+
+    Tracked(const Tracked& other) noexcept
+        : value(other.value)
+    {
+        ++g_Live;
+    }
+
+    Tracked(Tracked&& other) noexcept
+        : value(other.value)
+    {
+        other.value = -2;
+        ++g_Live;
+    }
+
+    Tracked& operator=(Tracked&& other) noexcept
+    {
+        value = other.value;
+        other.value = -2;
+        return *this;
+    }
+
+    ~Tracked()
+    {
+        --g_Live;
+    }
+
+    int value;
+};
+
+using Particles =
+    rad::SoaVector<radtest::Mallocator, float, double, uint8_t, int64_t>;
+
+bool IsAligned(const void* ptr, size_t align)
+{
+    return (reinterpret_cast<uintptr_t>(ptr) & (align - 1)) == 0;
+}
+} // namespace
+
+RAD_S_ASSERT(Particles::ColumnCount == 4);
+RAD_S_ASSERT((rad::IsSame<Particles::ColumnType<1>, double>));
+RAD_S_ASSERT((rad::IsSame<Particles::ColumnType<2>, uint8_t>));
+
+TEST(TestSoaVector, DefaultConstruct)
+{
+    Particles vec;
+    EXPECT_TRUE(vec.Empty());
+    EXPECT_EQ(vec.Size(), 0u);
+    EXPECT_EQ(vec.Capacity(), 0u);
+    EXPECT_EQ(vec.Data<0>(), nullptr);
+    EXPECT_EQ(vec.Column<1>().Size(), 0u);
+}
+
+TEST(TestSoaVector, PushBackColumns)
+{
+    Particles vec;
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(vec.PushBack(static_cast<float>(i),
+                                 i * 0.5,
+                                 static_cast<uint8_t>(i),
+                                 int64_t{ i } << 33)
+                        .IsOk());
+    }
+
+    EXPECT_EQ(vec.Size(), 1000u);
+    EXPECT_GE(vec.Capacity(), 1000u);
+
+    // each column is its own suitably aligned array
+    EXPECT_TRUE(IsAligned(vec.Data<0>(), alignof(float)));
+    EXPECT_TRUE(IsAligned(vec.Data<1>(), alignof(double)));
+    EXPECT_TRUE(IsAligned(vec.Data<3>(), alignof(int64_t)));
+
+    rad::Span<float> x = vec.Column<0>();
+    rad::Span<double> v = vec.Column<1>();
+    ASSERT_EQ(x.Size(), 1000u);
+    ASSERT_EQ(v.Size(), 1000u);
+    for (uint32_t i = 0; i < x.Size(); ++i)
+    {
+        x[i] += static_cast<float>(v[i]);
+    }
+
+    const Particles& cvec = vec;
+    rad::Span<const uint8_t> tags = cvec.Column<2>();
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(cvec.At<0>(i), static_cast<float>(i) * 1.5f);
+        EXPECT_EQ(tags[i], static_cast<uint8_t>(i));
+        EXPECT_EQ(cvec.At<3>(i), int64_t{ i } << 33);
+    }
+}
+
+TEST(TestSoaVector, Erase)
+{
+    rad::SoaVector<radtest::Mallocator, int, Tracked> vec;
+    for (int i = 0; i < 6; ++i)
+    {
+        ASSERT_TRUE(vec.EmplaceBack(i, i * 10).IsOk());
+    }
+
+    EXPECT_EQ(g_Live, 6);
+
+    vec.Erase(1);
+    EXPECT_EQ(g_Live, 5);
+    const int ordered[] = { 0, 2, 3, 4, 5 };
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        EXPECT_EQ(vec.At<0>(i), ordered[i]);
+        EXPECT_EQ(vec.At<1>(i).value, ordered[i] * 10);
+    }
+
+    vec.EraseUnordered(0);
+    EXPECT_EQ(vec.At<0>(0), 5);
+    EXPECT_EQ(vec.At<1>(0).value, 50);
+    vec.EraseUnordered(3);
+    vec.PopBack();
+    EXPECT_EQ(vec.Size(), 2u);
+    EXPECT_EQ(g_Live, 2);
+    EXPECT_EQ(vec.At<0>(1), 2);
+    EXPECT_EQ(vec.At<1>(1).value, 20);
+
+    vec.Clear();
+    EXPECT_TRUE(vec.Empty());
+    EXPECT_EQ(g_Live, 0);
+}
+
+TEST(TestSoaVector, Resize)
+{
+    {
+        rad::SoaVector<radtest::Mallocator, int, Tracked> vec;
+        ASSERT_TRUE(vec.Resize(10).IsOk());
+        EXPECT_EQ(g_Live, 10);
+        for (uint32_t i = 0; i < 10; ++i)
+        {
+            EXPECT_EQ(vec.At<0>(i), 0);
+            EXPECT_EQ(vec.At<1>(i).value, -1);
+        }
+
+        ASSERT_TRUE(vec.Resize(4).IsOk());
+        EXPECT_EQ(g_Live, 4);
+        EXPECT_EQ(vec.Size(), 4u);
+
+        ASSERT_TRUE(vec.Reserve(100).IsOk());
+        EXPECT_EQ(vec.Capacity(), 100u);
+        ASSERT_TRUE(vec.Reserve(50).IsOk());
+        EXPECT_EQ(vec.Capacity(), 100u);
+        EXPECT_EQ(g_Live, 4);
+    }
+
+    EXPECT_EQ(g_Live, 0);
+}
+
+TEST(TestSoaVector, Allocations)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        rad::SoaVector<radtest::CountingAllocator, int, double> vec;
+        ASSERT_TRUE(vec.Reserve(64).IsOk());
+        EXPECT_EQ(counter.AllocCount(), 1u);
+
+        // every column grows in a single allocation
+        for (int i = 0; i < 65; ++i)
+        {
+            ASSERT_TRUE(vec.PushBack(i, i).IsOk());
+        }
+
+        EXPECT_EQ(counter.AllocCount(), 2u);
+        EXPECT_EQ(counter.FreeCount(), 1u);
+        EXPECT_EQ(vec.Capacity(), 96u);
+        for (uint32_t i = 0; i < 65; ++i)
+        {
+            EXPECT_EQ(vec.At<0>(i), static_cast<int>(i));
+            EXPECT_EQ(vec.At<1>(i), i);
+        }
+    }
+
+    counter.VerifyCounts();
+}
+
+TEST(TestSoaVector, NoMemory)
+{
+    rad::SoaVector<radtest::FailingAllocator, int, float> failing;
+    EXPECT_EQ(failing.PushBack(1, 1.0f), rad::Error::NoMemory);
+    EXPECT_EQ(failing.Reserve(10), rad::Error::NoMemory);
+    EXPECT_EQ(failing.Resize(10), rad::Error::NoMemory);
+    EXPECT_TRUE(failing.Empty());
+
+    rad::SoaVector<radtest::OOMAllocator, int, Tracked> vec(
+        radtest::OOMAllocator(1));
+    ASSERT_TRUE(vec.EmplaceBack(1, 1).IsOk());
+    ASSERT_TRUE(vec.Resize(vec.Capacity()).IsOk());
+    EXPECT_EQ(vec.EmplaceBack(2, 2), rad::Error::NoMemory);
+    EXPECT_EQ(vec.At<1>(0).value, 1);
+    EXPECT_EQ(vec.Size(), vec.Capacity());
+}
+
+TEST(TestSoaVector, MoveSwapClone)
+{
+    {
+        rad::SoaVector<radtest::Mallocator, int, Tracked> a;
+        for (int i = 0; i < 20; ++i)
+        {
+            ASSERT_TRUE(a.EmplaceBack(i, i).IsOk());
+        }
+
+        rad::SoaVector<radtest::Mallocator, int, Tracked> b(std::move(a));
+        EXPECT_TRUE(a.Empty());
+        EXPECT_EQ(a.Capacity(), 0u);
+        EXPECT_EQ(b.Size(), 20u);
+        EXPECT_EQ(g_Live, 20);
+
+        ASSERT_TRUE(a.EmplaceBack(-1, -1).IsOk());
+        a.Swap(b);
+        EXPECT_EQ(a.Size(), 20u);
+        EXPECT_EQ(b.At<1>(0).value, -1);
+
+        auto res = a.Clone();
+        ASSERT_TRUE(res.IsOk());
+        EXPECT_EQ(g_Live, 41);
+        for (uint32_t i = 0; i < 20; ++i)
+        {
+            EXPECT_EQ(res.Ok().At<0>(i), static_cast<int>(i));
+            EXPECT_EQ(res.Ok().At<1>(i).value, static_cast<int>(i));
+        }
+
+        b = std::move(res.Ok());
+        EXPECT_EQ(b.Size(), 20u);
+        EXPECT_EQ(g_Live, 40);
+    }
+
+    EXPECT_EQ(g_Live, 0);
+
+    rad::SoaVector<radtest::FailingAllocator, int> empty;
+    EXPECT_TRUE(empty.Clone().IsOk());
+}
@@ -0,0 +1,274 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "gtest/gtest.h"
+
+#include "radiant/SpanCursor.h"
+
+#include <string.h>
+
+namespace
+{
+
+template <size_t N>
+rad::Span<const rad::Byte> Bytes(const uint8_t (&data)[N])
+{
+    return rad::Span<const uint8_t>(data).AsBytes();
+}
+
+} // namespace
+
+TEST(TestSpanCursor, FixedWidthLittle)
+{
+    const uint8_t data[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                             0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+                             0x0f, 0xff, 0xfe };
+    rad::SpanReader reader(Bytes(data));
+    EXPECT_EQ(reader.Size(), 17u);
+
+    EXPECT_EQ(reader.ReadU8().Ok(), 0x01u);
+    EXPECT_EQ(reader.ReadLittle<uint16_t>().Ok(), 0x0302u);
+    EXPECT_EQ(reader.ReadLittle<uint32_t>().Ok(), 0x07060504u);
+    EXPECT_EQ(reader.ReadLittle<uint64_t>().Ok(), 0x0f0e0d0c0b0a0908u);
+    EXPECT_EQ(reader.ReadLittle<int16_t>().Ok(), -257);
+    EXPECT_TRUE(reader.AtEnd());
+    EXPECT_EQ(reader.Remaining(), 0u);
+    EXPECT_EQ(reader.ReadU8().Err(), rad::Error::OutOfRange);
+}
+
+TEST(TestSpanCursor, FixedWidthBig)
+{
+    const uint8_t data[] = { 0x01, 0x02, 0x03, 0x04, 0x05,
+                             0x06, 0x07, 0x08, 0xff, 0xfe };
+    rad::SpanReader reader(Bytes(data));
+    EXPECT_EQ(reader.ReadBig<uint16_t>().Ok(), 0x0102u);
+    EXPECT_EQ(reader.Read<uint32_t>(rad::ByteOrder::Big).Ok(), 0x03040506u);
+    EXPECT_EQ(reader.ReadBig<uint16_t>().Ok(), 0x0708u);
+    EXPECT_EQ(reader.ReadBig<int16_t>().Ok(), -2);
+
+    ASSERT_TRUE(reader.Seek(0).IsOk());
+    EXPECT_EQ(reader.ReadBig<uint64_t>().Ok(), 0x0102030405060708u);
+    EXPECT_EQ(reader.ReadBig<int8_t>().Ok(), -1);
+}
+
+TEST(TestSpanCursor, ShortReadLeavesPosition)
+{
+    const uint8_t data[] = { 1, 2, 3 };
+    rad::SpanReader reader(Bytes(data));
+    ASSERT_TRUE(reader.Skip(1).IsOk());
+
+    EXPECT_EQ(reader.ReadLittle<uint32_t>().Err(), rad::Error::OutOfRange);
+    EXPECT_EQ(reader.ReadSpan(3).Err(), rad::Error::OutOfRange);
+    EXPECT_EQ(reader.Skip(3).Err(), rad::Error::OutOfRange);
+    EXPECT_EQ(reader.Seek(4).Err(), rad::Error::OutOfRange);
+    EXPECT_EQ(reader.Position(), 1u);
+    EXPECT_EQ(reader.ReadLittle<uint16_t>().Ok(), 0x0302u);
+
+    rad::SpanReader empty;
+    EXPECT_TRUE(empty.AtEnd());
+    EXPECT_EQ(empty.ReadVarint().Err(), rad::Error::OutOfRange);
+    EXPECT_TRUE(empty.ReadSpan(0).IsOk());
+}
+
+TEST(TestSpanCursor, ZeroCopySlices)
+{
+    // a length-prefixed nested message followed by a trailer
+    const uint8_t data[] = { 3, 0xaa, 0xbb, 0xcc, 0x7f };
+    rad::SpanReader reader(Bytes(data));
+
+    const auto length = reader.ReadU8();
+    ASSERT_TRUE(length.IsOk());
+    auto nested = reader.ReadReader(length.Ok());
+    ASSERT_TRUE(nested.IsOk());
+    EXPECT_EQ(nested.Ok().Size(), 3u);
+    EXPECT_EQ(nested.Ok().Data().Data(),
+              reinterpret_cast<const rad::Byte*>(data + 1));
+    EXPECT_EQ(nested.Ok().ReadBig<uint16_t>().Ok(), 0xaabbu);
+    EXPECT_EQ(nested.Ok().RemainingData().Size(), 1u);
+
+    EXPECT_EQ(reader.Position(), 4u);
+    const auto trailer = reader.ReadSpan(1);
+    ASSERT_TRUE(trailer.IsOk());
+    EXPECT_EQ(trailer.Ok().Data(),
+              reinterpret_cast<const rad::Byte*>(data + 4));
+
+    ASSERT_TRUE(reader.Seek(1).IsOk());
+    uint8_t copy[2] = {};
+    ASSERT_TRUE(
+        reader.ReadInto(rad::Span<uint8_t>(copy).AsBytes()).IsOk());
+    EXPECT_EQ(copy[0], 0xaa);
+    EXPECT_EQ(copy[1], 0xbb);
+    EXPECT_EQ(reader.Position(), 3u);
+}
+
+TEST(TestSpanCursor, Varint)
+{
+    const uint64_t values[] = { 0,
+                                1,
+                                127,
+                                128,
+                                300,
+                                16383,
+                                16384,
+                                0xffffffffu,
+                                0x7fffffffffffffffu,
+                                0xffffffffffffffffu };
+
+    uint8_t buffer[128] = {};
+    rad::SpanWriter writer(rad::Span<uint8_t>(buffer).AsBytes());
+    for (uint64_t value : values)
+    {
+        ASSERT_TRUE(writer.WriteVarint(value).IsOk());
+    }
+
+    // 300 is the usual example, 0xac 0x02
+    EXPECT_EQ(buffer[5], 0xac);
+    EXPECT_EQ(buffer[6], 0x02);
+    EXPECT_EQ(writer.Position(), 1u + 1 + 1 + 2 + 2 + 2 + 3 + 5 + 9 + 10);
+
+    rad::SpanReader reader(writer.Written());
+    for (uint64_t value : values)
+    {
+        EXPECT_EQ(reader.ReadVarint().Ok(), value);
+    }
+
+    EXPECT_TRUE(reader.AtEnd());
+}
+
+TEST(TestSpanCursor, SignedVarint)
+{
+    const int64_t values[] = { 0,  -1,  1,         -2,       63,
+                               -64, 64, INT64_MAX, INT64_MIN };
+
+    uint8_t buffer[64] = {};
+    rad::SpanWriter writer(rad::Span<uint8_t>(buffer).AsBytes());
+    for (int64_t value : values)
+    {
+        ASSERT_TRUE(writer.WriteSignedVarint(value).IsOk());
+    }
+
+    // zigzag keeps small magnitudes in a single byte
+    EXPECT_EQ(buffer[1], 1);
+    EXPECT_EQ(buffer[2], 2);
+    EXPECT_EQ(buffer[3], 3);
+
+    rad::SpanReader reader(writer.Written());
+    for (int64_t value : values)
+    {
+        EXPECT_EQ(reader.ReadSignedVarint().Ok(), value);
+    }
+}
+
+TEST(TestSpanCursor, MalformedVarint)
+{
+    // ends while the continuation bit is still set
+    const uint8_t truncated[] = { 0x80, 0x80 };
+    rad::SpanReader reader(Bytes(truncated));
+    EXPECT_EQ(reader.ReadVarint().Err(), rad::Error::OutOfRange);
+    EXPECT_EQ(reader.Position(), 0u);
+
+    // the tenth byte may only hold the top bit of a 64-bit value
+    const uint8_t tooBig[] = { 0xff, 0xff, 0xff, 0xff, 0xff,
+                               0xff, 0xff, 0xff, 0xff, 0x02 };
+    reader = rad::SpanReader(Bytes(tooBig));
+    EXPECT_EQ(reader.ReadVarint().Err(), rad::Error::IntegerOverflow);
+
+    const uint8_t tooLong[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+                                0x80, 0x80, 0x80, 0x81, 0x00 };
+    reader = rad::SpanReader(Bytes(tooLong));
+    EXPECT_EQ(reader.ReadVarint().Err(), rad::Error::IntegerOverflow);
+    EXPECT_EQ(reader.Position(), 0u);
+}
+
+TEST(TestSpanCursor, Writer)
+{
+    uint8_t buffer[16];
+    memset(buffer, 0xee, sizeof(buffer));
+    rad::SpanWriter writer(rad::Span<uint8_t>(buffer).AsBytes());
+    EXPECT_EQ(writer.Size(), 16u);
+
+    ASSERT_TRUE(writer.WriteU8(0x01).IsOk());
+    ASSERT_TRUE(writer.WriteLittle<uint16_t>(0x0302).IsOk());
+    ASSERT_TRUE(writer.WriteBig<uint32_t>(0x04050607).IsOk());
+    ASSERT_TRUE(writer.Write<int16_t>(-2, rad::ByteOrder::Big).IsOk());
+    EXPECT_EQ(writer.Position(), 9u);
+
+    const uint8_t expected[] = { 0x01, 0x02, 0x03, 0x04, 0x05,
+                                 0x06, 0x07, 0xff, 0xfe };
+    EXPECT_EQ(memcmp(buffer, expected, sizeof(expected)), 0);
+
+    // running out of space writes nothing
+    ASSERT_TRUE(writer.Skip(4).IsOk());
+    EXPECT_EQ(writer.WriteLittle<uint64_t>(0).Err(), rad::Error::OutOfRange);
+    EXPECT_EQ(writer.WriteVarint(UINT64_MAX).Err(), rad::Error::OutOfRange);
+    EXPECT_EQ(writer.Position(), 13u);
+    EXPECT_EQ(buffer[13], 0xee);
+
+    const uint8_t tail[] = { 0xa0, 0xa1, 0xa2 };
+    ASSERT_TRUE(writer.Write(Bytes(tail)).IsOk());
+    EXPECT_EQ(writer.Remaining(), 0u);
+    EXPECT_EQ(writer.WriteU8(0).Err(), rad::Error::OutOfRange);
+    EXPECT_EQ(writer.Written().Size(), 16u);
+    EXPECT_EQ(buffer[15], 0xa2);
+}
+
+TEST(TestSpanCursor, WriterInPlace)
+{
+    uint8_t buffer[16] = {};
+    rad::SpanWriter writer(rad::Span<uint8_t>(buffer).AsBytes());
+
+    // reserve a length prefix, encode the body, then fill the prefix in
+    auto prefix = writer.Reserve(2);
+    ASSERT_TRUE(prefix.IsOk());
+    rad::SpanWriter body = writer.RemainingWriter();
+    ASSERT_TRUE(body.WriteBig<uint32_t>(0xdeadbeef).IsOk());
+    ASSERT_TRUE(body.WriteVarint(300).IsOk());
+    ASSERT_TRUE(writer.Skip(body.Position()).IsOk());
+
+    rad::SpanWriter length(prefix.Ok());
+    ASSERT_TRUE(length.WriteBig<uint16_t>(
+                          static_cast<uint16_t>(body.Position()))
+                    .IsOk());
+    EXPECT_EQ(writer.Position(), 8u);
+    EXPECT_EQ(writer.Reserve(9).Err(), rad::Error::OutOfRange);
+
+    rad::SpanReader reader(writer.Written());
+    const auto size = reader.ReadBig<uint16_t>();
+    ASSERT_TRUE(size.IsOk());
+    EXPECT_EQ(size.Ok(), 6u);
+    auto nested = reader.ReadReader(size.Ok());
+    ASSERT_TRUE(nested.IsOk());
+    EXPECT_EQ(nested.Ok().ReadBig<uint32_t>().Ok(), 0xdeadbeefu);
+    EXPECT_EQ(nested.Ok().ReadVarint().Ok(), 300u);
+    EXPECT_TRUE(nested.Ok().AtEnd());
+    EXPECT_TRUE(reader.AtEnd());
+}
+
+TEST(TestSpanCursor, IntegerTypes)
+{
+    uint8_t buffer[32] = {};
+    rad::SpanWriter writer(rad::Span<uint8_t>(buffer).AsBytes());
+    ASSERT_TRUE(writer.WriteBig<long long>(-3).IsOk());
+    ASSERT_TRUE(writer.WriteLittle<unsigned long>(7).IsOk());
+    ASSERT_TRUE(writer.WriteBig<char>('x').IsOk());
+    ASSERT_TRUE(writer.WriteLittle<int8_t>(-5).IsOk());
+
+    rad::SpanReader reader(writer.Written());
+    EXPECT_EQ(reader.ReadBig<long long>().Ok(), -3);
+    EXPECT_EQ(reader.ReadLittle<unsigned long>().Ok(), 7u);
+    EXPECT_EQ(reader.ReadBig<char>().Ok(), 'x');
+    EXPECT_EQ(reader.ReadLittle<int8_t>().Ok(), -5);
+    EXPECT_TRUE(reader.AtEnd());
+}
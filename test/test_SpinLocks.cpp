@@ -0,0 +1,244 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/Locks.h"
+#include "radiant/SpinLocks.h"
+
+#include <chrono>
+#include <thread>
+
+namespace
+{
+constexpr int ThreadCount = 8;
+constexpr int Iterations = 5000;
+
+template <typename TLock>
+void ExclusiveStress()
+{
+    TLock lock;
+    int counter = 0;
+    rad::Atomic<int> inside{ 0 };
+    rad::Atomic<int> overlaps{ 0 };
+
+    std::thread threads[ThreadCount];
+    for (auto& thread : threads)
+    {
+        thread = std::thread(
+            [&]
+            {
+                for (int i = 0; i < Iterations; ++i)
+                {
+                    rad::LockExclusive<TLock> guard(lock);
+                    if (inside.FetchAdd(1, rad::MemOrderSeqCst) != 0)
+                    {
+                        overlaps.FetchAdd(1, rad::MemOrderSeqCst);
+                    }
+                    ++counter;
+                    inside.FetchSub(1, rad::MemOrderSeqCst);
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(overlaps.Load(rad::MemOrderSeqCst), 0);
+    EXPECT_EQ(counter, ThreadCount * Iterations);
+}
+
+template <typename TLock>
+void LongHold()
+{
+    // waiters exhaust their spin and park until the holder unlocks
+    TLock lock;
+    rad::Atomic<int> acquired{ 0 };
+
+    lock.LockExclusive();
+    std::thread threads[3];
+    for (auto& thread : threads)
+    {
+        thread = std::thread(
+            [&]
+            {
+                rad::LockExclusive<TLock> guard(lock);
+                acquired.FetchAdd(1, rad::MemOrderSeqCst);
+            });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(acquired.Load(rad::MemOrderSeqCst), 0);
+    lock.Unlock();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(acquired.Load(rad::MemOrderSeqCst), 3);
+}
+} // namespace
+
+TEST(TestTicketSpinLock, TryLock)
+{
+    rad::TicketSpinLock lock;
+    EXPECT_TRUE(lock.TryLockExclusive());
+    EXPECT_FALSE(lock.TryLockExclusive());
+    lock.Unlock();
+
+    {
+        rad::LockExclusive<rad::TicketSpinLock> guard(lock);
+        EXPECT_FALSE(lock.TryLockExclusive());
+    }
+    EXPECT_TRUE(lock.TryLockExclusive());
+    lock.Unlock();
+}
+
+TEST(TestTicketSpinLock, LongHold)
+{
+    LongHold<rad::TicketSpinLock>();
+}
+
+TEST(TestTicketSpinLock, Concurrent)
+{
+    ExclusiveStress<rad::TicketSpinLock>();
+}
+
+TEST(TestRWSpinLock, TryLock)
+{
+    rad::RWSpinLock lock;
+    EXPECT_TRUE(lock.TryLockShared());
+    EXPECT_TRUE(lock.TryLockShared());
+    EXPECT_FALSE(lock.TryLockExclusive());
+    lock.Unlock();
+    EXPECT_FALSE(lock.TryLockExclusive());
+    lock.Unlock();
+
+    EXPECT_TRUE(lock.TryLockExclusive());
+    EXPECT_FALSE(lock.TryLockShared());
+    EXPECT_FALSE(lock.TryLockExclusive());
+    lock.Unlock();
+
+    {
+        rad::LockShared<rad::RWSpinLock> guard(lock);
+        EXPECT_TRUE(lock.TryLockShared());
+        lock.Unlock();
+    }
+    {
+        rad::LockExclusive<rad::RWSpinLock> guard(lock);
+        EXPECT_FALSE(lock.TryLockShared());
+    }
+    EXPECT_TRUE(lock.TryLockExclusive());
+    lock.Unlock();
+}
+
+TEST(TestRWSpinLock, WriterPreference)
+{
+    rad::RWSpinLock lock;
+    lock.LockShared();
+
+    rad::Atomic<int> acquired{ 0 };
+    std::thread writer(
+        [&]
+        {
+            rad::LockExclusive<rad::RWSpinLock> guard(lock);
+            acquired.Store(1, rad::MemOrderSeqCst);
+        });
+
+    // once the writer waits, new readers are turned away
+    while (lock.TryLockShared())
+    {
+        lock.Unlock();
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(acquired.Load(rad::MemOrderSeqCst), 0);
+
+    lock.Unlock();
+    writer.join();
+    EXPECT_EQ(acquired.Load(rad::MemOrderSeqCst), 1);
+    EXPECT_TRUE(lock.TryLockShared());
+    lock.Unlock();
+}
+
+TEST(TestRWSpinLock, LongHold)
+{
+    LongHold<rad::RWSpinLock>();
+}
+
+TEST(TestRWSpinLock, Concurrent)
+{
+    ExclusiveStress<rad::RWSpinLock>();
+
+    rad::RWSpinLock lock;
+    int value = 0;
+    rad::Atomic<int> torn{ 0 };
+
+    std::thread threads[ThreadCount];
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads[t] = std::thread(
+            [&, t]
+            {
+                for (int i = 0; i < Iterations; ++i)
+                {
+                    if (t % 2 == 0)
+                    {
+                        rad::LockExclusive<rad::RWSpinLock> guard(lock);
+                        value += 2;
+                    }
+                    else
+                    {
+                        rad::LockShared<rad::RWSpinLock> guard(lock);
+                        if (value % 2 != 0)
+                        {
+                            torn.FetchAdd(1, rad::MemOrderSeqCst);
+                        }
+                    }
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(torn.Load(rad::MemOrderSeqCst), 0);
+    EXPECT_EQ(value, ThreadCount / 2 * Iterations * 2);
+}
+
+TEST(TestQueuedSpinLock, TryLock)
+{
+    rad::QueuedSpinLock lock;
+    EXPECT_TRUE(lock.TryLockExclusive());
+    EXPECT_FALSE(lock.TryLockExclusive());
+    lock.Unlock();
+
+    {
+        rad::LockExclusive<rad::QueuedSpinLock> guard(lock);
+        EXPECT_FALSE(lock.TryLockExclusive());
+    }
+    EXPECT_TRUE(lock.TryLockExclusive());
+    lock.Unlock();
+}
+
+TEST(TestQueuedSpinLock, LongHold)
+{
+    LongHold<rad::QueuedSpinLock>();
+}
+
+TEST(TestQueuedSpinLock, Concurrent)
+{
+    ExclusiveStress<rad::QueuedSpinLock>();
+}
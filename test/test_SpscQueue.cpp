@@ -0,0 +1,231 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/SpscQueue.h"
+
+#include "test/TestAlloc.h"
+
+#include <thread>
+
+namespace
+{
+int g_Live = 0;
+
+struct Tracked
+{
+    Tracked() noexcept
+        : value(0)
+    {
+        ++g_Live;
+    }
+
+    explicit Tracked(int v) noexcept
+        : value(v)
+    {
+        ++g_Live;
+    }
+
+    Tracked(Tracked&& other) noexcept
+        : value(other.value)
+    {
+        other.value = -1;
+        ++g_Live;
+    }
+
+    Tracked& operator=(Tracked&& other) noexcept
+    {
+        value = other.value;
+        other.value = -1;
+        return *this;
+    }
+
+    ~Tracked()
+    {
+        --g_Live;
+    }
+
+    int value;
+};
+
+using IntQueue = rad::SpscQueue<int, radtest::Mallocator>;
+} // namespace
+
+TEST(TestSpscQueue, Uninitialized)
+{
+    IntQueue queue;
+    EXPECT_EQ(queue.Capacity(), 0u);
+    EXPECT_EQ(queue.TryPush(1), rad::Error::OutOfRange);
+    EXPECT_EQ(queue.TryPop(), rad::Error::OutOfRange);
+
+    int items[2] = { 1, 2 };
+    EXPECT_EQ(queue.PushBatch(items), 0u);
+    EXPECT_EQ(queue.PopBatch(items), 0u);
+}
+
+TEST(TestSpscQueue, Capacity)
+{
+    IntQueue queue;
+    EXPECT_TRUE(queue.Init(1).IsOk());
+    EXPECT_EQ(queue.Capacity(), 1u);
+    EXPECT_TRUE(queue.TryPush(1).IsOk());
+    EXPECT_EQ(queue.TryPush(2), rad::Error::OutOfRange);
+
+    EXPECT_TRUE(queue.Init(3).IsOk());
+    EXPECT_EQ(queue.Capacity(), 4u);
+    EXPECT_EQ(queue.ApproxSize(), 0u);
+    EXPECT_EQ(queue.Init(~size_t(0)), rad::Error::IntegerOverflow);
+
+    rad::SpscQueue<int, radtest::FailingAllocator> failing;
+    EXPECT_EQ(failing.Init(4), rad::Error::NoMemory);
+    EXPECT_EQ(failing.Capacity(), 0u);
+}
+
+TEST(TestSpscQueue, Fifo)
+{
+    IntQueue queue;
+    ASSERT_TRUE(queue.Init(4).IsOk());
+
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_TRUE(queue.TryPush(round * 10 + i).IsOk());
+        }
+        EXPECT_EQ(queue.TryPush(99), rad::Error::OutOfRange);
+        EXPECT_EQ(queue.ApproxSize(), 4u);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            auto res = queue.TryPop();
+            ASSERT_TRUE(res.IsOk());
+            EXPECT_EQ(res.Ok(), round * 10 + i);
+        }
+        EXPECT_EQ(queue.TryPop(), rad::Error::OutOfRange);
+    }
+}
+
+TEST(TestSpscQueue, Batch)
+{
+    IntQueue queue;
+    ASSERT_TRUE(queue.Init(8).IsOk());
+
+    int in[6] = { 1, 2, 3, 4, 5, 6 };
+    EXPECT_EQ(queue.PushBatch(in), 6u);
+    // only the free slots are filled, wrapping around the end
+    EXPECT_EQ(queue.PushBatch(in), 2u);
+    EXPECT_EQ(queue.ApproxSize(), 8u);
+
+    int out[5] = {};
+    EXPECT_EQ(queue.PopBatch(out), 5u);
+    EXPECT_EQ(out[0], 1);
+    EXPECT_EQ(out[4], 5);
+
+    EXPECT_EQ(queue.PushBatch(rad::Span<int>(in + 2, 4)), 4u);
+
+    int rest[16] = {};
+    EXPECT_EQ(queue.PopBatch(rest), 7u);
+    const int expected[7] = { 6, 1, 2, 3, 4, 5, 6 };
+    for (int i = 0; i < 7; ++i)
+    {
+        EXPECT_EQ(rest[i], expected[i]);
+    }
+    EXPECT_EQ(queue.PopBatch(rest), 0u);
+}
+
+TEST(TestSpscQueue, ElementLifetime)
+{
+    g_Live = 0;
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        rad::SpscQueue<Tracked, radtest::CountingAllocator> queue;
+        ASSERT_TRUE(queue.Init(4).IsOk());
+
+        Tracked items[3];
+        items[0].value = 1;
+        items[1].value = 2;
+        items[2].value = 3;
+        EXPECT_EQ(queue.PushBatch(items), 3u);
+        EXPECT_EQ(items[0].value, -1);
+        EXPECT_EQ(g_Live, 6);
+
+        Tracked out[2];
+        EXPECT_EQ(queue.PopBatch(out), 2u);
+        EXPECT_EQ(out[0].value, 1);
+        EXPECT_EQ(out[1].value, 2);
+        EXPECT_EQ(g_Live, 6);
+    }
+    EXPECT_EQ(g_Live, 0);
+    counter.VerifyCounts(1, 1);
+    counter.VerifyCounts();
+}
+
+TEST(TestSpscQueue, Concurrent)
+{
+    static constexpr uint64_t Count = 200000;
+
+    rad::SpscQueue<uint64_t, radtest::Mallocator> queue;
+    ASSERT_TRUE(queue.Init(256).IsOk());
+
+    std::thread producer(
+        [&queue]
+        {
+            uint64_t batch[16];
+            uint64_t next = 1;
+            while (next <= Count)
+            {
+                size_t n = 0;
+                for (; n < 16 && next + n <= Count; ++n)
+                {
+                    batch[n] = next + n;
+                }
+
+                size_t pushed = 0;
+                while (pushed < n)
+                {
+                    const size_t count = queue.PushBatch(
+                        rad::Span<uint64_t>(batch + pushed, batch + n));
+                    if (count == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                    pushed += count;
+                }
+                next += n;
+            }
+        });
+
+    uint64_t expected = 1;
+    bool ordered = true;
+    uint64_t batch[32];
+    while (expected <= Count)
+    {
+        const size_t n = queue.PopBatch(batch);
+        if (n == 0)
+        {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            ordered = ordered && batch[i] == expected;
+            ++expected;
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(queue.TryPop(), rad::Error::OutOfRange);
+}
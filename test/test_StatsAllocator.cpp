@@ -0,0 +1,225 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "gtest/gtest.h"
+
+#include "radiant/Arena.h"
+#include "radiant/List.h"
+#include "radiant/StatsAllocator.h"
+#include "radiant/Vector.h"
+
+#include "test/TestAlloc.h"
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+using TestStatsAllocator = rad::StatsAllocator<radtest::Mallocator>;
+} // namespace
+
+RAD_S_ASSERT(!TestStatsAllocator::IsAlwaysEqual);
+RAD_S_ASSERT(TestStatsAllocator::PropagateOnCopy);
+RAD_S_ASSERT(TestStatsAllocator::PropagateOnMoveAssignment);
+RAD_S_ASSERT(TestStatsAllocator::PropagateOnSwap);
+RAD_S_ASSERT(!TestStatsAllocator::HasTryExpandBytes);
+RAD_S_ASSERT(sizeof(TestStatsAllocator) == 2 * sizeof(void*));
+
+TEST(StatsAllocatorTest, SizeClasses)
+{
+    EXPECT_EQ(rad::AllocStats::SizeClass(0), 0u);
+    EXPECT_EQ(rad::AllocStats::SizeClass(16), 0u);
+    EXPECT_EQ(rad::AllocStats::SizeClass(17), 1u);
+    EXPECT_EQ(rad::AllocStats::SizeClass(32), 1u);
+    EXPECT_EQ(rad::AllocStats::SizeClass(33), 2u);
+    EXPECT_EQ(rad::AllocStats::SizeClass(4096), 8u);
+    EXPECT_EQ(rad::AllocStats::SizeClass(size_t(16) << 14), 14u);
+    EXPECT_EQ(rad::AllocStats::SizeClass((size_t(16) << 14) + 1), 15u);
+    EXPECT_EQ(rad::AllocStats::SizeClass(~size_t(0)), 15u);
+}
+
+TEST(StatsAllocatorTest, CountsAndPeak)
+{
+    // without slack the high-water mark is exact
+    rad::AllocStats stats(0);
+    TestStatsAllocator alloc(stats);
+
+    void* small = alloc.AllocBytes(8);
+    void* large = alloc.AllocBytes(1000);
+    ASSERT_NE(small, nullptr);
+    ASSERT_NE(large, nullptr);
+    EXPECT_EQ(stats.Allocations(), 2u);
+    EXPECT_EQ(stats.Allocations(0), 1u);
+    EXPECT_EQ(stats.Allocations(rad::AllocStats::SizeClass(1000)), 1u);
+    EXPECT_EQ(stats.LiveBytes(), 1008u);
+    EXPECT_EQ(stats.PeakBytes(), 1008u);
+
+    alloc.FreeBytes(large, 1000);
+    EXPECT_EQ(stats.Frees(), 1u);
+    EXPECT_EQ(stats.LiveBytes(), 8u);
+    EXPECT_EQ(stats.PeakBytes(), 1008u);
+
+    stats.ResetPeak();
+    EXPECT_EQ(stats.PeakBytes(), 8u);
+
+    alloc.FreeBytes(small, 8);
+    alloc.FreeBytes(nullptr, 0);
+    EXPECT_EQ(stats.Frees(), 2u);
+    EXPECT_EQ(stats.LiveBytes(), 0u);
+    EXPECT_EQ(stats.PeakBytes(), 8u);
+    EXPECT_EQ(stats.Failures(), 0u);
+}
+
+TEST(StatsAllocatorTest, PeakSlack)
+{
+    constexpr size_t Slack = rad::AllocStats::DefaultPeakSlack;
+
+    rad::AllocStats stats;
+    TestStatsAllocator alloc(stats);
+
+    // a short-lived allocation within the slack stays in its shard
+    void* small = alloc.AllocBytes(1000);
+    ASSERT_NE(small, nullptr);
+    EXPECT_EQ(stats.PeakBytes(), 1000u);
+    alloc.FreeBytes(small, 1000);
+    EXPECT_EQ(stats.LiveBytes(), 0u);
+    EXPECT_LE(stats.PeakBytes(), 1000u);
+
+    void* large = alloc.AllocBytes(Slack + 1);
+    ASSERT_NE(large, nullptr);
+    alloc.FreeBytes(large, Slack + 1);
+    EXPECT_EQ(stats.LiveBytes(), 0u);
+    EXPECT_GE(stats.PeakBytes(), Slack + 1);
+    EXPECT_EQ(stats.Allocations(), 2u);
+    EXPECT_EQ(stats.Frees(), 2u);
+}
+
+TEST(StatsAllocatorTest, Tags)
+{
+    rad::AllocStats stats;
+    rad::Vector<int, TestStatsAllocator> vec(TestStatsAllocator(stats, 1));
+    rad::List<int, TestStatsAllocator> list(TestStatsAllocator(stats, 2));
+
+    ASSERT_TRUE(vec.Reserve(100).IsOk());
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_TRUE(list.PushBack(i).IsOk());
+    }
+
+    EXPECT_EQ(stats.TagAllocations(0), 0u);
+    EXPECT_EQ(stats.TagAllocations(1), 1u);
+    EXPECT_EQ(stats.TagLiveBytes(1), 100 * sizeof(int));
+    EXPECT_EQ(stats.TagAllocations(2), 10u);
+    EXPECT_EQ(stats.LiveBytes(),
+              stats.TagLiveBytes(1) + stats.TagLiveBytes(2));
+
+    list.Clear();
+    EXPECT_EQ(stats.TagLiveBytes(2), 0u);
+    EXPECT_EQ(stats.TagAllocations(2), 10u);
+    EXPECT_EQ(stats.LiveBytes(), 100 * sizeof(int));
+}
+
+TEST(StatsAllocatorTest, Equality)
+{
+    rad::AllocStats stats;
+    rad::AllocStats other;
+    TestStatsAllocator a(stats);
+    TestStatsAllocator b(radtest::Mallocator(), stats, 0);
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(a != TestStatsAllocator(stats, 3));
+    EXPECT_TRUE(a != TestStatsAllocator(other));
+    EXPECT_EQ(&a.GetStats(), &stats);
+    EXPECT_EQ(TestStatsAllocator(stats, 3).Tag(), 3u);
+}
+
+TEST(StatsAllocatorTest, Failure)
+{
+    rad::AllocStats stats;
+    rad::Vector<int, rad::StatsAllocator<radtest::FailingAllocator>> vec(
+        rad::StatsAllocator<radtest::FailingAllocator>(stats, 0));
+
+    EXPECT_EQ(vec.PushBack(1).Err(), rad::Error::NoMemory);
+    EXPECT_EQ(stats.Failures(), 1u);
+    EXPECT_EQ(stats.Allocations(), 0u);
+    EXPECT_EQ(stats.LiveBytes(), 0u);
+}
+
+TEST(StatsAllocatorTest, TryExpand)
+{
+    using ArenaType = rad::Arena<radtest::Mallocator>;
+    using InnerType = rad::ArenaAllocator<radtest::Mallocator>;
+    using AllocType = rad::StatsAllocator<InnerType>;
+    RAD_S_ASSERT(AllocType::HasTryExpandBytes);
+
+    ArenaType arena;
+    rad::AllocStats stats;
+    AllocType alloc(InnerType(arena), stats);
+
+    void* ptr = alloc.AllocBytes(16);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_TRUE(alloc.TryExpandBytes(ptr, 16, 64));
+    EXPECT_EQ(stats.LiveBytes(), 64u);
+    EXPECT_EQ(stats.PeakBytes(), 64u);
+    EXPECT_FALSE(alloc.TryExpandBytes(ptr, 64, ~size_t(0)));
+    EXPECT_EQ(stats.LiveBytes(), 64u);
+
+    alloc.FreeBytes(ptr, 64);
+    EXPECT_EQ(stats.LiveBytes(), 0u);
+    EXPECT_EQ(stats.Allocations(), 1u);
+}
+
+TEST(StatsAllocatorTest, Concurrent)
+{
+    constexpr int Threads = 4;
+    constexpr int Count = 2000;
+
+    rad::AllocStats stats(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; ++t)
+    {
+        threads.emplace_back(
+            [&stats, t]
+            {
+                TestStatsAllocator alloc(stats, static_cast<uint32_t>(t));
+                for (int i = 0; i < Count; ++i)
+                {
+                    const size_t size = static_cast<size_t>(i % 64 + 1);
+                    void* ptr = alloc.AllocBytes(size);
+                    EXPECT_NE(ptr, nullptr);
+                    if (i % 8 == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                    alloc.FreeBytes(ptr, size);
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(stats.Allocations(), uint64_t(Threads * Count));
+    EXPECT_EQ(stats.Frees(), uint64_t(Threads * Count));
+    EXPECT_EQ(stats.LiveBytes(), 0u);
+    EXPECT_GE(stats.PeakBytes(), 64u);
+    EXPECT_LE(stats.PeakBytes(), size_t(Threads * 64));
+    for (uint32_t t = 0; t < Threads; ++t)
+    {
+        EXPECT_EQ(stats.TagAllocations(t), uint64_t(Count));
+        EXPECT_EQ(stats.TagLiveBytes(t), 0u);
+    }
+}
@@ -0,0 +1,247 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/FlatHashMap.h"
+#include "radiant/String.h"
+
+#include "test/TestAlloc.h"
+
+#include <string.h>
+
+namespace
+{
+using String = rad::String<radtest::Mallocator>;
+using CountingString = rad::String<radtest::CountingAllocator>;
+
+rad::Span<const char> View(const char* str)
+{
+    return rad::Span<const char>(str,
+                                 static_cast<rad::SpanSizeType>(strlen(str)));
+}
+
+} // namespace
+
+TEST(TestString, Layout)
+{
+    const uint32_t inlineCapacity = String::InlineCapacity;
+    EXPECT_EQ(sizeof(String), 3 * sizeof(void*));
+    EXPECT_EQ(inlineCapacity, sizeof(String) - 1);
+    RAD_S_ASSERT(rad::IsTrivRelocatable<String>);
+}
+
+TEST(TestString, DefaultConstruct)
+{
+    String str;
+    EXPECT_TRUE(str.Empty());
+    EXPECT_EQ(str.Size(), 0u);
+    EXPECT_TRUE(str.IsInline());
+    EXPECT_EQ(str.Capacity(), sizeof(String) - 1);
+    EXPECT_STREQ(str.CStr(), "");
+    EXPECT_TRUE(str.ToSpan().Empty());
+}
+
+TEST(TestString, Inline)
+{
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+    {
+        CountingString str;
+        ASSERT_TRUE(str.Assign("hello").IsOk());
+        EXPECT_EQ(str.Size(), 5u);
+        EXPECT_STREQ(str.CStr(), "hello");
+        EXPECT_EQ(str, "hello");
+
+        // filling every inline character uses the size byte as terminator
+        const uint32_t inlineCapacity = CountingString::InlineCapacity;
+        char full[CountingString::InlineCapacity + 1];
+        memset(full, 'x', sizeof(full) - 1);
+        full[sizeof(full) - 1] = '\0';
+        ASSERT_TRUE(str.Assign(full).IsOk());
+        EXPECT_TRUE(str.IsInline());
+        EXPECT_EQ(str.Size(), inlineCapacity);
+        EXPECT_STREQ(str.CStr(), full);
+
+        str.PopBack();
+        EXPECT_EQ(str.Size(), inlineCapacity - 1);
+        ASSERT_TRUE(str.PushBack('y').IsOk());
+        EXPECT_EQ(str[inlineCapacity - 1], 'y');
+        EXPECT_TRUE(str.IsInline());
+    }
+
+    alloc.VerifyCounts(0, 0);
+}
+
+TEST(TestString, Allocated)
+{
+    radtest::CountingAllocator alloc;
+    alloc.ResetCounts();
+    {
+        CountingString str;
+        const char* text = "a string which is too long to be stored inline";
+        ASSERT_TRUE(str.Assign(text).IsOk());
+        EXPECT_FALSE(str.IsInline());
+        EXPECT_EQ(str.Size(), strlen(text));
+        EXPECT_GE(str.Capacity(), str.Size());
+        EXPECT_STREQ(str.CStr(), text);
+        alloc.VerifyCounts(1, 0);
+
+        // shrinking keeps the allocation
+        ASSERT_TRUE(str.Assign("short").IsOk());
+        EXPECT_FALSE(str.IsInline());
+        EXPECT_STREQ(str.CStr(), "short");
+        alloc.VerifyCounts(1, 0);
+
+        str.Clear();
+        EXPECT_TRUE(str.Empty());
+        EXPECT_STREQ(str.CStr(), "");
+    }
+
+    alloc.VerifyCounts(1, 1);
+}
+
+TEST(TestString, Append)
+{
+    String str;
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(str.PushBack(static_cast<char>('a' + i % 26)).IsOk());
+    }
+
+    EXPECT_EQ(str.Size(), 100u);
+    EXPECT_EQ(str[27], 'b');
+    EXPECT_EQ(str.CStr()[100], '\0');
+
+    String other;
+    ASSERT_TRUE(other.Append("abc").IsOk());
+    ASSERT_TRUE(other.Append(View("def")).IsOk());
+    ASSERT_TRUE(other.Append("").IsOk());
+    EXPECT_EQ(other, "abcdef");
+
+    // appending a string to itself, across a reallocation
+    for (int i = 0; i < 5; ++i)
+    {
+        ASSERT_TRUE(other.Append(other.ToSpan()).IsOk());
+    }
+
+    EXPECT_EQ(other.Size(), 6u * 32u);
+    for (uint32_t i = 0; i < other.Size(); ++i)
+    {
+        EXPECT_EQ(other[i], "abcdef"[i % 6]);
+    }
+}
+
+TEST(TestString, Resize)
+{
+    String str;
+    ASSERT_TRUE(str.Resize(3, 'z').IsOk());
+    EXPECT_EQ(str, "zzz");
+    ASSERT_TRUE(str.Resize(40, '-').IsOk());
+    EXPECT_EQ(str.Size(), 40u);
+    EXPECT_EQ(str[39], '-');
+    ASSERT_TRUE(str.Resize(2).IsOk());
+    EXPECT_EQ(str, "zz");
+
+    ASSERT_TRUE(str.Reserve(200).IsOk());
+    EXPECT_GE(str.Capacity(), 200u);
+    EXPECT_EQ(str, "zz");
+}
+
+TEST(TestString, EmbeddedNull)
+{
+    String str;
+    const char bytes[] = { 'a', '\0', 'b' };
+    ASSERT_TRUE(str.Assign(rad::Span<const char>(bytes, 3)).IsOk());
+    EXPECT_EQ(str.Size(), 3u);
+    EXPECT_EQ(str[2], 'b');
+    EXPECT_NE(str, "a");
+}
+
+TEST(TestString, Compare)
+{
+    String a;
+    String b;
+    ASSERT_TRUE(a.Assign("apple").IsOk());
+    ASSERT_TRUE(b.Assign("apples").IsOk());
+    EXPECT_LT(a.Compare(b.ToSpan()), 0);
+    EXPECT_GT(b.Compare(a.ToSpan()), 0);
+    EXPECT_EQ(a.Compare(View("apple")), 0);
+    EXPECT_TRUE(a < b);
+    EXPECT_TRUE(a != b);
+    EXPECT_TRUE(View("apple") == a);
+    EXPECT_TRUE(a == View("apple"));
+
+    String c;
+    ASSERT_TRUE(c.Assign("banana").IsOk());
+    EXPECT_TRUE(b < c);
+    EXPECT_FALSE(c < b);
+}
+
+TEST(TestString, MoveCloneSwap)
+{
+    String small;
+    String large;
+    ASSERT_TRUE(small.Assign("tiny").IsOk());
+    ASSERT_TRUE(
+        large.Assign("this one needs to live on the heap somewhere").IsOk());
+
+    String moved(rad::Move(large));
+    EXPECT_TRUE(large.Empty());
+    EXPECT_EQ(moved, "this one needs to live on the heap somewhere");
+
+    moved.Swap(small);
+    EXPECT_EQ(moved, "tiny");
+    EXPECT_EQ(small, "this one needs to live on the heap somewhere");
+
+    auto clone = small.Clone();
+    ASSERT_TRUE(clone.IsOk());
+    EXPECT_EQ(clone.Ok(), small);
+    EXPECT_NE(clone.Ok().CStr(), small.CStr());
+
+    large = rad::Move(small);
+    EXPECT_TRUE(small.Empty());
+    EXPECT_FALSE(large.IsInline());
+}
+
+TEST(TestString, NoMemory)
+{
+    rad::String<radtest::FailingAllocator> str;
+    ASSERT_TRUE(str.Assign("fits").IsOk());
+    EXPECT_EQ(str.Assign("does not fit in the inline characters").Err(),
+              rad::Error::NoMemory);
+    EXPECT_STREQ(str.CStr(), "fits");
+    EXPECT_EQ(str.Resize(100).Err(), rad::Error::NoMemory);
+    EXPECT_EQ(str.Size(), 4u);
+}
+
+TEST(TestString, HashMapKey)
+{
+    rad::FlatHashMap<String, int, radtest::Mallocator> map;
+    String key;
+    ASSERT_TRUE(key.Assign("session").IsOk());
+    ASSERT_TRUE(map.Insert(rad::Move(key), 7).IsOk());
+
+    EXPECT_EQ(rad::Hash<String>()(View("session")),
+              rad::HashBytes(View("session").AsBytes()));
+
+    rad::FlatHashMap<String, int, radtest::Mallocator, rad::Hash<String>,
+                     rad::EqualTo<>>
+        lookup;
+    ASSERT_TRUE(key.Assign("session").IsOk());
+    ASSERT_TRUE(lookup.Insert(rad::Move(key), 7).IsOk());
+    ASSERT_NE(lookup.Find(View("session")), nullptr);
+    EXPECT_EQ(*lookup.Find(View("session")), 7);
+    EXPECT_EQ(lookup.Find(View("other")), nullptr);
+}
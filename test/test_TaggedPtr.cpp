@@ -0,0 +1,162 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/TaggedPtr.h"
+
+#include <stdint.h>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct alignas(8) Node
+{
+    int value = 0;
+    // a tagged pointer to an incomplete type
+    rad::TaggedPtr<Node, 3> next;
+};
+
+using NodePtr = rad::TaggedPtr<Node, 3>;
+using AtomicNodePtr = rad::AtomicTaggedPtr<Node, 3>;
+} // namespace
+
+RAD_S_ASSERT(sizeof(NodePtr) == sizeof(void*));
+RAD_S_ASSERT(sizeof(AtomicNodePtr) == sizeof(void*));
+RAD_S_ASSERT(NodePtr::TagMask == 7);
+RAD_S_ASSERT(rad::IsTrivCopyCtor<NodePtr>);
+RAD_S_ASSERT((!rad::IsConv<Node*, NodePtr>));
+
+TEST(TaggedPtrTest, PackAndUnpack)
+{
+    NodePtr empty;
+    EXPECT_FALSE(empty);
+    EXPECT_EQ(empty.Ptr(), nullptr);
+    EXPECT_EQ(empty.Tag(), 0u);
+    EXPECT_EQ(empty.Bits(), 0u);
+
+    Node a;
+    Node b;
+    a.value = 1;
+    NodePtr ptr(&a, 5);
+    EXPECT_TRUE(ptr);
+    EXPECT_EQ(ptr.Ptr(), &a);
+    EXPECT_EQ(ptr.Tag(), 5u);
+    EXPECT_EQ(ptr->value, 1);
+    EXPECT_EQ((*ptr).value, 1);
+
+    ptr.SetTag(7);
+    EXPECT_EQ(ptr.Ptr(), &a);
+    EXPECT_EQ(ptr.Tag(), 7u);
+
+    ptr.SetPtr(&b);
+    EXPECT_EQ(ptr.Ptr(), &b);
+    EXPECT_EQ(ptr.Tag(), 7u);
+
+    // a null pointer may still carry a tag
+    NodePtr marked(nullptr, 1);
+    EXPECT_FALSE(marked);
+    EXPECT_NE(marked, empty);
+    EXPECT_EQ(marked.WithTag(0), empty);
+
+    EXPECT_EQ(ptr.WithPtr(&a), NodePtr(&a, 7));
+    EXPECT_EQ(ptr.WithTag(2), NodePtr(&b, 2));
+    EXPECT_EQ(NodePtr::FromBits(ptr.Bits()), ptr);
+
+    a.next = NodePtr(&b, 1);
+    EXPECT_EQ(a.next.Ptr(), &b);
+}
+
+TEST(TaggedPtrTest, AtomicOperations)
+{
+    Node a;
+    Node b;
+    AtomicNodePtr ptr(NodePtr(&a, 1));
+    EXPECT_EQ(ptr.Load(rad::MemOrderRelaxed), NodePtr(&a, 1));
+
+    ptr.Store(NodePtr(&b, 2), rad::MemOrderRelease);
+    EXPECT_EQ(ptr.Exchange(NodePtr(&a, 3), rad::MemOrderAcqRel),
+              NodePtr(&b, 2));
+
+    // the tag takes part in the comparison
+    NodePtr expected(&a, 0);
+    EXPECT_FALSE(ptr.CompareExchangeStrong(expected,
+                                           NodePtr(&b, 0),
+                                           rad::MemOrderSeqCst));
+    EXPECT_EQ(expected, NodePtr(&a, 3));
+    EXPECT_TRUE(ptr.CompareExchangeStrong(expected,
+                                          NodePtr(&b, 4),
+                                          rad::MemOrderAcqRel,
+                                          rad::MemOrderAcquire));
+    EXPECT_EQ(ptr.Load(rad::MemOrderRelaxed), NodePtr(&b, 4));
+
+    expected = NodePtr(&b, 4);
+    while (!ptr.CompareExchangeWeak(expected,
+                                    expected.WithTag(5),
+                                    rad::MemOrderSeqCst))
+    {
+    }
+
+    EXPECT_EQ(ptr.FetchAddTag(2, rad::MemOrderRelaxed), NodePtr(&b, 5));
+    EXPECT_EQ(ptr.FetchSubTag(1, rad::MemOrderRelaxed), NodePtr(&b, 7));
+    EXPECT_EQ(ptr.FetchAndTag(2, rad::MemOrderRelaxed), NodePtr(&b, 6));
+    EXPECT_EQ(ptr.FetchOrTag(1, rad::MemOrderRelaxed), NodePtr(&b, 2));
+    EXPECT_EQ(ptr.Load(rad::MemOrderRelaxed), NodePtr(&b, 3));
+}
+
+TEST(TaggedPtrTest, VersionedStack)
+{
+    // a tag used as a version counter on a shared head
+    constexpr int Count = 1000;
+    std::vector<Node> nodes(2 * Count);
+    AtomicNodePtr head;
+
+    auto push = [&head, &nodes](int first)
+    {
+        for (int i = first; i < first + Count; ++i)
+        {
+            Node* node = &nodes[static_cast<size_t>(i)];
+            node->value = i;
+            NodePtr old = head.Load(rad::MemOrderRelaxed);
+            do
+            {
+                node->next = old;
+            } while (!head.CompareExchangeWeak(
+                old,
+                NodePtr(node, (old.Tag() + 1) & NodePtr::TagMask),
+                rad::MemOrderRelease,
+                rad::MemOrderRelaxed));
+        }
+    };
+
+    std::thread t1(push, 0);
+    std::thread t2(push, Count);
+    t1.join();
+    t2.join();
+
+    std::vector<bool> seen(nodes.size());
+    int count = 0;
+    for (NodePtr p = head.Load(rad::MemOrderAcquire); p; p = p->next)
+    {
+        EXPECT_FALSE(seen[static_cast<size_t>(p->value)]);
+        seen[static_cast<size_t>(p->value)] = true;
+        ++count;
+    }
+
+    EXPECT_EQ(count, 2 * Count);
+    EXPECT_EQ(head.Load(rad::MemOrderAcquire).Tag(),
+              static_cast<uintptr_t>(2 * Count) & 7);
+}
@@ -0,0 +1,255 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/ThreadPool.h"
+
+#include "test/TestAlloc.h"
+
+#include <thread>
+
+namespace
+{
+using Pool = rad::ThreadPool<radtest::Mallocator>;
+
+// submits a binary tree of tasks from within tasks
+void Fan(Pool& pool, rad::Atomic<int>& count, int depth)
+{
+    count.FetchAdd(1, rad::MemOrderRelaxed);
+    if (depth == 0)
+    {
+        return;
+    }
+
+    for (int i = 0; i < 2; ++i)
+    {
+        EXPECT_TRUE(pool.Submit([&pool, &count, depth]
+                                { Fan(pool, count, depth - 1); })
+                        .IsOk());
+    }
+}
+
+// fails every allocation once its budget is spent
+class BudgetAllocator
+{
+public:
+
+    static constexpr bool IsAlwaysEqual = true;
+
+    void FreeBytes(void* ptr, size_t byte_count) noexcept
+    {
+        RAD_UNUSED(byte_count);
+
+        --s_live;
+        free(ptr);
+    }
+
+    void* AllocBytes(size_t byte_count) noexcept
+    {
+        if (s_budget == 0)
+        {
+            return nullptr;
+        }
+
+        --s_budget;
+        ++s_live;
+        return malloc(byte_count);
+    }
+
+    static void HandleSizeOverflow()
+    {
+    }
+
+    static int s_budget;
+    static int s_live;
+};
+
+int BudgetAllocator::s_budget = 0;
+int BudgetAllocator::s_live = 0;
+} // namespace
+
+TEST(TestThreadPool, NotStarted)
+{
+    Pool pool;
+    EXPECT_EQ(pool.ThreadCount(), 0u);
+    EXPECT_FALSE(pool.RunOne());
+
+    // without queues the submitting thread runs the task
+    int ran = 0;
+    EXPECT_TRUE(pool.Submit([&ran] { ++ran; }).IsOk());
+    EXPECT_EQ(ran, 1);
+    pool.WaitIdle();
+}
+
+TEST(TestThreadPool, Start)
+{
+    Pool pool;
+    EXPECT_TRUE(pool.Start(2, 16).IsOk());
+    EXPECT_EQ(pool.ThreadCount(), 2u);
+    EXPECT_EQ(pool.Start(2, 16), rad::Error::Unsuccessful);
+
+    rad::ThreadPool<radtest::FailingAllocator> failing;
+    EXPECT_EQ(failing.Start(2, 16), rad::Error::NoMemory);
+    EXPECT_EQ(failing.ThreadCount(), 0u);
+}
+
+TEST(TestThreadPool, NoWorkers)
+{
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        rad::ThreadPool<radtest::CountingAllocator> pool;
+        EXPECT_EQ(pool.Start(0, 4), rad::Error::OutOfRange);
+        EXPECT_EQ(pool.ThreadCount(), 0u);
+        counter.VerifyCounts(0, 0);
+
+        // the pool is still not started, so tasks run right away
+        int ran = 0;
+        EXPECT_TRUE(pool.Submit([&ran] { ++ran; }).IsOk());
+        EXPECT_EQ(ran, 1);
+
+        EXPECT_TRUE(pool.Start(1, 4).IsOk());
+        EXPECT_EQ(pool.ThreadCount(), 1u);
+    }
+    counter.VerifyCounts();
+}
+
+TEST(TestThreadPool, FailedStart)
+{
+    rad::ThreadPool<radtest::FailingAllocator> failing;
+    EXPECT_EQ(failing.Start(2, 16), rad::Error::NoMemory);
+    EXPECT_EQ(failing.Submit([] {}), rad::Error::NoMemory);
+    failing.WaitIdle();
+
+    // fail each allocation Start() makes in turn
+    for (int budget = 0; budget < 4; ++budget)
+    {
+        BudgetAllocator::s_budget = budget;
+        {
+            rad::ThreadPool<BudgetAllocator> pool;
+            EXPECT_EQ(pool.Start(2, 16), rad::Error::NoMemory);
+            EXPECT_EQ(pool.ThreadCount(), 0u);
+
+            // nothing would run a queued task, so it runs right away
+            BudgetAllocator::s_budget = 1;
+            int ran = 0;
+            EXPECT_TRUE(pool.Submit([&ran] { ++ran; }).IsOk());
+            EXPECT_EQ(ran, 1);
+            pool.WaitIdle();
+
+            BudgetAllocator::s_budget = 100;
+            ASSERT_TRUE(pool.Start(2, 16).IsOk());
+            EXPECT_TRUE(pool.Submit([&ran] { ++ran; }).IsOk());
+            pool.WaitIdle();
+            EXPECT_EQ(ran, 2);
+        }
+        EXPECT_EQ(BudgetAllocator::s_live, 0);
+    }
+}
+
+TEST(TestThreadPool, ManyTasks)
+{
+    static constexpr int TaskCount = 20000;
+
+    Pool pool;
+    ASSERT_TRUE(pool.Start(4, 64).IsOk());
+
+    rad::Atomic<int> count{ 0 };
+    for (int i = 0; i < TaskCount; ++i)
+    {
+        EXPECT_TRUE(
+            pool.Submit([&count] { count.FetchAdd(1, rad::MemOrderRelaxed); })
+                .IsOk());
+    }
+
+    pool.WaitIdle();
+    EXPECT_EQ(count.Load(rad::MemOrderRelaxed), TaskCount);
+}
+
+TEST(TestThreadPool, NestedSubmit)
+{
+    Pool pool;
+    ASSERT_TRUE(pool.Start(4, 32).IsOk());
+
+    // deques smaller than the fan out make workers run overflow inline
+    rad::Atomic<int> count{ 0 };
+    EXPECT_TRUE(pool.Submit([&pool, &count] { Fan(pool, count, 12); }).IsOk());
+    pool.WaitIdle();
+    EXPECT_EQ(count.Load(rad::MemOrderRelaxed), (1 << 13) - 1);
+
+    // and again once the workers have parked
+    count.Store(0, rad::MemOrderRelaxed);
+    EXPECT_TRUE(pool.Submit([&pool, &count] { Fan(pool, count, 8); }).IsOk());
+    pool.WaitIdle();
+    EXPECT_EQ(count.Load(rad::MemOrderRelaxed), (1 << 9) - 1);
+}
+
+TEST(TestThreadPool, CallerRunsWhenFull)
+{
+    Pool pool;
+    ASSERT_TRUE(pool.Start(1, 2).IsOk());
+
+    rad::Atomic<uint32_t> started{ 0 };
+    rad::Atomic<uint32_t> release{ 0 };
+    EXPECT_TRUE(pool.Submit(
+                        [&]
+                        {
+                            started.Store(1, rad::MemOrderRelease);
+                            while (release.Load(rad::MemOrderAcquire) == 0)
+                            {
+                                std::this_thread::yield();
+                            }
+                        })
+                    .IsOk());
+    while (started.Load(rad::MemOrderAcquire) == 0)
+    {
+        std::this_thread::yield();
+    }
+
+    // the only worker is busy, so the third task does not fit in the queue
+    const std::thread::id caller = std::this_thread::get_id();
+    std::thread::id ranOn[3];
+    for (auto& id : ranOn)
+    {
+        EXPECT_TRUE(
+            pool.Submit([&id] { id = std::this_thread::get_id(); }).IsOk());
+    }
+    EXPECT_EQ(ranOn[2], caller);
+
+    release.Store(1, rad::MemOrderRelease);
+    pool.WaitIdle();
+    EXPECT_NE(ranOn[0], std::thread::id());
+    EXPECT_NE(ranOn[1], std::thread::id());
+}
+
+TEST(TestThreadPool, DestroyWhileBusy)
+{
+    rad::Atomic<int> count{ 0 };
+    {
+        Pool pool;
+        ASSERT_TRUE(pool.Start(3, 16).IsOk());
+        for (int i = 0; i < 100; ++i)
+        {
+            EXPECT_TRUE(pool.Submit(
+                                [&count]
+                                {
+                                    std::this_thread::yield();
+                                    count.FetchAdd(1, rad::MemOrderRelaxed);
+                                })
+                            .IsOk());
+        }
+    }
+    EXPECT_EQ(count.Load(rad::MemOrderRelaxed), 100);
+}
@@ -0,0 +1,273 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/TimingWheel.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+struct Timer
+{
+    Timer(int i = 0) noexcept
+        : id(i)
+    {
+    }
+
+    int id;
+    double padding = 0;
+    rad::TimingWheelHook hook;
+    // tick at which the timer is expected to fire, or 0
+    uint64_t expected = 0;
+    uint64_t firedAt = 0;
+    int fireCount = 0;
+};
+
+using Wheel = rad::TimingWheel<Timer, &Timer::hook>;
+// two levels make the overflow list easy to reach
+using SmallWheel = rad::TimingWheel<Timer, &Timer::hook, 2>;
+} // namespace
+
+RAD_S_ASSERT(Wheel::SlotCount == 64);
+RAD_S_ASSERT(Wheel::Span == (uint64_t{ 1 } << 24));
+RAD_S_ASSERT(SmallWheel::Span == 4096);
+
+TEST(TimingWheelTest, Empty)
+{
+    Wheel wheel(100);
+    EXPECT_EQ(wheel.Now(), 100u);
+
+    int calls = 0;
+    auto fn = [&calls](Timer&) noexcept { ++calls; };
+    EXPECT_EQ(wheel.Advance(1000000, fn), 0u);
+    EXPECT_EQ(wheel.Now(), 1000000u);
+
+    // going back is ignored
+    EXPECT_EQ(wheel.Advance(5, fn), 0u);
+    EXPECT_EQ(wheel.Now(), 1000000u);
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(TimingWheelTest, FiresOnDeadline)
+{
+    SmallWheel wheel;
+    const uint64_t deadlines[] = { 1,    2,    63,   64,    65,    127,
+                                   128,  4095, 4096, 4097,  5000,  8191,
+                                   8192, 9999, 50000, 50001, 123456 };
+    std::vector<std::unique_ptr<Timer>> timers;
+    for (uint64_t deadline : deadlines)
+    {
+        timers.emplace_back(new Timer());
+        wheel.Schedule(*timers.back(), deadline);
+        EXPECT_TRUE(timers.back()->hook.IsScheduled());
+        EXPECT_EQ(timers.back()->hook.Deadline(), deadline);
+    }
+
+    auto fn = [&wheel](Timer& t) noexcept
+    {
+        EXPECT_FALSE(t.hook.IsScheduled());
+        t.firedAt = wheel.Now();
+        ++t.fireCount;
+    };
+
+    // one tick at a time, then in uneven steps
+    size_t fired = 0;
+    for (uint64_t now = 1; now <= 5000; ++now)
+    {
+        fired += wheel.Advance(now, fn);
+    }
+
+    for (uint64_t now = 5000; now <= 200000; now += 777)
+    {
+        fired += wheel.Advance(now, fn);
+    }
+
+    EXPECT_EQ(fired, timers.size());
+    for (size_t i = 0; i < timers.size(); ++i)
+    {
+        EXPECT_EQ(timers[i]->fireCount, 1);
+        EXPECT_EQ(timers[i]->firedAt, deadlines[i]);
+    }
+}
+
+TEST(TimingWheelTest, PastDeadline)
+{
+    Wheel wheel(1000);
+    Timer a;
+    Timer b;
+    wheel.Schedule(a, 10);
+    wheel.ScheduleAfter(b, 0);
+    EXPECT_EQ(a.hook.Deadline(), 10u);
+
+    auto fn = [&wheel](Timer& t) noexcept { t.firedAt = wheel.Now(); };
+    EXPECT_EQ(wheel.Advance(1005, fn), 2u);
+    EXPECT_EQ(a.firedAt, 1001u);
+    EXPECT_EQ(b.firedAt, 1001u);
+
+    // and across a turn of level 0
+    Wheel other(63);
+    other.Schedule(a, 1);
+    EXPECT_EQ(other.Advance(64, fn), 1u);
+}
+
+TEST(TimingWheelTest, CancelAndReschedule)
+{
+    Wheel wheel;
+    Timer a(1);
+    Timer b(2);
+    Timer c(3);
+    wheel.Schedule(a, 100);
+    wheel.Schedule(b, 100);
+    wheel.Schedule(c, 5000);
+
+    // rescheduling moves a timer, cancelling removes it
+    wheel.Schedule(a, 200);
+    Wheel::Cancel(b);
+    EXPECT_FALSE(b.hook.IsScheduled());
+    Wheel::Cancel(b);
+    c.hook.Cancel();
+
+    std::vector<int> order;
+    auto fn = [&order](Timer& t) noexcept { order.push_back(t.id); };
+    EXPECT_EQ(wheel.Advance(150, fn), 0u);
+    wheel.Schedule(c, 160);
+    {
+        Timer d(4);
+        wheel.Schedule(d, 155);
+    }
+
+    EXPECT_EQ(wheel.Advance(10000, fn), 2u);
+    ASSERT_EQ(order.size(), 2u);
+    EXPECT_EQ(order[0], 3);
+    EXPECT_EQ(order[1], 1);
+}
+
+TEST(TimingWheelTest, CallbackReschedules)
+{
+    Wheel wheel;
+    Timer periodic(1);
+    Timer other(2);
+    Timer doomed(3);
+    wheel.Schedule(periodic, 10);
+    wheel.Schedule(other, 1000);
+    wheel.Schedule(doomed, 30);
+
+    int periodicFires = 0;
+    auto fn = [&](Timer& t) noexcept
+    {
+        if (&t == &periodic)
+        {
+            ++periodicFires;
+            wheel.ScheduleAfter(t, 10);
+            doomed.hook.Cancel();
+        }
+        else
+        {
+            ++t.fireCount;
+        }
+    };
+
+    EXPECT_EQ(wheel.Advance(995, fn), 99u);
+    EXPECT_EQ(periodicFires, 99);
+    EXPECT_EQ(doomed.fireCount, 0);
+    EXPECT_EQ(other.fireCount, 0);
+    EXPECT_EQ(wheel.Advance(1000, fn), 2u);
+    EXPECT_EQ(other.fireCount, 1);
+}
+
+TEST(TimingWheelTest, Random)
+{
+    constexpr int Count = 2000;
+    SmallWheel wheel;
+    std::vector<std::unique_ptr<Timer>> timers;
+    for (int i = 0; i < Count; ++i)
+    {
+        timers.emplace_back(new Timer(i));
+    }
+
+    int fired = 0;
+    auto fn = [&](Timer& t) noexcept
+    {
+        EXPECT_EQ(t.expected, wheel.Now());
+        t.expected = 0;
+        ++fired;
+    };
+
+    int expectedFires = 0;
+    uint32_t state = 7;
+    for (int round = 0; round < 4000; ++round)
+    {
+        state = state * 1103515245u + 12345u;
+        Timer& t = *timers[(state >> 8) % Count];
+        if ((state >> 4) % 8 == 0)
+        {
+            if (t.expected != 0)
+            {
+                t.hook.Cancel();
+                t.expected = 0;
+                --expectedFires;
+            }
+        }
+        else
+        {
+            // deadlines up to three times the span of the wheel
+            const uint64_t delay = (state >> 12) % (3 * SmallWheel::Span);
+            if (t.expected == 0)
+            {
+                ++expectedFires;
+            }
+
+            wheel.ScheduleAfter(t, delay);
+            t.expected = delay == 0 ? wheel.Now() + 1 : wheel.Now() + delay;
+        }
+
+        state = state * 1103515245u + 12345u;
+        wheel.Advance(wheel.Now() + (state >> 16) % 64, fn);
+    }
+
+    wheel.Advance(wheel.Now() + 4 * SmallWheel::Span, fn);
+    EXPECT_EQ(fired, expectedFires);
+    for (const auto& t : timers)
+    {
+        EXPECT_FALSE(t->hook.IsScheduled());
+        EXPECT_EQ(t->expected, 0u);
+    }
+}
+
+TEST(TimingWheelTest, Clear)
+{
+    Timer a;
+    Timer b;
+    {
+        SmallWheel wheel;
+        wheel.Schedule(a, 5);
+        wheel.Schedule(b, 1000000);
+        wheel.Clear();
+        EXPECT_FALSE(a.hook.IsScheduled());
+        EXPECT_FALSE(b.hook.IsScheduled());
+
+        auto fn = [](Timer& t) noexcept { ++t.fireCount; };
+        EXPECT_EQ(wheel.Advance(2000000, fn), 0u);
+
+        wheel.Schedule(a, 2000005);
+    }
+
+    // destroying the wheel unlinks its timers
+    EXPECT_FALSE(a.hook.IsScheduled());
+}
@@ -0,0 +1,207 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/Trace.h"
+
+#include <string.h>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+using rad::TraceEvent;
+
+// drops events left over from earlier tests
+void DrainAll()
+{
+    TraceEvent events[64];
+    while (rad::TraceDrain(events) != 0)
+    {
+    }
+}
+
+} // namespace
+
+TEST(TestTrace, Timestamp)
+{
+    const uint64_t first = rad::TraceTimestamp();
+    const uint64_t second = rad::TraceTimestamp();
+    EXPECT_GE(second, first);
+}
+
+TEST(TestTrace, RecordAndDrain)
+{
+    DrainAll();
+    rad::TraceRecord("first", 10, 20);
+    {
+        rad::TraceScope scope("scope");
+    }
+    rad::TraceRecord("last", 30, 31);
+
+    TraceEvent events[8];
+    ASSERT_EQ(rad::TraceDrain(events), 3u);
+    EXPECT_STREQ(events[0].name, "first");
+    EXPECT_EQ(events[0].begin, 10u);
+    EXPECT_EQ(events[0].end, 20u);
+    EXPECT_STREQ(events[1].name, "scope");
+    EXPECT_LE(events[1].begin, events[1].end);
+    EXPECT_STREQ(events[2].name, "last");
+    EXPECT_NE(events[0].thread, 0u);
+    EXPECT_EQ(events[1].thread, events[0].thread);
+    EXPECT_EQ(events[2].thread, events[0].thread);
+
+    EXPECT_EQ(rad::TraceDrain(events), 0u);
+}
+
+TEST(TestTrace, PartialDrain)
+{
+    DrainAll();
+    for (uint64_t i = 0; i < 5; ++i)
+    {
+        rad::TraceRecord("event", i, i + 1);
+    }
+
+    TraceEvent events[3];
+    ASSERT_EQ(rad::TraceDrain(events), 3u);
+    EXPECT_EQ(events[2].begin, 2u);
+    ASSERT_EQ(rad::TraceDrain(events), 2u);
+    EXPECT_EQ(events[0].begin, 3u);
+    EXPECT_EQ(events[1].begin, 4u);
+}
+
+TEST(TestTrace, FullBufferDrops)
+{
+    DrainAll();
+    const uint64_t dropped = rad::TraceDroppedCount();
+    const uint32_t capacity = rad::detail::TraceBuffer::Capacity;
+    for (uint32_t i = 0; i < capacity + 5; ++i)
+    {
+        rad::TraceRecord("event", i, i);
+    }
+
+    EXPECT_EQ(rad::TraceDroppedCount(), dropped + 5);
+
+    std::vector<TraceEvent> events(capacity + 5);
+    rad::Span<TraceEvent> span(events.data(),
+                               static_cast<rad::SpanSizeType>(events.size()));
+    ASSERT_EQ(rad::TraceDrain(span), capacity);
+    EXPECT_EQ(events[capacity - 1].begin, capacity - 1);
+
+    // the drained space is reused
+    rad::TraceRecord("again", 1, 2);
+    ASSERT_EQ(rad::TraceDrain(span), 1u);
+    EXPECT_STREQ(events[0].name, "again");
+}
+
+TEST(TestTrace, Threads)
+{
+    DrainAll();
+    constexpr int ThreadCount = 4;
+    constexpr uint64_t EventCount = 100;
+    rad::Atomic<bool> done{ false };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back(
+            [&done]()
+            {
+                for (uint64_t i = 0; i < EventCount; ++i)
+                {
+                    rad::TraceRecord("worker", i, i);
+                }
+
+                // buffered events are lost when the thread exits
+                while (!done.Load(rad::MemOrderAcquire))
+                {
+                    std::this_thread::yield();
+                }
+            });
+    }
+
+    std::vector<TraceEvent> events;
+    TraceEvent batch[32];
+    while (events.size() < ThreadCount * EventCount)
+    {
+        const size_t count = rad::TraceDrain(batch);
+        events.insert(events.end(), batch, batch + count);
+        if (count == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    done.Store(true, rad::MemOrderRelease);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // each thread's events arrive in order under their own thread number
+    std::vector<uint32_t> ids;
+    std::vector<uint64_t> next;
+    for (const TraceEvent& event : events)
+    {
+        EXPECT_STREQ(event.name, "worker");
+        size_t index = 0;
+        while (index < ids.size() && ids[index] != event.thread)
+        {
+            ++index;
+        }
+
+        if (index == ids.size())
+        {
+            ids.push_back(event.thread);
+            next.push_back(0);
+        }
+
+        EXPECT_EQ(event.begin, next[index]++);
+    }
+
+    EXPECT_EQ(ids.size(), static_cast<size_t>(ThreadCount));
+    EXPECT_EQ(rad::TraceDrain(batch), 0u);
+}
+
+TEST(TestTrace, ThreadExitDrops)
+{
+    DrainAll();
+    const uint64_t dropped = rad::TraceDroppedCount();
+    std::thread thread(
+        []()
+        {
+            rad::TraceRecord("lost", 1, 2);
+            rad::TraceRecord("lost", 3, 4);
+        });
+    thread.join();
+
+    EXPECT_EQ(rad::TraceDroppedCount(), dropped + 2);
+    TraceEvent events[4];
+    EXPECT_EQ(rad::TraceDrain(events), 0u);
+}
+
+#if !RAD_ENABLE_TRACING
+TEST(TestTrace, DisabledScope)
+{
+    DrainAll();
+    {
+        RAD_TRACE_SCOPE("compiled out");
+    }
+
+    TraceEvent events[4];
+    EXPECT_EQ(rad::TraceDrain(events), 0u);
+}
+#endif
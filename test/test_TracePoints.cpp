@@ -0,0 +1,85 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tracing changes the inline functions holding trace points, so this test is
+// built into a binary of its own rather than with the other tests. The locked
+// AtomicSharedPtr is forced as it holds the trace points.
+#define RAD_ENABLE_TRACING 1
+#define RAD_LOCK_FREE_ATOMIC_SHARED_PTR 0
+
+#include "gtest/gtest.h"
+
+#include "radiant/SharedPtr.h"
+#include "radiant/Trace.h"
+#include "radiant/Vector.h"
+
+#include "test/TestAlloc.h"
+
+#include <string.h>
+
+namespace
+{
+using rad::TraceEvent;
+
+// drains every buffered event, counting the ones named name
+size_t CountEvents(const char* name)
+{
+    TraceEvent events[64];
+    size_t count = 0;
+    for (size_t drained = rad::TraceDrain(events); drained != 0;
+         drained = rad::TraceDrain(events))
+    {
+        for (size_t i = 0; i < drained; ++i)
+        {
+            if (strcmp(events[i].name, name) == 0)
+            {
+                ++count;
+            }
+        }
+    }
+
+    return count;
+}
+
+} // namespace
+
+TEST(TestTracePoints, VectorReserve)
+{
+    CountEvents("");
+    rad::Vector<int, radtest::Mallocator> vec;
+    ASSERT_TRUE(vec.Reserve(100).IsOk());
+
+    // already large enough, so nothing is traced
+    ASSERT_TRUE(vec.Reserve(10).IsOk());
+    EXPECT_EQ(CountEvents("rad::Vector::Reserve"), 1u);
+}
+
+TEST(TestTracePoints, AtomicSharedPtrLocks)
+{
+    radtest::Mallocator alloc;
+    auto ptr = rad::AllocateShared<int>(alloc, 3);
+    ASSERT_TRUE(ptr);
+
+    rad::AtomicSharedPtr<int> atomic(ptr);
+    CountEvents("");
+    EXPECT_EQ(*atomic.Load(), 3);
+    EXPECT_EQ(*atomic.Load(), 3);
+    atomic.Store(rad::SharedPtr<int>());
+    EXPECT_EQ(CountEvents("rad::AtomicSharedPtr::LockShared"), 2u);
+
+    atomic.Store(ptr);
+    auto prev = atomic.Exchange(rad::SharedPtr<int>());
+    EXPECT_EQ(prev, ptr);
+    EXPECT_EQ(CountEvents("rad::AtomicSharedPtr::LockExclusive"), 2u);
+}
@@ -33,3 +33,35 @@ RAD_S_ASSERT(!(rad::IsLRefBindable<int&, const int&>));
 RAD_S_ASSERT((rad::IsLRefBindable<const int&, const int&>));
 RAD_S_ASSERT((!rad::IsLRefBindable<int&, int&&>));
 RAD_S_ASSERT((rad::IsLRefBindable<A&, B>));
+
+struct NonTrivialDtor
+{
+    ~NonTrivialDtor()
+    {
+    }
+};
+
+struct NonTrivialMove
+{
+    NonTrivialMove(NonTrivialMove&&)
+    {
+    }
+};
+
+struct OptInRelocatable : NonTrivialDtor
+{
+    static constexpr bool IsTriviallyRelocatable = true;
+};
+
+struct OptOutRelocatable : NonTrivialMove
+{
+    static constexpr bool IsTriviallyRelocatable = false;
+};
+
+RAD_S_ASSERT(rad::IsTrivRelocatable<int>);
+RAD_S_ASSERT(rad::IsTrivRelocatable<int*>);
+RAD_S_ASSERT(rad::IsTrivRelocatable<A>);
+RAD_S_ASSERT(!rad::IsTrivRelocatable<NonTrivialDtor>);
+RAD_S_ASSERT(!rad::IsTrivRelocatable<NonTrivialMove>);
+RAD_S_ASSERT(rad::IsTrivRelocatable<OptInRelocatable>);
+RAD_S_ASSERT(!rad::IsTrivRelocatable<OptOutRelocatable>);
@@ -53,6 +53,8 @@ constexpr int MockResourcePolicy::InvalidValue;
 
 using MockResource = rad::UniqueResource<MockResourcePolicy>;
 
+RAD_S_ASSERT(rad::IsTrivRelocatable<MockResource>);
+
 namespace
 {
 
@@ -24,8 +24,12 @@
 #include "gtest/gtest.h"
 #include "test/TestAlloc.h"
 
+#include "radiant/Arena.h"
+#include "radiant/SharedPtr.h"
 #include "radiant/Vector.h"
 
+#include <string.h>
+
 struct VecTestStats
 {
     int DtorCount = 0;
@@ -400,6 +404,154 @@ TEST_F(TestVectorIntegral, InlineReserveFail)
     EXPECT_EQ(heap.allocCount, 0);
 }
 
+TEST_F(TestVectorIntegral, ReserveTryExpand)
+{
+    using ArenaType = rad::Arena<radtest::CountingAllocator>;
+    using AllocWrap = rad::ArenaAllocator<radtest::CountingAllocator>;
+
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        ArenaType arena;
+        AllocWrap alloc(arena);
+        rad::Vector<int, AllocWrap> vec(alloc);
+
+        EXPECT_TRUE(vec.Assign({ 1, 2, 3 }).IsOk());
+        const int* data = vec.Data();
+
+        // the buffer is the last allocation of the arena, so it grows in place
+        EXPECT_TRUE(vec.Reserve(100).IsOk());
+        EXPECT_EQ(vec.Data(), data);
+        EXPECT_GE(vec.Capacity(), 100u);
+        EXPECT_EQ(vec.Size(), 3u);
+        EXPECT_EQ(vec[2], 3);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            EXPECT_TRUE(vec.PushBack(i).IsOk());
+        }
+        EXPECT_EQ(vec.Data(), data);
+
+        // another allocation prevents growing in place
+        EXPECT_NE(arena.AllocBytes(1), nullptr);
+        EXPECT_TRUE(vec.Reserve(300).IsOk());
+        EXPECT_NE(vec.Data(), data);
+        EXPECT_EQ(vec.Size(), 203u);
+        EXPECT_EQ(vec[0], 1);
+        EXPECT_EQ(vec[202], 199);
+
+        EXPECT_EQ(counter.AllocCount(), 1u);
+    }
+    counter.VerifyCounts();
+}
+
+TEST_F(TestVectorIntegral, InlineReserveTryExpand)
+{
+    using ArenaType = rad::Arena<radtest::Mallocator>;
+    using AllocWrap = rad::ArenaAllocator<radtest::Mallocator>;
+
+    ArenaType arena;
+    AllocWrap alloc(arena);
+    rad::InlineVector<int, 4, AllocWrap> vec(alloc);
+
+    EXPECT_TRUE(vec.Assign({ 1, 2, 3 }).IsOk());
+    EXPECT_TRUE(vec.Reserve(10).IsOk());
+    EXPECT_GE(vec.Capacity(), 10u);
+    const int* data = vec.Data();
+
+    EXPECT_TRUE(vec.Reserve(100).IsOk());
+    EXPECT_EQ(vec.Data(), data);
+    EXPECT_EQ(vec.Size(), 3u);
+    EXPECT_EQ(vec[0], 1);
+    EXPECT_EQ(vec[2], 3);
+}
+
+TEST_F(TestVectorIntegral, ReserveRealloc)
+{
+    radtest::ReallocatingAllocator::g_ReallocCount = 0;
+
+    rad::Vector<int, radtest::ReallocatingAllocator> vec;
+    EXPECT_TRUE(vec.Reserve(10).IsOk());
+    EXPECT_EQ(radtest::ReallocatingAllocator::g_ReallocCount, 0u);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(vec.PushBack(i).IsOk());
+    }
+    EXPECT_GT(radtest::ReallocatingAllocator::g_ReallocCount, 0u);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(vec[static_cast<uint32_t>(i)], i);
+    }
+}
+
+TEST_F(TestVectorIntegral, ReserveAllocAtLeast)
+{
+    const uint32_t granularity = radtest::RoundingAllocator::Granularity;
+    radtest::RoundingAllocator::g_AllocCount = 0;
+
+    // the slack the allocator rounds up to becomes capacity
+    rad::Vector<uint8_t, radtest::RoundingAllocator> vec;
+    EXPECT_TRUE(vec.Reserve(10).IsOk());
+    EXPECT_EQ(vec.Capacity(), granularity);
+    for (uint32_t i = 0; i < granularity; ++i)
+    {
+        EXPECT_TRUE(vec.PushBack(static_cast<uint8_t>(i)).IsOk());
+    }
+
+    EXPECT_EQ(radtest::RoundingAllocator::g_AllocCount, 1u);
+
+    EXPECT_TRUE(vec.PushBack(0).IsOk());
+    EXPECT_EQ(vec.Capacity(), granularity * 2);
+    EXPECT_EQ(radtest::RoundingAllocator::g_AllocCount, 2u);
+    EXPECT_EQ(vec[granularity - 1], static_cast<uint8_t>(granularity - 1));
+
+    rad::InlineVector<uint8_t, 4, radtest::RoundingAllocator> inlineVec;
+    EXPECT_TRUE(inlineVec.Resize(5).IsOk());
+    EXPECT_EQ(inlineVec.Capacity(), granularity);
+}
+
+TEST_F(TestVectorIntegral, GrowthPolicy)
+{
+    rad::Vector<int, radtest::Mallocator, 0, rad::GrowDouble> doubling;
+    uint32_t capacities[5];
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_TRUE(doubling.PushBack(i).IsOk());
+        capacities[i] = doubling.Capacity();
+    }
+
+    const uint32_t expected[] = { 1, 2, 4, 4, 8 };
+    EXPECT_TRUE(rad::Equal(rad::Span<const uint32_t>(capacities),
+                           rad::Span<const uint32_t>(expected)));
+
+    rad::Vector<uint32_t, radtest::Mallocator, 0, rad::GrowPageRounded<>>
+        paged;
+    EXPECT_TRUE(paged.PushBack(1).IsOk());
+    EXPECT_EQ(paged.Capacity(), 1024u);
+
+    // an explicit reservation is exact regardless of the policy
+    rad::Vector<int, radtest::Mallocator, 0, rad::GrowPowerOfTwo> pow2;
+    EXPECT_TRUE(pow2.Reserve(5).IsOk());
+    EXPECT_EQ(pow2.Capacity(), 5u);
+    EXPECT_TRUE(pow2.Resize(6).IsOk());
+    EXPECT_EQ(pow2.Capacity(), 8u);
+
+    // growth starts from the inline capacity
+    rad::InlineVector<int, 2, radtest::Mallocator, rad::GrowDouble> small;
+    rad::Vector<int, radtest::Mallocator> other;
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_TRUE(small.PushBack(i).IsOk());
+        EXPECT_TRUE(other.PushBack(i).IsOk());
+    }
+
+    EXPECT_EQ(small.Capacity(), 8u);
+    EXPECT_TRUE(other == doubling);
+    EXPECT_TRUE(small == doubling);
+}
+
 TEST_F(TestVectorIntegral, PushBack)
 {
     rad::Vector<int> vec;
@@ -1290,6 +1442,222 @@ TEST_F(TestVectorIntegral, EmplaceBackNoMemory)
     EXPECT_TRUE(vec.Empty());
 }
 
+TEST_F(TestVectorIntegral, Insert)
+{
+    rad::Vector<int> vec;
+    EXPECT_EQ(vec.Insert(1, 5).Err(), rad::Error::OutOfRange);
+    EXPECT_TRUE(vec.Insert(0, 3).IsOk());
+    EXPECT_TRUE(vec.Insert(0, 1).IsOk());
+    EXPECT_TRUE(vec.Insert(2, 4).IsOk());
+    EXPECT_TRUE(vec.Emplace(1, 2).IsOk());
+    ASSERT_EQ(vec.Size(), 4u);
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(vec[i], static_cast<int>(i) + 1);
+    }
+
+    // an element of the vector itself survives being shifted
+    EXPECT_TRUE(vec.Reserve(10).IsOk());
+    EXPECT_TRUE(vec.Insert(0, vec[3]).IsOk());
+    EXPECT_TRUE(vec.ShrinkToFit().IsOk());
+    EXPECT_TRUE(vec.Insert(0, vec[4]).IsOk());
+    EXPECT_EQ(vec.Size(), 6u);
+    EXPECT_EQ(vec[0], 4);
+    EXPECT_EQ(vec[1], 4);
+    EXPECT_EQ(vec[5], 4);
+}
+
+TEST_F(TestVectorIntegral, InsertRange)
+{
+    rad::Vector<int> vec;
+    const int first[] = { 1, 2, 6 };
+    const int second[] = { 3, 4, 5 };
+    EXPECT_TRUE(vec.InsertRange(0, first).IsOk());
+    EXPECT_EQ(vec.Capacity(), 3u);
+    EXPECT_TRUE(vec.InsertRange(2, second).IsOk());
+    EXPECT_TRUE(vec.InsertRange(6, rad::Span<const int>()).IsOk());
+    ASSERT_EQ(vec.Size(), 6u);
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        EXPECT_EQ(vec[i], static_cast<int>(i) + 1);
+    }
+
+    EXPECT_EQ(vec.InsertRange(7, second).Err(), rad::Error::OutOfRange);
+    EXPECT_EQ(vec.InsertRange(0, vec.ToSpan(1, 2)).Err(),
+              rad::Error::InvalidAddress);
+    EXPECT_EQ(vec.Size(), 6u);
+
+    rad::InlineVector<int, 4> inl;
+    EXPECT_TRUE(inl.InsertRange(0, first).IsOk());
+    EXPECT_TRUE(inl.InsertRange(1, second).IsOk());
+    EXPECT_GT(inl.Capacity(), 4u);
+    const int expected[] = { 1, 3, 4, 5, 2, 6 };
+    EXPECT_TRUE(rad::Equal(inl.ToSpan(), rad::Span<const int>(expected)));
+}
+
+TEST_F(TestVectorIntegral, InsertTryExpand)
+{
+    using ArenaType = rad::Arena<radtest::CountingAllocator>;
+    using AllocWrap = rad::ArenaAllocator<radtest::CountingAllocator>;
+
+    ArenaType arena;
+    AllocWrap alloc(arena);
+    rad::Vector<int, AllocWrap> vec(alloc);
+    EXPECT_TRUE(vec.Assign({ 1, 2, 3 }).IsOk());
+    const int* data = vec.Data();
+
+    // growing in place shifts the elements within the same buffer
+    const int values[] = { 7, 8, 9, 10 };
+    EXPECT_TRUE(vec.InsertRange(1, values).IsOk());
+    EXPECT_EQ(vec.Data(), data);
+    const int expected[] = { 1, 7, 8, 9, 10, 2, 3 };
+    EXPECT_TRUE(rad::Equal(vec.ToSpan(), rad::Span<const int>(expected)));
+}
+
+TEST_F(TestVectorIntegral, InsertNoMemory)
+{
+    using AllocWrap = radtest::ResourceAllocator<radtest::HeapResource>;
+
+    radtest::HeapResource heap;
+    rad::Vector<int, AllocWrap> vec(heap);
+    EXPECT_TRUE(vec.Assign({ 1, 2 }).IsOk());
+    EXPECT_TRUE(vec.ShrinkToFit().IsOk());
+
+    heap.forceAllocFails = 2;
+    EXPECT_EQ(vec.Insert(0, 0).Err(), rad::Error::NoMemory);
+    const int values[] = { 3, 4 };
+    EXPECT_EQ(vec.InsertRange(1, values).Err(), rad::Error::NoMemory);
+    ASSERT_EQ(vec.Size(), 2u);
+    EXPECT_EQ(vec[0], 1);
+    EXPECT_EQ(vec[1], 2);
+}
+
+TEST_F(TestVectorIntegral, Erase)
+{
+    rad::Vector<int> vec;
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_TRUE(vec.PushBack(i).IsOk());
+    }
+
+    vec.Erase(0).Erase(3, 2);
+    const int expected[] = { 1, 2, 3, 6, 7, 8, 9 };
+    EXPECT_TRUE(rad::Equal(vec.ToSpan(), rad::Span<const int>(expected)));
+
+    // counts past the end stop at the end
+    vec.Erase(5, 100);
+    EXPECT_EQ(vec.Size(), 5u);
+    EXPECT_EQ(vec.Back(), 7);
+    vec.Erase(5, 1);
+    EXPECT_EQ(vec.Size(), 5u);
+    vec.Erase(0, vec.Size());
+    EXPECT_TRUE(vec.Empty());
+}
+
+TEST_F(TestVectorIntegral, EraseIf)
+{
+    rad::Vector<int> vec;
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(vec.PushBack(i).IsOk());
+    }
+
+    EXPECT_EQ(vec.EraseIf([](int value) noexcept { return value % 3 != 0; }),
+              66u);
+    ASSERT_EQ(vec.Size(), 34u);
+    for (uint32_t i = 0; i < vec.Size(); ++i)
+    {
+        EXPECT_EQ(vec[i], static_cast<int>(i) * 3);
+    }
+
+    EXPECT_EQ(vec.EraseIf([](int) noexcept { return false; }), 0u);
+    EXPECT_EQ(vec.EraseIf([](int) noexcept { return true; }), 34u);
+    EXPECT_TRUE(vec.Empty());
+}
+
+TEST_F(TestVectorIntegral, SwapErase)
+{
+    rad::Vector<int> vec;
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_TRUE(vec.PushBack(i).IsOk());
+    }
+
+    vec.SwapErase(1);
+    const int expected[] = { 0, 4, 2, 3 };
+    EXPECT_TRUE(rad::Equal(vec.ToSpan(), rad::Span<const int>(expected)));
+
+    vec.SwapErase(3);
+    EXPECT_EQ(vec.Size(), 3u);
+    EXPECT_EQ(vec.Back(), 2);
+}
+
+TEST_F(TestVectorIntegral, ResizeForOverwrite)
+{
+    rad::Vector<uint8_t> vec;
+    EXPECT_TRUE(vec.PushBack(7).IsOk());
+
+    EXPECT_TRUE(vec.ResizeForOverwrite(100).IsOk());
+    EXPECT_EQ(vec.Size(), 100u);
+    EXPECT_GE(vec.Capacity(), 100u);
+    EXPECT_EQ(vec[0], 7);
+
+    memset(vec.Data() + 1, 9, 99);
+    EXPECT_TRUE(vec.ResizeForOverwrite(2).IsOk());
+    EXPECT_EQ(vec.Size(), 2u);
+    EXPECT_GE(vec.Capacity(), 100u);
+    EXPECT_EQ(vec[1], 9);
+}
+
+TEST_F(TestVectorIntegral, UninitializedAppend)
+{
+    rad::Vector<uint8_t> vec;
+    EXPECT_TRUE(vec.PushBack(1).IsOk());
+
+    auto res = vec.UninitializedAppend(64);
+    ASSERT_TRUE(res.IsOk());
+    rad::Span<uint8_t> span = res.Ok();
+    EXPECT_EQ(span.Size(), 64u);
+    EXPECT_EQ(span.Data(), vec.Data() + 1);
+    EXPECT_EQ(vec.Size(), 1u);
+    EXPECT_GE(vec.Capacity(), 65u);
+
+    // only part of the reserved room is written, as with a short read
+    memset(span.Data(), 2, 10);
+    vec.CommitSize(vec.Size() + 10);
+    EXPECT_EQ(vec.Size(), 11u);
+    EXPECT_EQ(vec[0], 1);
+    EXPECT_EQ(vec[10], 2);
+
+    // appending within the remaining capacity does not reallocate
+    const uint8_t* data = vec.Data();
+    res = vec.UninitializedAppend(54);
+    ASSERT_TRUE(res.IsOk());
+    EXPECT_EQ(vec.Data(), data);
+    EXPECT_EQ(res.Ok().Data(), data + 11);
+
+    vec.CommitSize(0);
+    EXPECT_TRUE(vec.Empty());
+}
+
+TEST_F(TestVectorIntegral, UninitializedAppendNoMemory)
+{
+    using AllocWrap = radtest::ResourceAllocator<radtest::HeapResource>;
+
+    radtest::HeapResource heap;
+    rad::Vector<int, AllocWrap> vec(heap);
+
+    heap.forceAllocFails = 2;
+    EXPECT_EQ(vec.UninitializedAppend(100).Err(), rad::Error::NoMemory);
+    EXPECT_EQ(vec.ResizeForOverwrite(100).Err(), rad::Error::NoMemory);
+    EXPECT_EQ(vec.Capacity(), 0u);
+
+    EXPECT_TRUE(vec.PushBack(1).IsOk());
+    EXPECT_EQ(vec.UninitializedAppend(UINT32_MAX).Err(),
+              rad::Error::IntegerOverflow);
+    EXPECT_EQ(vec.Size(), 1u);
+}
+
 #if RAD_ENABLE_STD
 
 TEST_F(TestVectorIntegral, EqualityOperators)
@@ -1395,6 +1763,38 @@ TEST_F(TestVectorIntegral, ComparisonOperators)
     EXPECT_TRUE(right >= left);
 }
 
+TEST_F(TestVectorIntegral, ComparisonOperatorsLong)
+{
+    // long enough for the vectorized comparisons, differing past them
+    rad::Vector<int16_t> left;
+    rad::Vector<int16_t> right;
+    for (int16_t i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(left.PushBack(i).IsOk());
+        EXPECT_TRUE(right.PushBack(i).IsOk());
+    }
+
+    EXPECT_TRUE(left == right);
+    EXPECT_FALSE(left < right);
+
+    right[97] = -1;
+    EXPECT_FALSE(left == right);
+    EXPECT_TRUE(right < left);
+    EXPECT_TRUE(left > right);
+
+    right[97] = 97;
+    EXPECT_TRUE(right.PushBack(0).IsOk());
+    EXPECT_FALSE(left == right);
+    EXPECT_TRUE(left < right);
+
+    rad::Vector<double> zeros;
+    rad::Vector<double> negativeZeros;
+    EXPECT_TRUE(zeros.Assign({ 0.0, 0.0 }).IsOk());
+    EXPECT_TRUE(negativeZeros.Assign({ -0.0, 0.0 }).IsOk());
+    EXPECT_TRUE(zeros == negativeZeros);
+    EXPECT_FALSE(zeros < negativeZeros);
+}
+
 #endif // RAD_ENABLE_STD
 
 template <typename T>
@@ -1705,6 +2105,24 @@ TYPED_TEST_P(NonTrivialStruct, PushEmplaceBack)
     EXPECT_EQ(g_stats.MoveAssignCount, 0);
 }
 
+TYPED_TEST_P(NonTrivialStruct, InsertEraseNothing)
+{
+    rad::Vector<TypeParam> vec;
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(vec.EmplaceBack(i).IsOk());
+    }
+
+    VectorTest<TypeParam>::ResetStats();
+    EXPECT_TRUE(vec.InsertRange(1, rad::Span<const TypeParam>()).IsOk());
+    vec.Erase(1, 0);
+    vec.Erase(3);
+
+    EXPECT_TRUE(g_stats.Empty());
+    EXPECT_EQ(vec.Size(), 3u);
+    EXPECT_EQ(vec[2].m_value, 2);
+}
+
 TYPED_TEST_P(NonTrivialStruct, Copy)
 {
     TypeParam value(123);
@@ -1965,6 +2383,7 @@ REGISTER_TYPED_TEST_SUITE_P(NonTrivialStruct,
                             PushBackLVal,
                             PushBackRVal,
                             PushEmplaceBack,
+                            InsertEraseNothing,
                             Copy,
                             Move,
                             ShrinkToFit,
@@ -2026,6 +2445,168 @@ TEST(TestVectorTrivialStruct, Pointers)
     }
 }
 
+struct RelocatableTracker
+{
+    static constexpr bool IsTriviallyRelocatable = true;
+
+    static int MoveCount;
+    static int DtorCount;
+
+    explicit RelocatableTracker(int val) noexcept
+        : value(val)
+    {
+    }
+
+    RelocatableTracker(RelocatableTracker&& other) noexcept
+        : value(other.value)
+    {
+        ++MoveCount;
+    }
+
+    ~RelocatableTracker()
+    {
+        ++DtorCount;
+    }
+
+    int value;
+};
+
+int RelocatableTracker::MoveCount = 0;
+int RelocatableTracker::DtorCount = 0;
+
+RAD_S_ASSERT(rad::IsTrivRelocatable<RelocatableTracker>);
+RAD_S_ASSERT(rad::IsTrivRelocatable<rad::Vector<RelocatableTracker>>);
+RAD_S_ASSERT((rad::IsTrivRelocatable<rad::InlineVector<int, 4>>));
+struct NotRelocatable
+{
+    ~NotRelocatable()
+    {
+    }
+};
+
+RAD_S_ASSERT(!rad::IsTrivRelocatable<NotRelocatable>);
+RAD_S_ASSERT(
+    !(rad::IsTrivRelocatable<rad::InlineVector<NotRelocatable, 4>>));
+RAD_S_ASSERT(rad::IsTrivRelocatable<rad::Vector<NotRelocatable>>);
+
+TEST(TestVectorRelocatable, GrowWithoutMoves)
+{
+    RelocatableTracker::MoveCount = 0;
+    RelocatableTracker::DtorCount = 0;
+    {
+        rad::Vector<RelocatableTracker> vec;
+        for (int i = 0; i < 100; ++i)
+        {
+            EXPECT_TRUE(vec.EmplaceBack(i).IsOk());
+        }
+        EXPECT_TRUE(vec.Reserve(1000).IsOk());
+        EXPECT_TRUE(vec.ShrinkToFit().IsOk());
+
+        EXPECT_EQ(RelocatableTracker::MoveCount, 0);
+        EXPECT_EQ(RelocatableTracker::DtorCount, 0);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            EXPECT_EQ(vec[static_cast<uint32_t>(i)].value, i);
+        }
+    }
+    EXPECT_EQ(RelocatableTracker::DtorCount, 100);
+}
+
+TEST(TestVectorRelocatable, InlineSwap)
+{
+    RelocatableTracker::MoveCount = 0;
+    RelocatableTracker::DtorCount = 0;
+    {
+        rad::InlineVector<RelocatableTracker, 4> vec1;
+        rad::InlineVector<RelocatableTracker, 4> vec2;
+        EXPECT_TRUE(vec1.EmplaceBack(1).IsOk());
+        for (int i = 0; i < 10; ++i)
+        {
+            EXPECT_TRUE(vec2.EmplaceBack(i).IsOk());
+        }
+
+        vec1.Swap(vec2);
+        EXPECT_EQ(vec1.Size(), 10u);
+        EXPECT_EQ(vec2.Size(), 1u);
+        EXPECT_EQ(vec2[0].value, 1);
+        EXPECT_EQ(vec1[9].value, 9);
+        EXPECT_EQ(RelocatableTracker::MoveCount, 0);
+        EXPECT_EQ(RelocatableTracker::DtorCount, 0);
+    }
+    EXPECT_EQ(RelocatableTracker::DtorCount, 11);
+}
+
+TEST(TestVectorRelocatable, SharedPtr)
+{
+    auto sp = rad::MakeShared<int>(42);
+    {
+        rad::Vector<rad::SharedPtr<int>> vec;
+        for (int i = 0; i < 100; ++i)
+        {
+            EXPECT_TRUE(vec.PushBack(sp).IsOk());
+        }
+        EXPECT_EQ(sp.UseCount(), 101u);
+
+        EXPECT_TRUE(vec.Reserve(1000).IsOk());
+        EXPECT_EQ(sp.UseCount(), 101u);
+        EXPECT_EQ(*vec[99], 42);
+    }
+    EXPECT_EQ(sp.UseCount(), 1u);
+}
+
+TEST(TestVectorRelocatable, NestedVectors)
+{
+    rad::Vector<rad::Vector<int>> vec;
+    for (int i = 0; i < 20; ++i)
+    {
+        rad::Vector<int> inner;
+        EXPECT_TRUE(inner.Assign(static_cast<uint32_t>(i) + 1, i).IsOk());
+        EXPECT_TRUE(vec.PushBack(rad::Move(inner)).IsOk());
+    }
+
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        EXPECT_EQ(vec[i].Size(), i + 1);
+        EXPECT_EQ(vec[i][i], static_cast<int>(i));
+    }
+}
+
+TEST(TestVectorRelocatable, InsertEraseWithoutMoves)
+{
+    RelocatableTracker::MoveCount = 0;
+    RelocatableTracker::DtorCount = 0;
+    {
+        rad::Vector<RelocatableTracker> vec;
+        for (int i = 0; i < 10; ++i)
+        {
+            EXPECT_TRUE(vec.EmplaceBack(i).IsOk());
+        }
+
+        // shifting is a memmove, only the constructed element is moved
+        EXPECT_TRUE(vec.Emplace(3, 100).IsOk());
+        EXPECT_TRUE(vec.Emplace(0, 200).IsOk());
+        EXPECT_EQ(RelocatableTracker::MoveCount, 2);
+        EXPECT_EQ(RelocatableTracker::DtorCount, 2);
+
+        vec.Erase(1, 2);
+        vec.SwapErase(0);
+        EXPECT_EQ(vec.EraseIf([](const RelocatableTracker& t) noexcept
+                              { return t.value % 2 == 1; }),
+                  4u);
+        EXPECT_EQ(RelocatableTracker::MoveCount, 2);
+        EXPECT_EQ(RelocatableTracker::DtorCount, 9);
+
+        const int expected[] = { 2, 100, 4, 6, 8 };
+        ASSERT_EQ(vec.Size(), 5u);
+        for (uint32_t i = 0; i < vec.Size(); ++i)
+        {
+            EXPECT_EQ(vec[i].value, expected[i]);
+        }
+    }
+    EXPECT_EQ(RelocatableTracker::DtorCount, 14);
+}
+
 // Exception Safety Tests
 // We provide the strong guarantee for Vector.  To do this we require that the
 // contained types have noexcept move, swap, and destruction
@@ -2367,6 +2948,93 @@ TEST_F(TestVectorStrongGuarantee, PushBackLVal)
     EXPECT_EQ(g_stats.MoveAssignCount, 0);
 }
 
+TEST_F(TestVectorStrongGuarantee, Insert)
+{
+    rad::Vector<ThrowingVecTester> vec;
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(vec.EmplaceBack(i).IsOk());
+    }
+
+    ThrowingVecTester value(123);
+    ResetStats();
+    ThrowingVecTester::ThrowIn(1);
+    EXPECT_THROW(vec.Insert(1, value).IsOk(), SafetyException);
+
+    EXPECT_EQ(vec.Size(), 4u);
+    EXPECT_EQ(vec[1].m_value, 1);
+    EXPECT_EQ(g_stats.DtorCount, 0);
+    EXPECT_EQ(g_stats.MoveCtorCount, 0);
+
+    ResetStats();
+    EXPECT_TRUE(vec.Insert(1, value).IsOk());
+    EXPECT_EQ(vec[1].m_value, 123);
+    EXPECT_EQ(vec[4].m_value, 3);
+    EXPECT_EQ(g_stats.CopyCtorCount, 1);
+}
+
+TEST_F(TestVectorStrongGuarantee, InsertRange)
+{
+    rad::Vector<ThrowingVecTester> vec;
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(vec.EmplaceBack(i).IsOk());
+    }
+
+    ThrowingVecTester values[3] = { ThrowingVecTester(7),
+                                    ThrowingVecTester(8),
+                                    ThrowingVecTester(9) };
+    ResetStats();
+    ThrowingVecTester::ThrowIn(3);
+    EXPECT_THROW(
+        vec.InsertRange(2, rad::Span<const ThrowingVecTester>(values)).IsOk(),
+        SafetyException);
+
+    EXPECT_EQ(vec.Size(), 4u);
+    EXPECT_EQ(vec[2].m_value, 2);
+    EXPECT_EQ(g_stats.CopyCtorCount, 2);
+    EXPECT_EQ(g_stats.DtorCount, 2);
+
+    EXPECT_TRUE(
+        vec.InsertRange(2, rad::Span<const ThrowingVecTester>(values)).IsOk());
+    ASSERT_EQ(vec.Size(), 7u);
+    EXPECT_EQ(vec[2].m_value, 7);
+    EXPECT_EQ(vec[4].m_value, 9);
+    EXPECT_EQ(vec[5].m_value, 2);
+}
+
+TEST_F(TestVectorStrongGuarantee, EraseIfThrows)
+{
+    struct Failure
+    {
+    };
+
+    rad::Vector<ThrowingVecTester> vec;
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(vec.EmplaceBack(i).IsOk());
+    }
+
+    // the elements already looked at are removed, the rest are kept
+    EXPECT_THROW(vec.EraseIf(
+                     [](const ThrowingVecTester& t)
+                     {
+                         if (t.m_value == 5)
+                         {
+                             throw Failure();
+                         }
+
+                         return t.m_value % 2 == 0;
+                     }),
+                 Failure);
+    const int expected[] = { 1, 3, 5, 6, 7 };
+    ASSERT_EQ(vec.Size(), 5u);
+    for (uint32_t i = 0; i < vec.Size(); ++i)
+    {
+        EXPECT_EQ(vec[i].m_value, expected[i]);
+    }
+}
+
 TEST_F(TestVectorStrongGuarantee, Copy)
 {
     ThrowingVecTester value(123);
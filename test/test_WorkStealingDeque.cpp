@@ -0,0 +1,165 @@
+// Copyright 2024 The Radiant Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "radiant/WorkStealingDeque.h"
+
+#include "test/TestAlloc.h"
+
+#include <thread>
+
+namespace
+{
+using IntDeque = rad::WorkStealingDeque<int, radtest::Mallocator>;
+} // namespace
+
+TEST(TestWorkStealingDeque, Uninitialized)
+{
+    IntDeque deque;
+    EXPECT_EQ(deque.Capacity(), 0u);
+    EXPECT_EQ(deque.ApproxSize(), 0u);
+    EXPECT_EQ(deque.Push(1), rad::Error::OutOfRange);
+    EXPECT_EQ(deque.Pop(), rad::Error::OutOfRange);
+    EXPECT_EQ(deque.Steal(), rad::Error::OutOfRange);
+}
+
+TEST(TestWorkStealingDeque, Capacity)
+{
+    IntDeque deque;
+    EXPECT_TRUE(deque.Init(0).IsOk());
+    EXPECT_EQ(deque.Capacity(), 1u);
+    EXPECT_TRUE(deque.Init(5).IsOk());
+    EXPECT_EQ(deque.Capacity(), 8u);
+    EXPECT_EQ(deque.Init(~size_t(0)), rad::Error::IntegerOverflow);
+    EXPECT_EQ(deque.Capacity(), 8u);
+
+    rad::WorkStealingDeque<int, radtest::FailingAllocator> failing;
+    EXPECT_EQ(failing.Init(4), rad::Error::NoMemory);
+    EXPECT_EQ(failing.Capacity(), 0u);
+
+    radtest::CountingAllocator counter;
+    counter.ResetCounts();
+    {
+        rad::WorkStealingDeque<int*, radtest::CountingAllocator> counted;
+        EXPECT_TRUE(counted.Init(4).IsOk());
+        EXPECT_TRUE(counted.Init(8).IsOk());
+        counter.VerifyCounts(2, 1);
+    }
+    counter.VerifyCounts(2, 2);
+    counter.VerifyCounts();
+}
+
+TEST(TestWorkStealingDeque, PopLifoStealFifo)
+{
+    IntDeque deque;
+    ASSERT_TRUE(deque.Init(4).IsOk());
+
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 1; i <= 4; ++i)
+        {
+            EXPECT_TRUE(deque.Push(round * 10 + i).IsOk());
+        }
+        EXPECT_EQ(deque.Push(99), rad::Error::OutOfRange);
+        EXPECT_EQ(deque.ApproxSize(), 4u);
+
+        EXPECT_EQ(deque.Pop().Ok(), round * 10 + 4);
+        EXPECT_EQ(deque.Steal().Ok(), round * 10 + 1);
+        EXPECT_EQ(deque.Steal().Ok(), round * 10 + 2);
+        EXPECT_EQ(deque.Pop().Ok(), round * 10 + 3);
+        EXPECT_EQ(deque.ApproxSize(), 0u);
+        EXPECT_EQ(deque.Pop(), rad::Error::OutOfRange);
+        EXPECT_EQ(deque.Steal(), rad::Error::OutOfRange);
+    }
+}
+
+TEST(TestWorkStealingDeque, Concurrent)
+{
+    static constexpr int ThiefCount = 3;
+    static constexpr int Total = 50000;
+
+    rad::WorkStealingDeque<uint64_t, radtest::Mallocator> deque;
+    ASSERT_TRUE(deque.Init(64).IsOk());
+
+    rad::Atomic<int> taken{ 0 };
+    uint64_t sums[ThiefCount + 1] = {};
+
+    std::thread thieves[ThiefCount];
+    for (int t = 0; t < ThiefCount; ++t)
+    {
+        thieves[t] = std::thread(
+            [&, t]
+            {
+                while (taken.Load(rad::MemOrderRelaxed) < Total)
+                {
+                    auto res = deque.Steal();
+                    if (res.IsOk())
+                    {
+                        sums[t] += res.Ok();
+                        taken.FetchAdd(1, rad::MemOrderRelaxed);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+
+    // the owner pops every third element itself and retries full pushes
+    for (uint64_t i = 1; i <= Total; ++i)
+    {
+        while (!deque.Push(i).IsOk())
+        {
+            std::this_thread::yield();
+        }
+
+        if (i % 3 == 0)
+        {
+            auto res = deque.Pop();
+            if (res.IsOk())
+            {
+                sums[ThiefCount] += res.Ok();
+                taken.FetchAdd(1, rad::MemOrderRelaxed);
+            }
+        }
+    }
+
+    for (;;)
+    {
+        auto res = deque.Pop();
+        if (!res.IsOk())
+        {
+            break;
+        }
+
+        sums[ThiefCount] += res.Ok();
+        taken.FetchAdd(1, rad::MemOrderRelaxed);
+    }
+
+    for (auto& thief : thieves)
+    {
+        thief.join();
+    }
+
+    uint64_t sum = 0;
+    for (uint64_t s : sums)
+    {
+        sum += s;
+    }
+
+    EXPECT_EQ(taken.Load(rad::MemOrderRelaxed), Total);
+    EXPECT_EQ(sum, uint64_t(Total) * (Total + 1) / 2);
+}